@@ -12,7 +12,6 @@
 
 #include <KColorScheme>
 #include <KContextualHelpButton>
-#include <KIO/JobUiDelegateFactory>
 #include <KIO/SimpleJob>
 #include <KLocalizedString>
 
@@ -20,7 +19,6 @@
 #include <QGuiApplication>
 #include <QHBoxLayout>
 #include <QLabel>
-#include <QPointer>
 #include <QPushButton>
 #include <QStyle>
 #include <QToolButton>
@@ -28,11 +26,6 @@
 
 using namespace Admin;
 
-namespace
-{
-QPointer<KIO::SimpleJob> waitingForExpirationOfAuthorization;
-}
-
 Bar::Bar(DolphinViewContainer *parentViewContainer)
     : AnimatedHeightWidget{parentViewContainer}
     , m_parentViewContainer{parentViewContainer}
@@ -107,19 +100,9 @@ void Bar::resizeEvent(QResizeEvent *resizeEvent)
 
 void Bar::hideTheNextTimeAuthorizationExpires()
 {
-    if (waitingForExpirationOfAuthorization.isNull()) {
-        QByteArray packedArgs;
-        QDataStream stream(&packedArgs, QIODevice::WriteOnly);
-        stream << (int)1;
-        waitingForExpirationOfAuthorization = KIO::special(QUrl(QStringLiteral("admin:/")), packedArgs, KIO::HideProgressInfo);
-        waitingForExpirationOfAuthorization->setUiDelegate(KIO::createDefaultJobUiDelegate(KJobUiDelegate::AutoWarningHandlingEnabled, m_parentViewContainer));
-
-        connect(waitingForExpirationOfAuthorization, &KJob::finished, this, [](KJob *job) {
-            if (job->error()) {
-                job->uiDelegate()->showErrorMessage();
-            }
-        });
-    }
+    // The job is shared process-wide: it is usually already running because entering
+    // an admin:// url pre-warms the worker. @see Admin::authorizationExpirationWatcher().
+    KIO::SimpleJob *waitingForExpirationOfAuthorization = authorizationExpirationWatcher(m_parentViewContainer);
 
     connect(waitingForExpirationOfAuthorization, &KJob::finished, this, [this](KJob *job) {
         if (job->error()) {
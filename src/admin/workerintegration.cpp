@@ -13,12 +13,16 @@
 #include "dolphinviewcontainer.h"
 
 #include <KActionCollection>
+#include <KIO/JobUiDelegateFactory>
+#include <KIO/SimpleJob>
 #include <KLocalizedString>
 #include <KMessageBox>
 #include <KMessageDialog>
 #include <KProtocolInfo>
 
 #include <QAction>
+#include <QDataStream>
+#include <QPointer>
 
 #include <iostream>
 
@@ -106,6 +110,27 @@ namespace
 {
 /** The only WorkerIntegration object that is ever constructed. It is only ever accessed directly from within this file. */
 WorkerIntegration *instance = nullptr;
+
+/** @see Admin::authorizationExpirationWatcher(). */
+QPointer<KIO::SimpleJob> waitingForExpirationOfAuthorization;
+}
+
+KIO::SimpleJob *Admin::authorizationExpirationWatcher(QWidget *uiParent)
+{
+    if (waitingForExpirationOfAuthorization.isNull()) {
+        QByteArray packedArgs;
+        QDataStream stream(&packedArgs, QIODevice::WriteOnly);
+        stream << (int)1;
+        waitingForExpirationOfAuthorization = KIO::special(QUrl(QStringLiteral("admin:/")), packedArgs, KIO::HideProgressInfo);
+        waitingForExpirationOfAuthorization->setUiDelegate(KIO::createDefaultJobUiDelegate(KJobUiDelegate::AutoWarningHandlingEnabled, uiParent));
+
+        QObject::connect(waitingForExpirationOfAuthorization, &KJob::finished, [](KJob *job) {
+            if (job->error()) {
+                job->uiDelegate()->showErrorMessage();
+            }
+        });
+    }
+    return waitingForExpirationOfAuthorization;
 }
 
 WorkerIntegration::WorkerIntegration(DolphinMainWindow *parent, QAction *actAsAdminAction)
@@ -178,6 +203,10 @@ void WorkerIntegration::toggleActAsAdmin()
     }
 
     url.setScheme(QStringLiteral("admin"));
+    // Pre-warm the privileged worker: establishing the authenticated worker context
+    // starts right away and in parallel to the first listing, and the running job
+    // keeps the context alive for the following administrative operations.
+    authorizationExpirationWatcher(dolphinMainWindow);
     dolphinMainWindow->changeUrl(url);
 }
 
@@ -15,6 +15,12 @@ class DolphinViewContainer;
 class KActionCollection;
 class QAction;
 class QUrl;
+class QWidget;
+
+namespace KIO
+{
+class SimpleJob;
+}
 
 /**
  * @brief This namespace contains everything that is necessary to nicely integrate "KIO Admin Worker" into Dolphin.
@@ -42,6 +48,20 @@ constexpr QLatin1String warningDontShowAgainName{"warnAboutRisksBeforeActingAsAd
 /** @returns an elaborate warning about the dangers of acting with administrative privileges. */
 QString warningMessage();
 
+/**
+ * @returns the process-wide job that holds a connection to the authenticated admin worker
+ *          and finishes once the administrator authorization expires.
+ *
+ * The job is created on first use; later calls return the same job until it finishes.
+ * While it is running it keeps the privileged worker context alive, so successive
+ * administrative operations reuse it instead of paying the setup latency again.
+ * Calling this when the user enters an admin:// url pre-warms the worker in parallel
+ * to the first listing.
+ *
+ * @param uiParent The widget error messages are shown for when the job is first created.
+ */
+KIO::SimpleJob *authorizationExpirationWatcher(QWidget *uiParent);
+
 /**
  * @brief A class encapsulating the "Act as Admin"-toggle action.
  *
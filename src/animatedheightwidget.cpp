@@ -10,10 +10,11 @@
 #include <QEvent>
 #include <QGridLayout>
 #include <QKeyEvent>
-#include <QPropertyAnimation>
+#include <QPainter>
 #include <QScrollArea>
 #include <QScrollBar>
 #include <QStyle>
+#include <QVariantAnimation>
 
 AnimatedHeightWidget::AnimatedHeightWidget(QWidget *parent)
     : QWidget{parent}
@@ -49,9 +50,10 @@ QSize AnimatedHeightWidget::sizeHint() const
 void AnimatedHeightWidget::setVisible(bool visible, Animated animated)
 {
     setEnabled(visible);
-    if (m_heightAnimation) {
-        m_heightAnimation->stop(); // deletes because of QAbstractAnimation::DeleteWhenStopped.
+    if (m_slideAnimation) {
+        m_slideAnimation->stop(); // deletes because of QAbstractAnimation::DeleteWhenStopped.
     }
+    finishSlide(); // Restores a consistent state in case an animation was interrupted.
 
     if (animated == WithAnimation
         && (style()->styleHint(QStyle::SH_Widget_Animation_Duration, nullptr, this) < 1 || GlobalConfig::animationDurationFactor() <= 0.0)) {
@@ -64,20 +66,42 @@ void AnimatedHeightWidget::setVisible(bool visible, Animated animated)
         return;
     }
 
-    m_heightAnimation = new QPropertyAnimation(this, "maximumHeight");
-    m_heightAnimation->setDuration(2 * style()->styleHint(QStyle::SH_Widget_Animation_Duration, nullptr, this) * GlobalConfig::animationDurationFactor());
-
-    m_heightAnimation->setStartValue(height());
-    m_heightAnimation->setEasingCurve(QEasingCurve::OutCubic);
+    // Animating the height directly would relayout and repaint the whole window on
+    // every frame. Instead the layout change is committed exactly once – at the start
+    // when showing, at the end when hiding – and the animation itself only translates
+    // a pixmap of the contents within this widget, which is a mere repaint of the bar.
+    const int contentsHeight = preferredHeight();
     if (visible) {
         show();
-        m_heightAnimation->setEndValue(preferredHeight());
-    } else {
-        m_heightAnimation->setEndValue(0);
-        connect(m_heightAnimation, &QAbstractAnimation::finished, this, &QWidget::hide);
+        setMaximumHeight(contentsHeight);
+        // The layout will assign this geometry anyway, but only after returning to the
+        // event loop. Apply it right away so the grab below has the final size.
+        m_contentsContainerParent->resize(width(), contentsHeight);
     }
+    m_animationPixmap = m_contentsContainerParent->grab();
+    m_contentsContainerParent->hide();
+    m_slideOffset = visible ? -contentsHeight : 0.0;
+
+    m_slideAnimation = new QVariantAnimation(this);
+    m_slideAnimation->setDuration(2 * style()->styleHint(QStyle::SH_Widget_Animation_Duration, nullptr, this) * GlobalConfig::animationDurationFactor());
+    m_slideAnimation->setStartValue(0.0);
+    m_slideAnimation->setEndValue(1.0);
+    m_slideAnimation->setEasingCurve(QEasingCurve::OutCubic);
+
+    connect(m_slideAnimation, &QVariantAnimation::valueChanged, this, [this, visible, contentsHeight](const QVariant &value) {
+        const qreal progress = value.toReal();
+        m_slideOffset = visible ? (progress - 1.0) * contentsHeight : -progress * contentsHeight;
+        update();
+    });
+    connect(m_slideAnimation, &QAbstractAnimation::finished, this, [this, visible]() {
+        if (!visible) {
+            setMaximumHeight(0);
+            hide();
+        }
+        finishSlide();
+    });
 
-    m_heightAnimation->start(QAbstractAnimation::DeleteWhenStopped);
+    m_slideAnimation->start(QAbstractAnimation::DeleteWhenStopped);
 }
 
 QWidget *AnimatedHeightWidget::prepareContentsContainer(QWidget *contentsContainer)
@@ -94,7 +118,27 @@ QWidget *AnimatedHeightWidget::prepareContentsContainer(QWidget *contentsContain
 
 bool AnimatedHeightWidget::isAnimationRunning() const
 {
-    return m_heightAnimation && m_heightAnimation->state() == QAbstractAnimation::Running;
+    return m_slideAnimation && m_slideAnimation->state() == QAbstractAnimation::Running;
+}
+
+void AnimatedHeightWidget::finishSlide()
+{
+    if (m_animationPixmap.isNull()) {
+        return;
+    }
+    m_animationPixmap = QPixmap();
+    m_contentsContainerParent->show();
+    update();
+}
+
+void AnimatedHeightWidget::paintEvent(QPaintEvent *event)
+{
+    QWidget::paintEvent(event);
+
+    if (!m_animationPixmap.isNull()) {
+        QPainter painter(this);
+        painter.drawPixmap(QPointF{0.0, m_slideOffset}, m_animationPixmap);
+    }
 }
 
 bool AnimatedHeightWidget::eventFilter(QObject *obj, QEvent *event)
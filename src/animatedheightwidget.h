@@ -10,11 +10,12 @@
 
 #include "global.h"
 
+#include <QPixmap>
 #include <QPointer>
 #include <QWidget>
 
-class QPropertyAnimation;
 class QScrollArea;
+class QVariantAnimation;
 
 /**
  * @brief An abstract base class which facilitates animated showing and hiding of sub-classes
@@ -62,6 +63,9 @@ protected:
      */
     bool eventFilter(QObject *obj, QEvent *event) override;
 
+    /** Paints the grabbed contents pixmap at the current slide offset while an animation is running. */
+    void paintEvent(QPaintEvent *event) override;
+
 private:
     using QWidget::hide; // Use QAbstractAnimation::setVisible() instead.
     using QWidget::setVisible; // Makes sure that the setVisible() declaration above doesn't fully hide the one from QWidget so we can still use it privately.
@@ -70,12 +74,30 @@ private:
     /** @returns the full preferred height this widget should have when it is done animating and visible. */
     virtual int preferredHeight() const = 0;
 
+    /**
+     * Ends the pixmap-based slide: discards the grabbed pixmap and makes the
+     * real contents visible again. Also called before a new animation starts,
+     * in case the previous one was interrupted.
+     */
+    void finishSlide();
+
 private:
     /** @see contentsContainerParent() */
     QScrollArea *m_contentsContainerParent = nullptr;
 
     /** @see AnimatedHeightWidget::setVisible() */
-    QPointer<QPropertyAnimation> m_heightAnimation;
+    QPointer<QVariantAnimation> m_slideAnimation;
+
+    /**
+     * The contents grabbed when a show or hide animation starts. While it is
+     * non-null, the real contents are hidden and this pixmap is painted at
+     * m_slideOffset instead, so animation frames only repaint this bar and
+     * never relayout the window.
+     */
+    QPixmap m_animationPixmap;
+
+    /** Vertical position of m_animationPixmap relative to the top of this widget. */
+    qreal m_slideOffset = 0.0;
 };
 
 #endif // ANIMATEDHEIGHTWIDGET_H
@@ -6,13 +6,20 @@
 
 #include "dbusinterface.h"
 #include "dolphin_generalsettings.h"
+#include "dolphinmainwindow.h"
+#include "dolphinplacesmodelsingleton.h"
+#include "dolphinstartupprofiler.h"
 #include "global.h"
+#include "kitemviews/private/kfileitemrolestelemetry.h"
+#include "kitemviews/private/kmemoryaccounting.h"
+#include "kitemviews/private/kpipelinetrace.h"
 
 #include <KPropertiesDialog>
 #include <KWindowSystem>
 
 #include <QDBusConnection>
 #include <QDBusConnectionInterface>
+#include <QTimer>
 
 DBusInterface::DBusInterface()
     : QObject()
@@ -32,10 +39,21 @@ void DBusInterface::ShowFolders(const QStringList &uriList, const QString &start
     if (urls.isEmpty()) {
         return;
     }
-    const auto serviceName = isDaemon() ? QString() : QStringLiteral("org.kde.dolphin-%1").arg(QCoreApplication::applicationPid());
-    if (!Dolphin::attachToExistingInstance(urls, false, GeneralSettings::splitView(), serviceName, startUpId)) {
-        Dolphin::openNewWindow(urls);
-    }
+    // Reply to the bus call right after validation. Attaching to another
+    // instance and creating tabs can take a while when scripts pass hundreds
+    // of URLs, and the caller gains nothing from waiting for it.
+    QTimer::singleShot(0, this, [this, urls, startUpId]() {
+        const auto serviceName = isDaemon() ? QString() : QStringLiteral("org.kde.dolphin-%1").arg(QCoreApplication::applicationPid());
+        if (!Dolphin::attachToExistingInstance(urls, false, GeneralSettings::splitView(), serviceName, startUpId)) {
+            if (DolphinMainWindow *window = takePrewarmedWindow()) {
+                KWindowSystem::setCurrentXdgActivationToken(startUpId);
+                window->openDirectories(urls, GeneralSettings::splitView());
+                window->show();
+            } else {
+                Dolphin::openNewWindow(urls);
+            }
+        }
+    });
 }
 
 void DBusInterface::ShowItems(const QStringList &uriList, const QString &startUpId)
@@ -44,10 +62,19 @@ void DBusInterface::ShowItems(const QStringList &uriList, const QString &startUp
     if (urls.isEmpty()) {
         return;
     }
-    const auto serviceName = isDaemon() ? QString() : QStringLiteral("org.kde.dolphin-%1").arg(QCoreApplication::applicationPid());
-    if (!Dolphin::attachToExistingInstance(urls, true, GeneralSettings::splitView(), serviceName, startUpId)) {
-        Dolphin::openNewWindow(urls, nullptr, Dolphin::OpenNewWindowFlag::Select);
-    };
+    // See ShowFolders() for why the heavy lifting happens after the reply.
+    QTimer::singleShot(0, this, [this, urls, startUpId]() {
+        const auto serviceName = isDaemon() ? QString() : QStringLiteral("org.kde.dolphin-%1").arg(QCoreApplication::applicationPid());
+        if (!Dolphin::attachToExistingInstance(urls, true, GeneralSettings::splitView(), serviceName, startUpId)) {
+            if (DolphinMainWindow *window = takePrewarmedWindow()) {
+                KWindowSystem::setCurrentXdgActivationToken(startUpId);
+                window->openFiles(urls, GeneralSettings::splitView());
+                window->show();
+            } else {
+                Dolphin::openNewWindow(urls, nullptr, Dolphin::OpenNewWindowFlag::Select);
+            }
+        }
+    });
 }
 
 void DBusInterface::ShowItemProperties(const QStringList &uriList, const QString &startUpId)
@@ -71,9 +98,69 @@ void DBusInterface::SortOrderForUrl(const QString &url, QString &role, QString &
     }
 }
 
+QString DBusInterface::GetRolesUpdaterTelemetry()
+{
+    return KFileItemRolesTelemetry::instance()->report();
+}
+
+void DBusInterface::StartPipelineTrace()
+{
+    KPipelineTrace::instance()->start();
+}
+
+QString DBusInterface::StopPipelineTrace()
+{
+    return KPipelineTrace::instance()->stop();
+}
+
+QString DBusInterface::GetMemoryAccounting()
+{
+    return KMemoryAccounting::instance()->report();
+}
+
+QString DBusInterface::GetStartupTimings()
+{
+    return DolphinStartupProfiler::instance()->report();
+}
+
 void DBusInterface::setAsDaemon()
 {
     m_isDaemon = true;
+
+    if (GeneralSettings::residentWindowService()) {
+        // Warm the shared places model and pre-build a hidden window shell
+        // once the event loop runs, so the first window request only has to
+        // load its directory and show.
+        QTimer::singleShot(0, this, [this]() {
+            DolphinPlacesModelSingleton::instance();
+            prewarmWindow();
+        });
+    }
+}
+
+void DBusInterface::prewarmWindow()
+{
+    if (!m_prewarmedWindow) {
+        m_prewarmedWindow = new DolphinMainWindow();
+    }
+}
+
+DolphinMainWindow *DBusInterface::takePrewarmedWindow()
+{
+    if (!isDaemon() || !GeneralSettings::residentWindowService()) {
+        return nullptr;
+    }
+
+    DolphinMainWindow *window = m_prewarmedWindow.data();
+    m_prewarmedWindow.clear();
+
+    // Replace the taken shell in idle time so the next request is served
+    // just as quickly. If no shell was ready - e.g. two requests arrived
+    // back to back - the caller falls back to spawning a new process.
+    QTimer::singleShot(0, this, [this]() {
+        prewarmWindow();
+    });
+    return window;
 }
 
 bool DBusInterface::isDaemon() const
@@ -8,6 +8,9 @@
 #define DBUSINTERFACE_H
 
 #include <QObject>
+#include <QPointer>
+
+class DolphinMainWindow;
 
 class DBusInterface : QObject
 {
@@ -23,7 +26,41 @@ public:
     Q_SCRIPTABLE void SortOrderForUrl(const QString &url, QString &role, QString &order);
 
     /**
-     * Set whether this interface has been created by dolphin --daemon.
+     * @return The role resolution telemetry of this process as JSON: per-role
+     *         resolution counters, per-source latency histograms and the
+     *         current queue depths, see KFileItemRolesTelemetry.
+     */
+    Q_SCRIPTABLE QString GetRolesUpdaterTelemetry();
+
+    /**
+     * Starts recording spans of the directory display pipeline, see
+     * KPipelineTrace. A trace which is already running is restarted.
+     */
+    Q_SCRIPTABLE void StartPipelineTrace();
+
+    /**
+     * Stops recording and writes the trace as a chrome://tracing JSON file.
+     * @return The path of the written file, or an empty string if nothing
+     *         was recorded.
+     */
+    Q_SCRIPTABLE QString StopPipelineTrace();
+
+    /**
+     * @return Byte estimates of the major memory owners of this process as
+     *         JSON, grouped by subsystem, see KMemoryAccounting.
+     */
+    Q_SCRIPTABLE QString GetMemoryAccounting();
+
+    /**
+     * @return The startup milestone timings of this process as JSON, see
+     *         DolphinStartupProfiler.
+     */
+    Q_SCRIPTABLE QString GetStartupTimings();
+
+    /**
+     * Set whether this interface has been created by dolphin --daemon. If the
+     * resident window service is enabled, this also starts pre-building a
+     * hidden window shell, see takePrewarmedWindow().
      */
     void setAsDaemon();
 
@@ -32,8 +69,24 @@ public:
      */
     bool isDaemon() const;
 
+private:
+    /**
+     * Constructs the hidden window shell for the next window request if none
+     * exists yet. Building DolphinMainWindow is what dominates the latency of
+     * opening a window, so the daemon does it ahead of time while it idles.
+     */
+    void prewarmWindow();
+
+    /**
+     * @return The pre-built hidden window, or nullptr if the resident window
+     *         service is disabled or no window is ready yet. Taking the
+     *         window schedules the pre-building of its replacement.
+     */
+    DolphinMainWindow *takePrewarmedWindow();
+
 private:
     bool m_isDaemon = false;
+    QPointer<DolphinMainWindow> m_prewarmedWindow;
 };
 
 #endif // DBUSINTERFACE_H
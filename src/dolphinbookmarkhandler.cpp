@@ -9,27 +9,19 @@
 #include "dolphinviewcontainer.h"
 #include "global.h"
 #include <KActionCollection>
+#include <KBookmarkManager>
 #include <KBookmarkMenu>
 #include <QDebug>
 #include <QDir>
 #include <QStandardPaths>
 
+#include <memory>
+
 DolphinBookmarkHandler::DolphinBookmarkHandler(DolphinMainWindow *mainWindow, KActionCollection *collection, QMenu *menu, QObject *parent)
     : QObject(parent)
     , m_mainWindow(mainWindow)
 {
-    QString bookmarksFile = QStandardPaths::locate(QStandardPaths::GenericDataLocation, QStringLiteral("kfile/bookmarks.xml"));
-    if (bookmarksFile.isEmpty()) {
-        QString genericDataLocation = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation);
-        if (genericDataLocation.isEmpty()) {
-            qWarning() << "GenericDataLocation is empty! Bookmarks will not be saved correctly.";
-        }
-        bookmarksFile = QStringLiteral("%1/dolphin").arg(genericDataLocation);
-        QDir().mkpath(bookmarksFile);
-        bookmarksFile += QLatin1String("/bookmarks.xml");
-    }
-    m_bookmarkManager = std::make_unique<KBookmarkManager>(bookmarksFile);
-    m_bookmarkMenu.reset(new KBookmarkMenu(m_bookmarkManager.get(), this, menu));
+    m_bookmarkMenu.reset(new KBookmarkMenu(bookmarkManager(), this, menu));
 
     collection->addAction(QStringLiteral("add_bookmark"), m_bookmarkMenu->addBookmarkAction());
     collection->addAction(QStringLiteral("edit_bookmarks"), m_bookmarkMenu->editBookmarksAction());
@@ -117,4 +109,28 @@ QString DolphinBookmarkHandler::icon(DolphinViewContainer *viewContainer)
     return KIO::iconNameForUrl(viewContainer->url());
 }
 
+KBookmarkManager *DolphinBookmarkHandler::bookmarkManager()
+{
+    // One manager per process: every window used to locate and parse
+    // bookmarks.xml for itself, which is wasted work for users with large
+    // bookmark collections. KBookmarkManager watches the file, so changes
+    // made on disk - e.g. by another process - still invalidate the cached
+    // model and propagate to the menus of all windows.
+    static std::unique_ptr<KBookmarkManager> manager;
+    if (!manager) {
+        QString bookmarksFile = QStandardPaths::locate(QStandardPaths::GenericDataLocation, QStringLiteral("kfile/bookmarks.xml"));
+        if (bookmarksFile.isEmpty()) {
+            QString genericDataLocation = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation);
+            if (genericDataLocation.isEmpty()) {
+                qWarning() << "GenericDataLocation is empty! Bookmarks will not be saved correctly.";
+            }
+            bookmarksFile = QStringLiteral("%1/dolphin").arg(genericDataLocation);
+            QDir().mkpath(bookmarksFile);
+            bookmarksFile += QLatin1String("/bookmarks.xml");
+        }
+        manager = std::make_unique<KBookmarkManager>(bookmarksFile);
+    }
+    return manager.get();
+}
+
 #include "moc_dolphinbookmarkhandler.cpp"
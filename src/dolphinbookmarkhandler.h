@@ -7,13 +7,13 @@
 #ifndef DOLPHINBOOKMARKHANDLER_H
 #define DOLPHINBOOKMARKHANDLER_H
 
-#include <KBookmarkManager>
 #include <KBookmarkOwner>
 #include <QObject>
 
 class DolphinMainWindow;
 class DolphinViewContainer;
 class KActionCollection;
+class KBookmarkManager;
 class KBookmarkMenu;
 class QMenu;
 
@@ -39,9 +39,15 @@ private:
     static QUrl url(DolphinViewContainer *viewContainer);
     static QString icon(DolphinViewContainer *viewContainer);
 
+    /**
+     * Returns the KBookmarkManager shared by all windows of this process, so
+     * that bookmarks.xml is located and parsed only once. The manager watches
+     * the file and reloads when it changes on disk.
+     */
+    static KBookmarkManager *bookmarkManager();
+
 private:
     DolphinMainWindow *m_mainWindow;
-    std::unique_ptr<KBookmarkManager> m_bookmarkManager;
     QScopedPointer<KBookmarkMenu> m_bookmarkMenu;
 };
 
@@ -0,0 +1,142 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "dolphincachegovernor.h"
+
+#include "dolphin_generalsettings.h"
+#include "dolphintabpage.h"
+#include "kitemviews/private/kmemoryaccounting.h"
+
+#include <QTimer>
+
+namespace
+{
+// Interval in ms between two looks at the memory budget. The check itself
+// sweeps the byte estimators of KMemoryAccounting, which is cheap enough for
+// a background task but not free, so it is not run more often than this.
+const int GovernInterval = 30000;
+
+// Time in ms a tab page must have been in the background before any of its
+// caches are touched. Quick tab switches must never cost previews.
+const qint64 MinIdleTimeBeforeDemotion = 5 * 60000;
+
+// Upper bound for the demotion steps per govern run, so that one run cannot
+// stall the GUI thread by trimming many large models back to back.
+const int MaxDemotionsPerRun = 4;
+
+// A tab page past this stage has nothing left to demote,
+// see DolphinCacheGovernor::governCaches().
+const int FinalDemotionStage = 3;
+}
+
+struct DolphinCacheGovernorSingleton {
+    DolphinCacheGovernor instance;
+};
+Q_GLOBAL_STATIC(DolphinCacheGovernorSingleton, s_dolphinCacheGovernor)
+
+DolphinCacheGovernor *DolphinCacheGovernor::instance()
+{
+    return &s_dolphinCacheGovernor->instance;
+}
+
+DolphinCacheGovernor::DolphinCacheGovernor()
+    : QObject(nullptr)
+    , m_tabStates()
+    , m_governTimer(nullptr)
+    , m_clock()
+{
+    m_clock.start();
+
+    m_governTimer = new QTimer(this);
+    m_governTimer->setInterval(GovernInterval);
+    connect(m_governTimer, &QTimer::timeout, this, &DolphinCacheGovernor::governCaches);
+}
+
+void DolphinCacheGovernor::registerTabPage(DolphinTabPage *tabPage)
+{
+    m_tabStates.insert(tabPage, TabState{m_clock.elapsed(), 0});
+    if (!m_governTimer->isActive()) {
+        m_governTimer->start();
+    }
+}
+
+void DolphinCacheGovernor::unregisterTabPage(DolphinTabPage *tabPage)
+{
+    m_tabStates.remove(tabPage);
+    if (m_tabStates.isEmpty()) {
+        m_governTimer->stop();
+    }
+}
+
+void DolphinCacheGovernor::setTabPageActive(DolphinTabPage *tabPage, bool active)
+{
+    const auto it = m_tabStates.find(tabPage);
+    if (it == m_tabStates.end()) {
+        return;
+    }
+
+    if (active) {
+        it->idleSince = -1;
+        it->demotionStage = 0;
+    } else if (it->idleSince < 0) {
+        it->idleSince = m_clock.elapsed();
+    }
+}
+
+void DolphinCacheGovernor::governCaches()
+{
+    const qint64 budget = qint64(GeneralSettings::cacheMemoryBudget()) * 1024 * 1024;
+    if (budget <= 0) {
+        return;
+    }
+
+    for (int demotions = 0; demotions < MaxDemotionsPerRun; ++demotions) {
+        if (KMemoryAccounting::instance()->totalBytes() <= budget) {
+            return;
+        }
+
+        // Demote the tab page which has been idle the longest. A tab page
+        // that is still above the final stage threshold keeps its remaining
+        // caches until the budget check fails again.
+        DolphinTabPage *candidate = nullptr;
+        qint64 candidateIdleSince = 0;
+        const qint64 now = m_clock.elapsed();
+        for (auto it = m_tabStates.constBegin(); it != m_tabStates.constEnd(); ++it) {
+            if (it->idleSince < 0 || it->demotionStage >= FinalDemotionStage) {
+                continue;
+            }
+            if (now - it->idleSince < MinIdleTimeBeforeDemotion) {
+                continue;
+            }
+            if (!candidate || it->idleSince < candidateIdleSince) {
+                candidate = it.key();
+                candidateIdleSince = it->idleSince;
+            }
+        }
+
+        if (!candidate) {
+            return;
+        }
+
+        TabState &state = m_tabStates[candidate];
+        ++state.demotionStage;
+        switch (state.demotionStage) {
+        case 1:
+            candidate->trimCachedPreviews();
+            break;
+        case 2:
+            candidate->trimCachedRoleValues();
+            break;
+        case 3:
+            candidate->dehydrate();
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+#include "moc_dolphincachegovernor.cpp"
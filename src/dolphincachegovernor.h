@@ -0,0 +1,71 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef DOLPHINCACHEGOVERNOR_H
+#define DOLPHINCACHEGOVERNOR_H
+
+#include "dolphin_export.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+
+class DolphinTabPage;
+class QTimer;
+
+/**
+ * @brief Process-wide governor which trims the caches of idle background tabs.
+ *
+ * A week-long session with dozens of tabs accumulates item models, preview
+ * pixmaps and recycled widgets with no natural reclamation point. The
+ * governor periodically compares the byte estimate of KMemoryAccounting
+ * against the configured budget (GeneralSettings::cacheMemoryBudget()) and,
+ * while the session is above it, demotes the longest-idle background tabs
+ * one stage at a time: first their preview pixmaps are dropped, then their
+ * cached role values, and finally the whole tab page is dehydrated so that
+ * only its saved state remains. Every stage is transparent to the user: the
+ * caches are rebuilt on demand and a dehydrated tab page hydrates again on
+ * the next activation.
+ */
+class DOLPHIN_EXPORT DolphinCacheGovernor : public QObject
+{
+    Q_OBJECT
+
+public:
+    static DolphinCacheGovernor *instance();
+
+    /** Called by every DolphinTabPage on construction. */
+    void registerTabPage(DolphinTabPage *tabPage);
+
+    /** Must be called before \a tabPage is destroyed. */
+    void unregisterTabPage(DolphinTabPage *tabPage);
+
+    /**
+     * Informs the governor that \a tabPage was activated or put into the
+     * background. Activating a tab page protects it from demotion and resets
+     * its demotion stage.
+     */
+    void setTabPageActive(DolphinTabPage *tabPage, bool active);
+
+private Q_SLOTS:
+    void governCaches();
+
+private:
+    DolphinCacheGovernor();
+
+    struct TabState {
+        qint64 idleSince = -1; // Milliseconds on m_clock, or -1 while the tab page is active.
+        int demotionStage = 0;
+    };
+
+    QHash<DolphinTabPage *, TabState> m_tabStates;
+    QTimer *m_governTimer;
+    QElapsedTimer m_clock;
+
+    friend struct DolphinCacheGovernorSingleton;
+};
+
+#endif
@@ -8,12 +8,14 @@
 
 #include "dolphin_contextmenusettings.h"
 #include "dolphin_generalsettings.h"
+#include "dolphinduplicatechecker.h"
 #include "dolphinmainwindow.h"
 #include "dolphinnewfilemenu.h"
 #include "dolphinplacesmodelsingleton.h"
 #include "dolphinremoveaction.h"
 #include "dolphinviewcontainer.h"
 #include "global.h"
+#include "statusbar/dolphinstatusbar.h"
 #include "settings/dolphinsettingsdialog.h"
 #include "trash/dolphintrash.h"
 #include "views/dolphinview.h"
@@ -34,12 +36,15 @@
 #include <QClipboard>
 #include <QKeyEvent>
 #include <QAction>
+#include <QPointer>
+#include <QTimer>
 
 DolphinContextMenu::DolphinContextMenu(DolphinMainWindow *parent,
                                        const KFileItem &fileInfo,
                                        const KFileItemList &selectedItems,
                                        const QUrl &baseUrl,
-                                       KFileItemActions *fileItemActions)
+                                       KFileItemActions *fileItemActions,
+                                       Population population)
     : QMenu(parent)
     , m_mainWindow(parent)
     , m_fileInfo(fileInfo)
@@ -51,10 +56,20 @@ DolphinContextMenu::DolphinContextMenu(DolphinMainWindow *parent,
     , m_copyToMenu(parent)
     , m_removeAction(nullptr)
     , m_fileItemActions(fileItemActions)
+    , m_population(population)
+    , m_openWithMarker(nullptr)
+    , m_additionalActionsMarker(nullptr)
 {
     QApplication::instance()->installEventFilter(this);
 
     addAllActions();
+
+    if (m_openWithMarker || m_additionalActionsMarker) {
+        // Resolving applications and service menus takes long enough to delay painting
+        // the menu noticeably, so it happens once the menu is already on screen:
+        // the zero timer fires inside the nested event loop of exec().
+        QTimer::singleShot(0, this, &DolphinContextMenu::addDeferredActions);
+    }
 }
 
 DolphinContextMenu::~DolphinContextMenu()
@@ -220,7 +235,6 @@ void DolphinContextMenu::addDirectoryItemContextMenu()
     QAction *newFileAction = m_mainWindow->actionCollection()->action(QStringLiteral("create_file"));
     // Do not parent this to the menu, it has to outlive it. It is deleted manually below once a file has been created.
     DolphinNewFileMenu *newFileMenu = new DolphinNewFileMenu(newDirAction, newFileAction, m_mainWindow);
-    newFileMenu->checkUpToDate();
     newFileMenu->setWorkingDirectory(m_fileInfo.url());
     newFileMenu->setEnabled(selectedItemsProps.supportsWriting());
     connect(newFileMenu, &DolphinNewFileMenu::fileCreated, newFileMenu, &DolphinNewFileMenu::deleteLater);
@@ -231,6 +245,9 @@ void DolphinContextMenu::addDirectoryItemContextMenu()
     QMenu *menu = newFileMenu->menu();
     menu->setTitle(i18nc("@title:menu Create new folder, file, link, etc.", "Create New"));
     menu->setIcon(QIcon::fromTheme(QStringLiteral("list-add")));
+    // Enumerating the templates can stall on slow template directories (e.g.
+    // NFS mounts), so do it only once the submenu is actually about to show.
+    connect(menu, &QMenu::aboutToShow, newFileMenu, &DolphinNewFileMenu::checkUpToDate);
     addMenu(menu);
 
     addSeparator();
@@ -326,20 +343,88 @@ void DolphinContextMenu::addItemContextMenu()
         }
     }
 
+    if (DolphinDuplicateChecker::canCheck(m_selectedItems)) {
+        addAction(QIcon::fromTheme(QStringLiteral("checkmark")),
+                  i18nc("@action:inmenu Checks which of the selected files have identical contents", "Compare Contents"),
+                  this,
+                  &DolphinContextMenu::startDuplicateCheck);
+    }
+
     // insert 'Properties...' entry
     addSeparator();
     QAction *propertiesAction = m_mainWindow->actionCollection()->action(QStringLiteral("properties"));
     addAction(propertiesAction);
 }
 
+void DolphinContextMenu::startDuplicateCheck()
+{
+    auto *checker = new DolphinDuplicateChecker(m_selectedItems, m_mainWindow);
+    const int fileCount = checker->fileCount();
+    DolphinViewContainer *container = m_mainWindow->activeViewContainer();
+    const QString taskTitle = i18nc("@info:progress", "Comparing file contents");
+
+    // All connections below use the container or the main window as context,
+    // because the checker outlives this menu.
+    connect(checker, &DolphinDuplicateChecker::progressChanged, container, [container, taskTitle](int percent) {
+        container->statusBar()->showProgress(taskTitle, percent);
+    });
+    connect(container->statusBar(), &DolphinStatusBar::stopPressed, checker, &DolphinDuplicateChecker::stop);
+    connect(checker, &DolphinDuplicateChecker::canceled, container, [container, taskTitle]() {
+        container->statusBar()->showProgress(taskTitle, 100);
+    });
+    connect(checker, &DolphinDuplicateChecker::canceled, checker, &QObject::deleteLater);
+
+    QPointer<DolphinViewContainer> containerGuard(container);
+    connect(checker,
+            &DolphinDuplicateChecker::finished,
+            m_mainWindow,
+            [checker, containerGuard, taskTitle, fileCount](const QList<QList<QUrl>> &identicalGroups) {
+                checker->deleteLater();
+                if (!containerGuard) {
+                    return;
+                }
+                containerGuard->statusBar()->showProgress(taskTitle, 100);
+
+                int duplicateFileCount = 0;
+                for (const QList<QUrl> &group : identicalGroups) {
+                    duplicateFileCount += group.count();
+                }
+
+                QString message;
+                if (identicalGroups.isEmpty()) {
+                    message = i18nc("@info:status %1 is a number greater than 1", "No two of the %1 compared files have identical contents.", fileCount);
+                } else if (duplicateFileCount == fileCount && identicalGroups.count() == 1) {
+                    message = i18nc("@info:status %1 is a number greater than 1", "All %1 compared files have identical contents.", fileCount);
+                } else {
+                    message = i18ncp("@info:status %2 and %3 are numbers greater than 1",
+                                     "%2 of the %3 compared files have identical contents, forming one group of duplicates.",
+                                     "%2 of the %3 compared files have identical contents, forming %1 groups of duplicates.",
+                                     identicalGroups.count(),
+                                     duplicateFileCount,
+                                     fileCount);
+                }
+
+                KMessageWidget::MessageType messageType = KMessageWidget::Information;
+                if (checker->unreadableFileCount() > 0) {
+                    message += QLatin1Char(' ')
+                        + i18ncp("@info:status", "One file could not be read.", "%1 files could not be read.", checker->unreadableFileCount());
+                    messageType = KMessageWidget::Warning;
+                }
+                containerGuard->showMessage(message, messageType);
+            });
+
+    checker->start();
+}
+
 void DolphinContextMenu::addViewportContextMenu()
 {
     const KFileItemListProperties baseUrlProperties(KFileItemList() << baseFileItem());
     m_fileItemActions->setItemListProperties(baseUrlProperties);
 
-    // Set up and insert 'Create New' menu
+    // Set up and insert 'Create New' menu. No checkUpToDate() here: the
+    // main window refreshes this menu lazily on its aboutToShow, so opening
+    // the context menu never waits for the template directories.
     KNewFileMenu *newFileMenu = m_mainWindow->newFileMenu();
-    newFileMenu->checkUpToDate();
     newFileMenu->setWorkingDirectory(m_baseUrl);
     addMenu(newFileMenu->menu());
 
@@ -488,9 +573,22 @@ KFileItem DolphinContextMenu::baseFileItem()
 }
 
 void DolphinContextMenu::addOpenWithActions()
+{
+    if (m_population == Population::Deferred) {
+        // Only mark the position; resolving the applications is deferred
+        // until the menu is visible.
+        m_openWithMarker = addSeparator();
+        m_openWithMarker->setVisible(false);
+        return;
+    }
+
+    insertOpenWithActions(nullptr);
+}
+
+void DolphinContextMenu::insertOpenWithActions(QAction *before)
 {
     // insert 'Open With...' action or sub menu
-    m_fileItemActions->insertOpenWithActionsTo(nullptr, this, QStringList{qApp->desktopFileName()});
+    m_fileItemActions->insertOpenWithActionsTo(before, this, QStringList{qApp->desktopFileName()});
 
     // For a single file, hint in "Open with" menu that middle-clicking would open it in the secondary app,
     // and shift + middle-clicking would open it in the third associated app.
@@ -527,10 +625,26 @@ void DolphinContextMenu::addAdditionalActions(const KFileItemListProperties &pro
 {
     addSeparator();
 
+    if (m_population == Population::Deferred) {
+        // Only mark the position; resolving the service menus is deferred
+        // until the menu is visible.
+        m_additionalActionsMarker = addSeparator();
+        m_additionalActionsMarker->setVisible(false);
+        m_deferredActionsProperties = props;
+        return;
+    }
+
+    insertAdditionalActions(nullptr, props);
+}
+
+void DolphinContextMenu::insertAdditionalActions(QAction *before, const KFileItemListProperties &props)
+{
     QList<QAction *> additionalActions;
     if (props.isLocal() && ContextMenuSettings::showOpenTerminal()) {
         additionalActions << m_mainWindow->actionCollection()->action(QStringLiteral("open_terminal_here"));
     }
+
+    const int actionCountBefore = actions().count();
     m_fileItemActions->addActionsTo(this, KFileItemActions::MenuActionSource::All, additionalActions);
 
     const DolphinView *view = m_mainWindow->activeViewContainer()->view();
@@ -540,6 +654,30 @@ void DolphinContextMenu::addAdditionalActions(const KFileItemListProperties &pro
         addActions(versionControlActions);
         addSeparator();
     }
+
+    if (before) {
+        // KFileItemActions::addActionsTo() can only append, so move everything
+        // that was appended to the marked position.
+        const QList<QAction *> appendedActions = actions().mid(actionCountBefore);
+        for (QAction *action : appendedActions) {
+            removeAction(action);
+        }
+        insertActions(before, appendedActions);
+    }
+}
+
+void DolphinContextMenu::addDeferredActions()
+{
+    // The expensive sections are resolved for the properties the skeleton was
+    // built with, even if m_fileItemActions was used elsewhere in between.
+    m_fileItemActions->setItemListProperties(m_deferredActionsProperties);
+
+    if (m_openWithMarker) {
+        insertOpenWithActions(m_openWithMarker);
+    }
+    if (m_additionalActionsMarker) {
+        insertAdditionalActions(m_additionalActionsMarker, m_deferredActionsProperties);
+    }
 }
 
 #include "moc_dolphincontextmenu.cpp"
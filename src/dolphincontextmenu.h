@@ -10,13 +10,13 @@
 #include <KFileCopyToMenu>
 #include <KFileItem>
 #include <KFileItemActions>
+#include <KFileItemListProperties>
 
 #include <QMenu>
 #include <QUrl>
 
 class QAction;
 class DolphinMainWindow;
-class KFileItemListProperties;
 class DolphinRemoveAction;
 
 /**
@@ -36,6 +36,16 @@ class DolphinContextMenu : public QMenu
     Q_OBJECT
 
 public:
+    /**
+     * Controls when the expensive menu sections ('Open With' application
+     * resolution and the service menus) are added. With Deferred the static
+     * skeleton is built immediately and the expensive sections are filled in
+     * on the next event loop iteration, which is inside exec() once the menu
+     * is already on screen. Use Immediate when the actions are harvested
+     * without ever showing the menu.
+     */
+    enum class Population { Deferred, Immediate };
+
     /**
      * @parent        Pointer to the main window the context menu
      *                belongs to.
@@ -46,12 +56,15 @@ public:
      *                is opened. This list generally includes \a fileInfo.
      * @baseUrl       Base URL of the viewport where the context menu
      *                should be opened.
+     * @population    Whether the expensive menu sections are added
+     *                right away or deferred until the menu is visible.
      */
     DolphinContextMenu(DolphinMainWindow *parent,
                        const KFileItem &fileInfo,
                        const KFileItemList &selectedItems,
                        const QUrl &baseUrl,
-                       KFileItemActions *fileItemActions);
+                       KFileItemActions *fileItemActions,
+                       Population population = Population::Deferred);
 
     ~DolphinContextMenu() override;
 
@@ -85,20 +98,48 @@ private:
     KFileItem baseFileItem();
 
     /**
-     * Adds "Open With" actions
+     * Adds "Open With" actions, or merely a position marker for them if the
+     * population is deferred.
      */
     void addOpenWithActions();
 
     /**
-     * Add services, custom actions, plugins and version control items to the menu
+     * Add services, custom actions, plugins and version control items to the
+     * menu, or merely a position marker for them if the population is deferred.
      */
     void addAdditionalActions(const KFileItemListProperties &props);
 
+    /**
+     * Inserts the 'Open With' actions before \a before, or appends them
+     * if \a before is nullptr.
+     */
+    void insertOpenWithActions(QAction *before);
+
+    /**
+     * Inserts the service menus, custom actions, plugins and version control
+     * items before \a before, or appends them if \a before is nullptr.
+     */
+    void insertAdditionalActions(QAction *before, const KFileItemListProperties &props);
+
+    /**
+     * Fills in the sections that were skipped while building the skeleton.
+     * Runs on the next event loop iteration after construction, so the menu
+     * is typically already visible inside exec() by then.
+     */
+    void addDeferredActions();
+
 private:
     void addDirectoryItemContextMenu();
     void addOpenParentFolderActions();
     void configureTrash();
 
+    /**
+     * Starts a DolphinDuplicateChecker for the selected items. Progress is
+     * streamed to the status bar of the active view container and the result
+     * is shown there as a message. The checker outlives this menu.
+     */
+    void startDuplicateCheck();
+
     struct Entry {
         int type;
         QString name;
@@ -132,6 +173,15 @@ private:
 
     DolphinRemoveAction *m_removeAction; // Action that represents either 'Move To Trash' or 'Delete'
     KFileItemActions *m_fileItemActions;
+
+    Population m_population;
+
+    /// Invisible separators marking where the deferred sections are inserted.
+    QAction *m_openWithMarker;
+    QAction *m_additionalActionsMarker;
+
+    /// The item list properties the deferred sections are resolved for.
+    KFileItemListProperties m_deferredActionsProperties;
 };
 
 #endif
@@ -0,0 +1,356 @@
+/*
+    SPDX-FileCopyrightText: 2026 The Dolphin Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "dolphinduplicatechecker.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+namespace
+{
+// How many bytes of each file are hashed in the partial-hash stage. Large
+// enough that differing files practically always diverge within it, small
+// enough that a selection of large files is triaged with little I/O.
+constexpr qint64 PartialHashSize = 128 * 1024;
+
+// The hashing reads files in chunks of this size, so that progress moves
+// and cancelling reacts even while a single huge file is being hashed.
+constexpr qint64 HashChunkSize = 8 * 1024 * 1024;
+}
+
+struct DolphinDuplicateChecker::CheckerState {
+    struct Task {
+        QString path;
+        qint64 size;
+        /** Whether the whole file is hashed instead of only its first PartialHashSize bytes. */
+        bool fullHash;
+    };
+
+    QMutex mutex;
+    QWaitCondition workAvailable;
+    /** Hashing tasks that no worker has picked up yet. */
+    std::vector<Task> pendingTasks;
+    /** Number of workers currently hashing a file. */
+    int busyWorkers = 0;
+    /** Number of workers that have not exited their loop yet. The last one
+     * to leave computes and reports the result. */
+    int activeWorkers = 0;
+    /** 1 while the partial hashes are computed, 2 afterwards. */
+    int stage = 1;
+    QAtomicInt stopped;
+
+    /** Size of each file. Filled before the workers start, read-only afterwards. */
+    QHash<QString, qint64> sizes;
+    /** Hash of the first PartialHashSize bytes per file. Guarded by mutex. */
+    QHash<QString, QByteArray> partialHashes;
+    /** Hash of the complete contents per file. Guarded by mutex. */
+    QHash<QString, QByteArray> fullHashes;
+    /** Files that could not be opened or read. Guarded by mutex. */
+    QStringList unreadablePaths;
+
+    /** Bytes hashed so far resp. planned in total, for progress reporting. */
+    QAtomicInteger<qint64> hashedBytes;
+    QAtomicInteger<qint64> totalBytes;
+    QAtomicInt lastReportedPercent;
+
+    /**
+     * Schedules full hashes for every file whose size and partial hash still
+     * collide with another file. Must be called with the mutex held and no
+     * worker busy.
+     */
+    void scheduleFullHashTasks();
+};
+
+void DolphinDuplicateChecker::CheckerState::scheduleFullHashTasks()
+{
+    QHash<QByteArray, QStringList> collidingPaths;
+    for (auto it = partialHashes.constBegin(); it != partialHashes.constEnd(); ++it) {
+        const qint64 size = sizes.value(it.key());
+        if (size <= PartialHashSize) {
+            // The partial hash already covered the whole file.
+            continue;
+        }
+        collidingPaths[QByteArray::number(size) + ':' + it.value()].append(it.key());
+    }
+
+    for (const QStringList &paths : std::as_const(collidingPaths)) {
+        if (paths.count() < 2) {
+            continue;
+        }
+        for (const QString &path : paths) {
+            pendingTasks.push_back({path, sizes.value(path), true});
+            totalBytes.fetchAndAddRelaxed(sizes.value(path));
+        }
+    }
+}
+
+DolphinDuplicateChecker::DolphinDuplicateChecker(const KFileItemList &items, QObject *parent)
+    : QObject(parent)
+{
+    m_files.reserve(items.count());
+    for (const KFileItem &item : items) {
+        if (item.isLocalFile() && !item.isDir()) {
+            m_files.emplace_back(item.localPath(), static_cast<qint64>(item.size()));
+        }
+    }
+}
+
+DolphinDuplicateChecker::~DolphinDuplicateChecker()
+{
+    // Like stop(), but without emitting canceled() mid-destruction.
+    m_running = false;
+    if (m_state) {
+        m_state->stopped.storeRelaxed(1);
+        QMutexLocker locker(&m_state->mutex);
+        m_state->workAvailable.wakeAll();
+    }
+    m_pool.waitForDone();
+}
+
+bool DolphinDuplicateChecker::canCheck(const KFileItemList &items)
+{
+    int comparableFileCount = 0;
+    for (const KFileItem &item : items) {
+        if (item.isLocalFile() && !item.isDir() && ++comparableFileCount == 2) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int DolphinDuplicateChecker::fileCount() const
+{
+    return static_cast<int>(m_files.size());
+}
+
+int DolphinDuplicateChecker::unreadableFileCount() const
+{
+    return m_state ? m_state->unreadablePaths.count() : 0;
+}
+
+void DolphinDuplicateChecker::start()
+{
+    Q_ASSERT_X(!m_state, "DolphinDuplicateChecker::start()", "A checker instance may only be started once.");
+
+    m_state = std::make_shared<CheckerState>();
+    m_running = true;
+
+    // First stage: group by size without any I/O. Only a file that shares
+    // its size with another file can possibly have a duplicate.
+    QHash<qint64, int> sizeCounts;
+    for (const auto &file : m_files) {
+        ++sizeCounts[file.second];
+    }
+    for (const auto &[path, size] : m_files) {
+        m_state->sizes.insert(path, size);
+        if (sizeCounts.value(size) > 1) {
+            m_state->pendingTasks.push_back({path, size, false});
+            m_state->totalBytes.fetchAndAddRelaxed(qMin(size, PartialHashSize));
+        }
+    }
+
+    if (m_state->pendingTasks.empty()) {
+        // Every size is unique - the answer is known without reading a byte.
+        QMetaObject::invokeMethod(
+            this,
+            [this]() {
+                if (m_running) {
+                    m_running = false;
+                    Q_EMIT finished({});
+                }
+            },
+            Qt::QueuedConnection);
+        return;
+    }
+
+    const int workerCount = qMax(1, qMin(QThread::idealThreadCount(), static_cast<int>(m_state->pendingTasks.size())));
+    m_state->activeWorkers = workerCount;
+    m_pool.setMaxThreadCount(workerCount);
+
+    const std::shared_ptr<CheckerState> state = m_state;
+    for (int i = 0; i < workerCount; ++i) {
+        m_pool.start([this, state]() {
+            work(state);
+        });
+    }
+}
+
+void DolphinDuplicateChecker::stop()
+{
+    if (!m_running) {
+        return;
+    }
+    m_running = false;
+    if (m_state) {
+        m_state->stopped.storeRelaxed(1);
+        QMutexLocker locker(&m_state->mutex);
+        m_state->workAvailable.wakeAll();
+    }
+    Q_EMIT canceled();
+}
+
+void DolphinDuplicateChecker::work(const std::shared_ptr<CheckerState> &state)
+{
+    QMutexLocker locker(&state->mutex);
+    while (!state->stopped.loadRelaxed()) {
+        if (state->pendingTasks.empty()) {
+            if (state->busyWorkers == 0) {
+                if (state->stage == 1) {
+                    // All partial hashes are in; queue the full hashes for
+                    // the files that still collide.
+                    state->scheduleFullHashTasks();
+                    state->stage = 2;
+                    if (!state->pendingTasks.empty()) {
+                        state->workAvailable.wakeAll();
+                        continue;
+                    }
+                }
+                state->workAvailable.wakeAll();
+                break;
+            }
+            state->workAvailable.wait(&state->mutex);
+            continue;
+        }
+
+        const CheckerState::Task task = state->pendingTasks.back();
+        state->pendingTasks.pop_back();
+        ++state->busyWorkers;
+        locker.unlock();
+
+        const QByteArray hash = hashFile(task.path, task.fullHash ? task.size : qMin(task.size, PartialHashSize), state);
+
+        locker.relock();
+        if (hash.isNull()) {
+            if (!state->stopped.loadRelaxed()) {
+                state->unreadablePaths.append(task.path);
+            }
+        } else if (task.fullHash) {
+            state->fullHashes.insert(task.path, hash);
+        } else {
+            state->partialHashes.insert(task.path, hash);
+        }
+        --state->busyWorkers;
+        if (state->pendingTasks.empty() && state->busyWorkers == 0) {
+            state->workAvailable.wakeAll();
+        }
+    }
+
+    const bool lastWorker = (--state->activeWorkers == 0);
+    locker.unlock();
+
+    if (lastWorker && !state->stopped.loadRelaxed()) {
+        finish(state);
+    }
+}
+
+QByteArray DolphinDuplicateChecker::hashFile(const QString &path, qint64 bytesToHash, const std::shared_ptr<CheckerState> &state)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    qint64 offset = 0;
+    while (offset < bytesToHash) {
+        if (state->stopped.loadRelaxed()) {
+            return QByteArray();
+        }
+        const qint64 chunkSize = qMin(bytesToHash - offset, HashChunkSize);
+        uchar *mapped = file.map(offset, chunkSize);
+        if (mapped) {
+            hash.addData(QByteArrayView(reinterpret_cast<const char *>(mapped), chunkSize));
+            file.unmap(mapped);
+        } else {
+            // Not every file system supports mapping; read the chunk instead.
+            if (!file.seek(offset)) {
+                return QByteArray();
+            }
+            const QByteArray data = file.read(chunkSize);
+            if (data.size() != chunkSize) {
+                // The file shrank since it was stat'ed, or reading failed.
+                return QByteArray();
+            }
+            hash.addData(data);
+        }
+        offset += chunkSize;
+        state->hashedBytes.fetchAndAddRelaxed(chunkSize);
+        reportProgress(state);
+    }
+    // Hashing zero bytes still yields a non-null result, so a null return
+    // unambiguously means "unreadable".
+    return hash.result();
+}
+
+void DolphinDuplicateChecker::reportProgress(const std::shared_ptr<CheckerState> &state)
+{
+    const qint64 total = state->totalBytes.loadRelaxed();
+    if (total <= 0) {
+        return;
+    }
+    // totalBytes grows when the full-hash stage is scheduled; only ever
+    // reporting increasing values keeps the progress monotonic regardless.
+    const int percent = qBound(0, static_cast<int>(state->hashedBytes.loadRelaxed() * 100 / total), 99);
+    const int lastPercent = state->lastReportedPercent.loadRelaxed();
+    if (percent > lastPercent && state->lastReportedPercent.testAndSetRelaxed(lastPercent, percent)) {
+        QMetaObject::invokeMethod(
+            this,
+            [this, percent]() {
+                if (m_running) {
+                    Q_EMIT progressChanged(percent);
+                }
+            },
+            Qt::QueuedConnection);
+    }
+}
+
+void DolphinDuplicateChecker::finish(const std::shared_ptr<CheckerState> &state)
+{
+    // All workers are done, so the state is read without locking. Files with
+    // a unique size never got a partial hash and cannot have a duplicate;
+    // files that needed a full hash carry it in their key, so files whose
+    // partial hash collided but whose contents differ end up in different
+    // groups.
+    const QSet<QString> unreadablePaths(state->unreadablePaths.constBegin(), state->unreadablePaths.constEnd());
+    QHash<QByteArray, QList<QUrl>> groups;
+    for (const auto &[path, size] : m_files) {
+        if (unreadablePaths.contains(path)) {
+            continue;
+        }
+        const auto partialIt = state->partialHashes.constFind(path);
+        if (partialIt == state->partialHashes.constEnd()) {
+            continue;
+        }
+        QByteArray key = QByteArray::number(size) + ':' + partialIt.value();
+        const auto fullIt = state->fullHashes.constFind(path);
+        if (fullIt != state->fullHashes.constEnd()) {
+            key += ':' + fullIt.value();
+        }
+        groups[key].append(QUrl::fromLocalFile(path));
+    }
+
+    QList<QList<QUrl>> identicalGroups;
+    for (const QList<QUrl> &group : std::as_const(groups)) {
+        if (group.count() > 1) {
+            identicalGroups.append(group);
+        }
+    }
+
+    QMetaObject::invokeMethod(
+        this,
+        [this, identicalGroups]() {
+            if (m_running) {
+                m_running = false;
+                Q_EMIT finished(identicalGroups);
+            }
+        },
+        Qt::QueuedConnection);
+}
+
+#include "moc_dolphinduplicatechecker.cpp"
@@ -0,0 +1,106 @@
+/*
+    SPDX-FileCopyrightText: 2026 The Dolphin Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef DOLPHINDUPLICATECHECKER_H
+#define DOLPHINDUPLICATECHECKER_H
+
+#include "dolphin_export.h"
+
+#include <KFileItem>
+
+#include <QObject>
+#include <QThreadPool>
+#include <QUrl>
+
+#include <memory>
+
+/**
+ * @brief Checks which files of a selection have identical contents.
+ *
+ * The check runs as a staged pipeline so that it reads as little data as
+ * possible: files are first grouped by size (no I/O at all), groups that
+ * share a size are narrowed down by hashing only the first part of each
+ * file, and only files that still collide get hashed completely. The
+ * hashing itself is spread over one worker per core and reads through
+ * mmap where the file system supports it, so checking a large selection
+ * is limited by the storage device rather than by a single core.
+ *
+ * Progress is reported as the share of the bytes that need hashing;
+ * connect to progressChanged() to stream it to a status bar. The result
+ * arrives with finished() on the GUI thread.
+ */
+class DOLPHIN_EXPORT DolphinDuplicateChecker : public QObject
+{
+    Q_OBJECT
+
+public:
+    /** Considers only the local non-directory files of @p items, see canCheck(). */
+    explicit DolphinDuplicateChecker(const KFileItemList &items, QObject *parent = nullptr);
+    ~DolphinDuplicateChecker() override;
+
+    /** @returns whether @p items contains at least two local files to compare. */
+    static bool canCheck(const KFileItemList &items);
+
+    /** @returns the number of files taking part in the check. */
+    int fileCount() const;
+
+    /** @returns the number of files that could not be read. Only meaningful after finished(). */
+    int unreadableFileCount() const;
+
+    /** Starts the check. May only be called once per instance. */
+    void start();
+
+public Q_SLOTS:
+    /** Cancels the check. Emits canceled() unless the check already finished. */
+    void stop();
+
+Q_SIGNALS:
+    /**
+     * Reports how much of the data that needs hashing has been processed.
+     * @param percent A value between 0 and 99; 100 is never reported because
+     *                finished() marks the completion.
+     */
+    void progressChanged(int percent);
+
+    /**
+     * Emitted on the GUI thread once every file has been classified.
+     * @param identicalGroups The URLs of files with identical contents,
+     *                        one list per group of two or more such files.
+     */
+    void finished(const QList<QList<QUrl>> &identicalGroups);
+
+    /** Emitted when the check was stopped before completion. */
+    void canceled();
+
+private:
+    struct CheckerState;
+
+    /** Worker loop: takes hashing tasks from the shared state until none are left. */
+    void work(const std::shared_ptr<CheckerState> &state);
+
+    /**
+     * Hashes the first @p bytesToHash bytes of the file at @p path, through
+     * mmap when possible. @returns a null QByteArray if reading failed or the
+     * check was stopped.
+     */
+    QByteArray hashFile(const QString &path, qint64 bytesToHash, const std::shared_ptr<CheckerState> &state);
+
+    /** Emits progressChanged() on the GUI thread when the percentage grew. */
+    void reportProgress(const std::shared_ptr<CheckerState> &state);
+
+    /** Regroups the finished hashes and emits finished() on the GUI thread. */
+    void finish(const std::shared_ptr<CheckerState> &state);
+
+private:
+    QThreadPool m_pool;
+    std::shared_ptr<CheckerState> m_state;
+    bool m_running = false;
+
+    /** Path and size of every file taking part in the check. */
+    std::vector<std::pair<QString, qint64>> m_files;
+};
+
+#endif // DOLPHINDUPLICATECHECKER_H
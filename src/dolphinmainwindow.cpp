@@ -18,6 +18,7 @@
 #include "dolphinnewfilemenu.h"
 #include "dolphinplacesmodelsingleton.h"
 #include "dolphinrecenttabsmenu.h"
+#include "dolphinstartupprofiler.h"
 #include "dolphintabpage.h"
 #include "dolphinurlnavigatorscontroller.h"
 #include "dolphinviewcontainer.h"
@@ -108,6 +109,9 @@ const int CurrentDolphinVersion = 202;
 const int MaxNumberOfNavigationentries = 12;
 // The maximum number of "Go to Tab" shortcuts
 const int MaxActivateTabShortcuts = 9;
+// How long continuous activity may postpone the session autosave before the
+// session is saved anyway, see DolphinMainWindow::scheduleSessionSave().
+const int SessionSaveMaxPostponeInterval = 5 * 60 * 1000;
 }
 
 DolphinMainWindow::DolphinMainWindow()
@@ -262,6 +266,8 @@ DolphinMainWindow::DolphinMainWindow()
     });
 
     connect(GeneralSettings::self(), &GeneralSettings::splitViewChanged, this, &DolphinMainWindow::slotSplitViewChanged);
+
+    DolphinStartupProfiler::instance()->recordPhase(DolphinStartupProfiler::MainWindowConstructed);
 }
 
 DolphinMainWindow::~DolphinMainWindow()
@@ -283,6 +289,11 @@ QVector<DolphinViewContainer *> DolphinMainWindow::viewContainers() const
 
     for (int i = 0; i < m_tabWidget->count(); ++i) {
         DolphinTabPage *tabPage = m_tabWidget->tabPageAt(i);
+        if (!tabPage->isHydrated()) {
+            // A tab that was restored in a hibernated state has no view
+            // containers until it is activated for the first time.
+            continue;
+        }
 
         viewContainers << tabPage->primaryViewContainer();
         if (tabPage->splitViewEnabled()) {
@@ -616,6 +627,11 @@ bool DolphinMainWindow::event(QEvent *event)
             event->accept();
             return true;
         }
+    } else if (event->type() == QEvent::WindowActivate) {
+        // Mark this instance as the most recently used one, so that
+        // Dolphin::attachToExistingInstance() finds it without having to
+        // interrogate every instance on the session bus.
+        Dolphin::claimInstanceRendezvous();
     }
 
     return KXmlGuiWindow::event(event);
@@ -778,6 +794,21 @@ void DolphinMainWindow::slotSaveSession()
     }
 }
 
+void DolphinMainWindow::scheduleSessionSave()
+{
+    if (!m_sessionSaveTimer->isActive() && !m_sessionSaveScheduled && !m_sessionSaveWatcher->isRunning()) {
+        // This is the first unsaved change since the last save.
+        m_timeSinceUnsavedSessionChange.start();
+    } else if (m_timeSinceUnsavedSessionChange.elapsed() >= SessionSaveMaxPostponeInterval) {
+        // Continuous activity has postponed the save long enough - save now instead of restarting the timer once more.
+        m_sessionSaveTimer->stop();
+        slotSaveSession();
+        return;
+    }
+
+    m_sessionSaveTimer->start();
+}
+
 void DolphinMainWindow::setSessionAutoSaveEnabled(bool enable)
 {
     if (enable) {
@@ -790,9 +821,9 @@ void DolphinMainWindow::setSessionAutoSaveEnabled(bool enable)
             connect(m_sessionSaveTimer, &QTimer::timeout, this, &DolphinMainWindow::slotSaveSession);
         }
 
-        connect(m_tabWidget, &DolphinTabWidget::urlChanged, m_sessionSaveTimer, qOverload<>(&QTimer::start), Qt::UniqueConnection);
-        connect(m_tabWidget, &DolphinTabWidget::tabCountChanged, m_sessionSaveTimer, qOverload<>(&QTimer::start), Qt::UniqueConnection);
-        connect(m_tabWidget, &DolphinTabWidget::activeViewChanged, m_sessionSaveTimer, qOverload<>(&QTimer::start), Qt::UniqueConnection);
+        connect(m_tabWidget, &DolphinTabWidget::urlChanged, this, &DolphinMainWindow::scheduleSessionSave, Qt::UniqueConnection);
+        connect(m_tabWidget, &DolphinTabWidget::tabCountChanged, this, &DolphinMainWindow::scheduleSessionSave, Qt::UniqueConnection);
+        connect(m_tabWidget, &DolphinTabWidget::activeViewChanged, this, &DolphinMainWindow::scheduleSessionSave, Qt::UniqueConnection);
     } else if (m_sessionSaveTimer) {
         m_sessionSaveTimer->stop();
         m_sessionSaveWatcher->disconnect();
@@ -2231,7 +2262,35 @@ void DolphinMainWindow::setupActions()
     bookmarkMenu->setIcon(QIcon::fromTheme(QStringLiteral("bookmarks")));
     // Make the toolbar button version work properly on click
     bookmarkMenu->setPopupMode(QToolButton::InstantPopup);
-    m_bookmarkHandler = new DolphinBookmarkHandler(this, actionCollection(), bookmarkMenu->menu(), this);
+    // Constructing DolphinBookmarkHandler means locating and parsing bookmarks.xml, which is
+    // deferred until the menu is first shown to keep it off the startup path. Until then these
+    // lightweight placeholder actions keep the shortcuts registered and working; they are
+    // replaced by the real KBookmarkMenu actions in createBookmarkHandlerIfNeeded().
+    const struct {
+        const char *name;
+        QString text;
+        const char *icon;
+        QList<QKeySequence> shortcuts;
+    } deferredBookmarkActions[] = {
+        {"add_bookmark", i18nc("@action:inmenu Bookmarks", "Add Bookmark…"), "bookmark-new", KStandardShortcut::addBookmark()},
+        {"edit_bookmarks", i18nc("@action:inmenu Bookmarks", "Edit Bookmarks…"), "bookmarks-organize", {}},
+        {"add_bookmarks_list", i18nc("@action:inmenu Bookmarks", "Bookmark Tabs as Folder…"), "bookmark-new-list", {}},
+    };
+    for (const auto &info : deferredBookmarkActions) {
+        QAction *placeholder = actionCollection()->addAction(QString::fromLatin1(info.name));
+        placeholder->setText(info.text);
+        placeholder->setIcon(QIcon::fromTheme(QString::fromLatin1(info.icon)));
+        actionCollection()->setDefaultShortcuts(placeholder, info.shortcuts);
+        connect(placeholder, &QAction::triggered, this, [this, menu = bookmarkMenu->menu(), name = QString::fromLatin1(info.name)]() {
+            createBookmarkHandlerIfNeeded(menu);
+            if (QAction *realAction = actionCollection()->action(name)) {
+                realAction->trigger();
+            }
+        });
+    }
+    connect(bookmarkMenu->menu(), &QMenu::aboutToShow, this, [this, menu = bookmarkMenu->menu()]() {
+        createBookmarkHandlerIfNeeded(menu);
+    });
     actionCollection()->addAction(QStringLiteral("bookmarks"), bookmarkMenu);
 
     // setup 'Settings' menu
@@ -2591,6 +2650,25 @@ void DolphinMainWindow::setupDockWidgets()
     });
 }
 
+void DolphinMainWindow::createBookmarkHandlerIfNeeded(QMenu *bookmarkMenu)
+{
+    if (m_bookmarkHandler) {
+        return;
+    }
+
+    // The real bookmark actions created by KBookmarkMenu take over from the placeholders
+    // now. The placeholders are removed first so the shortcuts stay unambiguous.
+    const QString deferredActionNames[] = {QStringLiteral("add_bookmark"), QStringLiteral("edit_bookmarks"), QStringLiteral("add_bookmarks_list")};
+    for (const QString &name : deferredActionNames) {
+        if (QAction *placeholder = actionCollection()->action(name)) {
+            actionCollection()->takeAction(placeholder);
+            placeholder->deleteLater();
+        }
+    }
+
+    m_bookmarkHandler = new DolphinBookmarkHandler(this, actionCollection(), bookmarkMenu, this);
+}
+
 void DolphinMainWindow::updateFileAndEditActions()
 {
     const KFileItemList list = m_activeViewContainer->view()->selectedItems();
@@ -22,6 +22,7 @@
 #include "panels/information/informationpanel.h"
 #endif
 
+#include <QElapsedTimer>
 #include <QFutureWatcher>
 #include <QIcon>
 #include <QList>
@@ -683,6 +684,16 @@ private Q_SLOTS:
      */
     void slotSaveSession();
 
+    /**
+     * Marks the session state as dirty and (re)starts the quiet-period timer
+     * m_sessionSaveTimer, so that a burst of state changes - switching
+     * through tabs, opening a split view - is coalesced into a single save.
+     * Continuous activity does not postpone the save forever: once the first
+     * unsaved change is older than SessionSaveMaxPostponeInterval the
+     * session is saved right away.
+     */
+    void scheduleSessionSave();
+
 private:
     /**
      * Sets up the various menus and actions and connects them.
@@ -694,6 +705,13 @@ private:
      */
     void setupDockWidgets();
 
+    /**
+     * Constructs the DolphinBookmarkHandler and with it the bookmark manager and menu contents
+     * on first use. setupActions() only registers lightweight placeholder actions for the
+     * bookmark shortcuts, so the bookmarks file is not located and parsed during startup.
+     */
+    void createBookmarkHandlerIfNeeded(QMenu *bookmarkMenu);
+
     void updateFileAndEditActions();
     void updateViewActions();
     void updateGoActions();
@@ -795,6 +813,8 @@ private:
     QTimer *m_sessionSaveTimer;
     QFutureWatcher<void> *m_sessionSaveWatcher;
     bool m_sessionSaveScheduled;
+    /** Measures the age of the oldest unsaved session state change, see scheduleSessionSave(). */
+    QElapsedTimer m_timeSinceUnsavedSessionChange;
 
     KIO::CommandLauncherJob *m_job;
 
@@ -22,10 +22,20 @@
 #include <QStyle>
 #include <QToolBar>
 
+namespace
+{
+// Minimum time in ms between two adjustSpacing() runs which are driven by
+// resize events. While the splitter between the view containers is dragged,
+// a resize event arrives per mouse move, which can be far more often than
+// frames are drawn.
+const int AdjustSpacingFrameInterval = 1000 / 60;
+}
+
 DolphinNavigatorsWidgetAction::DolphinNavigatorsWidgetAction(QWidget *parent)
     : QWidgetAction{parent}
     , m_splitter{new QSplitter(Qt::Horizontal)}
     , m_adjustSpacingTimer{new QTimer(this)}
+    , m_adjustSpacingFrameTimer{new QTimer(this)}
     , m_viewGeometriesHelper{m_splitter.get(), this}
 {
     updateText();
@@ -39,12 +49,32 @@ DolphinNavigatorsWidgetAction::DolphinNavigatorsWidgetAction(QWidget *parent)
     m_adjustSpacingTimer->setInterval(100);
     m_adjustSpacingTimer->setSingleShot(true);
     connect(m_adjustSpacingTimer.get(), &QTimer::timeout, this, &DolphinNavigatorsWidgetAction::adjustSpacing);
+
+    m_adjustSpacingFrameTimer->setSingleShot(true);
+    connect(m_adjustSpacingFrameTimer.get(), &QTimer::timeout, this, &DolphinNavigatorsWidgetAction::adjustSpacing);
 }
 
 void DolphinNavigatorsWidgetAction::adjustSpacing()
 {
     m_previousWindowWidth = qobject_cast<QWidget *>(parent())->window()->width();
+    m_timeSinceAdjustSpacing.start();
     auto viewGeometries = m_viewGeometriesHelper.viewGeometries();
+
+    const bool hasSecondarySide = m_splitter->count() > 1;
+    const AdjustSpacingInputs adjustSpacingInputs{
+        viewGeometries,
+        m_splitter->width(),
+        primaryUrlNavigator()->sizeHint().width(),
+        hasSecondarySide ? secondaryUrlNavigator()->sizeHint().width() : 0,
+        emptyTrashButton(Primary)->isVisible() || networkFolderButton(Primary)->isVisible(),
+        hasSecondarySide && (emptyTrashButton(Secondary)->isVisible() || networkFolderButton(Secondary)->isVisible())};
+    if (m_lastAdjustSpacingInputs == adjustSpacingInputs) {
+        // The splitter and spacing widths below would come out exactly as they already are. Skipping the recomputation here is more than a micro-optimisation:
+        // applying those widths triggers resize events which feed right back into this method.
+        return;
+    }
+    m_lastAdjustSpacingInputs = adjustSpacingInputs;
+
     const int widthOfSplitterPrimary = viewGeometries.globalXOfPrimary + viewGeometries.widthOfPrimary - viewGeometries.globalXOfNavigatorsWidget;
     const QList<int> splitterSizes = {widthOfSplitterPrimary, m_splitter->width() - widthOfSplitterPrimary - m_splitter->handleWidth()};
     m_splitter->setSizes(splitterSizes);
@@ -338,11 +368,20 @@ bool DolphinNavigatorsWidgetAction::ViewGeometriesHelper::eventFilter(QObject *w
             // Let's wait a bit so the sizes of the navigatorsWidget and the viewContainers have all
             // had a chance to be updated.
             m_navigatorsWidgetAction->m_adjustSpacingTimer->start();
-        } else {
-            m_navigatorsWidgetAction->adjustSpacing();
+        } else if (!m_navigatorsWidgetAction->m_adjustSpacingFrameTimer->isActive()) {
             // We could always use the m_adjustSpacingTimer instead of calling adjustSpacing() directly
             // here but then the navigatorsWidget doesn't fluently align with the viewContainers when
-            // the DolphinTabPage::m_expandViewAnimation is animating.
+            // the DolphinTabPage::m_expandViewAnimation is animating. So the first resize event after
+            // a quiet period is handled synchronously and only the excess events within the same frame
+            // interval - e.g. from dragging the splitter between the view containers - are batched
+            // into one adjustSpacing() run per frame.
+            const QElapsedTimer &timeSinceAdjustSpacing = m_navigatorsWidgetAction->m_timeSinceAdjustSpacing;
+            const qint64 timeSinceLastRun = timeSinceAdjustSpacing.isValid() ? timeSinceAdjustSpacing.elapsed() : AdjustSpacingFrameInterval;
+            if (timeSinceLastRun < AdjustSpacingFrameInterval) {
+                m_navigatorsWidgetAction->m_adjustSpacingFrameTimer->start(AdjustSpacingFrameInterval - timeSinceLastRun);
+            } else {
+                m_navigatorsWidgetAction->adjustSpacing();
+            }
         }
         return false;
     }
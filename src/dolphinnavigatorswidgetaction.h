@@ -10,12 +10,14 @@
 
 #include "dolphinurlnavigator.h"
 
+#include <QElapsedTimer>
 #include <QPointer>
 #include <QSplitter>
 #include <QTimer>
 #include <QWidgetAction>
 
 #include <memory>
+#include <optional>
 
 class KXmlGuiWindow;
 class QPushButton;
@@ -199,6 +201,8 @@ private:
             int widthOfPrimary;
             int globalXOfSecondary;
             int widthOfSecondary;
+
+            bool operator==(const Geometries &other) const = default;
         };
         /**
          * @return a Geometries struct that contains values adjustSpacing() requires.
@@ -216,6 +220,37 @@ private:
 
     ViewGeometriesHelper m_viewGeometriesHelper;
 
+    /**
+     * Everything the spacing computation in adjustSpacing() depends on. Equal
+     * inputs always produce the same spacing, so a run whose inputs match the
+     * previous one is skipped entirely. This matters because the splitter and
+     * spacing changes which adjustSpacing() applies trigger resize events
+     * that feed right back into it.
+     */
+    struct AdjustSpacingInputs {
+        ViewGeometriesHelper::Geometries viewGeometries;
+        int splitterWidth;
+        int primaryUrlNavigatorWidthHint;
+        int secondaryUrlNavigatorWidthHint;
+        bool primaryExtraButtonsVisible;
+        bool secondaryExtraButtonsVisible;
+
+        bool operator==(const AdjustSpacingInputs &other) const = default;
+    };
+    /** The inputs of the most recent adjustSpacing() run. @see AdjustSpacingInputs. */
+    std::optional<AdjustSpacingInputs> m_lastAdjustSpacingInputs;
+
+    /**
+     * Batches the adjustSpacing() calls of rapid successions of resize
+     * events - e.g. while the splitter between the view containers is being
+     * dragged - to at most one per frame interval. The first event after a
+     * quiet period is still handled synchronously so the navigators visibly
+     * stick to the view containers.
+     */
+    std::unique_ptr<QTimer> m_adjustSpacingFrameTimer;
+    /** Time since the most recent adjustSpacing() run. @see m_adjustSpacingFrameTimer. */
+    QElapsedTimer m_timeSinceAdjustSpacing;
+
     /**
      * Used to check if the window has been resized.
      * @see ViewGeometriesHelper::eventFilter() for why this is needed.
@@ -15,9 +15,22 @@
 #include <QDesktopServices>
 #endif
 
+#include <QSet>
 #include <QTimer>
 #include <QtAssert>
 
+#if HAVE_PACKAGEKIT
+namespace
+{
+/**
+ * Package names PackageKit could not resolve earlier in this session.
+ * Repeated feature probes for the same missing tool fail fast instead of
+ * querying the package backend again.
+ */
+QSet<QString> s_unresolvablePackages;
+}
+#endif
+
 DolphinPackageInstaller::DolphinPackageInstaller(const QString &packageName,
                                                  const QUrl &fallBackInstallationPageUrl,
                                                  std::function<bool()> isPackageInstalledCheck,
@@ -27,6 +40,7 @@ DolphinPackageInstaller::DolphinPackageInstaller(const QString &packageName,
     , m_fallBackInstallationPageUrl{fallBackInstallationPageUrl}
     , m_isPackageInstalledCheck{isPackageInstalledCheck}
 {
+    setCapabilities(KJob::Killable);
 }
 
 void DolphinPackageInstaller::start()
@@ -37,11 +51,19 @@ void DolphinPackageInstaller::start()
     }
 
 #if HAVE_PACKAGEKIT
+    if (s_unresolvablePackages.contains(m_packageName)) {
+        slotInstallationFailed(PackageKit::Transaction::ErrorPackageNotFound,
+                               i18nc("@info:shell about system packages", "Could not find package %1.", m_packageName));
+        return;
+    }
+
     PackageKit::Daemon::setHints(PackageKit::Daemon::hints() + QStringList{QStringLiteral("interactive=true")});
-    const PackageKit::Transaction *resolveTransaction = PackageKit::Daemon::resolve(m_packageName);
+    PackageKit::Transaction *resolveTransaction = PackageKit::Daemon::resolve(m_packageName);
+    m_currentTransaction = resolveTransaction;
 
     connect(resolveTransaction, &PackageKit::Transaction::errorCode, this, &DolphinPackageInstaller::slotInstallationFailed);
     connect(resolveTransaction, &PackageKit::Transaction::finished, this, [this]() { // Will be disconnected if we find a package.
+        s_unresolvablePackages.insert(m_packageName);
         slotInstallationFailed(PackageKit::Transaction::ErrorPackageNotFound,
                                i18nc("@info:shell about system packages", "Could not find package %1.", m_packageName));
     });
@@ -54,20 +76,38 @@ void DolphinPackageInstaller::start()
             });
 #else
     QDesktopServices::openUrl(m_fallBackInstallationPageUrl);
-    auto waitForSuccess = new QTimer(this);
-    connect(waitForSuccess, &QTimer::timeout, this, [this]() {
+    m_waitForSuccessTimer = new QTimer(this);
+    connect(m_waitForSuccessTimer, &QTimer::timeout, this, [this]() {
         if (m_isPackageInstalledCheck()) {
             emitResult();
         }
     });
-    waitForSuccess->start(3000);
+    m_waitForSuccessTimer->start(3000);
+#endif
+}
+
+bool DolphinPackageInstaller::doKill()
+{
+#if HAVE_PACKAGEKIT
+    if (m_currentTransaction) {
+        disconnect(m_currentTransaction, nullptr, this, nullptr); // No result may be emitted for a killed job.
+        if (m_currentTransaction->allowCancel()) {
+            m_currentTransaction->cancel();
+        }
+    }
+#else
+    if (m_waitForSuccessTimer) {
+        m_waitForSuccessTimer->stop();
+    }
 #endif
+    return true;
 }
 
 #if HAVE_PACKAGEKIT
 void DolphinPackageInstaller::install(const QString &packageId)
 {
-    const PackageKit::Transaction *installTransaction = PackageKit::Daemon::installPackage(packageId);
+    PackageKit::Transaction *installTransaction = PackageKit::Daemon::installPackage(packageId);
+    m_currentTransaction = installTransaction;
     connectTransactionToJobProgress(*installTransaction);
     connect(installTransaction,
             &PackageKit::Transaction::errorCode,
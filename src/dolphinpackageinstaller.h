@@ -15,8 +15,11 @@
 #endif
 #include <KJob>
 
+#include <QPointer>
 #include <QUrl>
 
+class QTimer;
+
 /**
  * @brief A KJob providing simple means to install a package.
  */
@@ -50,6 +53,14 @@ public:
         return m_errorString;
     };
 
+protected:
+    /**
+     * @see KJob::doKill().
+     * Cancels the currently running PackageKit transaction if there is one and
+     * it allows cancelling, respectively stops polling for a manual installation.
+     */
+    bool doKill() override;
+
 private:
     /** @see KJob::errorString(). */
     inline void setErrorString(const QString &errorString)
@@ -87,6 +98,14 @@ private:
 
     /** @see KJob::errorString(). */
     QString m_errorString;
+
+#if HAVE_PACKAGEKIT
+    /** The transaction this job is currently waiting for, if any. @see doKill(). */
+    QPointer<PackageKit::Transaction> m_currentTransaction;
+#else
+    /** Polls m_isPackageInstalledCheck after the fallback installation page was opened. @see doKill(). */
+    QTimer *m_waitForSuccessTimer = nullptr;
+#endif
 };
 
 #endif // dolphinpackageinstaller_H
@@ -43,6 +43,7 @@
 #include <QRegularExpression>
 #include <QStandardPaths>
 #include <QTextDocument>
+#include <QVBoxLayout>
 
 #include <KPluginFactory>
 
@@ -50,6 +51,8 @@ K_PLUGIN_CLASS_WITH_JSON(DolphinPart, "dolphinpart.json")
 
 DolphinPart::DolphinPart(QWidget *parentWidget, QObject *parent, const KPluginMetaData &metaData, const QVariantList &args)
     : KParts::ReadOnlyPart(parent, metaData)
+    , m_view(nullptr)
+    , m_remoteEncoding(nullptr)
     , m_openTerminalAction(nullptr)
     , m_removeAction(nullptr)
 {
@@ -60,19 +63,69 @@ DolphinPart::DolphinPart(QWidget *parentWidget, QObject *parent, const KPluginMe
     // make sure that other apps using this part find Dolphin's view-file-columns icons
     KIconLoader::global()->addAppDir(QStringLiteral("dolphin"));
 
-    m_view = new DolphinView(QUrl(), parentWidget);
-    m_view->setTabsForFilesEnabled(true);
-    setWidget(m_view);
+    // Constructing the full DolphinView stack dominates the part-creation
+    // time, and embedders instantiate parts up front - often before any URL
+    // is opened. Only a plain host widget is created here; the view and
+    // everything depending on it is materialized in createViewIfNeeded() on
+    // the first openUrl() or view() access.
+    m_viewHost = new QWidget(parentWidget);
+    auto *hostLayout = new QVBoxLayout(m_viewHost);
+    hostLayout->setContentsMargins(0, 0, 0, 0);
+    setWidget(m_viewHost);
 
     connect(&DolphinNewFileMenuObserver::instance(), &DolphinNewFileMenuObserver::errorMessage, this, &DolphinPart::slotErrorMessage);
 
+    setXMLFile(QStringLiteral("dolphinpart.rc"));
+
+    // The actions have to exist before the embedder merges the part's GUI,
+    // so they cannot be deferred. DolphinViewActionHandler works without a
+    // view until setCurrentView() is called in createViewIfNeeded().
+    m_actionHandler = new DolphinViewActionHandler(actionCollection(), nullptr, this);
+    connect(m_actionHandler, &DolphinViewActionHandler::createDirectoryTriggered, this, &DolphinPart::createDirectory);
+
+    QClipboard *clipboard = QApplication::clipboard();
+    connect(clipboard, &QClipboard::dataChanged, this, &DolphinPart::updatePasteAction);
+
+    // Create the file info, listing filter and listing notification
+    // extensions. They have to exist while the embedder sets the part up,
+    // but they only touch the view once they are actually used.
+    new DolphinPartFileInfoExtension(this);
+
+    new DolphinPartListingFilterExtension(this);
+
+    m_notificationExtension = new DolphinPartListingNotificationExtension(this);
+
+    createActions();
+    slotSelectionChanged(KFileItemList()); // initially disable selection-dependent actions
+
+    // Listen to events from the app so we can update the remove key by
+    // checking for a Shift key press.
+    qApp->installEventFilter(this);
+
+    // TODO there was a "always open a new window" (when clicking on a directory) setting in konqueror
+    // (sort of spacial navigation)
+}
+
+DolphinPart::~DolphinPart()
+{
+}
+
+void DolphinPart::createViewIfNeeded()
+{
+    if (m_view) {
+        return;
+    }
+
+    m_view = new DolphinView(QUrl(), m_viewHost);
+    m_view->setTabsForFilesEnabled(true);
+    m_viewHost->layout()->addWidget(m_view);
+    m_viewHost->setFocusProxy(m_view);
+
     connect(m_view, &DolphinView::directoryLoadingCompleted, this, &KParts::ReadOnlyPart::completed);
     connect(m_view, &DolphinView::directoryLoadingCompleted, this, &DolphinPart::updatePasteAction);
     connect(m_view, &DolphinView::directoryLoadingProgress, this, &DolphinPart::updateProgress);
     connect(m_view, &DolphinView::errorMessage, this, &DolphinPart::slotErrorMessage);
 
-    setXMLFile(QStringLiteral("dolphinpart.rc"));
-
     connect(m_view, &DolphinView::infoMessage, this, &DolphinPart::slotMessage);
     connect(m_view, &DolphinView::operationCompletedMessage, this, &DolphinPart::slotMessage);
     connect(m_view, &DolphinView::errorMessage, this, &DolphinPart::slotErrorMessage);
@@ -95,45 +148,23 @@ DolphinPart::DolphinPart(QWidget *parentWidget, QObject *parent, const KPluginMe
     connect(m_view, &DolphinView::itemCountChanged, this, &DolphinPart::updateStatusBar);
     connect(m_view, &DolphinView::selectionChanged, this, &DolphinPart::updateStatusBar);
 
-    m_actionHandler = new DolphinViewActionHandler(actionCollection(), nullptr, this);
     m_actionHandler->setCurrentView(m_view);
-    connect(m_actionHandler, &DolphinViewActionHandler::createDirectoryTriggered, this, &DolphinPart::createDirectory);
+    m_actionHandler->updateViewActions();
 
     m_remoteEncoding = new DolphinRemoteEncoding(this, m_actionHandler);
     connect(this, &DolphinPart::aboutToOpenURL, m_remoteEncoding, &DolphinRemoteEncoding::slotAboutToOpenUrl);
 
-    QClipboard *clipboard = QApplication::clipboard();
-    connect(clipboard, &QClipboard::dataChanged, this, &DolphinPart::updatePasteAction);
-
-    // Create file info and listing filter extensions.
-    // NOTE: Listing filter needs to be instantiated after the creation of the view.
-    new DolphinPartFileInfoExtension(this);
-
-    new DolphinPartListingFilterExtension(this);
-
     KDirLister *lister = m_view->m_model->m_dirLister;
     if (lister) {
-        DolphinPartListingNotificationExtension *notifyExt = new DolphinPartListingNotificationExtension(this);
-        connect(lister, &KDirLister::newItems, notifyExt, &DolphinPartListingNotificationExtension::slotNewItems);
-        connect(lister, &KDirLister::itemsDeleted, notifyExt, &DolphinPartListingNotificationExtension::slotItemsDeleted);
+        connect(lister, &KDirLister::newItems, m_notificationExtension, &DolphinPartListingNotificationExtension::slotNewItems);
+        connect(lister, &KDirLister::itemsDeleted, m_notificationExtension, &DolphinPartListingNotificationExtension::slotItemsDeleted);
     } else {
         qCWarning(DolphinDebug) << "NULL KDirLister object! KParts::ListingNotificationExtension will NOT be supported";
     }
 
-    createActions();
-    m_actionHandler->updateViewActions();
-    slotSelectionChanged(KFileItemList()); // initially disable selection-dependent actions
-
-    // Listen to events from the app so we can update the remove key by
-    // checking for a Shift key press.
-    qApp->installEventFilter(this);
-
-    // TODO there was a "always open a new window" (when clicking on a directory) setting in konqueror
-    // (sort of spacial navigation)
-}
-
-DolphinPart::~DolphinPart()
-{
+    if (m_viewHost->isVisible()) {
+        m_view->show();
+    }
 }
 
 void DolphinPart::createActions()
@@ -158,16 +189,28 @@ void DolphinPart::createActions()
     unselectItemsMatching->setText(i18nc("@action:inmenu Edit", "Unselect Items Matching…"));
     connect(unselectItemsMatching, &QAction::triggered, this, &DolphinPart::slotUnselectItemsMatchingPattern);
 
-    KStandardAction::selectAll(m_view, &DolphinView::selectAll, actionCollection());
+    // The selection actions go through view() instead of being connected to
+    // the view directly because the view does not exist yet at this point,
+    // see createViewIfNeeded().
+    KStandardAction::selectAll(
+        this,
+        [this]() {
+            view()->selectAll();
+        },
+        actionCollection());
 
     QAction *unselectAll = actionCollection()->addAction(QStringLiteral("unselect_all"));
     unselectAll->setText(i18nc("@action:inmenu Edit", "Unselect All"));
-    connect(unselectAll, &QAction::triggered, m_view, &DolphinView::clearSelection);
+    connect(unselectAll, &QAction::triggered, this, [this]() {
+        view()->clearSelection();
+    });
 
     QAction *invertSelection = actionCollection()->addAction(QStringLiteral("invert_selection"));
     invertSelection->setText(i18nc("@action:inmenu Edit", "Invert Selection"));
     actionCollection()->setDefaultShortcut(invertSelection, Qt::CTRL | Qt::SHIFT | Qt::Key_A);
-    connect(invertSelection, &QAction::triggered, m_view, &DolphinView::invertSelection);
+    connect(invertSelection, &QAction::triggered, this, [this]() {
+        view()->invertSelection();
+    });
 
     // View menu: all done by DolphinViewActionHandler
 
@@ -254,6 +297,11 @@ void DolphinPart::slotSelectionChanged(const KFileItemList &selection)
 
 void DolphinPart::updatePasteAction()
 {
+    if (!m_view) {
+        // Triggered by clipboard changes; pasting needs an opened directory.
+        return;
+    }
+
     QPair<bool, QString> pasteInfo = m_view->pasteInfo();
     Q_EMIT m_extension->enableAction("paste", pasteInfo.first);
     Q_EMIT m_extension->setActionText("paste", pasteInfo.second);
@@ -273,6 +321,8 @@ QString DolphinPart::urlToLocalFilePath(const QUrl &url)
 
 bool DolphinPart::openUrl(const QUrl &url)
 {
+    createViewIfNeeded();
+
     bool reload = arguments().reload();
     // A bit of a workaround so that changing the namefilter works: force reload.
     // Otherwise DolphinView wouldn't relist the URL, so nothing would happen.
@@ -455,7 +505,7 @@ void DolphinPart::slotUnselectItemsMatchingPattern()
 
 void DolphinPart::openSelectionDialog(const QString &title, const QString &text, bool selectItems)
 {
-    auto *dialog = new QInputDialog(m_view);
+    auto *dialog = new QInputDialog(view());
     dialog->setAttribute(Qt::WA_DeleteOnClose, true);
     dialog->setInputMode(QInputDialog::TextInput);
     dialog->setWindowTitle(title);
@@ -482,7 +532,7 @@ void DolphinPart::openSelectionDialog(const QString &title, const QString &text,
             group.sync();
 
             const QRegularExpression patternRegExp(QRegularExpression::wildcardToRegularExpression(pattern));
-            m_view->selectItems(patternRegExp, selectItems);
+            view()->selectItems(patternRegExp, selectItems);
         }
     });
 
@@ -491,6 +541,8 @@ void DolphinPart::openSelectionDialog(const QString &title, const QString &text,
 
 void DolphinPart::setCurrentViewMode(const QString &viewModeName)
 {
+    createViewIfNeeded();
+
     QAction *action = actionCollection()->action(viewModeName);
     Q_ASSERT(action);
     action->trigger();
@@ -498,6 +550,9 @@ void DolphinPart::setCurrentViewMode(const QString &viewModeName)
 
 QString DolphinPart::currentViewMode() const
 {
+    // The property may be read before the first openUrl(); the action name
+    // comes from the view, so the view has to exist.
+    const_cast<DolphinPart *>(this)->createViewIfNeeded();
     return m_actionHandler->currentViewModeActionName();
 }
 
@@ -563,8 +618,8 @@ void DolphinPart::setFilesToSelect(const QList<QUrl> &files)
         return;
     }
 
-    m_view->markUrlsAsSelected(files);
-    m_view->markUrlAsCurrent(files.at(0));
+    view()->markUrlsAsSelected(files);
+    view()->markUrlAsCurrent(files.at(0));
 }
 
 bool DolphinPart::eventFilter(QObject *obj, QEvent *event)
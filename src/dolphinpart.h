@@ -18,6 +18,7 @@ class QActionGroup;
 class KFileItemList;
 class KFileItem;
 class DolphinPartBrowserExtension;
+class DolphinPartListingNotificationExtension;
 class DolphinRemoteEncoding;
 class KDirLister;
 class DolphinView;
@@ -69,9 +70,11 @@ public:
      */
     QString currentViewMode() const;
 
-    /// Returns the view owned by this part; used by DolphinPartBrowserExtension
+    /// Returns the view owned by this part; used by DolphinPartBrowserExtension.
+    /// The view is created lazily on first access, see createViewIfNeeded().
     DolphinView *view()
     {
+        createViewIfNeeded();
         return m_view;
     }
 
@@ -226,6 +229,15 @@ private Q_SLOTS:
     bool eventFilter(QObject *, QEvent *) override;
 
 private:
+    /**
+     * Materializes the DolphinView and everything that depends on it. The
+     * constructor only sets up a cheap shell - the actions, the extensions
+     * and a plain host widget - so that embedders can instantiate the part
+     * without paying for the full view stack; the view is created here on
+     * the first openUrl() or on the first view() access.
+     */
+    void createViewIfNeeded();
+
     void createActions();
     void createGoAction(const char *name, const char *iconName, const QString &text, const QString &url, QActionGroup *actionGroup);
 
@@ -234,10 +246,13 @@ private:
     QString localFilePathOrHome() const;
 
 private:
+    /** Plain widget the part hands to the embedder; hosts the lazily created view. */
+    QWidget *m_viewHost;
     DolphinView *m_view;
     DolphinViewActionHandler *m_actionHandler;
     DolphinRemoteEncoding *m_remoteEncoding;
     DolphinPartBrowserExtension *m_extension;
+    DolphinPartListingNotificationExtension *m_notificationExtension;
     DolphinNewFileMenu *m_newFileMenu;
     QAction *m_findFileAction;
     QAction *m_openTerminalAction;
@@ -5,18 +5,43 @@
  */
 
 #include "dolphinplacesmodelsingleton.h"
+#include "dolphinstartupprofiler.h"
 #include "trash/dolphintrash.h"
 #include "views/draganddrophelper.h"
 
 #include <KAboutData>
 
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QIcon>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QMimeData>
+#include <QStandardPaths>
+#include <QTimer>
 
 DolphinPlacesModel::DolphinPlacesModel(QObject *parent)
     : KFilePlacesModel(parent)
 {
     connect(&Trash::instance(), &Trash::emptinessChanged, this, &DolphinPlacesModel::slotTrashEmptinessChanged);
+
+    // Persist a snapshot of the resolved entries so the next session knows
+    // the final contents of this model before the device enumeration has
+    // confirmed them, see DolphinPlacesModelSingleton::snapshotPlaceTexts().
+    m_snapshotSaveTimer = new QTimer(this);
+    m_snapshotSaveTimer->setSingleShot(true);
+    m_snapshotSaveTimer->setInterval(1000);
+    connect(m_snapshotSaveTimer, &QTimer::timeout, this, &DolphinPlacesModel::saveSnapshot);
+
+    const auto scheduleSnapshotSave = [this]() {
+        m_snapshotSaveTimer->start();
+    };
+    connect(this, &QAbstractItemModel::rowsInserted, this, scheduleSnapshotSave);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, scheduleSnapshotSave);
+    connect(this, &QAbstractItemModel::dataChanged, this, scheduleSnapshotSave);
+    connect(this, &QAbstractItemModel::modelReset, this, scheduleSnapshotSave);
 }
 
 DolphinPlacesModel::~DolphinPlacesModel() = default;
@@ -112,6 +137,29 @@ void DolphinPlacesModel::slotTrashEmptinessChanged(bool isEmpty)
     }
 }
 
+void DolphinPlacesModel::saveSnapshot() const
+{
+    QJsonArray entries;
+    for (int i = 0; i < rowCount(); ++i) {
+        const QModelIndex index = this->index(i, 0);
+        if (isHidden(index)) {
+            continue;
+        }
+        QJsonObject entry;
+        entry.insert(QStringLiteral("text"), text(index));
+        entry.insert(QStringLiteral("iconName"), icon(index).name());
+        entry.insert(QStringLiteral("isDevice"), isDevice(index));
+        entries.append(entry);
+    }
+
+    const QString path = DolphinPlacesModelSingleton::snapshotPath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(entries).toJson(QJsonDocument::Compact));
+    }
+}
+
 bool DolphinPlacesModel::isTrash(const QModelIndex &index) const
 {
     return url(index) == QUrl(QStringLiteral("trash:/"));
@@ -120,6 +168,7 @@ bool DolphinPlacesModel::isTrash(const QModelIndex &index) const
 DolphinPlacesModelSingleton::DolphinPlacesModelSingleton()
     : m_placesModel(new DolphinPlacesModel())
 {
+    DolphinStartupProfiler::instance()->recordPhase(DolphinStartupProfiler::PlacesModelReady);
 }
 
 DolphinPlacesModelSingleton &DolphinPlacesModelSingleton::instance()
@@ -133,4 +182,27 @@ DolphinPlacesModel *DolphinPlacesModelSingleton::placesModel() const
     return m_placesModel.data();
 }
 
+QStringList DolphinPlacesModelSingleton::snapshotPlaceTexts()
+{
+    QFile file(snapshotPath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+
+    QStringList texts;
+    const QJsonArray entries = QJsonDocument::fromJson(file.readAll()).array();
+    for (const QJsonValue &entry : entries) {
+        const QString text = entry.toObject().value(QLatin1String("text")).toString();
+        if (!text.isEmpty()) {
+            texts.append(text);
+        }
+    }
+    return texts;
+}
+
+QString DolphinPlacesModelSingleton::snapshotPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/places-snapshot.json");
+}
+
 #include "moc_dolphinplacesmodelsingleton.cpp"
@@ -9,9 +9,12 @@
 
 #include <QScopedPointer>
 #include <QString>
+#include <QStringList>
 
 #include <KFilePlacesModel>
 
+class QTimer;
+
 /**
  * @brief Dolphin's special-cased KFilePlacesModel
  *
@@ -38,11 +41,20 @@ protected:
 private Q_SLOTS:
     void slotTrashEmptinessChanged(bool isEmpty);
 
+    /**
+     * Writes the current places entries to the snapshot file, see
+     * DolphinPlacesModelSingleton::snapshotPlaceTexts(). The save is
+     * debounced because entries arrive in bursts while the devices are
+     * being enumerated.
+     */
+    void saveSnapshot() const;
+
 private:
     bool isTrash(const QModelIndex &index) const;
 
     bool m_isEmpty = false;
     bool m_panelsLocked = true; // common-case, panels are locked
+    QTimer *m_snapshotSaveTimer = nullptr;
 };
 
 /**
@@ -55,6 +67,18 @@ public:
 
     DolphinPlacesModel *placesModel() const;
 
+    /**
+     * The texts of the places entries as they were at the end of the last
+     * session, read from the snapshot file. Unlike placesModel() this does
+     * not construct the model, so it is available before the (potentially
+     * slow) device enumeration has run. Returns an empty list if no snapshot
+     * has been written yet.
+     */
+    static QStringList snapshotPlaceTexts();
+
+    /** The path of the snapshot file written by DolphinPlacesModel. */
+    static QString snapshotPath();
+
     DolphinPlacesModelSingleton(const DolphinPlacesModelSingleton &) = delete;
     DolphinPlacesModelSingleton &operator=(const DolphinPlacesModelSingleton &) = delete;
 
@@ -0,0 +1,117 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "dolphinsessiontabstore.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtEndian>
+
+#include <cstring>
+
+namespace
+{
+/** Identifies a Dolphin session tab store ("DTAB"). */
+constexpr quint32 StoreMagic = 0x44544142;
+/** Bump whenever the layout of the store changes. */
+constexpr quint32 StoreVersion = 1;
+
+/** Reads the big-endian quint32 at \a data, as written by QDataStream. */
+quint32 readUInt32(const uchar *data)
+{
+    quint32 value = 0;
+    std::memcpy(&value, data, sizeof(value));
+    return qFromBigEndian(value);
+}
+}
+
+bool DolphinSessionTabStore::write(const QString &sessionGroupName, const QList<QByteArray> &tabStates)
+{
+    const QString path = storePath(sessionGroupName);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream << StoreMagic;
+    stream << StoreVersion;
+    stream << quint32(tabStates.count());
+    for (const QByteArray &state : tabStates) {
+        stream << state;
+    }
+
+    return file.commit();
+}
+
+QString DolphinSessionTabStore::storePath(const QString &sessionGroupName)
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) % QLatin1String("/session-tabs-") % sessionGroupName % QLatin1String(".bin");
+}
+
+DolphinSessionTabStore::Reader::Reader(const QString &sessionGroupName)
+    : m_file(storePath(sessionGroupName))
+{
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    m_size = m_file.size();
+    // 3 quint32: magic, version and tab count.
+    if (m_size < qint64(3 * sizeof(quint32))) {
+        return;
+    }
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        return;
+    }
+
+    if (readUInt32(m_data) != StoreMagic || readUInt32(m_data + sizeof(quint32)) != StoreVersion) {
+        return;
+    }
+
+    m_tabCount = readUInt32(m_data + 2 * sizeof(quint32));
+    m_offset = 3 * sizeof(quint32);
+    m_valid = true;
+}
+
+bool DolphinSessionTabStore::Reader::isValid() const
+{
+    return m_valid;
+}
+
+int DolphinSessionTabStore::Reader::tabCount() const
+{
+    return m_tabCount;
+}
+
+QByteArray DolphinSessionTabStore::Reader::nextTabState()
+{
+    if (!m_valid || m_offset + qint64(sizeof(quint32)) > m_size) {
+        return QByteArray();
+    }
+
+    // QDataStream serializes a QByteArray as its size followed by its raw
+    // bytes. Only this blob is copied out of the mapping.
+    const quint32 blobSize = readUInt32(m_data + m_offset);
+    m_offset += sizeof(quint32);
+    if (blobSize == 0xFFFFFFFF) { // a null QByteArray
+        return QByteArray();
+    }
+    if (m_offset + qint64(blobSize) > m_size) {
+        return QByteArray();
+    }
+
+    const QByteArray state(reinterpret_cast<const char *>(m_data + m_offset), blobSize);
+    m_offset += blobSize;
+    return state;
+}
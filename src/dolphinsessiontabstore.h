@@ -0,0 +1,75 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef DOLPHINSESSIONTABSTORE_H
+#define DOLPHINSESSIONTABSTORE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QString>
+
+/**
+ * @brief Compact binary store for the tab states of a saved session.
+ *
+ * KConfig keeps saved tab states as base64 text entries, which all have to be
+ * parsed and decoded before the first tab of a big session can restore. This
+ * store writes the tab state blobs of one session group as a single versioned
+ * binary file instead. Restoring memory-maps the file and streams the blobs
+ * out one by one, so the first tab can already start loading its directory
+ * while the rest of the session has not even been looked at, see
+ * DolphinTabWidget::readProperties().
+ */
+class DolphinSessionTabStore
+{
+public:
+    /**
+     * Writes \a tabStates as the store of the session group named
+     * \a sessionGroupName, replacing a previous store atomically.
+     * @return Whether writing succeeded. On failure the caller should fall
+     *         back to persisting the states through KConfig.
+     */
+    static bool write(const QString &sessionGroupName, const QList<QByteArray> &tabStates);
+
+    /** The path of the store file of the session group \a sessionGroupName. */
+    static QString storePath(const QString &sessionGroupName);
+
+    /**
+     * Streaming reader over the memory-mapped store of one session group.
+     * The state blobs are handed out in the order they were written; only the
+     * blob that is currently asked for is copied out of the mapping.
+     */
+    class Reader
+    {
+    public:
+        explicit Reader(const QString &sessionGroupName);
+
+        /**
+         * @return Whether the store exists, could be mapped and has a
+         *         supported version.
+         */
+        bool isValid() const;
+
+        /** @return The number of tab states in the store. */
+        int tabCount() const;
+
+        /**
+         * @return The state blob of the next tab, or an empty array if all
+         *         blobs have been read or the store is truncated.
+         */
+        QByteArray nextTabState();
+
+    private:
+        QFile m_file;
+        const uchar *m_data = nullptr;
+        qint64 m_size = 0;
+        qint64 m_offset = 0;
+        int m_tabCount = 0;
+        bool m_valid = false;
+    };
+};
+
+#endif // DOLPHINSESSIONTABSTORE_H
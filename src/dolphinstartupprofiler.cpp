@@ -0,0 +1,148 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "dolphinstartupprofiler.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+
+namespace
+{
+/** The log is trimmed to this many entries once it grows past twice as many. */
+constexpr int MaxLogEntries = 500;
+}
+
+struct DolphinStartupProfilerSingleton {
+    DolphinStartupProfiler instance;
+};
+Q_GLOBAL_STATIC(DolphinStartupProfilerSingleton, s_startupProfiler)
+
+DolphinStartupProfiler *DolphinStartupProfiler::instance()
+{
+    return &s_startupProfiler->instance;
+}
+
+DolphinStartupProfiler::DolphinStartupProfiler()
+    : m_sinceStartup(),
+      m_phaseRecorded(),
+      m_phaseMilliseconds(),
+      m_mutex()
+{
+    m_sinceStartup.start();
+    m_phaseMilliseconds.fill(-1);
+}
+
+void DolphinStartupProfiler::recordPhase(Phase phase)
+{
+    if (m_phaseRecorded[phase].loadRelaxed()) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (m_phaseRecorded[phase].loadRelaxed()) {
+        return;
+    }
+    m_phaseMilliseconds[phase] = m_sinceStartup.elapsed();
+    m_phaseRecorded[phase].storeRelease(1);
+
+    if (phase == FirstDirectoryPainted) {
+        // The final milestone. Write the log entry, but not from inside the
+        // paint event that reached it.
+        locker.unlock();
+        QMetaObject::invokeMethod(
+            QCoreApplication::instance(),
+            [this]() {
+                writeLogEntry();
+            },
+            Qt::QueuedConnection);
+    }
+}
+
+QString DolphinStartupProfiler::report() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QJsonObject phases;
+    bool complete = true;
+    for (int phase = 0; phase < PhaseCount; ++phase) {
+        if (m_phaseMilliseconds[phase] >= 0) {
+            phases.insert(QString::fromLatin1(phaseName(static_cast<Phase>(phase))), m_phaseMilliseconds[phase]);
+        } else {
+            complete = false;
+        }
+    }
+
+    QJsonObject root;
+    root.insert(QStringLiteral("phasesMs"), phases);
+    root.insert(QStringLiteral("complete"), complete);
+    root.insert(QStringLiteral("version"), QCoreApplication::applicationVersion());
+
+    return QString::fromUtf8(QJsonDocument(root).toJson(QJsonDocument::Compact));
+}
+
+QByteArray DolphinStartupProfiler::phaseName(Phase phase)
+{
+    switch (phase) {
+    case ApplicationInit:
+        return QByteArrayLiteral("applicationInit");
+    case ConfigLoaded:
+        return QByteArrayLiteral("configLoaded");
+    case PlacesModelReady:
+        return QByteArrayLiteral("placesModelReady");
+    case MainWindowConstructed:
+        return QByteArrayLiteral("mainWindowConstructed");
+    case FirstViewVisible:
+        return QByteArrayLiteral("firstViewVisible");
+    case FirstDirectoryPainted:
+        return QByteArrayLiteral("firstDirectoryPainted");
+    case PhaseCount:
+        break;
+    }
+    Q_UNREACHABLE();
+    return QByteArray();
+}
+
+void DolphinStartupProfiler::writeLogEntry()
+{
+    const QString directoryPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    if (directoryPath.isEmpty() || !QDir().mkpath(directoryPath)) {
+        return;
+    }
+    const QString logPath = directoryPath + QLatin1String("/startup-times.log");
+
+    QJsonObject entry = QJsonDocument::fromJson(report().toUtf8()).object();
+    entry.insert(QStringLiteral("timestamp"), QDateTime::currentDateTime().toString(Qt::ISODate));
+
+    QFile logFile(logPath);
+    if (!logFile.open(QIODevice::ReadWrite | QIODevice::Text)) {
+        return;
+    }
+
+    QList<QByteArray> lines;
+    while (!logFile.atEnd()) {
+        const QByteArray line = logFile.readLine().trimmed();
+        if (!line.isEmpty()) {
+            lines.append(line);
+        }
+    }
+    lines.append(QJsonDocument(entry).toJson(QJsonDocument::Compact));
+
+    if (lines.count() > 2 * MaxLogEntries) {
+        lines = lines.mid(lines.count() - MaxLogEntries);
+    }
+
+    logFile.seek(0);
+    logFile.resize(0);
+    for (const QByteArray &line : std::as_const(lines)) {
+        logFile.write(line);
+        logFile.write("\n");
+    }
+}
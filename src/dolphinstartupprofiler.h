@@ -0,0 +1,81 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef DOLPHINSTARTUPPROFILER_H
+#define DOLPHINSTARTUPPROFILER_H
+
+#include "dolphin_export.h"
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+
+#include <array>
+
+/**
+ * @brief Records how long the milestones of a cold start took.
+ *
+ * The clock starts with the first instance() call at the top of main(), and
+ * each startup phase records its completion once through recordPhase().
+ * When the last phase - the first painted directory item - is reached, the
+ * timings are appended as one JSON line to startup-times.log in the
+ * application data directory, so startup latency distributions can be
+ * compared across versions. The same numbers can be queried live over the
+ * D-Bus method GetStartupTimings().
+ *
+ * recordPhase() is a single atomic load once its phase has been recorded,
+ * so it is safe to call from paint paths.
+ */
+class DOLPHIN_EXPORT DolphinStartupProfiler
+{
+public:
+    /**
+     * The milestones of a start, in the order they are expected to
+     * complete. The names are part of the log format, see phaseName().
+     */
+    enum Phase {
+        ApplicationInit, ///< The QApplication object exists.
+        ConfigLoaded, ///< The general settings have been read for the first time.
+        PlacesModelReady, ///< The shared places model has been constructed.
+        MainWindowConstructed, ///< The DolphinMainWindow constructor has finished.
+        FirstViewVisible, ///< The first view container got its show event.
+        FirstDirectoryPainted, ///< The first directory item has been painted.
+        PhaseCount
+    };
+
+    static DolphinStartupProfiler *instance();
+
+    /**
+     * Records that \a phase has completed now. Only the first call per phase
+     * is kept; later calls - e.g. the paint of every further item - return
+     * after one atomic load. Recording the final phase writes the log entry.
+     */
+    void recordPhase(Phase phase);
+
+    /**
+     * @return The recorded milestones as JSON: milliseconds since the start
+     *         of main() per phase, and whether all phases have completed.
+     */
+    QString report() const;
+
+private:
+    DolphinStartupProfiler();
+
+    static QByteArray phaseName(Phase phase);
+
+    /** Appends the completed timings as one JSON line to startup-times.log and trims old entries. */
+    void writeLogEntry();
+
+    QElapsedTimer m_sinceStartup;
+    std::array<QAtomicInt, PhaseCount> m_phaseRecorded;
+    std::array<qint64, PhaseCount> m_phaseMilliseconds;
+    mutable QMutex m_mutex;
+
+    friend struct DolphinStartupProfilerSingleton;
+};
+
+#endif
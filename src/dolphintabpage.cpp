@@ -8,7 +8,9 @@
 #include "dolphintabpage.h"
 
 #include "dolphin_generalsettings.h"
+#include "dolphincachegovernor.h"
 #include "dolphinviewcontainer.h"
+#include "kitemviews/private/kmemoryaccounting.h"
 
 #include <QFrame>
 #include <QGridLayout>
@@ -61,6 +63,167 @@ DolphinTabPage::DolphinTabPage(const QUrl &primaryUrl, const QUrl &secondaryUrl,
     }
 
     m_primaryViewContainer->setActive(true);
+
+    registerMemoryReporter();
+    DolphinCacheGovernor::instance()->registerTabPage(this);
+}
+
+DolphinTabPage::DolphinTabPage(const QByteArray &state, QWidget *parent)
+    : QWidget(parent)
+    , m_expandingContainer{nullptr}
+    , m_primaryViewActive(true)
+    , m_splitViewEnabled(false)
+    , m_active(false)
+    , m_splitterLastPosition(0)
+    , m_hibernatedState(state)
+{
+    QGridLayout *layout = new QGridLayout(this);
+    layout->setSpacing(0);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    m_splitter = new DolphinTabPageSplitter(Qt::Horizontal, this);
+    m_splitter->setChildrenCollapsible(false);
+    connect(m_splitter, &QSplitter::splitterMoved, this, &DolphinTabPage::splitterMoved);
+    layout->addWidget(m_splitter, 1, 0);
+    layout->setRowStretch(1, 1);
+
+    // Peek at the URL of the primary view so that the tab can show a matching
+    // title and icon even though the view containers do not exist yet. The
+    // format must be kept in sync with saveState() and restoreState().
+    QDataStream stream(m_hibernatedState);
+    quint32 version = 0;
+    stream >> version;
+    if (version == 3) {
+        bool isSplitViewEnabled = false;
+        stream >> isSplitViewEnabled;
+        stream >> m_hibernatedUrl;
+    }
+    if (!m_hibernatedUrl.isValid()) {
+        m_hibernatedUrl = Dolphin::homeUrl();
+    }
+
+    registerMemoryReporter();
+    DolphinCacheGovernor::instance()->registerTabPage(this);
+}
+
+DolphinTabPage::~DolphinTabPage()
+{
+    DolphinCacheGovernor::instance()->unregisterTabPage(this);
+    KMemoryAccounting::instance()->unregisterReporter(this);
+}
+
+QByteArray DolphinTabPage::hibernatedStateForUrl(const QUrl &primaryUrl)
+{
+    QByteArray state;
+    QDataStream stream(&state, QIODevice::WriteOnly);
+
+    stream << quint32(3); // Tab state version, see saveState()
+    stream << false; // split view disabled
+    stream << primaryUrl;
+
+    return state;
+}
+
+void DolphinTabPage::registerMemoryReporter()
+{
+    // The models and views of the containers report themselves, so a tab page
+    // only accounts for its own overhead and the saved state of hibernated
+    // tabs. The instance count of this subsystem tells how many tab pages are
+    // alive in total; comparing it with the KFileItemModel count shows how
+    // many of them are hibernated.
+    KMemoryAccounting::instance()->registerReporter(this, QByteArrayLiteral("DolphinTabPage"), [this]() {
+        return static_cast<qint64>(sizeof(DolphinTabPage)) + m_hibernatedState.capacity();
+    });
+}
+
+bool DolphinTabPage::isHydrated() const
+{
+    return !m_primaryViewContainer.isNull();
+}
+
+void DolphinTabPage::hydrate()
+{
+    if (isHydrated()) {
+        return;
+    }
+
+    const QByteArray state = m_hibernatedState;
+    m_hibernatedState.clear();
+
+    m_primaryViewContainer = createViewContainer(m_hibernatedUrl);
+    connect(m_primaryViewContainer->view(), &DolphinView::urlChanged, this, &DolphinTabPage::activeViewUrlChanged);
+    connect(m_primaryViewContainer->view(), &DolphinView::redirection, this, &DolphinTabPage::slotViewUrlRedirection);
+    m_splitter->addWidget(m_primaryViewContainer);
+    m_primaryViewContainer->show();
+
+    restoreState(state);
+
+    // Apply the selection which was requested while this tab page was still
+    // hibernated, e.g. by an open-and-select call with many files.
+    if (!m_hibernatedSelection.isEmpty()) {
+        const QList<QUrl> selection = m_hibernatedSelection;
+        m_hibernatedSelection.clear();
+        markUrlsAsSelected(selection);
+    }
+    if (m_hibernatedCurrentUrl.isValid()) {
+        const QUrl currentUrl = m_hibernatedCurrentUrl;
+        m_hibernatedCurrentUrl = QUrl();
+        markUrlAsCurrent(currentUrl);
+    }
+
+    Q_EMIT hydrated();
+}
+
+void DolphinTabPage::dehydrate()
+{
+    if (!isHydrated() || m_active) {
+        return;
+    }
+
+    const QByteArray state = saveState();
+    m_hibernatedUrl = activeViewContainer()->url();
+
+    m_expandingContainer = nullptr;
+    delete m_primaryViewContainer;
+    delete m_secondaryViewContainer;
+    m_splitViewEnabled = false;
+    m_primaryViewActive = true;
+
+    // Assigned after saveState(), which passes the state of a hibernated tab
+    // page through unchanged.
+    m_hibernatedState = state;
+}
+
+void DolphinTabPage::trimCachedPreviews()
+{
+    if (!isHydrated()) {
+        return;
+    }
+
+    m_primaryViewContainer->view()->trimCachedPreviews();
+    if (m_secondaryViewContainer) {
+        m_secondaryViewContainer->view()->trimCachedPreviews();
+    }
+}
+
+void DolphinTabPage::trimCachedRoleValues()
+{
+    if (!isHydrated()) {
+        return;
+    }
+
+    m_primaryViewContainer->view()->trimCachedRoleValues();
+    if (m_secondaryViewContainer) {
+        m_secondaryViewContainer->view()->trimCachedRoleValues();
+    }
+}
+
+QUrl DolphinTabPage::activeViewUrl() const
+{
+    if (!isHydrated()) {
+        return m_hibernatedUrl;
+    }
+    return activeViewContainer()->url();
 }
 
 bool DolphinTabPage::primaryViewActive() const
@@ -101,18 +264,25 @@ void DolphinTabPage::setSplitViewEnabled(bool enabled, Animated animated, const
         const QUrl &url = (secondaryUrl.isEmpty()) ? m_primaryViewContainer->url() : secondaryUrl;
         m_secondaryViewContainer = createViewContainer(url);
 
-        auto secondaryNavigator = m_navigatorsWidget->secondaryUrlNavigator();
-        if (!secondaryNavigator) {
-            m_navigatorsWidget->createSecondaryUrlNavigator();
-            secondaryNavigator = m_navigatorsWidget->secondaryUrlNavigator();
+        // The navigators widget is not known yet if this tab page is being
+        // hydrated in the background. connectNavigators() wires everything up
+        // once the tab is activated.
+        if (m_navigatorsWidget) {
+            auto secondaryNavigator = m_navigatorsWidget->secondaryUrlNavigator();
+            if (!secondaryNavigator) {
+                m_navigatorsWidget->createSecondaryUrlNavigator();
+                secondaryNavigator = m_navigatorsWidget->secondaryUrlNavigator();
+            }
+            m_secondaryViewContainer->connectUrlNavigator(secondaryNavigator);
+            m_navigatorsWidget->setSecondaryNavigatorVisible(true);
+            m_navigatorsWidget->followViewContainersGeometry(m_primaryViewContainer, m_secondaryViewContainer);
         }
-        m_secondaryViewContainer->connectUrlNavigator(secondaryNavigator);
         connect(m_secondaryViewContainer->view(), &DolphinView::redirection, this, &DolphinTabPage::slotViewUrlRedirection);
-        m_navigatorsWidget->setSecondaryNavigatorVisible(true);
-        m_navigatorsWidget->followViewContainersGeometry(m_primaryViewContainer, m_secondaryViewContainer);
 
         m_splitter->addWidget(m_secondaryViewContainer);
-        m_secondaryViewContainer->setActive(true);
+        // A tab page that is hydrated in the background must not steal the
+        // focus from the currently shown tab.
+        m_secondaryViewContainer->setActive(m_active);
 
         if (animated == WithAnimation) {
             m_secondaryViewContainer->setMinimumWidth(1);
@@ -207,6 +377,9 @@ DolphinViewContainer *DolphinTabPage::inactiveViewContainer() const
 
 KFileItemList DolphinTabPage::selectedItems() const
 {
+    if (!isHydrated()) {
+        return KFileItemList();
+    }
     KFileItemList items = m_primaryViewContainer->view()->selectedItems();
     if (m_splitViewEnabled) {
         items += m_secondaryViewContainer->view()->selectedItems();
@@ -216,6 +389,9 @@ KFileItemList DolphinTabPage::selectedItems() const
 
 int DolphinTabPage::selectedItemsCount() const
 {
+    if (!isHydrated()) {
+        return 0;
+    }
     int selectedItemsCount = m_primaryViewContainer->view()->selectedItemsCount();
     if (m_splitViewEnabled) {
         selectedItemsCount += m_secondaryViewContainer->view()->selectedItemsCount();
@@ -272,6 +448,11 @@ void DolphinTabPage::insertNavigatorsWidget(DolphinNavigatorsWidgetAction *navig
 
 void DolphinTabPage::markUrlsAsSelected(const QList<QUrl> &urls)
 {
+    if (!isHydrated()) {
+        // Remember the selection and apply it on hydration.
+        m_hibernatedSelection = urls;
+        return;
+    }
     m_primaryViewContainer->view()->markUrlsAsSelected(urls);
     if (m_splitViewEnabled) {
         m_secondaryViewContainer->view()->markUrlsAsSelected(urls);
@@ -280,6 +461,11 @@ void DolphinTabPage::markUrlsAsSelected(const QList<QUrl> &urls)
 
 void DolphinTabPage::markUrlAsCurrent(const QUrl &url)
 {
+    if (!isHydrated()) {
+        // Remember the current item and apply it on hydration.
+        m_hibernatedCurrentUrl = url;
+        return;
+    }
     m_primaryViewContainer->view()->markUrlAsCurrent(url);
     if (m_splitViewEnabled) {
         m_secondaryViewContainer->view()->markUrlAsCurrent(url);
@@ -288,6 +474,11 @@ void DolphinTabPage::markUrlAsCurrent(const QUrl &url)
 
 void DolphinTabPage::refreshViews()
 {
+    if (!isHydrated()) {
+        // The view containers are created with the current settings on
+        // hydration anyway.
+        return;
+    }
     m_primaryViewContainer->readSettings();
     if (m_splitViewEnabled) {
         m_secondaryViewContainer->readSettings();
@@ -296,6 +487,13 @@ void DolphinTabPage::refreshViews()
 
 QByteArray DolphinTabPage::saveState() const
 {
+    if (!isHydrated()) {
+        // Nothing changed since the state was restored, pass it through
+        // unchanged. This also preserves parts that are unknown until
+        // hydration, like a custom tab label.
+        return m_hibernatedState;
+    }
+
     QByteArray state;
     QDataStream stream(&state, QIODevice::WriteOnly);
 
@@ -348,6 +546,11 @@ void DolphinTabPage::restoreState(const QByteArray &state)
     QUrl primaryUrl;
     stream >> primaryUrl;
     m_primaryViewContainer->setUrl(primaryUrl);
+    if (stream.atEnd()) {
+        // A minimal state as created by hibernatedStateForUrl() only carries
+        // the URL, there is nothing else to restore.
+        return;
+    }
     bool primaryUrlEditable;
     stream >> primaryUrlEditable;
     m_primaryViewContainer->urlNavigatorInternalWithHistory()->setUrlEditable(primaryUrlEditable);
@@ -364,11 +567,12 @@ void DolphinTabPage::restoreState(const QByteArray &state)
     }
 
     stream >> m_primaryViewActive;
-    if (m_primaryViewActive) {
-        m_primaryViewContainer->setActive(true);
-    } else {
-        Q_ASSERT(m_splitViewEnabled);
-        m_secondaryViewContainer->setActive(true);
+    Q_ASSERT(m_primaryViewActive || m_splitViewEnabled);
+    if (m_active) {
+        // A tab page that is restored in the background keeps all of its view
+        // containers inactive so that it does not steal the focus. The proper
+        // container is activated by setActive() once the tab is shown.
+        activeViewContainer()->setActive(true);
     }
 
     QByteArray splitterState;
@@ -385,6 +589,13 @@ void DolphinTabPage::restoreState(const QByteArray &state)
 
 void DolphinTabPage::setActive(bool active)
 {
+    DolphinCacheGovernor::instance()->setTabPageActive(this, active);
+    if (!isHydrated()) {
+        // There is no view container that could take the active state yet;
+        // restoreState() applies it on hydration.
+        m_active = active;
+        return;
+    }
     if (active) {
         m_active = active;
     } else {
@@ -28,6 +28,70 @@ class DolphinTabPage : public QWidget
 public:
     explicit DolphinTabPage(const QUrl &primaryUrl, const QUrl &secondaryUrl = QUrl(), QWidget *parent = nullptr);
 
+    /**
+     * Creates a hibernated tab page: No view containers are constructed and no
+     * directory is listed until hydrate() is called. Only the URL of the
+     * primary view is peeked from \a state so that the tab can show a matching
+     * title and icon. Used for the background tabs of a restored session, see
+     * DolphinTabWidget::readProperties().
+     */
+    explicit DolphinTabPage(const QByteArray &state, QWidget *parent = nullptr);
+
+    ~DolphinTabPage() override;
+
+    /**
+     * @return A minimal state for the hibernating constructor which only
+     *         carries \a primaryUrl. Allows to cheaply create a hibernated
+     *         background tab for a URL without any saved view state, see
+     *         DolphinTabWidget::openNewHibernatedTab().
+     */
+    static QByteArray hibernatedStateForUrl(const QUrl &primaryUrl);
+
+    /**
+     * @return True if the view containers of this tab page exist. Only a tab
+     *         page restored with the hibernating constructor can be
+     *         non-hydrated.
+     */
+    bool isHydrated() const;
+
+    /**
+     * Creates the view containers of a hibernated tab page and restores the
+     * state it was constructed with, which also starts the first listing of
+     * its directories. Does nothing if this tab page is hydrated already.
+     */
+    void hydrate();
+
+    /**
+     * The inverse of hydrate(): Saves the complete state of this tab page and
+     * deletes its view containers, including their models and caches. The tab
+     * keeps its title and icon and is transparently hydrated again on the
+     * next activation. Does nothing for an active or already hibernated tab
+     * page. Called by DolphinCacheGovernor as the last demotion stage of a
+     * long-idle background tab under memory pressure.
+     */
+    void dehydrate();
+
+    /**
+     * Drops the cached preview pixmaps of the views of this tab page except
+     * a screenful around their visible ranges,
+     * @see DolphinView::trimCachedPreviews().
+     */
+    void trimCachedPreviews();
+
+    /**
+     * Releases the cached role values of the views of this tab page,
+     * @see DolphinView::trimCachedRoleValues().
+     */
+    void trimCachedRoleValues();
+
+    /**
+     * @return The URL of the active view. In contrast to
+     *         activeViewContainer()->url() this also works for a hibernated
+     *         tab page, for which it returns the URL the primary view will be
+     *         opened at.
+     */
+    QUrl activeViewUrl() const;
+
     /**
      * @return True if primary view is the active view in this tab.
      */
@@ -156,6 +220,12 @@ Q_SIGNALS:
     void activeViewChanged(DolphinViewContainer *viewContainer);
     void activeViewUrlChanged(const QUrl &url);
 
+    /**
+     * Is emitted when the view containers of a hibernated tab page have been
+     * created, see hydrate().
+     */
+    void hydrated();
+
 private Q_SLOTS:
     /**
      * Saves splitter position to be able to restore it on split mode OFF->ON
@@ -204,6 +274,12 @@ private:
      */
     void startExpandViewAnimation(DolphinViewContainer *expandingContainer);
 
+    /**
+     * Registers this tab page with KMemoryAccounting. Called by both
+     * constructors; the destructor unregisters again.
+     */
+    void registerMemoryReporter();
+
 private:
     DolphinTabPageSplitter *m_splitter;
 
@@ -222,6 +298,20 @@ private:
     /** @see setCustomLabel(). */
     QString m_customLabel;
     int m_splitterLastPosition = 0;
+
+    /**
+     * The state a hibernated tab page was constructed with. It is applied by
+     * hydrate() and is empty for a hydrated tab page.
+     */
+    QByteArray m_hibernatedState;
+    /** The URL of the primary view of a hibernated tab page. */
+    QUrl m_hibernatedUrl;
+    /**
+     * Selection to apply once a hibernated tab page is hydrated, see
+     * markUrlsAsSelected() and markUrlAsCurrent().
+     */
+    QList<QUrl> m_hibernatedSelection;
+    QUrl m_hibernatedCurrentUrl;
 };
 
 class DolphinTabPageSplitterHandle : public QSplitterHandle
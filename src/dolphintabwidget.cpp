@@ -7,6 +7,7 @@
 #include "dolphintabwidget.h"
 
 #include "dolphin_generalsettings.h"
+#include "dolphinsessiontabstore.h"
 #include "dolphintabbar.h"
 #include "dolphinviewcontainer.h"
 #include "views/draganddrophelper.h"
@@ -21,7 +22,9 @@
 
 #include <QApplication>
 #include <QDropEvent>
+#include <QSet>
 #include <QStackedWidget>
+#include <QTimer>
 
 DolphinTabWidget::DolphinTabWidget(DolphinNavigatorsWidgetAction *navigatorsWidget, QWidget *parent)
     : QTabWidget(parent)
@@ -82,26 +85,79 @@ void DolphinTabWidget::saveProperties(KConfigGroup &group) const
     group.writeEntry("Tab Count", tabCount);
     group.writeEntry("Active Tab Index", currentIndex());
 
+    QList<QByteArray> tabStates;
+    tabStates.reserve(tabCount);
     for (int i = 0; i < tabCount; ++i) {
-        const DolphinTabPage *tabPage = tabPageAt(i);
-        group.writeEntry("Tab Data " % QString::number(i), tabPage->saveState());
+        tabStates.append(tabPageAt(i)->saveState());
+    }
+
+    if (DolphinSessionTabStore::write(group.name(), tabStates)) {
+        // The binary store replaces the per-tab text entries. Drop leftover
+        // entries of older versions so the config does not keep stale states.
+        for (int i = 0; group.hasKey("Tab Data " % QString::number(i)); ++i) {
+            group.deleteEntry("Tab Data " % QString::number(i));
+        }
+    } else {
+        for (int i = 0; i < tabCount; ++i) {
+            group.writeEntry("Tab Data " % QString::number(i), tabStates.at(i));
+        }
     }
 }
 
 void DolphinTabWidget::readProperties(const KConfigGroup &group)
 {
     const int tabCount = group.readEntry("Tab Count", 0);
+    if (tabCount < 1) {
+        return;
+    }
+
+    // Stream the states out of the memory-mapped binary store: The first tab
+    // starts loading its directory before the states of the other tabs have
+    // even been parsed. The text entries only remain as a fallback for
+    // sessions saved by older versions.
+    DolphinSessionTabStore::Reader tabStore(group.name());
+    const bool useTabStore = tabStore.isValid() && tabStore.tabCount() == tabCount;
+
     for (int i = 0; i < tabCount; ++i) {
-        if (i >= count()) {
-            openNewActivatedTab();
+        const QByteArray state = useTabStore ? tabStore.nextTabState() : group.readEntry("Tab Data " % QString::number(i), QByteArray());
+        if (i < count()) {
+            // Restore into the tab pages which exist already (the initial tab)
+            // right away.
+            setCurrentIndex(i);
+            tabPageAt(i)->restoreState(state);
+        } else {
+            // Restoring every view of a big session at once hammers the disk
+            // and delays the tab the user actually looks at, so background
+            // tabs are only created in a hibernated state: They know their
+            // URL for the tab title and icon, but construct their view
+            // containers and start their first listing on first activation,
+            // see DolphinTabPage::hydrate().
+            DolphinTabPage *tabPage = new DolphinTabPage(state, this);
+            connect(tabPage, &DolphinTabPage::activeViewChanged, this, &DolphinTabWidget::activeViewChanged);
+            connect(tabPage, &DolphinTabPage::activeViewUrlChanged, this, &DolphinTabWidget::tabUrlChanged);
+            connect(tabPage, &DolphinTabPage::hydrated, this, [this, tabPage]() {
+                connect(tabPage->activeViewContainer(), &DolphinViewContainer::captionChanged, this, [this, tabPage]() {
+                    updateTabName(indexOf(tabPage));
+                });
+                updateTabName(indexOf(tabPage));
+            });
+            insertTab(-1, tabPage, QIcon() /* loaded in tabInserted */, tabName(tabPage));
         }
-        const QByteArray state = group.readEntry("Tab Data " % QString::number(i), QByteArray());
-        setCurrentIndex(i);
-        tabPageAt(i)->restoreState(state);
     }
 
-    const int index = group.readEntry("Active Tab Index", 0);
+    const int index = qBound(0, group.readEntry("Active Tab Index", 0), count() - 1);
+    // Hydrates the active tab if it was created in a hibernated state.
     setCurrentIndex(index);
+
+    // Once the active tab had a chance to load, prefetch its neighbours.
+    // Those are the tabs that are most likely to be activated next.
+    QTimer::singleShot(3000, this, [this, index]() {
+        for (const int i : {index - 1, index + 1}) {
+            if (i >= 0 && i < count()) {
+                tabPageAt(i)->hydrate();
+            }
+        }
+    });
 }
 
 void DolphinTabWidget::refreshViews()
@@ -192,6 +248,15 @@ DolphinTabPage *DolphinTabWidget::openNewTab(const QUrl &primaryUrl, const QUrl
     connect(tabPage->activeViewContainer(), &DolphinViewContainer::captionChanged, this, [this, tabPage]() {
         updateTabName(indexOf(tabPage));
     });
+    // The caption connection above dies with the view container when the
+    // cache governor dehydrates this tab page, so re-establish it whenever
+    // the tab page is hydrated again.
+    connect(tabPage, &DolphinTabPage::hydrated, this, [this, tabPage]() {
+        connect(tabPage->activeViewContainer(), &DolphinViewContainer::captionChanged, this, [this, tabPage]() {
+            updateTabName(indexOf(tabPage));
+        });
+        updateTabName(indexOf(tabPage));
+    });
 
     if (position == NewTabPosition::FollowSetting) {
         if (GeneralSettings::openNewTabAfterLastTab()) {
@@ -216,11 +281,27 @@ DolphinTabPage *DolphinTabWidget::openNewTab(const QUrl &primaryUrl, const QUrl
     return tabPage;
 }
 
+DolphinTabPage *DolphinTabWidget::openNewHibernatedTab(const QUrl &url)
+{
+    DolphinTabPage *tabPage = new DolphinTabPage(DolphinTabPage::hibernatedStateForUrl(url), this);
+    connect(tabPage, &DolphinTabPage::activeViewChanged, this, &DolphinTabWidget::activeViewChanged);
+    connect(tabPage, &DolphinTabPage::activeViewUrlChanged, this, &DolphinTabWidget::tabUrlChanged);
+    connect(tabPage, &DolphinTabPage::hydrated, this, [this, tabPage]() {
+        connect(tabPage->activeViewContainer(), &DolphinViewContainer::captionChanged, this, [this, tabPage]() {
+            updateTabName(indexOf(tabPage));
+        });
+        updateTabName(indexOf(tabPage));
+    });
+    insertTab(-1, tabPage, QIcon() /* loaded in tabInserted */, tabName(tabPage));
+    return tabPage;
+}
+
 void DolphinTabWidget::openDirectories(const QList<QUrl> &dirs, bool splitView)
 {
     Q_ASSERT(dirs.size() > 0);
 
     bool somethingWasAlreadyOpen = false;
+    bool activatedNewTab = false;
 
     QList<QUrl>::const_iterator it = dirs.constBegin();
     while (it != dirs.constEnd()) {
@@ -234,16 +315,21 @@ void DolphinTabWidget::openDirectories(const QList<QUrl> &dirs, bool splitView)
             activateViewContainerAt(viewIndexAtDirectory.value());
         } else if (splitView && (it != dirs.constEnd())) {
             const QUrl &secondaryUrl = *(it++);
-            if (somethingWasAlreadyOpen) {
+            if (somethingWasAlreadyOpen || activatedNewTab) {
                 openNewTab(primaryUrl, secondaryUrl);
             } else {
                 openNewActivatedTab(primaryUrl, secondaryUrl);
+                activatedNewTab = true;
             }
         } else {
-            if (somethingWasAlreadyOpen) {
-                openNewTab(primaryUrl);
+            if (somethingWasAlreadyOpen || activatedNewTab) {
+                // The background tabs of a batch are created hibernated: The
+                // tab appears immediately, but its view containers are only
+                // constructed and its directory only listed on activation.
+                openNewHibernatedTab(primaryUrl);
             } else {
                 openNewActivatedTab(primaryUrl);
+                activatedNewTab = true;
             }
         }
     }
@@ -253,14 +339,17 @@ void DolphinTabWidget::openFiles(const QList<QUrl> &files, bool splitView)
 {
     Q_ASSERT(files.size() > 0);
 
-    // Get all distinct directories from 'files'.
+    // Get all distinct directories from 'files' in one pass. The (expensive)
+    // search for a view showing the item is only done once per directory, not
+    // once per file.
     QList<QUrl> dirsThatNeedToBeOpened;
-    QList<QUrl> dirsThatWereAlreadyOpen;
+    QSet<QUrl> handledDirs;
     for (const QUrl &file : files) {
         const QUrl dir(file.adjusted(QUrl::RemoveFilename | QUrl::StripTrailingSlash));
-        if (dirsThatNeedToBeOpened.contains(dir) || dirsThatWereAlreadyOpen.contains(dir)) {
+        if (handledDirs.contains(dir)) {
             continue;
         }
+        handledDirs.insert(dir);
 
         // The selecting of files that we do later will not work in views that already have items selected.
         // So we check if dir is already open and clear the selection if it is. BUG: 417230
@@ -269,7 +358,6 @@ void DolphinTabWidget::openFiles(const QList<QUrl> &files, bool splitView)
         if (viewIndex.has_value()) {
             viewContainerAt(viewIndex.value())->view()->clearSelection();
             activateViewContainerAt(viewIndex.value());
-            dirsThatWereAlreadyOpen.append(dir);
         } else {
             dirsThatNeedToBeOpened.append(dir);
         }
@@ -290,7 +378,7 @@ void DolphinTabWidget::openFiles(const QList<QUrl> &files, bool splitView)
         DolphinTabPage *tabPage = tabPageAt(i);
         tabPage->markUrlsAsSelected(files);
         tabPage->markUrlAsCurrent(files.first());
-        if (i < oldTabCount) {
+        if (i < oldTabCount && tabPage->isHydrated()) {
             // Force selection of file if directory was already open, BUG: 417230
             tabPage->activeViewContainer()->view()->updateViewState();
         }
@@ -314,7 +402,7 @@ void DolphinTabWidget::closeTab(const int index)
     }
 
     DolphinTabPage *tabPage = tabPageAt(index);
-    Q_EMIT rememberClosedTab(tabPage->activeViewContainer()->url(), tabPage->saveState());
+    Q_EMIT rememberClosedTab(tabPage->activeViewUrl(), tabPage->saveState());
 
     removeTab(index);
     tabPage->deleteLater();
@@ -388,7 +476,9 @@ void DolphinTabWidget::detachTab(int index)
 
     QStringList args;
 
-    const DolphinTabPage *tabPage = tabPageAt(index);
+    DolphinTabPage *tabPage = tabPageAt(index);
+    // The split state of a hibernated tab is only known after hydration.
+    tabPage->hydrate();
     args << tabPage->primaryViewContainer()->url().url();
     if (tabPage->splitViewEnabled()) {
         args << tabPage->secondaryViewContainer()->url().url();
@@ -407,13 +497,15 @@ void DolphinTabWidget::openNewActivatedTab(int index)
 {
     Q_ASSERT(index >= 0);
     const DolphinTabPage *tabPage = tabPageAt(index);
-    openNewActivatedTab(tabPage->activeViewContainer()->url());
+    openNewActivatedTab(tabPage->activeViewUrl());
 }
 
 void DolphinTabWidget::tabDragMoveEvent(int index, QDragMoveEvent *event)
 {
     if (index >= 0) {
-        DolphinView *view = tabPageAt(index)->activeViewContainer()->view();
+        DolphinTabPage *tabPage = tabPageAt(index);
+        tabPage->hydrate(); // Dragging over the tab is an explicit interest in its view.
+        DolphinView *view = tabPage->activeViewContainer()->view();
         DragAndDropHelper::updateDropAction(event, view->url());
     }
 }
@@ -421,7 +513,9 @@ void DolphinTabWidget::tabDragMoveEvent(int index, QDragMoveEvent *event)
 void DolphinTabWidget::tabDropEvent(int index, QDropEvent *event)
 {
     if (index >= 0) {
-        DolphinView *view = tabPageAt(index)->activeViewContainer()->view();
+        DolphinTabPage *tabPage = tabPageAt(index);
+        tabPage->hydrate();
+        DolphinView *view = tabPage->activeViewContainer()->view();
         view->dropUrls(view->url(), event, view);
     } else {
         const auto urls = event->mimeData()->urls();
@@ -467,6 +561,9 @@ void DolphinTabWidget::currentTabChanged(int index)
     if (tabPage == m_lastViewedTab) {
         return;
     }
+    // Create the view containers and start the first listing of a tab that
+    // was restored in a hibernated state. A no-op for all other tabs.
+    tabPage->hydrate();
     if (m_lastViewedTab) {
         m_lastViewedTab->disconnectNavigators();
         m_lastViewedTab->setActive(false);
@@ -496,7 +593,7 @@ void DolphinTabWidget::tabInserted(int index)
     if (tabBar()->isVisible()) {
         // Resolve all pending tab icons
         for (int i = 0; i < count(); ++i) {
-            const QUrl url = tabPageAt(i)->activeViewContainer()->url();
+            const QUrl url = tabPageAt(i)->activeViewUrl();
             if (tabBar()->tabIcon(i).isNull()) {
                 // ensure the path url ends with a slash to have proper folder icon for remote folders
                 const QUrl pathUrl = QUrl(url.adjusted(QUrl::StripTrailingSlash).toString(QUrl::FullyEncoded).append("/"));
@@ -526,7 +623,14 @@ QString DolphinTabWidget::tabName(DolphinTabPage *tabPage) const
     }
     // clang-format off
     QString name;
-    if (tabPage->splitViewEnabled()) {
+    if (!tabPage->isHydrated()) {
+        // Until the tab is activated for the first time only its URL is
+        // known; the proper caption follows once the view exists.
+        name = tabPage->activeViewUrl().fileName();
+        if (name.isEmpty()) {
+            name = tabPage->activeViewUrl().toDisplayString(QUrl::PreferLocalFile);
+        }
+    } else if (tabPage->splitViewEnabled()) {
         if (tabPage->primaryViewActive()) {
             // i18n: %1 is the primary view and %2 the secondary view. For left to right languages the primary view is on the left so we also want it to be on the
             // left in the tab name. In right to left languages the primary view would be on the right so the tab name should match.
@@ -576,12 +680,20 @@ const std::optional<const DolphinTabWidget::ViewIndex> DolphinTabWidget::viewOpe
     // loop over the tabs starting from the current one
     do {
         const auto tabPage = tabPageAt(i);
-        if (tabPage->primaryViewContainer()->url() == directory) {
-            return std::optional(ViewIndex{i, true});
-        }
+        if (!tabPage->isHydrated()) {
+            // Only the URL of the primary view of a hibernated tab is known.
+            // Activating the returned view index hydrates the tab.
+            if (tabPage->activeViewUrl() == directory) {
+                return std::optional(ViewIndex{i, true});
+            }
+        } else {
+            if (tabPage->primaryViewContainer()->url() == directory) {
+                return std::optional(ViewIndex{i, true});
+            }
 
-        if (tabPage->splitViewEnabled() && tabPage->secondaryViewContainer()->url() == directory) {
-            return std::optional(ViewIndex{i, false});
+            if (tabPage->splitViewEnabled() && tabPage->secondaryViewContainer()->url() == directory) {
+                return std::optional(ViewIndex{i, false});
+            }
         }
 
         i = (i + 1) % count();
@@ -613,6 +725,11 @@ const std::optional<const DolphinTabWidget::ViewIndex> DolphinTabWidget::viewSho
     // loop over the tabs starting from the current one
     do {
         const auto tabPage = tabPageAt(i);
+        if (!tabPage->isHydrated()) {
+            // A hibernated tab has no view that could have expanded folders.
+            i = (i + 1) % count();
+            continue;
+        }
         if (tabPage->primaryViewContainer()->url().isParentOf(item)) {
             const KFileItem fileItemContainingItem = tabPage->primaryViewContainer()->view()->items().findByUrl(dirContainingItem);
             if (!fileItemContainingItem.isNull() && tabPage->primaryViewContainer()->view()->isExpanded(fileItemContainingItem)) {
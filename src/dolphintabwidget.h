@@ -247,6 +247,15 @@ private:
      */
     QString tabName(DolphinTabPage *tabPage) const;
 
+    /**
+     * Appends a new hibernated tab page which will show \a url once it is
+     * activated for the first time. Used for the background tabs of a batch,
+     * so that opening many directories at once stays cheap, see
+     * openDirectories().
+     * @return A pointer to the opened DolphinTabPage.
+     */
+    DolphinTabPage *openNewHibernatedTab(const QUrl &url);
+
     struct ViewIndex {
         const int tabIndex;
         const bool isInPrimaryView;
@@ -0,0 +1,74 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "dolphinurlcompletionindex.h"
+
+#include <KIO/Global>
+
+namespace
+{
+/** Upper bound for the total number of directory names kept in the index. */
+constexpr int MaxIndexedNames = 10000;
+}
+
+DolphinUrlCompletionIndex &DolphinUrlCompletionIndex::instance()
+{
+    static DolphinUrlCompletionIndex index;
+    return index;
+}
+
+DolphinUrlCompletionIndex::DolphinUrlCompletionIndex()
+    : m_childDirectoryNames(MaxIndexedNames)
+{
+}
+
+void DolphinUrlCompletionIndex::recordListedDirectory(const QUrl &directory, const QStringList &childDirectoryNames)
+{
+    if (!directory.isValid()) {
+        return;
+    }
+
+    QStringList names = childDirectoryNames;
+    if (names.count() > MaxChildNamesPerDirectory) {
+        names = names.mid(0, MaxChildNamesPerDirectory);
+    }
+    m_childDirectoryNames.insert(keyForUrl(directory), new QStringList(names), qMax(1, int(names.count())));
+
+    // Remember the visited directory in its parent's entry as well, so a path
+    // towards it completes even if the parent was never listed by a view.
+    const QUrl parent = KIO::upUrl(directory);
+    if (parent.isValid() && parent != directory) {
+        const QString name = directory.adjusted(QUrl::StripTrailingSlash).fileName();
+        if (!name.isEmpty()) {
+            QStringList *siblings = m_childDirectoryNames.object(keyForUrl(parent));
+            if (siblings && !siblings->contains(name) && siblings->count() < MaxChildNamesPerDirectory) {
+                siblings->append(name);
+            } else if (!siblings) {
+                m_childDirectoryNames.insert(keyForUrl(parent), new QStringList{name});
+            }
+        }
+    }
+}
+
+QStringList DolphinUrlCompletionIndex::completionCandidates(const QUrl &directory, const QString &typedDirectoryPath) const
+{
+    QStringList candidates;
+    const QStringList *names = m_childDirectoryNames.object(keyForUrl(directory));
+    if (!names) {
+        return candidates;
+    }
+
+    candidates.reserve(names->count());
+    for (const QString &name : *names) {
+        candidates.append(typedDirectoryPath + name + QLatin1Char('/'));
+    }
+    return candidates;
+}
+
+QString DolphinUrlCompletionIndex::keyForUrl(const QUrl &url)
+{
+    return url.adjusted(QUrl::StripTrailingSlash).toString();
+}
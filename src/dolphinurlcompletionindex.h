@@ -0,0 +1,71 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef DOLPHINURLCOMPLETIONINDEX_H
+#define DOLPHINURLCOMPLETIONINDEX_H
+
+#include "dolphin_export.h"
+
+#include <QCache>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+
+/**
+ * @brief Process-wide index of directory names for instant path completion.
+ *
+ * KUrlCompletion lists the directory that is being completed with KIO while
+ * the user types. On slow mounts those listings arrive long after the
+ * keystroke, which makes typing a path in the editable URL navigator
+ * agonizing. This index remembers the child directory names of every
+ * directory a view has listed - information that was already paid for - so
+ * DolphinUrlNavigator can seed the completion synchronously from memory.
+ * Whether a completed path actually exists is verified by the normal
+ * navigation machinery once the user activates it.
+ */
+class DOLPHIN_EXPORT DolphinUrlCompletionIndex
+{
+public:
+    static DolphinUrlCompletionIndex &instance();
+
+    /**
+     * Upper bound for the number of child names remembered per directory.
+     * Callers collecting names from a listing can stop once it is reached.
+     */
+    static constexpr int MaxChildNamesPerDirectory = 500;
+
+    /**
+     * Records that the listing of \a directory contained the child
+     * directories \a childDirectoryNames. Called by KFileItemModel whenever
+     * a directory has been loaded. The visited \a directory itself is also
+     * added to the entry of its parent, so typing towards it completes even
+     * if the parent was never listed.
+     */
+    void recordListedDirectory(const QUrl &directory, const QStringList &childDirectoryNames);
+
+    /**
+     * @return Completion candidates for the child directories of
+     *         \a directory that are known to the index. The candidates are
+     *         \a typedDirectoryPath with the child name and a trailing slash
+     *         appended, so they are guaranteed to match the text the user
+     *         typed. An empty list is returned if the directory is unknown.
+     */
+    QStringList completionCandidates(const QUrl &directory, const QString &typedDirectoryPath) const;
+
+private:
+    DolphinUrlCompletionIndex();
+
+    static QString keyForUrl(const QUrl &url);
+
+    /// Child directory names keyed by the normalized URL of their parent.
+    /// The cost of an entry is its number of names, so the cache is bounded
+    /// by a total name budget rather than a directory count.
+    QCache<QString, QStringList> m_childDirectoryNames;
+
+    friend class DolphinUrlCompletionIndexSingleton;
+};
+
+#endif
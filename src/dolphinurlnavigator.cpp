@@ -9,6 +9,7 @@
 
 #include "dolphin_generalsettings.h"
 #include "dolphinplacesmodelsingleton.h"
+#include "dolphinurlcompletionindex.h"
 #include "dolphinurlnavigatorscontroller.h"
 #include "global.h"
 
@@ -51,6 +52,7 @@ DolphinUrlNavigator::DolphinUrlNavigator(const QUrl &url, QWidget *parent)
     DolphinUrlNavigatorsController::registerDolphinUrlNavigator(this);
 
     connect(this, &KUrlNavigator::returnPressed, this, &DolphinUrlNavigator::slotReturnPressed);
+    connect(editor()->lineEdit(), &QLineEdit::textEdited, this, &DolphinUrlNavigator::slotUrlEditorTextEdited);
 
     auto readOnlyBadge = new QLabel();
     readOnlyBadge->setPixmap(QIcon::fromTheme(QStringLiteral("emblem-readonly")).pixmap(12, 12));
@@ -146,6 +148,34 @@ void DolphinUrlNavigator::slotReturnPressed()
     }
 }
 
+void DolphinUrlNavigator::slotUrlEditorTextEdited(const QString &text)
+{
+    KCompletion *completion = editor()->completionObject();
+    if (!completion) {
+        return;
+    }
+
+    const int slashIndex = text.lastIndexOf(QLatin1Char('/'));
+    if (slashIndex < 0) {
+        return;
+    }
+    const QString typedDirectoryPath = text.left(slashIndex + 1);
+    if (typedDirectoryPath == m_lastSeededDirectoryPath) {
+        // The known candidates for this directory were already inserted.
+        return;
+    }
+    m_lastSeededDirectoryPath = typedDirectoryPath;
+
+    const QUrl directory = QUrl::fromUserInput(typedDirectoryPath, QString(), QUrl::AssumeLocalFile);
+    const QStringList candidates = DolphinUrlCompletionIndex::instance().completionCandidates(directory, typedDirectoryPath);
+    if (!candidates.isEmpty()) {
+        // Inserting into the completion object makes the candidates available
+        // to the current match immediately. KUrlCompletion's own asynchronous
+        // KIO listing merely adds to them once it finishes.
+        completion->insertItems(candidates);
+    }
+}
+
 void DolphinUrlNavigator::keyPressEvent(QKeyEvent *keyEvent)
 {
     if (keyEvent->key() == Qt::Key_Escape && !isUrlEditable()) {
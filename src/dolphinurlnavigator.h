@@ -104,6 +104,20 @@ protected:
      * Return focus back to the view when pressing Escape and this would have no other effect (e.g. deselecting or changing edit mode).
      */
     void keyPressEvent(QKeyEvent *keyEvent) override;
+
+private Q_SLOTS:
+    /**
+     * Seeds the completion object with the directory names the shared
+     * DolphinUrlCompletionIndex knows for the directory part of the typed
+     * @p text. The candidates come from listings the views have already
+     * performed, so path completion responds instantly even while the
+     * asynchronous KIO listing of a slow mount is still pending.
+     */
+    void slotUrlEditorTextEdited(const QString &text);
+
+private:
+    /** The directory part of the typed text the completion was last seeded for. */
+    QString m_lastSeededDirectoryPath;
 };
 
 #endif // DOLPHINURLNAVIGATOR_H
@@ -13,6 +13,13 @@
 
 #include <KUrlComboBox>
 
+namespace
+{
+// Upper bound for the shared typed-url history. The editors show at most their own
+// maximum of entries anyway, so an unbounded list would only grow stale tails.
+const int TypedUrlHistoryLimit = 50;
+}
+
 void DolphinUrlNavigatorsController::slotReadSettings()
 {
     // The startup settings should (only) get applied if they have been
@@ -47,11 +54,50 @@ void DolphinUrlNavigatorsController::registerDolphinUrlNavigator(DolphinUrlNavig
 {
     s_instances.push_front(dolphinUrlNavigator);
     connect(dolphinUrlNavigator->editor(), &KUrlComboBox::completionModeChanged, DolphinUrlNavigatorsController::setCompletionMode);
+    connect(dolphinUrlNavigator, &KUrlNavigator::returnPressed, dolphinUrlNavigator, [dolphinUrlNavigator]() {
+        commitTypedUrl(dolphinUrlNavigator);
+    });
+    connect(dolphinUrlNavigator, &KUrlNavigator::editableStateChanged, dolphinUrlNavigator, [dolphinUrlNavigator](bool editable) {
+        if (editable) {
+            syncTypedUrlHistory(dolphinUrlNavigator);
+        }
+    });
+    syncTypedUrlHistory(dolphinUrlNavigator);
 }
 
 void DolphinUrlNavigatorsController::unregisterDolphinUrlNavigator(DolphinUrlNavigator *dolphinUrlNavigator)
 {
     s_instances.remove(dolphinUrlNavigator);
+    s_syncedHistoryVersions.remove(dolphinUrlNavigator);
+}
+
+void DolphinUrlNavigatorsController::commitTypedUrl(DolphinUrlNavigator *dolphinUrlNavigator)
+{
+    const QString typedUrl = dolphinUrlNavigator->editor()->currentText().trimmed();
+    if (typedUrl.isEmpty()) {
+        return;
+    }
+    if (!s_typedUrlHistory.isEmpty() && s_typedUrlHistory.constFirst() == typedUrl) {
+        // Nothing changed, so every synchronized editor stays synchronized.
+        return;
+    }
+    s_typedUrlHistory.removeOne(typedUrl);
+    s_typedUrlHistory.prepend(typedUrl);
+    while (s_typedUrlHistory.count() > TypedUrlHistoryLimit) {
+        s_typedUrlHistory.removeLast();
+    }
+    ++s_typedUrlHistoryVersion;
+    // The committing navigator's editor has inserted the new entry itself but does not carry
+    // the complete shared list, so it is deliberately not marked as synchronized here.
+}
+
+void DolphinUrlNavigatorsController::syncTypedUrlHistory(DolphinUrlNavigator *dolphinUrlNavigator)
+{
+    if (s_syncedHistoryVersions.value(dolphinUrlNavigator, -1) == s_typedUrlHistoryVersion) {
+        return;
+    }
+    dolphinUrlNavigator->editor()->setUrls(s_typedUrlHistory);
+    s_syncedHistoryVersions.insert(dolphinUrlNavigator, s_typedUrlHistoryVersion);
 }
 
 void DolphinUrlNavigatorsController::setCompletionMode(const KCompletion::CompletionMode completionMode)
@@ -66,5 +112,8 @@ void DolphinUrlNavigatorsController::setCompletionMode(const KCompletion::Comple
 
 std::forward_list<DolphinUrlNavigator *> DolphinUrlNavigatorsController::s_instances;
 bool DolphinUrlNavigatorsController::s_placesSelectorVisible = true;
+QStringList DolphinUrlNavigatorsController::s_typedUrlHistory;
+int DolphinUrlNavigatorsController::s_typedUrlHistoryVersion = 0;
+QHash<const DolphinUrlNavigator *, int> DolphinUrlNavigatorsController::s_syncedHistoryVersions;
 
 #include "moc_dolphinurlnavigatorscontroller.cpp"
@@ -10,7 +10,9 @@
 
 #include <KCompletion>
 
+#include <QHash>
 #include <QObject>
+#include <QStringList>
 
 #include <forward_list>
 
@@ -57,6 +59,22 @@ private:
      */
     static void unregisterDolphinUrlNavigator(DolphinUrlNavigator *dolphinUrlNavigator);
 
+    /**
+     * Adds the location bar text the user just committed on \p dolphinUrlNavigator to the
+     * typed-url history which all DolphinUrlNavigators share. The other navigators are not
+     * updated right away because with many tabs that would turn a single navigation into
+     * dozens of combo box updates. @see syncTypedUrlHistory().
+     */
+    static void commitTypedUrl(DolphinUrlNavigator *dolphinUrlNavigator);
+
+    /**
+     * Hands the shared typed-url history to the editor of \p dolphinUrlNavigator unless that
+     * editor already carries the current version of it. QStringList is implicitly shared, so
+     * an up-to-date editor costs a version comparison and an outdated one a copy-on-write
+     * reference to the central list.
+     */
+    static void syncTypedUrlHistory(DolphinUrlNavigator *dolphinUrlNavigator);
+
 private Q_SLOTS:
     /**
      * Sets the completion mode for all DolphinUrlNavigators and saves it in settings.
@@ -70,6 +88,15 @@ private:
     /** Caches the (negated) places panel visibility */
     static bool s_placesSelectorVisible;
 
+    /** The typed-url history all DolphinUrlNavigators share. The newest entry comes first. */
+    static QStringList s_typedUrlHistory;
+
+    /** Incremented whenever s_typedUrlHistory changes. @see syncTypedUrlHistory(). */
+    static int s_typedUrlHistoryVersion;
+
+    /** The history version the editor of each DolphinUrlNavigator was last synchronized with. */
+    static QHash<const DolphinUrlNavigator *, int> s_syncedHistoryVersions;
+
     friend class DolphinUrlNavigator;
 };
 
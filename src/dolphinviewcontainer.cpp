@@ -359,6 +359,7 @@ void DolphinViewContainer::setSearchBarVisible(bool visible)
                     m_statusBar->showProgress(currentlyRunningTaskTitle, installationProgressPercent, DolphinStatusBar::CancelLoading::Disallowed);
                 });
         connect(m_searchBar, &Search::Bar::visibilityChanged, this, &DolphinViewContainer::searchBarVisibilityChanged);
+        m_searchBar->setFacetAggregator(m_view->searchFacetAggregator());
         m_topLayout->addWidget(m_searchBar, positionFor.searchBar, 0);
     }
 
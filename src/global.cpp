@@ -18,6 +18,52 @@
 #include <KWindowSystem>
 
 #include <QApplication>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace
+{
+/**
+ * Well-known service name owned by the GUI instance whose window was activated
+ * most recently. Distinct from "org.kde.dolphin", which KDBusService claims in
+ * daemon mode, and from "org.kde.dolphin-<pid>", which every GUI instance
+ * registers. See Dolphin::claimInstanceRendezvous().
+ */
+constexpr QLatin1String RendezvousServiceName("org.kde.dolphin.ActiveInstance");
+
+/** Path of the pid file fallback of the rendezvous, or an empty string if there is no runtime directory. */
+QString rendezvousPidFilePath()
+{
+    const QString runtimeDir = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+    if (runtimeDir.isEmpty()) {
+        return QString();
+    }
+    return runtimeDir + QLatin1String("/dolphin-active-instance.pid");
+}
+
+/**
+ * Returns the per-pid service name of the instance recorded in the rendezvous
+ * pid file, or an empty string if the file is missing or names this process.
+ * The returned service may no longer exist; callers have to validate it.
+ */
+QString serviceFromRendezvousPidFile()
+{
+    const QString pidFilePath = rendezvousPidFilePath();
+    if (pidFilePath.isEmpty()) {
+        return QString();
+    }
+    QFile pidFile(pidFilePath);
+    if (!pidFile.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    const qint64 pid = pidFile.readAll().trimmed().toLongLong();
+    if (pid <= 0 || pid == QCoreApplication::applicationPid()) {
+        return QString();
+    }
+    return QStringLiteral("org.kde.dolphin-%1").arg(pid);
+}
+}
 
 QList<QUrl> Dolphin::validateUris(const QStringList &uriList)
 {
@@ -69,19 +115,54 @@ bool Dolphin::attachToExistingInstance(const QList<QUrl> &inputUrls,
         return false;
     }
 
-    auto dolphinInterfaces = dolphinGuiInstances(preferredService);
-    if (dolphinInterfaces.isEmpty()) {
-        return false;
+    QVector<QPair<QSharedPointer<OrgKdeDolphinMainWindowInterface>, QStringList>> dolphinInterfaces;
+    int activeWindowIndex = -1;
+
+    if (preferredService.isEmpty()) {
+        // Fast path: the most recently activated instance claims a well-known
+        // rendezvous (a service name plus a pid file as fallback, see
+        // claimInstanceRendezvous()), so the common "dolphin <path>" invocation
+        // can talk to it directly instead of interrogating every instance on
+        // the bus one after the other.
+        const QString pidFileService = serviceFromRendezvousPidFile();
+        for (const QString &service : {QString(RendezvousServiceName), pidFileService}) {
+            if (service.isEmpty()) {
+                continue;
+            }
+            QSharedPointer<OrgKdeDolphinMainWindowInterface> interface(
+                new OrgKdeDolphinMainWindowInterface(service, QStringLiteral("/dolphin/Dolphin_1"), QDBusConnection::sessionBus()));
+            if (!interface->isValid() || interface->lastError().isValid()) {
+                continue;
+            }
+            // Probe the main window object: a stale rendezvous - e.g. a pid
+            // file left behind by an instance that exited - must not swallow
+            // the URLs.
+            auto probeReply = interface->isActiveWindow();
+            probeReply.waitForFinished();
+            if (!probeReply.isError()) {
+                dolphinInterfaces.append(qMakePair(interface, QStringList()));
+                activeWindowIndex = 0;
+                break;
+            }
+        }
     }
 
-    int activeWindowIndex = -1;
-    for (const auto &interface : std::as_const(dolphinInterfaces)) {
-        ++activeWindowIndex;
+    if (dolphinInterfaces.isEmpty()) {
+        // No usable rendezvous (or an explicitly preferred service): fall back
+        // to enumerating all instances and asking each one for its state.
+        dolphinInterfaces = dolphinGuiInstances(preferredService);
+        if (dolphinInterfaces.isEmpty()) {
+            return false;
+        }
+
+        for (const auto &interface : std::as_const(dolphinInterfaces)) {
+            ++activeWindowIndex;
 
-        auto isActiveWindowReply = interface.first->isActiveWindow();
-        isActiveWindowReply.waitForFinished();
-        if (!isActiveWindowReply.isError() && isActiveWindowReply.value()) {
-            break;
+            auto isActiveWindowReply = interface.first->isActiveWindow();
+            isActiveWindowReply.waitForFinished();
+            if (!isActiveWindowReply.isError() && isActiveWindowReply.value()) {
+                break;
+            }
         }
     }
 
@@ -170,6 +251,25 @@ QVector<QPair<QSharedPointer<OrgKdeDolphinMainWindowInterface>, QStringList>> Do
     return dolphinInterfaces;
 }
 
+void Dolphin::claimInstanceRendezvous()
+{
+    QDBusConnectionInterface *sessionInterface = QDBusConnection::sessionBus().interface();
+    if (sessionInterface) {
+        // Whichever instance was activated last owns the name and hands it
+        // over as soon as a window of another instance is activated.
+        sessionInterface->registerService(RendezvousServiceName, QDBusConnectionInterface::ReplaceExistingService, QDBusConnectionInterface::AllowReplacement);
+    }
+
+    const QString pidFilePath = rendezvousPidFilePath();
+    if (!pidFilePath.isEmpty()) {
+        QSaveFile pidFile(pidFilePath);
+        if (pidFile.open(QIODevice::WriteOnly)) {
+            pidFile.write(QByteArray::number(QCoreApplication::applicationPid()));
+            pidFile.commit();
+        }
+    }
+}
+
 QPair<QString, Qt::SortOrder> Dolphin::sortOrderForUrl(QUrl &url)
 {
     ViewProperties globalProps(url);
@@ -44,6 +44,15 @@ bool attachToExistingInstance(const QList<QUrl> &inputUrls, bool openFiles, bool
  */
 QVector<QPair<QSharedPointer<OrgKdeDolphinMainWindowInterface>, QStringList>> dolphinGuiInstances(const QString &preferredService);
 
+/**
+ * Claims the per-session rendezvous which attachToExistingInstance() tries
+ * before enumerating all DBus services: a well-known service name plus a pid
+ * file as fallback. Called whenever a main window of this process becomes the
+ * active window, so the rendezvous always points at the most recently used
+ * instance.
+ */
+void claimInstanceRendezvous();
+
 QPair<QString, Qt::SortOrder> sortOrderForUrl(QUrl &url);
 
 /**
@@ -11,6 +11,7 @@
 #include <KDirNotify>
 #endif
 #include <KConfigGroup>
+#include <KConfigWatcher>
 #include <KFileItem>
 #include <KFileItemListProperties>
 #include <KLocalizedString>
@@ -33,8 +34,22 @@ HideFileItemAction::HideFileItemAction(QObject *parent)
 
 static bool pluginIsEnabled()
 {
-    KConfigGroup showGroup(KSharedConfig::openConfig(QStringLiteral("kservicemenurc")), QStringLiteral("Show"));
-    return showGroup.readEntry(QStringLiteral("hidefileitemaction"), false);
+    // This is queried on every context menu invocation, so the entry is read
+    // once and then kept up to date by watching the config for changes instead
+    // of re-opening it each time.
+    static bool enabled = false;
+    static KConfigWatcher::Ptr watcher;
+    if (!watcher) {
+        const KSharedConfig::Ptr config = KSharedConfig::openConfig(QStringLiteral("kservicemenurc"));
+        enabled = KConfigGroup(config, QStringLiteral("Show")).readEntry(QStringLiteral("hidefileitemaction"), false);
+        watcher = KConfigWatcher::create(config);
+        QObject::connect(watcher.data(), &KConfigWatcher::configChanged, [](const KConfigGroup &group) {
+            if (group.name() == QLatin1String("Show")) {
+                enabled = group.readEntry(QStringLiteral("hidefileitemaction"), false);
+            }
+        });
+    }
+    return enabled;
 }
 
 static QStringList readHiddenFileEntries(const QString &hiddenPath)
@@ -50,17 +65,6 @@ static QStringList readHiddenFileEntries(const QString &hiddenPath)
     return entriesNames;
 }
 
-static bool fileAlreadyHidden(const KFileItem &item)
-{
-    QString fileName = item.name();
-    QString parentPath = QFileInfo(item.localPath()).absolutePath();
-    QString hiddenPath = QDir(parentPath).filePath(".hidden");
-
-    QStringList entriesNames = readHiddenFileEntries(hiddenPath);
-
-    return entriesNames.contains(fileName);
-}
-
 static void writeHiddenFileEntries(const QString &hiddenPath, const QStringList &entriesNames)
 {
     QFile writeHiddenFile(hiddenPath);
@@ -70,22 +74,6 @@ static void writeHiddenFileEntries(const QString &hiddenPath, const QStringList
     }
 }
 
-static void writeFileToHidden(const QString &hiddenPath, const QString &fileName)
-{
-    QStringList entriesNames = readHiddenFileEntries(hiddenPath);
-    if (!entriesNames.contains(fileName)) {
-        entriesNames.append(fileName);
-        writeHiddenFileEntries(hiddenPath, entriesNames);
-    }
-}
-
-static void deleteFileFromHidden(const QString &hiddenPath, const QString &fileName)
-{
-    QStringList entriesNames = readHiddenFileEntries(hiddenPath);
-    entriesNames.removeAll(fileName);
-    writeHiddenFileEntries(hiddenPath, entriesNames);
-}
-
 QList<QAction *> HideFileItemAction::actions(const KFileItemListProperties &fileItemInfos, QWidget *parentWidget)
 {
     if (!pluginIsEnabled()) {
@@ -115,13 +103,22 @@ QList<QAction *> HideFileItemAction::actions(const KFileItemListProperties &file
     hideFolder->setEnabled(canWrite);
 
     connect(hideFolder, &QAction::triggered, this, [selectedItems, hiddenFilePath, parentFilePath]() {
+        // Read and write the ".hidden" file once for the whole selection.
+        QStringList entriesNames = readHiddenFileEntries(hiddenFilePath);
+        bool changed = false;
         for (const KFileItem &item : selectedItems) {
             if (item.name() == ".hidden") {
                 continue;
             }
 
-            QString fileName = item.name();
-            writeFileToHidden(hiddenFilePath, fileName);
+            if (!entriesNames.contains(item.name())) {
+                entriesNames.append(item.name());
+                changed = true;
+            }
+        }
+
+        if (changed) {
+            writeHiddenFileEntries(hiddenFilePath, entriesNames);
 
 #ifdef QT_DBUS_LIB
             org::kde::KDirNotify::emitFilesChanged({QUrl::fromLocalFile(parentFilePath)});
@@ -134,13 +131,19 @@ QList<QAction *> HideFileItemAction::actions(const KFileItemListProperties &file
     unhideFolder->setEnabled(canWrite);
 
     connect(unhideFolder, &QAction::triggered, this, [selectedItems, hiddenFilePath, parentFilePath]() {
+        // Read and write the ".hidden" file once for the whole selection.
+        QStringList entriesNames = readHiddenFileEntries(hiddenFilePath);
+        bool changed = false;
         for (const KFileItem &item : selectedItems) {
             if (item.name() == ".hidden") {
                 continue;
             }
 
-            QString fileName = item.name();
-            deleteFileFromHidden(hiddenFilePath, fileName);
+            changed |= entriesNames.removeAll(item.name()) > 0;
+        }
+
+        if (changed) {
+            writeHiddenFileEntries(hiddenFilePath, entriesNames);
 
 #ifdef QT_DBUS_LIB
             org::kde::KDirNotify::emitFilesChanged({QUrl::fromLocalFile(parentFilePath)});
@@ -148,10 +151,13 @@ QList<QAction *> HideFileItemAction::actions(const KFileItemListProperties &file
         }
     });
 
+    // Read the ".hidden" file once; all selected items share the same parent directory.
+    const QStringList hiddenEntries = readHiddenFileEntries(hiddenFilePath);
+
     bool anyFileHidden = false;
     bool anyFileVisible = false;
     for (const KFileItem &item : selectedItems) {
-        if (fileAlreadyHidden(item)) {
+        if (hiddenEntries.contains(item.name())) {
             anyFileHidden = true;
         } else {
             anyFileVisible = true;
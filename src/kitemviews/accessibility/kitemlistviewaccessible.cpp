@@ -34,7 +34,6 @@ KItemListViewAccessible::KItemListViewAccessible(KItemListView *view_, KItemList
 {
     Q_ASSERT(view());
     Q_CHECK_PTR(parent);
-    m_accessibleDelegates.resize(childCount());
 
     m_announceCurrentItemTimer = new QTimer{view_};
     m_announceCurrentItemTimer->setSingleShot(true);
@@ -46,10 +45,8 @@ KItemListViewAccessible::KItemListViewAccessible(KItemListView *view_, KItemList
 
 KItemListViewAccessible::~KItemListViewAccessible()
 {
-    for (AccessibleIdWrapper idWrapper : std::as_const(m_accessibleDelegates)) {
-        if (idWrapper.isValid) {
-            QAccessible::deleteAccessibleInterface(idWrapper.id);
-        }
+    for (const QAccessible::Id id : std::as_const(m_accessibleDelegates)) {
+        QAccessible::deleteAccessibleInterface(id);
     }
 }
 
@@ -73,18 +70,14 @@ QAccessibleInterface *KItemListViewAccessible::accessibleDelegate(int index) con
         return nullptr;
     }
 
-    if (m_accessibleDelegates.size() <= index) {
-        m_accessibleDelegates.resize(childCount());
+    const auto it = m_accessibleDelegates.constFind(index);
+    if (it != m_accessibleDelegates.constEnd()) {
+        return QAccessible::accessibleInterface(it.value());
     }
-    Q_ASSERT(index < m_accessibleDelegates.size());
 
-    AccessibleIdWrapper idWrapper = m_accessibleDelegates.at(index);
-    if (!idWrapper.isValid) {
-        idWrapper.id = QAccessible::registerAccessibleInterface(new KItemListDelegateAccessible(view(), index));
-        idWrapper.isValid = true;
-        m_accessibleDelegates.insert(index, idWrapper);
-    }
-    return QAccessible::accessibleInterface(idWrapper.id);
+    const QAccessible::Id id = QAccessible::registerAccessibleInterface(new KItemListDelegateAccessible(view(), index));
+    m_accessibleDelegates.insert(index, id);
+    return QAccessible::accessibleInterface(id);
 }
 
 QAccessibleInterface *KItemListViewAccessible::cellAt(int row, int column) const
@@ -202,8 +195,26 @@ bool KItemListViewAccessible::unselectColumn(int)
     return true;
 }
 
-void KItemListViewAccessible::modelChange(QAccessibleTableModelChangeEvent * /*event*/)
+void KItemListViewAccessible::modelChange(QAccessibleTableModelChangeEvent *event)
+{
+    const int firstChangedIndex = (event->modelChangeType() == QAccessibleTableModelChangeEvent::ModelReset) ? 0 : event->firstRow();
+    dropCachedDelegatesFrom(firstChangedIndex);
+}
+
+void KItemListViewAccessible::dropCachedDelegatesFrom(int firstChangedIndex)
 {
+    // The cached KItemListDelegateAccessible objects at and behind the first changed row represent their old indices, which no longer match the items at those
+    // positions. They are dropped in one go per batch of changes and will be recreated lazily the next time an accessibility tool queries them. Recycling the
+    // registered objects for different indices instead is not an option because accessibility tools cache them by their accessible id and hence expect the
+    // identity of an id to never change.
+    for (auto it = m_accessibleDelegates.begin(); it != m_accessibleDelegates.end();) {
+        if (it.key() >= firstChangedIndex) {
+            QAccessible::deleteAccessibleInterface(it.value());
+            it = m_accessibleDelegates.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
 
 QAccessible::Role KItemListViewAccessible::role() const
@@ -346,12 +357,6 @@ QAccessibleInterface *KItemListViewAccessible::child(int index) const
     return nullptr;
 }
 
-KItemListViewAccessible::AccessibleIdWrapper::AccessibleIdWrapper()
-    : isValid(false)
-    , id(0)
-{
-}
-
 /* Selection interface */
 
 bool KItemListViewAccessible::clear()
@@ -13,6 +13,7 @@
 #include <QAccessible>
 #include <QAccessibleObject>
 #include <QAccessibleWidget>
+#include <QHash>
 #include <QPointer>
 
 class KItemListView;
@@ -74,6 +75,11 @@ public:
     bool selectColumn(int column) override;
     bool unselectRow(int row) override;
     bool unselectColumn(int column) override;
+    /**
+     * Drops the cached KItemListDelegateAccessible objects whose indices no longer match the items they were created for because rows have been inserted or
+     * removed. One call covers a whole batch of changes. The dropped cells are recreated lazily the next time an accessibility tool queries them.
+     * @see KItemListView::slotItemsInserted().
+     */
     void modelChange(QAccessibleTableModelChangeEvent *) override;
 
     // Selection interface
@@ -95,6 +101,13 @@ public:
     // Custom non-interface methods
     KItemListView *view() const;
 
+    /**
+     * The invalidation that modelChange() performs, callable directly by the view: while bulk model changes are coalesced into one deferred summary event
+     * (see KItemListView::scheduleAccessibleModelChange()), the cached cells must be dropped immediately so that queries arriving before the event is sent
+     * never see cells representing old indices.
+     */
+    void dropCachedDelegatesFrom(int firstChangedIndex);
+
     /**
      * Called by KItemListContainer when it passes on focus to the view. Accessible focus is then meant to go towards this accessible interface and a detailed
      * announcement of the current view state (current item and overall location state) should be triggered.
@@ -173,19 +186,13 @@ private:
      */
     bool m_shouldAnnounceLocation = true;
 
-    class AccessibleIdWrapper
-    {
-    public:
-        AccessibleIdWrapper();
-        bool isValid;
-        QAccessible::Id id;
-    };
     /**
-     * A list that maps the indices of the children of this KItemListViewAccessible to the accessible ids of the matching KItemListDelegateAccessible objects.
-     * For example: m_accessibleDelegates.at(2) would be the AccessibleIdWrapper with an id which can be used to retrieve the QAccessibleObject that represents
-     *              the third file in this view.
+     * Maps the indices of the children of this KItemListViewAccessible to the accessible ids of the matching KItemListDelegateAccessible objects.
+     * For example: m_accessibleDelegates.value(2) would be the id which can be used to retrieve the QAccessibleObject that represents the third file in this
+     * view. An entry only exists once an accessibility tool has actually queried the child, so the size of this hash is bounded by the number of queried items
+     * and not by the number of items in the view. @see accessibleDelegate().
      */
-    mutable QVector<AccessibleIdWrapper> m_accessibleDelegates;
+    mutable QHash<int, QAccessible::Id> m_accessibleDelegates;
 
     KItemListContainerAccessible *m_parent;
 };
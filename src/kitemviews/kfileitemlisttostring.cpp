@@ -14,7 +14,15 @@
 #include <QFontMetrics>
 #include <QString>
 
-QString fileItemListToString(KFileItemList items, int maximumTextWidth, const QFontMetrics &fontMetrics, ItemsState itemsState)
+namespace
+{
+// KFileItemListProperties iterates all items to classify the list. For huge
+// selections the added specificity of e.g. "Files" over "Items" is not worth
+// an O(n) sweep on every right-click, so classification is skipped then.
+constexpr int maxItemsToClassify = 1000;
+}
+
+QString fileItemListToString(const KFileItemList &items, int maximumTextWidth, const QFontMetrics &fontMetrics, ItemsState itemsState)
 {
     QString text;
     switch (items.count()) {
@@ -59,6 +67,19 @@ QString fileItemListToString(KFileItemList items, int maximumTextWidth, const QF
         return text;
     }
 
+    if (items.count() > maxItemsToClassify) {
+        if (itemsState == Selected) {
+            text = i18ncp("Textual representation of selected fileitems. %1 is the number of files/folders.",
+                          "One Selected Item",
+                          "%1 Selected Items",
+                          items.count());
+            if (fontMetrics.horizontalAdvance(text) <= maximumTextWidth) {
+                return text;
+            }
+        }
+        return i18ncp("Textual representation of fileitems. %1 is the number of files/folders.", "One Item", "%1 Items", items.count());
+    }
+
     const KFileItemListProperties properties(items);
     if (itemsState == Selected) {
         if (properties.isFile()) {
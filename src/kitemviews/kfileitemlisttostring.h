@@ -40,6 +40,10 @@ enum ItemsState { None, Selected };
  * \endcode
  * (The i18n call should be completely in the line following the i18n: comment without any line breaks within the i18n call or the comment might not be correctly extracted. See: https://commits.kde.org/kxmlgui/a31135046e1b3335b5d7bbbe6aa9a883ce3284c1 )
  *
+ * Only a bounded number of items is ever inspected: the names of at most the first five, and - to
+ * decide between e.g. "Files", "Folders" and "Items" wording - the types of at most the first
+ * thousand. Calling this with a selection of hundreds of thousands of items is therefore cheap.
+ *
  * @param items The KFileItemList for which a QString should be generated.
  * @param maximumTextWidth The maximum width/horizontalAdvance the QString should have. Keep scaling in mind.
  * @param fontMetrics the fontMetrics for the font that is used to calculate the maximumTextWidth.
@@ -48,6 +52,6 @@ enum ItemsState { None, Selected };
  *          Otherwise returns something like "5 Files", "8 Selected Folders" or "60 Items"
  *          while being as specific as possible.
  */
-QString fileItemListToString(KFileItemList items, int maximumTextWidth, const QFontMetrics &fontMetrics, ItemsState itemsState = ItemsState::None);
+QString fileItemListToString(const KFileItemList &items, int maximumTextWidth, const QFontMetrics &fontMetrics, ItemsState itemsState = ItemsState::None);
 
 #endif // KFILEITEMLISTTOSTRING_H
@@ -35,6 +35,46 @@ const int ShortInterval = 50;
 // the expensive re-generation of all previews is triggered repeatedly when
 // changing the zoom level.
 const int LongInterval = 300;
+
+// Scrolling is considered "fast" if more than FastScrollPages view heights
+// (resp. widths for horizontal scrolling) pass by per second. While scrolling
+// fast no previews are generated for the ranges which are just flicking by.
+const qreal FastScrollPages = 3.0;
+
+// Selections up to this size get the rectangular drag pixmap grid. Larger
+// selections get a stack of the first DragPixmapStackCount item pixmaps with
+// a count badge instead, so that starting a drag never walks more items than
+// can be told apart in the drag cursor anyway.
+const int DragPixmapMaxGridItems = 16;
+const int DragPixmapStackCount = 3;
+
+// Diagonal offset in logical pixels between the stacked pixmaps.
+const int DragPixmapStackOffset = 4;
+
+/**
+ * Returns the pixmap of the given item scaled to the given logical size,
+ * taken from the already cached "iconPixmap" role (preview or icon) when
+ * available and from the icon theme otherwise. Never does any I/O.
+ */
+QPixmap dragPixmapForIndex(const KItemModelBase *model, int index, int size, qreal dpr)
+{
+    QPixmap pixmap = model->data(index).value("iconPixmap").value<QPixmap>();
+    if (pixmap.isNull()) {
+        QIcon icon = QIcon::fromTheme(model->data(index).value("iconName").toString());
+        if (icon.isNull()) {
+            icon = QIcon::fromTheme(QStringLiteral("unknown"));
+        }
+        if (!icon.isNull()) {
+            pixmap = icon.pixmap(size, size);
+        } else {
+            pixmap = QPixmap(size, size);
+            pixmap.fill(Qt::transparent);
+        }
+    } else {
+        KPixmapModifier::scale(pixmap, QSize(size, size) * dpr);
+    }
+    return pixmap;
+}
 }
 
 KFileItemListView::KFileItemListView(QGraphicsWidget *parent)
@@ -57,6 +97,8 @@ KFileItemListView::KFileItemListView(QGraphicsWidget *parent)
     m_updateIconSizeTimer->setInterval(LongInterval);
     connect(m_updateIconSizeTimer, &QTimer::timeout, this, &KFileItemListView::updateIconSize);
 
+    connect(this, &KItemListView::scrollVelocityChanged, this, &KFileItemListView::slotScrollVelocityChanged);
+
     setVisibleRoles({"text"});
 }
 
@@ -130,15 +172,15 @@ QPixmap KFileItemListView::createDragPixmap(const KItemSet &indexes) const
     if (itemCount == 1) {
         return KItemListView::createDragPixmap(indexes);
     }
+    if (itemCount > DragPixmapMaxGridItems) {
+        return createCountBadgeDragPixmap(indexes);
+    }
 
     // If more than one item is dragged, align the items inside a
-    // rectangular grid. The maximum grid size is limited to 5 x 5 items.
+    // rectangular grid. The maximum grid size is limited to 4 x 4 items.
     int xCount;
     int size;
-    if (itemCount > 16) {
-        xCount = 5;
-        size = KIconLoader::SizeSmall;
-    } else if (itemCount > 9) {
+    if (itemCount > 9) {
         xCount = 4;
         size = KIconLoader::SizeSmallMedium;
     } else {
@@ -160,7 +202,8 @@ QPixmap KFileItemListView::createDragPixmap(const KItemSet &indexes) const
 
     const qreal dpr = KItemViewsUtils::devicePixelRatio(this);
     // Draw the selected items into the grid cells.
-    QPixmap dragPixmap(QSize(xCount * size + xCount, yCount * size + yCount) * dpr);
+    const QSize logicalSize(xCount * size + xCount, yCount * size + yCount);
+    QPixmap dragPixmap(logicalSize * dpr);
     dragPixmap.setDevicePixelRatio(dpr);
     dragPixmap.fill(Qt::transparent);
 
@@ -169,31 +212,17 @@ QPixmap KFileItemListView::createDragPixmap(const KItemSet &indexes) const
     int y = 0;
 
     for (int index : indexes) {
-        QPixmap pixmap = model()->data(index).value("iconPixmap").value<QPixmap>();
-        if (pixmap.isNull()) {
-            QIcon icon = QIcon::fromTheme(model()->data(index).value("iconName").toString());
-            if (icon.isNull()) {
-                icon = QIcon::fromTheme(QStringLiteral("unknown"));
-            }
-            if (!icon.isNull()) {
-                pixmap = icon.pixmap(size, size);
-            } else {
-                pixmap = QPixmap(size, size);
-                pixmap.fill(Qt::transparent);
-            }
-        } else {
-            KPixmapModifier::scale(pixmap, QSize(size, size) * dpr);
-        }
-
-        painter.drawPixmap(x, y, pixmap);
+        painter.drawPixmap(x, y, dragPixmapForIndex(model(), index, size, dpr));
 
         x += size + 1;
-        if (x >= dragPixmap.width()) {
+        // Compare against the logical size: painting happens in logical
+        // coordinates, the pixmap itself is allocated in device pixels.
+        if (x >= logicalSize.width()) {
             x = 0;
             y += size + 1;
         }
 
-        if (y >= dragPixmap.height()) {
+        if (y >= logicalSize.height()) {
             break;
         }
     }
@@ -201,6 +230,68 @@ QPixmap KFileItemListView::createDragPixmap(const KItemSet &indexes) const
     return dragPixmap;
 }
 
+QPixmap KFileItemListView::createCountBadgeDragPixmap(const KItemSet &indexes) const
+{
+    const int size = KIconLoader::SizeMedium;
+    const qreal dpr = KItemViewsUtils::devicePixelRatio(this);
+    const int canvasSize = size + (DragPixmapStackCount - 1) * DragPixmapStackOffset;
+
+    QPixmap dragPixmap(QSize(canvasSize, canvasSize) * dpr);
+    dragPixmap.setDevicePixelRatio(dpr);
+    dragPixmap.fill(Qt::transparent);
+
+    QPainter painter(&dragPixmap);
+
+    // Collect the pixmaps of the first items of the selection and draw them
+    // back to front, so that the first item ends up on top of the stack.
+    QVector<QPixmap> pixmaps;
+    pixmaps.reserve(DragPixmapStackCount);
+    for (int index : indexes) {
+        pixmaps.append(dragPixmapForIndex(model(), index, size, dpr));
+        if (pixmaps.count() == DragPixmapStackCount) {
+            break;
+        }
+    }
+    for (int i = pixmaps.count() - 1; i >= 0; --i) {
+        painter.drawPixmap(i * DragPixmapStackOffset, i * DragPixmapStackOffset, pixmaps.at(i));
+    }
+
+    // Badge with the total number of dragged items in the bottom right corner.
+    const QString countText = indexes.count() < 1000 ? QString::number(indexes.count()) : QStringLiteral("999+");
+    QFont font = styleOption().font;
+    font.setBold(true);
+    const QFontMetrics fontMetrics(font);
+    const int padding = 3;
+    QRect badgeRect(0, 0, qMax(fontMetrics.horizontalAdvance(countText), fontMetrics.height()) + 2 * padding, fontMetrics.height() + 2 * padding);
+    badgeRect.moveBottomRight(QPoint(canvasSize - 1, canvasSize - 1));
+
+    const QPalette &palette = styleOption().palette;
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(palette.color(QPalette::Highlight));
+    painter.drawRoundedRect(badgeRect, badgeRect.height() / 2.0, badgeRect.height() / 2.0);
+    painter.setFont(font);
+    painter.setPen(palette.color(QPalette::HighlightedText));
+    painter.drawText(badgeRect, Qt::AlignCenter, countText);
+
+    return dragPixmap;
+}
+
+void KFileItemListView::setRolesUpdaterSuspended(bool suspended)
+{
+    m_rolesUpdaterSuspended = suspended;
+    if (m_modelRolesUpdater) {
+        m_modelRolesUpdater->setSuspended(suspended);
+    }
+}
+
+void KFileItemListView::trimPreviews()
+{
+    if (m_modelRolesUpdater) {
+        m_modelRolesUpdater->trimPreviews();
+    }
+}
+
 void KFileItemListView::setHoverSequenceState(const QUrl &itemUrl, int seqIdx)
 {
     if (m_modelRolesUpdater) {
@@ -257,6 +348,7 @@ void KFileItemListView::onModelChanged(KItemModelBase *current, KItemModelBase *
         m_modelRolesUpdater = new KFileItemModelRolesUpdater(static_cast<KFileItemModel *>(current), this);
         m_modelRolesUpdater->setIconSize(availableIconSize());
         m_modelRolesUpdater->setDevicePixelRatio(KItemViewsUtils::devicePixelRatio(this));
+        m_modelRolesUpdater->setSuspended(m_rolesUpdaterSuspended);
 
         applyRolesToModel();
     }
@@ -395,6 +487,17 @@ void KFileItemListView::updateVisibleIndexRange()
     m_modelRolesUpdater->setPaused(isTransactionActive());
 }
 
+void KFileItemListView::slotScrollVelocityChanged(qreal pixelsPerSecond)
+{
+    if (!m_modelRolesUpdater) {
+        return;
+    }
+
+    const qreal viewLength = scrollOrientation() == Qt::Vertical ? size().height() : size().width();
+    const bool fast = viewLength > 0 && pixelsPerSecond > FastScrollPages * viewLength;
+    m_modelRolesUpdater->setScrollingFast(fast);
+}
+
 void KFileItemListView::triggerIconSizeUpdate()
 {
     if (!model()) {
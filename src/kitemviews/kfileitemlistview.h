@@ -73,6 +73,23 @@ public:
 
     QPixmap createDragPixmap(const KItemSet &indexes) const override;
 
+    /**
+     * Suspends or resumes the background work of the roles updater (preview
+     * generation, mime type sniffing, directory size counting). Is driven by
+     * the visibility of the view: there is no point in spending I/O and CPU
+     * on a view nobody sees, e.g. because its tab is in the background or its
+     * window is minimized. Changes that happen while suspended are coalesced
+     * by the roles updater and get resolved after resuming.
+     */
+    void setRolesUpdaterSuspended(bool suspended);
+
+    /**
+     * Drops the cached preview pixmaps of all items except a screenful
+     * around the visible range. Called for views in background tabs when the
+     * session is under memory pressure, @see DolphinCacheGovernor.
+     */
+    void trimPreviews();
+
     /**
      * Notifies the view of a change in the hover state on an item.
      *
@@ -109,6 +126,13 @@ private Q_SLOTS:
     void triggerVisibleIndexRangeUpdate();
     void updateVisibleIndexRange();
 
+    /**
+     * Suppresses the generation of previews while the view is scrolling fast,
+     * and triggers rebuilding the preview queue for the final viewport once
+     * the scrolling has settled.
+     */
+    void slotScrollVelocityChanged(qreal pixelsPerSecond);
+
     void triggerIconSizeUpdate();
     void updateIconSize();
 
@@ -128,6 +152,14 @@ private:
      */
     QSize availableIconSize() const;
 
+    /**
+     * @return Drag pixmap for selections too large for the item grid: a small
+     *         stack of the first few item pixmaps with a badge showing the
+     *         total count. Only touches the given number of items, so the cost
+     *         of starting a drag does not grow with the selection size.
+     */
+    QPixmap createCountBadgeDragPixmap(const KItemSet &indexes) const;
+
 private:
     void updateSelectedWidgets();
 
@@ -135,6 +167,10 @@ private:
     QTimer *m_updateVisibleIndexRangeTimer;
     QTimer *m_updateIconSizeTimer;
 
+    // Remembered so that the suspension survives switching the model, which
+    // recreates m_modelRolesUpdater. See setRolesUpdaterSuspended().
+    bool m_rolesUpdaterSuspended = false;
+
     friend class KFileItemListViewTest; // For unit testing
     friend class DolphinMainWindowTest; // For unit testing
 };
@@ -11,7 +11,20 @@
 #include "dolphin_contentdisplaysettings.h"
 #include "dolphin_generalsettings.h"
 #include "dolphindebug.h"
+#include "dolphinurlcompletionindex.h"
+#include "private/kfileitemclipboard.h"
 #include "private/kfileitemmodelsortalgorithm.h"
+#ifdef DOLPHIN_SORT_PROFILING
+#include "private/kfileitemrolestelemetry.h"
+#endif
+#include "private/klazyurlmimedata.h"
+#include "private/kdirectorylistingbroker.h"
+#include "private/klocaldirectorylister.h"
+#include "private/kmemoryaccounting.h"
+#include "private/kmimetypecache.h"
+#include "private/kpipelinetrace.h"
+#include "search/filenamesearchengine.h"
+#include "search/materializedsearchstore.h"
 #include "views/draganddrophelper.h"
 
 #include <KDirLister>
@@ -24,17 +37,65 @@
 #ifndef QT_NO_ACCESSIBILITY
 #include <QAccessible>
 #endif
+#include <QAtomicInt>
 #include <QElapsedTimer>
 #include <QIcon>
 #include <QMimeData>
 #include <QMimeDatabase>
+#include <QPixmap>
 #include <QRecursiveMutex>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
 #include <QTimer>
 #include <QWidget>
 #include <klazylocalizedstring.h>
 
+#include <cstring>
+#include <limits>
+#include <numeric>
+
 Q_GLOBAL_STATIC(QRecursiveMutex, s_collatorMutex)
 
+namespace
+{
+// Target wall-clock budget of a single insertItems() call dispatched from the
+// update interval timer, and the bounds of the adaptively sized batches.
+constexpr qint64 InsertBudgetMs = 10;
+constexpr int MinInsertBatchSize = 512;
+constexpr int MaxInsertBatchSize = 65536;
+
+// Resorting at least this many items is moved off the GUI thread so that
+// switching the sort role in a huge directory does not freeze the window.
+constexpr int BackgroundResortThreshold = 10000;
+
+// Listings with at least this many items spread the mime-type sniffing in
+// determineMimeTypes() across the thread pool.
+constexpr int ParallelMimeTypeThreshold = 100;
+
+// Number of recently shown directories whose final sort order is remembered
+// for instant back/forward navigation, see rememberDirectorySortOrder().
+constexpr int MaxRememberedDirectoryOrders = 5;
+
+// Number of collapsed directories that stay attached to the dir lister so
+// that their cached listings remain available (and watched for changes) for
+// a quick re-expansion, see retireExpandedDir().
+constexpr int MaxRetainedCollapsedDirs = 16;
+
+// Full-model filter passes in applyFilters() evaluate the filter for at least
+// this many items in parallel across the thread pool.
+constexpr int ParallelFilterThreshold = 1000;
+
+// Bounds of the adaptive interval at which buffered change notifications are
+// applied, see dispatchPendingRefreshItems(). A single changed file is shown
+// after the minimum interval; sustained notification storms (e.g. a build
+// writing thousands of files into a watched directory) stretch the interval
+// towards the maximum so that sorting and repainting happen once per batch.
+constexpr int MinRefreshCoalesceIntervalMs = 50;
+constexpr int MaxRefreshCoalesceIntervalMs = 1000;
+}
+
+QList<KFileItemModel::RememberedDirectoryOrder> KFileItemModel::s_rememberedDirectoryOrders;
+
 // #define KFILEITEMMODEL_DEBUG
 
 KFileItemModel::KFileItemModel(QObject *parent)
@@ -44,6 +105,7 @@ KFileItemModel::KFileItemModel(QObject *parent)
     , m_sortHiddenLast(false)
     , m_sortRole(NameRole)
     , m_sortingProgressPercent(-1)
+    , m_resortPendingWhileSorting(false)
     , m_roles()
     , m_itemData()
     , m_items()
@@ -52,6 +114,7 @@ KFileItemModel::KFileItemModel(QObject *parent)
     , m_requestRole()
     , m_maximumUpdateIntervalTimer(nullptr)
     , m_resortAllItemsTimer(nullptr)
+    , m_refreshCoalescingTimer(nullptr)
     , m_pendingItemsToInsert()
     , m_groups()
     , m_expandedDirs()
@@ -70,11 +133,17 @@ KFileItemModel::KFileItemModel(QObject *parent)
         m_dirLister->setMainWindow(parentWidget->window());
     }
 
-    connect(m_dirLister, &KCoreDirLister::started, this, &KFileItemModel::directoryLoadingStarted);
+    connect(m_dirLister, &KCoreDirLister::started, this, [this]() {
+        if (!m_adoptingLocalListing) {
+            // The takeover listing after a fast local listing is invisible to
+            // the outside; the loading was announced by startLocalListing().
+            Q_EMIT directoryLoadingStarted();
+        }
+    });
     connect(m_dirLister, &KCoreDirLister::canceled, this, &KFileItemModel::slotCanceled);
     connect(m_dirLister, &KCoreDirLister::itemsAdded, this, &KFileItemModel::slotItemsAdded);
     connect(m_dirLister, &KCoreDirLister::itemsDeleted, this, &KFileItemModel::slotItemsDeleted);
-    connect(m_dirLister, &KCoreDirLister::refreshItems, this, &KFileItemModel::slotRefreshItems);
+    connect(m_dirLister, &KCoreDirLister::refreshItems, this, &KFileItemModel::scheduleRefreshItems);
     connect(m_dirLister, &KCoreDirLister::clear, this, &KFileItemModel::slotClear);
     connect(m_dirLister, &KCoreDirLister::infoMessage, this, &KFileItemModel::infoMessage);
     connect(m_dirLister, &KCoreDirLister::jobError, this, &KFileItemModel::slotListerError);
@@ -82,6 +151,27 @@ KFileItemModel::KFileItemModel(QObject *parent)
     connect(m_dirLister, &KCoreDirLister::redirection, this, &KFileItemModel::directoryRedirection);
     connect(m_dirLister, &KCoreDirLister::listingDirCompleted, this, &KFileItemModel::slotCompleted);
 
+    m_backgroundResortWatcher = new QFutureWatcher<QList<ItemData *>>(this);
+    connect(m_backgroundResortWatcher, &QFutureWatcherBase::finished, this, &KFileItemModel::slotBackgroundResortFinished);
+
+    // Samples the comparison counter of the sorting threads while a
+    // background resort is in flight, see sampleSortProgress().
+    m_sortProgressSampleTimer = new QTimer(this);
+    m_sortProgressSampleTimer->setInterval(100);
+    connect(m_sortProgressSampleTimer, &QTimer::timeout, this, &KFileItemModel::sampleSortProgress);
+
+    // Feed the telemetry histograms with the size and the duration of every
+    // completed directory load, see slotCompleted(). The stop watch covers
+    // all loading paths because they all announce themselves through
+    // directoryLoadingStarted().
+    connect(this, &KFileItemModel::directoryLoadingStarted, this, [this]() {
+        m_directoryLoadStopWatch.start();
+    });
+
+    KFileItemClipboard *clipboard = KFileItemClipboard::instance();
+    m_cutUrls = clipboard->cutItems();
+    connect(clipboard, &KFileItemClipboard::cutItemsChanged, this, &KFileItemModel::slotCutItemsChanged);
+
     // Apply default roles that should be determined
     resetRoles();
     m_requestRole[NameRole] = true;
@@ -97,7 +187,7 @@ KFileItemModel::KFileItemModel(QObject *parent)
     m_maximumUpdateIntervalTimer = new QTimer(this);
     m_maximumUpdateIntervalTimer->setInterval(2000);
     m_maximumUpdateIntervalTimer->setSingleShot(true);
-    connect(m_maximumUpdateIntervalTimer, &QTimer::timeout, this, &KFileItemModel::dispatchPendingItemsToInsert);
+    connect(m_maximumUpdateIntervalTimer, &QTimer::timeout, this, &KFileItemModel::dispatchPendingItemsToInsertAdaptively);
 
     // When changing the value of an item which represents the sort-role a resorting must be
     // triggered. Especially in combination with KFileItemModelRolesUpdater this might be done
@@ -109,6 +199,11 @@ KFileItemModel::KFileItemModel(QObject *parent)
     m_resortAllItemsTimer->setSingleShot(true);
     connect(m_resortAllItemsTimer, &QTimer::timeout, this, &KFileItemModel::resortAllItems);
 
+    m_refreshCoalescingTimer = new QTimer(this);
+    m_refreshCoalescingTimer->setInterval(MinRefreshCoalesceIntervalMs);
+    m_refreshCoalescingTimer->setSingleShot(true);
+    connect(m_refreshCoalescingTimer, &QTimer::timeout, this, &KFileItemModel::dispatchPendingRefreshItems);
+
     connect(GeneralSettings::self(), &GeneralSettings::sortingChoiceChanged, this, &KFileItemModel::slotSortingChoiceChanged);
     connect(GeneralSettings::self(), &GeneralSettings::hiddenFilesWhitelistChanged, this, &KFileItemModel::slotHiddenFilesWhitelistChanged);
 
@@ -117,41 +212,458 @@ KFileItemModel::KFileItemModel(QObject *parent)
     m_filter.setHiddenFilesWhitelist(GeneralSettings::hiddenFilesWhitelist());
 
     setShowTrashMime(m_dirLister->showHiddenFiles() || !GeneralSettings::hideXTrashFile());
+
+    KMemoryAccounting::instance()->registerReporter(this, QByteArrayLiteral("KFileItemModel"), [this]() {
+        return estimatedMemoryUsageBytes();
+    });
 }
 
 KFileItemModel::~KFileItemModel()
 {
-    qDeleteAll(m_itemData);
-    qDeleteAll(m_filteredItems);
-    qDeleteAll(m_pendingItemsToInsert);
+    KMemoryAccounting::instance()->unregisterReporter(this);
+
+    if (m_backgroundResortWatcher->isRunning()) {
+        // The worker calls member functions like stringCompare(), so it must
+        // finish before the model is destroyed.
+        m_backgroundResortWatcher->disconnect();
+        m_backgroundResortWatcher->waitForFinished();
+    }
+
+    // All ItemData instances (m_itemData, m_filteredItems and
+    // m_pendingItemsToInsert) live in the arena and are released in one sweep.
+    m_itemArena.destroyAll();
 }
 
 void KFileItemModel::loadDirectory(const QUrl &url)
 {
+    rememberDirectorySortOrder();
+    if (Search::FilenameSearchEngine::canSearch(url)) {
+        startFilenameSearch(url);
+        return;
+    }
+    stopFilenameSearch();
+    stopLocalListing();
+    // When another model already holds the directory, a KDirLister listing is
+    // served from the in-process lister cache without any I/O and shares the
+    // existing directory watcher - faster than even the fast listing path.
+    if (KLocalDirectoryLister::canList(url) && GeneralSettings::useLocalListingFastPath()
+        && !KDirectoryListingBroker::instance()->isDirectoryHeldByOthers(url, this)) {
+        startLocalListing(url);
+        return;
+    }
+    m_dirLister->openUrl(url);
+    KDirectoryListingBroker::instance()->setHeldDirectory(this, url);
+}
+
+void KFileItemModel::startFilenameSearch(const QUrl &url)
+{
+    if (m_filenameSearchEngine && m_filenameSearchEngine->refine(url)) {
+        // The new term extends the previous one, so every new match is a
+        // subset of what was already found: the delivered results are
+        // re-filtered client-side while the walker continues with the
+        // narrower pattern instead of restarting the whole search.
+        dispatchPendingItemsToInsert();
+
+        QList<int> indexesToRemove;
+        for (int i = 0; i < m_itemData.count(); ++i) {
+            if (!m_filenameSearchEngine->matchesName(m_itemData.at(i)->item.name())) {
+                indexesToRemove.append(i);
+            }
+        }
+        if (!indexesToRemove.isEmpty()) {
+            removeItems(KItemRangeList::fromSortedContainer(indexesToRemove), DeleteItemData);
+        }
+
+        // Also drop results that the name or hidden-files filter is holding back.
+        QHash<KFileItem, ItemData *>::iterator it = m_filteredItems.begin();
+        while (it != m_filteredItems.end()) {
+            if (!m_filenameSearchEngine->matchesName(it.key().name())) {
+                it = m_filteredItems.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        Q_EMIT directoryLoadingStarted();
+        if (!m_filenameSearchEngine->isRunning()) {
+            // The walk had already finished, so the re-filtered results are
+            // all there is.
+            Q_EMIT directoryLoadingCompleted();
+        }
+        return;
+    }
+
+    auto *engine = new Search::FilenameSearchEngine(url, this);
+
+    // When the search starts in the directory the model is already showing, its direct children are resident and become first results instantly: the
+    // non-matching ones are removed and the walker skips the root directory so the kept items are not delivered a second time. Only a flat, completely
+    // listed directory qualifies — with expanded folders or an unfinished listing the resident data would overlap with or miss walker results.
+    const bool reuseResidentItems = !m_filenameSearchEngine && !m_localListingSubscription && m_expandedDirs.isEmpty() && m_dirLister->isFinished()
+        && directory().isLocalFile() && directory().adjusted(QUrl::StripTrailingSlash).toLocalFile() == engine->rootPath();
+
+    stopFilenameSearch();
+    stopLocalListing();
+    m_dirLister->stop();
+
+    KFileItemList materializedItems;
+    if (reuseResidentItems) {
+        dispatchPendingItemsToInsert();
+
+        QList<int> indexesToRemove;
+        for (int i = 0; i < m_itemData.count(); ++i) {
+            if (!engine->matchesName(m_itemData.at(i)->item.name())) {
+                indexesToRemove.append(i);
+            }
+        }
+        if (!indexesToRemove.isEmpty()) {
+            removeItems(KItemRangeList::fromSortedContainer(indexesToRemove), DeleteItemData);
+        }
+
+        QHash<KFileItem, ItemData *>::iterator it = m_filteredItems.begin();
+        while (it != m_filteredItems.end()) {
+            if (!engine->matchesName(it.key().name())) {
+                it = m_filteredItems.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        engine->setSkipRootDirectoryEntries(true);
+    } else {
+        slotClear();
+        // When a previous run of this search was materialized, its result set
+        // becomes visible right away and the walk merely revalidates it in
+        // the background, see applyRevalidatedSearchResults().
+        materializedItems = Search::MaterializedSearchStore::instance()->load(url);
+    }
+    Q_EMIT directoryLoadingStarted();
+
+    m_filenameSearchEngine = engine;
+    if (!materializedItems.isEmpty()) {
+        slotItemsAdded(url, materializedItems);
+        dispatchPendingItemsToInsert();
+
+        // The walker's results are collected off-model and reconciled with
+        // the shown snapshot in one pass when the walk finishes, so the
+        // revalidation never inserts duplicates or flickers.
+        connect(m_filenameSearchEngine, &Search::FilenameSearchEngine::itemsFound, this, [this](const QUrl &directoryUrl, const KFileItemList &items) {
+            Q_UNUSED(directoryUrl)
+            m_revalidatedSearchItems += items;
+        });
+        connect(m_filenameSearchEngine, &Search::FilenameSearchEngine::finished, this, &KFileItemModel::applyRevalidatedSearchResults);
+    } else {
+        connect(m_filenameSearchEngine, &Search::FilenameSearchEngine::itemsFound, this, &KFileItemModel::slotItemsAdded);
+        connect(m_filenameSearchEngine, &Search::FilenameSearchEngine::finished, this, &KFileItemModel::slotCompleted);
+        connect(m_filenameSearchEngine, &Search::FilenameSearchEngine::finished, this, &KFileItemModel::materializeSearchResults);
+    }
+    m_filenameSearchEngine->start();
+}
+
+void KFileItemModel::stopFilenameSearch()
+{
+    if (m_filenameSearchEngine) {
+        m_filenameSearchEngine->stop();
+        m_filenameSearchEngine->deleteLater();
+        m_filenameSearchEngine = nullptr;
+    }
+    m_revalidatedSearchItems.clear();
+}
+
+void KFileItemModel::materializeSearchResults()
+{
+    if (!m_filenameSearchEngine) {
+        return;
+    }
+
+    // slotCompleted() ran first, so all pending items have been dispatched.
+    KFileItemList results;
+    results.reserve(m_itemData.count() + m_filteredItems.count());
+    for (const ItemData *itemData : std::as_const(m_itemData)) {
+        if (!itemData->parent) {
+            results.append(itemData->item);
+        }
+    }
+    for (auto it = m_filteredItems.constBegin(); it != m_filteredItems.constEnd(); ++it) {
+        if (!it.value()->parent) {
+            results.append(it.key());
+        }
+    }
+    Search::MaterializedSearchStore::instance()->save(m_filenameSearchEngine->url(), results);
+}
+
+void KFileItemModel::applyRevalidatedSearchResults()
+{
+    if (!m_filenameSearchEngine) {
+        return;
+    }
+    dispatchPendingItemsToInsert();
+
+    // The batches were collected while the term may have been refined, so
+    // only results that match the current pattern count as confirmed.
+    QSet<QUrl> freshUrls;
+    KFileItemList freshItems;
+    freshItems.reserve(m_revalidatedSearchItems.count());
+    for (const KFileItem &item : std::as_const(m_revalidatedSearchItems)) {
+        if (m_filenameSearchEngine->matchesName(item.name()) && !freshUrls.contains(item.url())) {
+            freshUrls.insert(item.url());
+            freshItems.append(item);
+        }
+    }
+    m_revalidatedSearchItems.clear();
+
+    // Drop materialized results the walk no longer found - the same ranged
+    // reconciliation the dir lister takeover uses in slotCompleted().
+    QList<int> indexesToRemove;
+    for (int i = 0; i < m_itemData.count(); ++i) {
+        const ItemData *itemData = m_itemData.at(i);
+        if (!itemData->parent && !freshUrls.contains(itemData->item.url())) {
+            indexesToRemove.append(i);
+        }
+    }
+    if (!indexesToRemove.isEmpty()) {
+        removeItems(KItemRangeList::fromSortedContainer(indexesToRemove), DeleteItemData);
+    }
+
+    QHash<KFileItem, ItemData *>::iterator it = m_filteredItems.begin();
+    while (it != m_filteredItems.end()) {
+        if (!it.value()->parent && !freshUrls.contains(it.key().url())) {
+            it = m_filteredItems.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Insert the results that appeared since the materialization.
+    KFileItemList newItems;
+    for (const KFileItem &item : std::as_const(freshItems)) {
+        if (index(item.url()) < 0 && !m_filteredItems.contains(item)) {
+            newItems.append(item);
+        }
+    }
+    if (!newItems.isEmpty()) {
+        slotItemsAdded(m_filenameSearchEngine->url(), newItems);
+    }
+
+    Search::MaterializedSearchStore::instance()->save(m_filenameSearchEngine->url(), freshItems);
+    slotCompleted();
+}
+
+void KFileItemModel::startLocalListing(const QUrl &url)
+{
+    // The dir lister is left holding the previously shown directories until
+    // here because the takeover after the fast listing uses KDirLister::Keep,
+    // which would otherwise keep them listed and watched forever.
+    m_dirLister->stop();
+    const QList<QUrl> heldDirectories = m_dirLister->directories();
+    for (const QUrl &heldDirectory : heldDirectories) {
+        m_dirLister->forgetDirs(heldDirectory);
+    }
+    KDirectoryListingBroker::instance()->setHeldDirectory(this, QUrl());
+
+    slotClear();
+    Q_EMIT directoryLoadingStarted();
+
+    // Hidden entries are fetched under the same conditions under which the
+    // dir lister would fetch them, so the takeover listing delivers the same
+    // set of items, see setShowHiddenFiles(). Models requesting the same
+    // directory with the same settings share one listing via the broker.
+    m_localListingSubscription =
+        KDirectoryListingBroker::instance()->subscribeToLocalListing(url, m_dirLister->showHiddenFiles(), m_dirLister->dirOnlyMode(), this);
+    connect(m_localListingSubscription, &KDirectoryListingSubscription::itemsListed, this, &KFileItemModel::slotItemsAdded);
+    connect(m_localListingSubscription, &KDirectoryListingSubscription::finished, this, &KFileItemModel::slotLocalListingCompleted);
+    connect(m_localListingSubscription, &KDirectoryListingSubscription::listingFailed, this, &KFileItemModel::slotLocalListingFailed);
+}
+
+void KFileItemModel::stopLocalListing()
+{
+    m_adoptingLocalListing = false;
+    if (m_localListingSubscription) {
+        // This method may run from within one of the subscription's own
+        // signal handlers, so the object is deleted via the event loop; the
+        // explicit unsubscribe detaches it from the broker right away.
+        m_localListingSubscription->unsubscribe();
+        m_localListingSubscription->deleteLater();
+        m_localListingSubscription = nullptr;
+    }
+}
+
+void KFileItemModel::slotLocalListingCompleted()
+{
+    slotCompleted();
+
+    // Hand the directory over to the dir lister, which restores the KDirWatch
+    // based change notifications, the refresh diffing and the lister cache
+    // for other views. Its listing is served from the kernel caches the fast
+    // listing just warmed. The Keep flag avoids the clear() a plain openUrl()
+    // would emit and keeps directories expanded in the meantime listed; the
+    // duplicated items are dropped in slotItemsAdded().
+    m_adoptingLocalListing = true;
+    const QUrl url = m_localListingSubscription->url();
+    m_dirLister->openUrl(url, KDirLister::Keep);
+    KDirectoryListingBroker::instance()->setHeldDirectory(this, url);
+}
+
+void KFileItemModel::slotLocalListingFailed()
+{
+    const QUrl url = m_localListingSubscription->url();
+    stopLocalListing();
+    // The KIO listing reports the error (e.g. a denied permission) through
+    // the usual channels.
     m_dirLister->openUrl(url);
+    KDirectoryListingBroker::instance()->setHeldDirectory(this, url);
+}
+
+void KFileItemModel::rememberDirectorySortOrder()
+{
+    const QUrl currentUrl = directory();
+    if (!currentUrl.isValid() || m_itemData.isEmpty() || !m_expandedDirs.isEmpty() || !m_filteredItems.isEmpty() || !m_pendingItemsToInsert.isEmpty()) {
+        // Only the order of a completely shown flat directory is remembered: A partial order
+        // would hardly ever be applicable again anyway.
+        return;
+    }
+    if (m_backgroundResortWatcher && m_backgroundResortWatcher->isRunning()) {
+        // m_itemData does not match the current sort settings yet. The order
+        // is remembered by applyResortedItems() once the resort is done.
+        return;
+    }
+
+    for (int i = 0; i < s_rememberedDirectoryOrders.count(); ++i) {
+        if (s_rememberedDirectoryOrders.at(i).url == currentUrl) {
+            s_rememberedDirectoryOrders.removeAt(i);
+            break;
+        }
+    }
+
+    RememberedDirectoryOrder order;
+    order.url = currentUrl;
+    order.sortRole = m_sortRole;
+    order.sortOrder = sortOrder();
+    order.naturalSorting = m_naturalSorting;
+    order.sortDirsFirst = m_sortDirsFirst;
+    order.sortHiddenLast = m_sortHiddenLast;
+    order.positions.reserve(m_itemData.count());
+    for (int i = 0; i < m_itemData.count(); ++i) {
+        order.positions.insert(m_itemData.at(i)->item.url(), i);
+    }
+
+    s_rememberedDirectoryOrders.append(order);
+    if (s_rememberedDirectoryOrders.count() > MaxRememberedDirectoryOrders) {
+        s_rememberedDirectoryOrders.removeFirst();
+    }
+}
+
+bool KFileItemModel::sortByRememberedOrder(QList<ItemData *> &items)
+{
+    if (!m_expandedDirs.isEmpty()) {
+        // The order of a tree depends on the parent chains, the remembered order only covers the flat directory.
+        return false;
+    }
+
+    int orderIndex = -1;
+    const QUrl currentUrl = directory();
+    for (int i = 0; i < s_rememberedDirectoryOrders.count(); ++i) {
+        if (s_rememberedDirectoryOrders.at(i).url == currentUrl) {
+            orderIndex = i;
+            break;
+        }
+    }
+    if (orderIndex < 0) {
+        return false;
+    }
+
+    const RememberedDirectoryOrder &order = s_rememberedDirectoryOrders.at(orderIndex);
+    if (order.sortRole != m_sortRole || order.sortOrder != sortOrder() || order.naturalSorting != m_naturalSorting || order.sortDirsFirst != m_sortDirsFirst
+        || order.sortHiddenLast != m_sortHiddenLast) {
+        return false;
+    }
+
+    QVector<QPair<int, ItemData *>> keyedItems;
+    keyedItems.reserve(items.count());
+    for (ItemData *itemData : std::as_const(items)) {
+        const auto it = order.positions.constFind(itemData->item.url());
+        if (it == order.positions.constEnd()) {
+            // The directory gained an item since it was last shown, so its position is
+            // unknown and the items have to be compared for real.
+            return false;
+        }
+        keyedItems.append(qMakePair(it.value(), itemData));
+    }
+
+    std::sort(keyedItems.begin(), keyedItems.end(), [](const QPair<int, ItemData *> &a, const QPair<int, ItemData *> &b) {
+        return a.first < b.first;
+    });
+    for (int i = 0; i < keyedItems.count(); ++i) {
+        items[i] = keyedItems.at(i).second;
+    }
+
+    // Move the used entry to the most-recently-used end of the list.
+    s_rememberedDirectoryOrders.append(s_rememberedDirectoryOrders.takeAt(orderIndex));
+    return true;
 }
 
 void KFileItemModel::refreshDirectory(const QUrl &url)
 {
+    if (m_filenameSearchEngine) {
+        // Search results cannot be diffed against a lister cache; the search
+        // is simply run again.
+        loadDirectory(url);
+        Q_EMIT directoryRefreshing();
+        return;
+    }
+
+    if (m_localListingSubscription) {
+        // The fast local listing is still running or the dir lister has not
+        // completed its takeover yet, so there is no lister cache to diff
+        // against; the listing is simply run again.
+        loadDirectory(url);
+        Q_EMIT directoryRefreshing();
+        return;
+    }
+
     // Refresh all expanded directories first (Bug 295300)
     QHashIterator<QUrl, QUrl> expandedDirs(m_expandedDirs);
     while (expandedDirs.hasNext()) {
         expandedDirs.next();
-        m_dirLister->openUrl(expandedDirs.value(), KDirLister::Reload);
+        m_dirLister->updateDirectory(expandedDirs.value());
     }
 
-    m_dirLister->openUrl(url, KDirLister::Reload);
+    // Use the diffing update instead of a reload: the lister compares the
+    // fresh listing against its cached items and only emits the
+    // added/deleted/changed deltas, which the model applies incrementally.
+    // This keeps the cost of refreshing a huge directory where only a few
+    // items changed proportional to the changes, and neither the scroll
+    // position nor the selection is lost by a rebuild.
+    m_dirLister->updateDirectory(url);
 
     Q_EMIT directoryRefreshing();
 }
 
 QUrl KFileItemModel::directory() const
 {
+    if (m_filenameSearchEngine) {
+        return m_filenameSearchEngine->url();
+    }
+    if (m_localListingSubscription) {
+        // The dir lister still reports the previously shown directory until
+        // its takeover listing starts.
+        return m_localListingSubscription->url();
+    }
     return m_dirLister->url();
 }
 
 void KFileItemModel::cancelDirectoryLoading()
 {
+    if (m_filenameSearchEngine && m_filenameSearchEngine->isRunning()) {
+        m_filenameSearchEngine->stop();
+        slotCanceled();
+    }
+    if (m_localListingSubscription) {
+        const bool wasRunning = !m_localListingSubscription->isFinished();
+        stopLocalListing();
+        if (wasRunning) {
+            slotCanceled();
+        }
+    }
     m_dirLister->stop();
 }
 
@@ -166,21 +678,23 @@ QHash<QByteArray, QVariant> KFileItemModel::data(int index) const
         ItemData *data = m_itemData.at(index);
         if (data->values.isEmpty()) {
             data->values = retrieveData(data->item, data->parent);
-        } else if (data->values.count() <= 2 && data->values.value("isExpanded").toBool()) {
-            // Special case dealt by slotRefreshItems(), avoid losing the "isExpanded" and "expandedParentsCount" state when refreshing
-            // slotRefreshItems() makes sure folders keep the "isExpanded" and "expandedParentsCount" while clearing the remaining values
-            // so this special request of different behavior can be identified here.
-            bool hasExpandedParentsCount = false;
-            const int expandedParentsCount = data->values.value("expandedParentsCount").toInt(&hasExpandedParentsCount);
-
-            data->values = retrieveData(data->item, data->parent);
-            data->values.insert("isExpanded", true);
-            if (hasExpandedParentsCount) {
-                data->values.insert("expandedParentsCount", expandedParentsCount);
+        } else if (!data->values.contains("url")) {
+            // Only individual roles have been stored so far: the sort role by
+            // prepareItemsForSorting(), or the "isExpanded" and
+            // "expandedParentsCount" state which slotRefreshItems() preserves
+            // while clearing the remaining values. retrieveData() always
+            // stores "url", so its absence identifies such partial values.
+            // The remaining roles are materialized now and the already stored
+            // values win: they are either identical or fresher.
+            QHash<QByteArray, QVariant> values = retrieveData(data->item, data->parent);
+            const QHash<QByteArray, QVariant> storedValues = data->values.toHash();
+            for (auto it = storedValues.constBegin(); it != storedValues.constEnd(); ++it) {
+                values.insert(it.key(), it.value());
             }
+            data->values = values;
         }
 
-        return data->values;
+        return data->values.toHash();
     }
     return QHash<QByteArray, QVariant>();
 }
@@ -191,6 +705,8 @@ bool KFileItemModel::setData(int index, const QHash<QByteArray, QVariant> &value
         return false;
     }
 
+    cancelBackgroundResort();
+
     QHash<QByteArray, QVariant> currentValues = data(index);
 
     // Determine which roles have been changed
@@ -231,9 +747,98 @@ bool KFileItemModel::setData(int index, const QHash<QByteArray, QVariant> &value
     return true;
 }
 
+void KFileItemModel::setDataForRole(const QByteArray &role, const QList<QPair<int, QVariant>> &indexValues)
+{
+    Q_ASSERT(role != "text");
+
+    cancelBackgroundResort();
+
+    const QByteArray sharedRole = sharedValue(role);
+    QList<int> changedIndexes;
+    changedIndexes.reserve(indexValues.count());
+
+    for (const QPair<int, QVariant> &indexValue : indexValues) {
+        const int index = indexValue.first;
+        if (index < 0 || index >= count()) {
+            continue;
+        }
+
+        // Go through data() so that evicted role values are repopulated
+        // before the new value is merged in, just like setData() does.
+        QHash<QByteArray, QVariant> currentValues = data(index);
+        if (currentValues.value(sharedRole) == indexValue.second) {
+            continue;
+        }
+        currentValues.insert(sharedRole, indexValue.second);
+        m_itemData[index]->values = currentValues;
+        changedIndexes.append(index);
+    }
+
+    if (changedIndexes.isEmpty()) {
+        return;
+    }
+
+    std::sort(changedIndexes.begin(), changedIndexes.end());
+
+    KItemRangeList changedRanges;
+    int rangeStart = changedIndexes.first();
+    int rangeLength = 1;
+    for (int i = 1; i < changedIndexes.count(); ++i) {
+        if (changedIndexes.at(i) == rangeStart + rangeLength) {
+            ++rangeLength;
+        } else {
+            changedRanges.append(KItemRange(rangeStart, rangeLength));
+            rangeStart = changedIndexes.at(i);
+            rangeLength = 1;
+        }
+    }
+    changedRanges.append(KItemRange(rangeStart, rangeLength));
+
+    emitItemsChangedAndTriggerResorting(changedRanges, {sharedRole});
+}
+
+void KFileItemModel::beginItemsChangedBatch()
+{
+    ++m_itemsChangedBatchDepth;
+}
+
+void KFileItemModel::endItemsChangedBatch()
+{
+    Q_ASSERT(m_itemsChangedBatchDepth > 0);
+    --m_itemsChangedBatchDepth;
+    if (m_itemsChangedBatchDepth > 0 || m_batchedItemsChangedRanges.isEmpty()) {
+        return;
+    }
+
+    KItemRangeList bufferedRanges = m_batchedItemsChangedRanges;
+    const QSet<QByteArray> changedRoles = m_batchedItemsChangedRoles;
+    m_batchedItemsChangedRanges.clear();
+    m_batchedItemsChangedRoles.clear();
+
+    // Merge the buffered (mostly single-item) ranges into as few ranges as
+    // possible. Overlaps can occur when an item was changed twice within the
+    // batch.
+    std::sort(bufferedRanges.begin(), bufferedRanges.end(), [](const KItemRange &a, const KItemRange &b) {
+        return a.index < b.index;
+    });
+    KItemRangeList mergedRanges;
+    mergedRanges.reserve(bufferedRanges.count());
+    for (const KItemRange &range : std::as_const(bufferedRanges)) {
+        if (!mergedRanges.isEmpty() && range.index <= mergedRanges.last().index + mergedRanges.last().count) {
+            KItemRange &last = mergedRanges.last();
+            last.count = qMax(last.count, range.index + range.count - last.index);
+        } else {
+            mergedRanges.append(range);
+        }
+    }
+
+    emitItemsChangedAndTriggerResorting(mergedRanges, changedRoles);
+}
+
 void KFileItemModel::setSortDirectoriesFirst(bool dirsFirst)
 {
     if (dirsFirst != m_sortDirsFirst) {
+        cancelBackgroundResort();
         m_sortDirsFirst = dirsFirst;
         resortAllItems();
     }
@@ -247,6 +852,7 @@ bool KFileItemModel::sortDirectoriesFirst() const
 void KFileItemModel::setSortHiddenLast(bool hiddenLast)
 {
     if (hiddenLast != m_sortHiddenLast) {
+        cancelBackgroundResort();
         m_sortHiddenLast = hiddenLast;
         resortAllItems();
     }
@@ -273,6 +879,16 @@ void KFileItemModel::setShowTrashMime(bool showTrashMime)
 
 void KFileItemModel::scheduleResortAllItems()
 {
+    if (m_sortingProgressPercent >= 0) {
+        // KFileItemModelRolesUpdater is still resolving the sort role for the
+        // remaining items. Resorting every 100 ms while batches of freshly
+        // resolved values keep arriving would sort the full directory many
+        // times over. Remember the request instead; emitSortProgress() does
+        // the single resort once the resolution pass is complete.
+        m_resortPendingWhileSorting = true;
+        return;
+    }
+
     if (!m_resortAllItemsTimer->isActive()) {
         m_resortAllItemsTimer->start();
     }
@@ -288,11 +904,17 @@ void KFileItemModel::setShowHiddenFiles(bool show)
     // Configure the filter to handle hidden file visibility
     m_filter.setHiddenFilesShown(show);
     m_filter.setHiddenFilesWhitelistEnabled(whitelistEnabled);
-    m_filter.setHiddenFilesWhitelist(GeneralSettings::hiddenFilesWhitelist());
+    applyHiddenFilesWhitelist(GeneralSettings::hiddenFilesWhitelist());
 
     setShowTrashMime(show || !GeneralSettings::hideXTrashFile());
 
-    if (oldDirListerShowHidden != newDirListerShowHidden) {
+    if (oldDirListerShowHidden != newDirListerShowHidden && m_localListingSubscription) {
+        // The fast local listing fetched according to the old setting and the
+        // dir lister may not hold the directory yet, so the listing is simply
+        // run again with the new setting.
+        m_dirLister->setShowHiddenFiles(newDirListerShowHidden);
+        loadDirectory(directory());
+    } else if (oldDirListerShowHidden != newDirListerShowHidden && !m_filenameSearchEngine) {
         // Need to reload directory to fetch/unfetch hidden files from KIO
         m_dirLister->setShowHiddenFiles(newDirListerShowHidden);
         const QUrl url = m_dirLister->url();
@@ -306,7 +928,10 @@ void KFileItemModel::setShowHiddenFiles(bool show)
             m_dirLister->openUrl(url, KDirLister::Reload);
         }
     } else {
-        // Hidden files already loaded, just re-apply filter
+        // Hidden files already loaded, just re-apply filter. The search
+        // engine always reports hidden items and leaves hiding them to
+        // m_filter, so search listings never need a reload either.
+        m_dirLister->setShowHiddenFiles(newDirListerShowHidden);
         applyFilters();
     }
 }
@@ -330,13 +955,13 @@ bool KFileItemModel::showDirectoriesOnly() const
 
 QMimeData *KFileItemModel::createMimeData(const KItemSet &indexes) const
 {
-    QMimeData *data = new QMimeData();
-
     // The following code has been taken from KDirModel::mimeData()
     // (kdelibs/kio/kio/kdirmodel.cpp)
     // SPDX-FileCopyrightText: 2006 David Faure <faure@kde.org>
     QList<QUrl> urls;
     QList<QUrl> mostLocalUrls;
+    urls.reserve(indexes.count());
+    mostLocalUrls.reserve(indexes.count());
     const ItemData *lastAddedItem = nullptr;
 
     for (int index : indexes) {
@@ -362,8 +987,10 @@ QMimeData *KFileItemModel::createMimeData(const KItemSet &indexes) const
         }
     }
 
-    KUrlMimeData::setUrls(urls, mostLocalUrls, data);
-    return data;
+    // Encoding the url-list payloads is by far the most expensive part for
+    // huge selections. KLazyUrlMimeData defers it until a target actually
+    // retrieves data, so that e.g. starting a drag stays cheap.
+    return new KLazyUrlMimeData(urls, mostLocalUrls);
 }
 
 namespace
@@ -383,19 +1010,58 @@ QString removeMarks(const QString &original)
 
 int KFileItemModel::indexForKeyboardSearch(const QString &text, int startFromIndex) const
 {
-    const auto noMarkText = removeMarks(text);
+    if (!m_keyboardSearchIndexValid) {
+        buildKeyboardSearchIndex();
+    }
+
+    const QString searchKey = removeMarks(text).toCaseFolded();
     startFromIndex = qMax(0, startFromIndex);
-    for (int i = startFromIndex; i < count(); ++i) {
-        if (removeMarks(fileItem(i).text()).startsWith(noMarkText, Qt::CaseInsensitive)) {
-            return i;
+
+    // All keys starting with searchKey form a contiguous run in the sorted
+    // index. Among those the smallest model index >= startFromIndex wins; if
+    // there is none, the search wraps around to the smallest matching index.
+    auto it = std::lower_bound(m_keyboardSearchIndex.constBegin(),
+                               m_keyboardSearchIndex.constEnd(),
+                               searchKey,
+                               [](const KeyboardSearchEntry &entry, const QString &key) {
+                                   return entry.key < key;
+                               });
+
+    int match = -1;
+    int wrappedMatch = -1;
+    for (; it != m_keyboardSearchIndex.constEnd() && it->key.startsWith(searchKey); ++it) {
+        if (it->index >= startFromIndex) {
+            if (match == -1 || it->index < match) {
+                match = it->index;
+            }
+        } else if (wrappedMatch == -1 || it->index < wrappedMatch) {
+            wrappedMatch = it->index;
         }
     }
-    for (int i = 0; i < startFromIndex; ++i) {
-        if (removeMarks(fileItem(i).text()).startsWith(noMarkText, Qt::CaseInsensitive)) {
-            return i;
-        }
+
+    return match != -1 ? match : wrappedMatch;
+}
+
+void KFileItemModel::buildKeyboardSearchIndex() const
+{
+    m_keyboardSearchIndex.clear();
+    m_keyboardSearchIndex.reserve(m_itemData.count());
+
+    for (int i = 0; i < m_itemData.count(); ++i) {
+        m_keyboardSearchIndex.append(KeyboardSearchEntry{removeMarks(m_itemData.at(i)->item.text()).toCaseFolded(), i});
     }
-    return -1;
+
+    std::sort(m_keyboardSearchIndex.begin(), m_keyboardSearchIndex.end(), [](const KeyboardSearchEntry &a, const KeyboardSearchEntry &b) {
+        return a.key < b.key;
+    });
+
+    m_keyboardSearchIndexValid = true;
+}
+
+void KFileItemModel::invalidateKeyboardSearchIndex()
+{
+    m_keyboardSearchIndexValid = false;
+    m_keyboardSearchIndex.clear();
 }
 
 bool KFileItemModel::supportsDropping(int index) const
@@ -444,43 +1110,7 @@ QList<QPair<int, QVariant>> KFileItemModel::groups() const
         QElapsedTimer timer;
         timer.start();
 #endif
-        switch (typeForRole(sortRole())) {
-        case NameRole:
-            m_groups = nameRoleGroups();
-            break;
-        case SizeRole:
-            m_groups = sizeRoleGroups();
-            break;
-        case ModificationTimeRole:
-            m_groups = timeRoleGroups([](const ItemData *item) {
-                return item->item.time(KFileItem::ModificationTime);
-            });
-            break;
-        case CreationTimeRole:
-            m_groups = timeRoleGroups([](const ItemData *item) {
-                return item->item.time(KFileItem::CreationTime);
-            });
-            break;
-        case AccessTimeRole:
-            m_groups = timeRoleGroups([](const ItemData *item) {
-                return item->item.time(KFileItem::AccessTime);
-            });
-            break;
-        case DeletionTimeRole:
-            m_groups = timeRoleGroups([](const ItemData *item) {
-                return item->values.value("deletiontime").toDateTime();
-            });
-            break;
-        case PermissionsRole:
-            m_groups = permissionRoleGroups();
-            break;
-        case RatingRole:
-            m_groups = ratingRoleGroups();
-            break;
-        default:
-            m_groups = genericStringRoleGroups(sortRole());
-            break;
-        }
+        m_groups = computeGroups(0, count() - 1);
 
 #ifdef KFILEITEMMODEL_DEBUG
         qCDebug(DolphinDebug) << "[TIME] Calculating groups for" << count() << "items:" << timer.elapsed();
@@ -518,7 +1148,7 @@ int KFileItemModel::index(const QUrl &url) const
     const QUrl urlToFind = url.adjusted(QUrl::StripTrailingSlash);
 
     const int itemCount = m_itemData.count();
-    int itemsInHash = m_items.count();
+    int itemsInHash = m_itemsCachedUpTo;
 
     int index = m_items.value(urlToFind, -1);
     while (index < 0 && itemsInHash < itemCount) {
@@ -532,12 +1162,14 @@ int KFileItemModel::index(const QUrl &url) const
         // which costs both CPU cycles and memory.
         const int blockSize = 1000;
         const int currentBlockEnd = qMin(itemsInHash + blockSize, itemCount);
+        m_items.reserve(currentBlockEnd);
         for (int i = itemsInHash; i < currentBlockEnd; ++i) {
             const QUrl nextUrl = m_itemData.at(i)->item.url();
             m_items.insert(nextUrl, i);
         }
 
         itemsInHash = currentBlockEnd;
+        m_itemsCachedUpTo = currentBlockEnd;
         index = m_items.value(urlToFind, -1);
     }
 
@@ -586,6 +1218,17 @@ int KFileItemModel::index(const QUrl &url) const
 
 KFileItem KFileItemModel::rootItem() const
 {
+    if (m_filenameSearchEngine) {
+        // Search result listings have no root item, just like listings of the
+        // "filenamesearch" KIO worker. The lister still holds the root item of
+        // the previously shown directory, which must not leak through here.
+        return KFileItem();
+    }
+    if (m_localListingSubscription) {
+        // The takeover listing has not delivered the dir lister's root item
+        // yet; a stat'ed stand-in bridges the gap.
+        return KFileItem(m_localListingSubscription->url());
+    }
     return m_dirLister->rootItem();
 }
 
@@ -600,7 +1243,11 @@ void KFileItemModel::setRoles(const QSet<QByteArray> &roles)
         return;
     }
 
-    const QSet<QByteArray> changedRoles = (roles - m_roles) + (m_roles - roles);
+    cancelBackgroundResort();
+
+    const QSet<QByteArray> addedRoles = roles - m_roles;
+    const QSet<QByteArray> removedRoles = m_roles - roles;
+    const QSet<QByteArray> changedRoles = addedRoles + removedRoles;
     m_roles = roles;
 
     if (count() > 0) {
@@ -614,6 +1261,35 @@ void KFileItemModel::setRoles(const QSet<QByteArray> &roles)
     }
 
     m_groups.clear();
+
+    if (count() > 0 && !addedRoles.isEmpty()) {
+        // Retrieve only the values of the added roles and merge them into the
+        // stored values. Re-retrieving all roles of all items - like it would
+        // happen implicitly via data() after clearing the values - makes
+        // toggling a single column in a huge directory take seconds.
+        resetRoles();
+        for (const QByteArray &role : addedRoles) {
+            m_requestRole[typeForRole(role)] = true;
+        }
+
+        const int maxIndex = count() - 1;
+        for (int i = 0; i <= maxIndex; ++i) {
+            ItemData *const itemData = m_itemData.at(i);
+            const int storedCount = itemData->values.count();
+            if (storedCount == 0 || (storedCount <= 2 && itemData->values.value("isExpanded").toBool())) {
+                // The values were evicted or reduced to the expansion state
+                // marker. data() re-retrieves them on demand, including the
+                // added roles.
+                continue;
+            }
+
+            const QHash<QByteArray, QVariant> addedValues = retrieveData(itemData->item, itemData->parent);
+            for (auto it = addedValues.constBegin(); it != addedValues.constEnd(); ++it) {
+                itemData->values.insert(it.key(), it.value());
+            }
+        }
+    }
+
     resetRoles();
 
     QSetIterator<QByteArray> it(roles);
@@ -622,13 +1298,16 @@ void KFileItemModel::setRoles(const QSet<QByteArray> &roles)
         m_requestRole[typeForRole(role)] = true;
     }
 
+    // Dropping a whole column at once is much cheaper than touching the
+    // stored values of every single item.
+    for (const QByteArray &role : removedRoles) {
+        m_columnStore.removeColumn(role);
+    }
+
     if (count() > 0) {
-        // Update m_data with the changed requested roles
-        const int maxIndex = count() - 1;
-        for (int i = 0; i <= maxIndex; ++i) {
-            m_itemData[i]->values = retrieveData(m_itemData.at(i)->item, m_itemData.at(i)->parent);
+        if (changedRoles.contains("text")) {
+            invalidateKeyboardSearchIndex();
         }
-
         Q_EMIT itemsChanged(KItemRangeList() << KItemRange(0, count()), changedRoles);
     }
 
@@ -647,6 +1326,109 @@ QSet<QByteArray> KFileItemModel::roles() const
     return m_roles;
 }
 
+void KFileItemModel::evictRoleValues(int firstVisibleIndex, int lastVisibleIndex, int itemBudget)
+{
+    if (count() <= itemBudget) {
+        return;
+    }
+
+    switch (m_sortRole) {
+    case NameRole:
+    case ModificationTimeRole:
+    case CreationTimeRole:
+    case AccessTimeRole:
+        // These roles compare the KFileItem directly, so a later resort does
+        // not depend on the stored values and eviction is safe.
+        break;
+    default:
+        // The sort role reads the stored values (e.g. "type", "size" of
+        // folders, Baloo roles). Evicting them would break resorting.
+        return;
+    }
+
+    cancelBackgroundResort();
+
+    // Keep a generous margin around the visible range so that scrolling does
+    // not immediately retrieve the values of nearby items again.
+    const int margin = qMax(itemBudget / 4, lastVisibleIndex - firstVisibleIndex + 1);
+    const int keepFirst = qMax(0, firstVisibleIndex - margin);
+    const int keepLast = qMin(count() - 1, lastVisibleIndex + margin);
+
+    for (int i = 0; i < count(); ++i) {
+        if (i == keepFirst) {
+            i = keepLast;
+            continue;
+        }
+
+        ItemData *itemData = m_itemData.at(i);
+        if (itemData->values.count() <= 2) {
+            // Nothing worth evicting. This also covers the expansion state
+            // special case handled by data().
+            continue;
+        }
+
+        // Folders keep their expansion state, like slotRefreshItems() does;
+        // data() re-retrieves everything else on demand.
+        const bool isExpanded = itemData->values.value("isExpanded").toBool();
+        bool hasExpandedParentsCount = false;
+        const int expandedParentsCount = itemData->values.value("expandedParentsCount").toInt(&hasExpandedParentsCount);
+
+        itemData->values.clear();
+
+        if (isExpanded) {
+            itemData->values.insert(sharedValue("isExpanded"), true);
+            if (hasExpandedParentsCount) {
+                itemData->values.insert(sharedValue("expandedParentsCount"), expandedParentsCount);
+            }
+        }
+    }
+}
+
+KFileItemList KFileItemModel::evictPreviewPixmaps(int firstVisibleIndex, int lastVisibleIndex, int itemBudget)
+{
+    KFileItemList evictedItems;
+    if (count() <= itemBudget) {
+        return evictedItems;
+    }
+
+    cancelBackgroundResort();
+
+    // Same margin policy as evictRoleValues(): scrolling within the
+    // neighbourhood of the visible range must not discard anything.
+    const int margin = qMax(itemBudget / 4, lastVisibleIndex - firstVisibleIndex + 1);
+    const int keepFirst = qMax(0, firstVisibleIndex - margin);
+    const int keepLast = qMin(count() - 1, lastVisibleIndex + margin);
+
+    for (int i = 0; i < count(); ++i) {
+        if (i == keepFirst && keepLast >= keepFirst) {
+            // An empty keep range can occur for an item budget of 0 before
+            // the view has reported a visible range; evict everything then.
+            i = keepLast;
+            continue;
+        }
+
+        ItemData *itemData = m_itemData.at(i);
+        const bool hasPreview = !itemData->values.value("iconPixmap").value<QPixmap>().isNull();
+        const bool hasHoverSequence = !itemData->values.value("hoverSequencePixmaps").value<QVector<QPixmap>>().isEmpty();
+        if (!hasPreview && !hasHoverSequence) {
+            continue;
+        }
+
+        // Null placeholders instead of removed keys, like the sweep which
+        // clears the previews when they get disabled, so that the columnar
+        // storage keeps its layout and only the pixel data is released.
+        if (hasPreview) {
+            itemData->values.insert(sharedValue("iconPixmap"), QPixmap());
+        }
+        if (hasHoverSequence) {
+            itemData->values.insert(sharedValue("hoverSequencePixmaps"), QVariant::fromValue(QVector<QPixmap>()));
+        }
+        evictedItems.append(itemData->item);
+    }
+
+    return evictedItems;
+}
+
 bool KFileItemModel::setExpanded(int index, bool expanded)
 {
     if (!isExpandable(index) || isExpanded(index) == expanded) {
@@ -664,6 +1446,7 @@ bool KFileItemModel::setExpanded(int index, bool expanded)
     const QUrl targetUrl = item.targetUrl();
     if (expanded) {
         m_expandedDirs.insert(targetUrl, url);
+        m_recentlyCollapsedDirs.removeOne(url); // The directory is actively held again.
         m_dirLister->openUrl(url, KDirLister::Keep);
 
         const QVariantList previouslyExpandedChildren = m_itemData.at(index)->values.value("previouslyExpandedChildren").value<QVariantList>();
@@ -684,8 +1467,7 @@ bool KFileItemModel::setExpanded(int index, bool expanded)
         }
 
         m_expandedDirs.remove(targetUrl);
-        m_dirLister->stop(url);
-        m_dirLister->forgetDirs(url);
+        retireExpandedDir(url);
 
         const int parentLevel = expandedParentsCount(index);
         const int itemCount = m_itemData.count();
@@ -700,8 +1482,7 @@ bool KFileItemModel::setExpanded(int index, bool expanded)
                 const QUrl targetUrl = itemData->item.targetUrl();
                 const QUrl url = itemData->item.url();
                 m_expandedDirs.remove(targetUrl);
-                m_dirLister->stop(url); // TODO: try to unit-test this, see https://bugs.kde.org/show_bug.cgi?id=332102#c11
-                m_dirLister->forgetDirs(url);
+                retireExpandedDir(url); // TODO: try to unit-test this, see https://bugs.kde.org/show_bug.cgi?id=332102#c11
                 expandedChildren.append(targetUrl);
             }
             ++childIndex;
@@ -717,6 +1498,23 @@ bool KFileItemModel::setExpanded(int index, bool expanded)
     return true;
 }
 
+void KFileItemModel::retireExpandedDir(const QUrl &url)
+{
+    m_dirLister->stop(url);
+
+    // Don't forget the directory right away: While it stays attached to the
+    // dir lister its listing remains in the lister cache and is kept up to
+    // date by the directory watcher, so re-expanding it shortly afterwards is
+    // served from the cache instead of re-listing the directory. Only the
+    // directories that fall out of the recently-collapsed list are really
+    // forgotten.
+    m_recentlyCollapsedDirs.removeOne(url);
+    m_recentlyCollapsedDirs.append(url);
+    while (m_recentlyCollapsedDirs.count() > MaxRetainedCollapsedDirs) {
+        m_dirLister->forgetDirs(m_recentlyCollapsedDirs.takeFirst());
+    }
+}
+
 bool KFileItemModel::isExpanded(int index) const
 {
     if (index >= 0 && index < count()) {
@@ -738,11 +1536,56 @@ bool KFileItemModel::isExpandable(int index) const
 int KFileItemModel::expandedParentsCount(int index) const
 {
     if (index >= 0 && index < count()) {
-        return expandedParentsCount(m_itemData.at(index));
+        if (!m_treeStructureValid) {
+            buildTreeStructureCache();
+        }
+        return m_treeStructure.at(index).depth;
     }
     return 0;
 }
 
+void KFileItemModel::buildTreeStructureCache() const
+{
+    m_treeStructure.clear();
+    m_treeStructure.reserve(m_itemData.count());
+
+    // The ancestor chain of the current item. The items of the chain cannot
+    // get a complete entry yet because their subtree spans are only known
+    // once an item outside of their subtree (or the end of the list) is
+    // reached.
+    struct AncestorEntry {
+        const ItemData *itemData;
+        int index;
+    };
+    QList<AncestorEntry> ancestors;
+
+    for (int i = 0; i < m_itemData.count(); ++i) {
+        const ItemData *itemData = m_itemData.at(i);
+        while (!ancestors.isEmpty() && ancestors.last().itemData != itemData->parent) {
+            const AncestorEntry &entry = ancestors.last();
+            m_treeStructure[entry.index].subtreeSpan = i - entry.index - 1;
+            ancestors.removeLast();
+        }
+        const int parentIndex = ancestors.isEmpty() ? -1 : ancestors.last().index;
+        m_treeStructure.append(TreeStructureEntry{static_cast<int>(ancestors.count()), parentIndex, 0});
+        ancestors.append({itemData, i});
+    }
+
+    while (!ancestors.isEmpty()) {
+        const AncestorEntry &entry = ancestors.last();
+        m_treeStructure[entry.index].subtreeSpan = m_itemData.count() - entry.index - 1;
+        ancestors.removeLast();
+    }
+
+    m_treeStructureValid = true;
+}
+
+void KFileItemModel::invalidateTreeStructureCache()
+{
+    m_treeStructureValid = false;
+    m_treeStructure.clear();
+}
+
 QSet<QUrl> KFileItemModel::expandedDirectories() const
 {
     QSet<QUrl> result;
@@ -783,12 +1626,17 @@ void KFileItemModel::expandParentDirectories(const QUrl &url)
     // KDirLister::open() must called at least once to trigger an initial
     // loading. The pending URLs that must be restored are handled
     // in slotCompleted().
-    QSetIterator<QUrl> it2(m_urlsToExpand);
-    while (it2.hasNext()) {
-        const int idx = index(it2.next());
+    // Like in slotCompleted(), every URL that is visible in the model already
+    // is expanded right away. This matters when the subtree is still in the
+    // lister cache because it was expanded before: the whole known part of the
+    // ancestor chain opens in one go instead of one level per listing
+    // round-trip.
+    // Iterate over a const copy because setExpanded() can insert into m_urlsToExpand.
+    const auto urlsToExpand = m_urlsToExpand;
+    for (const QUrl &pendingUrl : urlsToExpand) {
+        const int idx = index(pendingUrl);
         if (idx >= 0 && !isExpanded(idx)) {
             setExpanded(idx, true);
-            break;
         }
     }
 }
@@ -797,8 +1645,9 @@ void KFileItemModel::setNameFilter(const QString &nameFilter)
 {
     if (m_filter.pattern() != nameFilter) {
         dispatchPendingItemsToInsert();
+        const FilterUpdate update = filterUpdateForPatternChange(m_filter.pattern(), nameFilter);
         m_filter.setPattern(nameFilter);
-        applyFilters();
+        applyFilters(update);
     }
 }
 
@@ -835,7 +1684,32 @@ QStringList KFileItemModel::excludeMimeTypeFilter() const
     return m_filter.excludeMimeTypes();
 }
 
-void KFileItemModel::applyFilters()
+KFileItemModel::FilterUpdate KFileItemModel::filterUpdateForPatternChange(const QString &oldPattern, const QString &newPattern)
+{
+    auto hasWildcards = [](const QString &pattern) {
+        return pattern.contains(QLatin1Char('*')) || pattern.contains(QLatin1Char('?')) || pattern.contains(QLatin1Char('['));
+    };
+
+    if (hasWildcards(oldPattern) || hasWildcards(newPattern)) {
+        // Wildcard patterns cannot be related to each other cheaply.
+        return FullFilterUpdate;
+    }
+
+    // Wildcard-free patterns are substring matches: a pattern matches a
+    // subset of another pattern's matches iff it contains the other pattern.
+    // An empty pattern matches everything.
+    const QString oldLower = oldPattern.toLower();
+    const QString newLower = newPattern.toLower();
+    if (newLower.contains(oldLower)) {
+        return RestrictiveFilterUpdate;
+    }
+    if (oldLower.contains(newLower)) {
+        return RelaxingFilterUpdate;
+    }
+    return FullFilterUpdate;
+}
+
+void KFileItemModel::applyFilters(FilterUpdate update)
 {
     // ===STEP 1===
     // Check which previously shown items from m_itemData must now get
@@ -847,11 +1721,26 @@ void KFileItemModel::applyFilters()
     // view of the current "itemData" in the upcoming "for" loop.
     ItemData *itemShownBelow = nullptr;
 
+    // Pre-evaluate the filter for all items in parallel. KFileItemModelFilter::matches()
+    // only reads the filter and touches the passed item, and all items are distinct
+    // instances, so the evaluations are independent. This includes mime type sniffing
+    // when a mime type filter is set, which dominates the pass on large directories.
+    QList<bool> visibleItemMatches;
+    if (update != RelaxingFilterUpdate && m_itemData.count() >= ParallelFilterThreshold) {
+        visibleItemMatches = QtConcurrent::blockingMapped(m_itemData, [this](const ItemData *itemData) {
+            return m_filter.matches(itemData->item, itemData->isHidden, itemData->isWhitelistedHidden);
+        });
+    }
+
+    // A relaxing update cannot hide any currently visible item, so the whole
+    // sweep over m_itemData can be skipped then.
     // We will iterate backwards because it's convenient to know beforehand if the item just below is its child or not.
-    for (int index = m_itemData.count() - 1; index >= 0; --index) {
+    for (int index = update == RelaxingFilterUpdate ? -1 : m_itemData.count() - 1; index >= 0; --index) {
         ItemData *itemData = m_itemData.at(index);
 
-        if (m_filter.matches(itemData->item) || (itemShownBelow && itemShownBelow->parent == itemData)) {
+        const bool matches =
+            visibleItemMatches.isEmpty() ? m_filter.matches(itemData->item, itemData->isHidden, itemData->isWhitelistedHidden) : visibleItemMatches.at(index);
+        if (matches || (itemShownBelow && itemShownBelow->parent == itemData)) {
             // We could've entered here for two reasons:
             // 1. This item passes the filter itself
             // 2. This is an expanded folder that doesn't pass the filter but sees a filter-passing child just below
@@ -879,9 +1768,27 @@ void KFileItemModel::applyFilters()
 
     QHash<KFileItem, ItemData *> ancestorsOfNewVisibleItems; // We will make sure these also become visible in step 3.
 
-    QHash<KFileItem, ItemData *>::iterator it = m_filteredItems.begin();
+    // Pre-evaluate the filter for the hidden items in parallel as well; relaxing a
+    // restrictive filter on a huge directory makes this the dominant sweep.
+    QHash<KFileItem, bool> filteredItemMatches;
+    if (update != RestrictiveFilterUpdate && m_filteredItems.count() >= ParallelFilterThreshold) {
+        const QList<ItemData *> filteredValues = m_filteredItems.values();
+        const QList<bool> matchResults = QtConcurrent::blockingMapped(filteredValues, [this](const ItemData *itemData) {
+            return m_filter.matches(itemData->item, itemData->isHidden, itemData->isWhitelistedHidden);
+        });
+        filteredItemMatches.reserve(filteredValues.count());
+        for (int i = 0; i < filteredValues.count(); ++i) {
+            filteredItemMatches.insert(filteredValues.at(i)->item, matchResults.at(i));
+        }
+    }
+
+    // A restrictive update cannot make any hidden item visible, so the sweep
+    // over m_filteredItems can be skipped then.
+    QHash<KFileItem, ItemData *>::iterator it = update == RestrictiveFilterUpdate ? m_filteredItems.end() : m_filteredItems.begin();
     while (it != m_filteredItems.end()) {
-        if (m_filter.matches(it.key())) {
+        const bool matches = filteredItemMatches.isEmpty() ? m_filter.matches(it.key(), it.value()->isHidden, it.value()->isWhitelistedHidden)
+                                                          : filteredItemMatches.value(it.key());
+        if (matches) {
             newVisibleItems.append(it.value());
 
             // If this is a child of an expanded folder, we must make sure that its whole parental chain will also be shown.
@@ -935,7 +1842,7 @@ void KFileItemModel::removeFilteredChildren(const KItemRangeList &itemRanges)
     QHash<KFileItem, ItemData *>::iterator it = m_filteredItems.begin();
     while (it != m_filteredItems.end()) {
         if (parents.contains(it.value()->parent)) {
-            delete it.value();
+            m_itemArena.destroy(it.value());
             it = m_filteredItems.erase(it);
         } else {
             ++it;
@@ -986,6 +1893,7 @@ void KFileItemModel::onGroupedSortingChanged(bool current)
 void KFileItemModel::onSortRoleChanged(const QByteArray &current, const QByteArray &previous, bool resortItems)
 {
     Q_UNUSED(previous)
+    cancelBackgroundResort();
     m_sortRole = typeForRole(current);
 
     if (!m_requestRole[m_sortRole]) {
@@ -1008,6 +1916,15 @@ void KFileItemModel::onSortOrderChanged(Qt::SortOrder current, Qt::SortOrder pre
 
 void KFileItemModel::loadSortingSettings()
 {
+    // A background resort worker shares the collator state and the collation
+    // key cache, which must not be reconfigured under its feet. Unlike the
+    // other mutating paths this one has to wait for the worker; sorting
+    // settings change rarely, so the wait does not hurt interactive use.
+    cancelBackgroundResort();
+    if (m_backgroundResortWatcher && m_backgroundResortWatcher->isRunning()) {
+        m_backgroundResortWatcher->waitForFinished();
+    }
+
     using Choice = GeneralSettings::EnumSortingChoice;
     switch (GeneralSettings::sortingChoice()) {
     case Choice::NaturalSorting:
@@ -1025,27 +1942,269 @@ void KFileItemModel::loadSortingSettings()
     default:
         Q_UNREACHABLE();
     }
-    // Workaround for bug https://bugreports.qt.io/browse/QTBUG-69361
-    // Force the clean state of QCollator in single thread to avoid thread safety problems in sort
-    m_collator.compare(QString(), QString());
+    // Workaround for bug https://bugreports.qt.io/browse/QTBUG-69361
+    // Force the clean state of QCollator in single thread to avoid thread safety problems in sort
+    m_collator.compare(QString(), QString());
+
+    // Keys created with the previous collator settings are not comparable anymore.
+    m_collationKeyCache.clear();
+}
+
+void KFileItemModel::resortAllItems()
+{
+    m_resortAllItemsTimer->stop();
+    m_resortPendingWhileSorting = false;
+
+    const int itemCount = count();
+    if (itemCount <= 0) {
+        return;
+    }
+
+    DOLPHIN_PIPELINE_TRACE_SPAN("KFileItemModel::resortAllItems", itemCount);
+
+#ifdef KFILEITEMMODEL_DEBUG
+    QElapsedTimer timer;
+    timer.start();
+    qCDebug(DolphinDebug) << "===========================================================";
+    qCDebug(DolphinDebug) << "Resorting" << itemCount << "items";
+#endif
+
+    if (itemCount >= BackgroundResortThreshold && !m_requestRole[ExpandedParentsCountRole]) {
+        // The order of an expanded tree depends on the parent chains, which
+        // the flat snapshot below cannot express; trees keep the synchronous
+        // path.
+
+        if (m_backgroundResortWatcher->isRunning()) {
+            // A stale order is already being computed. Discard it when it
+            // arrives; slotBackgroundResortFinished() schedules a fresh
+            // resort then.
+            m_backgroundResortInvalidated = true;
+            return;
+        }
+
+        // Compute the new order on a worker thread and swap it in from
+        // slotBackgroundResortFinished(). The worker must not touch the
+        // model: while it sorts, the GUI thread keeps painting and
+        // scrolling, and data() lazily materializes role values into the
+        // shared column store at any time. So everything the comparator
+        // reads is snapshotted here, and the worker sorts plain keys.
+        // Mutating code paths merely mark an in-flight computation as stale
+        // through cancelBackgroundResort() without having to wait for it.
+        struct BackgroundResortEntry {
+            ItemData *itemData; // Opaque handle for the result; the worker never dereferences it.
+            quint8 group; // Hidden-last and directories-first bucket
+            qlonglong number = 0; // Raw value of numeric sort roles
+            qlonglong number2 = 0; // Height for the "dimensions" role
+            QString string; // Value of string sort roles
+            QString text; // Tie-breakers, matching the fallbacks of sortRoleCompare()
+            QString name;
+            QString url;
+        };
+
+        const bool countDirectoryContents =
+            ContentDisplaySettings::directorySizeMode() == ContentDisplaySettings::EnumDirectorySizeMode::ContentCount && m_sortRole == SizeRole;
+        const bool dirsFirst = m_sortDirsFirst || countDirectoryContents;
+        const QByteArray role = roleForType(m_sortRole);
+
+        QList<BackgroundResortEntry> entries;
+        entries.reserve(itemCount);
+        for (ItemData *itemData : std::as_const(m_itemData)) {
+            const KFileItem &item = itemData->item;
+
+            BackgroundResortEntry entry;
+            entry.itemData = itemData;
+            entry.group = 0;
+            if (m_sortHiddenLast && itemData->isHidden) {
+                entry.group |= 2;
+            }
+            if (dirsFirst && !item.isDir()) {
+                entry.group |= 1;
+            }
+
+            switch (m_sortRole) {
+            case NameRole:
+                // Handled by the name fallback below, like in sortRoleCompare().
+                break;
+            case SizeRole:
+                if (item.isDir()) {
+                    if (countDirectoryContents) {
+                        // An unknown content count sorts before a known one,
+                        // matching sortRoleCompare().
+                        const QVariant count = itemData->values.value("count");
+                        entry.number = count.isNull() ? -1 : count.toLongLong();
+                    } else {
+                        entry.number = itemData->values.value("size").toLongLong();
+                    }
+                } else {
+                    entry.number = static_cast<qlonglong>(item.size());
+                }
+                break;
+            case ModificationTimeRole:
+                entry.number = item.entry().numberValue(KIO::UDSEntry::UDS_MODIFICATION_TIME, -1);
+                break;
+            case AccessTimeRole:
+                entry.number = item.entry().numberValue(KIO::UDSEntry::UDS_ACCESS_TIME, -1);
+                break;
+            case CreationTimeRole:
+                entry.number = item.entry().numberValue(KIO::UDSEntry::UDS_CREATION_TIME, -1);
+                break;
+            case DeletionTimeRole: {
+                const QDateTime deletionTime = itemData->values.value("deletiontime").toDateTime();
+                entry.number = deletionTime.isValid() ? deletionTime.toMSecsSinceEpoch() : std::numeric_limits<qlonglong>::min();
+                break;
+            }
+            case RatingRole:
+            case WidthRole:
+            case HeightRole:
+            case PublisherRole:
+            case PageCountRole:
+            case WordCountRole:
+            case LineCountRole:
+            case TrackRole:
+            case ReleaseYearRole:
+                entry.number = itemData->values.value(role).toInt();
+                break;
+            case DimensionsRole: {
+                const QSize dimensions = itemData->values.value(role).toSize();
+                entry.number = dimensions.width();
+                entry.number2 = dimensions.height();
+                break;
+            }
+            default:
+                entry.string = itemData->values.value(role).toString();
+                break;
+            }
+
+            entry.text = item.text();
+            entry.name = item.name();
+            entry.url = item.url().url();
+            entries.append(entry);
+        }
+
+        m_backgroundResortInvalidated = false;
+
+        // A merge sort of n items needs about n * log2(n) comparisons; the
+        // sorting threads count the ones they perform so that the progress of
+        // the sort itself can be estimated, see sampleSortProgress().
+        qint64 log2ItemCount = 0;
+        while ((qint64(1) << log2ItemCount) < itemCount) {
+            ++log2ItemCount;
+        }
+        m_sortProgressComparisons.storeRelaxed(0);
+        m_sortProgressExpectedComparisons = qint64(itemCount) * qMax(log2ItemCount, qint64(1));
+        m_sortProgressSampleTimer->start();
+
+        // The captured collator keeps the settings of this moment even if
+        // m_collator is reconfigured later (which detaches m_collator and
+        // marks this computation as stale), so the comparator stays
+        // consistent for the whole sort.
+        const bool ascending = sortOrder() == Qt::AscendingOrder;
+        const bool naturalRoleValue = isRoleValueNatural(m_sortRole);
+        const QCollator collator = m_collator;
+        m_backgroundResortWatcher->setFuture(QtConcurrent::run([this, entries = std::move(entries), ascending, naturalRoleValue, collator]() mutable {
+            auto entryLessThan = [this, ascending, naturalRoleValue, &collator](const BackgroundResortEntry &a, const BackgroundResortEntry &b) {
+                m_sortProgressComparisons.fetchAndAddRelaxed(1);
+                if (a.group != b.group) {
+                    // The hidden-last and directories-first buckets are not
+                    // affected by the sort order, just like in lessThan().
+                    return a.group < b.group;
+                }
+                int result = 0;
+                if (a.number != b.number) {
+                    result = a.number < b.number ? -1 : +1;
+                } else if (a.number2 != b.number2) {
+                    result = a.number2 < b.number2 ? -1 : +1;
+                } else if (!a.string.isEmpty() && b.string.isEmpty()) {
+                    // Items with an empty value sort behind items with a
+                    // value, like in the default case of sortRoleCompare().
+                    result = -1;
+                } else if (a.string.isEmpty() && !b.string.isEmpty()) {
+                    result = +1;
+                } else if (a.string != b.string) {
+                    result = naturalRoleValue ? stringCompare(a.string, b.string, collator) : QString::compare(a.string, b.string);
+                }
+                if (result == 0) {
+                    result = stringCompare(a.text, b.text, collator);
+                }
+                if (result == 0) {
+                    result = stringCompare(a.name, b.name, collator);
+                }
+                if (result == 0) {
+                    result = QString::compare(a.url, b.url, Qt::CaseSensitive);
+                }
+                return ascending ? result < 0 : result > 0;
+            };
+            mergeSort(entries.begin(), entries.end(), entryLessThan);
+
+            QList<ItemData *> sortedItems;
+            sortedItems.reserve(entries.count());
+            for (const BackgroundResortEntry &entry : std::as_const(entries)) {
+                sortedItems.append(entry.itemData);
+            }
+            return sortedItems;
+        }));
+        return;
+    }
+
+    // An order that is still being computed in the background is superseded
+    // by this sort.
+    cancelBackgroundResort();
+
+    QList<ItemData *> sortedItems = m_itemData;
+    sort(sortedItems.begin(), sortedItems.end());
+    applyResortedItems(sortedItems);
+
+#ifdef KFILEITEMMODEL_DEBUG
+    qCDebug(DolphinDebug) << "[TIME] Resorting of" << itemCount << "items:" << timer.elapsed();
+#endif
+}
+
+void KFileItemModel::slotBackgroundResortFinished()
+{
+    m_sortProgressSampleTimer->stop();
+    m_sortProgressExpectedComparisons = 0;
+
+    if (m_backgroundResortInvalidated) {
+        // The model changed while the worker was sorting, the computed order
+        // is stale. Schedule a fresh resort; its progress reporting starts
+        // over from resortAllItems().
+        m_backgroundResortInvalidated = false;
+        if (count() > 0) {
+            scheduleResortAllItems();
+        }
+        return;
+    }
+
+    if (m_sortingProgressPercent >= 0) {
+        // Progress of this sort has been reported, so report its completion.
+        m_sortingProgressPercent = -1;
+        Q_EMIT directorySortingProgress(100);
+    }
+
+    applyResortedItems(m_backgroundResortWatcher->result());
 }
 
-void KFileItemModel::resortAllItems()
+void KFileItemModel::cancelBackgroundResort()
 {
-    m_resortAllItemsTimer->stop();
+    if (m_backgroundResortWatcher && m_backgroundResortWatcher->isRunning()) {
+        // The worker only reads the snapshot taken in resortAllItems(), so
+        // the caller may go on mutating the model right away. Just mark the
+        // computed order as stale; slotBackgroundResortFinished() discards
+        // it and schedules a fresh resort.
+        m_backgroundResortInvalidated = true;
+    }
+}
 
-    const int itemCount = count();
-    if (itemCount <= 0) {
+void KFileItemModel::applyResortedItems(const QList<ItemData *> &sortedItems)
+{
+    const int itemCount = m_itemData.count();
+    if (sortedItems.count() != itemCount) {
+        // Should not happen - all mutating paths invalidate a running
+        // background resort - but stay safe and sort again.
+        scheduleResortAllItems();
         return;
     }
 
-#ifdef KFILEITEMMODEL_DEBUG
-    QElapsedTimer timer;
-    timer.start();
-    qCDebug(DolphinDebug) << "===========================================================";
-    qCDebug(DolphinDebug) << "Resorting" << itemCount << "items";
-#endif
-
     // Remember the order of the current URLs so
     // that it can be determined which indexes have
     // been moved because of the resorting.
@@ -1055,14 +2214,14 @@ void KFileItemModel::resortAllItems()
         oldUrls.append(itemData->item.url());
     }
 
+    m_itemData = sortedItems;
+
     m_items.clear();
     m_items.reserve(itemCount);
-
-    // Resort the items
-    sort(m_itemData.begin(), m_itemData.end());
     for (int i = 0; i < itemCount; ++i) {
         m_items.insert(m_itemData.at(i)->item.url(), i);
     }
+    m_itemsCachedUpTo = itemCount;
 
     // Determine the first index that has been moved.
     int firstMovedIndex = 0;
@@ -1092,6 +2251,8 @@ void KFileItemModel::resortAllItems()
             movedToIndexes.append(newIndex);
         }
 
+        invalidateKeyboardSearchIndex();
+        invalidateTreeStructureCache();
         Q_EMIT itemsMoved(KItemRange(firstMovedIndex, movedItemsCount), movedToIndexes);
     } else if (groupedSorting()) {
         // The groups might have changed even if the order of the items has not.
@@ -1102,9 +2263,9 @@ void KFileItemModel::resortAllItems()
         }
     }
 
-#ifdef KFILEITEMMODEL_DEBUG
-    qCDebug(DolphinDebug) << "[TIME] Resorting of" << itemCount << "items:" << timer.elapsed();
-#endif
+    // Publish the new order so that other models showing the directory - the
+    // other half of a split view in particular - can replay it right away.
+    rememberDirectorySortOrder();
 }
 
 void KFileItemModel::slotCompleted()
@@ -1112,30 +2273,124 @@ void KFileItemModel::slotCompleted()
     m_maximumUpdateIntervalTimer->stop();
     dispatchPendingItemsToInsert();
 
+    if (m_adoptingLocalListing && m_dirLister->isFinished()) {
+        // The dir lister has taken the directory over from the fast local
+        // listing. Items that vanished between the two listings are not part
+        // of the lister's fresh cache and are dropped from the model now;
+        // everything that appeared in between was inserted by
+        // slotItemsAdded() already.
+        const KFileItemList listedItems = m_dirLister->itemsForDir(directory());
+        QSet<QUrl> listedUrls;
+        listedUrls.reserve(listedItems.count());
+        for (const KFileItem &item : listedItems) {
+            listedUrls.insert(item.url());
+        }
+
+        QList<int> indexesToRemove;
+        for (int i = 0; i < m_itemData.count(); ++i) {
+            const ItemData *itemData = m_itemData.at(i);
+            if (!itemData->parent && !listedUrls.contains(itemData->item.url())) {
+                indexesToRemove.append(i);
+            }
+        }
+        if (!indexesToRemove.isEmpty()) {
+            removeItems(KItemRangeList::fromSortedContainer(indexesToRemove), DeleteItemData);
+        }
+
+        QHash<KFileItem, ItemData *>::iterator it = m_filteredItems.begin();
+        while (it != m_filteredItems.end()) {
+            if (!it.value()->parent && !listedUrls.contains(it.key().url())) {
+                it = m_filteredItems.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        stopLocalListing();
+
+        if (m_urlsToExpand.isEmpty()) {
+            rememberDirectorySortOrder();
+            // Like the started signal, the completion of the takeover is not
+            // announced: the directory was reported as loaded when the fast
+            // listing finished.
+            return;
+        }
+    }
+
     if (!m_urlsToExpand.isEmpty()) {
-        // Try to find a URL that can be expanded.
+        // Expand every URL that is visible already. Triggering all listings of
+        // one tree level at once lets KDirLister process them concurrently
+        // instead of waiting for one round-trip per directory, which makes
+        // restoring many expanded folders much faster on slow (e.g. remote)
+        // file systems. URLs of deeper levels become visible once the listing
+        // of their parent has completed and are handled by the next
+        // slotCompleted() call.
         // Note that the parent folder must be expanded before any of its subfolders become visible.
-        // Therefore, some URLs in m_restoredExpandedUrls might not be visible yet
-        // -> we expand the first visible URL we find in m_restoredExpandedUrls.
         // Iterate over a const copy because items are deleted and inserted within the loop
+        bool expansionTriggered = false;
         const auto urlsToExpand = m_urlsToExpand;
         for (const QUrl &url : urlsToExpand) {
             const int indexForUrl = index(url);
             if (indexForUrl >= 0) {
                 m_urlsToExpand.remove(url);
                 if (setExpanded(indexForUrl, true)) {
-                    // The dir lister has been triggered. This slot will be called
-                    // again after the directory has been expanded.
-                    return;
+                    expansionTriggered = true;
                 }
             }
         }
 
-        // None of the URLs in m_restoredExpandedUrls could be found in the model. This can happen
+        if (expansionTriggered) {
+            // The dir lister has been triggered. This slot will be called
+            // again after each of the directories has been expanded.
+            return;
+        }
+
+        if (!m_dirLister->isFinished()) {
+            // Listings of other expanded directories are still running. The
+            // remaining URLs may become visible when they complete.
+            return;
+        }
+
+        // None of the URLs in m_urlsToExpand could be found in the model. This can happen
         // if these URLs have been deleted in the meantime.
         m_urlsToExpand.clear();
     }
 
+    // Remember the final order already now instead of waiting for the
+    // navigation away: if the other half of a split view (or another tab)
+    // opens the same directory, its listing is served from the KDirLister
+    // cache and its sorting is replayed from the shared LRU list.
+    rememberDirectorySortOrder();
+
+    if (!m_filenameSearchEngine) {
+        // Feed the shared path-completion index with the child directory names
+        // this listing has already paid for, so that the URL navigator can offer
+        // them synchronously without stat'ing the (possibly remote) mount again.
+        // Search result listings are skipped: their directories are scattered
+        // all over the search path and are no children of the shown URL.
+        QStringList childDirectoryNames;
+        for (const ItemData *itemData : std::as_const(m_itemData)) {
+            if (!itemData->parent && itemData->item.isDir()) {
+                childDirectoryNames.append(itemData->item.name());
+                if (childDirectoryNames.count() >= DolphinUrlCompletionIndex::MaxChildNamesPerDirectory) {
+                    break;
+                }
+            }
+        }
+        DolphinUrlCompletionIndex::instance().recordListedDirectory(directory(), childDirectoryNames);
+    }
+
+    if (m_directoryLoadStopWatch.isValid()) {
+        // Both the item count and the load duration normalized to 10k items
+        // end up in power-of-two buckets, so only the distributions are
+        // recorded, never a recognizable directory.
+        const qint64 elapsed = m_directoryLoadStopWatch.elapsed();
+        const qint64 itemCount = qMax(count(), 1);
+        KFileItemRolesTelemetry::instance()->recordSample(QByteArrayLiteral("directory.items"), itemCount);
+        KFileItemRolesTelemetry::instance()->recordSample(QByteArrayLiteral("directory.loadMsPer10kItems"), elapsed * 10000 / itemCount);
+        m_directoryLoadStopWatch.invalidate();
+    }
+
     Q_EMIT directoryLoadingCompleted();
 }
 
@@ -1151,6 +2406,22 @@ void KFileItemModel::slotItemsAdded(const QUrl &directoryUrl, const KFileItemLis
 {
     Q_ASSERT(!items.isEmpty());
 
+    DOLPHIN_PIPELINE_TRACE_SPAN("KFileItemModel::slotItemsAdded", items.count());
+
+    KFileItemList newItems = items;
+    if (m_adoptingLocalListing) {
+        // The takeover listing of the dir lister delivers the directory the
+        // fast local listing has already inserted; everything that is shown
+        // or held back by the filter is dropped here so that only items which
+        // appeared in between are added.
+        newItems.removeIf([this](const KFileItem &item) {
+            return index(item.url()) >= 0 || m_filteredItems.contains(item);
+        });
+        if (newItems.isEmpty()) {
+            return;
+        }
+    }
+
     const QUrl parentUrl = m_expandedDirs.value(directoryUrl, directoryUrl.adjusted(QUrl::StripTrailingSlash));
 
     if (m_requestRole[ExpandedParentsCountRole]) {
@@ -1159,7 +2430,7 @@ void KFileItemModel::slotItemsAdded(const QUrl &directoryUrl, const KFileItemLis
         // might result in emitting the same items twice due to the Keep-parameter.
         // This case happens if an item gets expanded, collapsed and expanded again
         // before the items could be loaded for the first expansion.
-        if (index(items.first().url()) >= 0) {
+        if (index(newItems.first().url()) >= 0) {
             // The items are already part of the model.
             return;
         }
@@ -1180,17 +2451,26 @@ void KFileItemModel::slotItemsAdded(const QUrl &directoryUrl, const KFileItemLis
         }
     }
 
-    const QList<ItemData *> itemDataList = createItemDataList(parentUrl, items);
+    QList<ItemData *> itemDataList = createItemDataList(parentUrl, newItems);
 
     if (!m_filter.hasSetFilters()) {
-        m_pendingItemsToInsert.append(itemDataList);
+        if (m_pendingItemsToInsert.isEmpty()) {
+            // The common case while a directory streams in: the pending queue
+            // was just dispatched, so the batch can be adopted as a whole
+            // instead of growing the queue and copying the pointers over.
+            m_pendingItemsToInsert = std::move(itemDataList);
+        } else {
+            m_pendingItemsToInsert.reserve(m_pendingItemsToInsert.count() + itemDataList.count());
+            m_pendingItemsToInsert.append(itemDataList);
+        }
     } else {
         QSet<ItemData *> parentsToEnsureVisible;
 
         // The name or type filter is active. Hide filtered items
         // before inserting them into the model and remember
         // the filtered items in m_filteredItems.
-        for (ItemData *itemData : itemDataList) {
+        m_pendingItemsToInsert.reserve(m_pendingItemsToInsert.count() + itemDataList.count());
+        for (ItemData *itemData : std::as_const(itemDataList)) {
             if (m_filter.matches(itemData->item)) {
                 m_pendingItemsToInsert.append(itemData);
                 if (itemData->parent) {
@@ -1277,7 +2557,7 @@ void KFileItemModel::slotItemsDeleted(const KFileItemList &items)
             // Probably the item has been filtered.
             QHash<KFileItem, ItemData *>::iterator it = m_filteredItems.find(item);
             if (it != m_filteredItems.end()) {
-                delete it.value();
+                m_itemArena.destroy(it.value());
                 m_filteredItems.erase(it);
             }
         }
@@ -1325,6 +2605,57 @@ void KFileItemModel::slotItemsDeleted(const KFileItemList &items)
     Q_EMIT fileItemsChanged(dirsChanged);
 }
 
+void KFileItemModel::scheduleRefreshItems(const QList<QPair<KFileItem, KFileItem>> &items)
+{
+    Q_ASSERT(!items.isEmpty());
+
+    m_pendingRefreshItems.reserve(m_pendingRefreshItems.count() + items.count());
+    for (const QPair<KFileItem, KFileItem> &itemPair : items) {
+        // The file is currently known under the URL of the old item: either
+        // because this is its first buffered notification, or because an
+        // earlier buffered pair already renamed it to that URL.
+        const auto it = m_pendingRefreshIndexes.constFind(itemPair.first.url());
+        if (it != m_pendingRefreshIndexes.constEnd()) {
+            // Merge with the buffered pair: keep the original old item so the
+            // model lookup still succeeds, only the final state matters.
+            QPair<KFileItem, KFileItem> &pending = m_pendingRefreshItems[it.value()];
+            const int pendingIndex = it.value();
+            pending.second = itemPair.second;
+            m_pendingRefreshIndexes.erase(it);
+            m_pendingRefreshIndexes.insert(itemPair.second.url(), pendingIndex);
+        } else {
+            m_pendingRefreshIndexes.insert(itemPair.second.url(), m_pendingRefreshItems.count());
+            m_pendingRefreshItems.append(itemPair);
+        }
+    }
+
+    if (!m_refreshCoalescingTimer->isActive()) {
+        m_refreshCoalescingTimer->start();
+    }
+}
+
+void KFileItemModel::dispatchPendingRefreshItems()
+{
+    if (m_pendingRefreshItems.isEmpty()) {
+        return;
+    }
+    const QList<QPair<KFileItem, KFileItem>> items = m_pendingRefreshItems;
+    m_pendingRefreshItems.clear();
+    m_pendingRefreshIndexes.clear();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    slotRefreshItems(items);
+
+    // Pace the next dispatch by the measured cost of this one: a lone touched
+    // file keeps the interval at the minimum, while a build system rewriting
+    // the directory pushes it up so that the resulting resorts and repaints
+    // happen at most once per interval.
+    m_refreshCoalescingTimer->setInterval(
+        static_cast<int>(qBound(qint64(MinRefreshCoalesceIntervalMs), timer.elapsed() * 4, qint64(MaxRefreshCoalesceIntervalMs))));
+}
+
 void KFileItemModel::slotRefreshItems(const QList<QPair<KFileItem, KFileItem>> &items)
 {
     Q_ASSERT(!items.isEmpty());
@@ -1332,6 +2663,8 @@ void KFileItemModel::slotRefreshItems(const QList<QPair<KFileItem, KFileItem>> &
     qCDebug(DolphinDebug) << "Refreshing" << items.count() << "items";
 #endif
 
+    cancelBackgroundResort();
+
     // Get the indexes of all items that have been refreshed
     QList<int> indexes;
     indexes.reserve(items.count());
@@ -1357,6 +2690,7 @@ void KFileItemModel::slotRefreshItems(const QList<QPair<KFileItem, KFileItem>> &
         const bool newItemMatchesFilter = m_filter.matches(newItem);
         if (indexForItem >= 0) {
             m_itemData[indexForItem]->item = newItem;
+            updateCachedHiddenState(m_itemData.at(indexForItem));
 
             // Keep old values as long as possible if they could not retrieved synchronously yet.
             // The update of the values will be done asynchronously by KFileItemModelRolesUpdater.
@@ -1392,6 +2726,7 @@ void KFileItemModel::slotRefreshItems(const QList<QPair<KFileItem, KFileItem>> &
             if (it != m_filteredItems.end()) {
                 ItemData *const itemData = it.value();
                 itemData->item = newItem;
+                updateCachedHiddenState(itemData);
 
                 // The data stored in 'values' might have changed. Therefore, we clear
                 // 'values' and re-populate it the next time it is requested via data(int).
@@ -1490,25 +2825,53 @@ void KFileItemModel::slotClear()
     qCDebug(DolphinDebug) << "Clearing all items";
 #endif
 
-    qDeleteAll(m_filteredItems);
+    cancelBackgroundResort();
+
     m_filteredItems.clear();
     m_groups.clear();
 
     m_maximumUpdateIntervalTimer->stop();
     m_resortAllItemsTimer->stop();
+    m_resortPendingWhileSorting = false;
+    // emitSortProgress() never runs its completion branch for an empty model,
+    // so reset the progress here to keep scheduleResortAllItems() working.
+    m_sortingProgressPercent = -1;
+
+    m_refreshCoalescingTimer->stop();
+    m_refreshCoalescingTimer->setInterval(MinRefreshCoalesceIntervalMs);
+    m_pendingRefreshItems.clear();
+    m_pendingRefreshIndexes.clear();
 
-    qDeleteAll(m_pendingItemsToInsert);
     m_pendingItemsToInsert.clear();
 
     const int removedCount = m_itemData.count();
     if (removedCount > 0) {
-        qDeleteAll(m_itemData);
         m_itemData.clear();
         m_items.clear();
+        m_itemsCachedUpTo = 0;
+        invalidateKeyboardSearchIndex();
+        invalidateTreeStructureCache();
         Q_EMIT itemsRemoved(KItemRangeList() << KItemRange(0, removedCount));
     }
 
+    // All ItemData instances live in the arena. Now that no list refers to
+    // them anymore the whole arena can be released in one sweep, which is much
+    // cheaper than deleting the items one by one.
+    m_itemArena.destroyAll();
+
+    // The collation keys mostly belong to the file names of the closed
+    // directory. Drop them to keep the cache from growing without bounds.
+    // A background resort worker may be using the cache right now, so take
+    // the mutex which serializes all access to it.
+    {
+        QMutexLocker collatorLock(s_collatorMutex());
+        m_collationKeyCache.clear();
+    }
+
     m_expandedDirs.clear();
+    // The dir lister has already dropped all directories it held, so the
+    // retained collapsed directories are gone as well.
+    m_recentlyCollapsedDirs.clear();
 }
 
 void KFileItemModel::slotSortingChoiceChanged()
@@ -1521,7 +2884,7 @@ void KFileItemModel::slotHiddenFilesWhitelistChanged()
 {
     // Update filter settings from GeneralSettings
     m_filter.setHiddenFilesWhitelistEnabled(GeneralSettings::hiddenFilesWhitelistEnabled());
-    m_filter.setHiddenFilesWhitelist(GeneralSettings::hiddenFilesWhitelist());
+    applyHiddenFilesWhitelist(GeneralSettings::hiddenFilesWhitelist());
 
     // Re-apply the current hidden files setting to trigger filtering refresh
     const bool showHidden = m_filter.hiddenFilesShown();
@@ -1532,7 +2895,12 @@ void KFileItemModel::slotHiddenFilesWhitelistChanged()
     const bool dirListerShowHidden = m_dirLister->showHiddenFiles();
     const bool newDirListerShowHidden = showHidden || needAllHiddenFiles;
 
-    if (dirListerShowHidden != newDirListerShowHidden) {
+    if (dirListerShowHidden != newDirListerShowHidden && m_localListingSubscription) {
+        // The fast local listing fetched according to the old setting, see
+        // setShowHiddenFiles().
+        m_dirLister->setShowHiddenFiles(newDirListerShowHidden);
+        loadDirectory(directory());
+    } else if (dirListerShowHidden != newDirListerShowHidden && !m_filenameSearchEngine) {
         // Need to reload directory to fetch/unfetch hidden files
         m_dirLister->setShowHiddenFiles(newDirListerShowHidden);
         const QUrl url = m_dirLister->url();
@@ -1547,10 +2915,75 @@ void KFileItemModel::slotHiddenFilesWhitelistChanged()
         }
     } else {
         // Just re-apply filter without reloading
+        m_dirLister->setShowHiddenFiles(newDirListerShowHidden);
         applyFilters();
     }
 }
 
+void KFileItemModel::applyHiddenFilesWhitelist(const QStringList &patterns)
+{
+    if (patterns == m_filter.hiddenFilesWhitelist()) {
+        // The usual case for hidden files toggles: the cached whitelist bits
+        // in the ItemData stay valid, so applyFilters() can sweep them.
+        return;
+    }
+    m_filter.setHiddenFilesWhitelist(patterns);
+
+    // The whitelist patterns changed, so the cached verdicts are stale. Only
+    // hidden items can match the whitelist, so the visible non-hidden majority
+    // is skipped without pattern matching.
+    for (ItemData *itemData : std::as_const(m_itemData)) {
+        if (itemData->isHidden) {
+            itemData->isWhitelistedHidden = m_filter.matchesHiddenWhitelist(itemData->item);
+        }
+    }
+    for (ItemData *itemData : std::as_const(m_filteredItems)) {
+        if (itemData->isHidden) {
+            itemData->isWhitelistedHidden = m_filter.matchesHiddenWhitelist(itemData->item);
+        }
+    }
+}
+
+void KFileItemModel::slotCutItemsChanged()
+{
+    const QList<QUrl> newCutUrls = KFileItemClipboard::instance()->cutItems();
+
+    // Both lists are sorted, so walking them in parallel yields the URLs
+    // whose cut state changed without any lookups: URLs that are only in
+    // m_cutUrls lost their cut state, URLs that are only in newCutUrls
+    // gained it, and URLs in both lists are skipped.
+    QList<int> changedIndexes;
+    const auto applyCutState = [this, &changedIndexes](const QUrl &url, bool isCut) {
+        const int itemIndex = index(url);
+        if (itemIndex >= 0) {
+            m_itemData.at(itemIndex)->values.insert(sharedValue("isCut"), isCut);
+            changedIndexes.append(itemIndex);
+        }
+    };
+
+    auto oldIt = m_cutUrls.constBegin();
+    auto newIt = newCutUrls.constBegin();
+    while (oldIt != m_cutUrls.constEnd() || newIt != newCutUrls.constEnd()) {
+        if (newIt == newCutUrls.constEnd() || (oldIt != m_cutUrls.constEnd() && *oldIt < *newIt)) {
+            applyCutState(*oldIt, false);
+            ++oldIt;
+        } else if (oldIt == m_cutUrls.constEnd() || *newIt < *oldIt) {
+            applyCutState(*newIt, true);
+            ++newIt;
+        } else {
+            ++oldIt;
+            ++newIt;
+        }
+    }
+
+    m_cutUrls = newCutUrls;
+
+    if (!changedIndexes.isEmpty()) {
+        std::sort(changedIndexes.begin(), changedIndexes.end());
+        Q_EMIT itemsChanged(KItemRangeList::fromSortedContainer(changedIndexes), {"isCut"});
+    }
+}
+
 void KFileItemModel::dispatchPendingItemsToInsert()
 {
     if (!m_pendingItemsToInsert.isEmpty()) {
@@ -1559,12 +2992,56 @@ void KFileItemModel::dispatchPendingItemsToInsert()
     }
 }
 
+void KFileItemModel::dispatchPendingItemsToInsertAdaptively()
+{
+    if (m_pendingItemsToInsert.isEmpty()) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (m_pendingItemsToInsert.count() <= m_adaptiveInsertBatchSize) {
+        insertItems(m_pendingItemsToInsert);
+        m_pendingItemsToInsert.clear();
+    } else {
+        QList<ItemData *> batch = m_pendingItemsToInsert.mid(0, m_adaptiveInsertBatchSize);
+        m_pendingItemsToInsert.erase(m_pendingItemsToInsert.begin(), m_pendingItemsToInsert.begin() + m_adaptiveInsertBatchSize);
+        insertItems(batch);
+    }
+
+    const qint64 elapsed = timer.elapsed();
+
+    // Scale the next batch so that a single insert stays close to the
+    // main-thread budget. On slow listings (e.g. sshfs) this keeps the view
+    // responsive instead of alternating between starvation and insert storms.
+    if (elapsed > 0) {
+        const qint64 scaledBatchSize = m_adaptiveInsertBatchSize * InsertBudgetMs / elapsed;
+        m_adaptiveInsertBatchSize = static_cast<int>(qBound(qint64(MinInsertBatchSize), scaledBatchSize, qint64(MaxInsertBatchSize)));
+    } else {
+        m_adaptiveInsertBatchSize = qMin(m_adaptiveInsertBatchSize * 2, MaxInsertBatchSize);
+    }
+
+    if (!m_pendingItemsToInsert.isEmpty()) {
+        // Keep draining the backlog, pacing the dispatches by the measured
+        // cost of the previous insert.
+        m_maximumUpdateIntervalTimer->start(static_cast<int>(qBound(qint64(50), elapsed * 4, qint64(2000))));
+    } else {
+        // Restore the regular maximum update interval for the next listing.
+        m_maximumUpdateIntervalTimer->setInterval(2000);
+    }
+}
+
 void KFileItemModel::insertItems(QList<ItemData *> &newItems)
 {
     if (newItems.isEmpty()) {
         return;
     }
 
+    DOLPHIN_PIPELINE_TRACE_SPAN("KFileItemModel::insertItems", newItems.count());
+
+    cancelBackgroundResort();
+
 #ifdef KFILEITEMMODEL_DEBUG
     QElapsedTimer timer;
     timer.start();
@@ -1572,25 +3049,28 @@ void KFileItemModel::insertItems(QList<ItemData *> &newItems)
     qCDebug(DolphinDebug) << "Inserting" << newItems.count() << "items";
 #endif
 
-    m_groups.clear();
     prepareItemsForSorting(newItems);
 
-    // Natural sorting of items can be very slow. However, it becomes much faster
-    // if the input sequence is already mostly sorted. Therefore, we first sort
-    // 'newItems' according to the QStrings using QString::operator<(), which is quite fast.
-    if (m_naturalSorting) {
-        if (m_sortRole == NameRole) {
-            parallelMergeSort(newItems.begin(), newItems.end(), nameLessThan, QThread::idealThreadCount());
-        } else if (isRoleValueNatural(m_sortRole)) {
-            auto lambdaLessThan = [&](const KFileItemModel::ItemData *a, const KFileItemModel::ItemData *b) {
-                const QByteArray role = roleForType(m_sortRole);
-                return a->values.value(role).toString() < b->values.value(role).toString();
-            };
-            parallelMergeSort(newItems.begin(), newItems.end(), lambdaLessThan, QThread::idealThreadCount());
+    // When a recently shown directory is entered again (e.g. by navigating back), its final
+    // sort order is known already and the expensive comparison-based sorting can be skipped.
+    if (!sortByRememberedOrder(newItems)) {
+        // Natural sorting of items can be very slow. However, it becomes much faster
+        // if the input sequence is already mostly sorted. Therefore, we first sort
+        // 'newItems' according to the QStrings using QString::operator<(), which is quite fast.
+        if (m_naturalSorting) {
+            if (m_sortRole == NameRole) {
+                parallelMergeSort(newItems.begin(), newItems.end(), nameLessThan, QThread::idealThreadCount());
+            } else if (isRoleValueNatural(m_sortRole)) {
+                auto lambdaLessThan = [&](const KFileItemModel::ItemData *a, const KFileItemModel::ItemData *b) {
+                    const QByteArray role = roleForType(m_sortRole);
+                    return a->values.value(role).toString() < b->values.value(role).toString();
+                };
+                parallelMergeSort(newItems.begin(), newItems.end(), lambdaLessThan, QThread::idealThreadCount());
+            }
         }
-    }
 
-    sort(newItems.begin(), newItems.end());
+        sort(newItems.begin(), newItems.end());
+    }
 
 #ifdef KFILEITEMMODEL_DEBUG
     qCDebug(DolphinDebug) << "[TIME] Sorting:" << timer.elapsed();
@@ -1607,6 +3087,24 @@ void KFileItemModel::insertItems(QList<ItemData *> &newItems)
         m_itemData = newItems;
         itemRanges << KItemRange(0, newItemCount);
     } else {
+        // Determine the insertion position of each new item in the existing
+        // sorted list with a binary search. The new items are sorted as well,
+        // so the search range can be shrunk while walking through them. This
+        // costs O(batch * log n) comparisons in total, which is much cheaper
+        // than comparing every existing item when a small batch is merged
+        // into a huge directory.
+        QVector<int> insertPositions;
+        insertPositions.reserve(newItemCount);
+        auto existingLessThanNew = [this](const ItemData *existing, const ItemData *newItem) {
+            return lessThan(existing, newItem, m_collator);
+        };
+        int searchFrom = 0;
+        for (const ItemData *newItem : std::as_const(newItems)) {
+            const auto it = std::lower_bound(m_itemData.constBegin() + searchFrom, m_itemData.constEnd(), newItem, existingLessThanNew);
+            searchFrom = static_cast<int>(it - m_itemData.constBegin());
+            insertPositions.append(searchFrom);
+        }
+
         m_itemData.reserve(totalItemCount);
         for (int i = existingItemCount; i < totalItemCount; ++i) {
             m_itemData.append(nullptr);
@@ -1621,8 +3119,7 @@ void KFileItemModel::insertItems(QList<ItemData *> &newItems)
         int rangeCount = 0;
 
         while (sourceIndexNewItems >= 0) {
-            ItemData *newItem = newItems.at(sourceIndexNewItems);
-            if (sourceIndexExistingItems >= 0 && lessThan(newItem, m_itemData.at(sourceIndexExistingItems), m_collator)) {
+            if (sourceIndexExistingItems >= insertPositions.at(sourceIndexNewItems)) {
                 // Move an existing item to its new position. If any new items
                 // are behind it, push the item range to itemRanges.
                 if (rangeCount > 0) {
@@ -1635,7 +3132,7 @@ void KFileItemModel::insertItems(QList<ItemData *> &newItems)
             } else {
                 // Insert a new item into the list.
                 ++rangeCount;
-                m_itemData[targetIndex] = newItem;
+                m_itemData[targetIndex] = newItems.at(sourceIndexNewItems);
                 --sourceIndexNewItems;
             }
             --targetIndex;
@@ -1650,10 +3147,37 @@ void KFileItemModel::insertItems(QList<ItemData *> &newItems)
         std::reverse(itemRanges.begin(), itemRanges.end());
     }
 
-    // The indexes in m_items are not correct anymore. Therefore, we clear m_items.
-    // It will be re-populated with the updated indices if index(const QUrl&) is called.
-    m_items.clear();
+    // Update the URL index incrementally: shift the index of each cached
+    // entry by the number of items that have been inserted before it. The new
+    // items themselves are added lazily by index(const QUrl&), so the valid
+    // prefix ends at the first insertion position.
+    if (!m_items.isEmpty()) {
+        std::vector<int> rangeIndexes;
+        std::vector<int> cumulatedCounts;
+        rangeIndexes.reserve(itemRanges.count());
+        cumulatedCounts.reserve(itemRanges.count());
+        int cumulatedCount = 0;
+        for (const KItemRange &range : std::as_const(itemRanges)) {
+            rangeIndexes.push_back(range.index);
+            cumulatedCount += range.count;
+            cumulatedCounts.push_back(cumulatedCount);
+        }
+
+        for (auto it = m_items.begin(); it != m_items.end(); ++it) {
+            const auto rangeIt = std::upper_bound(rangeIndexes.cbegin(), rangeIndexes.cend(), it.value());
+            if (rangeIt != rangeIndexes.cbegin()) {
+                it.value() += cumulatedCounts[(rangeIt - rangeIndexes.cbegin()) - 1];
+            }
+        }
+    }
+    m_itemsCachedUpTo = qMin(m_itemsCachedUpTo, itemRanges.first().index);
+
+    // Patch the cached group boundaries instead of recomputing all of them
+    // for every insert batch while a directory streams in.
+    updateGroupsForInsertedRanges(itemRanges);
 
+    invalidateKeyboardSearchIndex();
+    invalidateTreeStructureCache();
     Q_EMIT itemsInserted(itemRanges);
 
 #ifdef KFILEITEMMODEL_DEBUG
@@ -1667,7 +3191,11 @@ void KFileItemModel::removeItems(const KItemRangeList &itemRanges, RemoveItemsBe
         return;
     }
 
-    m_groups.clear();
+    DOLPHIN_PIPELINE_TRACE_SPAN("KFileItemModel::removeItems", std::accumulate(itemRanges.cbegin(), itemRanges.cend(), qint64(0), [](qint64 sum, const KItemRange &range) {
+                                    return sum + range.count;
+                                }));
+
+    cancelBackgroundResort();
 
     // Step 1: Remove the items from m_itemData, and free the ItemData.
     int removedItemsCount = 0;
@@ -1676,40 +3204,93 @@ void KFileItemModel::removeItems(const KItemRangeList &itemRanges, RemoveItemsBe
 
         for (int index = range.index; index < range.index + range.count; ++index) {
             if (behavior == DeleteItemData || (behavior == DeleteItemDataIfUnfiltered && !m_filteredItems.contains(m_itemData.at(index)->item))) {
-                delete m_itemData.at(index);
+                m_itemArena.destroy(m_itemData.at(index));
             }
 
             m_itemData[index] = nullptr;
         }
     }
 
-    // Step 2: Remove the ItemData pointers from the list m_itemData.
-    int target = itemRanges.at(0).index;
-    int source = itemRanges.at(0).index + itemRanges.at(0).count;
-    int nextRange = 1;
-
+    // Step 2: Remove the ItemData pointers from the list m_itemData by moving
+    // each surviving block as a whole. The pointers are trivially copyable,
+    // so memmove() shifts a block in one go instead of one assignment per
+    // item.
     const int oldItemDataCount = m_itemData.count();
-    while (source < oldItemDataCount) {
-        m_itemData[target] = m_itemData[source];
-        ++target;
-        ++source;
-
-        if (nextRange < itemRanges.count() && source == itemRanges.at(nextRange).index) {
-            // Skip the items in the next removed range.
-            source += itemRanges.at(nextRange).count;
-            ++nextRange;
+    ItemData **itemData = m_itemData.data();
+    int target = itemRanges.at(0).index;
+    for (int i = 0; i < itemRanges.count(); ++i) {
+        const int blockStart = itemRanges.at(i).index + itemRanges.at(i).count;
+        const int blockEnd = i + 1 < itemRanges.count() ? itemRanges.at(i + 1).index : oldItemDataCount;
+        const int blockLength = blockEnd - blockStart;
+        if (blockLength > 0) {
+            std::memmove(itemData + target, itemData + blockStart, blockLength * sizeof(ItemData *));
+            target += blockLength;
         }
     }
 
     m_itemData.erase(m_itemData.end() - removedItemsCount, m_itemData.end());
 
-    // The indexes in m_items are not correct anymore. Therefore, we clear m_items.
-    // It will be re-populated with the updated indices if index(const QUrl&) is called.
-    m_items.clear();
+    // Update the URL index incrementally: drop the entries of the removed
+    // items and shift the index of each remaining entry by the number of
+    // items that have been removed before it.
+    if (!m_items.isEmpty()) {
+        std::vector<int> rangeIndexes;
+        std::vector<int> rangeEnds;
+        std::vector<int> cumulatedCounts;
+        rangeIndexes.reserve(itemRanges.count());
+        rangeEnds.reserve(itemRanges.count());
+        cumulatedCounts.reserve(itemRanges.count());
+        int cumulatedCount = 0;
+        for (const KItemRange &range : itemRanges) {
+            rangeIndexes.push_back(range.index);
+            rangeEnds.push_back(range.index + range.count);
+            cumulatedCount += range.count;
+            cumulatedCounts.push_back(cumulatedCount);
+        }
+
+        auto it = m_items.begin();
+        while (it != m_items.end()) {
+            const auto rangeIt = std::upper_bound(rangeIndexes.cbegin(), rangeIndexes.cend(), it.value());
+            if (rangeIt == rangeIndexes.cbegin()) {
+                // The entry lies before the first removed range.
+                ++it;
+                continue;
+            }
+            const int rangeNumber = static_cast<int>(rangeIt - rangeIndexes.cbegin()) - 1;
+            if (it.value() < rangeEnds[rangeNumber]) {
+                // The entry belongs to a removed item.
+                it = m_items.erase(it);
+            } else {
+                it.value() -= cumulatedCounts[rangeNumber];
+                ++it;
+            }
+        }
+
+        // Shrink the valid prefix by the number of items removed inside it.
+        int removedInsidePrefix = 0;
+        for (const KItemRange &range : itemRanges) {
+            if (range.index >= m_itemsCachedUpTo) {
+                break;
+            }
+            removedInsidePrefix += qMin(range.count, m_itemsCachedUpTo - range.index);
+        }
+        m_itemsCachedUpTo -= removedInsidePrefix;
+    }
+
+    // Patch the cached group boundaries instead of recomputing all of them.
+    updateGroupsForRemovedRanges(itemRanges);
 
+    invalidateKeyboardSearchIndex();
+    invalidateTreeStructureCache();
     Q_EMIT itemsRemoved(itemRanges);
 }
 
+void KFileItemModel::updateCachedHiddenState(ItemData *itemData) const
+{
+    itemData->isHidden = itemData->item.isHidden();
+    itemData->isWhitelistedHidden = itemData->isHidden && m_filter.matchesHiddenWhitelist(itemData->item);
+}
+
 QList<KFileItemModel::ItemData *> KFileItemModel::createItemDataList(const QUrl &parentUrl, const KFileItemList &items) const
 {
     if (m_sortRole == TypeRole) {
@@ -1727,15 +3308,29 @@ QList<KFileItemModel::ItemData *> KFileItemModel::createItemDataList(const QUrl
     itemDataList.reserve(items.count());
 
     for (const KFileItem &item : items) {
-        ItemData *itemData = new ItemData();
+        ItemData *itemData = m_itemArena.create();
         itemData->item = item;
+        itemData->values.attachToStore(&m_columnStore);
         itemData->parent = parentItem;
+        updateCachedHiddenState(itemData);
         itemDataList.append(itemData);
     }
 
     return itemDataList;
 }
 
+qint64 KFileItemModel::estimatedMemoryUsageBytes() const
+{
+    qint64 bytes = m_itemArena.allocatedBytes();
+    bytes += m_columnStore.estimatedMemoryUsageBytes();
+    bytes += static_cast<qint64>(m_itemData.capacity()) * sizeof(ItemData *);
+    bytes += static_cast<qint64>(m_pendingItemsToInsert.capacity()) * sizeof(ItemData *);
+    bytes += static_cast<qint64>(m_items.capacity()) * (sizeof(QUrl) + sizeof(int));
+    bytes += static_cast<qint64>(m_filteredItems.capacity()) * (sizeof(KFileItem) + sizeof(ItemData *));
+    bytes += static_cast<qint64>(m_groups.capacity()) * sizeof(QPair<int, QVariant>);
+    return bytes;
+}
+
 void KFileItemModel::prepareItemsForSorting(QList<ItemData *> &itemDataList)
 {
     switch (m_sortRole) {
@@ -1745,23 +3340,29 @@ void KFileItemModel::prepareItemsForSorting(QList<ItemData *> &itemDataList)
     case GroupRole:
     case DestinationRole:
     case PathRole:
-    case DeletionTimeRole:
-        // These roles can be determined with retrieveData, and they have to be stored
-        // in the QHash "values" for the sorting.
+    case DeletionTimeRole: {
+        // The sorting reads these roles from the stored "values", so they have
+        // to be materialized. Every item of the model flows through here, so
+        // only the sort role itself is computed; the other requested roles
+        // (e.g. the permission strings or the type with its MIME resolution)
+        // are retrieved on the first data() access of the item instead, which
+        // only happens for items that actually become visible.
+        const QByteArray role = roleForType(m_sortRole);
         for (ItemData *itemData : std::as_const(itemDataList)) {
-            if (itemData->values.isEmpty()) {
-                itemData->values = retrieveData(itemData->item, itemData->parent);
+            if (!itemData->values.contains(role)) {
+                itemData->values.insert(role, retrieveRoleValue(itemData->item, itemData->parent, m_sortRole));
             }
         }
         break;
+    }
 
     case TypeRole:
-        // At least store the data including the file type for items with known MIME type.
+        // At least store the file type for items with known MIME type.
         for (ItemData *itemData : std::as_const(itemDataList)) {
-            if (itemData->values.isEmpty()) {
+            if (!itemData->values.contains("type")) {
                 const KFileItem item = itemData->item;
                 if (item.isDir() || item.isMimeTypeKnown()) {
-                    itemData->values = retrieveData(itemData->item, itemData->parent);
+                    itemData->values.insert(sharedValue("type"), retrieveRoleValue(item, itemData->parent, TypeRole));
                 }
             }
         }
@@ -1815,7 +3416,7 @@ void KFileItemModel::removeExpandedItems()
 
     while (it != end) {
         if (it.value()->parent) {
-            delete it.value();
+            m_itemArena.destroy(it.value());
             it = m_filteredItems.erase(it);
         } else {
             ++it;
@@ -1825,6 +3426,16 @@ void KFileItemModel::removeExpandedItems()
 
 void KFileItemModel::emitItemsChangedAndTriggerResorting(const KItemRangeList &itemRanges, const QSet<QByteArray> &changedRoles)
 {
+    if (m_itemsChangedBatchDepth > 0) {
+        // Buffered and emitted as merged ranges by endItemsChangedBatch().
+        m_batchedItemsChangedRanges += itemRanges;
+        m_batchedItemsChangedRoles += changedRoles;
+        return;
+    }
+
+    if (changedRoles.contains("text")) {
+        invalidateKeyboardSearchIndex();
+    }
     Q_EMIT itemsChanged(itemRanges, changedRoles);
 
     // Trigger a resorting if necessary. Note that this can happen even if the sort
@@ -1870,7 +3481,12 @@ void KFileItemModel::emitItemsChangedAndTriggerResorting(const KItemRangeList &i
         // (possibly with a delayed timer to make sure that we don't
         // re-calculate the groups very often if items are updated one by
         // one), but starting m_resortAllItemsTimer is easier.
-        m_resortAllItemsTimer->start();
+        if (m_sortingProgressPercent >= 0) {
+            // Deferred like in scheduleResortAllItems().
+            m_resortPendingWhileSorting = true;
+        } else {
+            m_resortAllItemsTimer->start();
+        }
     }
 }
 
@@ -1943,6 +3559,13 @@ QHash<QByteArray, QVariant> KFileItemModel::retrieveData(const KFileItem &item,
     QHash<QByteArray, QVariant> data;
     data.insert(sharedValue("url"), item.url());
 
+    // The cut state is kept up to date by slotCutItemsChanged() afterwards,
+    // so the views never have to query the clipboard themselves.
+    const KFileItemClipboard *clipboard = KFileItemClipboard::instance();
+    if (clipboard->hasCutItems() && clipboard->isCut(item.url())) {
+        data.insert(sharedValue("isCut"), true);
+    }
+
     const bool isDir = item.isDir();
     if (m_requestRole[IsDirRole] && isDir) {
         data.insert(sharedValue("isDir"), true);
@@ -1961,8 +3584,7 @@ QHash<QByteArray, QVariant> KFileItemModel::retrieveData(const KFileItem &item,
     }
 
     if (m_requestRole[ExtensionRole] && !isDir) {
-        // TODO KF6 use KFileItem::suffix 464722
-        data.insert(sharedValue("extension"), QFileInfo(item.name()).suffix());
+        data.insert(sharedValue("extension"), retrieveRoleValue(item, parent, ExtensionRole));
     }
 
     if (m_requestRole[SizeRole] && !isDir) {
@@ -1977,43 +3599,114 @@ QHash<QByteArray, QVariant> KFileItemModel::retrieveData(const KFileItem &item,
         data.insert(sharedValue("modificationtime"), dateTime);
     }
 
-    if (m_requestRole[CreationTimeRole]) {
-        // Don't use KFileItem::timeString() or KFileItem::time() as this is too expensive when
-        // having several thousands of items. Instead read the raw number from UDSEntry directly
-        // and the formatting of the date-time will be done on-demand by the view when the date will be shown.
-        const long long dateTime = item.entry().numberValue(KIO::UDSEntry::UDS_CREATION_TIME, -1);
-        data.insert(sharedValue("creationtime"), dateTime);
+    if (m_requestRole[CreationTimeRole]) {
+        // Don't use KFileItem::timeString() or KFileItem::time() as this is too expensive when
+        // having several thousands of items. Instead read the raw number from UDSEntry directly
+        // and the formatting of the date-time will be done on-demand by the view when the date will be shown.
+        const long long dateTime = item.entry().numberValue(KIO::UDSEntry::UDS_CREATION_TIME, -1);
+        data.insert(sharedValue("creationtime"), dateTime);
+    }
+
+    if (m_requestRole[AccessTimeRole]) {
+        // Don't use KFileItem::timeString() or KFileItem::time() as this is too expensive when
+        // having several thousands of items. Instead read the raw number from UDSEntry directly
+        // and the formatting of the date-time will be done on-demand by the view when the date will be shown.
+        const long long dateTime = item.entry().numberValue(KIO::UDSEntry::UDS_ACCESS_TIME, -1);
+        data.insert(sharedValue("accesstime"), dateTime);
+    }
+
+    if (m_requestRole[PermissionsRole]) {
+        data.insert(sharedValue("permissions"), retrieveRoleValue(item, parent, PermissionsRole));
+    }
+
+    if (m_requestRole[OwnerRole]) {
+        data.insert(sharedValue("owner"), retrieveRoleValue(item, parent, OwnerRole));
+    }
+
+    if (m_requestRole[GroupRole]) {
+        data.insert(sharedValue("group"), retrieveRoleValue(item, parent, GroupRole));
+    }
+
+    if (m_requestRole[DestinationRole]) {
+        data.insert(sharedValue("destination"), retrieveRoleValue(item, parent, DestinationRole));
+    }
+
+    if (m_requestRole[PathRole]) {
+        data.insert(sharedValue("path"), retrieveRoleValue(item, parent, PathRole));
+    }
+
+    if (m_requestRole[DeletionTimeRole]) {
+        data.insert(sharedValue("deletiontime"), retrieveRoleValue(item, parent, DeletionTimeRole));
+    }
+
+    if (m_requestRole[IsExpandableRole] && isDir) {
+        data.insert(sharedValue("isExpandable"), true);
+    }
+
+    if (m_requestRole[ExpandedParentsCountRole]) {
+        if (parent) {
+            const int level = expandedParentsCount(parent) + 1;
+            data.insert(sharedValue("expandedParentsCount"), level);
+        }
+    }
+
+    if (item.isMimeTypeKnown()) {
+        QString iconName = item.iconName();
+        if (!QIcon::hasThemeIcon(iconName)) {
+            QMimeType mimeType = QMimeDatabase().mimeTypeForName(item.mimetype());
+            iconName = mimeType.genericIconName();
+        }
+
+        data.insert(sharedValue("iconName"), iconName);
+
+        if (m_requestRole[TypeRole]) {
+            data.insert(sharedValue("type"), retrieveRoleValue(item, parent, TypeRole));
+        }
+    } else if (m_requestRole[TypeRole] && isDir) {
+        data.insert(sharedValue("type"), retrieveRoleValue(item, parent, TypeRole));
+    }
+
+    if (m_requestRole[RatingRole] && item.isLocalFile()) {
+        KFileMetaData::UserMetaData md(item.localPath());
+        const int rating = md.rating();
+        if (rating > 0) {
+            data.insert(sharedValue("rating"), rating);
+        }
     }
 
-    if (m_requestRole[AccessTimeRole]) {
-        // Don't use KFileItem::timeString() or KFileItem::time() as this is too expensive when
-        // having several thousands of items. Instead read the raw number from UDSEntry directly
-        // and the formatting of the date-time will be done on-demand by the view when the date will be shown.
-        const long long dateTime = item.entry().numberValue(KIO::UDSEntry::UDS_ACCESS_TIME, -1);
-        data.insert(sharedValue("accesstime"), dateTime);
-    }
+    return data;
+}
 
-    if (m_requestRole[PermissionsRole]) {
-        data.insert(sharedValue("permissions"), QVariantList() << item.permissionsString() << item.permissions());
-    }
+QVariant KFileItemModel::retrieveRoleValue(const KFileItem &item, const ItemData *parent, RoleType role) const
+{
+    Q_UNUSED(parent)
 
-    if (m_requestRole[OwnerRole]) {
-        data.insert(sharedValue("owner"), item.user());
-    }
+    switch (role) {
+    case ExtensionRole:
+        if (item.isDir()) {
+            return QVariant();
+        }
+        // TODO KF6 use KFileItem::suffix 464722
+        return QFileInfo(item.name()).suffix();
 
-    if (m_requestRole[GroupRole]) {
-        data.insert(sharedValue("group"), item.group());
-    }
+    case PermissionsRole:
+        return QVariantList() << item.permissionsString() << item.permissions();
 
-    if (m_requestRole[DestinationRole]) {
+    case OwnerRole:
+        return item.user();
+
+    case GroupRole:
+        return item.group();
+
+    case DestinationRole: {
         QString destination = item.linkDest();
         if (destination.isEmpty()) {
             destination = QLatin1Char('-');
         }
-        data.insert(sharedValue("destination"), destination);
+        return destination;
     }
 
-    if (m_requestRole[PathRole]) {
+    case PathRole: {
         QString path;
         if (item.url().scheme() == QLatin1String("trash")) {
             path = item.entry().stringValue(KIO::UDSEntry::UDS_EXTRA);
@@ -2026,6 +3719,27 @@ QHash<QByteArray, QVariant> KFileItemModel::retrieveData(const KFileItem &item,
             }
 
             path = item.localPath();
+
+            if (m_filenameSearchEngine) {
+                // While the items come from a directory walk the paths are shown relative to the
+                // walked directory: "src/kitemviews" reads a lot quicker than the searched path
+                // repeated in front of every single item, and sorting or grouping by path then
+                // arranges the items by subfolder of that directory.
+                QString rootPath = m_filenameSearchEngine->rootPath();
+                if (!rootPath.endsWith(QLatin1Char('/'))) {
+                    rootPath.append(QLatin1Char('/'));
+                }
+                if (path.startsWith(rootPath)) {
+                    path.remove(0, rootPath.length());
+                    const int index = path.lastIndexOf(item.text());
+                    if (index <= 0) {
+                        // The item sits directly inside the walked directory.
+                        return QStringLiteral(".");
+                    }
+                    return path.mid(0, index - 1);
+                }
+            }
+
             if (path.startsWith(homePath)) {
                 path.replace(0, homePath.length(), QLatin1Char('~'));
             }
@@ -2033,54 +3747,33 @@ QHash<QByteArray, QVariant> KFileItemModel::retrieveData(const KFileItem &item,
 
         const int index = path.lastIndexOf(item.text());
         path = path.mid(0, index - 1);
-        data.insert(sharedValue("path"), path);
+        return path;
     }
 
-    if (m_requestRole[DeletionTimeRole]) {
+    case DeletionTimeRole: {
         QDateTime deletionTime;
         if (item.url().scheme() == QLatin1String("trash")) {
             deletionTime = QDateTime::fromString(item.entry().stringValue(KIO::UDSEntry::UDS_EXTRA + 1), Qt::ISODate);
         }
-        data.insert(sharedValue("deletiontime"), deletionTime);
+        return deletionTime;
     }
 
-    if (m_requestRole[IsExpandableRole] && isDir) {
-        data.insert(sharedValue("isExpandable"), true);
-    }
-
-    if (m_requestRole[ExpandedParentsCountRole]) {
-        if (parent) {
-            const int level = expandedParentsCount(parent) + 1;
-            data.insert(sharedValue("expandedParentsCount"), level);
-        }
-    }
-
-    if (item.isMimeTypeKnown()) {
-        QString iconName = item.iconName();
-        if (!QIcon::hasThemeIcon(iconName)) {
-            QMimeType mimeType = QMimeDatabase().mimeTypeForName(item.mimetype());
-            iconName = mimeType.genericIconName();
+    case TypeRole:
+        if (item.isMimeTypeKnown()) {
+            return item.mimeComment();
         }
-
-        data.insert(sharedValue("iconName"), iconName);
-
-        if (m_requestRole[TypeRole]) {
-            data.insert(sharedValue("type"), item.mimeComment());
+        if (item.isDir()) {
+            static const QString folderMimeType = item.mimeComment();
+            return folderMimeType;
         }
-    } else if (m_requestRole[TypeRole] && isDir) {
-        static const QString folderMimeType = item.mimeComment();
-        data.insert(sharedValue("type"), folderMimeType);
-    }
+        return QVariant();
 
-    if (m_requestRole[RatingRole] && item.isLocalFile()) {
-        KFileMetaData::UserMetaData md(item.localPath());
-        const int rating = md.rating();
-        if (rating > 0) {
-            data.insert(sharedValue("rating"), rating);
-        }
+    default:
+        // The remaining roles are either trivial to compute or resolved
+        // asynchronously by KFileItemModelRolesUpdater; nothing ever needs
+        // them individually.
+        return QVariant();
     }
-
-    return data;
 }
 
 bool KFileItemModel::lessThan(const ItemData *a, const ItemData *b, const QCollator &collator) const
@@ -2120,8 +3813,8 @@ bool KFileItemModel::lessThan(const ItemData *a, const ItemData *b, const QColla
 
     // Show hidden files and folders last
     if (m_sortHiddenLast) {
-        const bool isHiddenA = a->item.isHidden();
-        const bool isHiddenB = b->item.isHidden();
+        const bool isHiddenA = a->isHidden;
+        const bool isHiddenB = b->isHidden;
         if (isHiddenA && !isHiddenB) {
             return false;
         } else if (!isHiddenA && isHiddenB) {
@@ -2147,20 +3840,217 @@ bool KFileItemModel::lessThan(const ItemData *a, const ItemData *b, const QColla
 
 void KFileItemModel::sort(const QList<KFileItemModel::ItemData *>::iterator &begin, const QList<KFileItemModel::ItemData *>::iterator &end) const
 {
-    auto lambdaLessThan = [&](const KFileItemModel::ItemData *a, const KFileItemModel::ItemData *b) {
-        return lessThan(a, b, m_collator);
+#ifdef DOLPHIN_SORT_PROFILING
+    KSortProfilingStats stats;
+    KSortProfilingStats *const profilingStats = &stats;
+    QElapsedTimer wallTimer;
+    wallTimer.start();
+#else
+    KSortProfilingStats *const profilingStats = nullptr;
+#endif
+
+    if (!sortByPrecomputedKeys(begin, end, profilingStats)) {
+        auto lambdaLessThan = [&](const KFileItemModel::ItemData *a, const KFileItemModel::ItemData *b) {
+#ifdef DOLPHIN_SORT_PROFILING
+            stats.comparisons.fetchAndAddRelaxed(1);
+#endif
+            m_sortProgressComparisons.fetchAndAddRelaxed(1);
+            return lessThan(a, b, m_collator);
+        };
+
+        if (m_sortRole == NameRole || isRoleValueNatural(m_sortRole)) {
+            // Sorting by string can be expensive, in particular if natural sorting is
+            // enabled. Use all CPU cores to speed up the sorting process.
+            static const int numberOfThreads = QThread::idealThreadCount();
+            parallelMergeSort(begin, end, lambdaLessThan, numberOfThreads, 100, profilingStats);
+        } else {
+            // Sorting by other roles is quite fast. Use only one thread to prevent
+            // problems caused by non-reentrant comparison functions, see
+            // https://bugs.kde.org/show_bug.cgi?id=312679
+#ifdef DOLPHIN_SORT_PROFILING
+            QElapsedTimer busyTimer;
+            busyTimer.start();
+            mergeSort(begin, end, lambdaLessThan);
+            stats.busyNanoseconds.fetchAndAddRelaxed(busyTimer.nsecsElapsed());
+#else
+            mergeSort(begin, end, lambdaLessThan);
+#endif
+        }
+    }
+
+#ifdef DOLPHIN_SORT_PROFILING
+    // Publish the counters through the telemetry D-Bus interface
+    // (GetRolesUpdaterTelemetry). The ratio of sort.busyMs (summed over all
+    // sorting threads) to sort.wallMs is the achieved parallel speedup;
+    // sort.merges counts the cross-thread merge steps.
+    const qint64 wallMs = wallTimer.elapsed();
+    KFileItemRolesTelemetry *const telemetry = KFileItemRolesTelemetry::instance();
+    telemetry->incrementCounter(QByteArrayLiteral("sort.runs"));
+    telemetry->incrementCounter(QByteArrayLiteral("sort.items"), end - begin);
+    telemetry->incrementCounter(QByteArrayLiteral("sort.comparisons"), stats.comparisons.loadRelaxed());
+    telemetry->incrementCounter(QByteArrayLiteral("sort.merges"), stats.merges.loadRelaxed());
+    telemetry->incrementCounter(QByteArrayLiteral("sort.busyMs"), stats.busyNanoseconds.loadRelaxed() / 1000000);
+    telemetry->incrementCounter(QByteArrayLiteral("sort.wallMs"), wallMs);
+    telemetry->recordLatency(QByteArrayLiteral("sort"), wallMs);
+#endif
+}
+
+bool KFileItemModel::sortByPrecomputedKeys(const QList<KFileItemModel::ItemData *>::iterator &begin,
+                                           const QList<KFileItemModel::ItemData *>::iterator &end,
+                                           KSortProfilingStats *stats) const
+{
+    if (m_requestRole[ExpandedParentsCountRole]) {
+        // The order of a tree depends on the parent chains, which cannot be
+        // expressed as a flat per-item key.
+        return false;
+    }
+
+    const int span = static_cast<int>(end - begin);
+    if (span < 1000) {
+        // Extracting the keys does not pay off for small directories.
+        return false;
+    }
+
+    // Extract the comparison key of every item once, using all CPU cores.
+    // Each branch below instantiates keyedParallelMergeSort() with a concrete
+    // comparator, so the sort compares plain integers or strings instead of
+    // dispatching on the sort role and unboxing QVariants for each of the
+    // O(n * log n) comparisons.
+    struct NumberKey {
+        quint8 group; // Hidden-last and directories-first bucket
+        qlonglong number; // Raw value of the sort role
+    };
+    struct StringKey {
+        quint8 group;
+        QString string;
     };
 
-    if (m_sortRole == NameRole || isRoleValueNatural(m_sortRole)) {
-        // Sorting by string can be expensive, in particular if natural sorting is
-        // enabled. Use all CPU cores to speed up the sorting process.
-        static const int numberOfThreads = QThread::idealThreadCount();
-        parallelMergeSort(begin, end, lambdaLessThan, numberOfThreads);
-    } else {
-        // Sorting by other roles is quite fast. Use only one thread to prevent
-        // problems caused by non-reentrant comparison functions, see
-        // https://bugs.kde.org/show_bug.cgi?id=312679
-        mergeSort(begin, end, lambdaLessThan);
+    const bool countDirectoryContents =
+        ContentDisplaySettings::directorySizeMode() == ContentDisplaySettings::EnumDirectorySizeMode::ContentCount && m_sortRole == SizeRole;
+    const bool dirsFirst = m_sortDirsFirst || countDirectoryContents;
+
+    auto groupOf = [this, dirsFirst](const ItemData *itemData) -> quint8 {
+        quint8 group = 0;
+        if (m_sortHiddenLast && itemData->isHidden) {
+            group |= 2;
+        }
+        if (dirsFirst && !itemData->item.isDir()) {
+            group |= 1;
+        }
+        return group;
+    };
+
+    const bool ascending = sortOrder() == Qt::AscendingOrder;
+    auto numberKeyLessThan = [this, ascending](const NumberKey &a, const NumberKey &b, const ItemData *itemA, const ItemData *itemB) {
+        if (a.group != b.group) {
+            // The hidden-last and directories-first buckets are not affected
+            // by the sort order, just like in lessThan().
+            return a.group < b.group;
+        }
+        if (a.number != b.number) {
+            return ascending ? a.number < b.number : a.number > b.number;
+        }
+        // Equal keys: fall back to the full comparison which applies the
+        // name and URL tie-breakers.
+        return lessThan(itemA, itemB, m_collator);
+    };
+
+    static const int numberOfThreads = QThread::idealThreadCount();
+
+    switch (m_sortRole) {
+    case SizeRole:
+    case ModificationTimeRole:
+    case AccessTimeRole:
+    case CreationTimeRole: {
+        auto extractKey = [this, countDirectoryContents, groupOf](const ItemData *itemData) -> NumberKey {
+            const KFileItem &item = itemData->item;
+            qlonglong number = 0;
+            switch (m_sortRole) {
+            case SizeRole:
+                if (item.isDir()) {
+                    if (countDirectoryContents) {
+                        // An unknown content count sorts before a known one,
+                        // matching sortRoleCompare().
+                        const QVariant count = itemData->values.value("count");
+                        number = count.isNull() ? -1 : count.toLongLong();
+                    } else {
+                        number = itemData->values.value("size").toLongLong();
+                    }
+                } else {
+                    number = static_cast<qlonglong>(item.size());
+                }
+                break;
+            case ModificationTimeRole:
+                number = item.entry().numberValue(KIO::UDSEntry::UDS_MODIFICATION_TIME, -1);
+                break;
+            case AccessTimeRole:
+                number = item.entry().numberValue(KIO::UDSEntry::UDS_ACCESS_TIME, -1);
+                break;
+            case CreationTimeRole:
+                number = item.entry().numberValue(KIO::UDSEntry::UDS_CREATION_TIME, -1);
+                break;
+            default:
+                Q_UNREACHABLE();
+            }
+            return {groupOf(itemData), number};
+        };
+        keyedParallelMergeSort<NumberKey>(begin, end, extractKey, numberKeyLessThan, numberOfThreads, stats);
+        return true;
+    }
+
+    case RatingRole:
+    case WidthRole:
+    case HeightRole:
+    case PublisherRole:
+    case PageCountRole:
+    case WordCountRole:
+    case LineCountRole:
+    case TrackRole:
+    case ReleaseYearRole: {
+        const QByteArray role = roleForType(m_sortRole);
+        auto extractKey = [role, groupOf](const ItemData *itemData) -> NumberKey {
+            return {groupOf(itemData), itemData->values.value(role).toInt()};
+        };
+        keyedParallelMergeSort<NumberKey>(begin, end, extractKey, numberKeyLessThan, numberOfThreads, stats);
+        return true;
+    }
+
+    case NameRole:
+    case DeletionTimeRole:
+    case DimensionsRole:
+        // The name fallback is already fast due to the collation-key cache,
+        // and the remaining roles do not map to a flat integer key.
+        return false;
+
+    default: {
+        // String roles, handled like the default case of sortRoleCompare():
+        // items with an empty value sort behind items with a value.
+        const QByteArray role = roleForType(m_sortRole);
+        auto extractKey = [role, groupOf](const ItemData *itemData) -> StringKey {
+            return {groupOf(itemData), itemData->values.value(role).toString()};
+        };
+        const bool natural = isRoleValueNatural(m_sortRole);
+        auto stringKeyLessThan = [this, ascending, natural](const StringKey &a, const StringKey &b, const ItemData *itemA, const ItemData *itemB) {
+            m_sortProgressComparisons.fetchAndAddRelaxed(1);
+            if (a.group != b.group) {
+                return a.group < b.group;
+            }
+            int result = 0;
+            if (!a.string.isEmpty() && b.string.isEmpty()) {
+                result = -1;
+            } else if (a.string.isEmpty() && !b.string.isEmpty()) {
+                result = +1;
+            } else if (a.string != b.string) {
+                result = natural ? stringCompare(a.string, b.string, m_collator) : QString::compare(a.string, b.string);
+            }
+            if (result != 0) {
+                return ascending ? result < 0 : result > 0;
+            }
+            return lessThan(itemA, itemB, m_collator);
+        };
+        keyedParallelMergeSort<StringKey>(begin, end, extractKey, stringKeyLessThan, numberOfThreads, stats);
+        return true;
+    }
     }
 }
 
@@ -2333,6 +4223,17 @@ int KFileItemModel::sortRoleCompare(const ItemData *a, const ItemData *b, const
     return QString::compare(itemA.url().url(), itemB.url().url(), Qt::CaseSensitive);
 }
 
+const QCollatorSortKey &KFileItemModel::cachedCollationKey(const QString &text, const QCollator &collator) const
+{
+    // The caller must hold s_collatorMutex, which also serializes the
+    // access to m_collationKeyCache when sorting runs on multiple threads.
+    auto it = m_collationKeyCache.find(text);
+    if (it == m_collationKeyCache.end()) {
+        it = m_collationKeyCache.insert(text, collator.sortKey(text));
+    }
+    return it.value();
+}
+
 int KFileItemModel::stringCompare(const QString &a, const QString &b, const QCollator &collator) const
 {
     QMutexLocker collatorLock(s_collatorMutex());
@@ -2345,7 +4246,14 @@ int KFileItemModel::stringCompare(const QString &a, const QString &b, const QCol
         const QString aBaseName = a.section('.', 0, 0, flags);
         const QString bBaseName = b.section('.', 0, 0, flags);
 
-        const int res = collator.compare(aBaseName, bBaseName);
+        // Natural collation is expensive and each item is compared O(log n)
+        // times while sorting. Comparing cached collation keys instead of the
+        // strings means every distinct string is collated only once.
+        // The first key is copied out of the cache because looking up the
+        // second one may insert and rehash, which invalidates references to
+        // the stored keys.
+        const QCollatorSortKey aBaseNameKey = cachedCollationKey(aBaseName, collator);
+        const int res = aBaseNameKey.compare(cachedCollationKey(bBaseName, collator));
         if (res != 0 || (aBaseName.length() == a.length() && bBaseName.length() == b.length())) {
             return res;
         }
@@ -2355,7 +4263,8 @@ int KFileItemModel::stringCompare(const QString &a, const QString &b, const QCol
         Q_ASSERT(bBaseName.length() <= b.length() && bBaseName.length() >= 0);
 
         // baseNames were equal, sort by extension
-        return collator.compare(a.sliced(aBaseName.length()), b.sliced(bBaseName.length()));
+        const QCollatorSortKey aExtensionKey = cachedCollationKey(a.sliced(aBaseName.length()), collator);
+        return aExtensionKey.compare(cachedCollationKey(b.sliced(bBaseName.length()), collator));
     }
 
     const int result = QString::compare(a, b, collator.caseSensitivity());
@@ -2369,16 +4278,215 @@ int KFileItemModel::stringCompare(const QString &a, const QString &b, const QCol
     return QString::compare(a, b, Qt::CaseSensitive);
 }
 
-QList<QPair<int, QVariant>> KFileItemModel::nameRoleGroups() const
+QList<QPair<int, QVariant>> KFileItemModel::computeGroups(int firstIndex, int lastIndex) const
+{
+    switch (typeForRole(sortRole())) {
+    case NameRole:
+        return nameRoleGroups(firstIndex, lastIndex);
+    case SizeRole:
+        return sizeRoleGroups(firstIndex, lastIndex);
+    case ModificationTimeRole:
+        return timeRoleGroups(
+            [](const ItemData *item) {
+                return item->item.time(KFileItem::ModificationTime);
+            },
+            firstIndex,
+            lastIndex);
+    case CreationTimeRole:
+        return timeRoleGroups(
+            [](const ItemData *item) {
+                return item->item.time(KFileItem::CreationTime);
+            },
+            firstIndex,
+            lastIndex);
+    case AccessTimeRole:
+        return timeRoleGroups(
+            [](const ItemData *item) {
+                return item->item.time(KFileItem::AccessTime);
+            },
+            firstIndex,
+            lastIndex);
+    case DeletionTimeRole:
+        return timeRoleGroups(
+            [](const ItemData *item) {
+                return item->values.value("deletiontime").toDateTime();
+            },
+            firstIndex,
+            lastIndex);
+    case PermissionsRole:
+        return permissionRoleGroups(firstIndex, lastIndex);
+    case RatingRole:
+        return ratingRoleGroups(firstIndex, lastIndex);
+    default:
+        return genericStringRoleGroups(sortRole(), firstIndex, lastIndex);
+    }
+}
+
+void KFileItemModel::updateGroupsForInsertedRanges(const KItemRangeList &itemRanges)
+{
+    if (!groupedSorting() || m_groups.isEmpty()) {
+        // There is no cached group list that could be patched. It will be
+        // computed from scratch by the next groups() call.
+        m_groups.clear();
+        return;
+    }
+
+    // Step 1: Shift the cached group boundaries from pre-insert to
+    // post-insert coordinates. Both lists are sorted by index, so one merged
+    // walk is sufficient.
+    int rangeIndex = 0;
+    int cumulatedCount = 0;
+    for (QPair<int, QVariant> &group : m_groups) {
+        while (rangeIndex < itemRanges.count() && itemRanges.at(rangeIndex).index <= group.first) {
+            cumulatedCount += itemRanges.at(rangeIndex).count;
+            ++rangeIndex;
+        }
+        group.first += cumulatedCount;
+    }
+
+    // Step 2: Determine the affected spans in post-insert coordinates. Each
+    // span reaches from the start of the group that contains the first
+    // inserted item of a range to the first cached boundary behind the range:
+    // every item of the groups surrounding an insertion may gain or lose its
+    // boundary, while all boundaries outside the spans stay valid.
+    const auto groupLessThanIndex = [](const QPair<int, QVariant> &group, int index) {
+        return group.first < index;
+    };
+    std::vector<std::pair<int, int>> spans;
+    cumulatedCount = 0;
+    for (const KItemRange &range : itemRanges) {
+        const int firstInserted = range.index + cumulatedCount;
+        cumulatedCount += range.count;
+        const int lastInserted = range.index + cumulatedCount - 1;
+
+        const auto startIt = std::lower_bound(m_groups.constBegin(), m_groups.constEnd(), firstInserted, groupLessThanIndex);
+        const int spanStart = startIt == m_groups.constBegin() ? 0 : (startIt - 1)->first;
+
+        const auto endIt = std::lower_bound(m_groups.constBegin(), m_groups.constEnd(), lastInserted + 1, groupLessThanIndex);
+        const int spanEnd = endIt == m_groups.constEnd() ? count() - 1 : endIt->first;
+
+        if (!spans.empty() && spanStart <= spans.back().second) {
+            spans.back().second = qMax(spans.back().second, spanEnd);
+        } else {
+            spans.push_back({spanStart, spanEnd});
+        }
+    }
+
+    // Step 3: Splice the recomputed boundaries of each span into the list of
+    // cached boundaries.
+    spliceRecomputedGroupSpans(spans);
+}
+
+void KFileItemModel::updateGroupsForRemovedRanges(const KItemRangeList &itemRanges)
+{
+    if (!groupedSorting() || m_groups.isEmpty()) {
+        // There is no cached group list that could be patched. It will be
+        // computed from scratch by the next groups() call.
+        m_groups.clear();
+        return;
+    }
+
+    // Step 1: Drop the boundaries of removed items and shift the remaining
+    // cached boundaries from pre-remove to post-remove coordinates. Both
+    // lists are sorted by index, so one merged walk is sufficient.
+    QList<QPair<int, QVariant>> shiftedGroups;
+    shiftedGroups.reserve(m_groups.count());
+    int rangeIndex = 0;
+    int cumulatedCount = 0;
+    for (const QPair<int, QVariant> &group : std::as_const(m_groups)) {
+        while (rangeIndex < itemRanges.count() && itemRanges.at(rangeIndex).index + itemRanges.at(rangeIndex).count <= group.first) {
+            cumulatedCount += itemRanges.at(rangeIndex).count;
+            ++rangeIndex;
+        }
+        if (rangeIndex < itemRanges.count() && itemRanges.at(rangeIndex).index <= group.first) {
+            // The boundary item itself has been removed.
+            continue;
+        }
+        shiftedGroups.append(QPair<int, QVariant>(group.first - cumulatedCount, group.second));
+    }
+    m_groups = shiftedGroups;
+
+    if (m_groups.isEmpty() || m_itemData.isEmpty()) {
+        m_groups.clear();
+        return;
+    }
+
+    // Step 2: Determine the affected spans in post-remove coordinates. At
+    // each seam where a removed range used to be, the surrounding groups may
+    // merge or need a new boundary (e.g. if the group's first item has been
+    // removed), so the span reaches from the start of the group before the
+    // seam to the first surviving boundary behind it.
+    const auto groupLessThanIndex = [](const QPair<int, QVariant> &group, int index) {
+        return group.first < index;
+    };
+    std::vector<std::pair<int, int>> spans;
+    cumulatedCount = 0;
+    for (const KItemRange &range : itemRanges) {
+        const int seam = range.index - cumulatedCount;
+        cumulatedCount += range.count;
+        if (seam >= m_itemData.count()) {
+            // Items at the end of the list have been removed; there is no
+            // group behind the seam that could be affected.
+            break;
+        }
+
+        const auto startIt = std::lower_bound(m_groups.constBegin(), m_groups.constEnd(), seam, groupLessThanIndex);
+        const int spanStart = startIt == m_groups.constBegin() ? 0 : (startIt - 1)->first;
+
+        const auto endIt = std::lower_bound(m_groups.constBegin(), m_groups.constEnd(), seam + 1, groupLessThanIndex);
+        const int spanEnd = endIt == m_groups.constEnd() ? m_itemData.count() - 1 : endIt->first;
+
+        if (!spans.empty() && spanStart <= spans.back().second) {
+            spans.back().second = qMax(spans.back().second, spanEnd);
+        } else {
+            spans.push_back({spanStart, spanEnd});
+        }
+    }
+
+    // Step 3: Splice the recomputed boundaries of each span into the list of
+    // cached boundaries.
+    spliceRecomputedGroupSpans(spans);
+}
+
+void KFileItemModel::spliceRecomputedGroupSpans(const std::vector<std::pair<int, int>> &spans)
+{
+    QList<QPair<int, QVariant>> newGroups;
+    newGroups.reserve(m_groups.count());
+    int groupIt = 0;
+    for (const auto &span : spans) {
+        while (groupIt < m_groups.count() && m_groups.at(groupIt).first < span.first) {
+            newGroups.append(m_groups.at(groupIt));
+            ++groupIt;
+        }
+
+        const QList<QPair<int, QVariant>> recomputed = computeGroups(span.first, span.second);
+        for (const QPair<int, QVariant> &group : recomputed) {
+            if (newGroups.isEmpty() || newGroups.last().second != group.second) {
+                newGroups.append(group);
+            }
+        }
+
+        while (groupIt < m_groups.count() && m_groups.at(groupIt).first <= span.second) {
+            ++groupIt;
+        }
+    }
+    while (groupIt < m_groups.count()) {
+        newGroups.append(m_groups.at(groupIt));
+        ++groupIt;
+    }
+
+    m_groups = newGroups;
+}
+
+QList<QPair<int, QVariant>> KFileItemModel::nameRoleGroups(int firstIndex, int lastIndex) const
 {
     Q_ASSERT(!m_itemData.isEmpty());
 
-    const int maxIndex = count() - 1;
     QList<QPair<int, QVariant>> groups;
 
     QString groupValue;
     QChar firstChar;
-    for (int i = 0; i <= maxIndex; ++i) {
+    for (int i = firstIndex; i <= lastIndex; ++i) {
         if (isChildItem(i)) {
             continue;
         }
@@ -2442,15 +4550,14 @@ QList<QPair<int, QVariant>> KFileItemModel::nameRoleGroups() const
     return groups;
 }
 
-QList<QPair<int, QVariant>> KFileItemModel::sizeRoleGroups() const
+QList<QPair<int, QVariant>> KFileItemModel::sizeRoleGroups(int firstIndex, int lastIndex) const
 {
     Q_ASSERT(!m_itemData.isEmpty());
 
-    const int maxIndex = count() - 1;
     QList<QPair<int, QVariant>> groups;
 
     QString groupValue;
-    for (int i = 0; i <= maxIndex; ++i) {
+    for (int i = firstIndex; i <= lastIndex; ++i) {
         if (isChildItem(i)) {
             continue;
         }
@@ -2485,18 +4592,17 @@ QList<QPair<int, QVariant>> KFileItemModel::sizeRoleGroups() const
     return groups;
 }
 
-QList<QPair<int, QVariant>> KFileItemModel::timeRoleGroups(const std::function<QDateTime(const ItemData *)> &fileTimeCb) const
+QList<QPair<int, QVariant>> KFileItemModel::timeRoleGroups(const std::function<QDateTime(const ItemData *)> &fileTimeCb, int firstIndex, int lastIndex) const
 {
     Q_ASSERT(!m_itemData.isEmpty());
 
-    const int maxIndex = count() - 1;
     QList<QPair<int, QVariant>> groups;
 
     const QDate currentDate = QDate::currentDate();
 
     QDate previousFileDate;
     QString groupValue;
-    for (int i = 0; i <= maxIndex; ++i) {
+    for (int i = firstIndex; i <= lastIndex; ++i) {
         if (isChildItem(i)) {
             continue;
         }
@@ -2691,16 +4797,15 @@ QList<QPair<int, QVariant>> KFileItemModel::timeRoleGroups(const std::function<Q
     return groups;
 }
 
-QList<QPair<int, QVariant>> KFileItemModel::permissionRoleGroups() const
+QList<QPair<int, QVariant>> KFileItemModel::permissionRoleGroups(int firstIndex, int lastIndex) const
 {
     Q_ASSERT(!m_itemData.isEmpty());
 
-    const int maxIndex = count() - 1;
     QList<QPair<int, QVariant>> groups;
 
     QString permissionsString;
     QString groupValue;
-    for (int i = 0; i <= maxIndex; ++i) {
+    for (int i = firstIndex; i <= lastIndex; ++i) {
         if (isChildItem(i)) {
             continue;
         }
@@ -2763,15 +4868,14 @@ QList<QPair<int, QVariant>> KFileItemModel::permissionRoleGroups() const
     return groups;
 }
 
-QList<QPair<int, QVariant>> KFileItemModel::ratingRoleGroups() const
+QList<QPair<int, QVariant>> KFileItemModel::ratingRoleGroups(int firstIndex, int lastIndex) const
 {
     Q_ASSERT(!m_itemData.isEmpty());
 
-    const int maxIndex = count() - 1;
     QList<QPair<int, QVariant>> groups;
 
     int groupValue = -1;
-    for (int i = 0; i <= maxIndex; ++i) {
+    for (int i = firstIndex; i <= lastIndex; ++i) {
         if (isChildItem(i)) {
             continue;
         }
@@ -2785,16 +4889,15 @@ QList<QPair<int, QVariant>> KFileItemModel::ratingRoleGroups() const
     return groups;
 }
 
-QList<QPair<int, QVariant>> KFileItemModel::genericStringRoleGroups(const QByteArray &role) const
+QList<QPair<int, QVariant>> KFileItemModel::genericStringRoleGroups(const QByteArray &role, int firstIndex, int lastIndex) const
 {
     Q_ASSERT(!m_itemData.isEmpty());
 
-    const int maxIndex = count() - 1;
     QList<QPair<int, QVariant>> groups;
 
     bool isFirstGroupValue = true;
     QString groupValue;
-    for (int i = 0; i <= maxIndex; ++i) {
+    for (int i = firstIndex; i <= lastIndex; ++i) {
         if (isChildItem(i)) {
             continue;
         }
@@ -2820,8 +4923,9 @@ void KFileItemModel::emitSortProgress(int resolvedCount)
     const int itemCount = count();
     if (resolvedCount >= itemCount) {
         m_sortingProgressPercent = -1;
-        if (m_resortAllItemsTimer->isActive()) {
+        if (m_resortAllItemsTimer->isActive() || m_resortPendingWhileSorting) {
             m_resortAllItemsTimer->stop();
+            m_resortPendingWhileSorting = false;
             resortAllItems();
         }
 
@@ -2837,6 +4941,31 @@ void KFileItemModel::emitSortProgress(int resolvedCount)
     }
 }
 
+void KFileItemModel::sampleSortProgress()
+{
+    if (m_sortProgressExpectedComparisons <= 0) {
+        return;
+    }
+
+    const qint64 comparisons = m_sortProgressComparisons.loadRelaxed();
+    if (comparisons <= 0) {
+        // Sorting by an integer key (size, dates, ...): those comparisons are
+        // not counted because even huge directories sort in well under a
+        // second, and counting them would put an atomic increment into a
+        // comparison that is otherwise just an integer compare.
+        return;
+    }
+
+    // The estimate is capped below 100 percent - the comparison count of a
+    // merge sort depends on the input order - and the completion is reported
+    // by slotBackgroundResortFinished() when the new order is really in.
+    const int progress = static_cast<int>(qMin(qint64(99), comparisons * 100 / m_sortProgressExpectedComparisons));
+    if (progress > m_sortingProgressPercent) {
+        m_sortingProgressPercent = progress;
+        Q_EMIT directorySortingProgress(progress);
+    }
+}
+
 const KFileItemModel::RoleInfoMap *KFileItemModel::rolesInfoMap(int &count)
 {
     static const RoleInfoMap rolesInfoMap[] = {
@@ -2892,22 +5021,57 @@ void KFileItemModel::determineMimeTypes(const KFileItemList &items, int timeout)
 {
     QElapsedTimer timer;
     timer.start();
-    for (const KFileItem &item : items) {
-        // Only determine mime types for files here. For directories,
-        // KFileItem::determineMimeType() reads the .directory file inside to
-        // load the icon, but this is not necessary at all if we just need the
-        // type. Some special code for setting the correct mime type for
-        // directories is in retrieveData().
-        if (!item.isDir()) {
-            item.determineMimeType();
+
+    if (items.count() < ParallelMimeTypeThreshold) {
+        for (const KFileItem &item : items) {
+            // Only determine mime types for files here. For directories,
+            // KFileItem::determineMimeType() reads the .directory file inside to
+            // load the icon, but this is not necessary at all if we just need the
+            // type. Some special code for setting the correct mime type for
+            // directories is in retrieveData().
+            if (!item.isDir() && !item.isMimeTypeKnown()) {
+                item.determineMimeType();
+                KMimeTypeCache::instance()->insert(item);
+            }
+
+            if (timer.elapsed() > timeout) {
+                // Don't block the user interface, let the remaining items
+                // be resolved asynchronously.
+                return;
+            }
         }
+        return;
+    }
 
-        if (timer.elapsed() > timeout) {
-            // Don't block the user interface, let the remaining items
-            // be resolved asynchronously.
+    // For large listings the sequential loop resolves only a fraction of the
+    // items before the timeout, and the remaining items trickle in through
+    // KFileItemModelRolesUpdater causing repeated resorts. The mime database
+    // is read-only after warm-up, so content sniffing shards cleanly across
+    // the thread pool. Resolve the first item on this thread to warm the
+    // database up without all workers serializing on its initial load.
+    auto firstFile = std::find_if(items.constBegin(), items.constEnd(), [](const KFileItem &item) {
+        return !item.isDir();
+    });
+    if (firstFile == items.constEnd()) {
+        return;
+    }
+    firstFile->determineMimeType();
+
+    QAtomicInt timeoutReached(0);
+    QtConcurrent::blockingMap(items.constBegin(), items.constEnd(), [&timer, &timeoutReached, timeout](const KFileItem &item) {
+        if (timeoutReached.loadRelaxed()) {
+            // The wall-clock budget is spent. Skip the remaining items
+            // cheaply, they are resolved asynchronously.
             return;
         }
-    }
+        if (!item.isDir() && !item.isMimeTypeKnown()) {
+            item.determineMimeType();
+            KMimeTypeCache::instance()->insert(item);
+        }
+        if (timer.elapsed() > timeout) {
+            timeoutReached.storeRelaxed(1);
+        }
+    });
 }
 
 QByteArray KFileItemModel::sharedValue(const QByteArray &value)
@@ -9,22 +9,38 @@
 
 #include "dolphin_export.h"
 #include "kitemviews/kitemmodelbase.h"
+#include "kitemviews/private/kfileitemmodelcolumnstore.h"
+#include "kitemviews/private/kfileitemmodeldataarena.h"
 #include "kitemviews/private/kfileitemmodelfilter.h"
 
 #include <KFileItem>
 #include <KLazyLocalizedString>
 
+#include <QAtomicInteger>
 #include <QCollator>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
 #include <QHash>
 #include <QSet>
 #include <QUrl>
 
 #include <functional>
+#include <utility>
+#include <vector>
 
 class KDirLister;
+class KDirectoryListingSubscription;
+class KLocalDirectoryLister;
 
 class QTimer;
 
+struct KSortProfilingStats;
+
+namespace Search
+{
+class FilenameSearchEngine;
+}
+
 namespace KIO
 {
 class Job;
@@ -80,6 +96,31 @@ public:
     QHash<QByteArray, QVariant> data(int index) const override;
     bool setData(int index, const QHash<QByteArray, QVariant> &values) override;
 
+    /**
+     * Sets the value of \a role for many items in one go and emits a single
+     * itemsChanged() signal covering the changed ranges, instead of one
+     * signal per item as repeated setData() calls would. Items whose value
+     * already matches are skipped. Intended for bulk decorations like
+     * version states; \a role must not be a role that modifies the item
+     * itself (like "text", which renames it).
+     */
+    void setDataForRole(const QByteArray &role, const QList<QPair<int, QVariant>> &indexValues);
+
+    /**
+     * Starts coalescing the itemsChanged() signal: All changes announced by
+     * setData() calls until the matching endItemsChangedBatch() are merged
+     * into a single emission with ranged payloads, instead of one
+     * single-item signal per call. This takes the per-range bookkeeping of
+     * the consumers (view, selection manager, accessibility bridge) from
+     * once per item to once per batch while e.g. a whole batch of resolved
+     * previews is applied. Batches can be nested; the merged signal is
+     * emitted when the outermost batch ends. No structural change (insert,
+     * remove, resort) must happen inside a batch, because the buffered
+     * ranges refer to the indexes at setData() time.
+     */
+    void beginItemsChangedBatch();
+    void endItemsChangedBatch();
+
     /**
      * Sets a separate sorting with directories first (true) or a mixed
      * sorting of files and directories (false).
@@ -159,6 +200,26 @@ public:
     void setRoles(const QSet<QByteArray> &roles);
     QSet<QByteArray> roles() const;
 
+    /**
+     * Releases the cached role values of items far away from the visible
+     * range if the model holds more than \a itemBudget items, to bound the
+     * memory usage in huge directories. The values are retrieved again on
+     * demand when the items scroll back into view. Does nothing while the
+     * current sort role depends on the stored values.
+     */
+    void evictRoleValues(int firstVisibleIndex, int lastVisibleIndex, int itemBudget);
+
+    /**
+     * Releases only the preview pixmaps ("iconPixmap", "hoverSequencePixmaps")
+     * of items far away from the visible range if the model holds more than
+     * \a itemBudget items. The pixmaps dominate the per-item memory long
+     * before evictRoleValues() kicks in, and unlike the other role values
+     * they never feed the sort order, so they can be dropped under a much
+     * smaller budget. Returns the affected items so that the caller can
+     * queue them for preview regeneration when they scroll back into view.
+     */
+    KFileItemList evictPreviewPixmaps(int firstVisibleIndex, int lastVisibleIndex, int itemBudget);
+
     bool setExpanded(int index, bool expanded) override;
     bool isExpanded(int index) const override;
     bool isExpandable(int index) const override;
@@ -291,22 +352,73 @@ protected:
 private Q_SLOTS:
     /**
      * Resorts all items dependent on the set sortRole(), sortOrder()
-     * and foldersFirst() settings.
+     * and foldersFirst() settings. Large models are sorted on a worker
+     * thread over comparison keys snapshotted on the GUI thread, see
+     * slotBackgroundResortFinished().
      */
     void resortAllItems();
 
+    /**
+     * Swaps in the order computed by the background resort worker, unless the
+     * model changed in the meantime and the result is stale.
+     */
+    void slotBackgroundResortFinished();
+
     void slotCompleted();
     void slotCanceled();
     void slotItemsAdded(const QUrl &directoryUrl, const KFileItemList &items);
     void slotItemsDeleted(const KFileItemList &items);
+
+    /**
+     * Buffers the change notifications of the dir lister into
+     * m_pendingRefreshItems instead of applying them right away. Successive
+     * notifications for the same file are merged, so a process rewriting the
+     * watched directory repeatedly results in one ranged update per dispatch
+     * interval instead of a refresh storm.
+     * @see dispatchPendingRefreshItems()
+     */
+    void scheduleRefreshItems(const QList<QPair<KFileItem, KFileItem>> &items);
+
+    /**
+     * Applies the buffered change notifications through slotRefreshItems()
+     * and adapts the dispatch interval to the measured cost, so that
+     * write-heavy workloads coalesce more aggressively while a single changed
+     * file still shows up almost immediately.
+     */
+    void dispatchPendingRefreshItems();
+
+    /**
+     * Applies the given change pairs to the model: updates the stored items
+     * and role values, moves items in and out of m_filteredItems as their
+     * filter verdict changes, and emits one ranged itemsChanged() update with
+     * a single conditional resort.
+     */
     void slotRefreshItems(const QList<QPair<KFileItem, KFileItem>> &items);
+
     void slotClear();
     void slotSortingChoiceChanged();
     void slotHiddenFilesWhitelistChanged();
     void slotListerError(KIO::Job *job);
 
+    /**
+     * Updates the cached "isCut" bit of the affected items when the set of
+     * cut URLs on the clipboard changes. Only the items whose cut state
+     * actually changed are touched, so the views never have to ask
+     * KFileItemClipboard per item, see KStandardItemListWidget.
+     */
+    void slotCutItemsChanged();
+
     void dispatchPendingItemsToInsert();
 
+    /**
+     * Like dispatchPendingItemsToInsert(), but inserts at most an adaptively
+     * sized batch of the pending items and re-schedules itself for the rest.
+     * The batch size is derived from the measured duration of the previous
+     * insert so that a single dispatch stays within a small main-thread
+     * budget while a directory is streaming in.
+     */
+    void dispatchPendingItemsToInsertAdaptively();
+
 private:
     enum RoleType {
         // User visible roles:
@@ -362,8 +474,15 @@ private:
 
     struct ItemData {
         KFileItem item;
-        QHash<QByteArray, QVariant> values;
+        // The role values live in typed contiguous columns inside m_columnStore,
+        // see KFileItemModelColumnStore. RoleValues provides a QHash-like view.
+        KFileItemModelColumnStore::RoleValues values;
         ItemData *parent;
+        // Hidden state cached by updateCachedHiddenState() so that toggling the
+        // hidden files visibility only sweeps flags instead of re-evaluating
+        // KFileItem::isHidden() and the whitelist patterns per item.
+        bool isHidden = false;
+        bool isWhitelistedHidden = false;
     };
 
     enum RemoveItemsBehavior {
@@ -390,10 +509,25 @@ private:
      */
     void prepareItemsForSorting(QList<ItemData *> &itemDataList);
 
+    /**
+     * @return An estimate of the bytes held by this model: the ItemData
+     *         arena, the columnar role store and the lookup containers.
+     *         Reported to KMemoryAccounting.
+     */
+    qint64 estimatedMemoryUsageBytes() const;
+
     static int expandedParentsCount(const ItemData *data);
 
     void removeExpandedItems();
 
+    /**
+     * Stops the listing of the collapsed directory \a url but keeps it
+     * attached to the dir lister for a while, so that its cached listing
+     * stays available (and watched for changes) in case it gets expanded
+     * again soon. Only the oldest retained directories are really forgotten.
+     */
+    void retireExpandedDir(const QUrl &url);
+
     /**
      * This function is called by setData() and slotRefreshItems(). It emits
      * the itemsChanged() signal, checks if the sort order is still correct,
@@ -401,6 +535,40 @@ private:
      */
     void emitItemsChangedAndTriggerResorting(const KItemRangeList &itemRanges, const QSet<QByteArray> &changedRoles);
 
+    /**
+     * Builds the sorted name index used by indexForKeyboardSearch(): one
+     * entry per item, holding the case-folded name without diacritical marks
+     * and the model index of the item, ordered by the key. This turns each
+     * type-ahead keystroke into a binary search instead of a linear scan
+     * over all item names.
+     */
+    void buildKeyboardSearchIndex() const;
+
+    /**
+     * Marks the keyboard-search index as stale. It is rebuilt lazily by the
+     * next call of indexForKeyboardSearch().
+     */
+    void invalidateKeyboardSearchIndex();
+
+    /**
+     * Builds the flattened tree-structure cache m_treeStructure: for every
+     * item the expansion depth, the index of its parent and the number of
+     * (indirect) children that follow it in the flat item list. The flat
+     * item list is a pre-order traversal of the tree, so the cache can be
+     * filled in a single pass with a stack of the current ancestor chain.
+     * Tree queries like expandedParentsCount() then read a plain array
+     * instead of chasing ItemData::parent pointers and unboxing the
+     * "expandedParentsCount" value for every call.
+     */
+    void buildTreeStructureCache() const;
+
+    /**
+     * Marks the tree-structure cache as stale. It is rebuilt lazily by the
+     * next tree query. Must be called whenever items are inserted, removed
+     * or moved.
+     */
+    void invalidateTreeStructureCache();
+
     /**
      * Resets all values from m_requestRole to false.
      */
@@ -420,6 +588,15 @@ private:
 
     QHash<QByteArray, QVariant> retrieveData(const KFileItem &item, const ItemData *parent) const;
 
+    /**
+     * @return The value of the single role \a role for \a item, without
+     *         materializing any other role. Only the roles which
+     *         prepareItemsForSorting() may have to store are supported; an
+     *         invalid QVariant is returned for roles that do not apply to
+     *         the item.
+     */
+    QVariant retrieveRoleValue(const KFileItem &item, const ItemData *parent, RoleType role) const;
+
     /**
      * @return True if role values benefit from natural or case insensitive sorting.
      */
@@ -443,6 +620,102 @@ private:
      */
     void sort(const QList<ItemData *>::iterator &begin, const QList<ItemData *>::iterator &end) const;
 
+    /**
+     * Fast path for sort(): precomputes the integer comparison keys of all
+     * items in parallel and sorts over the plain keys afterwards. Only
+     * applicable for flat (non-tree) views with integer-valued sort roles.
+     *
+     * @return True if the items have been sorted, false if the caller must
+     *         fall back to the generic comparator-based sorting.
+     */
+    bool sortByPrecomputedKeys(const QList<ItemData *>::iterator &begin, const QList<ItemData *>::iterator &end, KSortProfilingStats *stats = nullptr) const;
+
+    /**
+     * Stores the current sort order of the shown directory in the LRU list
+     * s_rememberedDirectoryOrders, which is shared by all models of the
+     * process. Is called by loadDirectory() right before navigating away and
+     * whenever a loading or resorting finished, so that any model showing the
+     * directory afterwards can skip the comparison-based sorting, see
+     * sortByRememberedOrder().
+     */
+    void rememberDirectorySortOrder();
+
+    /**
+     * Reorders \a items according to the remembered sort order of the shown
+     * directory. Only succeeds if an order was remembered for the directory
+     * with the current sort settings and it covers all passed items; a
+     * directory that gained items since it was last shown is sorted the
+     * regular way.
+     *
+     * @return True if the items have been reordered, false if the caller
+     *         must sort them with the comparison-based sorting.
+     */
+    bool sortByRememberedOrder(QList<ItemData *> &items);
+
+    /**
+     * Starts loading the search results for the "filenamesearch" URL \a url
+     * with a Search::FilenameSearchEngine instead of the KIO worker. The
+     * engine walks the search path with several threads and streams its
+     * matches into the model in batches. Is called by loadDirectory() for
+     * every URL that the engine can answer, see
+     * Search::FilenameSearchEngine::canSearch().
+     *
+     * If a search is already shown and \a url merely narrows its term, the
+     * already found results are re-filtered in place and a running walk
+     * continues with the narrower pattern, see
+     * Search::FilenameSearchEngine::refine().
+     */
+    void startFilenameSearch(const QUrl &url);
+
+    /** Stops a running filename search and discards the engine. */
+    void stopFilenameSearch();
+
+    /**
+     * Persists the shown search results (including items held back by the
+     * filter) in the Search::MaterializedSearchStore, so that the next run
+     * of the same search can open from them instantly. Is invoked after
+     * slotCompleted() whenever a filename search finishes.
+     */
+    void materializeSearchResults();
+
+    /**
+     * Reconciles the shown materialized search results with the fresh
+     * results collected in m_revalidatedSearchItems once the background walk
+     * has finished: items the walk no longer found are removed and items
+     * which appeared since the materialization are inserted, both as ranged
+     * updates. Completes the loading and refreshes the snapshot.
+     */
+    void applyRevalidatedSearchResults();
+
+    /**
+     * Starts listing the local directory \a url with a KLocalDirectoryLister
+     * instead of the KIO worker, which halves the cold listing time of huge
+     * local directories. The listing is subscribed to through
+     * KDirectoryListingBroker, so models which request the same directory
+     * with the same settings share one listing. Once the listing is complete
+     * the directory is handed over to m_dirLister so that the change
+     * notifications, the refresh diffing and the lister cache work as usual,
+     * see slotCompleted(). Is called by loadDirectory() for every URL that
+     * the lister can answer, see KLocalDirectoryLister::canList().
+     */
+    void startLocalListing(const QUrl &url);
+
+    /** Unsubscribes from a running local listing and resets the takeover state. */
+    void stopLocalListing();
+
+    /**
+     * Is invoked when the local listing has delivered all items. Completes the
+     * loading and starts the takeover listing of m_dirLister.
+     */
+    void slotLocalListingCompleted();
+
+    /**
+     * Is invoked when the local listing could not read the directory. Falls
+     * back to the KIO listing, which reports the error through its usual
+     * channels.
+     */
+    void slotLocalListingFailed();
+
     /**
      * Helper method for lessThan() and expandedParentsCountCompare(): Compares
      * the passed item-data using m_sortRole as criteria. Both items must
@@ -452,12 +725,47 @@ private:
 
     int stringCompare(const QString &a, const QString &b, const QCollator &collator) const;
 
-    QList<QPair<int, QVariant>> nameRoleGroups() const;
-    QList<QPair<int, QVariant>> sizeRoleGroups() const;
-    QList<QPair<int, QVariant>> timeRoleGroups(const std::function<QDateTime(const ItemData *)> &fileTimeCb) const;
-    QList<QPair<int, QVariant>> permissionRoleGroups() const;
-    QList<QPair<int, QVariant>> ratingRoleGroups() const;
-    QList<QPair<int, QVariant>> genericStringRoleGroups(const QByteArray &typeForRole) const;
+    /**
+     * @return Cached collation key for \a text, creating it with \a collator
+     *         on the first request. The caller must hold the collator mutex.
+     */
+    const QCollatorSortKey &cachedCollationKey(const QString &text, const QCollator &collator) const;
+
+    /**
+     * @return Group boundaries for the items between \a firstIndex and
+     *         \a lastIndex (inclusive), computed with the role-specific
+     *         xxxRoleGroups() method that matches the current sort role.
+     */
+    QList<QPair<int, QVariant>> computeGroups(int firstIndex, int lastIndex) const;
+
+    /**
+     * Patches the cached group boundaries in m_groups after \a itemRanges
+     * have been inserted: boundaries outside the affected groups are shifted,
+     * only the groups surrounding the insertions are recomputed. Clears the
+     * cache if grouping is disabled or no boundaries are cached.
+     */
+    void updateGroupsForInsertedRanges(const KItemRangeList &itemRanges);
+
+    /**
+     * Counterpart of updateGroupsForInsertedRanges() for removals: drops the
+     * boundaries of removed items, shifts the remaining cached boundaries and
+     * recomputes only the groups surrounding each removed range.
+     */
+    void updateGroupsForRemovedRanges(const KItemRangeList &itemRanges);
+
+    /**
+     * Replaces the cached boundaries inside each span of \a spans (pairs of
+     * first and last index, inclusive) by freshly computed ones and keeps the
+     * boundaries outside the spans.
+     */
+    void spliceRecomputedGroupSpans(const std::vector<std::pair<int, int>> &spans);
+
+    QList<QPair<int, QVariant>> nameRoleGroups(int firstIndex, int lastIndex) const;
+    QList<QPair<int, QVariant>> sizeRoleGroups(int firstIndex, int lastIndex) const;
+    QList<QPair<int, QVariant>> timeRoleGroups(const std::function<QDateTime(const ItemData *)> &fileTimeCb, int firstIndex, int lastIndex) const;
+    QList<QPair<int, QVariant>> permissionRoleGroups(int firstIndex, int lastIndex) const;
+    QList<QPair<int, QVariant>> ratingRoleGroups(int firstIndex, int lastIndex) const;
+    QList<QPair<int, QVariant>> genericStringRoleGroups(const QByteArray &typeForRole, int firstIndex, int lastIndex) const;
 
     /**
      * Helper method for all xxxRoleGroups() methods to check whether the
@@ -471,16 +779,74 @@ private:
 
     void scheduleResortAllItems();
 
+    /**
+     * Marks a background resort that is currently in flight as stale, so that
+     * its result is discarded on arrival. Does not block: the worker only
+     * reads a snapshot taken on the GUI thread, so the model may be mutated
+     * right away. Must be called whenever the order of the items may have
+     * become outdated.
+     */
+    void cancelBackgroundResort();
+
+    /**
+     * Replaces the order of m_itemData by \a sortedItems, updates m_items and
+     * emits a single coalesced itemsMoved() event. \a sortedItems must contain
+     * exactly the items of m_itemData.
+     */
+    void applyResortedItems(const QList<ItemData *> &sortedItems);
+
     /**
      * Is invoked by KFileItemModelRolesUpdater and results in emitting the
      * sortProgress signal with a percent-value of the progress.
      */
     void emitSortProgress(int resolvedCount);
 
+    /**
+     * Samples m_sortProgressComparisons while a background resort is running
+     * and emits directorySortingProgress() with the estimated progress of the
+     * sort itself, so that minute-long sorts of huge directories by expensive
+     * string roles do not show a frozen progress display. Driven by
+     * m_sortProgressSampleTimer; the estimate is capped below 100 percent,
+     * the completion is reported by slotBackgroundResortFinished().
+     */
+    void sampleSortProgress();
+
+    enum FilterUpdate {
+        FullFilterUpdate, // All items must be re-tested against the filter
+        RestrictiveFilterUpdate, // The new filter matches a subset of the old one: only visible items can become hidden
+        RelaxingFilterUpdate // The new filter matches a superset of the old one: only hidden items can become visible
+    };
+
     /**
      * Applies the filters set through @ref setNameFilter and @ref setMimeTypeFilters.
+     * If \a update narrows the work down to the visible or the filtered items,
+     * the other set is skipped entirely, making filter-bar keystrokes
+     * O(affected items) instead of O(n).
+     */
+    void applyFilters(FilterUpdate update = FullFilterUpdate);
+
+    /**
+     * @return Which subset of items needs re-testing when the name filter
+     *         pattern changes from \a oldPattern to \a newPattern. Only
+     *         wildcard-free (substring) patterns can be classified; anything
+     *         else requires a FullFilterUpdate.
+     */
+    static FilterUpdate filterUpdateForPatternChange(const QString &oldPattern, const QString &newPattern);
+
+    /**
+     * Caches the hidden state of the item into @p itemData: whether it is
+     * hidden at all and, if so, whether it matches the hidden files whitelist.
+     * Must be called whenever ItemData::item is assigned. The cached bits let
+     * applyFilters() skip per-item whitelist pattern matching.
+     */
+    void updateCachedHiddenState(ItemData *itemData) const;
+
+    /**
+     * Applies @p patterns as the hidden files whitelist to m_filter and, if the
+     * patterns actually changed, refreshes the whitelist bit cached in the
+     * ItemData of all hidden items.
      */
-    void applyFilters();
+    void applyHiddenFilesWhitelist(const QStringList &patterns);
 
     /**
      * Removes filtered items whose expanded parents have been deleted
@@ -541,22 +907,59 @@ private:
 private:
     KDirLister *m_dirLister = nullptr;
 
+    // Answers local "filenamesearch" URLs with a parallel directory walker
+    // instead of the sequential KIO worker. Only non-null while a search
+    // result listing is shown, see startFilenameSearch().
+    Search::FilenameSearchEngine *m_filenameSearchEngine = nullptr;
+
+    // Fresh results streamed by the walker while materialized results of a
+    // previous run are shown. They are reconciled with the shown items in
+    // one pass when the walk finishes, see applyRevalidatedSearchResults().
+    KFileItemList m_revalidatedSearchItems;
+
+    // Subscription to a local listing with batched syscalls instead of the
+    // KIO worker, shared with other models on the same directory through
+    // KDirectoryListingBroker. Only non-null between loadDirectory() and the
+    // completed takeover by m_dirLister, see startLocalListing().
+    KDirectoryListingSubscription *m_localListingSubscription = nullptr;
+    // True while m_dirLister relists the directory the local lister has
+    // already delivered: slotItemsAdded() then drops the duplicates and
+    // slotCompleted() reconciles items that vanished in between.
+    bool m_adoptingLocalListing = false;
+
     QCollator m_collator;
+    // Caches the collation keys of the strings compared by stringCompare().
+    // Cleared whenever the collator settings change or the model is cleared.
+    mutable QHash<QString, QCollatorSortKey> m_collationKeyCache;
     bool m_naturalSorting;
     bool m_sortDirsFirst;
     bool m_sortHiddenLast;
 
     RoleType m_sortRole;
     int m_sortingProgressPercent; // Value of directorySortingProgress() signal
+    bool m_resortPendingWhileSorting; // A resort request arrived while the sort role was still being resolved, @see scheduleResortAllItems()
     QSet<QByteArray> m_roles;
 
+    // Columnar storage backing ItemData::values. Mutable because items (and
+    // hence their storage slots) are also created from const methods like
+    // createItemDataList().
+    mutable KFileItemModelColumnStore m_columnStore;
+
+    // Slab arena that owns all ItemData instances (m_itemData, m_filteredItems
+    // and m_pendingItemsToInsert). Mutable for the same reason as m_columnStore.
+    mutable KFileItemModelDataArena<ItemData> m_itemArena;
+
     QList<ItemData *> m_itemData;
 
-    // m_items is a cache for the method index(const QUrl&). If it contains N
-    // entries, it is guaranteed that these correspond to the first N items in
-    // the model, i.e., that (for every i between 0 and N - 1)
-    // m_items.value(fileItem(i).url()) == i
+    // m_items is a cache for the method index(const QUrl&). All entries map a
+    // URL to the correct current index of its item. It is guaranteed that the
+    // first m_itemsCachedUpTo items of the model are contained, i.e., that
+    // (for every i between 0 and m_itemsCachedUpTo - 1)
+    // m_items.value(fileItem(i).url()) == i.
+    // Entries beyond that prefix may exist after insertions or removals, see
+    // insertItems() and removeItems() which maintain the cache incrementally.
     mutable QHash<QUrl, int> m_items;
+    mutable int m_itemsCachedUpTo = 0;
 
     KFileItemModelFilter m_filter;
     QHash<KFileItem, ItemData *> m_filteredItems; // Items that got hidden by KFileItemModel::setNameFilter()
@@ -565,11 +968,89 @@ private:
 
     QTimer *m_maximumUpdateIntervalTimer;
     QTimer *m_resortAllItemsTimer;
+
+    // Change notifications buffered by slotRefreshItems() until the next
+    // dispatch, in arrival order. m_pendingRefreshIndexes maps the current
+    // (new) URL of each buffered pair to its position for merging follow-up
+    // notifications of the same file.
+    QList<QPair<KFileItem, KFileItem>> m_pendingRefreshItems;
+    QHash<QUrl, int> m_pendingRefreshIndexes;
+    QTimer *m_refreshCoalescingTimer;
+
+    // Changes buffered between beginItemsChangedBatch() and the outermost
+    // endItemsChangedBatch(), where they are merged into ranges and emitted
+    // in one itemsChanged() signal.
+    int m_itemsChangedBatchDepth = 0;
+    KItemRangeList m_batchedItemsChangedRanges;
+    QSet<QByteArray> m_batchedItemsChangedRoles;
+
+    // Worker that computes the new sort order off the GUI thread, see
+    // resortAllItems(). The invalidation flag marks the result as stale when
+    // the model changes while the worker is running.
+    QFutureWatcher<QList<ItemData *>> *m_backgroundResortWatcher = nullptr;
+    bool m_backgroundResortInvalidated = false;
+
+    // Comparisons performed by the string-comparison branches of an ongoing
+    // sort. The sorting threads increment the counter with relaxed atomics -
+    // no lock is taken - and the GUI thread samples it once per timer tick
+    // while a background resort runs, see sampleSortProgress(). Mutable
+    // because sort() is const.
+    mutable QAtomicInteger<qint64> m_sortProgressComparisons;
+    // Estimated total comparisons of the running sort (n * log2(n)); 0 while
+    // no background resort is in flight.
+    qint64 m_sortProgressExpectedComparisons = 0;
+    QTimer *m_sortProgressSampleTimer = nullptr;
+
     QList<ItemData *> m_pendingItemsToInsert;
+    // Batch size used by dispatchPendingItemsToInsertAdaptively(), adjusted
+    // after every timed insert.
+    int m_adaptiveInsertBatchSize = 4096;
+
+    struct KeyboardSearchEntry {
+        QString key; // Case-folded item name without diacritical marks
+        int index;
+    };
+
+    // Name index for indexForKeyboardSearch(), sorted by key. Built lazily
+    // on the first type-ahead search and invalidated whenever the names or
+    // the indexes of the items change.
+    mutable QList<KeyboardSearchEntry> m_keyboardSearchIndex;
+    mutable bool m_keyboardSearchIndexValid = false;
+
+    struct TreeStructureEntry {
+        int depth; // Number of expanded parents, matches the "expandedParentsCount" role
+        int parentIndex; // Index of the parent item, or -1 for top-level items
+        int subtreeSpan; // Number of direct and indirect children that follow the item
+    };
+
+    // Flattened tree structure for the expanded-folders mode, indexed by the
+    // item index. Built lazily by the first tree query and invalidated
+    // whenever items are inserted, removed or moved.
+    mutable QList<TreeStructureEntry> m_treeStructure;
+    mutable bool m_treeStructureValid = false;
 
     // Cache for KFileItemModel::groups()
     mutable QList<QPair<int, QVariant>> m_groups;
 
+    struct RememberedDirectoryOrder {
+        QUrl url;
+        RoleType sortRole;
+        Qt::SortOrder sortOrder;
+        bool naturalSorting;
+        bool sortDirsFirst;
+        bool sortHiddenLast;
+        QHash<QUrl, int> positions; // Item URL -> position in the final sort order
+    };
+
+    // The final sort orders of the directories that were shown most recently
+    // (most recently used last), see rememberDirectorySortOrder(). The list is
+    // shared by all models of the process so that a second view opening an
+    // already shown directory - e.g. the other half of a split view, another
+    // tab or the Folders Panel - profits from the work of the first one: the
+    // listing itself is served from the KDirLister cache and the sorting is
+    // replayed from here.
+    static QList<RememberedDirectoryOrder> s_rememberedDirectoryOrders;
+
     // Stores the URLs (key: target url, value: url) of the expanded directories.
     QHash<QUrl, QUrl> m_expandedDirs;
 
@@ -577,9 +1058,25 @@ private:
     // and done step after step in slotCompleted().
     QSet<QUrl> m_urlsToExpand;
 
+    // Runs from directoryLoadingStarted() until the load completes, feeding
+    // the directory size and load duration telemetry histograms. Invalid
+    // while no load is in flight. @see slotCompleted()
+    QElapsedTimer m_directoryLoadStopWatch;
+
+    // Collapsed directories that are still attached to the dir lister so that
+    // re-expanding them is served from the lister cache, in collapse order
+    // (the oldest first). @see retireExpandedDir()
+    QList<QUrl> m_recentlyCollapsedDirs;
+
+    // The sorted cut URLs that have been applied to the "isCut" bits of the
+    // items, i.e. the clipboard state at the time of the last
+    // slotCutItemsChanged() call.
+    QList<QUrl> m_cutUrls;
+
     friend class KFileItemModelRolesUpdater; // Accesses emitSortProgress() method
     friend class KFileItemModelTest; // For unit testing
     friend class KFileItemModelBenchmark; // For unit testing
+    friend class KFileItemModelSortBenchmark; // For unit testing
     friend class KFileItemListViewTest; // For unit testing
     friend class DolphinPart; // Accesses m_dirLister
 };
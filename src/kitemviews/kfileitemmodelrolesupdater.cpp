@@ -9,6 +9,11 @@
 #include "dolphindebug.h"
 #include "kfileitemmodel.h"
 #include "private/kdirectorycontentscounter.h"
+#include "private/kfileitemrolescache.h"
+#include "private/kfileitemrolestelemetry.h"
+#include "private/kmemoryaccounting.h"
+#include "private/kmimetypecache.h"
+#include "private/kpipelinetrace.h"
 #include "private/kpixmapmodifier.h"
 
 #include <KConfig>
@@ -31,39 +36,84 @@
 #endif
 
 #include <QApplication>
+#include <QDateTime>
 #include <QElapsedTimer>
+#include <QFile>
 #include <QFileInfo>
+#include <QImage>
+#include <QImageReader>
+#include <QMimeDatabase>
 #include <QPainter>
 #include <QPluginLoader>
+#include <QThread>
 #include <QTimer>
+#include <QtConcurrentMap>
+#include <QtConcurrentRun>
 #include <chrono>
 
+#ifndef Q_OS_WIN
+#include <dirent.h>
+#endif
+
 using namespace std::chrono_literals;
 
 // #define KFILEITEMMODELROLESUPDATER_DEBUG
 
 namespace
 {
-// Maximum time in ms that the KFileItemModelRolesUpdater
-// may perform a blocking operation
-const int MaxBlockTimeout = 200;
-
-// If the number of items is smaller than ResolveAllItemsLimit,
-// the roles of all items will be resolved.
-const int ResolveAllItemsLimit = 500;
-
-// Not only the visible area, but up to ReadAheadPages before and after
-// this area will be resolved.
-const int ReadAheadPages = 5;
+// If the model holds more items than RoleValuesItemBudget, the role values
+// of items far away from the visible range are evicted and retrieved again
+// on demand, to bound the memory usage in huge directories.
+const int RoleValuesItemBudget = 100000;
+
+// Preview pixmaps dominate the per-item memory long before
+// RoleValuesItemBudget is reached: a 64 px preview costs ~16 KiB, a 256 px
+// preview ~256 KiB, each with its own allocation. The pixmaps of items far
+// away from the visible range are therefore evicted under a separate item
+// budget derived from this memory bound and regenerated - usually straight
+// from KFileItemRolesCache or the on-disk thumbnail cache - when the items
+// scroll back into view.
+const qint64 PreviewPixmapMemoryBudget = 256LL * 1024 * 1024;
+
+// Floor for the budget derived from PreviewPixmapMemoryBudget, so that huge
+// zoom levels never churn the previews of items right next to the margin
+// that is kept around the visible range.
+const int MinPreviewPixmapItemBudget = 1000;
+
+// Maximum number of items that are passed to a single preview job when the
+// pending items are sharded across several concurrent jobs.
+const int MaxItemsPerPreviewJob = 100;
+
+// Number of items whose Baloo-backed sort role is resolved per batch. The
+// batch is fetched in one pass over the metadata database instead of one
+// lookup per event loop tick.
+const int BalooSortRoleBatchSize = 256;
+
+// Number of hover sequence frames that are generated in advance while an
+// item is hovered, so that scrubbing does not stall on every frame.
+const int HoverSequencePrefetchFrames = 5;
+
+// Time in ms that may be spent generating frames beyond the next one per
+// hover event. Cheap thumbnailers fill the whole prefetch buffer, expensive
+// ones (e.g. 4K videos) stop after the frame the user is about to see.
+const qint64 HoverSequenceIoBudgetMs = 500;
+
+// Upper bound for the memory held by loaded hover sequences. The trim is
+// sized in bytes instead of items, so that a few large video previews
+// cannot hold more memory than many small ones.
+const qint64 MaxHoverSequenceCacheBytes = 64 * 1024 * 1024;
 }
 
 KFileItemModelRolesUpdater::KFileItemModelRolesUpdater(KFileItemModel *model, QObject *parent)
     : QObject(parent)
     , m_state(Idle)
+    , m_suspended(false)
+    , m_pauseRequested(false)
     , m_previewChangedDuringPausing(false)
     , m_iconSizeChangedDuringPausing(false)
     , m_rolesChangedDuringPausing(false)
     , m_previewShown(false)
+    , m_scrollingFast(false)
     , m_enlargeSmallPreviews(true)
     , m_clearPreviews(false)
     , m_finishedItems()
@@ -77,18 +127,30 @@ KFileItemModelRolesUpdater::KFileItemModelRolesUpdater(KFileItemModel *model, QO
     , m_resolvableRoles()
     , m_enabledPlugins()
     , m_localFileSizePreviewLimit(0)
+    , m_inProcessImageDecoding(false)
     , m_pendingSortRoleItems()
     , m_pendingIndexes()
     , m_pendingPreviewItems()
-    , m_previewJob()
+    , m_previewJobs()
+    , m_previewTransformWatchers()
+    , m_previewDecodeWatchers()
     , m_hoverSequenceItem()
     , m_hoverSequenceIndex(0)
     , m_hoverSequencePreviewJob(nullptr)
     , m_hoverSequenceNumSuccessiveFailures(0)
+    , m_hoverSequenceSpentIoMs(0)
+    , m_hoverSequenceFrameTimer()
     , m_recentlyChangedItemsTimer(nullptr)
     , m_recentlyChangedItems()
     , m_changedItems()
+    , m_overlayUpdateTimer(nullptr)
+    , m_pendingOverlayUrls()
+    , m_resolvedOverlays()
     , m_directoryContentsCounter(nullptr)
+    , m_expandabilityProbeTimer(nullptr)
+    , m_pendingExpandabilityProbes()
+    , m_expandabilityProbeWatchers()
+    , m_overlayIconsPluginLoaded(false)
 #if HAVE_BALOO
     , m_balooFileMonitor(nullptr)
 #endif
@@ -98,6 +160,7 @@ KFileItemModelRolesUpdater::KFileItemModelRolesUpdater(KFileItemModel *model, QO
     const KConfigGroup globalConfig(KSharedConfig::openConfig(), QStringLiteral("PreviewSettings"));
     m_enabledPlugins = globalConfig.readEntry("Plugins", KIO::PreviewJob::defaultPlugins());
     m_localFileSizePreviewLimit = static_cast<qulonglong>(globalConfig.readEntry("MaximumSize", 0));
+    m_inProcessImageDecoding = globalConfig.readEntry("InProcessImageDecoding", false);
 
     connect(m_model, &KFileItemModel::itemsInserted, this, &KFileItemModelRolesUpdater::slotItemsInserted);
     connect(m_model, &KFileItemModel::itemsRemoved, this, &KFileItemModelRolesUpdater::slotItemsRemoved);
@@ -112,6 +175,14 @@ KFileItemModelRolesUpdater::KFileItemModelRolesUpdater(KFileItemModel *model, QO
     m_recentlyChangedItemsTimer->setSingleShot(true);
     connect(m_recentlyChangedItemsTimer, &QTimer::timeout, this, &KFileItemModelRolesUpdater::resolveRecentlyChangedItems);
 
+    // Overlay changes from the plugins can come in storms, e.g. when a
+    // cloud-sync plugin updates the sync status of a whole directory tree.
+    // They are collected and applied in one pass.
+    m_overlayUpdateTimer = new QTimer(this);
+    m_overlayUpdateTimer->setInterval(50ms);
+    m_overlayUpdateTimer->setSingleShot(true);
+    connect(m_overlayUpdateTimer, &QTimer::timeout, this, &KFileItemModelRolesUpdater::applyPendingOverlayUpdates);
+
     m_resolvableRoles.insert("size");
     m_resolvableRoles.insert("type");
     m_resolvableRoles.insert("isExpandable");
@@ -120,31 +191,41 @@ KFileItemModelRolesUpdater::KFileItemModelRolesUpdater(KFileItemModel *model, QO
 #endif
 
     m_directoryContentsCounter = new KDirectoryContentsCounter(m_model, this);
-    connect(m_directoryContentsCounter, &KDirectoryContentsCounter::result, this, &KFileItemModelRolesUpdater::slotDirectoryContentsCountReceived);
-
-    const auto plugins = KPluginMetaData::findPlugins(QStringLiteral("kf6/overlayicon"), {}, KPluginMetaData::AllowEmptyMetaData);
-    for (const KPluginMetaData &data : plugins) {
-        auto instance = QPluginLoader(data.fileName()).instance();
-        auto plugin = qobject_cast<KOverlayIconPlugin *>(instance);
-        if (plugin) {
-            m_overlayIconsPlugin.append(plugin);
-            connect(plugin, &KOverlayIconPlugin::overlaysChanged, this, &KFileItemModelRolesUpdater::slotOverlaysChanged);
-        } else {
-            // not our/valid plugin, so delete the created object
-            delete instance;
-        }
-    }
+    connect(m_directoryContentsCounter, &KDirectoryContentsCounter::results, this, &KFileItemModelRolesUpdater::slotDirectoryContentsCountsReceived);
+
+    // Expandability probes are collected shortly so that the visible
+    // folders of one directory are probed as one batch per parent instead
+    // of one thread-pool task per folder.
+    m_expandabilityProbeTimer = new QTimer(this);
+    m_expandabilityProbeTimer->setInterval(50ms);
+    m_expandabilityProbeTimer->setSingleShot(true);
+    connect(m_expandabilityProbeTimer, &QTimer::timeout, this, &KFileItemModelRolesUpdater::startExpandabilityProbes);
+
+    KFileItemRolesTelemetry::instance()->registerUpdater(this);
+    KMemoryAccounting::instance()->registerReporter(this, QByteArrayLiteral("KFileItemModelRolesUpdater"), [this]() {
+        return estimatedMemoryUsageBytes();
+    });
 }
 
 KFileItemModelRolesUpdater::~KFileItemModelRolesUpdater()
 {
+    KMemoryAccounting::instance()->unregisterReporter(this);
+    KFileItemRolesTelemetry::instance()->unregisterUpdater(this);
     killPreviewJob();
+    cancelPreviewTransforms();
+
+    for (QFutureWatcher<QList<ExpandabilityProbe>> *watcher : std::as_const(m_expandabilityProbeWatchers)) {
+        disconnect(watcher, nullptr, this, nullptr);
+        watcher->cancel();
+        watcher->deleteLater();
+    }
 }
 
 void KFileItemModelRolesUpdater::setIconSize(const QSize &size)
 {
     if (size != m_iconSize) {
         m_iconSize = size;
+        cancelPreviewTransforms();
         if (m_state == Paused) {
             m_iconSizeChangedDuringPausing = true;
         } else if (m_previewShown) {
@@ -165,6 +246,7 @@ void KFileItemModelRolesUpdater::setDevicePixelRatio(qreal devicePixelRatio)
 {
     if (m_devicePixelRatio != devicePixelRatio) {
         m_devicePixelRatio = devicePixelRatio;
+        cancelPreviewTransforms();
         if (m_state == Paused) {
             m_iconSizeChangedDuringPausing = true;
         } else if (m_previewShown) {
@@ -197,14 +279,64 @@ void KFileItemModelRolesUpdater::setVisibleIndexRange(int index, int count)
     m_firstVisibleIndex = index;
     m_lastVisibleIndex = qMin(index + count - 1, m_model->count() - 1);
 
+    m_model->evictRoleValues(m_firstVisibleIndex, m_lastVisibleIndex, RoleValuesItemBudget);
+
+    if (m_previewShown) {
+        // The stored previews have the size of the icons, so the number of
+        // pixmaps that fit into the memory budget depends on the zoom level.
+        const qreal pixelsPerPreview = m_iconSize.width() * m_iconSize.height() * m_devicePixelRatio * m_devicePixelRatio;
+        const qint64 bytesPerPreview = qMax(qint64(1), qint64(pixelsPerPreview) * 4);
+        const int itemBudget = qMax(MinPreviewPixmapItemBudget, static_cast<int>(qMin(PreviewPixmapMemoryBudget / bytesPerPreview, qint64(RoleValuesItemBudget))));
+
+        const KFileItemList evictedItems = m_model->evictPreviewPixmaps(m_firstVisibleIndex, m_lastVisibleIndex, itemBudget);
+        for (const KFileItem &item : evictedItems) {
+            // No longer finished: the preview is regenerated by the usual
+            // around-the-visible-range scheduling when the item approaches.
+            m_finishedItems.remove(item);
+        }
+    }
+
     startUpdating();
 }
 
+void KFileItemModelRolesUpdater::trimPreviews()
+{
+    // An item budget of 0 leaves only the margin around the visible range
+    // intact, so returning to the tab still shows previews immediately.
+    const KFileItemList evictedItems = m_model->evictPreviewPixmaps(m_firstVisibleIndex, m_lastVisibleIndex, 0);
+    for (const KFileItem &item : evictedItems) {
+        m_finishedItems.remove(item);
+    }
+}
+
 void KFileItemModelRolesUpdater::setMaximumVisibleItems(int count)
 {
     m_maximumVisibleItems = count;
 }
 
+void KFileItemModelRolesUpdater::setScrollingFast(bool fast)
+{
+    if (m_scrollingFast == fast) {
+        return;
+    }
+    m_scrollingFast = fast;
+    m_budget.setScrolling(fast);
+
+    if (fast) {
+        // Stop generating previews for ranges which are just flicking by.
+        // The cheap icon roles of the visible items are still resolved
+        // synchronously by startUpdating().
+        killPreviewJob();
+        if (m_state == PreviewJobRunning) {
+            m_state = Idle;
+        }
+    } else {
+        // The scrolling has settled: rebuild the queues for the final
+        // viewport. startUpdating() is a no-op while being paused.
+        startUpdating();
+    }
+}
+
 void KFileItemModelRolesUpdater::setPreviewsShown(bool show)
 {
     if (show == m_previewShown) {
@@ -249,8 +381,25 @@ void KFileItemModelRolesUpdater::setEnabledPlugins(const QStringList &list)
     }
 }
 
+void KFileItemModelRolesUpdater::setSuspended(bool suspended)
+{
+    if (m_suspended != suspended) {
+        m_suspended = suspended;
+        // Apply the pause state the view asked for most recently, which the
+        // suspension either overrides or stops overriding.
+        setPaused(m_pauseRequested);
+    }
+}
+
+bool KFileItemModelRolesUpdater::isSuspended() const
+{
+    return m_suspended;
+}
+
 void KFileItemModelRolesUpdater::setPaused(bool paused)
 {
+    m_pauseRequested = paused;
+    paused = paused || m_suspended;
     if (paused == (m_state == Paused)) {
         return;
     }
@@ -351,6 +500,11 @@ void KFileItemModelRolesUpdater::setHoverSequenceState(const QUrl &itemUrl, int
         killHoverSequencePreviewJob();
     }
 
+    if (item != m_hoverSequenceItem || seqIdx != m_hoverSequenceIndex) {
+        // Each hover event grants a fresh I/O budget for prefetching.
+        m_hoverSequenceSpentIoMs = 0;
+    }
+
     m_hoverSequenceItem = item;
     m_hoverSequenceIndex = seqIdx;
 
@@ -363,6 +517,37 @@ void KFileItemModelRolesUpdater::setHoverSequenceState(const QUrl &itemUrl, int
     loadNextHoverSequencePreview();
 }
 
+KFileItemRolesBudget &KFileItemModelRolesUpdater::budget()
+{
+    return m_budget;
+}
+
+QHash<QByteArray, int> KFileItemModelRolesUpdater::telemetryQueueDepths() const
+{
+    return {{"pendingSortRoleItems", static_cast<int>(m_pendingSortRoleItems.count())},
+            {"pendingIndexes", static_cast<int>(m_pendingIndexes.count())},
+            {"pendingPreviewItems", static_cast<int>(m_pendingPreviewItems.count())},
+            {"previewJobs", static_cast<int>(m_previewJobs.count())},
+            {"previewTransforms", static_cast<int>(m_previewTransformWatchers.count())},
+            {"previewDecodes", static_cast<int>(m_previewDecodeWatchers.count())},
+            {"expandabilityProbes", static_cast<int>(m_expandabilityProbeWatchers.count())},
+            {"changedItems", static_cast<int>(m_changedItems.count())}};
+}
+
+qint64 KFileItemModelRolesUpdater::estimatedMemoryUsageBytes() const
+{
+    // KFileItem instances in the bookkeeping sets share their data with the
+    // model, so only the per-entry container footprint is counted here.
+    const qint64 itemSetEntries = m_finishedItems.count() + m_pendingSortRoleItems.count() + m_pendingPreviewItems.count() + m_changedItems.count()
+        + m_recentlyChangedItems.count();
+    qint64 bytes = itemSetEntries * (sizeof(KFileItem) + sizeof(void *));
+    bytes += static_cast<qint64>(m_pendingIndexes.capacity()) * sizeof(int);
+    for (auto it = m_resolvedOverlays.constBegin(); it != m_resolvedOverlays.constEnd(); ++it) {
+        bytes += sizeof(QUrl) + static_cast<qint64>(it.value().count()) * sizeof(QString);
+    }
+    return bytes;
+}
+
 void KFileItemModelRolesUpdater::slotItemsInserted(const KItemRangeList &itemRanges)
 {
     QElapsedTimer timer;
@@ -372,6 +557,8 @@ void KFileItemModelRolesUpdater::slotItemsInserted(const KItemRangeList &itemRan
     if (m_resolvableRoles.contains(m_model->sortRole())) {
         QList<QUrl> dirsWithAddedItems;
 
+        const int maxBlockTime = m_budget.maxBlockTime();
+        int resolvedCount = 0;
         int insertedCount = 0;
         for (const KItemRange &range : itemRanges) {
             const int lastIndex = insertedCount + range.index + range.count - 1;
@@ -381,14 +568,16 @@ void KFileItemModelRolesUpdater::slotItemsInserted(const KItemRangeList &itemRan
                 if (!dirsWithAddedItems.contains(fileItemParentFolderUrl)) {
                     dirsWithAddedItems.append(fileItemParentFolderUrl);
                 }
-                if (timer.elapsed() < MaxBlockTimeout) {
+                if (timer.elapsed() < maxBlockTime) {
                     applySortRole(i);
+                    ++resolvedCount;
                 } else {
                     m_pendingSortRoleItems.insert(fileItem);
                 }
             }
             insertedCount += range.count;
         }
+        m_budget.recordResolved(resolvedCount, timer.elapsed());
 
         recountDirectoryItems(dirsWithAddedItems);
 
@@ -442,8 +631,14 @@ void KFileItemModelRolesUpdater::slotItemsRemoved(const KItemRangeList &itemRang
         m_recentlyChangedItemsTimer->stop();
         m_changedItems.clear();
         m_hoverSequenceLoadedItems.clear();
+        m_pendingOverlayUrls.clear();
+        m_overlayUpdateTimer->stop();
+        m_resolvedOverlays.clear();
+        m_pendingExpandabilityProbes.clear();
+        m_expandabilityProbeTimer->stop();
 
         killPreviewJob();
+        cancelPreviewTransforms();
         if (!m_model->showDirectoriesOnly()) {
             m_directoryContentsCounter->stopWorker();
         }
@@ -467,6 +662,16 @@ void KFileItemModelRolesUpdater::slotItemsRemoved(const KItemRangeList &itemRang
 
         recountDirectoryItems(dirsWithDeletedItems);
 
+        // Drop the cached overlays of the removed items.
+        auto overlayIt = m_resolvedOverlays.begin();
+        while (overlayIt != m_resolvedOverlays.end()) {
+            if (m_model->index(overlayIt.key()) < 0) {
+                overlayIt = m_resolvedOverlays.erase(overlayIt);
+            } else {
+                ++overlayIt;
+            }
+        }
+
         // Removed items won't have hover previews loaded anymore.
         for (const KItemRange &itemRange : itemRanges) {
             int index = itemRange.index;
@@ -493,7 +698,28 @@ void KFileItemModelRolesUpdater::slotItemsMoved(KItemRange itemRange, const QLis
 
 void KFileItemModelRolesUpdater::slotItemsChanged(const KItemRangeList &itemRanges, const QSet<QByteArray> &roles)
 {
-    Q_UNUSED(roles)
+    if (!roles.isEmpty()) {
+        // Skip the update if none of the changed roles affects the data that
+        // is resolved asynchronously here. This happens in particular when a
+        // column gets toggled: KFileItemModel then reports a change of just
+        // that role for every item of the directory, and collecting hundreds
+        // of thousands of items below only to re-resolve previews and MIME
+        // types that did not change would take seconds.
+        bool needsResolving = false;
+        for (const QByteArray &role : roles) {
+            if (m_resolvableRoles.contains(role) || role == "text" || role == "modificationtime" || role == "iconName" || role == "iconPixmap"
+                || role == "iconOverlays") {
+                // "text" and "modificationtime" indicate that the file itself
+                // was renamed or modified, so previews and MIME types might
+                // be outdated.
+                needsResolving = true;
+                break;
+            }
+        }
+        if (!needsResolving) {
+            return;
+        }
+    }
 
     // Find out if slotItemsChanged() has been done recently. If that is the
     // case, resolving the roles is postponed until a timer has exceeded
@@ -532,13 +758,17 @@ void KFileItemModelRolesUpdater::slotSortRoleChanged(const QByteArray &current,
         timer.start();
 
         // Determine the sort role synchronously for as many items as possible.
+        const int maxBlockTime = m_budget.maxBlockTime();
+        int resolvedCount = 0;
         for (int index = 0; index < count; ++index) {
-            if (timer.elapsed() < MaxBlockTimeout) {
+            if (timer.elapsed() < maxBlockTime) {
                 applySortRole(index);
+                ++resolvedCount;
             } else {
                 m_pendingSortRoleItems.insert(m_model->fileItem(index));
             }
         }
+        m_budget.recordResolved(resolvedCount, timer.elapsed());
 
         applySortProgressToModel();
 
@@ -568,16 +798,26 @@ void KFileItemModelRolesUpdater::slotGotPreview(const KFileItem &item, const QPi
         return;
     }
 
-    QHash<QByteArray, QVariant> data = rolesData(item, index);
-    data.insert("iconPixmap", transformPreviewPixmap(pixmap));
-    data.insert("supportsSequencing", m_previewJob->handlesSequences());
-
-    disconnect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
-    m_model->setData(index, data);
-    connect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
-    Q_EMIT previewJobFinished(); // For unit testing
-
-    m_finishedItems.insert(item);
+    const KIO::PreviewJob *job = qobject_cast<KIO::PreviewJob *>(sender());
+    const bool supportsSequencing = job && job->handlesSequences();
+
+    // Share the preview with the other views of this process, so that e.g.
+    // the second half of a split view on the same directory populates from
+    // memory instead of re-running the thumbnailer.
+    KFileItemRolesCache::instance()->insertPreview(item, cacheSize(), m_devicePixelRatio, pixmap, supportsSequencing);
+
+    // Scale and frame the raw preview on the thread pool; the result is
+    // applied by applyTransformedPreview(). With the raster paint engine
+    // toImage() gives access to the backing store of the pixmap without a
+    // deep copy, so the delivered preview stays a QImage until it is set on
+    // the model.
+    PreviewTransform transform;
+    transform.item = item;
+    transform.image = pixmap.toImage();
+    transform.hasAlpha = pixmap.hasAlpha();
+    transform.fresh = true;
+    transform.supportsSequencing = supportsSequencing;
+    startPreviewTransforms({transform});
 }
 
 void KFileItemModelRolesUpdater::slotPreviewFailed(const KFileItem &item)
@@ -600,24 +840,40 @@ void KFileItemModelRolesUpdater::slotPreviewFailed(const KFileItem &item)
         applyResolvedRoles(index, ResolveAll);
         m_finishedItems.insert(item);
     }
+    KFileItemRolesTelemetry::instance()->incrementCounter("failed.preview");
 }
 
 void KFileItemModelRolesUpdater::slotPreviewJobFinished()
 {
-    m_previewJob = nullptr;
+    KIO::PreviewJob *job = qobject_cast<KIO::PreviewJob *>(sender());
+    m_previewJobs.removeOne(job);
+
+    const qint64 startTime = m_previewJobStartTimes.take(job);
+    if (startTime > 0) {
+        KFileItemRolesTelemetry::instance()->recordLatency("previewJob", QDateTime::currentMSecsSinceEpoch() - startTime);
+    }
 
     if (m_state != PreviewJobRunning) {
         return;
     }
 
-    m_state = Idle;
-
     if (!m_pendingPreviewItems.isEmpty()) {
+        // Refill the freed shard (and, if mime types have become known in the
+        // meantime, further ones).
         startPreviewJob();
-    } else {
-        if (!m_changedItems.isEmpty()) {
-            updateChangedItems();
-        }
+        return;
+    }
+
+    if (!m_previewJobs.isEmpty() || !m_previewDecodeWatchers.isEmpty() || !m_previewTransformWatchers.isEmpty()) {
+        // Other shards, in-process decode batches or pending preview
+        // transforms are still delivering previews.
+        return;
+    }
+
+    m_state = Idle;
+
+    if (!m_changedItems.isEmpty()) {
+        updateChangedItems();
     }
 }
 
@@ -658,8 +914,12 @@ void KFileItemModelRolesUpdater::slotHoverSequenceGotPreview(const KFileItem &it
         const auto loadedIt = std::find(m_hoverSequenceLoadedItems.begin(), m_hoverSequenceLoadedItems.end(), item);
         if (loadedIt == m_hoverSequenceLoadedItems.end()) {
             m_hoverSequenceLoadedItems.push_back(item);
-            trimHoverSequenceLoadedItems();
+        } else {
+            // Move the item to the back, so that the least recently hovered
+            // items are evicted first.
+            m_hoverSequenceLoadedItems.splice(m_hoverSequenceLoadedItems.end(), m_hoverSequenceLoadedItems, loadedIt);
         }
+        trimHoverSequenceLoadedItems();
     }
 
     m_hoverSequenceNumSuccessiveFailures = 0;
@@ -709,6 +969,11 @@ void KFileItemModelRolesUpdater::slotHoverSequencePreviewFailed(const KFileItem
 
 void KFileItemModelRolesUpdater::slotHoverSequencePreviewJobFinished()
 {
+    if (m_hoverSequenceFrameTimer.isValid()) {
+        m_hoverSequenceSpentIoMs += m_hoverSequenceFrameTimer.elapsed();
+        m_hoverSequenceFrameTimer.invalidate();
+    }
+
     const int index = m_model->index(m_hoverSequenceItem);
     if (index < 0) {
         m_hoverSequencePreviewJob = nullptr;
@@ -729,22 +994,83 @@ void KFileItemModelRolesUpdater::resolveNextSortRole()
         return;
     }
 
-    QSet<KFileItem>::iterator it = m_pendingSortRoleItems.begin();
-    while (it != m_pendingSortRoleItems.end()) {
-        const KFileItem item = *it;
-        const int index = m_model->index(item);
+    DOLPHIN_PIPELINE_TRACE_SPAN("KFileItemModelRolesUpdater::resolveNextSortRole", m_pendingSortRoleItems.count());
+
+#if HAVE_BALOO
+    if (KBalooRolesProvider::instance().roles().contains(m_model->sortRole())) {
+        // The sort role is backed by Baloo. Resolving it item by item would
+        // issue one database lookup per event loop tick, which makes sorting
+        // a large directory by e.g. rating or tags take minutes. Fetch the
+        // metadata for a whole batch of items in one pass instead.
+        QList<KFileItem> batchItems;
+        QStringList batchPaths;
+        QSet<KFileItem>::iterator it = m_pendingSortRoleItems.begin();
+        while (it != m_pendingSortRoleItems.end() && batchItems.count() < BalooSortRoleBatchSize) {
+            const KFileItem item = *it;
+            const int index = m_model->index(item);
+
+            // Continue if the sort role has already been determined for the
+            // item, and the item has not been changed recently.
+            if (!m_changedItems.contains(item) && m_model->data(index).contains(m_model->sortRole())) {
+                it = m_pendingSortRoleItems.erase(it);
+                continue;
+            }
 
-        // Continue if the sort role has already been determined for the
-        // item, and the item has not been changed recently.
-        if (!m_changedItems.contains(item) && m_model->data(index).contains(m_model->sortRole())) {
+            batchItems.append(item);
+            batchPaths.append(item.localPath());
             it = m_pendingSortRoleItems.erase(it);
-            continue;
         }
 
-        applySortRole(index);
-        m_pendingSortRoleItems.erase(it);
-        break;
+        if (!batchItems.isEmpty()) {
+            QHash<QByteArray, QVariant> blankedRoles;
+            const auto providerRoles = KBalooRolesProvider::instance().roles();
+            for (const QByteArray &role : providerRoles) {
+                // See applyChangedBalooRolesForItem() and bug 322348.
+                blankedRoles.insert(role, QVariant());
+            }
+
+            QElapsedTimer balooTimer;
+            balooTimer.start();
+            const QList<QHash<QByteArray, QVariant>> batchValues = KBalooRolesProvider::instance().roleValuesBatch(batchPaths, m_roles);
+            KFileItemRolesTelemetry::instance()->recordLatency("balooFetch", balooTimer.elapsed());
+            KFileItemRolesTelemetry::instance()->incrementCounter("resolved.balooRoles", batchItems.count());
+
+            disconnect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
+            m_model->beginItemsChangedBatch();
+            for (int i = 0; i < batchItems.count(); ++i) {
+                const int index = m_model->index(batchItems.at(i));
+                if (index < 0) {
+                    continue;
+                }
+
+                QHash<QByteArray, QVariant> data = blankedRoles;
+                data.insert(batchValues.at(i));
+                m_model->setData(index, data);
+            }
+            m_model->endItemsChangedBatch();
+            connect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
+        }
+    } else {
+#endif
+        QSet<KFileItem>::iterator it = m_pendingSortRoleItems.begin();
+        while (it != m_pendingSortRoleItems.end()) {
+            const KFileItem item = *it;
+            const int index = m_model->index(item);
+
+            // Continue if the sort role has already been determined for the
+            // item, and the item has not been changed recently.
+            if (!m_changedItems.contains(item) && m_model->data(index).contains(m_model->sortRole())) {
+                it = m_pendingSortRoleItems.erase(it);
+                continue;
+            }
+
+            applySortRole(index);
+            m_pendingSortRoleItems.erase(it);
+            break;
+        }
+#if HAVE_BALOO
     }
+#endif
 
     if (!m_pendingSortRoleItems.isEmpty()) {
         applySortProgressToModel();
@@ -766,6 +1092,8 @@ void KFileItemModelRolesUpdater::resolveNextPendingRoles()
         return;
     }
 
+    DOLPHIN_PIPELINE_TRACE_SPAN("KFileItemModelRolesUpdater::resolveNextPendingRoles", m_pendingIndexes.count());
+
     while (!m_pendingIndexes.isEmpty()) {
         const int index = m_pendingIndexes.takeFirst();
         const KFileItem item = m_model->fileItem(index);
@@ -793,11 +1121,13 @@ void KFileItemModelRolesUpdater::resolveNextPendingRoles()
                 data.insert("hoverSequencePixmaps", QVariant::fromValue(QVector<QPixmap>()));
 
                 disconnect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
+                m_model->beginItemsChangedBatch();
                 for (int index = 0; index <= m_model->count(); ++index) {
                     if (m_model->data(index).contains("iconPixmap") || m_model->data(index).contains("hoverSequencePixmaps")) {
                         m_model->setData(index, data);
                     }
                 }
+                m_model->endItemsChangedBatch();
                 connect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
             }
             m_clearPreviews = false;
@@ -835,8 +1165,12 @@ void KFileItemModelRolesUpdater::applyChangedBalooRoles(const QString &file)
 void KFileItemModelRolesUpdater::applyChangedBalooRolesForItem(const KFileItem &item)
 {
 #if HAVE_BALOO
+    QElapsedTimer balooTimer;
+    balooTimer.start();
     Baloo::File file(item.localPath());
     file.load();
+    KFileItemRolesTelemetry::instance()->recordLatency("balooFetch", balooTimer.elapsed());
+    KFileItemRolesTelemetry::instance()->incrementCounter("resolved.balooRoles");
 
     const KBalooRolesProvider &rolesProvider = KBalooRolesProvider::instance();
     QHash<QByteArray, QVariant> data;
@@ -866,29 +1200,47 @@ void KFileItemModelRolesUpdater::applyChangedBalooRolesForItem(const KFileItem &
 #endif
 }
 
-void KFileItemModelRolesUpdater::slotDirectoryContentsCountReceived(const QString &path, int count, long long size)
+void KFileItemModelRolesUpdater::slotDirectoryContentsCountsReceived(const QList<KDirectoryContentsCounter::DirectoryCountResult> &results)
 {
     const bool getIsExpandableRole = m_roles.contains("isExpandable");
     const bool getSizeRole = m_roles.contains("size");
 
-    if (getSizeRole || getIsExpandableRole) {
-        const int index = m_model->index(QUrl::fromLocalFile(path));
-        if (index >= 0) {
-            QHash<QByteArray, QVariant> data;
+    if (!getSizeRole && !getIsExpandableRole) {
+        return;
+    }
 
-            if (getSizeRole) {
-                data.insert("count", count);
-                data.insert("size", QVariant::fromValue(size));
-            }
-            if (getIsExpandableRole) {
-                data.insert("isExpandable", count > 0);
-            }
+    disconnect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
+    // The counter delivers the counts of one flush interval in one go. Merge
+    // them into a single ranged itemsChanged() emission so that a folder full
+    // of subdirectories causes one repaint per batch instead of one per
+    // counted directory, and so that a resort by size is considered once per
+    // batch instead of once per item.
+    m_model->beginItemsChangedBatch();
+    for (const KDirectoryContentsCounter::DirectoryCountResult &result : results) {
+        const int index = m_model->index(QUrl::fromLocalFile(result.path));
+        if (index < 0) {
+            continue;
+        }
 
-            disconnect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
-            m_model->setData(index, data);
-            connect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
+        if (!result.intermediate) {
+            KFileItemRolesCache::instance()->insertDirectoryCount(m_model->fileItem(index), result.count, result.size);
+            KFileItemRolesTelemetry::instance()->incrementCounter("resolved.directoryCount");
+        }
+
+        QHash<QByteArray, QVariant> data;
+
+        if (getSizeRole) {
+            data.insert("count", result.count);
+            data.insert("size", QVariant::fromValue(result.size));
+        }
+        if (getIsExpandableRole) {
+            data.insert("isExpandable", result.count > 0);
         }
+
+        m_model->setData(index, data);
     }
+    m_model->endItemsChangedBatch();
+    connect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
 }
 
 void KFileItemModelRolesUpdater::startUpdating()
@@ -897,6 +1249,8 @@ void KFileItemModelRolesUpdater::startUpdating()
         return;
     }
 
+    DOLPHIN_PIPELINE_TRACE_SPAN("KFileItemModelRolesUpdater::startUpdating", m_model->count());
+
     if (m_finishedItems.count() == m_model->count()) {
         // All roles have been resolved already.
         m_state = Idle;
@@ -919,6 +1273,14 @@ void KFileItemModelRolesUpdater::startUpdating()
         return;
     }
 
+    if (m_scrollingFast) {
+        // While the view is being flick-scrolled only the cheap icon roles
+        // of the visible items are determined. Everything else is resolved
+        // by setScrollingFast(false) once the scrolling settles.
+        m_state = Idle;
+        return;
+    }
+
     // Start the preview job or the asynchronous resolving of all roles.
     QList<int> indexes = indexesToResolve();
 
@@ -958,10 +1320,14 @@ void KFileItemModelRolesUpdater::updateVisibleIcons()
     timer.start();
 
     // Try to determine the final icons for all visible items.
+    const int maxBlockTime = m_budget.maxBlockTime();
     int index;
-    for (index = m_firstVisibleIndex; index <= lastVisibleIndex && timer.elapsed() < MaxBlockTimeout; ++index) {
+    m_model->beginItemsChangedBatch();
+    for (index = m_firstVisibleIndex; index <= lastVisibleIndex && timer.elapsed() < maxBlockTime; ++index) {
         applyResolvedRoles(index, ResolveFast);
     }
+    m_model->endItemsChangedBatch();
+    m_budget.recordResolved(index - m_firstVisibleIndex, timer.elapsed());
 
     // KFileItemListView::initializeItemListWidget(KItemListWidget*) will load
     // preliminary icons (i.e., without mime type determination) for the
@@ -972,95 +1338,388 @@ void KFileItemModelRolesUpdater::startPreviewJob()
 {
     m_state = PreviewJobRunning;
 
+    // Serve items whose preview another view of this process has generated
+    // already straight from the process-wide cache. Only the cheap roles are
+    // applied synchronously; scaling and framing thousands of cached
+    // previews (e.g. after a zoom level change) is done on the thread pool
+    // in visible-first order, while the view keeps drawing the previous
+    // pixmap cheaply scaled at paint time until the crisp one lands.
+    QList<PreviewTransform> transforms;
+    // One ranged itemsChanged emission for the whole cache sweep instead of
+    // one single-item signal per served preview.
+    m_model->beginItemsChangedBatch();
+    auto pendingIt = m_pendingPreviewItems.begin();
+    while (pendingIt != m_pendingPreviewItems.end()) {
+        bool supportsSequencing = false;
+        const QPixmap cachedPreview = KFileItemRolesCache::instance()->preview(*pendingIt, cacheSize(), m_devicePixelRatio, &supportsSequencing);
+        if (cachedPreview.isNull()) {
+            ++pendingIt;
+            continue;
+        }
+
+        const KFileItem item = *pendingIt;
+        pendingIt = m_pendingPreviewItems.erase(pendingIt);
+
+        const int index = m_model->index(item);
+        if (index < 0) {
+            continue;
+        }
+
+        QHash<QByteArray, QVariant> data = rolesData(item, index);
+        data.insert("supportsSequencing", supportsSequencing);
+
+        disconnect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
+        m_model->setData(index, data);
+        connect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
+
+        m_finishedItems.insert(item);
+        m_changedItems.remove(item);
+
+        transforms.append({item, cachedPreview.toImage(), cachedPreview.hasAlpha()});
+    }
+    m_model->endItemsChangedBatch();
+
+    if (!transforms.isEmpty()) {
+        startPreviewTransforms(transforms);
+    }
+
+    if (m_inProcessImageDecoding) {
+        // Plain image files skip the external thumbnailer round trip of
+        // PreviewJob and are decoded at target resolution on the thread pool.
+        startInProcessPreviewDecodes();
+    }
+
     if (m_pendingPreviewItems.isEmpty()) {
-        QTimer::singleShot(0, this, &KFileItemModelRolesUpdater::slotPreviewJobFinished);
+        if (m_previewJobs.isEmpty()) {
+            QTimer::singleShot(0, this, &KFileItemModelRolesUpdater::slotPreviewJobFinished);
+        }
         return;
     }
 
-    // KIO::filePreview() will request the MIME-type of all passed items, which (in the
-    // worst case) might block the application for several seconds. To prevent such
-    // a blocking, we only pass items with known mime type to the preview job.
-    const int count = m_pendingPreviewItems.count();
-    KFileItemList itemSubSet;
-    itemSubSet.reserve(count);
-
-    if (m_pendingPreviewItems.first().isMimeTypeKnown()) {
-        // Some mime types are known already, probably because they were
-        // determined when loading the icons for the visible items. Start
-        // a preview job for all items at the beginning of the list which
-        // have a known mime type.
-        do {
-            itemSubSet.append(m_pendingPreviewItems.takeFirst());
-        } while (!m_pendingPreviewItems.isEmpty() && m_pendingPreviewItems.first().isMimeTypeKnown());
-    } else {
-        // Determine mime types for MaxBlockTimeout ms, and start a preview
-        // job for the corresponding items.
-        QElapsedTimer timer;
-        timer.start();
+    // Shard the pending items across several concurrent preview jobs so that
+    // thumbnailing a big directory uses more than one core. The items are
+    // taken from the front of the list, which keeps the visible-range-first
+    // ordering: every shard starts with items close to the viewport. Remote
+    // and otherwise slow folders stay on a single job, they are bound by the
+    // connection and not by the CPU.
+    static const int maxJobs = qBound(1, QThread::idealThreadCount() / 2, 8);
+
+    while (m_previewJobs.count() < maxJobs && !m_pendingPreviewItems.isEmpty()) {
+        // KIO::filePreview() will request the MIME-type of all passed items, which (in the
+        // worst case) might block the application for several seconds. To prevent such
+        // a blocking, we only pass items with known mime type to the preview job.
+        KFileItemList itemSubSet;
+
+        if (m_pendingPreviewItems.first().isMimeTypeKnown()) {
+            // Some mime types are known already, probably because they were
+            // determined when loading the icons for the visible items. Start
+            // a preview job for items at the beginning of the list which
+            // have a known mime type.
+            do {
+                itemSubSet.append(m_pendingPreviewItems.takeFirst());
+            } while (!m_pendingPreviewItems.isEmpty() && m_pendingPreviewItems.first().isMimeTypeKnown() && itemSubSet.count() < MaxItemsPerPreviewJob);
+        } else if (m_previewJobs.isEmpty()) {
+            // Determine mime types for the time slice granted by the budget,
+            // and start a preview job for the corresponding items.
+            const int maxBlockTime = m_budget.maxBlockTime();
+            QElapsedTimer timer;
+            timer.start();
+
+            do {
+                const KFileItem item = m_pendingPreviewItems.takeFirst();
+                item.determineMimeType();
+                KMimeTypeCache::instance()->insert(item);
+                itemSubSet.append(item);
+            } while (!m_pendingPreviewItems.isEmpty() && timer.elapsed() < maxBlockTime);
+            m_budget.recordResolved(itemSubSet.count(), timer.elapsed());
+        } else {
+            // Spending another synchronous time slice on mime determination
+            // would block the application. The remaining items are handled
+            // when one of the running jobs finishes.
+            break;
+        }
+
+        KIO::PreviewJob *job = new KIO::PreviewJob(itemSubSet, cacheSize(), &m_enabledPlugins);
+        job->setDevicePixelRatio(m_devicePixelRatio);
+        const bool fastLocalItems = itemSubSet.first().isLocalFile() && !itemSubSet.first().isSlow();
+        job->setIgnoreMaximumSize(fastLocalItems && m_localFileSizePreviewLimit <= 0);
+        if (job->uiDelegate()) {
+            KJobWidgets::setWindow(job, qApp->activeWindow());
+        }
 
-        do {
-            const KFileItem item = m_pendingPreviewItems.takeFirst();
-            item.determineMimeType();
-            itemSubSet.append(item);
-        } while (!m_pendingPreviewItems.isEmpty() && timer.elapsed() < MaxBlockTimeout);
+        connect(job, &KIO::PreviewJob::gotPreview, this, &KFileItemModelRolesUpdater::slotGotPreview);
+        connect(job, &KIO::PreviewJob::failed, this, &KFileItemModelRolesUpdater::slotPreviewFailed);
+        connect(job, &KIO::PreviewJob::finished, this, &KFileItemModelRolesUpdater::slotPreviewJobFinished);
+
+        m_previewJobs.append(job);
+        m_previewJobStartTimes.insert(job, QDateTime::currentMSecsSinceEpoch());
+
+        if (!fastLocalItems) {
+            break;
+        }
     }
+}
 
-    KIO::PreviewJob *job = new KIO::PreviewJob(itemSubSet, cacheSize(), &m_enabledPlugins);
-    job->setDevicePixelRatio(m_devicePixelRatio);
-    job->setIgnoreMaximumSize(itemSubSet.first().isLocalFile() && !itemSubSet.first().isSlow() && m_localFileSizePreviewLimit <= 0);
-    if (job->uiDelegate()) {
-        KJobWidgets::setWindow(job, qApp->activeWindow());
+/**
+ * Scales and frames a raw preview image. Operates purely on the QImage level
+ * so that it can run on any thread; every parameter is passed by value.
+ */
+static QImage transformPreviewImage(QImage image, bool hasAlpha, QSize iconSize, bool enlargeSmallPreviews, qreal devicePixelRatio)
+{
+    if (hasAlpha || iconSize.width() <= KIconLoader::SizeSmallMedium || iconSize.height() <= KIconLoader::SizeSmallMedium) {
+        KPixmapModifier::scale(image, iconSize * devicePixelRatio);
+        image.setDevicePixelRatio(devicePixelRatio);
+        return image;
+    }
+
+    if (enlargeSmallPreviews) {
+        KPixmapModifier::applyFrame(image, iconSize);
+        return image;
     }
 
-    connect(job, &KIO::PreviewJob::gotPreview, this, &KFileItemModelRolesUpdater::slotGotPreview);
-    connect(job, &KIO::PreviewJob::failed, this, &KFileItemModelRolesUpdater::slotPreviewFailed);
-    connect(job, &KIO::PreviewJob::finished, this, &KFileItemModelRolesUpdater::slotPreviewJobFinished);
+    // Assure that small previews don't get enlarged. Instead they should be
+    // shown centered within the frame.
+    const QSize contentSize = KPixmapModifier::sizeInsideFrame(iconSize);
+    const bool enlargingRequired = image.width() < contentSize.width() && image.height() < contentSize.height();
+    if (enlargingRequired) {
+        QSize frameSize = image.size() / image.devicePixelRatio();
+        frameSize.scale(iconSize, Qt::KeepAspectRatio);
+
+        QImage largeFrame(frameSize, QImage::Format_ARGB32_Premultiplied);
+        largeFrame.fill(Qt::transparent);
+
+        KPixmapModifier::applyFrame(largeFrame, frameSize);
 
-    m_previewJob = job;
+        QPainter painter(&largeFrame);
+        painter.drawImage((largeFrame.width() - image.width() / image.devicePixelRatio()) / 2,
+                          (largeFrame.height() - image.height() / image.devicePixelRatio()) / 2,
+                          image);
+        return largeFrame;
+    }
+
+    // The image must be shrunk as it is too large to fit into the available
+    // icon size.
+    KPixmapModifier::applyFrame(image, iconSize);
+    return image;
 }
 
 QPixmap KFileItemModelRolesUpdater::transformPreviewPixmap(const QPixmap &pixmap)
 {
-    QPixmap scaledPixmap = pixmap;
-
     if (pixmap.isNull()) {
-        return scaledPixmap;
+        return pixmap;
+    }
+
+    // With the raster paint engine toImage() gives access to the backing
+    // store of the pixmap without a deep copy. All transformations are done
+    // on the QImage level and the result is converted to a QPixmap exactly
+    // once at the end - each QPixmap operation would internally do its own
+    // image round trip, copying megabytes per item at large icon sizes.
+    return QPixmap::fromImage(transformPreviewImage(pixmap.toImage(), pixmap.hasAlpha(), m_iconSize, m_enlargeSmallPreviews, m_devicePixelRatio));
+}
+
+void KFileItemModelRolesUpdater::startPreviewTransforms(const QList<PreviewTransform> &transforms)
+{
+    const QSize iconSize = m_iconSize;
+    const bool enlargeSmallPreviews = m_enlargeSmallPreviews;
+    const qreal devicePixelRatio = m_devicePixelRatio;
+
+    auto *watcher = new QFutureWatcher<PreviewTransform>(this);
+    connect(watcher, &QFutureWatcherBase::resultReadyAt, this, [this, watcher](int resultIndex) {
+        applyTransformedPreview(watcher->resultAt(resultIndex));
+    });
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher]() {
+        m_previewTransformWatchers.removeOne(watcher);
+        watcher->deleteLater();
+        // A preview pass is only finished once the transforms of all
+        // delivered previews have landed in the model; this mirrors a job's
+        // finished() handling.
+        slotPreviewJobFinished();
+    });
+    m_previewTransformWatchers.append(watcher);
+
+    watcher->setFuture(QtConcurrent::mapped(transforms, [iconSize, enlargeSmallPreviews, devicePixelRatio](const PreviewTransform &transform) {
+        PreviewTransform result = transform;
+        result.image = transformPreviewImage(transform.image, transform.hasAlpha, iconSize, enlargeSmallPreviews, devicePixelRatio);
+        return result;
+    }));
+}
+
+void KFileItemModelRolesUpdater::applyTransformedPreview(const PreviewTransform &transform)
+{
+    const int index = m_model->index(transform.item);
+    if (index < 0) {
+        return;
+    }
+
+    QHash<QByteArray, QVariant> data;
+    if (transform.fresh) {
+        data = rolesData(transform.item, index);
+        data.insert("supportsSequencing", transform.supportsSequencing);
+    }
+    data.insert("iconPixmap", QPixmap::fromImage(transform.image));
+
+    disconnect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
+    m_model->setData(index, data);
+    connect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
+
+    if (transform.fresh) {
+        Q_EMIT previewJobFinished(); // For unit testing
+
+        m_finishedItems.insert(transform.item);
+        KFileItemRolesTelemetry::instance()->incrementCounter("resolved.preview");
+    }
+}
+
+void KFileItemModelRolesUpdater::cancelPreviewTransforms()
+{
+    for (QFutureWatcher<PreviewTransform> *watcher : std::as_const(m_previewTransformWatchers)) {
+        disconnect(watcher, nullptr, this, nullptr);
+        watcher->cancel();
+        watcher->deleteLater();
+    }
+    m_previewTransformWatchers.clear();
+
+    for (QFutureWatcher<PreviewDecode> *watcher : std::as_const(m_previewDecodeWatchers)) {
+        disconnect(watcher, nullptr, this, nullptr);
+        watcher->cancel();
+        watcher->deleteLater();
+    }
+    m_previewDecodeWatchers.clear();
+}
+
+bool KFileItemModelRolesUpdater::canDecodePreviewInProcess(const KFileItem &item) const
+{
+    if (!item.isLocalFile() || item.isSlow()) {
+        return false;
+    }
+    if (m_localFileSizePreviewLimit > 0 && item.size() > m_localFileSizePreviewLimit) {
+        return false;
+    }
+    if (!m_enabledPlugins.contains(QLatin1String("imagethumbnail"))) {
+        // The user disabled image previews; the fast path must not resurrect them.
+        return false;
+    }
+    // Only formats whose decoder is known to handle arbitrary files robustly
+    // and to support scaled decoding. Everything else keeps going through
+    // the sandboxed external thumbnailers.
+    const QString mimeType = item.mimetype();
+    return mimeType == QLatin1String("image/jpeg") || mimeType == QLatin1String("image/png") || mimeType == QLatin1String("image/webp");
+}
+
+/**
+ * Decodes an image file directly at the requested target resolution. With
+ * setScaledSize() e.g. the JPEG decoder only reconstructs the needed IDCT
+ * coefficients, which makes decoding a multi-megapixel photo to a 256 px
+ * preview several times cheaper than a full decode. Runs on any thread.
+ */
+static QImage decodePreviewImage(const QString &path, QSize targetSize, qreal devicePixelRatio)
+{
+    QImageReader reader(path);
+    // Honor the EXIF orientation like the thumbnailers do.
+    reader.setAutoTransform(true);
+
+    const QSize sourceSize = reader.size();
+    if (!sourceSize.isValid()) {
+        return QImage();
     }
 
-    if (!pixmap.hasAlpha() && m_iconSize.width() > KIconLoader::SizeSmallMedium && m_iconSize.height() > KIconLoader::SizeSmallMedium) {
-        if (m_enlargeSmallPreviews) {
-            KPixmapModifier::applyFrame(scaledPixmap, m_iconSize);
+    // Downscale only; small images are handled by the preview frame logic.
+    // The orientation transform is applied after scaling, so the scaled size
+    // is given in source orientation - for the square target this is moot.
+    const QSize maxSize = targetSize * devicePixelRatio;
+    if (sourceSize.width() > maxSize.width() || sourceSize.height() > maxSize.height()) {
+        reader.setScaledSize(sourceSize.scaled(maxSize, Qt::KeepAspectRatio));
+    }
+
+    QImage image = reader.read();
+    image.setDevicePixelRatio(devicePixelRatio);
+    return image;
+}
+
+void KFileItemModelRolesUpdater::startInProcessPreviewDecodes()
+{
+    QList<KFileItem> decodeItems;
+    auto it = m_pendingPreviewItems.begin();
+    while (it != m_pendingPreviewItems.end()) {
+        // Items with an unknown mime type are left for the budgeted mime
+        // determination of the preview job sharding below.
+        if (it->isMimeTypeKnown() && canDecodePreviewInProcess(*it)) {
+            decodeItems.append(*it);
+            it = m_pendingPreviewItems.erase(it);
         } else {
-            // Assure that small previews don't get enlarged. Instead they
-            // should be shown centered within the frame.
-            const QSize contentSize = KPixmapModifier::sizeInsideFrame(m_iconSize);
-            const bool enlargingRequired = scaledPixmap.width() < contentSize.width() && scaledPixmap.height() < contentSize.height();
-            if (enlargingRequired) {
-                QSize frameSize = scaledPixmap.size() / scaledPixmap.devicePixelRatio();
-                frameSize.scale(m_iconSize, Qt::KeepAspectRatio);
-
-                QPixmap largeFrame(frameSize);
-                largeFrame.fill(Qt::transparent);
-
-                KPixmapModifier::applyFrame(largeFrame, frameSize);
-
-                QPainter painter(&largeFrame);
-                painter.drawPixmap((largeFrame.width() - scaledPixmap.width() / scaledPixmap.devicePixelRatio()) / 2,
-                                   (largeFrame.height() - scaledPixmap.height() / scaledPixmap.devicePixelRatio()) / 2,
-                                   scaledPixmap);
-                scaledPixmap = largeFrame;
-            } else {
-                // The image must be shrunk as it is too large to fit into
-                // the available icon size
-                KPixmapModifier::applyFrame(scaledPixmap, m_iconSize);
-            }
+            ++it;
         }
-    } else {
-        KPixmapModifier::scale(scaledPixmap, m_iconSize * m_devicePixelRatio);
-        scaledPixmap.setDevicePixelRatio(m_devicePixelRatio);
     }
 
-    return scaledPixmap;
+    if (decodeItems.isEmpty()) {
+        return;
+    }
+
+    const QSize targetSize = cacheSize();
+    const QSize iconSize = m_iconSize;
+    const bool enlargeSmallPreviews = m_enlargeSmallPreviews;
+    const qreal devicePixelRatio = m_devicePixelRatio;
+
+    auto *watcher = new QFutureWatcher<PreviewDecode>(this);
+    connect(watcher, &QFutureWatcherBase::resultReadyAt, this, [this, watcher](int resultIndex) {
+        applyInProcessDecode(watcher->resultAt(resultIndex));
+    });
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher]() {
+        m_previewDecodeWatchers.removeOne(watcher);
+        watcher->deleteLater();
+        // The preview pass is finished once the last decode batch and all
+        // preview jobs are done; this mirrors a job's finished() handling.
+        slotPreviewJobFinished();
+    });
+    m_previewDecodeWatchers.append(watcher);
+
+    watcher->setFuture(QtConcurrent::mapped(decodeItems, [targetSize, iconSize, enlargeSmallPreviews, devicePixelRatio](const KFileItem &item) {
+        PreviewDecode result;
+        result.item = item;
+        result.image = decodePreviewImage(item.localPath(), targetSize, devicePixelRatio);
+        if (!result.image.isNull()) {
+            result.transformedImage = transformPreviewImage(result.image, result.image.hasAlphaChannel(), iconSize, enlargeSmallPreviews, devicePixelRatio);
+        }
+        return result;
+    }));
+}
+
+void KFileItemModelRolesUpdater::applyInProcessDecode(const PreviewDecode &decode)
+{
+    if (m_state != PreviewJobRunning) {
+        return;
+    }
+
+    if (decode.image.isNull()) {
+        // A corrupt or misdetected file; fall back to the plain icon like a
+        // failed preview job would.
+        slotPreviewFailed(decode.item);
+        return;
+    }
+
+    m_changedItems.remove(decode.item);
+
+    const int index = m_model->index(decode.item);
+    if (index < 0) {
+        return;
+    }
+
+    QHash<QByteArray, QVariant> data = rolesData(decode.item, index);
+    data.insert("iconPixmap", QPixmap::fromImage(decode.transformedImage));
+    // Static images have no hover sequence.
+    data.insert("supportsSequencing", false);
+
+    // Share the preview with the other views of this process, like
+    // slotGotPreview() does for previews from a PreviewJob.
+    KFileItemRolesCache::instance()->insertPreview(decode.item, cacheSize(), m_devicePixelRatio, QPixmap::fromImage(decode.image), false);
+
+    disconnect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
+    m_model->setData(index, data);
+    connect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
+    Q_EMIT previewJobFinished(); // For unit testing
+
+    m_finishedItems.insert(decode.item);
+    KFileItemRolesTelemetry::instance()->incrementCounter("resolved.previewInProcess");
 }
 
 QSize KFileItemModelRolesUpdater::cacheSize()
@@ -1085,7 +1744,7 @@ void KFileItemModelRolesUpdater::loadNextHoverSequencePreview()
     }
 
     // We generate the next few sequence indices in advance (buffering)
-    const int maxSeqIdx = m_hoverSequenceIndex + 5;
+    const int maxSeqIdx = m_hoverSequenceIndex + HoverSequencePrefetchFrames;
 
     QHash<QByteArray, QVariant> data = m_model->data(index);
 
@@ -1113,6 +1772,14 @@ void KFileItemModelRolesUpdater::loadNextHoverSequencePreview()
         return;
     }
 
+    if (loadSeqIdx > m_hoverSequenceIndex + 1 && m_hoverSequenceSpentIoMs > HoverSequenceIoBudgetMs) {
+        // The frame the user is about to see is loaded, and generating more
+        // prefetch frames of this (expensive) item would exceed the I/O
+        // budget of the hover event. Further frames are loaded when the user
+        // scrubs on.
+        return;
+    }
+
     KIO::PreviewJob *job = new KIO::PreviewJob({m_hoverSequenceItem}, cacheSize(), &m_enabledPlugins);
 
     job->setSequenceIndex(loadSeqIdx);
@@ -1125,6 +1792,7 @@ void KFileItemModelRolesUpdater::loadNextHoverSequencePreview()
     connect(job, &KIO::PreviewJob::failed, this, &KFileItemModelRolesUpdater::slotHoverSequencePreviewFailed);
     connect(job, &KIO::PreviewJob::finished, this, &KFileItemModelRolesUpdater::slotHoverSequencePreviewJobFinished);
 
+    m_hoverSequenceFrameTimer.start();
     m_hoverSequencePreviewJob = job;
 }
 
@@ -1189,6 +1857,10 @@ void KFileItemModelRolesUpdater::updateChangedItems()
     }
 
     std::sort(visibleChangedIndexes.begin(), visibleChangedIndexes.end());
+    // Process the items which are closest to the viewport first.
+    std::sort(invisibleChangedIndexes.begin(), invisibleChangedIndexes.end(), [this](int a, int b) {
+        return distanceFromVisibleRange(a) < distanceFromVisibleRange(b);
+    });
 
     if (m_previewShown) {
         for (int index : std::as_const(visibleChangedIndexes)) {
@@ -1199,12 +1871,13 @@ void KFileItemModelRolesUpdater::updateChangedItems()
             m_pendingPreviewItems.append(m_model->fileItem(index));
         }
 
-        if (!m_previewJob) {
+        if (m_previewJobs.isEmpty()) {
             startPreviewJob();
         }
     } else {
         const bool resolvingInProgress = !m_pendingIndexes.isEmpty();
         m_pendingIndexes = visibleChangedIndexes + m_pendingIndexes + invisibleChangedIndexes;
+        prioritizePendingIndexes();
         if (!resolvingInProgress) {
             // Trigger the asynchronous resolving of the changed roles.
             m_state = ResolvingAllRoles;
@@ -1219,11 +1892,20 @@ void KFileItemModelRolesUpdater::applySortRole(int index)
     const KFileItem item = m_model->fileItem(index);
 
     if (m_model->sortRole() == "type") {
+        QString type;
         if (!item.isMimeTypeKnown()) {
-            item.determineMimeType();
+            // Maybe the mime type was sniffed in an earlier session, then
+            // the file content does not have to be read again.
+            const QMimeType cachedMimeType = QMimeDatabase().mimeTypeForName(KMimeTypeCache::instance()->mimeType(item));
+            if (cachedMimeType.isValid()) {
+                type = cachedMimeType.comment();
+            } else {
+                item.determineMimeType();
+                KMimeTypeCache::instance()->insert(item);
+            }
         }
 
-        data.insert("type", item.mimeComment());
+        data.insert("type", type.isEmpty() ? item.mimeComment() : type);
     } else if (m_model->sortRole() == "size" && item.isLocalFile() && item.isDir()) {
         startDirectorySizeCounting(item, index);
         return;
@@ -1235,6 +1917,7 @@ void KFileItemModelRolesUpdater::applySortRole(int index)
     disconnect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
     m_model->setData(index, data);
     connect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
+    KFileItemRolesTelemetry::instance()->incrementCounter("resolved.sortRole." + m_model->sortRole());
 }
 
 void KFileItemModelRolesUpdater::applySortProgressToModel()
@@ -1253,6 +1936,8 @@ bool KFileItemModelRolesUpdater::applyResolvedRoles(int index, ResolveHint hint)
     bool iconChanged = false;
     if (!item.isMimeTypeKnown() || !item.isFinalIconKnown()) {
         item.determineMimeType();
+        KMimeTypeCache::instance()->insert(item);
+        KFileItemRolesTelemetry::instance()->incrementCounter("resolved.mimeType");
         iconChanged = true;
     } else if (!m_model->data(index).contains("iconName")) {
         iconChanged = true;
@@ -1370,8 +2055,16 @@ void KFileItemModelRolesUpdater::startDirectorySizeCounting(const KFileItem &ite
         return;
     }
 
+    // Maybe another view of this process has counted this directory already.
+    int cachedCount;
+    long long cachedSize;
+    if (KFileItemRolesCache::instance()->directoryCount(item, &cachedCount, &cachedSize)) {
+        slotDirectoryContentsCountsReceived({{item.localPath(), cachedCount, cachedSize, false}});
+        return;
+    }
+
     // Tell m_directoryContentsCounter that we want to count the items
-    // inside the directory. The result will be received in slotDirectoryContentsCountReceived.
+    // inside the directory. The result will be received in slotDirectoryContentsCountsReceived.
     const QString path = item.localPath();
     const auto priority = index >= m_firstVisibleIndex && index <= m_lastVisibleIndex ? KDirectoryContentsCounter::PathCountPriority::High
                                                                                       : KDirectoryContentsCounter::PathCountPriority::Normal;
@@ -1379,6 +2072,116 @@ void KFileItemModelRolesUpdater::startDirectorySizeCounting(const KFileItem &ite
     m_directoryContentsCounter->scanDirectory(path, priority);
 }
 
+void KFileItemModelRolesUpdater::queueExpandabilityProbe(const KFileItem &item)
+{
+    const QString path = item.localPath();
+    const int sepIndex = path.lastIndexOf(QLatin1Char('/'));
+    const QString parent = sepIndex > 0 ? path.left(sepIndex) : QStringLiteral("/");
+
+    QStringList &siblings = m_pendingExpandabilityProbes[parent];
+    if (!siblings.contains(path)) {
+        siblings.append(path);
+    }
+
+    if (!m_expandabilityProbeTimer->isActive()) {
+        m_expandabilityProbeTimer->start();
+    }
+}
+
+void KFileItemModelRolesUpdater::startExpandabilityProbes()
+{
+    if (m_pendingExpandabilityProbes.isEmpty()) {
+        return;
+    }
+
+    const bool countHiddenFiles = m_model->showHiddenFiles();
+    const bool directoriesOnly = m_model->showDirectoriesOnly();
+
+    for (auto it = m_pendingExpandabilityProbes.constBegin(); it != m_pendingExpandabilityProbes.constEnd(); ++it) {
+        const QStringList paths = it.value();
+
+        auto *watcher = new QFutureWatcher<QList<ExpandabilityProbe>>(this);
+        connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher]() {
+            m_expandabilityProbeWatchers.removeOne(watcher);
+            applyExpandabilityProbes(watcher->result());
+            watcher->deleteLater();
+        });
+        m_expandabilityProbeWatchers.append(watcher);
+
+        watcher->setFuture(QtConcurrent::run([paths, countHiddenFiles, directoriesOnly]() {
+            QList<ExpandabilityProbe> probes;
+            probes.reserve(paths.count());
+
+            for (const QString &path : paths) {
+                ExpandabilityProbe probe{path, false, false};
+#ifndef Q_OS_WIN
+                DIR *dir = ::opendir(QFile::encodeName(path).constData());
+                if (!dir) {
+                    probes.append(probe);
+                    continue;
+                }
+
+                bool unknownTypeCandidates = false;
+                while (const struct dirent *entry = ::readdir(dir)) {
+                    const char *name = entry->d_name;
+                    if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+                        continue;
+                    }
+                    if (!countHiddenFiles && name[0] == '.') {
+                        continue;
+                    }
+                    if (directoriesOnly && entry->d_type != DT_DIR) {
+                        // Symlinks may point to directories, and DT_UNKNOWN
+                        // filesystems do not say what the entry is. Both
+                        // would need a stat() to decide, which is left to
+                        // the fallback counting off this fast path.
+                        if (entry->d_type == DT_LNK || entry->d_type == DT_UNKNOWN) {
+                            unknownTypeCandidates = true;
+                        }
+                        continue;
+                    }
+                    probe.expandable = true;
+                    break;
+                }
+                ::closedir(dir);
+
+                probe.needsFullCount = !probe.expandable && unknownTypeCandidates;
+#else
+                probe.needsFullCount = true;
+#endif
+                probes.append(probe);
+            }
+
+            return probes;
+        }));
+    }
+    m_pendingExpandabilityProbes.clear();
+}
+
+void KFileItemModelRolesUpdater::applyExpandabilityProbes(const QList<ExpandabilityProbe> &probes)
+{
+    disconnect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
+    m_model->beginItemsChangedBatch();
+    for (const ExpandabilityProbe &probe : probes) {
+        const int index = m_model->index(QUrl::fromLocalFile(probe.path));
+        if (index < 0) {
+            continue;
+        }
+
+        if (probe.needsFullCount) {
+            m_directoryContentsCounter->scanDirectory(probe.path, KDirectoryContentsCounter::PathCountPriority::Normal);
+            continue;
+        }
+
+        QHash<QByteArray, QVariant> data;
+        data.insert("isExpandable", probe.expandable);
+        m_model->setData(index, data);
+        KFileItemRolesTelemetry::instance()->incrementCounter("resolved.isExpandable");
+    }
+    m_model->endItemsChangedBatch();
+    connect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
+}
+
 QHash<QByteArray, QVariant> KFileItemModelRolesUpdater::rolesData(const KFileItem &item, int index)
 {
     QHash<QByteArray, QVariant> data;
@@ -1387,7 +2190,14 @@ QHash<QByteArray, QVariant> KFileItemModelRolesUpdater::rolesData(const KFileIte
     const bool getIsExpandableRole = m_roles.contains("isExpandable");
 
     if ((getSizeRole || getIsExpandableRole) && item.isDir()) {
-        startDirectorySizeCounting(item, index);
+        if (!getSizeRole && !item.localPath().isEmpty() && !item.isSlow()) {
+            // Only the expansion arrow is needed. A batched probe that reads
+            // each directory up to its first matching entry answers that
+            // without paying for a full count per folder.
+            queueExpandabilityProbe(item);
+        } else {
+            startDirectorySizeCounting(item, index);
+        }
     }
 
     if (m_roles.contains("extension")) {
@@ -1396,16 +2206,25 @@ QHash<QByteArray, QVariant> KFileItemModelRolesUpdater::rolesData(const KFileIte
     }
 
     if (m_roles.contains("type")) {
-        data.insert("type", item.mimeComment());
+        QString type;
+        if (!item.isMimeTypeKnown()) {
+            const QMimeType cachedMimeType = QMimeDatabase().mimeTypeForName(KMimeTypeCache::instance()->mimeType(item));
+            if (cachedMimeType.isValid()) {
+                type = cachedMimeType.comment();
+            }
+        }
+        data.insert("type", type.isEmpty() ? item.mimeComment() : type);
+        KMimeTypeCache::instance()->insert(item);
     }
 
     QStringList overlays = item.overlays();
-    for (KOverlayIconPlugin *it : std::as_const(m_overlayIconsPlugin)) {
+    for (KOverlayIconPlugin *it : overlayIconPlugins()) {
         overlays.append(it->getOverlays(item.url()));
     }
     if (!overlays.isEmpty()) {
         data.insert("iconOverlays", overlays);
     }
+    m_resolvedOverlays.insert(item.url(), overlays);
 
 #if HAVE_BALOO
     if (m_balooFileMonitor) {
@@ -1416,24 +2235,97 @@ QHash<QByteArray, QVariant> KFileItemModelRolesUpdater::rolesData(const KFileIte
     return data;
 }
 
+const QList<KOverlayIconPlugin *> &KFileItemModelRolesUpdater::overlayIconPlugins()
+{
+    if (!m_overlayIconsPluginLoaded) {
+        m_overlayIconsPluginLoaded = true;
+
+        const auto plugins = KPluginMetaData::findPlugins(QStringLiteral("kf6/overlayicon"), {}, KPluginMetaData::AllowEmptyMetaData);
+        for (const KPluginMetaData &data : plugins) {
+            auto instance = QPluginLoader(data.fileName()).instance();
+            auto plugin = qobject_cast<KOverlayIconPlugin *>(instance);
+            if (plugin) {
+                m_overlayIconsPlugin.append(plugin);
+                connect(plugin, &KOverlayIconPlugin::overlaysChanged, this, &KFileItemModelRolesUpdater::slotOverlaysChanged);
+            } else {
+                // not our/valid plugin, so delete the created object
+                delete instance;
+            }
+        }
+    }
+    return m_overlayIconsPlugin;
+}
+
 void KFileItemModelRolesUpdater::slotOverlaysChanged(const QUrl &url, const QStringList &)
 {
     const KFileItem item = m_model->fileItem(url);
     if (item.isNull()) {
         return;
     }
-    const int index = m_model->index(item);
-    QHash<QByteArray, QVariant> data = m_model->data(index);
-    QStringList overlays = item.overlays();
-    for (KOverlayIconPlugin *it : std::as_const(m_overlayIconsPlugin)) {
-        overlays.append(it->getOverlays(url));
+
+    // Just queue the URL: a cloud-sync plugin on a large sync root emits one
+    // change per file, and recomposing the icon for each of them would cause
+    // a repaint cascade. The updates are applied as one batch by
+    // applyPendingOverlayUpdates().
+    m_pendingOverlayUrls.insert(url);
+    if (!m_overlayUpdateTimer->isActive()) {
+        m_overlayUpdateTimer->start();
     }
-    data.insert("iconOverlays", overlays);
-    m_model->setData(index, data);
+}
+
+void KFileItemModelRolesUpdater::applyPendingOverlayUpdates()
+{
+    QList<std::pair<int, QStringList>> updates;
+    updates.reserve(m_pendingOverlayUrls.count());
+
+    for (const QUrl &url : std::as_const(m_pendingOverlayUrls)) {
+        const KFileItem item = m_model->fileItem(url);
+        if (item.isNull()) {
+            m_resolvedOverlays.remove(url);
+            continue;
+        }
+
+        QStringList overlays = item.overlays();
+        for (KOverlayIconPlugin *it : overlayIconPlugins()) {
+            overlays.append(it->getOverlays(url));
+        }
+
+        // Skip items whose effective overlay set did not change, they do not
+        // need a new icon composition.
+        const auto cached = m_resolvedOverlays.constFind(url);
+        if (cached != m_resolvedOverlays.constEnd() && *cached == overlays) {
+            continue;
+        }
+        m_resolvedOverlays.insert(url, overlays);
+
+        updates.append({m_model->index(item), overlays});
+    }
+    m_pendingOverlayUrls.clear();
+
+    if (updates.isEmpty()) {
+        return;
+    }
+
+    // Apply the updates ordered by index, so that the resulting itemsChanged
+    // notifications of neighbouring items reach the view back-to-back.
+    std::sort(updates.begin(), updates.end(), [](const std::pair<int, QStringList> &a, const std::pair<int, QStringList> &b) {
+        return a.first < b.first;
+    });
+
+    // An overlay change does not invalidate the preview or any other role,
+    // so the own slotItemsChanged() must not re-resolve the items.
+    disconnect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
+    for (const auto &[index, overlays] : std::as_const(updates)) {
+        QHash<QByteArray, QVariant> data;
+        data.insert("iconOverlays", overlays);
+        m_model->setData(index, data);
+    }
+    connect(m_model, &KFileItemModel::itemsChanged, this, &KFileItemModelRolesUpdater::slotItemsChanged);
 }
 
 void KFileItemModelRolesUpdater::updateAllPreviews()
 {
+    cancelPreviewTransforms();
     if (m_state == Paused) {
         m_previewChangedDuringPausing = true;
     } else {
@@ -1444,22 +2336,47 @@ void KFileItemModelRolesUpdater::updateAllPreviews()
 
 void KFileItemModelRolesUpdater::killPreviewJob()
 {
-    if (m_previewJob) {
-        disconnect(m_previewJob, &KIO::PreviewJob::gotPreview, this, &KFileItemModelRolesUpdater::slotGotPreview);
-        disconnect(m_previewJob, &KIO::PreviewJob::failed, this, &KFileItemModelRolesUpdater::slotPreviewFailed);
-        disconnect(m_previewJob, &KIO::PreviewJob::finished, this, &KFileItemModelRolesUpdater::slotPreviewJobFinished);
-        m_previewJob->kill();
-        m_previewJob = nullptr;
+    if (!m_previewJobs.isEmpty()) {
+        for (KIO::PreviewJob *job : std::as_const(m_previewJobs)) {
+            disconnect(job, &KIO::PreviewJob::gotPreview, this, &KFileItemModelRolesUpdater::slotGotPreview);
+            disconnect(job, &KIO::PreviewJob::failed, this, &KFileItemModelRolesUpdater::slotPreviewFailed);
+            disconnect(job, &KIO::PreviewJob::finished, this, &KFileItemModelRolesUpdater::slotPreviewJobFinished);
+            job->kill();
+        }
+        m_previewJobs.clear();
+        m_previewJobStartTimes.clear();
         m_pendingPreviewItems.clear();
     }
 }
 
+int KFileItemModelRolesUpdater::distanceFromVisibleRange(int index) const
+{
+    if (index < m_firstVisibleIndex) {
+        return m_firstVisibleIndex - index;
+    }
+    if (index > m_lastVisibleIndex) {
+        return index - m_lastVisibleIndex;
+    }
+    return 0;
+}
+
+void KFileItemModelRolesUpdater::prioritizePendingIndexes()
+{
+    // A stable sort keeps the relative order of items which are equally far
+    // away from the viewport (e.g. the visible items themselves).
+    std::stable_sort(m_pendingIndexes.begin(), m_pendingIndexes.end(), [this](int a, int b) {
+        return distanceFromVisibleRange(a) < distanceFromVisibleRange(b);
+    });
+}
+
 QList<int> KFileItemModelRolesUpdater::indexesToResolve() const
 {
     const int count = m_model->count();
 
+    const int resolveAllItemsLimit = m_budget.resolveAllItemsLimit();
+
     QList<int> result;
-    result.reserve(qMin(count, (m_lastVisibleIndex - m_firstVisibleIndex + 1) + ResolveAllItemsLimit + (2 * m_maximumVisibleItems)));
+    result.reserve(qMin(count, (m_lastVisibleIndex - m_firstVisibleIndex + 1) + resolveAllItemsLimit + (2 * m_maximumVisibleItems)));
 
     // Add visible items.
     // Resolve files first, their previews are quicker.
@@ -1475,61 +2392,74 @@ QList<int> KFileItemModelRolesUpdater::indexesToResolve() const
 
     result.append(visibleDirs);
 
-    // We need a reasonable upper limit for number of items to resolve after
-    // and before the visible range. m_maximumVisibleItems can be quite large
-    // when using Compact View.
-    const int readAheadItems = qMin(ReadAheadPages * m_maximumVisibleItems, ResolveAllItemsLimit / 2);
-
-    // Add items after the visible range.
-    const int endExtendedVisibleRange = qMin(m_lastVisibleIndex + readAheadItems, count - 1);
-    for (int i = m_lastVisibleIndex + 1; i <= endExtendedVisibleRange; ++i) {
-        result.append(i);
-    }
-
-    // Add items before the visible range in reverse order.
-    const int beginExtendedVisibleRange = qMax(0, m_firstVisibleIndex - readAheadItems);
-    for (int i = m_firstVisibleIndex - 1; i >= beginExtendedVisibleRange; --i) {
-        result.append(i);
+    // Add the remaining items ordered strictly by their distance from the
+    // visible range, alternating between the items below and above it. This
+    // way the items next to the viewport always materialize first, even after
+    // a long scroll jump in a huge directory.
+    int below = m_lastVisibleIndex + 1;
+    int above = m_firstVisibleIndex - 1;
+    int remainingItems = resolveAllItemsLimit - result.count();
+
+    while (remainingItems > 0 && (below < count || above >= 0)) {
+        const int distanceBelow = (below < count) ? below - m_lastVisibleIndex : -1;
+        const int distanceAbove = (above >= 0) ? m_firstVisibleIndex - above : -1;
+        if (distanceBelow >= 0 && (distanceAbove < 0 || distanceBelow <= distanceAbove)) {
+            result.append(below);
+            ++below;
+        } else {
+            result.append(above);
+            --above;
+        }
+        --remainingItems;
     }
 
-    // Add items on the last page.
-    const int beginLastPage = qMax(endExtendedVisibleRange + 1, count - m_maximumVisibleItems);
+    // Add items on the last page, so that jumping to the end of the
+    // directory shows final icons right away.
+    const int beginLastPage = qMax(below, count - m_maximumVisibleItems);
     for (int i = beginLastPage; i < count; ++i) {
         result.append(i);
     }
 
     // Add items on the first page.
-    const int endFirstPage = qMin(beginExtendedVisibleRange, m_maximumVisibleItems);
+    const int endFirstPage = qMin(above + 1, m_maximumVisibleItems);
     for (int i = 0; i < endFirstPage; ++i) {
         result.append(i);
     }
 
-    // Continue adding items until ResolveAllItemsLimit is reached.
-    int remainingItems = ResolveAllItemsLimit - result.count();
-
-    for (int i = endExtendedVisibleRange + 1; i < beginLastPage && remainingItems > 0; ++i) {
-        result.append(i);
-        --remainingItems;
-    }
-
-    for (int i = beginExtendedVisibleRange - 1; i >= endFirstPage && remainingItems > 0; --i) {
-        result.append(i);
-        --remainingItems;
-    }
-
     return result;
 }
 
 void KFileItemModelRolesUpdater::trimHoverSequenceLoadedItems()
 {
-    static const size_t maxLoadedItems = 20;
+    // The eviction is sized in bytes instead of items: a few 4K video items
+    // would otherwise hold many times the memory of dozens of small
+    // thumbnails while still counting as few items.
+    const auto bytesOfItem = [this](const KFileItem &item) -> qint64 {
+        const int index = m_model->index(item);
+        if (index < 0) {
+            return 0;
+        }
+
+        const QVector<QPixmap> pixmaps = m_model->data(index).value("hoverSequencePixmaps").value<QVector<QPixmap>>();
+        qint64 bytes = 0;
+        for (const QPixmap &pixmap : pixmaps) {
+            bytes += static_cast<qint64>(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+        }
+        return bytes;
+    };
+
+    qint64 totalBytes = 0;
+    for (const KFileItem &item : m_hoverSequenceLoadedItems) {
+        totalBytes += bytesOfItem(item);
+    }
 
-    size_t loadedItems = m_hoverSequenceLoadedItems.size();
-    while (loadedItems > maxLoadedItems) {
+    // Keep at least the item at the back of the list, it is the one being
+    // hovered right now.
+    while (totalBytes > MaxHoverSequenceCacheBytes && m_hoverSequenceLoadedItems.size() > 1) {
         const KFileItem item = m_hoverSequenceLoadedItems.front();
+        totalBytes -= bytesOfItem(item);
 
         m_hoverSequenceLoadedItems.pop_front();
-        loadedItems--;
 
         const int index = m_model->index(item);
         if (index >= 0) {
@@ -15,12 +15,17 @@
 #include "config-dolphin.h"
 #include <KFileItem>
 
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QImage>
 #include <QObject>
 #include <QSet>
+#include "private/kdirectorycontentscounter.h"
+#include "private/kfileitemrolesbudget.h"
+
 #include <QSize>
 #include <QStringList>
 
-class KDirectoryContentsCounter;
 class KFileItemModel;
 class QPixmap;
 class QTimer;
@@ -55,14 +60,15 @@ class FileMonitor;
  * Determining the roles is done in several phases:
  *
  * 1.   If the sort role is "slow", it is determined for all items. If this
- *      cannot be finished synchronously in 200 ms, the remaining items are
- *      handled asynchronously by \a resolveNextSortRole().
+ *      cannot be finished synchronously within the time slice granted by the
+ *      budget(), the remaining items are handled asynchronously by
+ *      \a resolveNextSortRole().
  *
  * 2.   The function startUpdating(), which is called if either the sort role
  *      has been successfully determined for all items, or items are inserted
  *      in the view, or the visible items might have changed because items
  *      were removed or moved, tries to determine the icons for all visible
- *      items synchronously for 200 ms. Then:
+ *      items synchronously within the budget's time slice. Then:
  *
  *      (a) If previews are disabled, icons and all other roles are determined
  *          asynchronously for the interesting items. This is done by the
@@ -100,6 +106,14 @@ public:
 
     void setMaximumVisibleItems(int count);
 
+    /**
+     * If \a fast is set to true the view is being scrolled so quickly that
+     * generating previews for the passing ranges would be wasted I/O. Only
+     * the cheap icon roles of the visible items are resolved until the
+     * scrolling settles, then the queues are rebuilt for the final viewport.
+     */
+    void setScrollingFast(bool fast);
+
     /**
      * If \a show is set to true, the "iconPixmap" role will be filled with a preview
      * of the file. If \a show is false the MIME type icon will be used for the "iconPixmap"
@@ -124,6 +138,28 @@ public:
     void setPaused(bool paused);
     bool isPaused() const;
 
+    /**
+     * If \a suspended is set to true the asynchronous resolving of roles and the
+     * generation of previews are stopped until the suspension is lifted again.
+     * In contrast to setPaused(), which the view toggles around internal
+     * transactions, the suspension is driven by whether the view is visible to
+     * the user at all, e.g. because its tab is in the background or its window
+     * is minimized. While suspended, setPaused(false) calls only take effect
+     * once the suspension is lifted, and state changes are remembered and
+     * handled afterwards just like during a pause.
+     */
+    void setSuspended(bool suspended);
+    bool isSuspended() const;
+
+    /**
+     * Drops the preview pixmaps of all items except a screenful around the
+     * visible range, regardless of the usual memory budget. Called for views
+     * in background tabs when the session is under memory pressure; the
+     * previews are regenerated by the regular scheduling when the view
+     * becomes visible again.
+     */
+    void trimPreviews();
+
     /**
      * Sets the roles that should be resolved asynchronously.
      */
@@ -178,6 +214,27 @@ public:
      */
     void setHoverSequenceState(const QUrl &itemUrl, int seqIdx);
 
+    /**
+     * @return The policy object that decides how long the updater may block
+     *         the main thread per tick and how many items are resolved
+     *         eagerly. Adapts itself to the measured per-item cost, and can
+     *         be tuned at runtime.
+     */
+    KFileItemRolesBudget &budget();
+
+    /**
+     * @return The current depths of the internal work queues, keyed by queue
+     *         name. Used by KFileItemRolesTelemetry to expose them over
+     *         D-Bus, see DBusInterface::GetRolesUpdaterTelemetry().
+     */
+    QHash<QByteArray, int> telemetryQueueDepths() const;
+
+    /**
+     * @return An estimate of the bytes held by the internal work queues and
+     *         bookkeeping sets of this updater. Reported to KMemoryAccounting.
+     */
+    qint64 estimatedMemoryUsageBytes() const;
+
 Q_SIGNALS:
     void previewJobFinished(); // For unit testing
 
@@ -238,10 +295,18 @@ private Q_SLOTS:
     void slotHoverSequencePreviewJobFinished();
 
     /**
-     * Is invoked when one of the KOverlayIconPlugin emit the signal that an overlay has changed
+     * Is invoked when one of the KOverlayIconPlugin emit the signal that an overlay has changed.
+     * The URL is only queued; the updates are applied as one batch when the
+     * m_overlayUpdateTimer expires.
      */
     void slotOverlaysChanged(const QUrl &url, const QStringList &);
 
+    /**
+     * Applies the overlay updates queued by slotOverlaysChanged() in one
+     * pass, skipping items whose effective overlay set did not change.
+     */
+    void applyPendingOverlayUpdates();
+
     /**
      * Resolves the sort role of the next item in m_pendingSortRole, applies it
      * to the model, and invokes itself if there are any pending items left. If
@@ -266,7 +331,7 @@ private Q_SLOTS:
     void applyChangedBalooRoles(const QString &file);
     void applyChangedBalooRolesForItem(const KFileItem &file);
 
-    void slotDirectoryContentsCountReceived(const QString &path, int count, long long size);
+    void slotDirectoryContentsCountsReceived(const QList<KDirectoryContentsCounter::DirectoryCountResult> &results);
 
 private:
     /**
@@ -275,10 +340,10 @@ private:
     void startUpdating();
 
     /**
-     * Loads the icons for the visible items. After 200 ms, the function
-     * stops determining mime types and only loads preliminary icons.
-     * This is a compromise that prevents that
-     * (a) the GUI is blocked for more than 200 ms, and
+     * Loads the icons for the visible items. After the time slice granted by
+     * the budget() has passed, the function stops determining mime types and
+     * only loads preliminary icons. This is a compromise that prevents that
+     * (a) the GUI is blocked for a noticeable amount of time, and
      * (b) "unknown" icons could be shown in the view.
      */
     void updateVisibleIcons();
@@ -293,14 +358,93 @@ private:
     void startPreviewJob();
 
     /**
-     * Transforms a raw preview image, applying scale and frame.
+     * Transforms a raw preview image synchronously, applying scale and frame.
+     * Only used for hover sequence frames, whose order-sensitive appends must
+     * not be reordered; all other previews are transformed on the thread
+     * pool, see startPreviewTransforms().
      *
      * @param pixmap A raw preview image from a PreviewJob.
-     * @param overlays the overlays to add to the pixmap
      * @return The scaled and decorated preview image.
      */
     QPixmap transformPreviewPixmap(const QPixmap &pixmap);
 
+    /**
+     * A cached preview together with everything that is needed to scale and
+     * frame it off the GUI thread.
+     */
+    struct PreviewTransform {
+        KFileItem item;
+        QImage image;
+        bool hasAlpha;
+        /**
+         * True for previews freshly delivered by a PreviewJob (see
+         * slotGotPreview()): applyTransformedPreview() then also resolves the
+         * remaining roles and marks the item as finished, in addition to
+         * setting the transformed preview.
+         */
+        bool fresh = false;
+        /** Only meaningful when fresh: whether the delivering thumbnailer handles sequences. */
+        bool supportsSequencing = false;
+    };
+
+    /**
+     * Scales and frames the cached previews in \a transforms on the thread
+     * pool, keeping their (visible-first) order. Each result is applied by
+     * applyTransformedPreview() as soon as it is ready; until then the view
+     * keeps drawing the previous pixmap, cheaply scaled at paint time.
+     */
+    void startPreviewTransforms(const QList<PreviewTransform> &transforms);
+
+    /**
+     * Applies an asynchronously transformed preview to the model. For fresh
+     * previews (see PreviewTransform::fresh) the remaining roles are resolved
+     * and the item is marked as finished as well.
+     */
+    void applyTransformedPreview(const PreviewTransform &transform);
+
+    /**
+     * Cancels all preview transforms and in-process decodes that are still
+     * in flight. Must be called whenever the target icon size, device pixel
+     * ratio or preview settings change, so that no stale result lands
+     * afterwards.
+     */
+    void cancelPreviewTransforms();
+
+    /**
+     * A preview decoded in-process, see startInProcessPreviewDecodes().
+     */
+    struct PreviewDecode {
+        KFileItem item;
+        /** Raw preview at cache size. Null if decoding failed. */
+        QImage image;
+        /** Scaled and framed for display. */
+        QImage transformedImage;
+    };
+
+    /**
+     * @return Whether a preview for \a item can be generated in-process
+     *         instead of going through an external thumbnailer: the item
+     *         must be a fast local file of a plain image format, previews
+     *         for images must be enabled and the file size limit respected.
+     */
+    bool canDecodePreviewInProcess(const KFileItem &item) const;
+
+    /**
+     * Takes the items eligible for in-process decoding out of
+     * m_pendingPreviewItems and decodes them at target resolution on the
+     * thread pool. Scaled decoding lets e.g. the JPEG decoder skip most of
+     * the work, and the external thumbnailer round trip of PreviewJob is
+     * avoided entirely. Only active with the opt-in, see
+     * m_inProcessImageDecoding.
+     */
+    void startInProcessPreviewDecodes();
+
+    /**
+     * Applies an in-process decoded preview to the model, mirroring what
+     * slotGotPreview() does for previews from a PreviewJob.
+     */
+    void applyInProcessDecode(const PreviewDecode &decode);
+
     /**
      * Starts a PreviewJob for loading the next hover sequence image.
      */
@@ -328,6 +472,14 @@ private:
     bool applyResolvedRoles(int index, ResolveHint hint);
     QHash<QByteArray, QVariant> rolesData(const KFileItem &item, int index);
 
+    /**
+     * Loads the KOverlayIconPlugins on first use and returns them. Loading
+     * the plugin binaries is deferred until the roles of an item are actually
+     * resolved, so that constructing a view (e.g. during startup) does not
+     * pay for plugins which most directories never trigger.
+     */
+    const QList<KOverlayIconPlugin *> &overlayIconPlugins();
+
     /**
      * Must be invoked if a property has been changed that affects
      * the look of the preview. Takes care to update all previews.
@@ -336,6 +488,22 @@ private:
 
     void killPreviewJob();
 
+    /**
+     * @return The distance of \a index from the visible index range, or 0
+     *         if the index is inside the range.
+     */
+    int distanceFromVisibleRange(int index) const;
+
+    /**
+     * Reorders m_pendingIndexes so that the items closest to the visible
+     * index range are resolved first.
+     */
+    void prioritizePendingIndexes();
+
+    /**
+     * @return The indexes to resolve, ordered by their distance from the
+     *         visible index range.
+     */
     QList<int> indexesToResolve() const;
 
     void trimHoverSequenceLoadedItems();
@@ -351,10 +519,56 @@ private:
      */
     void startDirectorySizeCounting(const KFileItem &item, int index);
 
+    /**
+     * Result of one directory handled by startExpandabilityProbes().
+     */
+    struct ExpandabilityProbe {
+        QString path;
+        bool expandable;
+        /** The dirent type hints were inconclusive (e.g. DT_UNKNOWN on a
+         * filesystem that does not fill d_type), so the full per-item
+         * counting has to decide. */
+        bool needsFullCount;
+    };
+
+    /**
+     * Queues the directory \a item for a batched expandability probe. When
+     * only "isExpandable" is requested (no size counting), running a full
+     * directory count per folder is wasted I/O: deciding whether the
+     * expansion arrow shows only needs to know whether the directory has at
+     * least one matching entry. The queued directories are grouped by
+     * parent and probed together on the thread pool, where each directory
+     * is read only up to the first entry that proves it expandable - on
+     * filesystems that fill the dirent type hints this needs no stat() at
+     * all, which removes the arrow pop-in on slow mounts.
+     */
+    void queueExpandabilityProbe(const KFileItem &item);
+
+    /**
+     * Runs the queued expandability probes per parent directory on the
+     * thread pool. Each finished parent batch is applied as one ranged
+     * model update by applyExpandabilityProbes().
+     */
+    void startExpandabilityProbes();
+
+    /**
+     * Applies one batch of probe results to the model. Directories whose
+     * probe was inconclusive fall back to the per-item counting of
+     * m_directoryContentsCounter.
+     */
+    void applyExpandabilityProbes(const QList<ExpandabilityProbe> &probes);
+
     enum State { Idle, Paused, ResolvingSortRole, ResolvingAllRoles, PreviewJobRunning };
 
     State m_state;
 
+    // Property for setSuspended()/isSuspended().
+    bool m_suspended;
+    // The pause state the view asked for most recently. While suspended the
+    // updater stays paused regardless, and this is what setSuspended(false)
+    // falls back to.
+    bool m_pauseRequested;
+
     // Property changes during pausing must be remembered to be able
     // to react when unpausing again:
     bool m_previewChangedDuringPausing;
@@ -363,6 +577,10 @@ private:
 
     // Property for setPreviewsShown()/previewsShown().
     bool m_previewShown;
+    bool m_scrollingFast;
+
+    // Adaptive budget for the synchronous slices of work, see budget().
+    KFileItemRolesBudget m_budget;
 
     // Property for setEnlargeSmallPreviews()/enlargeSmallPreviews()
     bool m_enlargeSmallPreviews;
@@ -387,6 +605,12 @@ private:
     QStringList m_enabledPlugins;
     qulonglong m_localFileSizePreviewLimit;
 
+    // Opt-in ("InProcessImageDecoding" in the PreviewSettings group): decode
+    // previews for plain image formats directly on the thread pool instead
+    // of round-tripping through the external thumbnailer processes of
+    // PreviewJob, see startInProcessPreviewDecodes().
+    bool m_inProcessImageDecoding;
+
     // Items for which the sort role still has to be determined.
     QSet<KFileItem> m_pendingSortRoleItems;
 
@@ -395,10 +619,25 @@ private:
     QList<int> m_pendingIndexes;
 
     // Items which have been left over from the last call of startPreviewJob().
-    // A new preview job will be started from them once the first one finishes.
+    // New preview jobs will be started from them once a running one finishes.
     KFileItemList m_pendingPreviewItems;
 
-    KIO::PreviewJob *m_previewJob;
+    // The pending preview items are sharded across several concurrent jobs,
+    // scaled to the number of CPU cores. See startPreviewJob().
+    QList<KIO::PreviewJob *> m_previewJobs;
+
+    // Start time of each running preview job in msecs since the epoch, used
+    // to record the job duration in the latency telemetry.
+    QHash<KIO::PreviewJob *, qint64> m_previewJobStartTimes;
+
+    // Watchers for the batches of cached previews which are scaled and
+    // framed on the thread pool, see startPreviewTransforms().
+    QList<QFutureWatcher<PreviewTransform> *> m_previewTransformWatchers;
+
+    // Watchers for the batches of image files which are decoded in-process
+    // on the thread pool, see startInProcessPreviewDecodes(). The preview
+    // pass only finishes once the preview jobs and these are all done.
+    QList<QFutureWatcher<PreviewDecode> *> m_previewDecodeWatchers;
 
     // Info about the item that the user currently hovers, and the current sequence
     // index for thumb generation.
@@ -408,6 +647,11 @@ private:
     int m_hoverSequenceNumSuccessiveFailures;
     std::list<KFileItem> m_hoverSequenceLoadedItems;
 
+    // Time in ms spent generating frames for the current hover event. Limits
+    // how far ahead frames are prefetched, see loadNextHoverSequencePreview().
+    qint64 m_hoverSequenceSpentIoMs;
+    QElapsedTimer m_hoverSequenceFrameTimer;
+
     // When downloading or copying large files, the slot slotItemsChanged()
     // will be called periodically within a quite short delay. To prevent
     // a high CPU-load by generating e.g. previews for each notification, the update
@@ -419,9 +663,29 @@ private:
     // Items which have not been changed repeatedly recently.
     QSet<KFileItem> m_changedItems;
 
+    // Overlay changes from the KOverlayIconPlugins arrive per URL and can
+    // come in storms, e.g. when a cloud-sync plugin updates the sync status
+    // of a whole directory tree. The URLs are collected and applied in one
+    // batch; m_resolvedOverlays remembers the last applied overlay set per
+    // URL so that unchanged items are skipped.
+    QTimer *m_overlayUpdateTimer;
+    QSet<QUrl> m_pendingOverlayUrls;
+    QHash<QUrl, QStringList> m_resolvedOverlays;
+
     KDirectoryContentsCounter *m_directoryContentsCounter;
 
+    // Directories queued for a batched expandability probe, grouped by
+    // parent path so that the probes of siblings run as one task with good
+    // metadata locality, which matters on network mounts. See
+    // queueExpandabilityProbe().
+    QTimer *m_expandabilityProbeTimer;
+    QHash<QString, QStringList> m_pendingExpandabilityProbes;
+    QList<QFutureWatcher<QList<ExpandabilityProbe>> *> m_expandabilityProbeWatchers;
+
+    // Only valid once m_overlayIconsPluginLoaded is true, see
+    // overlayIconPlugins().
     QList<KOverlayIconPlugin *> m_overlayIconsPlugin;
+    bool m_overlayIconsPluginLoaded;
 
 #if HAVE_BALOO
     Baloo::FileMonitor *m_balooFileMonitor;
@@ -8,8 +8,11 @@
 
 #include "kitemlistcontainer.h"
 
+#include "dolphin_generalsettings.h"
+#include "dolphinstartupprofiler.h"
 #include "kitemlistcontroller.h"
 #include "kitemlistview.h"
+#include "private/kitemlistperformancehud.h"
 #include "private/kitemlistsmoothscroller.h"
 
 #ifndef QT_NO_ACCESSIBILITY
@@ -22,6 +25,18 @@
 #include <QScrollBar>
 #include <QScroller>
 #include <QStyleOption>
+#include <QTimer>
+
+namespace
+{
+// Minimum time in ms between two scrollbar range updates which are driven by
+// growth of the view's maximum offsets. While a directory streams in, every
+// inserted batch grows the maximum scroll offset; updating the scrollbar
+// geometry more than once per frame interval only causes repaints of
+// intermediate ranges nobody ever sees and perturbs running smooth-scroll
+// animations. See KItemListContainer::scheduleScrollBarRangeUpdate().
+const int ScrollBarRangeUpdateInterval = 1000 / 60;
+}
 
 /**
  * Replaces the default viewport of KItemListContainer by a
@@ -61,13 +76,24 @@ KItemListContainer::KItemListContainer(KItemListController *controller, QWidget
     , m_horizontalSmoothScroller(nullptr)
     , m_verticalSmoothScroller(nullptr)
     , m_scroller(nullptr)
+    , m_pendingScrollOffsetScrollBarUpdate(false)
+    , m_pendingItemOffsetScrollBarUpdate(false)
 {
     Q_ASSERT(controller);
     controller->setParent(this);
 
+    m_scrollBarRangeUpdateTimer = new QTimer(this);
+    m_scrollBarRangeUpdateTimer->setSingleShot(true);
+    connect(m_scrollBarRangeUpdateTimer, &QTimer::timeout, this, &KItemListContainer::updateScrollBarRanges);
+
     QGraphicsView *graphicsView = new KItemListContainerViewport(new QGraphicsScene(this), this);
     setViewport(graphicsView);
 
+    if (GeneralSettings::renderingPerformanceHud()) {
+        // The HUD deletes itself with its parent, the inner viewport that the scene is rendered into.
+        new KItemListPerformanceHud(controller, graphicsView->viewport());
+    }
+
     m_horizontalSmoothScroller = new KItemListSmoothScroller(horizontalScrollBar(), this);
     m_verticalSmoothScroller = new KItemListSmoothScroller(verticalScrollBar(), this);
 
@@ -160,6 +186,7 @@ void KItemListContainer::showEvent(QShowEvent *event)
 {
     QAbstractScrollArea::showEvent(event);
     updateGeometries();
+    DolphinStartupProfiler::instance()->recordPhase(DolphinStartupProfiler::FirstViewVisible);
 }
 
 void KItemListContainer::resizeEvent(QResizeEvent *event)
@@ -239,25 +266,32 @@ void KItemListContainer::slotViewChanged(KItemListView *current, KItemListView *
         scene->removeItem(previous);
         disconnect(previous, &KItemListView::scrollOrientationChanged, this, &KItemListContainer::slotScrollOrientationChanged);
         disconnect(previous, &KItemListView::scrollOffsetChanged, this, &KItemListContainer::updateScrollOffsetScrollBar);
-        disconnect(previous, &KItemListView::maximumScrollOffsetChanged, this, &KItemListContainer::updateScrollOffsetScrollBar);
+        disconnect(previous, &KItemListView::maximumScrollOffsetChanged, this, &KItemListContainer::scheduleScrollOffsetScrollBarUpdate);
         disconnect(previous, &KItemListView::itemOffsetChanged, this, &KItemListContainer::updateItemOffsetScrollBar);
-        disconnect(previous, &KItemListView::maximumItemOffsetChanged, this, &KItemListContainer::updateItemOffsetScrollBar);
+        disconnect(previous, &KItemListView::maximumItemOffsetChanged, this, &KItemListContainer::scheduleItemOffsetScrollBarUpdate);
         disconnect(previous, &KItemListView::scrollTo, this, &KItemListContainer::scrollTo);
         disconnect(m_horizontalSmoothScroller, &KItemListSmoothScroller::scrollingStopped, previous, &KItemListView::scrollingStopped);
         disconnect(m_verticalSmoothScroller, &KItemListSmoothScroller::scrollingStopped, previous, &KItemListView::scrollingStopped);
+        disconnect(m_horizontalSmoothScroller, &KItemListSmoothScroller::scrollVelocityChanged, previous, &KItemListView::scrollVelocityChanged);
+        disconnect(m_verticalSmoothScroller, &KItemListSmoothScroller::scrollVelocityChanged, previous, &KItemListView::scrollVelocityChanged);
         m_horizontalSmoothScroller->setTargetObject(nullptr);
         m_verticalSmoothScroller->setTargetObject(nullptr);
+        m_scrollBarRangeUpdateTimer->stop();
+        m_pendingScrollOffsetScrollBarUpdate = false;
+        m_pendingItemOffsetScrollBarUpdate = false;
     }
     if (current) {
         scene->addItem(current);
         connect(current, &KItemListView::scrollOrientationChanged, this, &KItemListContainer::slotScrollOrientationChanged);
         connect(current, &KItemListView::scrollOffsetChanged, this, &KItemListContainer::updateScrollOffsetScrollBar);
-        connect(current, &KItemListView::maximumScrollOffsetChanged, this, &KItemListContainer::updateScrollOffsetScrollBar);
+        connect(current, &KItemListView::maximumScrollOffsetChanged, this, &KItemListContainer::scheduleScrollOffsetScrollBarUpdate);
         connect(current, &KItemListView::itemOffsetChanged, this, &KItemListContainer::updateItemOffsetScrollBar);
-        connect(current, &KItemListView::maximumItemOffsetChanged, this, &KItemListContainer::updateItemOffsetScrollBar);
+        connect(current, &KItemListView::maximumItemOffsetChanged, this, &KItemListContainer::scheduleItemOffsetScrollBarUpdate);
         connect(current, &KItemListView::scrollTo, this, &KItemListContainer::scrollTo);
         connect(m_horizontalSmoothScroller, &KItemListSmoothScroller::scrollingStopped, current, &KItemListView::scrollingStopped);
         connect(m_verticalSmoothScroller, &KItemListSmoothScroller::scrollingStopped, current, &KItemListView::scrollingStopped);
+        connect(m_horizontalSmoothScroller, &KItemListSmoothScroller::scrollVelocityChanged, current, &KItemListView::scrollVelocityChanged);
+        connect(m_verticalSmoothScroller, &KItemListSmoothScroller::scrollVelocityChanged, current, &KItemListView::scrollVelocityChanged);
 
         m_horizontalSmoothScroller->setTargetObject(current);
         m_verticalSmoothScroller->setTargetObject(current);
@@ -372,6 +406,51 @@ void KItemListContainer::updateItemOffsetScrollBar()
     }
 }
 
+void KItemListContainer::scheduleScrollOffsetScrollBarUpdate()
+{
+    m_pendingScrollOffsetScrollBarUpdate = true;
+    scheduleScrollBarRangeUpdate();
+}
+
+void KItemListContainer::scheduleItemOffsetScrollBarUpdate()
+{
+    m_pendingItemOffsetScrollBarUpdate = true;
+    scheduleScrollBarRangeUpdate();
+}
+
+void KItemListContainer::scheduleScrollBarRangeUpdate()
+{
+    if (m_scrollBarRangeUpdateTimer->isActive()) {
+        // An update is already scheduled and will use the newest maximum offsets once it fires.
+        return;
+    }
+
+    const qint64 timeSinceLastUpdate = m_timeSinceScrollBarRangeUpdate.isValid() ? m_timeSinceScrollBarRangeUpdate.elapsed() : ScrollBarRangeUpdateInterval;
+    if (timeSinceLastUpdate < ScrollBarRangeUpdateInterval) {
+        // The maximum offsets grow faster than frames are drawn, which happens while a directory streams in batch by batch. The scrollbar updates for
+        // the intermediate ranges are skipped; the one at the end of the frame interval picks up whatever maximum is newest then, including the final
+        // one when the load completes.
+        m_scrollBarRangeUpdateTimer->start(ScrollBarRangeUpdateInterval - timeSinceLastUpdate);
+        return;
+    }
+
+    updateScrollBarRanges();
+}
+
+void KItemListContainer::updateScrollBarRanges()
+{
+    m_timeSinceScrollBarRangeUpdate.start();
+
+    if (m_pendingScrollOffsetScrollBarUpdate) {
+        m_pendingScrollOffsetScrollBarUpdate = false;
+        updateScrollOffsetScrollBar();
+    }
+    if (m_pendingItemOffsetScrollBarUpdate) {
+        m_pendingItemOffsetScrollBarUpdate = false;
+        updateItemOffsetScrollBar();
+    }
+}
+
 void KItemListContainer::stopScroller()
 {
     m_scroller->stop();
@@ -12,12 +12,14 @@
 #include "dolphin_export.h"
 
 #include <QAbstractScrollArea>
+#include <QElapsedTimer>
 
 class KItemListController;
 class KItemListSmoothScroller;
 class KItemListView;
 class KItemModelBase;
 class QScroller;
+class QTimer;
 
 /**
  * @brief Provides a QWidget based scrolling view for a KItemListController.
@@ -61,12 +63,31 @@ private Q_SLOTS:
     void scrollTo(qreal offset);
     void updateScrollOffsetScrollBar();
     void updateItemOffsetScrollBar();
+
+    /**
+     * Called when the maximum scroll offset or the maximum item offset of the
+     * view changed, which happens once per inserted batch while a directory
+     * streams in. Unlike scroll position changes, which are applied to the
+     * scrollbars immediately, range growth is coalesced to at most one
+     * scrollbar update per frame interval: intermediate ranges only schedule a
+     * deferred update which picks up whatever maximum is newest when it fires,
+     * including the final one when the load completes.
+     */
+    void scheduleScrollOffsetScrollBarUpdate();
+    void scheduleItemOffsetScrollBarUpdate();
+
     void stopScroller();
 
 private:
     void updateGeometries();
     void updateSmoothScrollers(Qt::Orientation orientation);
 
+    /** Shared throttling logic of scheduleScrollOffsetScrollBarUpdate() and scheduleItemOffsetScrollBarUpdate(). */
+    void scheduleScrollBarRangeUpdate();
+
+    /** Applies the scrollbar range updates which were deferred by scheduleScrollBarRangeUpdate(). */
+    void updateScrollBarRanges();
+
     /**
      * Helper method for updateScrollOffsetScrollBar(). Updates the scrollbar-policy
      * to Qt::ScrollBarAlwaysOn for cases where turning off the scrollbar might lead
@@ -80,6 +101,12 @@ private:
     KItemListSmoothScroller *m_horizontalSmoothScroller;
     KItemListSmoothScroller *m_verticalSmoothScroller;
     QScroller *m_scroller;
+
+    // Coalesce scrollbar range updates while items stream in, see scheduleScrollBarRangeUpdate().
+    QTimer *m_scrollBarRangeUpdateTimer;
+    QElapsedTimer m_timeSinceScrollBarRangeUpdate;
+    bool m_pendingScrollOffsetScrollBarUpdate;
+    bool m_pendingItemOffsetScrollBarUpdate;
 };
 
 #endif
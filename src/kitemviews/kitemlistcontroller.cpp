@@ -52,6 +52,8 @@ KItemListController::KItemListController(KItemModelBase *model, KItemListView *v
     , m_pressedIndex(std::nullopt)
     , m_pressedMouseGlobalPos()
     , m_autoActivationTimer(nullptr)
+    , m_hoverUpdateTimer(nullptr)
+    , m_pendingHoverPos()
     , m_swipeGesture(Qt::CustomGesture)
     , m_twoFingerTapGesture(Qt::CustomGesture)
     , m_oldSelection()
@@ -67,6 +69,11 @@ KItemListController::KItemListController(KItemModelBase *model, KItemListView *v
     m_autoActivationTimer->setInterval(750);
     connect(m_autoActivationTimer, &QTimer::timeout, this, &KItemListController::slotAutoActivationTimeout);
 
+    m_hoverUpdateTimer = new QTimer(this);
+    m_hoverUpdateTimer->setSingleShot(true);
+    m_hoverUpdateTimer->setInterval(1000 / 60);
+    connect(m_hoverUpdateTimer, &QTimer::timeout, this, &KItemListController::slotHoverUpdateTimeout);
+
     setModel(model);
     setView(view);
 
@@ -577,6 +584,15 @@ void KItemListController::slotAutoActivationTimeout()
     }
 }
 
+void KItemListController::slotHoverUpdateTimeout()
+{
+    if (m_hoverUpdatePending && m_model && m_view) {
+        m_hoverUpdatePending = false;
+        processHoverMove(m_pendingHoverPos);
+        m_hoverUpdateTimer->start();
+    }
+}
+
 bool KItemListController::inputMethodEvent(QInputMethodEvent *event)
 {
     Q_UNUSED(event)
@@ -779,6 +795,8 @@ bool KItemListController::contextMenuEvent(QContextMenuEvent *event)
     }
 
     // Remove any hover highlights so the context menu doesn't look like it applies to a row.
+    m_hoverUpdateTimer->stop();
+    m_hoverUpdatePending = false;
     const auto widgets = m_view->visibleItemListWidgets();
     for (KItemListWidget *widget : widgets) {
         if (widget->isHovered()) {
@@ -795,6 +813,10 @@ bool KItemListController::dragEnterEvent(QGraphicsSceneDragDropEvent *event, con
     Q_UNUSED(event)
     Q_UNUSED(transform)
 
+    // Item hovering is handled by dragMoveEvent() while a drag is active, so a hover update that is still pending must not be applied anymore.
+    m_hoverUpdateTimer->stop();
+    m_hoverUpdatePending = false;
+
     DragAndDropHelper::clearUrlListMatchesUrlCache();
 
     return false;
@@ -938,11 +960,24 @@ bool KItemListController::hoverEnterEvent(QGraphicsSceneHoverEvent *event, const
 
 bool KItemListController::hoverMoveEvent(QGraphicsSceneHoverEvent *event, const QTransform &transform)
 {
-    Q_UNUSED(transform)
     if (!m_model || !m_view) {
         return false;
     }
 
+    // Hover events can arrive with every input event, which can be a multiple of the display refresh rate. All events that arrive while m_hoverUpdateTimer is
+    // running are coalesced into a single hover state update per frame: Only the most recent position is applied once the timer times out.
+    m_pendingHoverPos = transform.map(event->pos());
+    if (m_hoverUpdateTimer->isActive()) {
+        m_hoverUpdatePending = true;
+    } else {
+        processHoverMove(m_pendingHoverPos);
+        m_hoverUpdateTimer->start();
+    }
+    return false;
+}
+
+void KItemListController::processHoverMove(const QPointF &pos)
+{
     // We identify the widget whose expansionArea had been hovered before this hoverMoveEvent() triggered.
     // we can't use hoveredWidget() here (it handles the icon+text rect, not the expansion rect)
     // like hoveredWidget(), we find the hovered widget for the expansion rect
@@ -968,7 +1003,6 @@ bool KItemListController::hoverMoveEvent(QGraphicsSceneHoverEvent *event, const
         }
     };
 
-    const QPointF pos = transform.map(event->pos());
     if (KItemListWidget *newHoveredWidget = widgetForPos(pos); newHoveredWidget) {
         // something got hovered, work out which part and set hover for the appropriate widget
         const auto mappedPos = newHoveredWidget->mapFromItem(m_view, pos);
@@ -1015,7 +1049,6 @@ bool KItemListController::hoverMoveEvent(QGraphicsSceneHoverEvent *event, const
         unhoverOldHoveredWidget();
         unhoverOldExpansionWidget();
     }
-    return false;
 }
 
 bool KItemListController::hoverLeaveEvent(QGraphicsSceneHoverEvent *event, const QTransform &transform)
@@ -1026,6 +1059,9 @@ bool KItemListController::hoverLeaveEvent(QGraphicsSceneHoverEvent *event, const
     m_mousePress = false;
     m_isTouchEvent = false;
 
+    m_hoverUpdateTimer->stop();
+    m_hoverUpdatePending = false;
+
     if (!m_model || !m_view) {
         return false;
     }
@@ -1376,29 +1412,25 @@ void KItemListController::slotRubberBandChanged()
         }
     }
 
-    // Select all invisible items that intersect with the rubberband. Instead of
-    // iterating all items only the area which might be touched by the rubberband
-    // will be checked.
-    const bool increaseIndex = scrollVertical ? startPos.y() > endPos.y() : startPos.x() > endPos.x();
-
-    int index = increaseIndex ? m_view->lastVisibleIndex() + 1 : m_view->firstVisibleIndex() - 1;
-    bool selectionFinished = false;
-    do {
-        const QRectF widgetRect = m_view->itemRect(index);
-        if (widgetRect.intersects(rubberBandRect)) {
-            selectedItems.insert(index);
+    // Select all invisible items that intersect with the rubberband. The
+    // layouter narrows the candidates down to the rows that are touched by
+    // the rubberband, so the costs per mouse-move event are proportional to
+    // the covered area instead of walking item by item through the model.
+    const std::pair<int, int> candidates = m_view->itemRangeForRect(rubberBandRect);
+    const int firstVisibleIndex = m_view->firstVisibleIndex();
+    const int lastVisibleIndex = m_view->lastVisibleIndex();
+    for (int index = candidates.first; index != -1 && index <= candidates.second; ++index) {
+        if (index >= firstVisibleIndex && index <= lastVisibleIndex) {
+            // The visible items have already been tested above with the
+            // precise selection rectangles of their widgets.
+            index = lastVisibleIndex;
+            continue;
         }
 
-        if (increaseIndex) {
-            ++index;
-            selectionFinished = (index >= m_model->count()) || (scrollVertical && widgetRect.top() > rubberBandRect.bottom())
-                || (!scrollVertical && widgetRect.left() > rubberBandRect.right());
-        } else {
-            --index;
-            selectionFinished = (index < 0) || (scrollVertical && widgetRect.bottom() < rubberBandRect.top())
-                || (!scrollVertical && widgetRect.right() < rubberBandRect.left());
+        if (m_view->itemRect(index).intersects(rubberBandRect)) {
+            selectedItems.insert(index);
         }
-    } while (!selectionFinished);
+    }
 
     if ((QApplication::keyboardModifiers() & Qt::ControlModifier) || m_selectionMode) {
         // If Control is pressed, the selection state of all items in the rubberband is toggled.
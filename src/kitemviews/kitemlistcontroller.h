@@ -237,6 +237,11 @@ private Q_SLOTS:
 
     void slotAutoActivationTimeout();
 
+    /**
+     * Applies the most recent hover position if hover events arrived while m_hoverUpdateTimer was running. @see hoverMoveEvent().
+     */
+    void slotHoverUpdateTimeout();
+
 private:
     /**
      * Creates a QDrag object and initiates a drag-operation.
@@ -299,6 +304,12 @@ private:
      */
     void updateExtendedSelectionRegion();
 
+    /**
+     * Applies the hover state changes for the view position \a pos. Is called at most once per frame by hoverMoveEvent(), which coalesces the hover events
+     * that arrive in between.
+     */
+    void processHoverMove(const QPointF &pos);
+
     bool keyPressEvent(QKeyEvent *event);
     bool inputMethodEvent(QInputMethodEvent *event);
     bool mousePressEvent(QGraphicsSceneMouseEvent *event, const QTransform &transform);
@@ -350,6 +361,15 @@ private:
     bool m_autoActivationEnabled = false;
     QTimer *m_autoActivationTimer;
 
+    /**
+     * Hover events can arrive with every input event, which can be a multiple of the display refresh rate. This timer gates processHoverMove() so that the
+     * hover state is updated at most once per frame no matter how many hover events arrive in between. @see hoverMoveEvent().
+     */
+    QTimer *m_hoverUpdateTimer;
+    /** The position of the most recent hover event. It is applied by slotHoverUpdateTimeout() if m_hoverUpdatePending is true. */
+    QPointF m_pendingHoverPos;
+    bool m_hoverUpdatePending = false;
+
     Qt::GestureType m_swipeGesture;
     Qt::GestureType m_twoFingerTapGesture;
 
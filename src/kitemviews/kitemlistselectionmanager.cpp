@@ -26,7 +26,15 @@ KItemListSelectionManager::~KItemListSelectionManager()
 void KItemListSelectionManager::setCurrentItem(int current)
 {
     const int previous = m_currentItem;
-    const KItemSet previousSelection = selectedItems();
+
+    // The anchored span (m_anchorItem, m_currentItem) is only composed with
+    // m_selectedItems on demand. Materializing the merged set is hence only
+    // required if an anchored selection is active and the selectionChanged
+    // signal might have to be emitted below.
+    KItemSet previousSelection;
+    if (m_isAnchoredSelectionActive) {
+        previousSelection = selectedItems();
+    }
 
     if (m_model && current >= 0 && current < m_model->count()) {
         m_currentItem = current;
@@ -70,9 +78,7 @@ KItemSet KItemListSelectionManager::selectedItems() const
         const int from = qMin(m_anchorItem, m_currentItem);
         const int to = qMax(m_anchorItem, m_currentItem);
 
-        for (int index = from; index <= to; ++index) {
-            selectedItems.insert(index);
-        }
+        selectedItems.insertRange(from, to - from + 1);
     }
 
     return selectedItems;
@@ -114,29 +120,21 @@ void KItemListSelectionManager::setSelected(int index, int count, SelectionMode
 
     count = qMin(count, m_model->count() - index);
 
-    const int endIndex = index + count - 1;
     switch (mode) {
     case Select:
-        for (int i = index; i <= endIndex; ++i) {
-            m_selectedItems.insert(i);
-        }
+        m_selectedItems.insertRange(index, count);
         break;
 
     case Deselect:
-        for (int i = index; i <= endIndex; ++i) {
-            m_selectedItems.remove(i);
-        }
+        m_selectedItems.removeRange(index, count);
         break;
 
-    case Toggle:
-        for (int i = index; i <= endIndex; ++i) {
-            if (m_selectedItems.contains(i)) {
-                m_selectedItems.remove(i);
-            } else {
-                m_selectedItems.insert(i);
-            }
-        }
+    case Toggle: {
+        KItemSet toggledRange;
+        toggledRange.insertRange(index, count);
+        m_selectedItems = m_selectedItems ^ toggledRange;
         break;
+    }
 
     default:
         Q_ASSERT(false);
@@ -185,9 +183,7 @@ void KItemListSelectionManager::endAnchoredSelection()
         const int from = qMin(m_anchorItem, m_currentItem);
         const int to = qMax(m_anchorItem, m_currentItem);
 
-        for (int index = from; index <= to; ++index) {
-            m_selectedItems.insert(index);
-        }
+        m_selectedItems.insertRange(from, to - from + 1);
     }
 
     m_isAnchoredSelectionActive = false;
@@ -351,18 +347,11 @@ void KItemListSelectionManager::itemsMoved(const KItemRange &itemRange, const QL
         beginAnchoredSelection(m_currentItem);
     }
 
-    // Update the selections
+    // Update the selections. The permutation is applied to whole ranges of
+    // the set so that moving e.g. a select-all selection does not degrade
+    // into a per-item remap.
     if (!m_selectedItems.isEmpty()) {
-        const KItemSet previous = m_selectedItems;
-        m_selectedItems.clear();
-
-        for (int index : previous) {
-            if (index >= itemRange.index && index < itemRange.index + itemRange.count) {
-                m_selectedItems.insert(movedToIndexes.at(index - itemRange.index));
-            } else {
-                m_selectedItems.insert(index);
-            }
-        }
+        m_selectedItems = m_selectedItems.afterItemsMoved(itemRange, movedToIndexes);
     }
 
     const KItemSet selection = selectedItems();
@@ -50,7 +50,19 @@ public:
     void replaceSelection(int index, int count = 1);
     void clearSelection();
 
+    /**
+     * Starts an anchored selection between \a anchor and the current item.
+     * The anchored span is not materialized while it is extended: it is
+     * represented by the pair (anchor, current item) and composed with the
+     * persistent selection on demand, so moving the current item is
+     * independent of the size of the span.
+     */
     void beginAnchoredSelection(int anchor);
+
+    /**
+     * Commits the anchored selection: the items between the anchor and the
+     * current item are merged into the persistent selection.
+     */
     void endAnchoredSelection();
     bool isAnchoredSelectionActive() const;
 
@@ -24,6 +24,8 @@
 #include "private/kitemlistrubberband.h"
 #include "private/kitemlistsizehintresolver.h"
 #include "private/kitemlistviewlayouter.h"
+#include "private/kmemoryaccounting.h"
+#include "private/kpipelinetrace.h"
 
 #include <QElapsedTimer>
 #include <QGraphicsSceneMouseEvent>
@@ -46,6 +48,29 @@ const int RepeatingAutoScrollDelay = 1000 / 60;
 const int RubberFadeSpeed = 150;
 
 const char *RubberPropertyName = "_kitemviews_rubberBandPosition";
+
+// Maximum number of items that are measured synchronously when the
+// preferred column-widths of a whole directory have to be determined.
+// Larger directories are sampled and refined asynchronously afterwards,
+// see KItemListView::refineColumnWidths().
+const int MaxColumnWidthSampleCount = 1000;
+
+// Number of items whose preferred column-widths are measured per tick of
+// the asynchronous refinement.
+const int ColumnWidthRefineBatchSize = 4096;
+
+// Minimum time in ms between two relayouts which are driven by geometry
+// changes. During an interactive window resize the geometry changes with
+// every mouse move, which can be far more often than frames are drawn;
+// relayouting more than once per frame interval only burns time on
+// intermediate states nobody ever sees. See KItemListView::setGeometry().
+const int ResizeRelayoutInterval = 1000 / 60;
+
+// Layout passes faster than this stay synchronous even during rapid
+// geometry changes: they fit into the frame budget anyway, and relayouting
+// every intermediate geometry keeps the view tracking the window edge
+// exactly. See KItemListView::setGeometry().
+const qint64 ExpensiveRelayoutDurationMicroseconds = 3000;
 }
 
 #ifndef QT_NO_ACCESSIBILITY
@@ -107,6 +132,12 @@ KItemListView::KItemListView(QGraphicsWidget *parent)
     , m_statusBarOffset(0)
     , m_dropIndicator()
     , m_sizeHintResolver(nullptr)
+    , m_poolWarmUpTimer(nullptr)
+    , m_columnWidthRefineTimer(nullptr)
+    , m_columnWidthRefineIndex(0)
+    , m_createdWidgetCount(0)
+    , m_recycledWidgetCount(0)
+    , m_lastLayoutDurationMicroseconds(0)
 {
     setAcceptHoverEvents(true);
     setAcceptTouchEvents(true);
@@ -114,6 +145,9 @@ KItemListView::KItemListView(QGraphicsWidget *parent)
     m_sizeHintResolver = new KItemListSizeHintResolver(this);
 
     m_layouter = new KItemListViewLayouter(m_sizeHintResolver, this);
+    // Keep the scrollbar range up to date while the layouter refines its
+    // estimated maximum scroll offset in idle time slices.
+    connect(m_layouter, &KItemListViewLayouter::incrementalLayoutProgress, this, &KItemListView::emitOffsetChanges);
 
     m_animation = new KItemListViewAnimation(this);
     connect(m_animation, &KItemListViewAnimation::finished, this, &KItemListView::slotAnimationFinished);
@@ -143,13 +177,43 @@ KItemListView::KItemListView(QGraphicsWidget *parent)
 
     m_header = new KItemListHeader(this);
 
+    m_poolWarmUpTimer = new QTimer(this);
+    m_poolWarmUpTimer->setInterval(200);
+    connect(m_poolWarmUpTimer, &QTimer::timeout, this, &KItemListView::warmUpWidgetPool);
+    m_poolWarmUpTimer->start();
+
+    m_columnWidthRefineTimer = new QTimer(this);
+    m_columnWidthRefineTimer->setInterval(50);
+    connect(m_columnWidthRefineTimer, &QTimer::timeout, this, &KItemListView::refineColumnWidths);
+
+    m_resizeThrottleTimer = new QTimer(this);
+    m_resizeThrottleTimer->setSingleShot(true);
+    connect(m_resizeThrottleTimer, &QTimer::timeout, this, &KItemListView::relayoutForResize);
+
 #ifndef QT_NO_ACCESSIBILITY
     QAccessible::installFactory(accessibleInterfaceFactory);
+
+    // Merges the accessibility notifications of bulk model and selection
+    // changes into summary events, see scheduleAccessibleModelChange().
+    m_accessibleEventFlushTimer = new QTimer(this);
+    m_accessibleEventFlushTimer->setInterval(100);
+    m_accessibleEventFlushTimer->setSingleShot(true);
+    connect(m_accessibleEventFlushTimer, &QTimer::timeout, this, &KItemListView::flushAccessibleEvents);
 #endif
+
+    KMemoryAccounting::instance()->registerReporter(this, QByteArrayLiteral("KItemListView widget pool"), [this]() {
+        qint64 bytes = m_widgetCreator ? m_widgetCreator->estimatedMemoryUsageBytes() : 0;
+        if (m_groupHeaderCreator) {
+            bytes += m_groupHeaderCreator->estimatedMemoryUsageBytes();
+        }
+        return bytes;
+    });
 }
 
 KItemListView::~KItemListView()
 {
+    KMemoryAccounting::instance()->unregisterReporter(this);
+
     // The group headers are children of the widgets created by
     // widgetCreator(). So it is mandatory to delete the group headers
     // first.
@@ -378,9 +442,36 @@ void KItemListView::setGeometry(const QRectF &rect)
         return;
     }
 
-    const QSizeF newSize = rect.size();
+    if (m_resizeThrottleTimer->isActive()) {
+        // A relayout is already scheduled and will use the newest geometry once it fires.
+        return;
+    }
+
+    if (m_lastLayoutDurationMicroseconds <= ExpensiveRelayoutDurationMicroseconds) {
+        // Relayouts of this view are cheap, so every intermediate geometry is laid out and the view tracks the window edge exactly. Only views whose
+        // relayout eats a significant part of the frame budget are coalesced below.
+        relayoutForResize();
+        return;
+    }
+
+    const qint64 timeSinceLastRelayout = m_timeSinceResizeRelayout.isValid() ? m_timeSinceResizeRelayout.elapsed() : ResizeRelayoutInterval;
+    if (timeSinceLastRelayout < ResizeRelayoutInterval) {
+        // The geometry changes faster than frames are drawn, which happens while the window edge is dragged. The relayout for the intermediate geometries
+        // is skipped; the one at the end of the frame interval picks up whatever geometry is newest then, including the final one when the drag ends.
+        m_resizeThrottleTimer->start(ResizeRelayoutInterval - timeSinceLastRelayout);
+        return;
+    }
+
+    relayoutForResize();
+}
+
+void KItemListView::relayoutForResize()
+{
+    m_timeSinceResizeRelayout.start();
+
+    const QSizeF newSize = geometry().size();
     if (m_itemSize.isEmpty()) {
-        m_headerWidget->resize(rect.width(), m_headerWidget->size().height());
+        m_headerWidget->resize(newSize.width(), m_headerWidget->size().height());
         if (m_headerWidget->automaticColumnResizing()) {
             applyAutomaticColumnWidths();
         } else {
@@ -541,6 +632,11 @@ QRectF KItemListView::itemRect(int index) const
     return m_layouter->itemRect(index);
 }
 
+std::pair<int, int> KItemListView::itemRangeForRect(const QRectF &rect) const
+{
+    return m_layouter->itemRangeForRect(rect);
+}
+
 QRectF KItemListView::itemContextRect(int index) const
 {
     QRectF contextRect;
@@ -1171,6 +1267,12 @@ void KItemListView::updatePalette()
 
 void KItemListView::slotItemsInserted(const KItemRangeList &itemRanges)
 {
+    if (!m_deferredSizeHintItemRanges.isEmpty()) {
+        // The insertion shifts the recorded indexes; recalculate the hints of
+        // all items when the rename ends instead of tracking the shifts.
+        m_deferredSizeHintItemRanges = KItemRangeList() << KItemRange(0, m_model->count());
+    }
+
     if (m_itemSize.isEmpty()) {
         updatePreferredColumnWidths(itemRanges);
     }
@@ -1180,10 +1282,51 @@ void KItemListView::slotItemsInserted(const KItemRangeList &itemRanges)
         beginTransaction();
     }
 
+    // Capture the first visible item as scroll anchor before the layouter
+    // learns about the insertion. When all the new items of a range end up
+    // above the viewport (the usual case while a sorted directory is still
+    // streaming in), the scroll offset is corrected by the resulting shift
+    // so that the watched items stay put instead of jumping with every batch.
+    // No anchoring is done at the very top of the view, where new items are
+    // expected to push the content down.
+    int anchorIndex = -1;
+    qreal anchorPos = 0;
+    if (scrollOffset() > 0) {
+        anchorIndex = m_layouter->firstVisibleIndex();
+        if (anchorIndex >= 0) {
+            const QRectF anchorRect = m_layouter->itemRect(anchorIndex);
+            anchorPos = (scrollOrientation() == Qt::Vertical) ? anchorRect.y() : anchorRect.x();
+        }
+    }
+
     m_layouter->markAsDirty();
 
     m_sizeHintResolver->itemsInserted(itemRanges);
 
+    if (anchorIndex >= 0) {
+        // All range indexes refer to the model before the insertion, so the
+        // number of items that went in above the anchor can be summed up
+        // directly.
+        int insertedAboveAnchor = 0;
+        for (const KItemRange &range : itemRanges) {
+            if (range.index <= anchorIndex) {
+                insertedAboveAnchor += range.count;
+            }
+        }
+
+        if (insertedAboveAnchor > 0) {
+            const QRectF newAnchorRect = m_layouter->itemRect(anchorIndex + insertedAboveAnchor);
+            const qreal newAnchorPos = (scrollOrientation() == Qt::Vertical) ? newAnchorRect.y() : newAnchorRect.x();
+            const qreal shift = newAnchorPos - anchorPos;
+            if (shift != 0) {
+                m_layouter->setScrollOffset(qMax(qreal(0), m_layouter->scrollOffset() + shift));
+                m_animation->setScrollOffset(m_layouter->scrollOffset());
+                // The scrollbar is synchronized by emitOffsetChanges() at the
+                // end of the upcoming doLayout() call.
+            }
+        }
+    }
+
     int previouslyInsertedCount = 0;
     for (const KItemRange &range : itemRanges) {
         // range.index is related to the model before anything has been inserted.
@@ -1259,6 +1402,14 @@ void KItemListView::slotItemsInserted(const KItemRangeList &itemRanges)
         m_controller->selectionManager()->itemsInserted(itemRanges);
     }
 
+#ifndef QT_NO_ACCESSIBILITY
+    if (QAccessible::isActive() && previouslyInsertedCount > 0) {
+        // One queued summary notification covers the whole range list, and consecutive insertion batches of a streaming directory load are merged further by
+        // the flush timer, so the accessibility bridge traffic stays independent of both the item count and the batch count.
+        scheduleAccessibleModelChange(QAccessibleTableModelChangeEvent::RowsInserted, itemRanges.first().index, itemRanges.last().index + previouslyInsertedCount - 1);
+    }
+#endif
+
     if (hasMultipleRanges) {
         m_endTransactionAnimationHint = NoAnimation;
         endTransaction();
@@ -1280,6 +1431,10 @@ void KItemListView::slotItemsInserted(const KItemRangeList &itemRanges)
 
 void KItemListView::slotItemsRemoved(const KItemRangeList &itemRanges)
 {
+    if (!m_deferredSizeHintItemRanges.isEmpty()) {
+        m_deferredSizeHintItemRanges = KItemRangeList() << KItemRange(0, m_model->count());
+    }
+
     if (m_itemSize.isEmpty()) {
         // Don't pass the item-range: The preferred column-widths of
         // all items must be adjusted when removing items.
@@ -1379,6 +1534,13 @@ void KItemListView::slotItemsRemoved(const KItemRangeList &itemRanges)
         m_controller->selectionManager()->itemsRemoved(itemRanges);
     }
 
+#ifndef QT_NO_ACCESSIBILITY
+    if (QAccessible::isActive()) {
+        // One queued summary notification covers the whole range list; consecutive removal batches are merged further by the flush timer.
+        scheduleAccessibleModelChange(QAccessibleTableModelChangeEvent::RowsRemoved, itemRanges.first().index, itemRanges.last().index + itemRanges.last().count - 1);
+    }
+#endif
+
     if (hasMultipleRanges) {
         m_endTransactionAnimationHint = NoAnimation;
         endTransaction();
@@ -1398,6 +1560,10 @@ void KItemListView::slotItemsRemoved(const KItemRangeList &itemRanges)
 
 void KItemListView::slotItemsMoved(const KItemRange &itemRange, const QList<int> &movedToIndexes)
 {
+    if (!m_deferredSizeHintItemRanges.isEmpty()) {
+        m_deferredSizeHintItemRanges = KItemRangeList() << KItemRange(0, m_model->count());
+    }
+
     m_sizeHintResolver->itemsMoved(itemRange, movedToIndexes);
     m_layouter->markAsDirty();
 
@@ -1437,7 +1603,17 @@ void KItemListView::slotItemsMoved(const KItemRange &itemRange, const QList<int>
 
 void KItemListView::slotItemsChanged(const KItemRangeList &itemRanges, const QSet<QByteArray> &roles)
 {
-    const bool updateSizeHints = itemSizeHintUpdateRequired(roles);
+    bool updateSizeHints = itemSizeHintUpdateRequired(roles);
+    if (updateSizeHints && m_editingRole) {
+        // Recalculating size hints would relayout the surrounding items under
+        // the open rename editor on every streamed update (e.g. directory
+        // size counts), which makes typing stutter in very large views.
+        // Defer the recalculation until the rename commits; the widgets still
+        // receive the changed data below.
+        m_deferredSizeHintItemRanges << itemRanges;
+        m_deferredSizeHintRoles += roles;
+        updateSizeHints = false;
+    }
     if (updateSizeHints && m_itemSize.isEmpty()) {
         updatePreferredColumnWidths(itemRanges);
     }
@@ -1448,7 +1624,7 @@ void KItemListView::slotItemsChanged(const KItemRangeList &itemRanges, const QSe
 
         if (updateSizeHints) {
             m_sizeHintResolver->itemsChanged(index, count, roles);
-            m_layouter->markAsDirty();
+            m_layouter->updateSizeHints(index, count);
         }
 
         // Apply the changed roles to the visible item-widgets
@@ -1550,6 +1726,11 @@ void KItemListView::slotCurrentChanged(int current, int previous)
 
 void KItemListView::slotSelectionChanged(const KItemSet &current, const KItemSet &previous)
 {
+#ifndef QT_NO_ACCESSIBILITY
+    int changedCount = 0;
+    int lastChangedIndex = -1;
+#endif
+
     QHashIterator<int, KItemListWidget *> it(m_visibleItems);
     while (it.hasNext()) {
         it.next();
@@ -1562,20 +1743,87 @@ void KItemListView::slotSelectionChanged(const KItemSet &current, const KItemSet
         if (!QAccessible::isActive()) {
             continue;
         }
-        // Let the screen reader announce "selected" or "not selected" for the active item.
         const bool wasSelected(previous.contains(index));
         if (isSelected != wasSelected) {
-            QAccessibleEvent accessibleSelectionChangedEvent(this, QAccessible::SelectionAdd);
-            accessibleSelectionChangedEvent.setChild(index);
-            QAccessible::updateAccessibility(&accessibleSelectionChangedEvent);
+            ++changedCount;
+            lastChangedIndex = index;
         }
+#endif
     }
-#else
+
+#ifndef QT_NO_ACCESSIBILITY
+    if (changedCount == 1) {
+        // Let the screen reader announce "selected" or "not selected" for the active item.
+        QAccessibleEvent accessibleSelectionChangedEvent(this, QAccessible::SelectionAdd);
+        accessibleSelectionChangedEvent.setChild(lastChangedIndex);
+        QAccessible::updateAccessibility(&accessibleSelectionChangedEvent);
+    } else if (changedCount > 1) {
+        // The selection state of many items changed at once, e.g. because of "Select All" or an anchored selection. A single queued event announcing a
+        // selection change within the view replaces the per-item events, and the flush timer merges the rapid succession of such bulk changes (e.g. while a
+        // rubber band sweeps over thousands of items) so that the accessibility bridge traffic stays bounded.
+        scheduleAccessibleSelectionWithin();
     }
+#else
     Q_UNUSED(previous)
 #endif
 }
 
+#ifndef QT_NO_ACCESSIBILITY
+void KItemListView::scheduleAccessibleModelChange(QAccessibleTableModelChangeEvent::ModelChangeType type, int firstRow, int lastRow)
+{
+    // The cached cell interfaces are invalidated right away so that queries
+    // arriving before the flush never see children representing old indices;
+    // only the bus notification itself is deferred.
+    if (auto *accessibleView = static_cast<KItemListViewAccessible *>(QAccessible::queryAccessibleInterface(this))) {
+        accessibleView->dropCachedDelegatesFrom(firstRow);
+    }
+
+    if (m_accessiblePendingFirstRow < 0) {
+        m_accessiblePendingModelChangeType = type;
+        m_accessiblePendingFirstRow = firstRow;
+        m_accessiblePendingLastRow = lastRow;
+    } else {
+        if (m_accessiblePendingModelChangeType != type) {
+            // Insertions and removals within one flush interval cannot be
+            // described by a single ranged event; a model-reset summary can.
+            m_accessiblePendingModelChangeType = QAccessibleTableModelChangeEvent::ModelReset;
+        }
+        m_accessiblePendingFirstRow = qMin(m_accessiblePendingFirstRow, firstRow);
+        m_accessiblePendingLastRow = qMax(m_accessiblePendingLastRow, lastRow);
+    }
+
+    if (!m_accessibleEventFlushTimer->isActive()) {
+        m_accessibleEventFlushTimer->start();
+    }
+}
+
+void KItemListView::scheduleAccessibleSelectionWithin()
+{
+    m_accessiblePendingSelectionWithin = true;
+    if (!m_accessibleEventFlushTimer->isActive()) {
+        m_accessibleEventFlushTimer->start();
+    }
+}
+
+void KItemListView::flushAccessibleEvents()
+{
+    if (m_accessiblePendingFirstRow >= 0) {
+        QAccessibleTableModelChangeEvent modelChangeEvent(this, m_accessiblePendingModelChangeType);
+        modelChangeEvent.setFirstRow(m_accessiblePendingFirstRow);
+        modelChangeEvent.setLastRow(m_accessiblePendingLastRow);
+        m_accessiblePendingFirstRow = -1;
+        m_accessiblePendingLastRow = -1;
+        QAccessible::updateAccessibility(&modelChangeEvent);
+    }
+
+    if (m_accessiblePendingSelectionWithin) {
+        m_accessiblePendingSelectionWithin = false;
+        QAccessibleEvent selectionChangedEvent(this, QAccessible::SelectionWithin);
+        QAccessible::updateAccessibility(&selectionChangedEvent);
+    }
+}
+#endif
+
 void KItemListView::slotAnimationFinished(QGraphicsWidget *widget, KItemListViewAnimation::AnimationType type)
 {
     KItemListWidget *itemListWidget = qobject_cast<KItemListWidget *>(widget);
@@ -1752,6 +2000,7 @@ void KItemListView::slotRoleEditingCanceled(int index, const QByteArray &role, c
     disconnectRoleEditingSignals(index);
 
     m_editingRole = false;
+    applyDeferredSizeHintUpdates();
     Q_EMIT roleEditingCanceled(index, role, value);
 }
 
@@ -1760,6 +2009,7 @@ void KItemListView::slotRoleEditingFinished(int index, const QByteArray &role, c
     disconnectRoleEditingSignals(index);
 
     m_editingRole = false;
+    applyDeferredSizeHintUpdates();
     Q_EMIT roleEditingFinished(index, role, value);
 }
 
@@ -1806,6 +2056,9 @@ void KItemListView::setModel(KItemModelBase *model)
         m_sizeHintResolver->itemsRemoved(KItemRangeList() << KItemRange(0, m_model->count()));
     }
 
+    m_deferredSizeHintItemRanges.clear();
+    m_deferredSizeHintRoles.clear();
+
     m_model = model;
     m_layouter->setModel(model);
     m_grouped = model->groupedSorting();
@@ -1845,6 +2098,8 @@ void KItemListView::doLayout(LayoutAnimationHint hint, int changedIndex, int cha
         return;
     }
 
+    DOLPHIN_PIPELINE_TRACE_SPAN("KItemListView::doLayout", m_model ? m_model->count() : 0);
+
     if (!m_model || m_model->count() < 0) {
         return;
     }
@@ -1855,6 +2110,9 @@ void KItemListView::doLayout(LayoutAnimationHint hint, int changedIndex, int cha
         return;
     }
 
+    QElapsedTimer layoutDurationTimer;
+    layoutDurationTimer.start();
+
     // Do a sanity check of the scroll-offset property: When properties of the itemlist-view have been changed
     // it might be possible that the maximum offset got changed too. Assure that the full visible range
     // is still shown if the maximum offset got decreased.
@@ -1999,6 +2257,8 @@ void KItemListView::doLayout(LayoutAnimationHint hint, int changedIndex, int cha
         }
     }
 
+    m_lastLayoutDurationMicroseconds = layoutDurationTimer.nsecsElapsed() / 1000;
+
     emitOffsetChanges();
 }
 
@@ -2105,8 +2365,24 @@ void KItemListView::emitOffsetChanges()
     }
 }
 
+quint64 KItemListView::createdWidgetCount() const
+{
+    return m_createdWidgetCount;
+}
+
+quint64 KItemListView::recycledWidgetCount() const
+{
+    return m_recycledWidgetCount;
+}
+
+qint64 KItemListView::lastLayoutDurationMicroseconds() const
+{
+    return m_lastLayoutDurationMicroseconds;
+}
+
 KItemListWidget *KItemListView::createWidget(int index)
 {
+    ++m_createdWidgetCount;
     KItemListWidget *widget = widgetCreator()->create(this);
     widget->setFlag(QGraphicsItem::ItemStacksBehindParent);
 
@@ -2119,6 +2395,7 @@ KItemListWidget *KItemListView::createWidget(int index)
 
 void KItemListView::recycleWidget(KItemListWidget *widget)
 {
+    ++m_recycledWidgetCount;
     if (m_grouped) {
         recycleGroupHeaderForWidget(widget);
     }
@@ -2130,6 +2407,31 @@ void KItemListView::recycleWidget(KItemListWidget *widget)
     widgetCreator()->recycle(widget);
 }
 
+void KItemListView::warmUpWidgetPool()
+{
+    if (!m_model || maximumVisibleItems() <= 0) {
+        // The view is not set up yet - keep the timer running and try
+        // again once the model and the geometry are known.
+        return;
+    }
+
+    // Cover one viewport of items, but respect the upper bound of the
+    // recycleable pool (see KItemListCreatorBase::pushRecycleableWidget()).
+    const int targetCount = qMin(maximumVisibleItems(), 100) - static_cast<int>(m_visibleItems.count()) - widgetCreator()->recycleableWidgetCount();
+    if (targetCount <= 0) {
+        m_poolWarmUpTimer->stop();
+        return;
+    }
+
+    // Construct only a few widgets per tick so that the event loop stays
+    // responsive while the application is starting up.
+    const int batchCount = qMin(targetCount, 4);
+    for (int i = 0; i < batchCount; ++i) {
+        KItemListWidget *widget = widgetCreator()->create(this);
+        widgetCreator()->recycle(widget);
+    }
+}
+
 void KItemListView::setWidgetIndex(KItemListWidget *widget, int index)
 {
     const int oldIndex = widget->index();
@@ -2430,9 +2732,23 @@ void KItemListView::updatePreferredColumnWidths(const KItemRangeList &itemRanges
     }
 
     if (itemCount == rangesItemCount) {
-        const QHash<QByteArray, qreal> preferredWidths = preferredColumnWidths(itemRanges);
-        for (const QByteArray &role : std::as_const(m_visibleRoles)) {
-            m_headerWidget->setPreferredColumnWidth(role, preferredWidths.value(role));
+        if (itemCount > MaxColumnWidthSampleCount) {
+            // Measuring every item of a huge directory would block the GUI
+            // thread. Derive the initial widths from the visible range plus a
+            // bounded sample that is spread evenly across the directory, and
+            // refine the remaining items asynchronously.
+            const QHash<QByteArray, qreal> preferredWidths = preferredColumnWidths(columnWidthSampleRanges());
+            for (const QByteArray &role : std::as_const(m_visibleRoles)) {
+                m_headerWidget->setPreferredColumnWidth(role, preferredWidths.value(role));
+            }
+            m_columnWidthRefineIndex = 0;
+            m_columnWidthRefineTimer->start();
+        } else {
+            m_columnWidthRefineTimer->stop();
+            const QHash<QByteArray, qreal> preferredWidths = preferredColumnWidths(itemRanges);
+            for (const QByteArray &role : std::as_const(m_visibleRoles)) {
+                m_headerWidget->setPreferredColumnWidth(role, preferredWidths.value(role));
+            }
         }
     } else {
         // Only a sub range of the roles need to be determined.
@@ -2473,6 +2789,98 @@ void KItemListView::updatePreferredColumnWidths()
     }
 }
 
+void KItemListView::applyDeferredSizeHintUpdates()
+{
+    if (m_deferredSizeHintItemRanges.isEmpty() || !m_model) {
+        m_deferredSizeHintItemRanges.clear();
+        m_deferredSizeHintRoles.clear();
+        return;
+    }
+
+    const KItemRangeList itemRanges = m_deferredSizeHintItemRanges;
+    const QSet<QByteArray> roles = m_deferredSizeHintRoles;
+    m_deferredSizeHintItemRanges.clear();
+    m_deferredSizeHintRoles.clear();
+
+    if (m_itemSize.isEmpty()) {
+        updatePreferredColumnWidths(itemRanges);
+    }
+
+    for (const KItemRange &itemRange : itemRanges) {
+        // Items might have been removed after a range was recorded; clamp
+        // against the current model size.
+        const int index = qMin(itemRange.index, m_model->count());
+        const int count = qMin(itemRange.count, m_model->count() - index);
+        if (count > 0) {
+            m_sizeHintResolver->itemsChanged(index, count, roles);
+            m_layouter->updateSizeHints(index, count);
+        }
+    }
+
+    doLayout(NoAnimation);
+}
+
+KItemRangeList KItemListView::columnWidthSampleRanges() const
+{
+    KItemRangeList ranges;
+    const int itemCount = m_model->count();
+
+    const int firstVisible = qMax(0, firstVisibleIndex());
+    const int lastVisible = lastVisibleIndex();
+    if (lastVisible >= firstVisible && lastVisible >= 0) {
+        ranges << KItemRange(firstVisible, lastVisible - firstVisible + 1);
+    }
+
+    // Spread single-item samples evenly across the whole directory.
+    const int stride = qMax(1, itemCount / MaxColumnWidthSampleCount);
+    for (int i = 0; i < itemCount; i += stride) {
+        if (i >= firstVisible && i <= lastVisible) {
+            continue;
+        }
+        ranges << KItemRange(i, 1);
+    }
+
+    return ranges;
+}
+
+void KItemListView::refineColumnWidths()
+{
+    if (!m_model || !m_itemSize.isEmpty()) {
+        m_columnWidthRefineTimer->stop();
+        return;
+    }
+
+    const int itemCount = m_model->count();
+    if (m_columnWidthRefineIndex >= itemCount) {
+        m_columnWidthRefineTimer->stop();
+        return;
+    }
+
+    const KItemListWidgetCreatorBase *creator = widgetCreator();
+    const int endIndex = qMin(m_columnWidthRefineIndex + ColumnWidthRefineBatchSize, itemCount);
+
+    bool changed = false;
+    for (const QByteArray &role : std::as_const(m_visibleRoles)) {
+        qreal maxWidth = m_headerWidget->preferredColumnWidth(role);
+        for (int i = m_columnWidthRefineIndex; i < endIndex; ++i) {
+            maxWidth = qMax(maxWidth, creator->preferredRoleColumnWidth(role, i, this));
+        }
+        if (maxWidth > m_headerWidget->preferredColumnWidth(role)) {
+            m_headerWidget->setPreferredColumnWidth(role, maxWidth);
+            changed = true;
+        }
+    }
+
+    m_columnWidthRefineIndex = endIndex;
+    if (m_columnWidthRefineIndex >= itemCount) {
+        m_columnWidthRefineTimer->stop();
+    }
+
+    if (changed && m_headerWidget->automaticColumnResizing()) {
+        applyAutomaticColumnWidths();
+    }
+}
+
 void KItemListView::applyAutomaticColumnWidths()
 {
     Q_ASSERT(m_itemSize.isEmpty());
@@ -2852,6 +3260,32 @@ KItemListCreatorBase::~KItemListCreatorBase()
     qDeleteAll(m_createdWidgets);
 }
 
+int KItemListCreatorBase::recycleableWidgetCount() const
+{
+    return m_recycleableWidgets.count();
+}
+
+qint64 KItemListCreatorBase::estimatedMemoryUsageBytes() const
+{
+    // Group-header creators hold widgets that are not KItemListWidgets, for
+    // those only the base object size can be counted.
+    auto widgetBytes = [](const QGraphicsWidget *widget) -> qint64 {
+        if (const KItemListWidget *itemListWidget = qobject_cast<const KItemListWidget *>(widget)) {
+            return itemListWidget->estimatedMemoryUsageBytes();
+        }
+        return sizeof(QGraphicsWidget);
+    };
+
+    qint64 bytes = 0;
+    for (const QGraphicsWidget *widget : m_createdWidgets) {
+        bytes += widgetBytes(widget);
+    }
+    for (const QGraphicsWidget *widget : m_recycleableWidgets) {
+        bytes += widgetBytes(widget);
+    }
+    return bytes;
+}
+
 void KItemListCreatorBase::addCreatedWidget(QGraphicsWidget *widget)
 {
     m_createdWidgets.insert(widget);
@@ -10,6 +10,7 @@
 #define KITEMLISTVIEW_H
 
 #include <optional>
+#include <utility>
 
 #include "dolphin_export.h"
 #include "kitemviews/kitemliststyleoption.h"
@@ -18,6 +19,8 @@
 #include "kitemviews/kstandarditemlistgroupheader.h"
 #include "kitemviews/private/kitemlistviewanimation.h"
 
+#include <QAccessible>
+#include <QElapsedTimer>
 #include <QGraphicsWidget>
 #include <QSet>
 
@@ -180,6 +183,17 @@ public:
      */
     virtual qreal scrollSingleStep() const;
 
+    /**
+     * Counters and timings consumed by the performance HUD overlay, see
+     * KItemListPerformanceHud. Keeping them up to date is cheap, so they
+     * are recorded unconditionally.
+     */
+    quint64 createdWidgetCount() const;
+    quint64 recycledWidgetCount() const;
+
+    /** @return How long the most recent full layout pass of doLayout() took. */
+    qint64 lastLayoutDurationMicroseconds() const;
+
     /**
      * @return Index of the item that is below the point \a pos.
      *         The position is relative to the upper right of
@@ -239,6 +253,13 @@ public:
      */
     QRectF itemRect(int index) const;
 
+    /**
+     * @return Range of the first and last item index whose rows intersect
+     *         the rectangle \a rect, which is given in the same coordinates
+     *         as itemRect(). See KItemListViewLayouter::itemRangeForRect().
+     */
+    std::pair<int, int> itemRangeForRect(const QRectF &rect) const;
+
     /**
      * @return The context rectangle of the item relative to the top/left of
      *         the currently visible area (see KItemListView::offset()). The
@@ -356,6 +377,12 @@ Q_SIGNALS:
      */
     void scrollingStopped();
 
+    /**
+     * Emitted whenever the estimated scroll velocity changes. Forwarded from
+     * KItemListSmoothScroller by KItemListContainer.
+     */
+    void scrollVelocityChanged(qreal pixelsPerSecond);
+
     void columnHovered(int roleIndex);
     void columnUnHovered(int roleIndex);
 
@@ -496,6 +523,15 @@ private:
 
     void doLayout(LayoutAnimationHint hint, int changedIndex = 0, int changedCount = 0);
 
+    /**
+     * Applies the current geometry to the layouter and relayouts the view.
+     * Called from setGeometry(), either directly or - during an interactive
+     * window resize, where geometry changes arrive faster than frames are
+     * drawn - deferred through m_resizeThrottleTimer so that at most one
+     * relayout per frame interval runs. @see setGeometry().
+     */
+    void relayoutForResize();
+
     /**
      * Helper method for doLayout: Returns a list of items that can be reused for the visible
      * area. Invisible group headers get recycled. The reusable items are items that are
@@ -518,6 +554,15 @@ private:
     KItemListWidget *createWidget(int index);
     void recycleWidget(KItemListWidget *widget);
 
+    /**
+     * Constructs item-widgets during idle time after the view has been
+     * created until the recycleable pool of the widget-creator can cover
+     * one viewport of items. This prevents a hitch on the first fast
+     * scrolling through a directory, where otherwise dozens of widgets
+     * would have to be instantiated at once.
+     */
+    void warmUpWidgetPool();
+
     /**
      * Changes the index of the widget to \a index and assures a consistent
      * update for m_visibleItems and m_visibleCells. The cell-information
@@ -627,6 +672,28 @@ private:
      */
     void updatePreferredColumnWidths();
 
+    /**
+     * Updates the size hints whose recalculation was skipped while a rename
+     * editor was open and does one relayout, see slotItemsChanged(). Called
+     * when the role editing has been finished or canceled.
+     */
+    void applyDeferredSizeHintUpdates();
+
+    /**
+     * @return Item ranges that cover the visible items plus a bounded sample
+     *         that is spread evenly across all items of the model. Used by
+     *         updatePreferredColumnWidths() instead of measuring every item
+     *         of a huge directory synchronously.
+     */
+    KItemRangeList columnWidthSampleRanges() const;
+
+    /**
+     * Measures the preferred column-widths of the items that were skipped by
+     * the sampling in batches during idle time. The preferred widths may only
+     * grow during the refinement so that no flickering occurs.
+     */
+    void refineColumnWidths();
+
     /**
      * Resizes the column-widths of m_headerWidget based on the preferred widths
      * and the available view-size.
@@ -724,6 +791,34 @@ private:
      */
     static int itemsPerSize(qreal size, qreal itemSize, qreal itemMargin);
 
+#ifndef QT_NO_ACCESSIBILITY
+    /**
+     * Queues an accessibility model-change notification for the rows
+     * \a firstRow to \a lastRow. The notifications of one flush interval are
+     * merged into a single summary event, so that a directory streaming in
+     * with many insertion batches puts one event per interval on the
+     * accessibility bus instead of one per batch - with a screen reader
+     * attached, per-batch events freeze the session in huge directories.
+     * The cached cell interfaces are invalidated immediately; only the bus
+     * traffic is deferred. Mixed insertions and removals within one interval
+     * degrade to a model-reset summary.
+     */
+    void scheduleAccessibleModelChange(QAccessibleTableModelChangeEvent::ModelChangeType type, int firstRow, int lastRow);
+
+    /**
+     * Queues a selection-within summary notification, merging the rapid
+     * succession of bulk selection changes (e.g. while a rubber band sweeps
+     * over thousands of items) into one event per flush interval.
+     */
+    void scheduleAccessibleSelectionWithin();
+
+    /**
+     * Sends the accessibility notifications queued by
+     * scheduleAccessibleModelChange() and scheduleAccessibleSelectionWithin().
+     */
+    void flushAccessibleEvents();
+#endif
+
 private:
     bool m_enabledSelectionToggles;
     bool m_grouped;
@@ -731,6 +826,12 @@ private:
     bool m_alternateBackgrounds;
     bool m_supportsItemExpanding;
     bool m_editingRole;
+    // Item ranges whose size hints changed while the rename editor was open.
+    // They are applied in one go when the rename commits so that typing does
+    // not compete with relayouts of the surrounding items, see
+    // slotItemsChanged() and applyDeferredSizeHintUpdates().
+    KItemRangeList m_deferredSizeHintItemRanges;
+    QSet<QByteArray> m_deferredSizeHintRoles;
     int m_activeTransactions; // Counter for beginTransaction()/endTransaction()
     LayoutAnimationHint m_endTransactionAnimationHint;
 
@@ -743,6 +844,15 @@ private:
 #ifndef QT_NO_ACCESSIBILITY
     /** The object that will be the parent of this classes QAccessibleInterface. */
     KItemListContainerAccessible *m_accessibleParent = nullptr;
+
+    // Queued accessibility notifications, merged into summary events by
+    // flushAccessibleEvents(). A pending first row of -1 means that no
+    // model-change notification is queued.
+    QTimer *m_accessibleEventFlushTimer = nullptr;
+    QAccessibleTableModelChangeEvent::ModelChangeType m_accessiblePendingModelChangeType = QAccessibleTableModelChangeEvent::ModelReset;
+    int m_accessiblePendingFirstRow = -1;
+    int m_accessiblePendingLastRow = -1;
+    bool m_accessiblePendingSelectionWithin = false;
 #endif
     KItemListStyleOption m_styleOption;
 
@@ -801,10 +911,27 @@ private:
 
     KItemListSizeHintResolver *m_sizeHintResolver;
 
+    QTimer *m_poolWarmUpTimer;
+
+    // Drive the asynchronous refinement of the preferred column-widths,
+    // see refineColumnWidths().
+    QTimer *m_columnWidthRefineTimer;
+    int m_columnWidthRefineIndex;
+
+    // Coalesce relayouts while the geometry changes rapidly, see relayoutForResize().
+    QTimer *m_resizeThrottleTimer;
+    QElapsedTimer m_timeSinceResizeRelayout;
+
+    // Performance HUD statistics, see createdWidgetCount() etc.
+    quint64 m_createdWidgetCount;
+    quint64 m_recycledWidgetCount;
+    qint64 m_lastLayoutDurationMicroseconds;
+
     friend class KItemListContainer; // Accesses scrollBarRequired()
     friend class KItemListHeader; // Accesses m_headerWidget
     friend class KItemListController;
     friend class KItemListControllerTest;
+    friend class KStandardItemListWidgetPaintTest; // Accesses visibleItemListWidgets()
     friend class KItemListViewAccessible;
     friend class KItemListDelegateAccessible;
 
@@ -822,6 +949,18 @@ class DOLPHIN_EXPORT KItemListCreatorBase
 public:
     virtual ~KItemListCreatorBase();
 
+    /**
+     * @return Number of widgets that are currently held back for being reused.
+     */
+    int recycleableWidgetCount() const;
+
+    /**
+     * @return An estimate of the bytes held by all widgets of this creator,
+     *         both the ones currently in use and the recycled pool. See
+     *         KMemoryAccounting.
+     */
+    qint64 estimatedMemoryUsageBytes() const;
+
 protected:
     void addCreatedWidget(QGraphicsWidget *widget);
     void pushRecycleableWidget(QGraphicsWidget *widget);
@@ -15,9 +15,24 @@
 #include <KSharedConfig>
 
 #include <QApplication>
+#include <QCache>
 #include <QPainter>
 #include <QPropertyAnimation>
 #include <QStyleOption>
+#include <QtMath>
+
+namespace
+{
+/**
+ * Rendered selection/hover chrome pixmaps, shared between all item widgets
+ * of this process. Sweeping the cursor across a grid renders the identical
+ * chrome for every hovered item; with this cache each
+ * (size, state, palette) combination is rendered exactly once and every
+ * further paint is a blit. The cost is the byte size of the cached pixmaps.
+ * Palette and size changes simply produce new keys, stale entries age out.
+ */
+QCache<QString, QPixmap> g_chromeCache(16 * 1024 * 1024);
+}
 
 KItemListWidgetInformant::KItemListWidgetInformant()
 {
@@ -46,30 +61,36 @@ KItemListWidget::KItemListWidget(KItemListWidgetInformant *informant, QGraphicsI
     , m_styleOption()
     , m_siblingsInfo()
     , m_hoverOpacity(0)
-    , m_hoverCache(nullptr)
     , m_hoverSequenceIndex(0)
     , m_selectionToggle(nullptr)
     , m_editedRole()
     , m_iconSize(-1)
 {
     connect(&m_hoverSequenceTimer, &QTimer::timeout, this, &KItemListWidget::slotHoverSequenceTimerTimeout);
+
+    // Render the widget into a cached layer so that scrolling only has to
+    // translate and compose the existing pixmaps instead of re-executing the
+    // full paint (icon blit, text draw, decoration) of every visible item
+    // per frame. The cache is invalidated by the update() calls that data,
+    // selection and hover changes trigger anyway (see setData() and
+    // damageRect() for the partial invalidation of single roles), and the
+    // backing QPixmapCache evicts the layers of invisible items on its own.
+    setCacheMode(QGraphicsItem::DeviceCoordinateCache);
 }
 
 KItemListWidget::~KItemListWidget()
 {
-    clearHoverCache();
 }
 
 void KItemListWidget::setIndex(int index)
 {
     if (m_index != index) {
-        delete m_selectionToggle;
-        m_selectionToggle = nullptr;
+        if (m_selectionToggle) {
+            m_selectionToggle->hide();
+        }
 
         m_hoverOpacity = 0;
 
-        clearHoverCache();
-
         m_index = index;
     }
 }
@@ -81,17 +102,17 @@ int KItemListWidget::index() const
 
 void KItemListWidget::setData(const QHash<QByteArray, QVariant> &data, const QSet<QByteArray> &roles)
 {
-    clearHoverCache();
     if (roles.isEmpty()) {
         m_data = data;
         dataChanged(m_data);
+        update();
     } else {
         for (const QByteArray &role : roles) {
             m_data[role] = data[role];
         }
         dataChanged(m_data, roles);
+        update(damageRect(roles));
     }
-    update();
 }
 
 QHash<QByteArray, QVariant> KItemListWidget::data() const
@@ -131,20 +152,13 @@ void KItemListWidget::paint(QPainter *painter, const QStyleOptionGraphicsItem *o
     }
 
     if (m_hoverOpacity > 0.0) {
-        if (!m_hoverCache) {
-            // Initialize the m_hoverCache pixmap to improve the drawing performance
-            // when fading the hover background
-            m_hoverCache = new QPixmap(size().toSize());
-            m_hoverCache->fill(Qt::transparent);
-
-            QPainter pixmapPainter(m_hoverCache);
-            const QStyle::State activeState(isActiveWindow() && widget->hasFocus() ? QStyle::State_Active | QStyle::State_Enabled : 0);
-            drawItemStyleOption(&pixmapPainter, widget, activeState | QStyle::State_MouseOver | QStyle::State_Item);
-        }
-
+        // drawItemStyleOption() blits the chrome from the shared pixmap
+        // cache, so fading the hover background only composes that pixmap
+        // with the changing opacity.
+        const QStyle::State activeState(isActiveWindow() && widget->hasFocus() ? QStyle::State_Active | QStyle::State_Enabled : 0);
         const qreal opacity = painter->opacity();
         painter->setOpacity(m_hoverOpacity * opacity);
-        painter->drawPixmap(0, 0, *m_hoverCache);
+        drawItemStyleOption(painter, widget, activeState | QStyle::State_MouseOver | QStyle::State_Item);
         painter->setOpacity(opacity);
     }
 }
@@ -216,7 +230,6 @@ void KItemListWidget::setStyleOption(const KItemListStyleOption &option)
     }
 
     const KItemListStyleOption previous = m_styleOption;
-    clearHoverCache();
     m_styleOption = option;
     styleOptionChanged(option, previous);
     update();
@@ -277,16 +290,16 @@ void KItemListWidget::setHovered(bool hovered)
 
         hoverSequenceStarted();
 
-        const KConfigGroup globalConfig(KSharedConfig::openConfig(), QStringLiteral("PreviewSettings"));
-        const int interval = globalConfig.readEntry("HoverSequenceInterval", 700);
+        // The interval is read only once: Re-reading it from the config for every item the mouse sweeps over would be unnecessarily expensive.
+        static const int interval = KConfigGroup(KSharedConfig::openConfig(), QStringLiteral("PreviewSettings")).readEntry("HoverSequenceInterval", 700);
 
         m_hoverSequenceTimer.start(interval);
     } else {
         setHoverOpacity(0.0);
 
+        // The toggle is only hidden and not deleted so that it can be reused the next time this (possibly recycled) widget is hovered.
         if (m_selectionToggle) {
-            m_selectionToggle->deleteLater();
-            m_selectionToggle = nullptr;
+            m_selectionToggle->hide();
         }
 
         hoverSequenceEnded();
@@ -348,8 +361,7 @@ void KItemListWidget::setEnabledSelectionToggle(bool enable)
                 initializeSelectionToggle();
             }
         } else if (m_selectionToggle) {
-            m_selectionToggle->deleteLater();
-            m_selectionToggle = nullptr;
+            m_selectionToggle->hide();
         }
 
         update();
@@ -416,6 +428,17 @@ QRectF KItemListWidget::textFocusRect() const
     return textRect();
 }
 
+QRectF KItemListWidget::damageRect(const QSet<QByteArray> &changedRoles) const
+{
+    Q_UNUSED(changedRoles)
+    return QRectF(QPointF(0, 0), size());
+}
+
+qint64 KItemListWidget::estimatedMemoryUsageBytes() const
+{
+    return sizeof(KItemListWidget);
+}
+
 QRectF KItemListWidget::selectionToggleRect() const
 {
     return QRectF();
@@ -531,7 +554,6 @@ void KItemListWidget::iconSizeChanged(int current, int previous)
 void KItemListWidget::resizeEvent(QGraphicsSceneResizeEvent *event)
 {
     QGraphicsWidget::resizeEvent(event);
-    clearHoverCache();
 
     if (m_selectionToggle) {
         const QRectF &toggleRect = selectionToggleRect();
@@ -582,6 +604,7 @@ void KItemListWidget::initializeSelectionToggle()
     m_selectionToggle->resize(toggleRect.size());
 
     m_selectionToggle->setChecked(isSelected());
+    m_selectionToggle->show();
 }
 
 void KItemListWidget::setHoverOpacity(qreal opacity)
@@ -591,20 +614,9 @@ void KItemListWidget::setHoverOpacity(qreal opacity)
         m_selectionToggle->setOpacity(opacity);
     }
 
-    if (m_hoverOpacity <= 0.0) {
-        delete m_hoverCache;
-        m_hoverCache = nullptr;
-    }
-
     update();
 }
 
-void KItemListWidget::clearHoverCache()
-{
-    delete m_hoverCache;
-    m_hoverCache = nullptr;
-}
-
 bool KItemListWidget::isPressed() const
 {
     return m_clickHighlighted;
@@ -614,27 +626,53 @@ void KItemListWidget::setPressed(bool enabled)
 {
     if (m_clickHighlighted != enabled) {
         m_clickHighlighted = enabled;
-        clearHoverCache();
         update();
     }
 }
 
 void KItemListWidget::drawItemStyleOption(QPainter *painter, QWidget *widget, QStyle::State styleState)
 {
-    QStyleOptionViewItem viewItemOption;
+    const bool current = m_current && styleState & QStyle::State_Active;
+
+    const QRectF rectFull = selectionRectFull();
+    if (rectFull.isEmpty()) {
+        return;
+    }
+
+    // The chrome is rendered at the fractional part of the rect position, so
+    // blitting the shared pixmap at the floored position reproduces the same
+    // raster as painting the path directly would.
+    const QPointF origin(qFloor(rectFull.x()), qFloor(rectFull.y()));
+    const QRectF localRect = rectFull.translated(-origin);
+    const qreal devicePixelRatio = widget->devicePixelRatioF();
+
+    const QColor accentColor = widget->palette().color(QPalette::Accent);
+    const QColor textColor = widget->palette().color(QPalette::Text);
+    const QColor baseColor = m_styleOption.palette.color(QPalette::Base);
+
+    const QString key = QString::number(localRect.x()) % QLatin1Char(',') % QString::number(localRect.y()) % QLatin1Char(':')
+        % QString::number(localRect.width()) % QLatin1Char('x') % QString::number(localRect.height()) % QLatin1Char('@')
+        % QString::number(devicePixelRatio) % QLatin1Char('|') % QString::number((m_clickHighlighted << 3) | (m_selected << 2) | (m_hovered << 1) | current)
+        % QLatin1Char('|') % QString::number(accentColor.rgba(), 16) % QLatin1Char('-') % QString::number(textColor.rgba(), 16) % QLatin1Char('-')
+        % QString::number(baseColor.rgba(), 16);
+
+    if (const QPixmap *cachedChrome = g_chromeCache.object(key)) {
+        painter->drawPixmap(origin, *cachedChrome);
+        return;
+    }
+
+    QPixmap chrome(QSize(qCeil(localRect.right() * devicePixelRatio), qCeil(localRect.bottom() * devicePixelRatio)));
+    chrome.setDevicePixelRatio(devicePixelRatio);
+    chrome.fill(Qt::transparent);
+
+    QPainter chromePainter(&chrome);
     constexpr int roundness = 5; // From Breeze style.
     constexpr qreal penWidth = 1.25;
-    initStyleOption(&viewItemOption);
-    viewItemOption.state = styleState;
-    viewItemOption.viewItemPosition = QStyleOptionViewItem::OnlyOne;
-    viewItemOption.showDecorationSelected = true;
-    viewItemOption.rect = selectionRectFull().toRect();
     QPainterPath path;
     const qreal adjustment = 0.5 * penWidth; // Use same adjustments as Breeze strokedRect uses, to snap to pixelGrid.
-    path.addRoundedRect(selectionRectFull().adjusted(adjustment, adjustment, -adjustment, -adjustment), roundness, roundness);
-    QColor backgroundColor{widget->palette().color(QPalette::Accent)};
-    painter->setRenderHint(QPainter::Antialiasing);
-    bool current = m_current && styleState & QStyle::State_Active;
+    path.addRoundedRect(localRect.adjusted(adjustment, adjustment, -adjustment, -adjustment), roundness, roundness);
+    QColor backgroundColor{accentColor};
+    chromePainter.setRenderHint(QPainter::Antialiasing);
 
     // Background item, alpha values are from
     // https://invent.kde.org/plasma/libplasma/-/blob/master/src/desktoptheme/breeze/widgets/viewitem.svg
@@ -648,23 +686,27 @@ void KItemListWidget::drawItemStyleOption(QPainter *painter, QWidget *widget, QS
         } else if (m_selected) {
             backgroundColor.setAlphaF(0.32);
         } else if (m_hovered) {
-            backgroundColor = widget->palette().color(QPalette::Text);
+            backgroundColor = textColor;
             backgroundColor.setAlphaF(0.06);
         }
     }
 
-    painter->fillPath(path, backgroundColor);
+    chromePainter.fillPath(path, backgroundColor);
 
     // Focus decoration
     if (current) {
-        QColor focusColor{widget->palette().color(QPalette::Accent)};
-        focusColor = m_styleOption.palette.color(QPalette::Base).lightnessF() > 0.5 ? focusColor.darker(110) : focusColor.lighter(110);
+        QColor focusColor{accentColor};
+        focusColor = baseColor.lightnessF() > 0.5 ? focusColor.darker(110) : focusColor.lighter(110);
         focusColor.setAlphaF(m_selected || m_hovered ? 1.0 : 0.8);
         // Set the pen color lighter or darker depending on background color
         QPen pen{focusColor, penWidth};
         pen.setCosmetic(true);
-        painter->strokePath(path, pen);
+        chromePainter.strokePath(path, pen);
     }
+    chromePainter.end();
+
+    painter->drawPixmap(origin, chrome);
+    g_chromeCache.insert(key, new QPixmap(chrome), chrome.width() * chrome.height() * chrome.depth() / 8);
 }
 
 #include "moc_kitemlistwidget.cpp"
@@ -162,6 +162,22 @@ public:
      */
     virtual QRectF textFocusRect() const;
 
+    /**
+     * @return Area that has to be repainted when the given roles have changed.
+     *         Per default the whole widget is returned. Derived classes may
+     *         return a smaller area so that items which receive streaming
+     *         updates of single roles (e.g. directory size counts) only
+     *         repaint the affected cells.
+     */
+    virtual QRectF damageRect(const QSet<QByteArray> &changedRoles) const;
+
+    /**
+     * @return An estimate of the bytes held by this widget including cached
+     *         pixmaps. Used for the memory accounting of the widget pool,
+     *         see KMemoryAccounting.
+     */
+    virtual qint64 estimatedMemoryUsageBytes() const;
+
     /**
      * Used for drawing the visuals, and situations where we want the behavior of the
      * selection to match the visuals.
@@ -219,7 +235,6 @@ protected:
     virtual void editedRoleChanged(const QByteArray &current, const QByteArray &previous);
     virtual void iconSizeChanged(int current, int previous);
     void resizeEvent(QGraphicsSceneResizeEvent *event) override;
-    void clearHoverCache();
 
     /**
      * Called when the user starts hovering this item.
@@ -254,6 +269,13 @@ private Q_SLOTS:
 private:
     void initializeSelectionToggle();
     void setHoverOpacity(qreal opacity);
+
+    /**
+     * Draws the selection/hover chrome for the current state. The rendered
+     * chrome only depends on the selection rect size, the state and the
+     * palette, so it is blitted from a pixmap cache which is shared between
+     * all item widgets of this process.
+     */
     void drawItemStyleOption(QPainter *painter, QWidget *widget, QStyle::State styleState);
 
 private:
@@ -275,7 +297,6 @@ private:
     QBitArray m_siblingsInfo;
 
     qreal m_hoverOpacity;
-    mutable QPixmap *m_hoverCache;
 
     int m_hoverSequenceIndex;
     QTimer m_hoverSequenceTimer;
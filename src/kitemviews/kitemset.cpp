@@ -6,6 +6,8 @@
 
 #include "kitemset.h"
 
+#include <algorithm>
+
 KItemSet::iterator KItemSet::insert(int i)
 {
     if (m_itemRanges.empty()) {
@@ -254,6 +256,161 @@ KItemSet KItemSet::operator^(const KItemSet &other) const
     return result;
 }
 
+KItemSet KItemSet::operator-(const KItemSet &other) const
+{
+    KItemSet difference;
+
+    KItemRangeList::const_iterator it2 = other.m_itemRanges.constBegin();
+    const KItemRangeList::const_iterator end2 = other.m_itemRanges.constEnd();
+
+    for (const KItemRange &range : std::as_const(m_itemRanges)) {
+        int index = range.index;
+        const int endIndex = range.index + range.count;
+
+        while (index < endIndex) {
+            // Skip the ranges of 'other' which end before the current position.
+            // it2 never moves backwards as both range lists are sorted.
+            while (it2 != end2 && it2->index + it2->count <= index) {
+                ++it2;
+            }
+
+            if (it2 == end2 || it2->index >= endIndex) {
+                // Nothing is removed from the remaining part of the range.
+                difference.m_itemRanges.append(KItemRange(index, endIndex - index));
+                break;
+            }
+
+            if (it2->index > index) {
+                // Keep the part in front of the overlapping range of 'other'.
+                difference.m_itemRanges.append(KItemRange(index, it2->index - index));
+            }
+
+            // Continue behind the removed part.
+            index = it2->index + it2->count;
+        }
+    }
+
+    return difference;
+}
+
+KItemSet KItemSet::operator&(const KItemSet &other) const
+{
+    KItemSet intersection;
+
+    KItemRangeList::const_iterator it1 = m_itemRanges.constBegin();
+    KItemRangeList::const_iterator it2 = other.m_itemRanges.constBegin();
+
+    const KItemRangeList::const_iterator end1 = m_itemRanges.constEnd();
+    const KItemRangeList::const_iterator end2 = other.m_itemRanges.constEnd();
+
+    while (it1 != end1 && it2 != end2) {
+        const int overlapBegin = qMax(it1->index, it2->index);
+        const int overlapEnd = qMin(it1->index + it1->count, it2->index + it2->count);
+        if (overlapBegin < overlapEnd) {
+            intersection.m_itemRanges.append(KItemRange(overlapBegin, overlapEnd - overlapBegin));
+        }
+
+        // Advance the range that ends first.
+        if (it1->index + it1->count < it2->index + it2->count) {
+            ++it1;
+        } else {
+            ++it2;
+        }
+    }
+
+    return intersection;
+}
+
+KItemSet KItemSet::afterItemsMoved(const KItemRange &itemRange, const QList<int> &movedToIndexes) const
+{
+    Q_ASSERT(itemRange.count == movedToIndexes.count());
+
+    const int moveBegin = itemRange.index;
+    const int moveEnd = itemRange.index + itemRange.count;
+
+    // Collect the mapped ranges. Parts outside the moved range are taken over
+    // unchanged. Parts inside are split at the boundaries of the maximal
+    // consecutive runs of movedToIndexes and each piece is moved as a whole.
+    // After a resort only few items change their relative position, so the
+    // runs are long and the number of pieces stays close to the number of
+    // stored ranges.
+    KItemRangeList mappedRanges;
+    mappedRanges.reserve(m_itemRanges.count());
+
+    for (const KItemRange &range : m_itemRanges) {
+        int index = range.index;
+        int remaining = range.count;
+
+        if (index < moveBegin) {
+            const int count = qMin(remaining, moveBegin - index);
+            mappedRanges.append(KItemRange(index, count));
+            index += count;
+            remaining -= count;
+        }
+
+        while (remaining > 0 && index < moveEnd) {
+            const int offset = index - moveBegin;
+            const int newIndex = movedToIndexes.at(offset);
+            const int maxRunLength = qMin(remaining, moveEnd - index);
+            int runLength = 1;
+            while (runLength < maxRunLength && movedToIndexes.at(offset + runLength) == newIndex + runLength) {
+                ++runLength;
+            }
+            mappedRanges.append(KItemRange(newIndex, runLength));
+            index += runLength;
+            remaining -= runLength;
+        }
+
+        if (remaining > 0) {
+            mappedRanges.append(KItemRange(index, remaining));
+        }
+    }
+
+    // The moved pieces are in general not in ascending order anymore. Restore
+    // the order and merge pieces which became adjacent.
+    std::sort(mappedRanges.begin(), mappedRanges.end(), [](const KItemRange &a, const KItemRange &b) {
+        return a.index < b.index;
+    });
+
+    KItemSet result;
+    result.m_itemRanges.reserve(mappedRanges.count());
+    for (const KItemRange &range : std::as_const(mappedRanges)) {
+        if (!result.m_itemRanges.isEmpty()) {
+            KItemRange &last = result.m_itemRanges.last();
+            if (range.index == last.index + last.count) {
+                last.count += range.count;
+                continue;
+            }
+        }
+        result.m_itemRanges.append(range);
+    }
+
+    Q_ASSERT(result.isValid());
+    return result;
+}
+
+void KItemSet::insertRange(int index, int count)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    KItemSet rangeSet;
+    rangeSet.m_itemRanges.append(KItemRange(index, count));
+    *this = *this + rangeSet;
+}
+
+void KItemSet::removeRange(int index, int count)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    KItemSet rangeSet;
+    rangeSet.m_itemRanges.append(KItemRange(index, count));
+    *this = *this - rangeSet;
+}
+
 bool KItemSet::isValid() const
 {
     const KItemRangeList::const_iterator begin = m_itemRanges.constBegin();
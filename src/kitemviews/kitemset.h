@@ -320,6 +320,44 @@ public:
      */
     KItemSet operator^(const KItemSet &other) const;
 
+    /**
+     * Returns a new set which contains all items of this KItemSet that are
+     * not contained in \a other (the set difference).
+     */
+    KItemSet operator-(const KItemSet &other) const;
+
+    /**
+     * Returns a new set which contains all items that are contained in both
+     * this KItemSet and in \a other (the intersection of both KItemSets).
+     */
+    KItemSet operator&(const KItemSet &other) const;
+
+    /**
+     * Returns a new set in which all items covered by \a itemRange are mapped
+     * to their new positions according to \a movedToIndexes, which contains
+     * the new index for every item of \a itemRange. Items outside
+     * \a itemRange keep their positions.
+     *
+     * The stored ranges are mapped wholesale: they are split at the
+     * boundaries of the maximal consecutive runs of \a movedToIndexes and
+     * each piece is moved as one range. The complexity hence depends on the
+     * number of ranges in the input and the result, not on the number of
+     * stored items.
+     */
+    KItemSet afterItemsMoved(const KItemRange &itemRange, const QList<int> &movedToIndexes) const;
+
+    /**
+     * Inserts the \a count consecutive items starting at \a index into the
+     * set. Complexity: O(number of ranges), independent of \a count.
+     */
+    void insertRange(int index, int count);
+
+    /**
+     * Removes the \a count consecutive items starting at \a index from the
+     * set. Complexity: O(number of ranges), independent of \a count.
+     */
+    void removeRange(int index, int count);
+
     KItemSet &operator<<(int i);
 
 private:
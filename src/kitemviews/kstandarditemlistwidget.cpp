@@ -7,11 +7,13 @@
 #include "kstandarditemlistwidget.h"
 
 #include "dolphin_contentdisplaysettings.h"
+#include "dolphinstartupprofiler.h"
 #include "kfileitemlistview.h"
-#include "private/kfileitemclipboard.h"
 #include "private/kitemlistroleeditor.h"
 #include "private/kitemviewsutils.h"
 #include "private/kpixmapmodifier.h"
+#include "private/kstatictextcache.h"
+#include "private/ktextmeasurementcache.h"
 
 #include <KIconEffect>
 #include <KIconLoader>
@@ -21,16 +23,43 @@
 #include <klocalizedstring.h>
 
 #include <QApplication>
+#include <QCache>
 #include <QGraphicsScene>
 #include <QGraphicsSceneResizeEvent>
 #include <QGraphicsView>
 #include <QPixmapCache>
 #include <QStyleOption>
 #include <QTextBoundaryFinder>
+#include <QTimer>
 #include <QVariantAnimation>
+#include <QtConcurrentMap>
 
 // #define KSTANDARDITEMLISTWIDGET_DEBUG
 
+namespace
+{
+// Number of unresolved size hints from which on the text measurement is
+// distributed over the thread pool instead of running in a plain loop.
+const int ParallelMeasurementThreshold = 1000;
+
+// Budget of the icon+emblem composition cache in kilobytes. Most items of
+// a view share a handful of emblem combinations, so the cache stays small
+// in practice even for huge directories.
+const int ComposedPixmapCacheCostLimit = 8 * 1024;
+
+// Model data of an item whose size hint still has to be measured. The data
+// is fetched up front on the GUI thread because reading the model lazily
+// materializes roles and is not thread-safe. The measurement itself only
+// depends on this data and may then run on the thread pool.
+struct UnresolvedItemMeasurement {
+    int index;
+    bool isLink;
+    QStringList texts;
+};
+}
+
+qint64 KStandardItemListWidget::s_paintScratchBufferAllocations = 0;
+
 KStandardItemListWidgetInformant::KStandardItemListWidgetInformant()
     : KItemListWidgetInformant()
 {
@@ -151,42 +180,62 @@ void KStandardItemListWidgetInformant::calculateIconsLayoutItemSizeHints(QVector
     QTextOption textOption(Qt::AlignHCenter);
     textOption.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
 
-    for (int index = 0; index < logicalHeightHints.count(); ++index) {
-        if (logicalHeightHints.at(index).first > 0.0) {
-            continue;
-        }
-
+    const auto measureItem = [&](const UnresolvedItemMeasurement &item) {
         // If the current item is a link, we use the customized link font instead of the normal font.
-        const QFont &font = itemIsLink(index, view) ? linkFont : normalFont;
+        const QFont &font = item.isLink ? linkFont : normalFont;
 
-        const QString &text = KStringHandler::preProcessWrap(itemText(index, view));
+        const QString &text = KStringHandler::preProcessWrap(item.texts.first());
 
-        // Calculate the number of lines required for wrapping the name
+        // Calculate the number of lines required for wrapping the name.
+        // The result only depends on the font, the width and the string,
+        // so it is shared between all views of the process.
         qreal textHeight = 0;
-        QTextLayout layout(text, font);
-        layout.setTextOption(textOption);
-        layout.beginLayout();
-        QTextLine line;
-        int lineCount = 0;
         bool isElided = false;
-        while ((line = layout.createLine()).isValid()) {
-            line.setLineWidth(maxWidth);
-            line.naturalTextWidth();
-            textHeight += line.height();
-
-            ++lineCount;
-            if (lineCount == option.maxTextLines) {
-                isElided = layout.createLine().isValid();
-                break;
+        if (!KTextMeasurementCache::instance()->lookup(font, maxWidth, text, &textHeight, &isElided)) {
+            QTextLayout layout(text, font);
+            layout.setTextOption(textOption);
+            layout.beginLayout();
+            QTextLine line;
+            int lineCount = 0;
+            while ((line = layout.createLine()).isValid()) {
+                line.setLineWidth(maxWidth);
+                line.naturalTextWidth();
+                textHeight += line.height();
+
+                ++lineCount;
+                if (lineCount == option.maxTextLines) {
+                    isElided = layout.createLine().isValid();
+                    break;
+                }
             }
+            layout.endLayout();
+
+            KTextMeasurementCache::instance()->insert(font, maxWidth, text, textHeight, isElided);
         }
-        layout.endLayout();
 
         // Add one line for each additional information
         textHeight += additionalRolesSpacing;
 
-        logicalHeightHints[index].first = textHeight + spacingAndIconHeight;
-        logicalHeightHints[index].second = isElided;
+        logicalHeightHints[item.index].first = textHeight + spacingAndIconHeight;
+        logicalHeightHints[item.index].second = isElided;
+    };
+
+    QList<UnresolvedItemMeasurement> unresolvedItems;
+    for (int index = 0; index < logicalHeightHints.count(); ++index) {
+        if (logicalHeightHints.at(index).first <= 0.0) {
+            unresolvedItems.append({index, itemIsLink(index, view), {itemText(index, view)}});
+        }
+    }
+
+    if (unresolvedItems.count() >= ParallelMeasurementThreshold) {
+        // Each item only reads its pre-fetched data and writes to its own
+        // slot of logicalHeightHints, so the measurements are independent
+        // and can run on the thread pool.
+        QtConcurrent::blockingMap(unresolvedItems, measureItem);
+    } else {
+        for (const UnresolvedItemMeasurement &item : unresolvedItems) {
+            measureItem(item);
+        }
     }
 
     logicalWidthHint = itemWidth;
@@ -206,37 +255,66 @@ void KStandardItemListWidgetInformant::calculateCompactLayoutItemSizeHints(QVect
     const qreal paddingAndIconWidth = option.padding * 4 + option.iconSize;
     const qreal height = option.padding * 2 + qMax(option.iconSize, (1 + additionalRolesCount) * normalFontMetrics.lineSpacing());
 
-    const QFontMetrics linkFontMetrics(customizedFontForLinks(option.font));
-
-    for (int index = 0; index < logicalHeightHints.count(); ++index) {
-        if (logicalHeightHints.at(index).first > 0.0) {
-            continue;
-        }
+    const QFont linkFont = customizedFontForLinks(option.font);
+    const QFontMetrics linkFontMetrics(linkFont);
 
+    const auto measureItem = [&](const UnresolvedItemMeasurement &item) {
         // If the current item is a link, we use the customized link font metrics instead of the normal font metrics.
-        const QFontMetrics &fontMetrics = itemIsLink(index, view) ? linkFontMetrics : normalFontMetrics;
+        const QFontMetrics &fontMetrics = item.isLink ? linkFontMetrics : normalFontMetrics;
+        const QFont &font = item.isLink ? linkFont : option.font;
+
+        // A negative line width keys the cache entries for unbounded
+        // single-line measurements.
+        const auto cachedAdvance = [&fontMetrics, &font](const QString &text) {
+            qreal advance = 0.0;
+            bool elided = false;
+            if (!KTextMeasurementCache::instance()->lookup(font, -1.0, text, &advance, &elided)) {
+                advance = fontMetrics.horizontalAdvance(text);
+                KTextMeasurementCache::instance()->insert(font, -1.0, text, advance, false);
+            }
+            return advance;
+        };
 
         // For each row exactly one role is shown. Calculate the maximum required width that is necessary
         // to show all roles without horizontal clipping.
         qreal maximumRequiredWidth = 0.0;
+        for (const QString &text : item.texts) {
+            const qreal requiredWidth = cachedAdvance(text);
+            maximumRequiredWidth = qMax(maximumRequiredWidth, requiredWidth);
+        }
+
+        qreal width = paddingAndIconWidth + maximumRequiredWidth;
+        if (maxWidth > 0 && width > maxWidth) {
+            width = maxWidth;
+        }
+
+        logicalHeightHints[item.index].first = width;
+    };
+
+    QList<UnresolvedItemMeasurement> unresolvedItems;
+    for (int index = 0; index < logicalHeightHints.count(); ++index) {
+        if (logicalHeightHints.at(index).first > 0.0) {
+            continue;
+        }
 
+        UnresolvedItemMeasurement item{index, itemIsLink(index, view), {}};
         if (showOnlyTextRole) {
-            maximumRequiredWidth = fontMetrics.horizontalAdvance(itemText(index, view));
+            item.texts.append(itemText(index, view));
         } else {
-            const QHash<QByteArray, QVariant> &values = view->model()->data(index);
+            const QHash<QByteArray, QVariant> values = view->model()->data(index);
             for (const QByteArray &role : visibleRoles) {
-                const QString &text = roleText(role, values);
-                const qreal requiredWidth = fontMetrics.horizontalAdvance(text);
-                maximumRequiredWidth = qMax(maximumRequiredWidth, requiredWidth);
+                item.texts.append(roleText(role, values));
             }
         }
+        unresolvedItems.append(item);
+    }
 
-        qreal width = paddingAndIconWidth + maximumRequiredWidth;
-        if (maxWidth > 0 && width > maxWidth) {
-            width = maxWidth;
+    if (unresolvedItems.count() >= ParallelMeasurementThreshold) {
+        QtConcurrent::blockingMap(unresolvedItems, measureItem);
+    } else {
+        for (const UnresolvedItemMeasurement &item : unresolvedItems) {
+            measureItem(item);
         }
-
-        logicalHeightHints[index].first = width;
     }
 
     logicalWidthHint = height;
@@ -265,6 +343,7 @@ KStandardItemListWidget::KStandardItemListWidget(KItemListWidgetInformant *infor
     , m_dirtyLayout(true)
     , m_dirtyContent(true)
     , m_dirtyContentRoles()
+    , m_iconResolutionScheduled(false)
     , m_layout(IconsLayout)
     , m_pixmapPos()
     , m_pixmap()
@@ -278,6 +357,12 @@ KStandardItemListWidget::KStandardItemListWidget(KItemListWidgetInformant *infor
     , m_additionalInfoTextColor()
     , m_overlays()
     , m_rating()
+    , m_overlaidPixmap()
+    , m_overlaidPixmapSourceKey(0)
+    , m_overlaidPixmapMaxSize()
+    , m_overlaidPixmapDpr(0)
+    , m_hoverBlendPixmap()
+    , m_hoverBlendBuffer()
     , m_roleEditor(nullptr)
     , m_oldRoleEditor(nullptr)
 {
@@ -337,6 +422,9 @@ bool KStandardItemListWidget::supportsItemExpanding() const
 
 void KStandardItemListWidget::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
+    // A no-op after the first item of this process has been painted.
+    DolphinStartupProfiler::instance()->recordPhase(DolphinStartupProfiler::FirstDirectoryPainted);
+
     const_cast<KStandardItemListWidget *>(this)->triggerCacheRefreshing();
 
     KItemListWidget::paint(painter, option, widget);
@@ -356,8 +444,19 @@ void KStandardItemListWidget::paint(QPainter *painter, const QStyleOptionGraphic
         const int widgetIconSize = styleOption().iconSize;
         const int maxIconWidth = iconOnTop ? size().width() - 2 * padding : widgetIconSize;
         const int maxIconHeight = widgetIconSize;
-
-        pixmap = addOverlays(pixmap, m_overlays, QSize(maxIconWidth, maxIconHeight), dpr);
+        const QSize maxIconSize(maxIconWidth, maxIconHeight);
+
+        // Composing the overlays - or even just building the key for the
+        // composition cache - allocates, so keep the composed pixmap around
+        // and only recreate it when its inputs changed since the last frame.
+        if (m_overlaidPixmapSourceKey != m_pixmap.cacheKey() || m_overlaidPixmapMaxSize != maxIconSize || m_overlaidPixmapDpr != dpr) {
+            m_overlaidPixmap = addOverlays(pixmap, m_overlays, maxIconSize, dpr);
+            m_overlaidPixmapSourceKey = m_pixmap.cacheKey();
+            m_overlaidPixmapMaxSize = maxIconSize;
+            m_overlaidPixmapDpr = dpr;
+            ++s_paintScratchBufferAllocations;
+        }
+        pixmap = m_overlaidPixmap;
     }
 
     const KItemListStyleOption &itemListStyleOption = styleOption();
@@ -370,37 +469,44 @@ void KStandardItemListWidget::paint(QPainter *painter, const QStyleOptionGraphic
              * pixmap, even if the opacities are adjusted. For details see
              * https://git.reviewboard.kde.org/r/109614/
              */
-            // Paint pixmap1 so that pixmap1 = pixmap * (1.0 - hoverOpacity())
-            QPixmap pixmap1(pixmap.size());
-            pixmap1.setDevicePixelRatio(pixmap.devicePixelRatio());
-            pixmap1.fill(Qt::transparent);
+            // The two blend buffers are kept as members so that consecutive
+            // frames of the fade animation reuse them instead of allocating
+            // two full-size pixmaps per item per frame.
+            if (m_hoverBlendPixmap.size() != pixmap.size() || m_hoverBlendPixmap.devicePixelRatio() != pixmap.devicePixelRatio()) {
+                m_hoverBlendPixmap = QPixmap(pixmap.size());
+                m_hoverBlendPixmap.setDevicePixelRatio(pixmap.devicePixelRatio());
+                m_hoverBlendBuffer = QPixmap(pixmap.size());
+                m_hoverBlendBuffer.setDevicePixelRatio(pixmap.devicePixelRatio());
+                ++s_paintScratchBufferAllocations;
+            }
+
+            // Paint m_hoverBlendPixmap so that m_hoverBlendPixmap = pixmap * (1.0 - hoverOpacity())
+            m_hoverBlendPixmap.fill(Qt::transparent);
             {
-                QPainter p(&pixmap1);
+                QPainter p(&m_hoverBlendPixmap);
                 p.setOpacity(1.0 - hoverOpacity());
                 p.drawPixmap(0, 0, pixmap);
             }
 
-            // Paint pixmap2 so that pixmap2 = m_hoverPixmap * hoverOpacity()
-            QPixmap pixmap2(pixmap1.size());
-            pixmap2.setDevicePixelRatio(pixmap1.devicePixelRatio());
-            pixmap2.fill(Qt::transparent);
+            // Paint m_hoverBlendBuffer so that m_hoverBlendBuffer = m_hoverPixmap * hoverOpacity()
+            m_hoverBlendBuffer.fill(Qt::transparent);
             {
-                QPainter p(&pixmap2);
+                QPainter p(&m_hoverBlendBuffer);
                 p.setOpacity(hoverOpacity());
                 p.drawPixmap(0, 0, m_pixmap);
             }
 
-            // Paint pixmap2 on pixmap1 using CompositionMode_Plus
-            // Now pixmap1 = pixmap2 + pixmap * (1.0 - hoverOpacity())
-            //             = m_hoverPixmap * hoverOpacity() + pixmap * (1.0 - hoverOpacity())
+            // Paint m_hoverBlendBuffer on m_hoverBlendPixmap using CompositionMode_Plus
+            // Now m_hoverBlendPixmap = m_hoverBlendBuffer + pixmap * (1.0 - hoverOpacity())
+            //                        = m_hoverPixmap * hoverOpacity() + pixmap * (1.0 - hoverOpacity())
             {
-                QPainter p(&pixmap1);
+                QPainter p(&m_hoverBlendPixmap);
                 p.setCompositionMode(QPainter::CompositionMode_Plus);
-                p.drawPixmap(0, 0, pixmap2);
+                p.drawPixmap(0, 0, m_hoverBlendBuffer);
             }
 
-            // Finally paint pixmap1 on the widget
-            drawPixmap(painter, pixmap1);
+            // Finally paint the blended pixmap on the widget
+            drawPixmap(painter, m_hoverBlendPixmap);
         } else {
             drawPixmap(painter, pixmap);
         }
@@ -479,6 +585,10 @@ void KStandardItemListWidget::paint(QPainter *painter, const QStyleOptionGraphic
 
     painter->setPen(Qt::red);
     painter->drawText(QPointF(0, m_customizedFontMetrics.height()), QString::number(index()));
+    // Process-wide count of paint-path scratch-buffer allocations: if the
+    // number keeps climbing while the view idles, some repaint is allocating
+    // every frame.
+    painter->drawText(QPointF(0, 2 * m_customizedFontMetrics.height()), QString::number(s_paintScratchBufferAllocations));
     painter->drawRect(rect());
 #endif
 }
@@ -530,6 +640,69 @@ QRectF KStandardItemListWidget::textFocusRect() const
     return m_textRect;
 }
 
+QRectF KStandardItemListWidget::damageRect(const QSet<QByteArray> &changedRoles) const
+{
+    // Changes of the name can rewrap the text and move all other roles, and
+    // a pending layout change invalidates the cached positions anyhow.
+    if (m_dirtyLayout || m_textInfo.isEmpty() || changedRoles.contains("text") || changedRoles.contains("iconPixmap") || changedRoles.contains("iconName")
+        || changedRoles.contains("iconOverlays")) {
+        return KItemListWidget::damageRect(changedRoles);
+    }
+
+    // The extents of the selection- and hover-chrome follow the text
+    // rectangle, which might grow or shrink with the new values.
+    if (isSelected() || isHovered() || isCurrent()) {
+        return KItemListWidget::damageRect(changedRoles);
+    }
+
+    // dataChanged() marks the icon as dirty on every change as its state
+    // might depend on other roles, so it gets repainted unconditionally.
+    QRectF damage = m_iconRect;
+
+    for (const QByteArray &role : changedRoles) {
+        const TextInfo *textInfo = m_textInfo.value(role);
+        if (!textInfo) {
+            // The role is not shown by this widget.
+            continue;
+        }
+
+        if (m_layout == DetailsLayout) {
+            // Repaint the whole column of the role. The column grid does not
+            // depend on the shown values, so the cell covers both the old and
+            // the new text independent of how their widths differ.
+            qreal x = leftPadding();
+            for (const QByteArray &visibleRole : std::as_const(m_sortedVisibleRoles)) {
+                const qreal roleWidth = columnWidth(visibleRole);
+                if (visibleRole == role) {
+                    const qreal left = (layoutDirection() == Qt::LeftToRight) ? x : size().width() - x - roleWidth;
+                    damage |= QRectF(left, 0, roleWidth, size().height());
+                    break;
+                }
+                x += roleWidth;
+            }
+        } else {
+            // Repaint the whole text line of the role: the new text might be
+            // centered or elided differently than the old one.
+            damage |= QRectF(0, textInfo->pos.y(), size().width(), m_customizedFontMetrics.lineSpacing());
+        }
+    }
+
+    return damage;
+}
+
+qint64 KStandardItemListWidget::estimatedMemoryUsageBytes() const
+{
+    // Besides the object itself the cached icon pixmap dominates, especially
+    // with previews at large zoom levels.
+    qint64 bytes = sizeof(KStandardItemListWidget);
+    bytes += static_cast<qint64>(m_pixmap.width()) * m_pixmap.height() * m_pixmap.depth() / 8;
+    bytes += static_cast<qint64>(m_rating.width()) * m_rating.height() * m_rating.depth() / 8;
+    bytes += static_cast<qint64>(m_overlaidPixmap.width()) * m_overlaidPixmap.height() * m_overlaidPixmap.depth() / 8;
+    bytes += static_cast<qint64>(m_hoverBlendPixmap.width()) * m_hoverBlendPixmap.height() * m_hoverBlendPixmap.depth() / 8;
+    bytes += static_cast<qint64>(m_hoverBlendBuffer.width()) * m_hoverBlendBuffer.height() * m_hoverBlendBuffer.depth() / 8;
+    return bytes;
+}
+
 QRectF KStandardItemListWidget::selectionRectFull() const
 {
     const_cast<KStandardItemListWidget *>(this)->triggerCacheRefreshing();
@@ -666,6 +839,16 @@ KItemListWidgetInformant *KStandardItemListWidget::createInformant()
     return new KStandardItemListWidgetInformant();
 }
 
+qint64 KStandardItemListWidget::paintScratchBufferAllocations()
+{
+    return s_paintScratchBufferAllocations;
+}
+
+void KStandardItemListWidget::resetPaintScratchBufferAllocations()
+{
+    s_paintScratchBufferAllocations = 0;
+}
+
 void KStandardItemListWidget::invalidateCache()
 {
     m_dirtyLayout = true;
@@ -738,6 +921,7 @@ void KStandardItemListWidget::setOverlays(QHash<Qt::Corner, QString> &overlays)
     }
 
     m_overlays = overlays;
+    m_overlaidPixmapSourceKey = 0; // The cached composition pairs m_pixmap with the old overlays.
     m_dirtyContent = true;
     m_dirtyContentRoles.insert("iconOverlays");
     update();
@@ -767,11 +951,15 @@ void KStandardItemListWidget::dataChanged(const QHash<QByteArray, QVariant> &cur
         dirtyRoles = roles;
     }
 
-    // The URL might have changed (i.e., if the sort order of the items has
-    // been changed). Therefore, the "is cut" state must be updated.
-    KFileItemClipboard *clipboard = KFileItemClipboard::instance();
-    const QUrl itemUrl = data().value("url").toUrl();
-    m_isCut = clipboard->isCut(itemUrl);
+    // The model caches the cut state per item and updates it on clipboard
+    // changes, see KFileItemModel::slotCutItemsChanged(). Reading the bit
+    // here avoids a lookup in the cut URLs for every data change, which is
+    // expensive while scrolling when many items have been cut.
+    const bool isCut = data().value("isCut").toBool();
+    if (m_isCut != isCut) {
+        m_isCut = isCut;
+        m_pixmap = QPixmap();
+    }
 
     // The icon-state might depend from other roles and hence is
     // marked as dirty whenever a role has been changed
@@ -820,6 +1008,13 @@ void KStandardItemListWidget::hoveredChanged(bool hovered)
     if (!hovered && m_activateSoonAnimation) {
         m_activateSoonAnimation->stop(); // automatically DeleteWhenStopped
     }
+    if (!hovered) {
+        // Only the handful of widgets the mouse is sweeping over need the
+        // blend buffers; do not pin two icon-sized pixmaps on every widget
+        // that was hovered once.
+        m_hoverBlendPixmap = QPixmap();
+        m_hoverBlendBuffer = QPixmap();
+    }
     m_dirtyLayout = true;
 }
 
@@ -930,26 +1125,6 @@ void KStandardItemListWidget::resizeEvent(QGraphicsSceneResizeEvent *event)
     m_dirtyLayout = true;
 }
 
-void KStandardItemListWidget::showEvent(QShowEvent *event)
-{
-    KItemListWidget::showEvent(event);
-
-    // Listen to changes of the clipboard to mark the item as cut/uncut
-    KFileItemClipboard *clipboard = KFileItemClipboard::instance();
-
-    const QUrl itemUrl = data().value("url").toUrl();
-    m_isCut = clipboard->isCut(itemUrl);
-
-    connect(clipboard, &KFileItemClipboard::cutItemsChanged, this, &KStandardItemListWidget::slotCutItemsChanged);
-}
-
-void KStandardItemListWidget::hideEvent(QHideEvent *event)
-{
-    disconnect(KFileItemClipboard::instance(), &KFileItemClipboard::cutItemsChanged, this, &KStandardItemListWidget::slotCutItemsChanged);
-
-    KItemListWidget::hideEvent(event);
-}
-
 bool KStandardItemListWidget::event(QEvent *event)
 {
     if (event->type() == QEvent::WindowDeactivate || event->type() == QEvent::WindowActivate || event->type() == QEvent::PaletteChange) {
@@ -966,18 +1141,6 @@ void KStandardItemListWidget::finishRoleEditing()
     }
 }
 
-void KStandardItemListWidget::slotCutItemsChanged()
-{
-    const QUrl itemUrl = data().value("url").toUrl();
-    const bool isCut = KFileItemClipboard::instance()->isCut(itemUrl);
-    if (m_isCut != isCut) {
-        m_isCut = isCut;
-        m_pixmap = QPixmap();
-        m_dirtyContent = true;
-        update();
-    }
-}
-
 void KStandardItemListWidget::slotRoleEditingCanceled(const QByteArray &role, const QVariant &value)
 {
     closeRoleEditor();
@@ -1012,7 +1175,6 @@ void KStandardItemListWidget::triggerCacheRefreshing()
     updateExpansionArea();
     updateTextsCache();
     updatePixmapCache();
-    clearHoverCache();
 
     m_dirtyLayout = false;
     m_dirtyContent = false;
@@ -1105,15 +1267,46 @@ void KStandardItemListWidget::updatePixmapCache()
                 iconName = QStringLiteral("unknown");
             }
             const bool hasFocus = scene()->views()[0]->parentWidget()->hasFocus();
-            m_pixmap = pixmapForIcon(iconName,
-                                     QSize(maxIconWidth, maxIconHeight),
-                                     m_layout != IconsLayout && isActiveWindow() && isPressed() && hasFocus ? QIcon::Selected : QIcon::Normal);
+            const QSize maxIconSize(maxIconWidth, maxIconHeight);
+            const QIcon::Mode mode = m_layout != IconsLayout && isActiveWindow() && isPressed() && hasFocus ? QIcon::Selected : QIcon::Normal;
+            if (QPixmapCache::find(pixmapCacheKeyForIcon(iconName, maxIconSize, mode), &m_pixmap)) {
+                m_pixmap.setDevicePixelRatio(dpr);
+            } else {
+                // The icon has not been rendered yet, so resolving it now would hit the
+                // icon-theme disk lookups on the paint path. Show the generic icon for
+                // this frame and resolve the themed icon right afterwards from the event
+                // loop; the repaint then finds it in QPixmapCache. During the first
+                // scroll through a directory with many distinct types this keeps each
+                // frame under budget even while the icon-theme caches are cold.
+                m_pixmap = pixmapForIcon(QStringLiteral("unknown"), maxIconSize, mode);
+                if (!m_iconResolutionScheduled) {
+                    m_iconResolutionScheduled = true;
+                    QTimer::singleShot(0, this, [this, iconName, maxIconSize, mode]() {
+                        m_iconResolutionScheduled = false;
+                        pixmapForIcon(iconName, maxIconSize, mode); // Renders the icon into QPixmapCache.
+                        m_dirtyContent = true;
+                        m_dirtyContentRoles.insert("iconName");
+                        update();
+                    });
+                }
+            }
 
         } else {
             if (m_pixmap.width() / m_pixmap.devicePixelRatio() != maxIconWidth || m_pixmap.height() / m_pixmap.devicePixelRatio() != maxIconHeight) {
                 // A custom pixmap has been applied. Assure that the pixmap
-                // is scaled to the maximum available size.
-                KPixmapModifier::scale(m_pixmap, QSize(maxIconWidth, maxIconHeight) * dpr);
+                // is scaled to the maximum available size. The scaled variants
+                // are kept in QPixmapCache, keyed by the source pixmap and the
+                // target size, so that toggling between zoom levels does not
+                // rescale every preview from scratch again.
+                const QString key = "KStandardItemListWidget:scaled:" % QString::number(m_pixmap.cacheKey()) % ":" % QString::number(maxIconWidth) % "x"
+                    % QString::number(maxIconHeight) % "@" % QString::number(dpr);
+                QPixmap scaledPixmap;
+                if (QPixmapCache::find(key, &scaledPixmap)) {
+                    m_pixmap = scaledPixmap;
+                } else {
+                    KPixmapModifier::scale(m_pixmap, QSize(maxIconWidth, maxIconHeight) * dpr);
+                    QPixmapCache::insert(key, m_pixmap);
+                }
             }
         }
 
@@ -1306,14 +1499,14 @@ void KStandardItemListWidget::updateIconsLayoutTextCache()
     // for initializing the position of the other roles.
     TextInfo *nameTextInfo = m_textInfo.value("text");
     const QString nameText = KStringHandler::preProcessWrap(escapeString(values["text"].toString()));
-    nameTextInfo->staticText.setText(nameText);
+    QString displayedNameText = nameText;
 
     // Calculate the number of lines required for the name and the required width
     qreal nameWidth = 0;
     qreal nameHeight = 0;
     QTextLine line;
 
-    QTextLayout layout(nameTextInfo->staticText.text(), m_customizedFont);
+    QTextLayout layout(nameText, m_customizedFont);
     layout.setTextOption(nameTextInfo->staticText.textOption());
     layout.beginLayout();
     int nameLineIndex = 0;
@@ -1334,8 +1527,7 @@ void KStandardItemListWidget::updateIconsLayoutTextCache()
                 do {
                     QString lastTextLine = nameText.mid(line.textStart());
                     lastTextLine = elideText(lastTextLine, elidingWidth);
-                    const QString elidedText = nameText.left(line.textStart()) + lastTextLine;
-                    nameTextInfo->staticText.setText(elidedText);
+                    displayedNameText = nameText.left(line.textStart()) + lastTextLine;
 
                     lastLineWidth = m_customizedFontMetrics.size(0, lastTextLine).width();
 
@@ -1353,7 +1545,7 @@ void KStandardItemListWidget::updateIconsLayoutTextCache()
     layout.endLayout();
 
     // Use one line for each additional information
-    nameTextInfo->staticText.setTextWidth(maxWidth);
+    nameTextInfo->staticText = KStaticTextCache::instance()->staticText(displayedNameText, m_customizedFont, nameTextInfo->staticText.textOption(), maxWidth);
     nameTextInfo->pos = QPointF(padding, styleOption().iconSize + 2 * padding);
     m_textRect = QRectF(padding + (maxWidth - nameWidth) / 2, nameTextInfo->pos.y(), nameWidth, nameHeight);
 
@@ -1366,7 +1558,7 @@ void KStandardItemListWidget::updateIconsLayoutTextCache()
 
         const QString text = roleText(role, values);
         TextInfo *textInfo = m_textInfo.value(role);
-        textInfo->staticText.setText(text);
+        QString displayedText = text;
 
         qreal requiredWidth = 0;
 
@@ -1381,9 +1573,8 @@ void KStandardItemListWidget::updateIconsLayoutTextCache()
             textLine.setLineWidth(maxWidth);
             requiredWidth = textLine.naturalTextWidth();
             if (requiredWidth > maxWidth) {
-                const QString elidedText = m_customizedFontMetrics.elidedText(text, Qt::ElideRight, maxWidth);
-                textInfo->staticText.setText(elidedText);
-                requiredWidth = m_customizedFontMetrics.horizontalAdvance(elidedText);
+                displayedText = m_customizedFontMetrics.elidedText(text, Qt::ElideRight, maxWidth);
+                requiredWidth = m_customizedFontMetrics.horizontalAdvance(displayedText);
             } else if (role == "rating") {
                 // Use the width of the rating pixmap, because the rating text is empty.
                 requiredWidth = m_rating.width() / m_rating.devicePixelRatioF();
@@ -1392,7 +1583,7 @@ void KStandardItemListWidget::updateIconsLayoutTextCache()
         layout.endLayout();
 
         textInfo->pos = QPointF(padding, y);
-        textInfo->staticText.setTextWidth(maxWidth);
+        textInfo->staticText = KStaticTextCache::instance()->staticText(displayedText, m_customizedFont, textInfo->staticText.textOption(), maxWidth);
 
         const QRectF textRect(padding + (maxWidth - requiredWidth) / 2, y, requiredWidth, lineSpacing);
 
@@ -1428,22 +1619,20 @@ void KStandardItemListWidget::updateCompactLayoutTextCache()
     for (const QByteArray &role : std::as_const(m_sortedVisibleRoles)) {
         const QString text = escapeString(roleText(role, values));
         TextInfo *textInfo = m_textInfo.value(role);
-        textInfo->staticText.setText(text);
+        QString displayedText = text;
 
         qreal requiredWidth = m_customizedFontMetrics.horizontalAdvance(text);
         if (requiredWidth > maxWidth) {
             requiredWidth = maxWidth;
             if (role == "text") {
-                const QString elidedText = elideText(text, maxWidth);
-                textInfo->staticText.setText(elidedText);
+                displayedText = elideText(text, maxWidth);
             } else {
-                const QString elidedText = m_customizedFontMetrics.elidedText(text, Qt::ElideRight, maxWidth);
-                textInfo->staticText.setText(elidedText);
+                displayedText = m_customizedFontMetrics.elidedText(text, Qt::ElideRight, maxWidth);
             }
         }
 
         textInfo->pos = QPointF(x, y);
-        textInfo->staticText.setTextWidth(maxWidth);
+        textInfo->staticText = KStaticTextCache::instance()->staticText(displayedText, m_customizedFont, textInfo->staticText.textOption(), maxWidth);
 
         maximumRequiredTextWidth = qMax(maximumRequiredTextWidth, requiredWidth);
 
@@ -1507,7 +1696,7 @@ void KStandardItemListWidget::updateDetailsLayoutTextCache()
         }
 
         TextInfo *textInfo = m_textInfo.value(role);
-        textInfo->staticText.setText(text);
+        textInfo->staticText = KStaticTextCache::instance()->staticText(text, m_customizedFont, textInfo->staticText.textOption(), -1.0);
         qreal y = standardY;
         if (isTextRole) {
             QTextLayout layout(text, m_customizedFont);
@@ -1566,6 +1755,23 @@ KStandardItemListWidget::addOverlays(const QPixmap &pixmap, const QHash<Qt::Corn
         return pixmap;
     }
 
+    // Composed results are shared between all widgets: after a version
+    // control refresh thousands of items typically show the same few
+    // icon+emblem combinations, so their repaints become cache lookups
+    // instead of re-blending the same pixmaps over and over.
+    static QCache<QString, QPixmap> composedPixmapCache(ComposedPixmapCacheCostLimit);
+
+    QString cacheKey = QString::number(pixmap.cacheKey()) + QLatin1Char('@') + QString::number(size.width()) + QLatin1Char('x')
+        + QString::number(size.height()) + QLatin1Char('@') + QString::number(dpr) + QLatin1Char('@') + QString::number(mode) + QLatin1Char('@')
+        + QIcon::themeName();
+    for (const Qt::Corner corner : {Qt::TopLeftCorner, Qt::TopRightCorner, Qt::BottomLeftCorner, Qt::BottomRightCorner}) {
+        cacheKey += QLatin1Char('@') + overlays.value(corner);
+    }
+
+    if (const QPixmap *composedPixmap = composedPixmapCache.object(cacheKey)) {
+        return *composedPixmap;
+    }
+
     int width = size.width();
     int height = size.height();
     const int iconSize = qMin(width, height);
@@ -1625,6 +1831,8 @@ KStandardItemListWidget::addOverlays(const QPixmap &pixmap, const QHash<Qt::Corn
         painter.drawPixmap(startPoint, overlayPixmap);
     }
 
+    composedPixmapCache.insert(cacheKey, new QPixmap(output), output.width() * output.height() * output.depth() / 8 / 1024 + 1);
+
     return output;
 }
 
@@ -1710,6 +1918,12 @@ void KStandardItemListWidget::closeRoleEditor()
     m_roleEditor = nullptr;
 }
 
+QString KStandardItemListWidget::pixmapCacheKeyForIcon(const QString &name, const QSize &size, QIcon::Mode mode) const
+{
+    const qreal dpr = KItemViewsUtils::devicePixelRatio(this);
+    return "KStandardItemListWidget:" % name % ":" % QString::number(size.height()) % "@" % QString::number(dpr) % ":" % QString::number(mode);
+}
+
 QPixmap KStandardItemListWidget::pixmapForIcon(const QString &name, const QSize &size, QIcon::Mode mode) const
 {
     static const QIcon fallbackIcon = QIcon::fromTheme(QStringLiteral("unknown"));
@@ -1718,7 +1932,7 @@ QPixmap KStandardItemListWidget::pixmapForIcon(const QString &name, const QSize
     int iconHeight = size.height();
     QSize iconSize = QSize(iconHeight, iconHeight);
 
-    const QString key = "KStandardItemListWidget:" % name % ":" % QString::number(iconHeight) % "@" % QString::number(dpr) % ":" % QString::number(mode);
+    const QString key = pixmapCacheKeyForIcon(name, size, mode);
     QPixmap pixmap;
 
     if (!QPixmapCache::find(key, &pixmap)) {
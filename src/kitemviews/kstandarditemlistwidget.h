@@ -107,6 +107,8 @@ public:
 
     QRectF textRect() const override;
     QRectF textFocusRect() const override;
+    QRectF damageRect(const QSet<QByteArray> &changedRoles) const override;
+    qint64 estimatedMemoryUsageBytes() const override;
     QRectF selectionRectFull() const override;
     QRectF selectionRectCore() const override;
     QRectF expansionToggleRect() const override;
@@ -117,6 +119,20 @@ public:
 
     static KItemListWidgetInformant *createInformant();
 
+    /**
+     * @return Number of heap-allocating scratch-buffer (re)creations that the
+     *         paint code of all widgets performed since the last reset. A
+     *         steady-state repaint - no icon, overlay, size or hover-fade
+     *         change since the previous frame - reuses the per-widget scratch
+     *         buffers and leaves the counter untouched. Profiling sessions and
+     *         the paint regression test use it to catch code changes that
+     *         reintroduce per-frame allocations.
+     */
+    static qint64 paintScratchBufferAllocations();
+
+    /** Resets the counter returned by paintScratchBufferAllocations(). */
+    static void resetPaintScratchBufferAllocations();
+
 protected:
     /**
      * Invalidates the cache which results in calling KStandardItemListWidget::refreshCache() as
@@ -184,8 +200,6 @@ protected:
     void editedRoleChanged(const QByteArray &current, const QByteArray &previous) override;
     void iconSizeChanged(int current, int previous) override;
     void resizeEvent(QGraphicsSceneResizeEvent *event) override;
-    void showEvent(QShowEvent *event) override;
-    void hideEvent(QHideEvent *event) override;
     bool event(QEvent *event) override;
 
     struct TextInfo {
@@ -198,7 +212,6 @@ public Q_SLOTS:
     void finishRoleEditing();
 
 private Q_SLOTS:
-    void slotCutItemsChanged();
     void slotRoleEditingCanceled(const QByteArray &role, const QVariant &value);
     void slotRoleEditingFinished(const QByteArray &role, const QVariant &value);
 
@@ -239,6 +252,13 @@ private:
      */
     void closeRoleEditor();
 
+    /**
+     * @return The key under which pixmapForIcon() stores the resolved pixmap
+     *         in QPixmapCache. Probing the cache with this key tells whether
+     *         pixmapForIcon() can return without consulting the icon theme.
+     */
+    QString pixmapCacheKeyForIcon(const QString &name, const QSize &size, QIcon::Mode mode) const;
+
     QPixmap pixmapForIcon(const QString &name, const QSize &size, QIcon::Mode mode) const;
 
     /**
@@ -273,6 +293,10 @@ private:
     bool m_dirtyContent;
     QSet<QByteArray> m_dirtyContentRoles;
 
+    // Whether a deferred icon-theme lookup is queued because the themed icon
+    // of this widget was not in QPixmapCache yet, see updatePixmapCache().
+    bool m_iconResolutionScheduled;
+
     Layout m_layout;
     QPointF m_pixmapPos;
     QPixmap m_pixmap;
@@ -293,14 +317,28 @@ private:
     QHash<Qt::Corner, QString> m_overlays;
     QPixmap m_rating;
 
+    // Scratch buffers that are reused across paint() calls so that a
+    // steady-state repaint does not allocate, see paint(). They are only
+    // (re)created when the pixmap they are derived from changes.
+    QPixmap m_overlaidPixmap; // m_pixmap with m_overlays composed onto it
+    qint64 m_overlaidPixmapSourceKey; // cacheKey() of the m_pixmap that m_overlaidPixmap was composed from
+    QSize m_overlaidPixmapMaxSize;
+    qreal m_overlaidPixmapDpr;
+    QPixmap m_hoverBlendPixmap; // Blend target of the hover fade, released when the hover ends
+    QPixmap m_hoverBlendBuffer; // Intermediate buffer of the hover fade
+
     KItemListRoleEditor *m_roleEditor;
     KItemListRoleEditor *m_oldRoleEditor;
 
+    /** @see paintScratchBufferAllocations() */
+    static qint64 s_paintScratchBufferAllocations;
+
     /** @see startActivateSoonAnimation() */
     QPointer<QVariantAnimation> m_activateSoonAnimation;
 
     friend class KStandardItemListWidgetInformant; // Accesses private static methods to be able to
                                                    // share a common layout calculation
+    friend class KStandardItemListWidgetPaintTest; // Accesses setOverlays() and the scratch buffers
 };
 
 #endif
@@ -171,6 +171,20 @@ QHash<QByteArray, QVariant> KBalooRolesProvider::roleValues(const Baloo::File &f
     return values;
 }
 
+QList<QHash<QByteArray, QVariant>> KBalooRolesProvider::roleValuesBatch(const QStringList &paths, const QSet<QByteArray> &roles) const
+{
+    QList<QHash<QByteArray, QVariant>> results;
+    results.reserve(paths.count());
+
+    for (const QString &path : paths) {
+        Baloo::File file(path);
+        file.load();
+        results.append(roleValues(file, roles));
+    }
+
+    return results;
+}
+
 KBalooRolesProvider::KBalooRolesProvider()
 {
     // Display roles filled from Baloo property cache
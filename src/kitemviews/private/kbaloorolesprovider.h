@@ -12,6 +12,7 @@
 
 #include <QHash>
 #include <QSet>
+#include <QStringList>
 #include <QVariant>
 
 namespace Baloo
@@ -42,6 +43,14 @@ public:
      */
     QHash<QByteArray, QVariant> roleValues(const Baloo::File &file, const QSet<QByteArray> &roles) const;
 
+    /**
+     * @return Values for the roles \a roles for each of the files in
+     *         \a paths, in the same order. All files are loaded in one pass
+     *         over the database, which is considerably faster than querying
+     *         them one by one.
+     */
+    QList<QHash<QByteArray, QVariant>> roleValuesBatch(const QStringList &paths, const QSet<QByteArray> &roles) const;
+
 protected:
     KBalooRolesProvider();
 
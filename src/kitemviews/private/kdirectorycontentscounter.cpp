@@ -11,12 +11,37 @@
 
 #include <KDirWatch>
 
+#include <QDataStream>
 #include <QDir>
 #include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include <QThread>
+#include <QTimer>
+
+#include <algorithm>
 
 namespace
 {
+// Format of the on-disk table holding the directory counting results.
+const quint32 CacheMagic = 0x646c7063; // 'dlpc'
+const quint32 CacheVersion = 1;
+
+// Maximum number of entries written to the on-disk table. If the table grew
+// beyond this limit, the entries with the oldest scan time are dropped.
+const int MaxPersistentEntries = 100000;
+
+// Delay in ms before updated results are written back to disk, so that a
+// burst of finished scans causes only one write.
+const int SaveDelayMs = 5000;
+
+// Upper bound for the number of worker threads counting directories.
+const int MaxCountWorkers = 4;
+
+// Results are collected for this many ms and delivered as one batch, so that
+// counting thousands of small directories does not invoke the receiver once
+// per directory.
+const int ResultBatchIntervalMs = 50;
 
 class LocalCache
 {
@@ -36,6 +61,7 @@ public:
     LocalCache()
         : m_cache()
     {
+        load();
     }
 
     cacheData insert(const QString &key, cacheData data, bool inserted)
@@ -45,12 +71,23 @@ public:
             data.refCount += 1;
         }
         m_cache.insert(key, data);
+
+        m_persistentCache.insert(key, data);
+        scheduleSave();
         return data;
     }
 
     cacheData value(const QString &key) const
     {
-        return m_cache.value(key);
+        cacheData entry = m_cache.value(key);
+        if (!entry) {
+            // The directory has not been scanned in this session, but maybe
+            // in an earlier one. The caller compares the timestamp with the
+            // directory modification time, so a stale entry only leads to a
+            // rescan - like a cache miss.
+            entry = m_persistentCache.value(key);
+        }
+        return entry;
     }
 
     void unRefAll(const QSet<QString> &keys)
@@ -68,17 +105,117 @@ public:
     {
         for (const auto &key : keys) {
             m_cache.remove(key);
+            if (m_persistentCache.remove(key) > 0) {
+                scheduleSave();
+            }
         }
     }
 
+    void save()
+    {
+        m_saveScheduled = false;
+
+        if (m_persistentCache.count() > MaxPersistentEntries) {
+            // Drop the entries with the oldest scan time.
+            QList<qint64> timestamps;
+            timestamps.reserve(m_persistentCache.count());
+            for (const auto &entry : std::as_const(m_persistentCache)) {
+                timestamps.append(entry.timestamp);
+            }
+            std::nth_element(timestamps.begin(), timestamps.end() - MaxPersistentEntries, timestamps.end());
+            const qint64 cutOff = *(timestamps.end() - MaxPersistentEntries);
+
+            auto it = m_persistentCache.begin();
+            while (it != m_persistentCache.end() && m_persistentCache.count() > MaxPersistentEntries) {
+                if (it->timestamp < cutOff) {
+                    it = m_persistentCache.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        const QString filePath = cacheFilePath();
+        QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+        QSaveFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly)) {
+            return;
+        }
+
+        QDataStream out(&file);
+        out << CacheMagic << CacheVersion;
+        for (auto it = m_persistentCache.constBegin(); it != m_persistentCache.constEnd(); ++it) {
+            out << it.key() << it->count << static_cast<qint64>(it->size) << it->timestamp;
+        }
+        file.commit();
+    }
+
 private:
+    static QString cacheFilePath()
+    {
+        return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/directory-sizes.cache");
+    }
+
+    void load()
+    {
+        QFile file(cacheFilePath());
+        if (!file.open(QIODevice::ReadOnly)) {
+            return;
+        }
+
+        QDataStream in(&file);
+        quint32 magic = 0;
+        quint32 version = 0;
+        in >> magic >> version;
+        if (magic != CacheMagic || version != CacheVersion) {
+            return;
+        }
+
+        while (!in.atEnd()) {
+            QString key;
+            cacheData data;
+            qint64 size = 0;
+            in >> key >> data.count >> size >> data.timestamp;
+            if (in.status() != QDataStream::Ok) {
+                m_persistentCache.clear();
+                return;
+            }
+            data.size = size;
+            m_persistentCache.insert(key, data);
+        }
+    }
+
+    void scheduleSave();
+
     QHash<QString, cacheData> m_cache;
+    QHash<QString, cacheData> m_persistentCache;
+    bool m_saveScheduled = false;
 };
 
 /// cache of directory counting result
 static LocalCache *s_cache;
-static QThread *s_workerThread;
-static KDirectoryContentsCounterWorker *s_worker;
+
+/// pool of worker threads counting directories, shared by all counters
+struct WorkerPool {
+    QList<QThread *> threads;
+    QList<KDirectoryContentsCounterWorker *> workers;
+    QSet<KDirectoryContentsCounterWorker *> busyWorkers;
+};
+static WorkerPool *s_workerPool;
+
+void LocalCache::scheduleSave()
+{
+    if (m_saveScheduled) {
+        return;
+    }
+    m_saveScheduled = true;
+    QTimer::singleShot(SaveDelayMs, []() {
+        if (s_cache) {
+            s_cache->save();
+        }
+    });
+}
 }
 
 KDirectoryContentsCounter::KDirectoryContentsCounter(KFileItemModel *model, QObject *parent)
@@ -86,7 +223,9 @@ KDirectoryContentsCounter::KDirectoryContentsCounter(KFileItemModel *model, QObj
     , m_model(model)
     , m_priorityQueue()
     , m_queue()
-    , m_workerIsBusy(false)
+    , m_currentScans()
+    , m_pendingResults()
+    , m_resultFlushTimer(nullptr)
     , m_dirWatcher(nullptr)
     , m_watchedDirs()
 {
@@ -94,25 +233,35 @@ KDirectoryContentsCounter::KDirectoryContentsCounter(KFileItemModel *model, QObj
         s_cache = new LocalCache();
     }
 
-    if (!s_workerThread) {
-        s_workerThread = new QThread();
-        s_workerThread->setObjectName(QStringLiteral("KDirectoryContentsCounterThread"));
-        s_workerThread->start();
-    }
+    if (!s_workerPool) {
+        s_workerPool = new WorkerPool();
+        const int workerCount = qBound(1, QThread::idealThreadCount() / 2, MaxCountWorkers);
+        for (int i = 0; i < workerCount; ++i) {
+            QThread *thread = new QThread();
+            thread->setObjectName(QStringLiteral("KDirectoryContentsCounterThread-%1").arg(i + 1));
+            thread->start();
+
+            KDirectoryContentsCounterWorker *worker = new KDirectoryContentsCounterWorker();
+            worker->moveToThread(thread);
 
-    if (!s_worker) {
-        s_worker = new KDirectoryContentsCounterWorker();
-        s_worker->moveToThread(s_workerThread);
+            s_workerPool->threads.append(thread);
+            s_workerPool->workers.append(worker);
+        }
     }
 
     connect(m_model, &KFileItemModel::itemsRemoved, this, &KDirectoryContentsCounter::slotItemsRemoved);
     connect(m_model, &KFileItemModel::directoryRefreshing, this, &KDirectoryContentsCounter::slotDirectoryRefreshing);
 
-    connect(this, &KDirectoryContentsCounter::requestDirectoryContentsCount, s_worker, &KDirectoryContentsCounterWorker::countDirectoryContents);
+    for (KDirectoryContentsCounterWorker *worker : std::as_const(s_workerPool->workers)) {
+        connect(worker, &KDirectoryContentsCounterWorker::result, this, &KDirectoryContentsCounter::slotResult);
+        connect(worker, &KDirectoryContentsCounterWorker::intermediateResult, this, &KDirectoryContentsCounter::slotIntermediateResult);
+        connect(worker, &KDirectoryContentsCounterWorker::finished, this, &KDirectoryContentsCounter::slotWorkerFinished);
+    }
 
-    connect(s_worker, &KDirectoryContentsCounterWorker::result, this, &KDirectoryContentsCounter::slotResult);
-    connect(s_worker, &KDirectoryContentsCounterWorker::intermediateResult, this, &KDirectoryContentsCounter::result);
-    connect(s_worker, &KDirectoryContentsCounterWorker::finished, this, &KDirectoryContentsCounter::scheduleNext);
+    m_resultFlushTimer = new QTimer(this);
+    m_resultFlushTimer->setSingleShot(true);
+    m_resultFlushTimer->setInterval(ResultBatchIntervalMs);
+    connect(m_resultFlushTimer, &QTimer::timeout, this, &KDirectoryContentsCounter::flushResults);
 
     m_dirWatcher = new KDirWatch(this);
     connect(m_dirWatcher, &KDirWatch::dirty, this, &KDirectoryContentsCounter::slotDirWatchDirty);
@@ -135,8 +284,39 @@ void KDirectoryContentsCounter::slotResult(const QString &path, int count, long
     // update cache or overwrite value
     s_cache->insert(resolvedPath, {count, size, true}, inserted);
 
-    // sends the results
-    Q_EMIT result(path, count, size);
+    appendResult(path, count, size, false);
+}
+
+void KDirectoryContentsCounter::slotIntermediateResult(const QString &path, int count, long long size)
+{
+    appendResult(path, count, size, true);
+}
+
+void KDirectoryContentsCounter::slotWorkerFinished()
+{
+    KDirectoryContentsCounterWorker *worker = qobject_cast<KDirectoryContentsCounterWorker *>(sender());
+    s_workerPool->busyWorkers.remove(worker);
+    m_currentScans.remove(worker);
+    scheduleNext();
+}
+
+void KDirectoryContentsCounter::appendResult(const QString &path, int count, long long size, bool intermediate)
+{
+    m_pendingResults.append({path, count, size, intermediate});
+    if (!m_resultFlushTimer->isActive()) {
+        m_resultFlushTimer->start();
+    }
+}
+
+void KDirectoryContentsCounter::flushResults()
+{
+    if (m_pendingResults.isEmpty()) {
+        return;
+    }
+
+    const QList<DirectoryCountResult> results = std::move(m_pendingResults);
+    m_pendingResults = QList<DirectoryCountResult>();
+    Q_EMIT this->results(results);
 }
 
 void KDirectoryContentsCounter::slotDirWatchDirty(const QString &path)
@@ -190,41 +370,60 @@ void KDirectoryContentsCounter::slotDirectoryRefreshing()
 
 void KDirectoryContentsCounter::scheduleNext()
 {
-    if (!m_priorityQueue.empty()) {
-        m_currentPath = m_priorityQueue.front();
-        m_priorityQueue.pop_front();
-    } else if (!m_queue.empty()) {
-        m_currentPath = m_queue.front();
-        m_queue.pop_front();
-    } else {
-        m_currentPath.clear();
-        m_workerIsBusy = false;
-        return;
-    }
+    while (!m_priorityQueue.empty() || !m_queue.empty()) {
+        // Find an idle worker in the shared pool.
+        KDirectoryContentsCounterWorker *worker = nullptr;
+        for (KDirectoryContentsCounterWorker *candidate : std::as_const(s_workerPool->workers)) {
+            if (!s_workerPool->busyWorkers.contains(candidate) && !candidate->stopping()) {
+                worker = candidate;
+                break;
+            }
+        }
+        if (!worker) {
+            // All workers are busy. The next path is handed out once a
+            // worker finishes.
+            return;
+        }
 
-    const auto fileInfo = QFileInfo(m_currentPath);
-    const QString resolvedPath = fileInfo.canonicalFilePath();
-    const auto pair = s_cache->value(resolvedPath);
-    if (pair) {
-        // fast path when in cache
-        // will be updated later if result has changed
-        Q_EMIT result(m_currentPath, pair.count, pair.size);
-    }
+        QString path;
+        if (!m_priorityQueue.empty()) {
+            path = m_priorityQueue.front();
+            m_priorityQueue.pop_front();
+        } else {
+            path = m_queue.front();
+            m_queue.pop_front();
+        }
 
-    // if scanned fully recently, skip rescan
-    if (pair && pair.timestamp >= fileInfo.fileTime(QFile::FileModificationTime).toMSecsSinceEpoch()) {
-        scheduleNext();
-        return;
-    }
+        const auto fileInfo = QFileInfo(path);
+        const QString resolvedPath = fileInfo.canonicalFilePath();
+        const auto pair = s_cache->value(resolvedPath);
+        if (pair) {
+            // fast path when in cache
+            // will be updated later if result has changed
+            appendResult(path, pair.count, pair.size, false);
+        }
 
-    KDirectoryContentsCounterWorker::Options options;
+        // if scanned fully recently, skip rescan
+        if (pair && pair.timestamp >= fileInfo.fileTime(QFile::FileModificationTime).toMSecsSinceEpoch()) {
+            continue;
+        }
 
-    if (m_model->showHiddenFiles()) {
-        options |= KDirectoryContentsCounterWorker::CountHiddenFiles;
-    }
+        KDirectoryContentsCounterWorker::Options options;
 
-    m_workerIsBusy = true;
-    Q_EMIT requestDirectoryContentsCount(m_currentPath, options, ContentDisplaySettings::recursiveDirectorySizeLimit());
+        if (m_model->showHiddenFiles()) {
+            options |= KDirectoryContentsCounterWorker::CountHiddenFiles;
+        }
+
+        s_workerPool->busyWorkers.insert(worker);
+        m_currentScans.insert(worker, path);
+
+        QMetaObject::invokeMethod(worker,
+                                  "countDirectoryContents",
+                                  Qt::QueuedConnection,
+                                  Q_ARG(QString, path),
+                                  Q_ARG(KDirectoryContentsCounterWorker::Options, options),
+                                  Q_ARG(int, ContentDisplaySettings::recursiveDirectorySizeLimit()));
+    }
 }
 
 void KDirectoryContentsCounter::enqueuePathScanning(const QString &path, bool alreadyInCache, PathCountPriority priority)
@@ -256,7 +455,7 @@ void KDirectoryContentsCounter::enqueuePathScanning(const QString &path, bool al
 
 void KDirectoryContentsCounter::scanDirectory(const QString &path, PathCountPriority priority)
 {
-    if (m_workerIsBusy && m_currentPath == path) {
+    if (std::find(m_currentScans.cbegin(), m_currentScans.cend(), path) != m_currentScans.cend()) {
         // already listing
         return;
     }
@@ -267,7 +466,7 @@ void KDirectoryContentsCounter::scanDirectory(const QString &path, PathCountPrio
     if (pair) {
         // fast path when in cache
         // will be updated later if result has changed
-        Q_EMIT result(path, pair.count, pair.size);
+        appendResult(path, pair.count, pair.size, false);
     }
 
     // if scanned fully recently, skip rescan
@@ -277,9 +476,7 @@ void KDirectoryContentsCounter::scanDirectory(const QString &path, PathCountPrio
 
     enqueuePathScanning(path, pair, priority);
 
-    if (!m_workerIsBusy && !s_worker->stopping()) {
-        scheduleNext();
-    }
+    scheduleNext();
 }
 
 void KDirectoryContentsCounter::stopWorker()
@@ -287,10 +484,12 @@ void KDirectoryContentsCounter::stopWorker()
     m_queue.clear();
     m_priorityQueue.clear();
 
-    if (m_workerIsBusy && m_currentPath == s_worker->scannedPath()) {
-        s_worker->stop();
+    for (auto it = m_currentScans.constBegin(); it != m_currentScans.constEnd(); ++it) {
+        if (it.key()->scannedPath() == it.value()) {
+            it.key()->stop();
+        }
     }
-    m_currentPath.clear();
+    m_currentScans.clear();
 }
 
 #include "moc_kdirectorycontentscounter.cpp"
@@ -10,11 +10,13 @@
 
 #include "kdirectorycontentscounterworker.h"
 
+#include <QHash>
 #include <QSet>
 
 class KDirWatch;
 class KFileItemModel;
 class QString;
+class QTimer;
 
 class KDirectoryContentsCounter : public QObject
 {
@@ -23,19 +25,31 @@ class KDirectoryContentsCounter : public QObject
 public:
     enum PathCountPriority { Normal, High };
 
+    struct DirectoryCountResult {
+        QString path;
+        int count;
+        long long size;
+        bool intermediate;
+    };
+
     explicit KDirectoryContentsCounter(KFileItemModel *model, QObject *parent = nullptr);
     ~KDirectoryContentsCounter() override;
 
     /**
      * Requests the number of items inside the directory \a path. The actual
-     * counting is done asynchronously, and the result is announced via the
-     * signal \a result.
+     * counting is done asynchronously on a small pool of worker threads, and
+     * the result is announced via the signal \a results.
      *
      * The directory \a path is watched for changes, and the signal is emitted
      * again if a change occurs.
      *
      * Uses a cache internally to speed up first result,
      * but emit again result when the cache was updated
+     *
+     * The cache is persisted to disk, so revisiting a directory in a later
+     * session shows the counts instantly. An entry is only trusted as long
+     * as the directory modification time is older than the recorded scan
+     * time, and only changed directories are rescanned.
      */
     void scanDirectory(const QString &path, PathCountPriority priority);
 
@@ -46,35 +60,52 @@ public:
 
 Q_SIGNALS:
     /**
-     * Signals that the directory \a path contains \a count items of size \a
+     * Signals that the directories in \a results have been counted.
+     * Results are batched so that counting thousands of small directories
+     * does not invoke the receiver once per directory.
      * Size calculation depends on parameter ContentDisplaySettings::recursiveDirectorySizeLimit
      */
-    void result(const QString &path, int count, long long size);
-
-    void requestDirectoryContentsCount(const QString &path, KDirectoryContentsCounterWorker::Options options, int maxRecursiveLevel);
+    void results(const QList<KDirectoryContentsCounter::DirectoryCountResult> &results);
 
 private Q_SLOTS:
     void slotResult(const QString &path, int count, long long size);
+    void slotIntermediateResult(const QString &path, int count, long long size);
+    void slotWorkerFinished();
     void slotDirWatchDirty(const QString &path);
     void slotItemsRemoved();
     void slotDirectoryRefreshing();
-    void scheduleNext();
 
 private:
     void enqueuePathScanning(const QString &path, bool alreadyInCache, PathCountPriority priority);
 
+    /**
+     * Hands queued paths to idle workers of the shared pool until either
+     * the queues are empty or all workers are busy.
+     */
+    void scheduleNext();
+
+    /**
+     * Appends \a result to the pending batch and starts the flush timer.
+     */
+    void appendResult(const QString &path, int count, long long size, bool intermediate);
+
+    void flushResults();
+
     KFileItemModel *m_model;
 
     // Used as FIFO queues.
     std::list<QString> m_priorityQueue;
     std::list<QString> m_queue;
 
-    bool m_workerIsBusy;
+    // The paths this counter currently has running, by worker.
+    QHash<KDirectoryContentsCounterWorker *, QString> m_currentScans;
+
+    QList<DirectoryCountResult> m_pendingResults;
+    QTimer *m_resultFlushTimer;
 
     KDirWatch *m_dirWatcher;
     QSet<QString> m_watchedDirs; // Required as sadly KDirWatch does not offer a getter method
                                  // to get all watched directories.
-    QString m_currentPath;
 };
 
 #endif
@@ -0,0 +1,242 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kdirectorylistingbroker.h"
+
+#include "klocaldirectorylister.h"
+
+namespace
+{
+/**
+ * @returns the key identifying a shareable listing: models may only share a
+ *          stream if both the directory and the listing settings match.
+ */
+QString listingKeyFor(const QUrl &url, bool listHiddenFiles, bool directoriesOnly)
+{
+    QString key = url.adjusted(QUrl::StripTrailingSlash).toString();
+    key.append(listHiddenFiles ? QLatin1String("|hidden") : QLatin1String("|"));
+    key.append(directoriesOnly ? QLatin1String("|dirsOnly") : QLatin1String("|"));
+    return key;
+}
+}
+
+KDirectoryListingSubscription::KDirectoryListingSubscription(const QUrl &url, const QString &listingKey, QObject *parent)
+    : QObject(parent)
+    , m_url(url)
+    , m_listingKey(listingKey)
+{
+}
+
+KDirectoryListingSubscription::~KDirectoryListingSubscription()
+{
+    unsubscribe();
+}
+
+void KDirectoryListingSubscription::unsubscribe()
+{
+    if (!m_unsubscribed) {
+        m_unsubscribed = true;
+        KDirectoryListingBroker::instance()->unsubscribe(this);
+    }
+}
+
+QUrl KDirectoryListingSubscription::url() const
+{
+    return m_url;
+}
+
+bool KDirectoryListingSubscription::isFinished() const
+{
+    return m_completed;
+}
+
+KDirectoryListingBroker::KDirectoryListingBroker(QObject *parent)
+    : QObject(parent)
+{
+}
+
+KDirectoryListingBroker *KDirectoryListingBroker::instance()
+{
+    static KDirectoryListingBroker *broker = new KDirectoryListingBroker();
+    return broker;
+}
+
+KDirectoryListingSubscription *KDirectoryListingBroker::subscribeToLocalListing(const QUrl &url, bool listHiddenFiles, bool directoriesOnly, QObject *parent)
+{
+    Q_ASSERT(KLocalDirectoryLister::canList(url));
+
+    const QString key = listingKeyFor(url, listHiddenFiles, directoriesOnly);
+    auto *subscription = new KDirectoryListingSubscription(url, key, parent);
+
+    auto it = m_listings.find(key);
+    if (it == m_listings.end()) {
+        // No matching listing exists. Start one; the first subscriber is
+        // caught up by definition because the worker thread delivers all
+        // events through the event loop.
+        auto *lister = new KLocalDirectoryLister(url, this);
+        lister->setListHiddenFiles(listHiddenFiles);
+        lister->setDirectoriesOnly(directoriesOnly);
+        connect(lister, &KLocalDirectoryLister::itemsListed, this, [this, key](const QUrl &directoryUrl, const KFileItemList &items) {
+            slotItemsListed(key, directoryUrl, items);
+        });
+        connect(lister, &KLocalDirectoryLister::finished, this, [this, key]() {
+            slotFinished(key);
+        });
+        connect(lister, &KLocalDirectoryLister::listingFailed, this, [this, key]() {
+            slotListingFailed(key);
+        });
+
+        it = m_listings.insert(key, ActiveListing());
+        it->lister = lister;
+        subscription->m_caughtUp = true;
+        it->subscribers.append(subscription);
+
+        lister->start();
+        return subscription;
+    }
+
+    // Share the stream of the existing listing. The part that was delivered
+    // before this subscriber joined is replayed through the event loop, after
+    // the caller had a chance to connect to the subscription's signals. Live
+    // events are held back until the replay has caught up, so the subscriber
+    // sees every batch exactly once and in order.
+    // The subscription is the context object, so a queued catchUp() does not
+    // run anymore if the subscriber is gone before the event loop gets to it.
+    it->subscribers.append(subscription);
+    QMetaObject::invokeMethod(
+        subscription,
+        [this, subscription]() {
+            catchUp(subscription);
+        },
+        Qt::QueuedConnection);
+    return subscription;
+}
+
+void KDirectoryListingBroker::catchUp(KDirectoryListingSubscription *subscription)
+{
+    const auto it = m_listings.constFind(subscription->m_listingKey);
+    if (it == m_listings.constEnd() || !it->subscribers.contains(subscription)) {
+        // The listing was dropped or the subscriber already unsubscribed.
+        return;
+    }
+
+    // A signal handler may unsubscribe in the middle of the replay, which can
+    // tear the listing down; work on a copy of the stream state.
+    const QList<KFileItemList> batches = it->deliveredBatches;
+    const bool finished = it->finished;
+    const bool failed = it->failed;
+
+    subscription->m_caughtUp = true;
+    for (const KFileItemList &batch : batches) {
+        Q_EMIT subscription->itemsListed(subscription->m_url, batch);
+        if (subscription->m_unsubscribed) {
+            return;
+        }
+    }
+
+    if (failed) {
+        subscription->m_completed = true;
+        Q_EMIT subscription->listingFailed();
+    } else if (finished) {
+        subscription->m_completed = true;
+        Q_EMIT subscription->finished();
+    }
+}
+
+void KDirectoryListingBroker::unsubscribe(KDirectoryListingSubscription *subscription)
+{
+    const auto it = m_listings.find(subscription->m_listingKey);
+    if (it == m_listings.end()) {
+        return;
+    }
+
+    it->subscribers.removeOne(subscription);
+    if (it->subscribers.isEmpty()) {
+        it->lister->stop();
+        it->lister->deleteLater();
+        m_listings.erase(it);
+    }
+}
+
+void KDirectoryListingBroker::slotItemsListed(const QString &listingKey, const QUrl &directoryUrl, const KFileItemList &items)
+{
+    const auto it = m_listings.find(listingKey);
+    if (it == m_listings.end()) {
+        return;
+    }
+
+    it->deliveredBatches.append(items);
+    // A signal handler may unsubscribe and thereby modify the subscriber
+    // list or drop the whole listing; iterate over a copy.
+    const QList<KDirectoryListingSubscription *> subscribers = it->subscribers;
+    for (KDirectoryListingSubscription *subscription : subscribers) {
+        if (subscription->m_caughtUp && !subscription->m_unsubscribed) {
+            Q_EMIT subscription->itemsListed(directoryUrl, items);
+        }
+    }
+}
+
+void KDirectoryListingBroker::slotFinished(const QString &listingKey)
+{
+    const auto it = m_listings.find(listingKey);
+    if (it == m_listings.end()) {
+        return;
+    }
+
+    it->finished = true;
+    const QList<KDirectoryListingSubscription *> subscribers = it->subscribers;
+    for (KDirectoryListingSubscription *subscription : subscribers) {
+        if (subscription->m_caughtUp && !subscription->m_unsubscribed) {
+            subscription->m_completed = true;
+            Q_EMIT subscription->finished();
+        }
+    }
+}
+
+void KDirectoryListingBroker::slotListingFailed(const QString &listingKey)
+{
+    const auto it = m_listings.find(listingKey);
+    if (it == m_listings.end()) {
+        return;
+    }
+
+    it->failed = true;
+    const QList<KDirectoryListingSubscription *> subscribers = it->subscribers;
+    for (KDirectoryListingSubscription *subscription : subscribers) {
+        if (subscription->m_caughtUp && !subscription->m_unsubscribed) {
+            subscription->m_completed = true;
+            Q_EMIT subscription->listingFailed();
+        }
+    }
+}
+
+void KDirectoryListingBroker::setHeldDirectory(QObject *holder, const QUrl &url)
+{
+    if (!url.isValid()) {
+        m_heldDirectories.remove(holder);
+        return;
+    }
+
+    if (!m_heldDirectories.contains(holder)) {
+        connect(holder, &QObject::destroyed, this, [this, holder]() {
+            m_heldDirectories.remove(holder);
+        });
+    }
+    m_heldDirectories.insert(holder, url.adjusted(QUrl::StripTrailingSlash));
+}
+
+bool KDirectoryListingBroker::isDirectoryHeldByOthers(const QUrl &url, const QObject *holder) const
+{
+    const QUrl adjustedUrl = url.adjusted(QUrl::StripTrailingSlash);
+    for (auto it = m_heldDirectories.constBegin(); it != m_heldDirectories.constEnd(); ++it) {
+        if (it.key() != holder && it.value() == adjustedUrl) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#include "moc_kdirectorylistingbroker.cpp"
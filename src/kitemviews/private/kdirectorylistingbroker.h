@@ -0,0 +1,163 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KDIRECTORYLISTINGBROKER_H
+#define KDIRECTORYLISTINGBROKER_H
+
+#include "dolphin_export.h"
+
+#include <KFileItem>
+
+#include <QHash>
+#include <QObject>
+#include <QUrl>
+
+class KLocalDirectoryLister;
+
+/**
+ * @brief One subscriber's view on a fast local listing shared through
+ *        KDirectoryListingBroker.
+ *
+ * The subscription mirrors the event stream of the underlying
+ * KLocalDirectoryLister. A subscriber who joins a listing which is already
+ * under way first receives the batches that were delivered before it joined
+ * and then the live events, so every subscriber sees the complete stream.
+ * Deleting the subscription unsubscribes; the listing itself is stopped once
+ * its last subscriber is gone.
+ */
+class DOLPHIN_EXPORT KDirectoryListingSubscription : public QObject
+{
+    Q_OBJECT
+
+public:
+    ~KDirectoryListingSubscription() override;
+
+    /** @returns the URL of the listed directory. */
+    QUrl url() const;
+
+    /**
+     * @returns true once this subscription has received its finished() or
+     *          listingFailed() signal, i.e. the stream will not deliver
+     *          further items.
+     */
+    bool isFinished() const;
+
+    /**
+     * Detaches from the shared listing immediately: no further signals are
+     * emitted and the listing is stopped if this was its last subscriber.
+     * Called by the destructor, but a subscriber who can only delete the
+     * subscription via deleteLater() - e.g. from one of its signal handlers -
+     * calls it directly so that a new subscription to the same directory
+     * starts a fresh listing instead of joining the stale one.
+     */
+    void unsubscribe();
+
+Q_SIGNALS:
+    /** @see KLocalDirectoryLister::itemsListed() */
+    void itemsListed(const QUrl &directoryUrl, const KFileItemList &items);
+
+    /** @see KLocalDirectoryLister::finished() */
+    void finished();
+
+    /** @see KLocalDirectoryLister::listingFailed() */
+    void listingFailed();
+
+private:
+    explicit KDirectoryListingSubscription(const QUrl &url, const QString &listingKey, QObject *parent);
+
+    QUrl m_url;
+    /** The key of the shared listing inside the broker. */
+    QString m_listingKey;
+    /** False until the batches delivered before subscribing have been replayed. */
+    bool m_caughtUp = false;
+    /** True once finished() or listingFailed() has been emitted on this subscription. */
+    bool m_completed = false;
+    /** Guards against unsubscribing twice, see unsubscribe(). */
+    bool m_unsubscribed = false;
+
+    friend class KDirectoryListingBroker;
+};
+
+/**
+ * @brief Shares directory listings between the item models of different views.
+ *
+ * Several views open on the same directory - split views, or a set of tabs
+ * kept on one project root - would each run their own fast local listing and
+ * sweep the same directory multiple times. The broker deduplicates this: all
+ * models requesting the same URL with the same listing settings subscribe to
+ * one KLocalDirectoryLister, whose batched item events are fanned out to every
+ * subscriber.
+ *
+ * The broker also keeps track of which root directories are currently held by
+ * a model's KDirLister. When another model wants to enter such a directory,
+ * a plain KDirLister listing is served from the in-process lister cache
+ * without any I/O and shares the existing directory watcher, so the fast
+ * listing would only add a redundant sweep; see
+ * KFileItemModel::loadDirectory().
+ */
+class DOLPHIN_EXPORT KDirectoryListingBroker : public QObject
+{
+    Q_OBJECT
+
+public:
+    static KDirectoryListingBroker *instance();
+
+    /**
+     * Subscribes to the fast local listing of \a url with the given listing
+     * settings. If no matching listing exists, one is started; otherwise the
+     * event stream of the running (or just finished) listing is shared. The
+     * returned subscription is parented to \a parent and is deleted by the
+     * subscriber to unsubscribe.
+     *
+     * \a url must satisfy KLocalDirectoryLister::canList().
+     */
+    KDirectoryListingSubscription *subscribeToLocalListing(const QUrl &url, bool listHiddenFiles, bool directoriesOnly, QObject *parent);
+
+    /**
+     * Records that \a holder's KDirLister currently holds \a url as its root
+     * directory. An invalid \a url clears the record. The record is also
+     * cleared automatically when \a holder is destroyed.
+     */
+    void setHeldDirectory(QObject *holder, const QUrl &url);
+
+    /**
+     * @returns true if a holder other than \a holder has recorded \a url as
+     *          its held root directory, i.e. the directory is in the lister
+     *          cache and watched already.
+     */
+    bool isDirectoryHeldByOthers(const QUrl &url, const QObject *holder) const;
+
+private:
+    explicit KDirectoryListingBroker(QObject *parent = nullptr);
+
+    /** The shared state of one running or recently finished listing. */
+    struct ActiveListing {
+        KLocalDirectoryLister *lister = nullptr;
+        /** All batches delivered so far, for replay to late subscribers. */
+        QList<KFileItemList> deliveredBatches;
+        bool finished = false;
+        bool failed = false;
+        QList<KDirectoryListingSubscription *> subscribers;
+    };
+
+    /** Replays the missed part of the stream to \a subscription. */
+    void catchUp(KDirectoryListingSubscription *subscription);
+
+    /** Removes \a subscription; stops and drops the listing if it was the last one. */
+    void unsubscribe(KDirectoryListingSubscription *subscription);
+
+    void slotItemsListed(const QString &listingKey, const QUrl &directoryUrl, const KFileItemList &items);
+    void slotFinished(const QString &listingKey);
+    void slotListingFailed(const QString &listingKey);
+
+    QHash<QString, ActiveListing> m_listings;
+    /** The held root directory per registered holder. */
+    QHash<const QObject *, QUrl> m_heldDirectories;
+
+    friend class KDirectoryListingSubscription;
+};
+
+#endif // KDIRECTORYLISTINGBROKER_H
@@ -12,6 +12,8 @@
 #include <QClipboard>
 #include <QMimeData>
 
+#include <algorithm>
+
 class KFileItemClipboardSingleton
 {
 public:
@@ -26,12 +28,17 @@ KFileItemClipboard *KFileItemClipboard::instance()
 
 bool KFileItemClipboard::isCut(const QUrl &url) const
 {
-    return m_cutItems.contains(url);
+    return std::binary_search(m_cutItems.constBegin(), m_cutItems.constEnd(), url);
+}
+
+bool KFileItemClipboard::hasCutItems() const
+{
+    return !m_cutItems.isEmpty();
 }
 
 QList<QUrl> KFileItemClipboard::cutItems() const
 {
-    return m_cutItems.values();
+    return m_cutItems;
 }
 
 KFileItemClipboard::~KFileItemClipboard()
@@ -52,8 +59,9 @@ void KFileItemClipboard::updateCutItems()
     const QByteArray data = mimeData->data(QStringLiteral("application/x-kde-cutselection"));
     const bool isCutSelection = (!data.isEmpty() && data.at(0) == QLatin1Char('1'));
     if (isCutSelection) {
-        const auto urlsFromMimeData = KUrlMimeData::urlsFromMimeData(mimeData);
-        m_cutItems = QSet<QUrl>(urlsFromMimeData.constBegin(), urlsFromMimeData.constEnd());
+        m_cutItems = KUrlMimeData::urlsFromMimeData(mimeData);
+        std::sort(m_cutItems.begin(), m_cutItems.end());
+        m_cutItems.erase(std::unique(m_cutItems.begin(), m_cutItems.end()), m_cutItems.end());
     } else {
         m_cutItems.clear();
     }
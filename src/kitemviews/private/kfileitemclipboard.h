@@ -11,7 +11,6 @@
 
 #include <QList>
 #include <QObject>
-#include <QSet>
 #include <QUrl>
 
 /**
@@ -27,6 +26,13 @@ public:
 
     bool isCut(const QUrl &url) const;
 
+    /**
+     * @return Whether any items have been cut at all. Cheaper than asking
+     *         for cutItems() or isCut() when most of the time nothing is cut.
+     */
+    bool hasCutItems() const;
+
+    /** @return The cut URLs in ascending order. */
     QList<QUrl> cutItems() const;
 
 Q_SIGNALS:
@@ -41,7 +47,12 @@ private Q_SLOTS:
 private:
     KFileItemClipboard();
 
-    QSet<QUrl> m_cutItems;
+    /**
+     * Kept sorted so that isCut() can binary-search instead of hashing the
+     * URL. With hundreds of thousands of cut items the sorted list is also
+     * considerably more compact than a hash-based set.
+     */
+    QList<QUrl> m_cutItems;
 
     friend class KFileItemClipboardSingleton;
 };
@@ -0,0 +1,371 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kfileitemmodelcolumnstore.h"
+
+#include <QPixmap>
+
+namespace
+{
+// Upper bound for the number of distinct values an intern pool keeps. Roles
+// designated as low-cardinality stay far below this in practice; if a pool
+// ever fills up, further values are stored unshared instead of letting the
+// pool grow towards the item count.
+constexpr int MaxInternPoolSize = 1024;
+}
+
+KFileItemModelColumnStore::KFileItemModelColumnStore() = default;
+
+KFileItemModelColumnStore::~KFileItemModelColumnStore() = default;
+
+void KFileItemModelColumnStore::removeColumn(const QByteArray &role)
+{
+    const auto it = m_columns.constFind(role);
+    if (it == m_columns.constEnd()) {
+        return;
+    }
+
+    const std::vector<quint8> &present = it->present;
+    for (std::size_t slot = 0; slot < present.size(); ++slot) {
+        if (present[slot]) {
+            --m_roleCounts[slot];
+        }
+    }
+    m_columns.erase(it);
+}
+
+qint64 KFileItemModelColumnStore::estimatedMemoryUsageBytes() const
+{
+    qint64 bytes = 0;
+    for (const Column &column : m_columns) {
+        bytes += static_cast<qint64>(column.numbers.capacity()) * sizeof(qlonglong);
+        bytes += static_cast<qint64>(column.present.capacity()) * sizeof(quint8);
+        bytes += static_cast<qint64>(column.strings.capacity()) * sizeof(QString);
+        if (column.internValues) {
+            // The slots share the character data of the pooled strings, so
+            // only the pool is deep-counted.
+            for (const QString &string : column.stringPool) {
+                bytes += static_cast<qint64>(string.capacity()) * sizeof(QChar);
+            }
+        } else {
+            for (const QString &string : column.strings) {
+                bytes += static_cast<qint64>(string.capacity()) * sizeof(QChar);
+            }
+        }
+        bytes += static_cast<qint64>(column.variants.capacity()) * sizeof(QVariant);
+        for (const QVariant &variant : column.variants) {
+            // Preview pixmaps dominate the variant columns, count their pixel data.
+            if (variant.typeId() == QMetaType::QPixmap) {
+                const QPixmap pixmap = variant.value<QPixmap>();
+                bytes += static_cast<qint64>(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+            }
+        }
+    }
+    bytes += static_cast<qint64>(m_roleCounts.capacity()) * sizeof(int);
+    bytes += static_cast<qint64>(m_freeSlots.capacity()) * sizeof(int);
+    return bytes;
+}
+
+int KFileItemModelColumnStore::allocateSlot()
+{
+    if (!m_freeSlots.empty()) {
+        const int slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        return slot;
+    }
+
+    const int slot = static_cast<int>(m_roleCounts.size());
+    m_roleCounts.push_back(0);
+    return slot;
+}
+
+void KFileItemModelColumnStore::releaseSlot(int slot)
+{
+    clearSlot(slot);
+    m_freeSlots.push_back(slot);
+}
+
+void KFileItemModelColumnStore::clearSlot(int slot)
+{
+    if (m_roleCounts[slot] == 0) {
+        return;
+    }
+
+    for (Column &column : m_columns) {
+        if (slot < static_cast<int>(column.present.size()) && column.present[slot]) {
+            column.present[slot] = 0;
+            switch (column.type) {
+            case NumberStorage:
+                column.numbers[slot] = 0;
+                break;
+            case StringStorage:
+                column.strings[slot] = QString();
+                break;
+            case VariantStorage:
+                column.variants[slot] = QVariant();
+                break;
+            }
+        }
+    }
+
+    m_roleCounts[slot] = 0;
+}
+
+bool KFileItemModelColumnStore::contains(int slot, const QByteArray &role) const
+{
+    const auto it = m_columns.constFind(role);
+    if (it == m_columns.constEnd()) {
+        return false;
+    }
+    return slot < static_cast<int>(it->present.size()) && it->present[slot];
+}
+
+QVariant KFileItemModelColumnStore::value(int slot, const QByteArray &role, const QVariant &defaultValue) const
+{
+    const auto it = m_columns.constFind(role);
+    if (it == m_columns.constEnd() || slot >= static_cast<int>(it->present.size()) || !it->present[slot]) {
+        return defaultValue;
+    }
+    return columnValue(*it, slot);
+}
+
+void KFileItemModelColumnStore::insert(int slot, const QByteArray &role, const QVariant &value)
+{
+    auto it = m_columns.find(role);
+    if (it == m_columns.end()) {
+        Column column;
+        column.type = storageTypeForVariant(value);
+        column.metaType = value.metaType();
+        column.internValues = isLowCardinalityRole(role);
+        it = m_columns.insert(role, column);
+    } else if (it->type != VariantStorage && value.metaType() != it->metaType) {
+        // A value of a mismatching type is inserted into a typed column.
+        // Fall back to generic QVariant storage for this role.
+        convertColumnToVariantStorage(*it);
+    }
+
+    Column &column = *it;
+    const int oldSize = static_cast<int>(column.present.size());
+    if (slot >= oldSize) {
+        column.present.resize(slot + 1, 0);
+        switch (column.type) {
+        case NumberStorage:
+            column.numbers.resize(slot + 1, 0);
+            break;
+        case StringStorage:
+            column.strings.resize(slot + 1);
+            break;
+        case VariantStorage:
+            column.variants.resize(slot + 1);
+            break;
+        }
+    }
+
+    if (!column.present[slot]) {
+        column.present[slot] = 1;
+        ++m_roleCounts[slot];
+    }
+    setColumnValue(column, slot, value);
+}
+
+int KFileItemModelColumnStore::roleCount(int slot) const
+{
+    return m_roleCounts[slot];
+}
+
+QHash<QByteArray, QVariant> KFileItemModelColumnStore::toHash(int slot) const
+{
+    QHash<QByteArray, QVariant> values;
+    if (m_roleCounts[slot] == 0) {
+        return values;
+    }
+
+    values.reserve(m_roleCounts[slot]);
+    for (auto it = m_columns.constBegin(); it != m_columns.constEnd(); ++it) {
+        if (slot < static_cast<int>(it->present.size()) && it->present[slot]) {
+            values.insert(it.key(), columnValue(*it, slot));
+        }
+    }
+    return values;
+}
+
+KFileItemModelColumnStore::StorageType KFileItemModelColumnStore::storageTypeForVariant(const QVariant &value)
+{
+    switch (value.metaType().id()) {
+    case QMetaType::Bool:
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+        return NumberStorage;
+    case QMetaType::QString:
+        return StringStorage;
+    default:
+        return VariantStorage;
+    }
+}
+
+void KFileItemModelColumnStore::convertColumnToVariantStorage(Column &column)
+{
+    const int size = static_cast<int>(column.present.size());
+    column.variants.resize(size);
+    for (int slot = 0; slot < size; ++slot) {
+        if (column.present[slot]) {
+            column.variants[slot] = columnValue(column, slot);
+        }
+    }
+    column.numbers.clear();
+    column.numbers.shrink_to_fit();
+    column.strings.clear();
+    column.stringPool.clear();
+    column.type = VariantStorage;
+}
+
+bool KFileItemModelColumnStore::isLowCardinalityRole(const QByteArray &role)
+{
+    // Roles whose values repeat across nearly all items of a directory. The
+    // per-item roles like "text" or "size" must not be listed here, their
+    // values would only bloat the pools.
+    static const QSet<QByteArray> lowCardinalityRoles = {QByteArrayLiteral("owner"),
+                                                         QByteArrayLiteral("group"),
+                                                         QByteArrayLiteral("type"),
+                                                         QByteArrayLiteral("permissions"),
+                                                         QByteArrayLiteral("extension"),
+                                                         QByteArrayLiteral("iconName")};
+    return lowCardinalityRoles.contains(role);
+}
+
+QString KFileItemModelColumnStore::internedString(Column &column, const QString &value)
+{
+    const auto it = column.stringPool.constFind(value);
+    if (it != column.stringPool.constEnd()) {
+        return *it;
+    }
+    if (column.stringPool.count() >= MaxInternPoolSize) {
+        return value;
+    }
+    column.stringPool.insert(value);
+    return value;
+}
+
+QVariant KFileItemModelColumnStore::internedVariant(Column &column, const QVariant &value)
+{
+    // The pool is scanned linearly because QVariant is not hashable. The
+    // designated roles keep the pool small enough for this to stay cheap,
+    // e.g. "permissions" stores one list per distinct permission set.
+    for (const QVariant &pooled : std::as_const(column.variantPool)) {
+        if (pooled == value) {
+            return pooled;
+        }
+    }
+    if (column.variantPool.count() >= MaxInternPoolSize) {
+        return value;
+    }
+    column.variantPool.append(value);
+    return value;
+}
+
+QVariant KFileItemModelColumnStore::columnValue(const Column &column, int slot) const
+{
+    switch (column.type) {
+    case NumberStorage: {
+        // Re-create the QVariant with the original meta-type so that callers
+        // cannot tell the difference to per-item QHash storage.
+        QVariant value(column.numbers[slot]);
+        value.convert(column.metaType);
+        return value;
+    }
+    case StringStorage:
+        return column.strings.at(slot);
+    case VariantStorage:
+    default:
+        return column.variants.at(slot);
+    }
+}
+
+void KFileItemModelColumnStore::setColumnValue(Column &column, int slot, const QVariant &value)
+{
+    switch (column.type) {
+    case NumberStorage:
+        column.numbers[slot] = value.toLongLong();
+        break;
+    case StringStorage:
+        column.strings[slot] = column.internValues ? internedString(column, value.toString()) : value.toString();
+        break;
+    case VariantStorage:
+        column.variants[slot] = column.internValues ? internedVariant(column, value) : value;
+        break;
+    }
+}
+
+void KFileItemModelColumnStore::RoleValues::attachToStore(KFileItemModelColumnStore *store)
+{
+    Q_ASSERT(!m_store || m_store == store);
+    m_store = store;
+}
+
+KFileItemModelColumnStore::RoleValues::~RoleValues()
+{
+    if (m_store && m_slot >= 0) {
+        m_store->releaseSlot(m_slot);
+    }
+}
+
+bool KFileItemModelColumnStore::RoleValues::isEmpty() const
+{
+    return m_slot < 0 || m_store->roleCount(m_slot) == 0;
+}
+
+int KFileItemModelColumnStore::RoleValues::count() const
+{
+    return m_slot < 0 ? 0 : m_store->roleCount(m_slot);
+}
+
+bool KFileItemModelColumnStore::RoleValues::contains(const QByteArray &role) const
+{
+    return m_slot >= 0 && m_store->contains(m_slot, role);
+}
+
+QVariant KFileItemModelColumnStore::RoleValues::value(const QByteArray &role, const QVariant &defaultValue) const
+{
+    if (m_slot < 0) {
+        return defaultValue;
+    }
+    return m_store->value(m_slot, role, defaultValue);
+}
+
+void KFileItemModelColumnStore::RoleValues::insert(const QByteArray &role, const QVariant &value)
+{
+    Q_ASSERT(m_store);
+    if (m_slot < 0) {
+        m_slot = m_store->allocateSlot();
+    }
+    m_store->insert(m_slot, role, value);
+}
+
+void KFileItemModelColumnStore::RoleValues::clear()
+{
+    if (m_slot >= 0) {
+        m_store->clearSlot(m_slot);
+    }
+}
+
+KFileItemModelColumnStore::RoleValues &KFileItemModelColumnStore::RoleValues::operator=(const QHash<QByteArray, QVariant> &values)
+{
+    clear();
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+        insert(it.key(), it.value());
+    }
+    return *this;
+}
+
+QHash<QByteArray, QVariant> KFileItemModelColumnStore::RoleValues::toHash() const
+{
+    if (m_slot < 0) {
+        return QHash<QByteArray, QVariant>();
+    }
+    return m_store->toHash(m_slot);
+}
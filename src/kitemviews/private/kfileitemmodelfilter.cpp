@@ -8,14 +8,12 @@
 
 #include <QRegularExpression>
 
-#include <algorithm>
-
 #include <KFileItem>
 
 KFileItemModelFilter::KFileItemModelFilter()
-    : m_useRegExp(false)
+    : m_patternMode(SubstringMode)
+    , m_literal()
     , m_regExp(nullptr)
-    , m_lowerCasePattern()
     , m_pattern()
     , m_hiddenFilesShown(true)
     , m_hiddenWhitelistEnabled(false)
@@ -33,17 +31,56 @@ KFileItemModelFilter::~KFileItemModelFilter()
 void KFileItemModelFilter::setPattern(const QString &filter)
 {
     m_pattern = filter;
-    m_lowerCasePattern = filter.toLower();
 
-    if (filter.contains(QLatin1Char('*')) || filter.contains(QLatin1Char('?')) || filter.contains(QLatin1Char('['))) {
-        if (!m_regExp) {
-            m_regExp = new QRegularExpression();
-            m_regExp->setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+    const auto isWildcardFree = [](QStringView pattern) {
+        return !pattern.contains(QLatin1Char('*')) && !pattern.contains(QLatin1Char('?')) && !pattern.contains(QLatin1Char('['));
+    };
+
+    if (isWildcardFree(filter)) {
+        // A wildcard-free pattern is a sub-string match.
+        m_patternMode = SubstringMode;
+        m_literal = filter;
+        return;
+    }
+
+    // Compile anchored literals like "literal*", "*literal" and "*literal*" into
+    // plain prefix/suffix/sub-string comparisons, which are far cheaper than the
+    // regular expression engine when a full-model pass tests every name.
+    QStringView literal{filter};
+    bool openStart = false;
+    bool openEnd = false;
+    if (literal.startsWith(QLatin1Char('*'))) {
+        openStart = true;
+        literal = literal.mid(1);
+    }
+    if (literal.endsWith(QLatin1Char('*'))) {
+        openEnd = true;
+        literal.chop(1);
+    }
+    if (!literal.isEmpty() && isWildcardFree(literal)) {
+        m_literal = literal.toString();
+        if (openStart && openEnd) {
+            m_patternMode = SubstringMode;
+        } else if (openEnd) {
+            m_patternMode = PrefixMode;
+        } else {
+            m_patternMode = SuffixMode;
         }
-        m_regExp->setPattern(QRegularExpression::wildcardToRegularExpression(filter));
-        m_useRegExp = m_regExp->isValid();
+        return;
+    }
+
+    if (!m_regExp) {
+        m_regExp = new QRegularExpression();
+        m_regExp->setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+    }
+    m_regExp->setPattern(QRegularExpression::wildcardToRegularExpression(filter));
+    if (m_regExp->isValid()) {
+        m_patternMode = RegExpMode;
     } else {
-        m_useRegExp = false;
+        // Fall back to the legacy behavior for broken patterns: a sub-string
+        // match against the verbatim pattern.
+        m_patternMode = SubstringMode;
+        m_literal = filter;
     }
 }
 
@@ -55,6 +92,7 @@ QString KFileItemModelFilter::pattern() const
 void KFileItemModelFilter::setMimeTypes(const QStringList &types)
 {
     m_mimeTypes = types;
+    m_mimeTypesSet = QSet<QString>(types.constBegin(), types.constEnd());
 }
 
 QStringList KFileItemModelFilter::mimeTypes() const
@@ -65,6 +103,7 @@ QStringList KFileItemModelFilter::mimeTypes() const
 void KFileItemModelFilter::setExcludeMimeTypes(const QStringList &types)
 {
     m_excludeMimeTypes = types;
+    m_excludeMimeTypesSet = QSet<QString>(types.constBegin(), types.constEnd());
 }
 
 QStringList KFileItemModelFilter::excludeMimeTypes() const
@@ -94,6 +133,11 @@ bool KFileItemModelFilter::hiddenFilesWhitelistEnabled() const
 
 void KFileItemModelFilter::setHiddenFilesWhitelist(const QStringList &patterns)
 {
+    if (patterns == m_hiddenWhitelist) {
+        // Skip recompiling the patterns. Callers re-apply the whitelist from the
+        // settings on every hidden files toggle, where it is usually unchanged.
+        return;
+    }
     m_hiddenWhitelist = patterns;
     updateHiddenWhitelistRegExps();
 }
@@ -156,6 +200,20 @@ bool KFileItemModelFilter::matches(const KFileItem &item) const
         }
     }
 
+    return matchesSetFilters(item);
+}
+
+bool KFileItemModelFilter::matches(const KFileItem &item, bool isHidden, bool isWhitelistedHidden) const
+{
+    if (!m_hiddenFilesShown && isHidden && !(m_hiddenWhitelistEnabled && isWhitelistedHidden)) {
+        return false;
+    }
+
+    return matchesSetFilters(item);
+}
+
+bool KFileItemModelFilter::matchesSetFilters(const KFileItem &item) const
+{
     const bool hasPatternFilter = !m_pattern.isEmpty();
     const bool hasMimeTypesFilter = !m_mimeTypes.isEmpty() || !m_excludeMimeTypes.isEmpty();
 
@@ -179,28 +237,26 @@ bool KFileItemModelFilter::matches(const KFileItem &item) const
 
 bool KFileItemModelFilter::matchesPattern(const KFileItem &item) const
 {
-    if (m_useRegExp) {
-        return m_regExp->match(item.text()).hasMatch();
-    } else {
-        return item.text().toLower().contains(m_lowerCasePattern);
+    const QString name = item.text();
+    switch (m_patternMode) {
+    case SubstringMode:
+        return name.contains(m_literal, Qt::CaseInsensitive);
+    case PrefixMode:
+        return name.startsWith(m_literal, Qt::CaseInsensitive);
+    case SuffixMode:
+        return name.endsWith(m_literal, Qt::CaseInsensitive);
+    case RegExpMode:
+        return m_regExp->match(name).hasMatch();
     }
+    return false;
 }
 
 bool KFileItemModelFilter::matchesType(const KFileItem &item) const
 {
-    bool excluded = std::any_of(m_excludeMimeTypes.constBegin(), m_excludeMimeTypes.constEnd(), [item](const QString &excludeMimetype) {
-        return item.mimetype() == excludeMimetype;
-    });
-    if (excluded) {
+    const QString mimeType = item.mimetype();
+    if (m_excludeMimeTypesSet.contains(mimeType)) {
         return false;
     }
 
-    bool included = std::any_of(m_mimeTypes.constBegin(), m_mimeTypes.constEnd(), [item](const QString &mimeType) {
-        return item.mimetype() == mimeType;
-    });
-    if (included) {
-        return true;
-    }
-
-    return m_mimeTypes.isEmpty();
+    return m_mimeTypesSet.isEmpty() || m_mimeTypesSet.contains(mimeType);
 }
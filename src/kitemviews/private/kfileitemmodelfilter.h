@@ -9,6 +9,7 @@
 
 #include "dolphin_export.h"
 
+#include <QSet>
 #include <QStringList>
 
 class KFileItem;
@@ -33,6 +34,11 @@ public:
      * in KFileItemModelFilter::matches(). Per default the pattern
      * defines a sub-string. As soon as the pattern contains at least
      * a '*', '?' or '[' the pattern represents a regular expression.
+     *
+     * The pattern is compiled once here: purely anchored literals like
+     * "literal*", "*literal" and "*literal*" are matched with plain
+     * case-insensitive prefix/suffix/sub-string comparisons instead of
+     * the regular expression engine.
      */
     void setPattern(const QString &pattern);
     QString pattern() const;
@@ -82,9 +88,30 @@ public:
     /**
      * @return True if the item matches with the pattern defined by
      *         @ref setPattern() or @ref setMimeTypes
+     *
+     * This method is safe to call from multiple threads concurrently as
+     * long as the items are distinct instances and the filter itself is
+     * not modified while matching.
      */
     bool matches(const KFileItem &item) const;
 
+    /**
+     * Overload that takes the hidden state of @p item as precomputed values
+     * instead of evaluating KFileItem::isHidden() and the whitelist patterns
+     * per call. KFileItemModel caches both verdicts in its ItemData when an
+     * item is inserted or refreshed, which turns toggling the hidden files
+     * visibility on big directories into a sweep over cached flags.
+     */
+    bool matches(const KFileItem &item, bool isHidden, bool isWhitelistedHidden) const;
+
+    /**
+     * @return True if the hidden item matches any of the whitelist patterns.
+     *
+     * Public so that KFileItemModel can precompute the verdict once per item
+     * for the matches() overload above.
+     */
+    bool matchesHiddenWhitelist(const KFileItem &item) const;
+
 private:
     /**
      * @return True if item matches pattern set by @ref setPattern.
@@ -97,23 +124,32 @@ private:
     bool matchesType(const KFileItem &item) const;
 
     /**
-     * @return True if the hidden item matches any of the whitelist patterns.
+     * @return True if item passes the pattern and mimetype filters. The
+     *         hidden state is not considered here.
      */
-    bool matchesHiddenWhitelist(const KFileItem &item) const;
+    bool matchesSetFilters(const KFileItem &item) const;
 
     /**
      * Updates the compiled regular expressions for the whitelist patterns.
      */
     void updateHiddenWhitelistRegExps();
 
-    bool m_useRegExp; // If true, m_regExp is used for filtering,
-                      // otherwise m_lowerCaseFilter is used.
+    /** How the compiled pattern is evaluated in matchesPattern(). */
+    enum PatternMode {
+        SubstringMode, // m_literal must occur anywhere in the name.
+        PrefixMode, // The name must start with m_literal ("literal*").
+        SuffixMode, // The name must end with m_literal ("*literal").
+        RegExpMode, // The pattern needs full wildcard matching with m_regExp.
+    };
+
+    PatternMode m_patternMode; // Fast path selected when the pattern was compiled in setPattern().
+    QString m_literal; // The literal compared in the non-regexp modes, in original case.
     QRegularExpression *m_regExp;
-    QString m_lowerCasePattern; // Lowercase version of m_filter for
-                                // faster comparison in matches().
     QString m_pattern; // Property set by setPattern().
     QStringList m_mimeTypes; // Property set by setMimeTypes()
     QStringList m_excludeMimeTypes; // Property set by setExcludeMimeTypes()
+    QSet<QString> m_mimeTypesSet; // m_mimeTypes as a set for O(1) lookups in matchesType().
+    QSet<QString> m_excludeMimeTypesSet; // m_excludeMimeTypes as a set for O(1) lookups in matchesType().
 
     bool m_hiddenFilesShown; // Whether hidden files should be visible
     bool m_hiddenWhitelistEnabled; // Whether whitelist is active
@@ -9,9 +9,32 @@
 #ifndef KFILEITEMMODELSORTALGORITHM_H
 #define KFILEITEMMODELSORTALGORITHM_H
 
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QtConcurrentMap>
 #include <QtConcurrentRun>
 
 #include <algorithm>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Counters filled by the sorting templates below when the caller passes a
+ * stats object. All members are updated with relaxed atomics because the
+ * sorting threads write them concurrently.
+ *
+ * Collection is meant for profiling builds only (see the DOLPHIN_SORT_PROFILING
+ * build option): without a stats object the templates behave exactly as before.
+ * The sum of \a busyNanoseconds over all threads compared to the wall time of
+ * the whole sort exposes the achieved parallel speedup, \a merges counts the
+ * cross-thread merge steps whose duration is part of the busy time of the
+ * merging thread.
+ */
+struct KSortProfilingStats {
+    QAtomicInteger<qint64> comparisons{0};
+    QAtomicInteger<qint64> merges{0};
+    QAtomicInteger<qint64> busyNanoseconds{0};
+};
 
 /**
  * Sorts the items using the merge sort algorithm is used to assure a
@@ -45,11 +68,18 @@ static void mergeSort(RandomAccessIterator begin, RandomAccessIterator end, cons
  * threads.
  *
  * The comparison function \a lessThan must be reentrant.
+ *
+ * If \a stats is given, the number of merge steps and the busy time of every
+ * participating thread are recorded in it.
  */
 
 template<typename RandomAccessIterator, typename LessThan>
-static void
-parallelMergeSort(RandomAccessIterator begin, RandomAccessIterator end, LessThan lessThan, int numberOfThreads, int parallelMergeSortingThreshold = 100)
+static void parallelMergeSort(RandomAccessIterator begin,
+                              RandomAccessIterator end,
+                              LessThan lessThan,
+                              int numberOfThreads,
+                              int parallelMergeSortingThreshold = 100,
+                              KSortProfilingStats *stats = nullptr)
 {
     const int span = end - begin;
 
@@ -57,13 +87,33 @@ parallelMergeSort(RandomAccessIterator begin, RandomAccessIterator end, LessThan
         const int newNumberOfThreads = numberOfThreads / 2;
         const RandomAccessIterator middle = begin + span / 2;
 
-        QFuture<void> future =
-            QtConcurrent::run(parallelMergeSort<RandomAccessIterator, LessThan>, begin, middle, lessThan, newNumberOfThreads, parallelMergeSortingThreshold);
-        parallelMergeSort(middle, end, lessThan, newNumberOfThreads, parallelMergeSortingThreshold);
+        QFuture<void> future = QtConcurrent::run(parallelMergeSort<RandomAccessIterator, LessThan>,
+                                                 begin,
+                                                 middle,
+                                                 lessThan,
+                                                 newNumberOfThreads,
+                                                 parallelMergeSortingThreshold,
+                                                 stats);
+        parallelMergeSort(middle, end, lessThan, newNumberOfThreads, parallelMergeSortingThreshold, stats);
 
         future.waitForFinished();
 
-        merge(begin, middle, end, lessThan);
+        if (stats) {
+            QElapsedTimer busyTimer;
+            busyTimer.start();
+            merge(begin, middle, end, lessThan);
+            stats->merges.fetchAndAddRelaxed(1);
+            stats->busyNanoseconds.fetchAndAddRelaxed(busyTimer.nsecsElapsed());
+        } else {
+            merge(begin, middle, end, lessThan);
+        }
+    } else if (stats) {
+        // Leaf of the parallel recursion: the whole range is sorted by this
+        // thread, so the elapsed time is its busy time.
+        QElapsedTimer busyTimer;
+        busyTimer.start();
+        mergeSort(begin, end, lessThan);
+        stats->busyNanoseconds.fetchAndAddRelaxed(busyTimer.nsecsElapsed());
     } else {
         mergeSort(begin, end, lessThan);
     }
@@ -78,6 +128,59 @@ parallelMergeSort(RandomAccessIterator begin, RandomAccessIterator end, LessThan
  * SPDX-FileCopyrightText: 2011 Nokia Corporation and/or its subsidiary(-ies).
  */
 
+/**
+ * Sorts the items between \a begin and \a end by extracting a comparison key
+ * for every item exactly once with \a extractKey - in parallel over all
+ * items - and sorting the keyed entries with \a keyLessThan, which is called
+ * as keyLessThan(keyA, keyB, itemA, itemB) so that equal keys can fall back
+ * to a full comparison of the items.
+ *
+ * Every instantiation gets a concrete, inlinable comparator instead of
+ * dispatching on the sort role for each of the O(n * log n) comparisons.
+ *
+ * Both \a extractKey and \a keyLessThan must be reentrant.
+ *
+ * If \a stats is given, every key comparison is counted in addition to the
+ * merge and busy-time accounting of parallelMergeSort().
+ */
+template<typename Key, typename RandomAccessIterator, typename KeyExtractor, typename KeyLessThan>
+static void keyedParallelMergeSort(RandomAccessIterator begin,
+                                   RandomAccessIterator end,
+                                   const KeyExtractor &extractKey,
+                                   const KeyLessThan &keyLessThan,
+                                   int numberOfThreads,
+                                   KSortProfilingStats *stats = nullptr)
+{
+    using Value = std::decay_t<decltype(*begin)>;
+
+    struct KeyedEntry {
+        Key key;
+        Value value;
+    };
+
+    const int span = static_cast<int>(end - begin);
+    std::vector<KeyedEntry> entries(span);
+    for (int i = 0; i < span; ++i) {
+        entries[i].value = *(begin + i);
+    }
+
+    QtConcurrent::blockingMap(entries, [&extractKey](KeyedEntry &entry) {
+        entry.key = extractKey(entry.value);
+    });
+
+    auto entryLessThan = [&keyLessThan, stats](const KeyedEntry &a, const KeyedEntry &b) {
+        if (stats) {
+            stats->comparisons.fetchAndAddRelaxed(1);
+        }
+        return keyLessThan(a.key, b.key, a.value, b.value);
+    };
+    parallelMergeSort(entries.begin(), entries.end(), entryLessThan, numberOfThreads, 100, stats);
+
+    for (int i = 0; i < span; ++i) {
+        *(begin + i) = entries[i].value;
+    }
+}
+
 template<typename RandomAccessIterator, typename LessThan>
 static void merge(RandomAccessIterator begin, RandomAccessIterator pivot, RandomAccessIterator end, const LessThan &lessThan)
 {
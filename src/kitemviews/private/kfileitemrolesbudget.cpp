@@ -0,0 +1,128 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kfileitemrolesbudget.h"
+
+#include "kfileitemrolestelemetry.h"
+
+namespace
+{
+// Fallback limit for the eager resolution of all items as long as no
+// per-item cost has been measured yet.
+const int DefaultResolveAllItemsLimit = 500;
+}
+
+KFileItemRolesBudget::KFileItemRolesBudget()
+    : m_scrolling(false)
+    , m_targetFrameIntervalMs(16)
+    , m_idleSliceCapMs(200)
+    , m_resolveBudgetMs(1000)
+    , m_resolveAllItemsCap(50000)
+    , m_itemCostUs(0)
+    , m_otherWorkMs(0)
+{
+}
+
+void KFileItemRolesBudget::setScrolling(bool scrolling)
+{
+    m_scrolling = scrolling;
+}
+
+bool KFileItemRolesBudget::isScrolling() const
+{
+    return m_scrolling;
+}
+
+void KFileItemRolesBudget::setTargetFrameInterval(int ms)
+{
+    m_targetFrameIntervalMs = qMax(1, ms);
+}
+
+int KFileItemRolesBudget::targetFrameInterval() const
+{
+    return m_targetFrameIntervalMs;
+}
+
+void KFileItemRolesBudget::setIdleSliceCap(int ms)
+{
+    m_idleSliceCapMs = qMax(1, ms);
+}
+
+int KFileItemRolesBudget::idleSliceCap() const
+{
+    return m_idleSliceCapMs;
+}
+
+void KFileItemRolesBudget::setResolveBudget(int ms)
+{
+    m_resolveBudgetMs = qMax(0, ms);
+}
+
+int KFileItemRolesBudget::resolveBudget() const
+{
+    return m_resolveBudgetMs;
+}
+
+void KFileItemRolesBudget::setResolveAllItemsCap(int count)
+{
+    m_resolveAllItemsCap = qMax(DefaultResolveAllItemsLimit, count);
+}
+
+int KFileItemRolesBudget::resolveAllItemsCap() const
+{
+    return m_resolveAllItemsCap;
+}
+
+int KFileItemRolesBudget::maxBlockTime() const
+{
+    if (m_scrolling) {
+        // Leave most of the frame to the scroll animation.
+        return qMax(2, m_targetFrameIntervalMs / 4);
+    }
+
+    if (m_otherWorkMs > 2 * m_targetFrameIntervalMs) {
+        // The main thread is already congested by other work (painting,
+        // layouting, ...). Blocking it for long would drop even more frames.
+        return m_targetFrameIntervalMs;
+    }
+
+    return m_idleSliceCapMs;
+}
+
+int KFileItemRolesBudget::resolveAllItemsLimit() const
+{
+    if (m_itemCostUs <= 0) {
+        return DefaultResolveAllItemsLimit;
+    }
+
+    const int affordableItems = static_cast<int>(m_resolveBudgetMs * 1000.0 / m_itemCostUs);
+    return qBound(DefaultResolveAllItemsLimit, affordableItems, m_resolveAllItemsCap);
+}
+
+void KFileItemRolesBudget::recordResolved(int count, qint64 elapsedMs)
+{
+    if (m_lastSliceEnd.isValid()) {
+        // Everything that happened between the end of the previous slice and
+        // the end of this one, minus our own work, was other main-thread
+        // work. Smooth it the same way KItemListSmoothScroller smooths the
+        // scroll velocity.
+        const qreal otherWork = qMax<qreal>(0, m_lastSliceEnd.elapsed() - elapsedMs);
+        m_otherWorkMs = (m_otherWorkMs + otherWork) / 2;
+    }
+    m_lastSliceEnd.restart();
+
+    if (count > 0 && elapsedMs > 0) {
+        const qreal costUs = elapsedMs * 1000.0 / count;
+        m_itemCostUs = m_itemCostUs > 0 ? (m_itemCostUs + costUs) / 2 : costUs;
+    }
+
+    // All synchronous slices pass through here, which makes this the natural
+    // central point to feed the stat/mime sniffing telemetry.
+    if (count > 0) {
+        KFileItemRolesTelemetry::instance()->incrementCounter("resolved.syncItems", count);
+        KFileItemRolesTelemetry::instance()->recordLatency("syncSlice", elapsedMs);
+    }
+}
@@ -0,0 +1,107 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KFILEITEMROLESBUDGET_H
+#define KFILEITEMROLESBUDGET_H
+
+#include "dolphin_export.h"
+
+#include <QElapsedTimer>
+
+/**
+ * @brief Adaptive budget for the synchronous work done by KFileItemModelRolesUpdater.
+ *
+ * The roles updater resolves roles in synchronous slices on the main thread.
+ * Instead of hardcoding how long a slice may block and how many items are
+ * resolved eagerly, this policy object measures the actual per-item
+ * resolution cost and how busy the event loop is between slices, and derives
+ * both values from the measurements: long slices and large eager limits on an
+ * idle application with a fast disk, short slices while the user interacts
+ * with the view.
+ *
+ * All thresholds can be tuned at runtime via the setters.
+ */
+class DOLPHIN_EXPORT KFileItemRolesBudget
+{
+public:
+    KFileItemRolesBudget();
+
+    /**
+     * Sets whether the user is currently scrolling fast. While scrolling,
+     * maxBlockTime() returns only a small fraction of a frame so that the
+     * scroll animation stays smooth.
+     */
+    void setScrolling(bool scrolling);
+    bool isScrolling() const;
+
+    /**
+     * Target duration of one frame in milliseconds. Default is 16 ms.
+     */
+    void setTargetFrameInterval(int ms);
+    int targetFrameInterval() const;
+
+    /**
+     * Upper bound in milliseconds for a synchronous slice while the
+     * application is idle. Default is 200 ms.
+     */
+    void setIdleSliceCap(int ms);
+    int idleSliceCap() const;
+
+    /**
+     * Total amount of synchronous time in milliseconds that may be invested
+     * into resolving all items of a directory eagerly. Together with the
+     * measured per-item cost this determines resolveAllItemsLimit().
+     * Default is 1000 ms.
+     */
+    void setResolveBudget(int ms);
+    int resolveBudget() const;
+
+    /**
+     * Upper bound for resolveAllItemsLimit(), independent of how cheap the
+     * items turn out to be. Default is 50000 items.
+     */
+    void setResolveAllItemsCap(int count);
+    int resolveAllItemsCap() const;
+
+    /**
+     * @return Maximum time in milliseconds the next synchronous slice may
+     *         block the main thread. Shrinks to a fraction of a frame while
+     *         scrolling, and to one frame interval when the measurements
+     *         indicate that the event loop is already congested by other
+     *         work.
+     */
+    int maxBlockTime() const;
+
+    /**
+     * @return Number of items up to which the roles of all items of a
+     *         directory are resolved eagerly. Derived from the measured
+     *         per-item cost so that the eager resolution fits into
+     *         resolveBudget().
+     */
+    int resolveAllItemsLimit() const;
+
+    /**
+     * Feeds a measurement into the budget: \a count items were resolved
+     * synchronously within \a elapsedMs milliseconds.
+     */
+    void recordResolved(int count, qint64 elapsedMs);
+
+private:
+    bool m_scrolling;
+    int m_targetFrameIntervalMs;
+    int m_idleSliceCapMs;
+    int m_resolveBudgetMs;
+    int m_resolveAllItemsCap;
+
+    // Averaged cost of resolving a single item, in microseconds.
+    qreal m_itemCostUs;
+    // Averaged time the main thread spent on other work between two
+    // synchronous slices, in milliseconds.
+    qreal m_otherWorkMs;
+    QElapsedTimer m_lastSliceEnd;
+};
+
+#endif
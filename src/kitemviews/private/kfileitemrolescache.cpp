@@ -0,0 +1,166 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kfileitemrolescache.h"
+
+#include <algorithm>
+
+namespace
+{
+// Upper bound for the memory spent on cached previews. The cost of an
+// entry is the pixmap size in KiB.
+const int MaxPreviewCostKiB = 64 * 1024;
+
+// Maximum number of cached directory content counts.
+const int MaxDirectoryCountEntries = 50000;
+
+// When the preview variant index holds entries for more items than this, the
+// entries whose pixmaps have all been evicted from the preview cache are
+// dropped. The index of the items whose pixmaps are still cached is bounded by
+// the memory bound of the preview cache itself.
+const int PreviewVariantIndexPruneThreshold = 10000;
+}
+
+class KFileItemRolesCacheSingleton
+{
+public:
+    KFileItemRolesCache instance;
+};
+Q_GLOBAL_STATIC(KFileItemRolesCacheSingleton, s_KFileItemRolesCache)
+
+KFileItemRolesCache *KFileItemRolesCache::instance()
+{
+    return &s_KFileItemRolesCache->instance;
+}
+
+QPixmap KFileItemRolesCache::preview(const KFileItem &item, const QSize &cacheSize, qreal devicePixelRatio, bool *supportsSequencing) const
+{
+    const CachedPreview *cached = m_previews.object(previewKey(item, cacheSize, devicePixelRatio));
+    if (!cached) {
+        return QPixmap();
+    }
+
+    if (supportsSequencing) {
+        *supportsSequencing = cached->supportsSequencing;
+    }
+    return cached->pixmap;
+}
+
+void KFileItemRolesCache::insertPreview(const KFileItem &item, const QSize &cacheSize, qreal devicePixelRatio, const QPixmap &pixmap, bool supportsSequencing)
+{
+    if (pixmap.isNull()) {
+        return;
+    }
+
+    const int costKiB = qMax(1, pixmap.width() * pixmap.height() * pixmap.depth() / 8 / 1024);
+    m_previews.insert(previewKey(item, cacheSize, devicePixelRatio), new CachedPreview{pixmap, supportsSequencing}, costKiB);
+
+    QList<PreviewVariant> &variants = m_previewVariants[itemKey(item)];
+    const bool variantKnown = std::any_of(variants.constBegin(), variants.constEnd(), [&cacheSize, devicePixelRatio](const PreviewVariant &variant) {
+        return variant.cacheSize == cacheSize && variant.devicePixelRatio == devicePixelRatio;
+    });
+    if (!variantKnown) {
+        variants.append(PreviewVariant{cacheSize, devicePixelRatio});
+    }
+
+    if (m_previewVariants.count() > PreviewVariantIndexPruneThreshold) {
+        // Most of the indexed items must have been evicted from the bounded
+        // preview cache by now; drop the index entries which only refer to
+        // evicted pixmaps.
+        for (auto it = m_previewVariants.begin(); it != m_previewVariants.end();) {
+            const QString &prunedItemKey = it.key();
+            const bool anyCached = std::any_of(it.value().constBegin(), it.value().constEnd(), [this, &prunedItemKey](const PreviewVariant &variant) {
+                return m_previews.contains(prunedItemKey + previewVariantSuffix(variant.cacheSize, variant.devicePixelRatio));
+            });
+            it = anyCached ? it + 1 : m_previewVariants.erase(it);
+        }
+    }
+}
+
+QPixmap KFileItemRolesCache::nearestPreview(const KFileItem &item, const QSize &size, qreal devicePixelRatio) const
+{
+    const auto variantsIt = m_previewVariants.find(itemKey(item));
+    if (variantsIt == m_previewVariants.end()) {
+        return QPixmap();
+    }
+
+    // Pick the cached variant with the highest resolution, pruning the
+    // variants whose pixmap has been evicted meanwhile.
+    QPixmap bestPreview;
+    QList<PreviewVariant> &variants = variantsIt.value();
+    for (auto it = variants.begin(); it != variants.end();) {
+        const CachedPreview *cached = m_previews.object(previewKey(item, it->cacheSize, it->devicePixelRatio));
+        if (!cached) {
+            it = variants.erase(it);
+            continue;
+        }
+        if (cached->pixmap.width() * cached->pixmap.height() > bestPreview.width() * bestPreview.height()) {
+            bestPreview = cached->pixmap;
+        }
+        ++it;
+    }
+    if (variants.isEmpty()) {
+        m_previewVariants.erase(variantsIt);
+    }
+
+    const QSize requestedDeviceSize = (QSizeF(size) * devicePixelRatio).toSize();
+    if (bestPreview.isNull() || qMax(bestPreview.width(), bestPreview.height()) * 2 < qMax(requestedDeviceSize.width(), requestedDeviceSize.height())) {
+        // No cached variant, or the best one would have to be upscaled by more
+        // than a factor of two and would look noticeably blurry.
+        return QPixmap();
+    }
+
+    if (bestPreview.width() > requestedDeviceSize.width() || bestPreview.height() > requestedDeviceSize.height()) {
+        QPixmap scaled = bestPreview.scaled(requestedDeviceSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        scaled.setDevicePixelRatio(devicePixelRatio);
+        return scaled;
+    }
+    return bestPreview;
+}
+
+bool KFileItemRolesCache::directoryCount(const KFileItem &item, int *count, long long *size) const
+{
+    const CachedDirectoryCount *cached = m_directoryCounts.object(directoryCountKey(item));
+    if (!cached) {
+        return false;
+    }
+
+    *count = cached->count;
+    *size = cached->size;
+    return true;
+}
+
+void KFileItemRolesCache::insertDirectoryCount(const KFileItem &item, int count, long long size)
+{
+    m_directoryCounts.insert(directoryCountKey(item), new CachedDirectoryCount{count, size});
+}
+
+KFileItemRolesCache::KFileItemRolesCache()
+    : m_previews(MaxPreviewCostKiB)
+    , m_directoryCounts(MaxDirectoryCountEntries)
+{
+}
+
+QString KFileItemRolesCache::itemKey(const KFileItem &item)
+{
+    return item.url().toString(QUrl::FullyEncoded) + QLatin1Char('\n') + QString::number(item.time(KFileItem::ModificationTime).toSecsSinceEpoch());
+}
+
+QString KFileItemRolesCache::previewVariantSuffix(const QSize &cacheSize, qreal devicePixelRatio)
+{
+    return QLatin1Char('\n') + QString::number(cacheSize.width()) + QLatin1Char('x') + QString::number(cacheSize.height()) + QLatin1Char('@')
+        + QString::number(devicePixelRatio);
+}
+
+QString KFileItemRolesCache::previewKey(const KFileItem &item, const QSize &cacheSize, qreal devicePixelRatio)
+{
+    return itemKey(item) + previewVariantSuffix(cacheSize, devicePixelRatio);
+}
+
+QString KFileItemRolesCache::directoryCountKey(const KFileItem &item)
+{
+    return itemKey(item);
+}
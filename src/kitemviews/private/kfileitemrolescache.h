@@ -0,0 +1,104 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KFILEITEMROLESCACHE_H
+#define KFILEITEMROLESCACHE_H
+
+#include "dolphin_export.h"
+
+#include <KFileItem>
+
+#include <QCache>
+#include <QHash>
+#include <QPixmap>
+#include <QString>
+
+/**
+ * @brief Process-wide cache for expensively resolved roles.
+ *
+ * With split view or several tabs showing the same directory, every
+ * DolphinView owns its own KFileItemModelRolesUpdater and would request
+ * identical previews and directory item counts again. This cache is shared
+ * by all updaters and keyed by the item URL together with its modification
+ * time (plus the requested size and device pixel ratio for previews), so a
+ * second view of a directory populates from memory and stale entries are
+ * never served after a file has changed.
+ */
+class DOLPHIN_EXPORT KFileItemRolesCache
+{
+public:
+    static KFileItemRolesCache *instance();
+
+    /**
+     * @return The cached preview of \a item as it was delivered by
+     *         KIO::PreviewJob for the given \a cacheSize and
+     *         \a devicePixelRatio, or a null pixmap if none is cached.
+     *         \a supportsSequencing is set to the cached value of
+     *         KIO::PreviewJob::handlesSequences() on a hit.
+     */
+    QPixmap preview(const KFileItem &item, const QSize &cacheSize, qreal devicePixelRatio, bool *supportsSequencing) const;
+
+    void insertPreview(const KFileItem &item, const QSize &cacheSize, qreal devicePixelRatio, const QPixmap &pixmap, bool supportsSequencing);
+
+    /**
+     * @return The cached preview of \a item which comes closest to the
+     *         requested \a size at \a devicePixelRatio, considering all cache
+     *         sizes and device pixel ratios the item's preview has been
+     *         inserted under. This lets e.g. a tooltip reuse the thumbnail
+     *         which a view has already resolved at its icon size. A preview
+     *         larger than requested is scaled down smoothly; a smaller one is
+     *         returned as delivered as long as it still provides at least half
+     *         of the requested edge length in device pixels. A null pixmap is
+     *         returned when no cached variant is close enough.
+     */
+    QPixmap nearestPreview(const KFileItem &item, const QSize &size, qreal devicePixelRatio) const;
+
+    /**
+     * @return True if a directory content count for \a item is cached.
+     *         \a count and \a size are only written on a hit.
+     */
+    bool directoryCount(const KFileItem &item, int *count, long long *size) const;
+
+    void insertDirectoryCount(const KFileItem &item, int count, long long size);
+
+private:
+    KFileItemRolesCache();
+
+    static QString itemKey(const KFileItem &item);
+    static QString previewVariantSuffix(const QSize &cacheSize, qreal devicePixelRatio);
+    static QString previewKey(const KFileItem &item, const QSize &cacheSize, qreal devicePixelRatio);
+    static QString directoryCountKey(const KFileItem &item);
+
+    struct CachedPreview {
+        QPixmap pixmap;
+        bool supportsSequencing;
+    };
+
+    struct CachedDirectoryCount {
+        int count;
+        long long size;
+    };
+
+    struct PreviewVariant {
+        QSize cacheSize;
+        qreal devicePixelRatio;
+    };
+
+    QCache<QString, CachedPreview> m_previews;
+    QCache<QString, CachedDirectoryCount> m_directoryCounts;
+
+    /**
+     * Remembers under which cache sizes and device pixel ratios a preview of
+     * an item has been inserted, so that nearestPreview() can try the existing
+     * variants directly instead of scanning all cache keys. Variants whose
+     * pixmap has meanwhile been evicted from m_previews are pruned lazily.
+     */
+    mutable QHash<QString, QList<PreviewVariant>> m_previewVariants;
+
+    friend class KFileItemRolesCacheSingleton;
+};
+
+#endif
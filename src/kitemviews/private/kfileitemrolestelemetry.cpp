@@ -0,0 +1,128 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kfileitemrolestelemetry.h"
+
+#include "kitemviews/kfileitemmodelrolesupdater.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+struct KFileItemRolesTelemetrySingleton {
+    KFileItemRolesTelemetry instance;
+};
+Q_GLOBAL_STATIC(KFileItemRolesTelemetrySingleton, s_rolesTelemetry)
+
+KFileItemRolesTelemetry *KFileItemRolesTelemetry::instance()
+{
+    return &s_rolesTelemetry->instance;
+}
+
+KFileItemRolesTelemetry::KFileItemRolesTelemetry()
+    : m_mutex(),
+      m_counters(),
+      m_histograms(),
+      m_updaters()
+{
+}
+
+void KFileItemRolesTelemetry::registerUpdater(const KFileItemModelRolesUpdater *updater)
+{
+    QMutexLocker locker(&m_mutex);
+    m_updaters.insert(updater);
+}
+
+void KFileItemRolesTelemetry::unregisterUpdater(const KFileItemModelRolesUpdater *updater)
+{
+    QMutexLocker locker(&m_mutex);
+    m_updaters.remove(updater);
+}
+
+void KFileItemRolesTelemetry::incrementCounter(const QByteArray &name, qint64 delta)
+{
+    QMutexLocker locker(&m_mutex);
+    m_counters[name] += delta;
+}
+
+void KFileItemRolesTelemetry::recordLatency(const QByteArray &source, qint64 milliseconds)
+{
+    recordSample(source, milliseconds);
+}
+
+void KFileItemRolesTelemetry::recordSample(const QByteArray &name, qint64 value)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_histograms.find(name);
+    if (it == m_histograms.end()) {
+        it = m_histograms.insert(name, {});
+    }
+    ++(*it)[bucketForLatency(value)];
+}
+
+QString KFileItemRolesTelemetry::report() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QJsonObject counters;
+    for (auto it = m_counters.constBegin(); it != m_counters.constEnd(); ++it) {
+        counters.insert(QString::fromLatin1(it.key()), it.value());
+    }
+
+    // Each histogram is emitted as an array of bucket counts. The upper bound
+    // of bucket i is (1 << i) milliseconds, the last bucket is open-ended.
+    QJsonObject histograms;
+    for (auto it = m_histograms.constBegin(); it != m_histograms.constEnd(); ++it) {
+        QJsonArray buckets;
+        for (qint64 count : it.value()) {
+            buckets.append(count);
+        }
+        histograms.insert(QString::fromLatin1(it.key()), buckets);
+    }
+
+    QJsonObject queues;
+    for (const KFileItemModelRolesUpdater *updater : m_updaters) {
+        const QHash<QByteArray, int> depths = updater->telemetryQueueDepths();
+        for (auto it = depths.constBegin(); it != depths.constEnd(); ++it) {
+            const QString key = QString::fromLatin1(it.key());
+            queues.insert(key, queues.value(key).toInt() + it.value());
+        }
+    }
+
+    QJsonObject root;
+    root.insert(QStringLiteral("counters"), counters);
+    root.insert(QStringLiteral("latencyHistogramsMs"), histograms);
+    root.insert(QStringLiteral("queueDepths"), queues);
+    root.insert(QStringLiteral("updaters"), m_updaters.count());
+
+    return QString::fromUtf8(QJsonDocument(root).toJson(QJsonDocument::Compact));
+}
+
+QHash<QByteArray, qint64> KFileItemRolesTelemetry::counters() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_counters;
+}
+
+QHash<QByteArray, QList<qint64>> KFileItemRolesTelemetry::histograms() const
+{
+    QMutexLocker locker(&m_mutex);
+    QHash<QByteArray, QList<qint64>> histograms;
+    histograms.reserve(m_histograms.count());
+    for (auto it = m_histograms.constBegin(); it != m_histograms.constEnd(); ++it) {
+        histograms.insert(it.key(), QList<qint64>(it.value().begin(), it.value().end()));
+    }
+    return histograms;
+}
+
+int KFileItemRolesTelemetry::bucketForLatency(qint64 milliseconds)
+{
+    int bucket = 0;
+    while (bucket < LatencyBucketCount - 1 && milliseconds > (qint64(1) << bucket)) {
+        ++bucket;
+    }
+    return bucket;
+}
@@ -0,0 +1,95 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KFILEITEMROLESTELEMETRY_H
+#define KFILEITEMROLESTELEMETRY_H
+
+#include "dolphin_export.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+#include <array>
+
+class KFileItemModelRolesUpdater;
+
+/**
+ * @brief Process-wide instrumentation for the role resolution machinery.
+ *
+ * Answers the question why a directory populates slowly: counters tell how
+ * many roles of which kind were resolved, latency histograms tell how long
+ * the individual sources (preview jobs, Baloo, the synchronous slices on the
+ * GUI thread) took, and the queue depths of all live
+ * KFileItemModelRolesUpdater instances tell what is still outstanding.
+ *
+ * The collected numbers can be scraped over the D-Bus method
+ * GetRolesUpdaterTelemetry() of the DBusInterface. Recording is cheap (a
+ * mutex-guarded counter increment), so the instrumentation is always on.
+ */
+class DOLPHIN_EXPORT KFileItemRolesTelemetry
+{
+public:
+    static KFileItemRolesTelemetry *instance();
+
+    void registerUpdater(const KFileItemModelRolesUpdater *updater);
+    void unregisterUpdater(const KFileItemModelRolesUpdater *updater);
+
+    /**
+     * Increments the counter \a name by \a delta, e.g. "resolved.preview".
+     */
+    void incrementCounter(const QByteArray &name, qint64 delta = 1);
+
+    /**
+     * Adds one sample of \a milliseconds to the latency histogram of
+     * \a source. The histogram buckets are powers of two: the first bucket
+     * holds samples up to 1 ms, the last everything above 16 s.
+     */
+    void recordLatency(const QByteArray &source, qint64 milliseconds);
+
+    /**
+     * Adds one sample of \a value to the histogram \a name. Same power-of-two
+     * bucketing as recordLatency(), but for dimensionless quantities such as
+     * directory sizes, where only the distribution matters.
+     */
+    void recordSample(const QByteArray &name, qint64 value);
+
+    /**
+     * @return The counters, histograms and current queue depths as a JSON
+     *         document, see the D-Bus method GetRolesUpdaterTelemetry().
+     */
+    QString report() const;
+
+    /**
+     * @return A snapshot of the counters, for users that need the values
+     *         structured instead of the JSON of report(), e.g. the opt-in
+     *         performance user-feedback data source.
+     */
+    QHash<QByteArray, qint64> counters() const;
+
+    /**
+     * @return A snapshot of the histograms as bucket-count lists. The upper
+     *         bound of bucket i is (1 << i), the last bucket is open-ended.
+     */
+    QHash<QByteArray, QList<qint64>> histograms() const;
+
+private:
+    KFileItemRolesTelemetry();
+
+    static constexpr int LatencyBucketCount = 16;
+
+    static int bucketForLatency(qint64 milliseconds);
+
+    mutable QMutex m_mutex;
+    QHash<QByteArray, qint64> m_counters;
+    QHash<QByteArray, std::array<qint64, LatencyBucketCount>> m_histograms;
+    QSet<const KFileItemModelRolesUpdater *> m_updaters;
+
+    friend struct KFileItemRolesTelemetrySingleton;
+};
+
+#endif
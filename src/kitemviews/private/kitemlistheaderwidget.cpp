@@ -12,6 +12,7 @@
 #include <QGraphicsSceneHoverEvent>
 #include <QPainter>
 #include <QStyleOptionHeader>
+#include <QtMath>
 
 namespace
 {
@@ -110,6 +111,7 @@ void KItemListHeaderWidget::setColumns(const QList<QByteArray> &roles)
     }
 
     m_columns = layoutDirection() == Qt::LeftToRight ? roles : reversed(roles);
+    m_sectionCache.clear();
     update();
 }
 
@@ -214,7 +216,8 @@ void KItemListHeaderWidget::paint(QPainter *painter, const QStyleOptionGraphicsI
     for (const QByteArray &role : std::as_const(m_columns)) {
         const qreal roleWidth = m_columnWidths.value(role);
         const QRectF rect(x, 0, roleWidth, size().height());
-        paintRole(painter, role, rect, orderIndex, widget);
+        const QStyleOptionHeader::SectionPosition position = paintPaddings(painter, rect, orderIndex, widget);
+        painter->drawPixmap(QPointF(x, 0), cachedSectionPixmap(role, roleWidth, orderIndex, position, widget));
         x += roleWidth;
         ++orderIndex;
     }
@@ -427,6 +430,22 @@ void KItemListHeaderWidget::hoverMoveEvent(QGraphicsSceneHoverEvent *event)
     }
 }
 
+void KItemListHeaderWidget::changeEvent(QEvent *event)
+{
+    switch (event->type()) {
+    case QEvent::StyleChange:
+    case QEvent::PaletteChange:
+    case QEvent::FontChange:
+    case QEvent::LayoutDirectionChange:
+        m_sectionCache.clear();
+        break;
+    default:
+        break;
+    }
+
+    QGraphicsWidget::changeEvent(event);
+}
+
 void KItemListHeaderWidget::slotSortRoleChanged(const QByteArray &current, const QByteArray &previous)
 {
     Q_UNUSED(current)
@@ -442,6 +461,17 @@ void KItemListHeaderWidget::slotSortOrderChanged(Qt::SortOrder current, Qt::Sort
 }
 
 void KItemListHeaderWidget::paintRole(QPainter *painter, const QByteArray &role, const QRectF &rect, int orderIndex, QWidget *widget) const
+{
+    const QStyleOptionHeader::SectionPosition position = paintPaddings(painter, rect, orderIndex, widget);
+    paintSection(painter, role, rect, orderIndex, position, widget);
+}
+
+void KItemListHeaderWidget::paintSection(QPainter *painter,
+                                         const QByteArray &role,
+                                         const QRectF &rect,
+                                         int orderIndex,
+                                         QStyleOptionHeader::SectionPosition position,
+                                         QWidget *widget) const
 {
     // The following code is based on the code from QHeaderView::paintSection().
     // SPDX-FileCopyrightText: 2011 Nokia Corporation and/or its subsidiary(-ies).
@@ -465,10 +495,15 @@ void KItemListHeaderWidget::paintRole(QPainter *painter, const QByteArray &role,
     }
     option.rect = rect.toRect();
     option.orientation = Qt::Horizontal;
+    option.position = position;
     option.selectedPosition = QStyleOptionHeader::NotAdjacent;
     option.text = m_model->roleDescription(role);
 
-    // First we paint any potential empty (padding) space on left and/or right of this role's column.
+    style()->drawControl(QStyle::CE_Header, &option, painter, widget);
+}
+
+QStyleOptionHeader::SectionPosition KItemListHeaderWidget::paintPaddings(QPainter *painter, const QRectF &rect, int orderIndex, QWidget *widget) const
+{
     const auto paintPadding = [&](int section, const QRectF &rect, const QStyleOptionHeader::SectionPosition &pos) {
         QStyleOptionHeader padding;
         padding.state = QStyle::State_None | QStyle::State_Raised | QStyle::State_Horizontal;
@@ -481,30 +516,69 @@ void KItemListHeaderWidget::paintRole(QPainter *painter, const QByteArray &role,
     };
 
     if (m_columns.count() == 1) {
-        option.position = QStyleOptionHeader::Middle;
         paintPadding(0, QRectF(0.0, 0.0, rect.left(), rect.height()), QStyleOptionHeader::Beginning);
         paintPadding(1, QRectF(rect.right(), 0.0, size().width() - rect.right(), rect.height()), QStyleOptionHeader::End);
+        return QStyleOptionHeader::Middle;
     } else if (orderIndex == 0) {
-        // Paint the header for the first column; check if there is some empty space to the left which needs to be filled.
+        // The first column; check if there is some empty space to the left which needs to be filled.
         if (rect.left() > 0) {
-            option.position = QStyleOptionHeader::Middle;
             paintPadding(0, QRectF(0.0, 0.0, rect.left(), rect.height()), QStyleOptionHeader::Beginning);
-        } else {
-            option.position = QStyleOptionHeader::Beginning;
+            return QStyleOptionHeader::Middle;
         }
+        return QStyleOptionHeader::Beginning;
     } else if (orderIndex == m_columns.count() - 1) {
-        // Paint the header for the last column; check if there is some empty space to the right which needs to be filled.
+        // The last column; check if there is some empty space to the right which needs to be filled.
         if (rect.right() < size().width()) {
-            option.position = QStyleOptionHeader::Middle;
             paintPadding(m_columns.count(), QRectF(rect.right(), 0.0, size().width() - rect.right(), rect.height()), QStyleOptionHeader::End);
-        } else {
-            option.position = QStyleOptionHeader::End;
+            return QStyleOptionHeader::Middle;
         }
+        return QStyleOptionHeader::End;
+    }
+    return QStyleOptionHeader::Middle;
+}
+
+QPixmap KItemListHeaderWidget::cachedSectionPixmap(const QByteArray &role, qreal width, int orderIndex, QStyleOptionHeader::SectionPosition position, QWidget *widget)
+    const
+{
+    if (width <= 0 || size().height() <= 0) {
+        return QPixmap();
+    }
+
+    const qreal devicePixelRatio = widget ? widget->devicePixelRatioF() : qApp->devicePixelRatio();
+
+    // The key captures everything that influences the rendering of the
+    // section apart from the palette, the style and the font; changes to
+    // those clear the whole cache, see changeEvent().
+    QString key = QString::number(width) + QLatin1Char('|') + QString::number(size().height()) + QLatin1Char('|') + QString::number(orderIndex)
+        + QLatin1Char('|') + QString::number(position) + QLatin1Char('|') + QString::number(devicePixelRatio) + QLatin1Char('|');
+    key += QLatin1Char(m_hoveredIndex == orderIndex ? '1' : '0');
+    key += QLatin1Char(m_pressedRoleIndex == orderIndex ? '1' : '0');
+    key += QLatin1Char(isEnabled() ? '1' : '0');
+    key += QLatin1Char(window() && window()->isActiveWindow() ? '1' : '0');
+    if (m_model->sortRole() == role) {
+        key += QLatin1Char(m_model->sortOrder() == Qt::AscendingOrder ? 'v' : '^');
     } else {
-        option.position = QStyleOptionHeader::Middle;
+        key += QLatin1Char('-');
     }
+    key += m_model->roleDescription(role);
 
-    style()->drawControl(QStyle::CE_Header, &option, painter, widget);
+    CachedSection &section = m_sectionCache[role];
+    if (section.key == key && !section.pixmap.isNull()) {
+        return section.pixmap;
+    }
+
+    QPixmap pixmap(QSize(qCeil(width * devicePixelRatio), qCeil(size().height() * devicePixelRatio)));
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmap.fill(Qt::transparent);
+
+    QPainter painter(&pixmap);
+    painter.setFont(font());
+    painter.setPen(palette().text().color());
+    paintSection(&painter, role, QRectF(0, 0, width, size().height()), orderIndex, position, widget);
+
+    section.key = key;
+    section.pixmap = pixmap;
+    return pixmap;
 }
 
 void KItemListHeaderWidget::updatePressedRoleIndex(const QPointF &pos)
@@ -13,6 +13,7 @@
 #include <QGraphicsWidget>
 #include <QHash>
 #include <QList>
+#include <QStyleOption>
 
 class KItemModelBase;
 
@@ -106,6 +107,7 @@ protected:
     void hoverEnterEvent(QGraphicsSceneHoverEvent *event) override;
     void hoverLeaveEvent(QGraphicsSceneHoverEvent *event) override;
     void hoverMoveEvent(QGraphicsSceneHoverEvent *event) override;
+    void changeEvent(QEvent *event) override;
 
 private Q_SLOTS:
     void slotSortRoleChanged(const QByteArray &current, const QByteArray &previous);
@@ -119,6 +121,29 @@ private:
 
     void paintRole(QPainter *painter, const QByteArray &role, const QRectF &rect, int orderIndex, QWidget *widget = nullptr) const;
 
+    /**
+     * Paints the header section of \a role into \a rect without any padding
+     * areas. \a position describes where the section lies within the header.
+     */
+    void paintSection(QPainter *painter, const QByteArray &role, const QRectF &rect, int orderIndex, QStyleOptionHeader::SectionPosition position, QWidget *widget)
+        const;
+
+    /**
+     * Paints the empty padding areas that surround the section at \a rect,
+     * if there are any.
+     * @return The position of the section within the header.
+     */
+    QStyleOptionHeader::SectionPosition paintPaddings(QPainter *painter, const QRectF &rect, int orderIndex, QWidget *widget) const;
+
+    /**
+     * @return The pixmap of the header section for \a role. The pixmap is
+     *         taken from m_sectionCache and is only re-rendered if the
+     *         width or the state of the section changed since the last
+     *         paint. This keeps interactive column resizing cheap: only the
+     *         resized section is rendered again, all others are blitted.
+     */
+    QPixmap cachedSectionPixmap(const QByteArray &role, qreal width, int orderIndex, QStyleOptionHeader::SectionPosition position, QWidget *widget) const;
+
     void updatePressedRoleIndex(const QPointF &pos);
     void updateHoveredIndex(const QPointF &pos);
     int roleIndexAt(const QPointF &pos) const;
@@ -176,6 +201,14 @@ private:
         int index;
     };
     MovingRole m_movingRole;
+
+    struct CachedSection {
+        QString key;
+        QPixmap pixmap;
+    };
+    // Rendered header sections keyed by role, see cachedSectionPixmap().
+    // The cache is cleared when the style, palette or font changes.
+    mutable QHash<QByteArray, CachedSection> m_sectionCache;
 };
 
 #endif
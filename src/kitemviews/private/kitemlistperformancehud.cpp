@@ -0,0 +1,196 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kitemlistperformancehud.h"
+
+#include "kitemviews/kitemlistcontroller.h"
+#include "kitemviews/kitemlistview.h"
+
+#include <QEvent>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QScreen>
+#include <QTimer>
+
+namespace
+{
+/** Size of the overlay. Wide enough for the graph plus four lines of statistics. */
+constexpr int HudWidth = 240;
+constexpr int HudHeight = 132;
+constexpr int HudMargin = 6;
+constexpr int GraphHeight = 48;
+
+/** Paint intervals above this are idle pauses between interactions, not frames of an animation, and are not recorded. */
+constexpr qreal IdleThresholdMs = 250.0;
+
+/** How often the overlay repaints itself with fresh numbers. */
+constexpr int RepaintIntervalMs = 500;
+}
+
+KItemListPerformanceHud::KItemListPerformanceHud(KItemListController *controller, QWidget *parent)
+    : QWidget(parent)
+    , m_controller(controller)
+    , m_sincePreviousFrame()
+    , m_frameTimesMs()
+    , m_frameHistoryIndex(0)
+    , m_recordedFrameCount(0)
+    , m_droppedFrameCount(0)
+    , m_sinceRateUpdate()
+    , m_createdWidgetBaseline(0)
+    , m_recycledWidgetBaseline(0)
+    , m_createdWidgetsPerSecond(0)
+    , m_recycledWidgetsPerSecond(0)
+    , m_repaintTimer(nullptr)
+{
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setFixedSize(HudWidth, HudHeight);
+    setFocusPolicy(Qt::NoFocus);
+
+    parent->installEventFilter(this);
+    updatePosition();
+
+    m_sinceRateUpdate.start();
+
+    m_repaintTimer = new QTimer(this);
+    m_repaintTimer->setInterval(RepaintIntervalMs);
+    connect(m_repaintTimer, &QTimer::timeout, this, QOverload<>::of(&QWidget::update));
+    m_repaintTimer->start();
+
+    show();
+    raise();
+}
+
+bool KItemListPerformanceHud::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == parentWidget()) {
+        if (event->type() == QEvent::Paint) {
+            // Repainting the translucent overlay itself repaints the viewport behind it.
+            // Such paints are no frames of the view and would distort the graph.
+            if (!geometry().contains(static_cast<QPaintEvent *>(event)->rect())) {
+                recordFrame();
+            }
+        } else if (event->type() == QEvent::Resize) {
+            updatePosition();
+        }
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+void KItemListPerformanceHud::recordFrame()
+{
+    if (!m_sincePreviousFrame.isValid()) {
+        m_sincePreviousFrame.start();
+        return;
+    }
+
+    const qreal intervalMs = m_sincePreviousFrame.nsecsElapsed() / 1000000.0;
+    m_sincePreviousFrame.restart();
+
+    if (intervalMs > IdleThresholdMs) {
+        // An idle pause between interactions, not a slow frame.
+        return;
+    }
+
+    m_frameTimesMs[m_frameHistoryIndex] = intervalMs;
+    m_frameHistoryIndex = (m_frameHistoryIndex + 1) % FrameHistoryLength;
+    ++m_recordedFrameCount;
+
+    const qreal periodMs = refreshPeriodMs();
+    if (intervalMs > periodMs * 1.5) {
+        // Count how many refresh deadlines this frame missed.
+        m_droppedFrameCount += qMax(qint64(1), qRound64(intervalMs / periodMs) - 1);
+    }
+}
+
+void KItemListPerformanceHud::updatePosition()
+{
+    move(parentWidget()->width() - width() - HudMargin, HudMargin);
+}
+
+qreal KItemListPerformanceHud::refreshPeriodMs() const
+{
+    const QScreen *currentScreen = screen();
+    const qreal refreshRate = currentScreen ? currentScreen->refreshRate() : 0;
+    return refreshRate > 0 ? 1000.0 / refreshRate : 1000.0 / 60.0;
+}
+
+void KItemListPerformanceHud::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event)
+
+    const KItemListView *view = m_controller->view();
+
+    // Refresh the per-second widget rates about once a second, independently of how often the overlay repaints.
+    if (view && m_sinceRateUpdate.elapsed() >= 1000) {
+        const qreal seconds = m_sinceRateUpdate.nsecsElapsed() / 1000000000.0;
+        m_createdWidgetsPerSecond = (view->createdWidgetCount() - m_createdWidgetBaseline) / seconds;
+        m_recycledWidgetsPerSecond = (view->recycledWidgetCount() - m_recycledWidgetBaseline) / seconds;
+        m_createdWidgetBaseline = view->createdWidgetCount();
+        m_recycledWidgetBaseline = view->recycledWidgetCount();
+        m_sinceRateUpdate.restart();
+    }
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(0, 0, 0, 160));
+    painter.drawRoundedRect(rect(), 4, 4);
+
+    // The frame-time graph: one bar per recorded frame, newest on the right.
+    // The horizontal line marks the refresh period of the screen, so every
+    // bar crossing it is a frame that arrived late.
+    const QRectF graphRect(HudMargin, HudMargin, width() - 2 * HudMargin, GraphHeight);
+    const qreal periodMs = refreshPeriodMs();
+    const qreal graphCeilingMs = periodMs * 4;
+    const qreal barWidth = graphRect.width() / FrameHistoryLength;
+    const int availableFrames = qMin(m_recordedFrameCount, FrameHistoryLength);
+    painter.setBrush(QColor(120, 200, 120, 220));
+    for (int i = 0; i < availableFrames; ++i) {
+        const qreal frameTimeMs = m_frameTimesMs[(m_frameHistoryIndex - availableFrames + i + FrameHistoryLength) % FrameHistoryLength];
+        const qreal barHeight = qMin(frameTimeMs, graphCeilingMs) / graphCeilingMs * graphRect.height();
+        if (frameTimeMs > periodMs * 1.5) {
+            painter.setBrush(QColor(230, 120, 100, 220));
+        } else {
+            painter.setBrush(QColor(120, 200, 120, 220));
+        }
+        painter.drawRect(QRectF(graphRect.left() + i * barWidth, graphRect.bottom() - barHeight, barWidth, barHeight));
+    }
+    painter.setPen(QColor(255, 255, 255, 120));
+    const qreal deadlineY = graphRect.bottom() - periodMs / graphCeilingMs * graphRect.height();
+    painter.drawLine(QPointF(graphRect.left(), deadlineY), QPointF(graphRect.right(), deadlineY));
+
+    // The statistics below the graph. Untranslated on purpose: the HUD is a
+    // support tool which is pasted into bug reports, not user interface.
+    qreal averageMs = 0;
+    qreal maximumMs = 0;
+    for (int i = 0; i < availableFrames; ++i) {
+        averageMs += m_frameTimesMs[i];
+        maximumMs = qMax(maximumMs, m_frameTimesMs[i]);
+    }
+    if (availableFrames > 0) {
+        averageMs /= availableFrames;
+    }
+
+    QFont hudFont = font();
+    hudFont.setPointSizeF(qMax(6.0, hudFont.pointSizeF() - 2));
+    painter.setFont(hudFont);
+    painter.setPen(Qt::white);
+
+    const QStringList lines = {
+        QStringLiteral("frame: %1 ms avg, %2 ms max").arg(averageMs, 0, 'f', 1).arg(maximumMs, 0, 'f', 1),
+        QStringLiteral("dropped frames: %1").arg(m_droppedFrameCount),
+        QStringLiteral("widgets/s: %1 created, %2 recycled").arg(m_createdWidgetsPerSecond, 0, 'f', 1).arg(m_recycledWidgetsPerSecond, 0, 'f', 1),
+        QStringLiteral("last layout: %1 ms").arg(view ? view->lastLayoutDurationMicroseconds() / 1000.0 : 0, 0, 'f', 2),
+    };
+    const int lineHeight = painter.fontMetrics().lineSpacing();
+    int y = int(graphRect.bottom()) + HudMargin + painter.fontMetrics().ascent();
+    for (const QString &line : lines) {
+        painter.drawText(HudMargin, y, line);
+        y += lineHeight;
+    }
+}
+
+#include "moc_kitemlistperformancehud.cpp"
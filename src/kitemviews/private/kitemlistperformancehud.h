@@ -0,0 +1,85 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KITEMLISTPERFORMANCEHUD_H
+#define KITEMLISTPERFORMANCEHUD_H
+
+#include "dolphin_export.h"
+
+#include <QElapsedTimer>
+#include <QWidget>
+
+#include <array>
+
+class KItemListController;
+
+/**
+ * @brief Semi-transparent overlay which visualizes the rendering performance of a view.
+ *
+ * The HUD sits in the top right corner of the viewport it is a child of and
+ * shows a live frame-time graph, the number of frames which missed the
+ * refresh deadline of the screen, the widget-recycle rate and the duration of
+ * the last layout pass of the KItemListView. It exists so "scrolling feels
+ * slow" reports can be quantified with numbers tied to the exact view
+ * configuration that shows the problem.
+ *
+ * Frame times are taken from the paint events of the parent viewport, which
+ * the HUD observes through an event filter. The overlay is transparent for
+ * mouse events and is only created at all when the hidden configuration
+ * entry RenderingPerformanceHud of the [General] group of dolphinrc is
+ * enabled, so normal sessions pay nothing for it.
+ */
+class DOLPHIN_EXPORT KItemListPerformanceHud : public QWidget
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param controller Used to reach the current KItemListView of the
+     *                   observed viewport, which can change over time.
+     * @param parent     The viewport widget the HUD covers. The HUD filters
+     *                   its paint and resize events.
+     */
+    explicit KItemListPerformanceHud(KItemListController *controller, QWidget *parent);
+
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    /** Records the interval since the previous paint of the observed viewport. */
+    void recordFrame();
+
+    /** Moves the HUD into the top right corner of the parent viewport. */
+    void updatePosition();
+
+    /** @return The refresh period of the screen this widget is shown on in milliseconds. */
+    qreal refreshPeriodMs() const;
+
+private:
+    static constexpr int FrameHistoryLength = 120;
+
+    KItemListController *m_controller;
+
+    QElapsedTimer m_sincePreviousFrame;
+    /** Ring buffer of the most recent frame times in milliseconds, m_frameHistoryIndex points past the newest entry. */
+    std::array<qreal, FrameHistoryLength> m_frameTimesMs;
+    int m_frameHistoryIndex;
+    int m_recordedFrameCount;
+    quint64 m_droppedFrameCount;
+
+    /** Baselines for the per-second rates shown in the HUD, refreshed once a second. */
+    QElapsedTimer m_sinceRateUpdate;
+    quint64 m_createdWidgetBaseline;
+    quint64 m_recycledWidgetBaseline;
+    qreal m_createdWidgetsPerSecond;
+    qreal m_recycledWidgetsPerSecond;
+
+    QTimer *m_repaintTimer;
+};
+
+#endif
@@ -143,8 +143,11 @@ void KItemListRoleEditor::autoAdjustSize()
     const auto originalSize = size();
     auto newSize = originalSize;
 
-    document()->adjustSize();
-    const qreal requiredWidth = document()->size().width();
+    // idealWidth() measures the text without changing the text width of the
+    // document. The previously used adjustSize() re-layouted the whole
+    // document to its ideal width just to read the same value, and the
+    // setTextWidth() below then layouted it back - twice per typed character.
+    const qreal requiredWidth = document()->idealWidth();
     const qreal availableWidth = size().width() - frameBorder;
     if (requiredWidth > availableWidth) {
         qreal newWidth = requiredWidth + frameBorder;
@@ -167,9 +170,12 @@ void KItemListRoleEditor::autoAdjustSize()
     if (originalSize != newSize) {
         resize(newSize);
     }
-    // reset the document width to the widget width
-    // to allow alignment to be properly rendered
-    document()->setTextWidth(newSize.width());
+    // Match the document width to the widget width to allow alignment to be
+    // properly rendered, but only when it changed: setTextWidth() triggers a
+    // full relayout of the document even for an unchanged width.
+    if (document()->textWidth() != newSize.width()) {
+        document()->setTextWidth(newSize.width());
+    }
 }
 
 void KItemListRoleEditor::emitRoleEditingFinished(EditResultDirection direction)
@@ -11,19 +11,42 @@
 
 #include <QApplication>
 #include <QDBusConnection>
-#include <QPropertyAnimation>
 #include <QScrollBar>
 #include <QStyle>
+#include <QTimer>
 #include <QWheelEvent>
+#include <QWindow>
+
+namespace
+{
+// Interval of the fallback timer that drives the animation as long as the
+// scrollbar is not part of a shown window whose update-request cycle could
+// be used instead.
+const int FallbackFrameInterval = 1000 / 60;
+}
 
 KItemListSmoothScroller::KItemListSmoothScroller(QScrollBar *scrollBar, QObject *parent)
     : QObject(parent)
     , m_scrollBarPressed(false)
     , m_smoothScrolling(true)
     , m_scrollBar(scrollBar)
-    , m_animation(nullptr)
+    , m_targetObject(nullptr)
+    , m_propertyName()
+    , m_animationRunning(false)
+    , m_animationDuration(1)
+    , m_animationStart(0)
+    , m_animationEnd(0)
+    , m_animationEasing(QEasingCurve::InOutQuad)
+    , m_animationTime()
+    , m_frameWindow(nullptr)
+    , m_frameFallbackTimer(nullptr)
+    , m_velocityMeasurementTime()
+    , m_velocity(0)
 {
-    m_animation = new QPropertyAnimation(this);
+    m_frameFallbackTimer = new QTimer(this);
+    m_frameFallbackTimer->setInterval(FallbackFrameInterval);
+    m_frameFallbackTimer->setSingleShot(true);
+    connect(m_frameFallbackTimer, &QTimer::timeout, this, &KItemListSmoothScroller::frameTick);
 
     KSharedConfig::Ptr globalConfig = KSharedConfig::openConfig(QStringLiteral("kdeglobals"), KConfig::IncludeGlobals);
     KConfigGroup configGroup(globalConfig, QStringLiteral("KDE"));
@@ -35,7 +58,6 @@ KItemListSmoothScroller::KItemListSmoothScroller(QScrollBar *scrollBar, QObject
                                           QStringLiteral("notifyChange"),
                                           this,
                                           SLOT(updateAnimationDuration(bool)));
-    connect(m_animation, &QPropertyAnimation::stateChanged, this, &KItemListSmoothScroller::slotAnimationStateChanged);
 
     m_scrollBar->installEventFilter(this);
 }
@@ -56,28 +78,24 @@ QScrollBar *KItemListSmoothScroller::scrollBar() const
 
 void KItemListSmoothScroller::setTargetObject(QObject *target)
 {
-    if (m_animation->state() == QAbstractAnimation::Running) {
-        m_animation->stop();
-    }
-    m_animation->setTargetObject(target);
+    stopAnimation();
+    m_targetObject = target;
 }
 
 QObject *KItemListSmoothScroller::targetObject() const
 {
-    return m_animation->targetObject();
+    return m_targetObject;
 }
 
 void KItemListSmoothScroller::setPropertyName(const QByteArray &propertyName)
 {
-    if (m_animation->state() == QAbstractAnimation::Running) {
-        m_animation->stop();
-    }
-    m_animation->setPropertyName(propertyName);
+    stopAnimation();
+    m_propertyName = propertyName;
 }
 
 QByteArray KItemListSmoothScroller::propertyName() const
 {
-    return m_animation->propertyName();
+    return m_propertyName;
 }
 
 void KItemListSmoothScroller::scrollContentsBy(qreal distance)
@@ -87,6 +105,21 @@ void KItemListSmoothScroller::scrollContentsBy(qreal distance)
         return;
     }
 
+    if (!m_velocityMeasurementTime.isValid()) {
+        m_velocityMeasurementTime.start();
+    } else {
+        const qint64 elapsed = m_velocityMeasurementTime.restart();
+        if (elapsed > 0 && elapsed < 1000) {
+            // Average with the previous velocity so that a single slow or
+            // fast scroll event does not make the estimate jump.
+            m_velocity = (m_velocity + qAbs(distance) * 1000.0 / elapsed) / 2;
+        } else {
+            // The last scroll event is too long ago to estimate a velocity.
+            m_velocity = 0;
+        }
+        Q_EMIT scrollVelocityChanged(m_velocity);
+    }
+
     const QByteArray name = propertyName();
     const qreal currentOffset = target->property(name).toReal();
     if (static_cast<int>(currentOffset) == m_scrollBar->value()) {
@@ -94,12 +127,14 @@ void KItemListSmoothScroller::scrollContentsBy(qreal distance)
         return;
     }
 
-    const bool animRunning = (m_animation->state() == QAbstractAnimation::Running);
+    const bool animRunning = m_animationRunning;
     if (animRunning) {
-        // Stopping a running animation means skipping the range from the current offset
-        // until the target offset. To prevent skipping of the range the difference
-        // is added to the new target offset.
-        const qreal oldEndOffset = m_animation->endValue().toReal();
+        // Wheel events that arrive while the animation is active are
+        // coalesced into it: stopping a running animation means skipping the
+        // range from the current offset until the target offset. To prevent
+        // skipping of the range the difference is added to the new target
+        // offset.
+        const qreal oldEndOffset = m_animationEnd;
         distance += (currentOffset - oldEndOffset);
     }
 
@@ -111,7 +146,7 @@ void KItemListSmoothScroller::scrollContentsBy(qreal distance)
             // one frame must be added to the start-offset to keep the animation smooth. This also
             // assures that animation proceeds even in cases where new end-offset are triggered
             // within a very short timeslots.
-            startOffset += (endOffset - currentOffset) * 1000 / (m_animation->duration() * 60);
+            startOffset += (endOffset - currentOffset) * 1000 / (m_animationDuration * 60);
             if (currentOffset < endOffset) {
                 startOffset = qMin(startOffset, endOffset);
             } else {
@@ -119,11 +154,7 @@ void KItemListSmoothScroller::scrollContentsBy(qreal distance)
             }
         }
 
-        m_animation->stop();
-        m_animation->setStartValue(startOffset);
-        m_animation->setEndValue(endOffset);
-        m_animation->setEasingCurve(animRunning ? QEasingCurve::OutQuad : QEasingCurve::InOutQuad);
-        m_animation->start();
+        startAnimation(startOffset, endOffset, animRunning ? QEasingCurve(QEasingCurve::OutQuad) : QEasingCurve(QEasingCurve::InOutQuad));
         target->setProperty(name, startOffset);
     } else {
         target->setProperty(name, endOffset);
@@ -143,7 +174,7 @@ void KItemListSmoothScroller::scrollTo(qreal position)
 
 bool KItemListSmoothScroller::requestScrollBarUpdate(int newMaximum)
 {
-    if (m_animation->state() == QAbstractAnimation::Running) {
+    if (m_animationRunning) {
         if (newMaximum == m_scrollBar->maximum()) {
             // The value has been changed by the animation, no update
             // of the scrollbars is required as their target state will be
@@ -154,13 +185,22 @@ bool KItemListSmoothScroller::requestScrollBarUpdate(int newMaximum)
         // The maximum has been changed which indicates that the content
         // of the view has been changed. Stop the animation in any case and
         // update the scrollbars immediately.
-        m_animation->stop();
+        stopAnimation();
     }
     return true;
 }
 
 bool KItemListSmoothScroller::eventFilter(QObject *obj, QEvent *event)
 {
+    if (obj == m_frameWindow) {
+        // The window is about to present a new frame. The event is only
+        // observed, never consumed, so the regular repainting is unaffected.
+        if (event->type() == QEvent::UpdateRequest && m_animationRunning) {
+            frameTick();
+        }
+        return QObject::eventFilter(obj, event);
+    }
+
     Q_ASSERT(obj == m_scrollBar);
 
     switch (event->type()) {
@@ -184,15 +224,85 @@ bool KItemListSmoothScroller::eventFilter(QObject *obj, QEvent *event)
     return QObject::eventFilter(obj, event);
 }
 
-void KItemListSmoothScroller::slotAnimationStateChanged(QAbstractAnimation::State newState, QAbstractAnimation::State oldState)
+void KItemListSmoothScroller::startAnimation(qreal start, qreal end, const QEasingCurve &easing)
+{
+    stopAnimation();
+
+    m_animationStart = start;
+    m_animationEnd = end;
+    m_animationEasing = easing;
+    m_animationRunning = true;
+    m_animationTime.start();
+
+    requestFrame();
+}
+
+void KItemListSmoothScroller::stopAnimation()
+{
+    if (!m_animationRunning) {
+        return;
+    }
+
+    m_animationRunning = false;
+    m_frameFallbackTimer->stop();
+    markAnimationStopped();
+}
+
+void KItemListSmoothScroller::frameTick()
+{
+    if (!m_animationRunning) {
+        return;
+    }
+
+    QObject *target = targetObject();
+    if (!target) {
+        stopAnimation();
+        return;
+    }
+
+    // The elapsed time is taken when the window asks for the next frame, so
+    // the offset below corresponds to the frame that is about to be
+    // presented rather than to an unrelated timer tick.
+    const qreal progress = qMin(1.0, static_cast<qreal>(m_animationTime.elapsed()) / qMax(1, m_animationDuration));
+    const qreal offset = m_animationStart + (m_animationEnd - m_animationStart) * m_animationEasing.valueForProgress(progress);
+    target->setProperty(m_propertyName.constData(), offset);
+
+    if (progress >= 1.0) {
+        m_animationRunning = false;
+        markAnimationStopped();
+    } else {
+        requestFrame();
+    }
+}
+
+void KItemListSmoothScroller::requestFrame()
+{
+    QWindow *window = m_scrollBar->window() ? m_scrollBar->window()->windowHandle() : nullptr;
+    if (window) {
+        if (m_frameWindow != window) {
+            if (m_frameWindow) {
+                m_frameWindow->removeEventFilter(this);
+            }
+            window->installEventFilter(this);
+            m_frameWindow = window;
+        }
+        window->requestUpdate();
+    } else {
+        m_frameFallbackTimer->start();
+    }
+}
+
+void KItemListSmoothScroller::markAnimationStopped()
 {
-    Q_UNUSED(oldState)
-    if (newState == QAbstractAnimation::Stopped && m_smoothScrolling && !m_scrollBarPressed) {
+    if (m_smoothScrolling && !m_scrollBarPressed) {
         m_smoothScrolling = false;
     }
-    if (newState == QAbstractAnimation::Stopped) {
-        Q_EMIT scrollingStopped();
+    if (m_velocity != 0) {
+        m_velocity = 0;
+        m_velocityMeasurementTime.invalidate();
+        Q_EMIT scrollVelocityChanged(0);
     }
+    Q_EMIT scrollingStopped();
 }
 
 void KItemListSmoothScroller::updateAnimationDuration(bool isSmoothScrollingEnabled)
@@ -201,9 +311,9 @@ void KItemListSmoothScroller::updateAnimationDuration(bool isSmoothScrollingEnab
         // Breeze sets SH_Widget_Animation_Duration from the KDE global animation speed setting
         const int animationDuration = m_scrollBar->style()->styleHint(QStyle::SH_Widget_Animation_Duration, nullptr, m_scrollBar);
         const bool animationEnabled = (animationDuration > 0);
-        m_animation->setDuration(animationEnabled ? animationDuration : 1);
+        m_animationDuration = animationEnabled ? animationDuration : 1;
     } else {
-        m_animation->setDuration(1);
+        m_animationDuration = 1;
     }
 }
 
@@ -222,8 +332,8 @@ void KItemListSmoothScroller::handleWheelEvent(QWheelEvent *event)
 
 bool KItemListSmoothScroller::isAnimating()
 {
-    if (m_animation) {
-        return (m_animation->state() == QAbstractAnimation::Running);
+    if (m_animationRunning) {
+        return true;
     }
     return false;
 }
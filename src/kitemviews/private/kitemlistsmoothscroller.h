@@ -9,16 +9,26 @@
 
 #include "dolphin_export.h"
 
-#include <QAbstractAnimation>
+#include <QByteArray>
+#include <QEasingCurve>
+#include <QElapsedTimer>
 #include <QObject>
+#include <QPointer>
 
-class QPropertyAnimation;
 class QScrollBar;
+class QTimer;
 class QWheelEvent;
+class QWindow;
 
 /**
  * @brief Helper class for KItemListContainer to have a smooth
  *        scrolling when adjusting the scrollbars.
+ *
+ * The scroll animation is driven by the update-request cycle of the window
+ * that contains the scrollbar, so each animation step is computed for the
+ * frame that is about to be presented instead of for an unrelated timer
+ * tick. This keeps the frame pacing even on displays with high refresh
+ * rates and avoids rendering frames that are never shown.
  */
 class DOLPHIN_EXPORT KItemListSmoothScroller : public QObject
 {
@@ -75,11 +85,16 @@ Q_SIGNALS:
      */
     void scrollingStopped();
 
+    /**
+     * Emitted whenever the estimated scroll velocity changes. The velocity
+     * is 0 when the scrolling has stopped.
+     */
+    void scrollVelocityChanged(qreal pixelsPerSecond);
+
 protected:
     bool eventFilter(QObject *obj, QEvent *event) override;
 
 private Q_SLOTS:
-    void slotAnimationStateChanged(QAbstractAnimation::State newState, QAbstractAnimation::State oldState);
     /**
      * Calculates the duration of the smooth scrolling animation.
      * If \p isSmoothScrollingEnabled is true, the duration will be calculated
@@ -88,11 +103,61 @@ private Q_SLOTS:
      */
     void updateAnimationDuration(bool isSmoothScrollingEnabled);
 
+private:
+    /**
+     * Starts the scroll animation from offset \a start to offset \a end. A
+     * running animation is implicitly replaced; wheel events that arrive
+     * while an animation is active are hence coalesced into it by the
+     * caller, see scrollContentsBy().
+     */
+    void startAnimation(qreal start, qreal end, const QEasingCurve &easing);
+
+    /**
+     * Stops a running scroll animation without jumping to the end offset.
+     */
+    void stopAnimation();
+
+    /**
+     * Advances the scroll animation to the offset that corresponds to the
+     * time of the frame that is about to be presented and requests the next
+     * frame if the end offset has not been reached yet.
+     */
+    void frameTick();
+
+    /**
+     * Requests the next frame for frameTick() from the update-request cycle
+     * of the window that contains the scrollbar. If the scrollbar is not
+     * part of a native window yet, a fallback timer is used instead.
+     */
+    void requestFrame();
+
+    /**
+     * Resets the scrolling state after the animation has finished or has
+     * been interrupted and emits scrollingStopped().
+     */
+    void markAnimationStopped();
+
 private:
     bool m_scrollBarPressed;
     bool m_smoothScrolling;
     QScrollBar *m_scrollBar;
-    QPropertyAnimation *m_animation;
+
+    QObject *m_targetObject;
+    QByteArray m_propertyName;
+
+    bool m_animationRunning;
+    int m_animationDuration;
+    qreal m_animationStart;
+    qreal m_animationEnd;
+    QEasingCurve m_animationEasing;
+    /** Measures the time since the animation has been started. */
+    QElapsedTimer m_animationTime;
+    /** The window whose update-requests currently drive the animation. */
+    QPointer<QWindow> m_frameWindow;
+    QTimer *m_frameFallbackTimer;
+
+    QElapsedTimer m_velocityMeasurementTime;
+    qreal m_velocity;
 };
 
 #endif
@@ -7,21 +7,32 @@
 #include "kitemlistviewanimation.h"
 #include "kitemviews/kitemlistview.h"
 
-#include <QPropertyAnimation>
+#include <QEasingCurve>
+#include <QStyle>
+#include <QTimer>
+
+namespace
+{
+// Tick interval of the shared timeline. 60 updates per second match the
+// granularity that the individual animation objects used before.
+const int TimelineInterval = 1000 / 60;
+}
 
 KItemListViewAnimation::KItemListViewAnimation(QObject *parent)
     : QObject(parent)
     , m_scrollOrientation(Qt::Vertical)
     , m_scrollOffset(0)
     , m_animation()
+    , m_timer(nullptr)
+    , m_tickTimer()
 {
+    m_timer = new QTimer(this);
+    m_timer->setInterval(TimelineInterval);
+    connect(m_timer, &QTimer::timeout, this, &KItemListViewAnimation::slotTick);
 }
 
 KItemListViewAnimation::~KItemListViewAnimation()
 {
-    for (int type = 0; type < AnimationTypeCount; ++type) {
-        qDeleteAll(m_animation[type]);
-    }
 }
 
 void KItemListViewAnimation::setScrollOrientation(Qt::Orientation orientation)
@@ -48,12 +59,12 @@ void KItemListViewAnimation::setScrollOffset(qreal offset)
             continue;
         }
 
-        QHashIterator<QGraphicsWidget *, QPropertyAnimation *> it(m_animation[type]);
+        QMutableHashIterator<QGraphicsWidget *, Animation> it(m_animation[type]);
         while (it.hasNext()) {
             it.next();
 
             QGraphicsWidget *widget = it.key();
-            QPropertyAnimation *propertyAnim = it.value();
+            Animation &anim = it.value();
 
             QPointF currentPos = widget->pos();
             if (m_scrollOrientation == Qt::Vertical) {
@@ -63,29 +74,18 @@ void KItemListViewAnimation::setScrollOffset(qreal offset)
             }
 
             if (type == MovingAnimation) {
-                // Stop the animation, calculate the moved start- and end-value
-                // and restart the animation for the remaining duration.
-                const int remainingDuration = propertyAnim->duration() - propertyAnim->currentTime();
-
-                const bool block = propertyAnim->signalsBlocked();
-                propertyAnim->blockSignals(true);
-                propertyAnim->stop();
-
-                QPointF endPos = propertyAnim->endValue().toPointF();
+                // Calculate the moved start- and end-value and restart the
+                // interpolation for the remaining duration.
+                anim.duration = qMax(anim.duration - anim.elapsed, 1);
+                anim.elapsed = 0;
+                anim.startPos = currentPos;
                 if (m_scrollOrientation == Qt::Vertical) {
-                    endPos.ry() += diff;
+                    anim.endPos.ry() += diff;
                 } else {
-                    endPos.rx() += diff;
+                    anim.endPos.rx() += diff;
                 }
-
-                propertyAnim->setDuration(remainingDuration);
-                propertyAnim->setStartValue(currentPos);
-                propertyAnim->setEndValue(endPos);
-                propertyAnim->start();
-                propertyAnim->blockSignals(block);
-            } else {
-                widget->setPos(currentPos);
             }
+            widget->setPos(currentPos);
         }
     }
 }
@@ -99,8 +99,9 @@ void KItemListViewAnimation::start(QGraphicsWidget *widget, AnimationType type,
 {
     stop(widget, type);
 
-    QPropertyAnimation *propertyAnim = nullptr;
-    const int animationDuration = widget->style()->styleHint(QStyle::SH_Widget_Animate) ? 200 : 1;
+    Animation anim;
+    anim.elapsed = 0;
+    anim.duration = widget->style()->styleHint(QStyle::SH_Widget_Animate) ? 200 : 1;
 
     switch (type) {
     case MovingAnimation: {
@@ -109,48 +110,35 @@ void KItemListViewAnimation::start(QGraphicsWidget *widget, AnimationType type,
             return;
         }
 
-        propertyAnim = new QPropertyAnimation(widget, "pos");
-        propertyAnim->setDuration(animationDuration);
-        propertyAnim->setEndValue(newPos);
+        anim.startPos = widget->pos();
+        anim.endPos = newPos;
         break;
     }
 
-    case CreateAnimation: {
-        propertyAnim = new QPropertyAnimation(widget, "opacity");
-        propertyAnim->setEasingCurve(QEasingCurve::InQuart);
-        propertyAnim->setDuration(animationDuration);
-        propertyAnim->setStartValue(0.0);
-        propertyAnim->setEndValue(1.0);
+    case CreateAnimation:
+        widget->setOpacity(0.0);
         break;
-    }
 
-    case DeleteAnimation: {
-        propertyAnim = new QPropertyAnimation(widget, "opacity");
-        propertyAnim->setEasingCurve(QEasingCurve::OutQuart);
-        propertyAnim->setDuration(animationDuration);
-        propertyAnim->setStartValue(1.0);
-        propertyAnim->setEndValue(0.0);
+    case DeleteAnimation:
+        widget->setOpacity(1.0);
         break;
-    }
 
     default:
         Q_UNREACHABLE();
         break;
     }
 
-    Q_ASSERT(propertyAnim);
-    connect(propertyAnim, &QPropertyAnimation::finished, this, &KItemListViewAnimation::slotFinished);
-    m_animation[type].insert(widget, propertyAnim);
+    m_animation[type].insert(widget, anim);
 
-    propertyAnim->start();
+    if (!m_timer->isActive()) {
+        m_tickTimer.start();
+        m_timer->start();
+    }
 }
 
 void KItemListViewAnimation::stop(QGraphicsWidget *widget, AnimationType type)
 {
-    QPropertyAnimation *propertyAnim = m_animation[type].value(widget);
-    if (propertyAnim) {
-        propertyAnim->stop();
-
+    if (m_animation[type].remove(widget) > 0) {
         switch (type) {
         case MovingAnimation:
             break;
@@ -164,9 +152,6 @@ void KItemListViewAnimation::stop(QGraphicsWidget *widget, AnimationType type)
             break;
         }
 
-        m_animation[type].remove(widget);
-        delete propertyAnim;
-
         Q_EMIT finished(widget, type);
     }
 }
@@ -180,7 +165,7 @@ void KItemListViewAnimation::stop(QGraphicsWidget *widget)
 
 bool KItemListViewAnimation::isStarted(QGraphicsWidget *widget, AnimationType type) const
 {
-    return m_animation[type].value(widget);
+    return m_animation[type].contains(widget);
 }
 
 bool KItemListViewAnimation::isStarted(QGraphicsWidget *widget) const
@@ -193,25 +178,63 @@ bool KItemListViewAnimation::isStarted(QGraphicsWidget *widget) const
     return false;
 }
 
-void KItemListViewAnimation::slotFinished()
+void KItemListViewAnimation::slotTick()
 {
-    QPropertyAnimation *finishedAnim = qobject_cast<QPropertyAnimation *>(sender());
+    const int elapsed = static_cast<int>(m_tickTimer.restart());
+
+    static const QEasingCurve createCurve(QEasingCurve::InQuart);
+    static const QEasingCurve deleteCurve(QEasingCurve::OutQuart);
+
+    // The values of all widgets are committed within this one tick, so the
+    // scene coalesces them into a single update. The finished-signals are
+    // emitted after the iteration as the receivers might start or stop
+    // other animations.
+    QVector<QGraphicsWidget *> finishedWidgets[AnimationTypeCount];
+
+    bool stillRunning = false;
     for (int type = 0; type < AnimationTypeCount; ++type) {
-        QMutableHashIterator<QGraphicsWidget *, QPropertyAnimation *> it(m_animation[type]);
+        QMutableHashIterator<QGraphicsWidget *, Animation> it(m_animation[type]);
         while (it.hasNext()) {
             it.next();
-            QPropertyAnimation *propertyAnim = it.value();
-            if (propertyAnim == finishedAnim) {
-                QGraphicsWidget *widget = it.key();
-                it.remove();
-                finishedAnim->deleteLater();
 
-                Q_EMIT finished(widget, static_cast<AnimationType>(type));
-                return;
+            QGraphicsWidget *widget = it.key();
+            Animation &anim = it.value();
+
+            anim.elapsed += elapsed;
+            const qreal progress = qMin(qreal(anim.elapsed) / anim.duration, qreal(1.0));
+
+            switch (type) {
+            case MovingAnimation:
+                widget->setPos(anim.startPos + (anim.endPos - anim.startPos) * progress);
+                break;
+            case CreateAnimation:
+                widget->setOpacity(createCurve.valueForProgress(progress));
+                break;
+            case DeleteAnimation:
+                widget->setOpacity(1.0 - deleteCurve.valueForProgress(progress));
+                break;
+            default:
+                break;
+            }
+
+            if (progress >= 1.0) {
+                it.remove();
+                finishedWidgets[type].append(widget);
+            } else {
+                stillRunning = true;
             }
         }
     }
-    Q_ASSERT(false);
+
+    if (!stillRunning) {
+        m_timer->stop();
+    }
+
+    for (int type = 0; type < AnimationTypeCount; ++type) {
+        for (QGraphicsWidget *widget : std::as_const(finishedWidgets[type])) {
+            Q_EMIT finished(widget, static_cast<AnimationType>(type));
+        }
+    }
 }
 
 #include "moc_kitemlistviewanimation.cpp"
@@ -9,19 +9,27 @@
 
 #include "dolphin_export.h"
 
+#include <QElapsedTimer>
 #include <QHash>
 #include <QObject>
+#include <QPointF>
 #include <QVariant>
 
 class KItemListView;
 class QGraphicsWidget;
-class QPropertyAnimation;
+class QTimer;
 
 /**
  * @brief Internal helper class for KItemListView to animate the items.
  *
  * Supports item animations for moving, creating, deleting and resizing
  * an item. Several applications can be applied to one item in parallel.
+ *
+ * All concurrently running animations are driven by one shared timeline:
+ * a single timer tick interpolates the values of every animated widget,
+ * so that inserting or removing a large batch of items does not start
+ * hundreds of independently ticking animation objects and all position
+ * and opacity changes of a tick get coalesced into one scene update.
  */
 class DOLPHIN_EXPORT KItemListViewAnimation : public QObject
 {
@@ -76,12 +84,30 @@ Q_SIGNALS:
     void finished(QGraphicsWidget *widget, KItemListViewAnimation::AnimationType type);
 
 private Q_SLOTS:
-    void slotFinished();
+    /**
+     * Advances all running animations by the elapsed time of the shared
+     * timeline and applies the interpolated values to the widgets.
+     */
+    void slotTick();
 
 private:
+    /**
+     * State of one running animation. The interpolated value is derived
+     * from the progress elapsed/duration, the positions are only used by
+     * the moving-animation.
+     */
+    struct Animation {
+        int elapsed;
+        int duration;
+        QPointF startPos;
+        QPointF endPos;
+    };
+
     Qt::Orientation m_scrollOrientation;
     qreal m_scrollOffset;
-    QHash<QGraphicsWidget *, QPropertyAnimation *> m_animation[AnimationTypeCount];
+    QHash<QGraphicsWidget *, Animation> m_animation[AnimationTypeCount];
+    QTimer *m_timer;
+    QElapsedTimer m_tickTimer;
 };
 
 #endif
@@ -11,9 +11,19 @@
 
 #include <QGuiApplication>
 #include <QScopeGuard>
+#include <QTimer>
+
+#include <algorithm>
 
 // #define KITEMLISTVIEWLAYOUTER_DEBUG
 
+namespace
+{
+// Number of items which are laid out per idle time slice when the layout
+// is completed incrementally behind the viewport.
+const int LayoutChunkSize = 16384;
+}
+
 KItemListViewLayouter::KItemListViewLayouter(KItemListSizeHintResolver *sizeHintResolver, QObject *parent)
     : QObject(parent)
     , m_dirty(true)
@@ -34,7 +44,19 @@ KItemListViewLayouter::KItemListViewLayouter(KItemListSizeHintResolver *sizeHint
     , m_columnWidth(0)
     , m_xPosInc(0)
     , m_columnCount(0)
-    , m_rowOffsets()
+    , m_rowCount(0)
+    , m_firstRowOffset(0)
+    , m_rowOffsetTree()
+    , m_rowHeights()
+    , m_firstItemIndexOfRow()
+    , m_minimumRowHeight(0)
+    , m_grouped(false)
+    , m_layoutInProgress(false)
+    , m_layoutedItemCount(0)
+    , m_layoutY(0)
+    , m_layoutItemMarginHeight(0)
+    , m_buildRowOffsets()
+    , m_layoutTimer(nullptr)
     , m_columnOffsets()
     , m_groupItemIndexes()
     , m_groupHeaderHeight(0)
@@ -43,6 +65,11 @@ KItemListViewLayouter::KItemListViewLayouter(KItemListSizeHintResolver *sizeHint
     , m_statusBarOffset(0)
 {
     Q_ASSERT(m_sizeHintResolver);
+
+    m_layoutTimer = new QTimer(this);
+    m_layoutTimer->setInterval(0);
+    m_layoutTimer->setSingleShot(true);
+    connect(m_layoutTimer, &QTimer::timeout, this, &KItemListViewLayouter::continueLayout);
 }
 
 KItemListViewLayouter::~KItemListViewLayouter()
@@ -217,11 +244,12 @@ QRectF KItemListViewLayouter::itemRect(int index) const
     if (index < 0 || index >= m_itemInfos.count()) {
         return QRectF();
     }
+    const_cast<KItemListViewLayouter *>(this)->ensureItemLayouted(index);
 
     QSizeF sizeHint = m_sizeHintResolver->sizeHint(index);
 
     const qreal x = m_columnOffsets.at(m_itemInfos.at(index).column);
-    const qreal y = m_rowOffsets.at(m_itemInfos.at(index).row);
+    const qreal y = rowOffset(m_itemInfos.at(index).row);
 
     if (m_scrollOrientation == Qt::Horizontal) {
         // Rotate the logical direction which is always vertical by 90°
@@ -245,6 +273,43 @@ QRectF KItemListViewLayouter::itemRect(int index) const
     return QRectF(pos, sizeHint);
 }
 
+std::pair<int, int> KItemListViewLayouter::itemRangeForRect(const QRectF &rect) const
+{
+    const_cast<KItemListViewLayouter *>(this)->doLayout();
+
+    if (m_rowCount <= 0 || m_itemInfos.isEmpty()) {
+        return std::make_pair(-1, -1);
+    }
+
+    // Map the rectangle back into the logical row-offset direction
+    // (see the coordinate handling in itemRect()).
+    qreal minOffset;
+    qreal maxOffset;
+    if (m_scrollOrientation == Qt::Horizontal) {
+        if (QGuiApplication::isRightToLeft()) {
+            minOffset = m_size.width() - 1 + m_scrollOffset - rect.right();
+            maxOffset = m_size.width() - 1 + m_scrollOffset - rect.left();
+        } else {
+            minOffset = rect.left() + m_scrollOffset;
+            maxOffset = rect.right() + m_scrollOffset;
+        }
+    } else {
+        minOffset = rect.top() + m_scrollOffset;
+        maxOffset = rect.bottom() + m_scrollOffset;
+    }
+
+    // The first row is the one that contains the minimum offset, the last
+    // row is the last one that begins before the maximum offset. Rows never
+    // extend into the area of their successors, so no intersecting item can
+    // be outside this range.
+    const int firstRow = rowForOffset(minOffset, true);
+    const int lastRow = qMax(firstRow, rowForOffset(maxOffset, false));
+
+    const int firstIndex = m_firstItemIndexOfRow.at(firstRow);
+    const int lastIndex = (lastRow + 1 < m_rowCount) ? m_firstItemIndexOfRow.at(lastRow + 1) - 1 : m_itemInfos.count() - 1;
+    return std::make_pair(firstIndex, lastIndex);
+}
+
 QRectF KItemListViewLayouter::groupHeaderRect(int index) const
 {
     const_cast<KItemListViewLayouter *>(this)->doLayout();
@@ -303,6 +368,7 @@ int KItemListViewLayouter::itemColumn(int index) const
     if (index < 0 || index >= m_itemInfos.count()) {
         return -1;
     }
+    const_cast<KItemListViewLayouter *>(this)->ensureItemLayouted(index);
 
     return (m_scrollOrientation == Qt::Vertical) ? m_itemInfos[index].column : m_itemInfos[index].row;
 }
@@ -313,6 +379,7 @@ int KItemListViewLayouter::itemRow(int index) const
     if (index < 0 || index >= m_itemInfos.count()) {
         return -1;
     }
+    const_cast<KItemListViewLayouter *>(this)->ensureItemLayouted(index);
 
     return (m_scrollOrientation == Qt::Vertical) ? m_itemInfos[index].row : m_itemInfos[index].column;
 }
@@ -342,6 +409,42 @@ void KItemListViewLayouter::markAsDirty()
     m_dirty = true;
 }
 
+void KItemListViewLayouter::updateSizeHints(int index, int count)
+{
+    if (m_dirty) {
+        // A full relayout is pending anyway and will pick up the new
+        // size hints.
+        return;
+    }
+
+    if (m_layoutInProgress) {
+        // The incremental layout has not reached all items yet; restarting
+        // it is cheaper than patching a half-built row geometry.
+        markAsDirty();
+        return;
+    }
+
+    if (index < 0 || count <= 0 || index + count > m_itemInfos.count()) {
+        markAsDirty();
+        return;
+    }
+
+    const int firstRow = m_itemInfos.at(index).row;
+    const int lastRow = m_itemInfos.at(index + count - 1).row;
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        const qreal height = calculateRowHeight(row);
+        const qreal delta = height - m_rowHeights.at(row);
+        if (delta != 0) {
+            m_rowHeights[row] = height;
+            adjustRowAdvance(row, delta);
+            m_maximumScrollOffset += delta;
+        }
+    }
+
+    m_visibleIndexesDirty = true;
+}
+
 void KItemListViewLayouter::setStatusBarOffset(int offset)
 {
     if (m_statusBarOffset != offset) {
@@ -363,10 +466,25 @@ void KItemListViewLayouter::doLayout()
         updateVisibleIndexes();
     });
 
-    if (!m_dirty) {
-        return;
+    if (m_dirty) {
+        startIncrementalLayout();
     }
 
+    if (m_layoutInProgress && m_visibleIndexesDirty) {
+        // Lay out synchronously up to the bottom of the viewport so that
+        // the visible indexes can be resolved. The remaining items are
+        // processed in idle time slices by m_layoutTimer.
+        const int visibleHeight = (m_scrollOrientation == Qt::Horizontal) ? m_size.width() : m_size.height();
+        qreal bottom = m_scrollOffset + visibleHeight;
+        if (m_model->groupedSorting()) {
+            bottom += m_groupHeaderHeight;
+        }
+        layoutUntil(-1, bottom, -1);
+    }
+}
+
+void KItemListViewLayouter::startIncrementalLayout()
+{
 #ifdef KITEMLISTVIEWLAYOUTER_DEBUG
     QElapsedTimer timer;
     timer.start();
@@ -378,6 +496,7 @@ void KItemListViewLayouter::doLayout()
     QSizeF size = m_size;
 
     const bool grouped = createGroupHeaders();
+    m_grouped = grouped;
 
     const bool horizontalScrolling = m_scrollOrientation == Qt::Horizontal;
     if (horizontalScrolling) {
@@ -441,7 +560,7 @@ void KItemListViewLayouter::doLayout()
         }
     }
 
-    // Prepare the QVector which stores the y-coordinate for each new row.
+    // Prepare the QVectors which store the geometry for each new row.
     int numberOfRows = (itemCount + m_columnCount - 1) / m_columnCount;
     if (grouped && m_columnCount > 1) {
         // In the worst case, a new row will be started for every group.
@@ -450,14 +569,60 @@ void KItemListViewLayouter::doLayout()
         // memory than it would save in the average case.
         numberOfRows += m_groupItemIndexes.count();
     }
-    m_rowOffsets.resize(numberOfRows);
+    m_buildRowOffsets.resize(numberOfRows);
+    m_rowHeights.resize(numberOfRows);
+    m_firstItemIndexOfRow.resize(numberOfRows);
+    m_minimumRowHeight = itemSize.height();
+    m_layoutItemMarginHeight = itemMargin.height();
+
+    m_layoutY = m_headerHeight + itemMargin.height();
+    m_firstRowOffset = m_layoutY;
+    m_rowCount = 0;
+    m_layoutedItemCount = 0;
+    m_layoutInProgress = true;
+    m_maximumItemOffset = (itemCount > 0) ? m_columnCount * m_columnWidth : 0;
+    m_dirty = false;
 
-    qreal y = m_headerHeight + itemMargin.height();
-    int row = 0;
+    if (itemCount > 0) {
+        updateMaximumScrollOffsetEstimate();
+        m_layoutTimer->start();
+    } else {
+        finishIncrementalLayout();
+    }
+
+#ifdef KITEMLISTVIEWLAYOUTER_DEBUG
+    qCDebug(DolphinDebug) << "[TIME] startIncrementalLayout() for " << m_model->count() << "items:" << timer.elapsed();
+#endif
+}
+
+void KItemListViewLayouter::layoutUntil(int untilItemIndex, qreal untilOffset, int maxItems)
+{
+    if (!m_layoutInProgress) {
+        return;
+    }
+
+    const int itemCount = m_model->count();
+    const bool grouped = m_grouped;
+    const bool horizontalScrolling = m_scrollOrientation == Qt::Horizontal;
+
+    int processed = 0;
+    int index = m_layoutedItemCount;
 
-    int index = 0;
     while (index < itemCount) {
-        qreal maxItemHeight = itemSize.height();
+        if (untilItemIndex >= 0 && index > untilItemIndex) {
+            break;
+        }
+        if (untilOffset >= 0 && m_rowCount > 0 && m_buildRowOffsets.at(m_rowCount - 1) > untilOffset) {
+            // The row laid out last already starts behind the requested
+            // offset, which guarantees that the visible range can be
+            // resolved completely.
+            break;
+        }
+        if (maxItems >= 0 && processed >= maxItems) {
+            break;
+        }
+
+        qreal maxItemHeight = m_minimumRowHeight;
 
         if (grouped) {
             if (m_groupItemIndexes.contains(index)) {
@@ -467,23 +632,24 @@ void KItemListViewLayouter::doLayout()
                 if (index > 0) {
                     // Only add a margin if there has been added another
                     // group already before
-                    y += m_groupHeaderMargin;
+                    m_layoutY += m_groupHeaderMargin;
                 } else if (!horizontalScrolling) {
                     // The first group header should be aligned on top
-                    y -= itemMargin.height();
+                    m_layoutY -= m_layoutItemMarginHeight;
                 }
 
                 if (!horizontalScrolling) {
-                    y += m_groupHeaderHeight;
+                    m_layoutY += m_groupHeaderHeight;
                 }
             }
         }
 
-        m_rowOffsets[row] = y;
+        m_buildRowOffsets[m_rowCount] = m_layoutY;
+        m_firstItemIndexOfRow[m_rowCount] = index;
 
         int column = 0;
         while (index < itemCount && column < m_columnCount) {
-            qreal requiredItemHeight = itemSize.height();
+            qreal requiredItemHeight = m_minimumRowHeight;
             const QSizeF sizeHint = m_sizeHintResolver->sizeHint(index);
             const qreal sizeHintHeight = sizeHint.height();
             if (sizeHintHeight > requiredItemHeight) {
@@ -492,7 +658,7 @@ void KItemListViewLayouter::doLayout()
 
             ItemInfo &itemInfo = m_itemInfos[index];
             itemInfo.column = column;
-            itemInfo.row = row;
+            itemInfo.row = m_rowCount;
 
             if (grouped && horizontalScrolling) {
                 // When grouping is enabled in the horizontal mode, the header alignment
@@ -516,6 +682,7 @@ void KItemListViewLayouter::doLayout()
             maxItemHeight = qMax(maxItemHeight, requiredItemHeight);
             ++index;
             ++column;
+            ++processed;
 
             if (grouped && m_groupItemIndexes.contains(index)) {
                 // The item represents the first index of a group
@@ -524,22 +691,76 @@ void KItemListViewLayouter::doLayout()
             }
         }
 
-        y += maxItemHeight + itemMargin.height();
-        ++row;
+        m_rowHeights[m_rowCount] = maxItemHeight;
+        m_layoutY += maxItemHeight + m_layoutItemMarginHeight;
+        ++m_rowCount;
     }
 
-    if (itemCount > 0) {
-        m_maximumScrollOffset = y;
-        m_maximumItemOffset = m_columnCount * m_columnWidth;
+    m_layoutedItemCount = index;
+
+    if (m_layoutedItemCount >= itemCount) {
+        finishIncrementalLayout();
     } else {
+        updateMaximumScrollOffsetEstimate();
+    }
+}
+
+void KItemListViewLayouter::ensureItemLayouted(int index)
+{
+    if (m_layoutInProgress && index >= m_layoutedItemCount) {
+        layoutUntil(index, -1, -1);
+    }
+}
+
+void KItemListViewLayouter::finishIncrementalLayout()
+{
+    m_layoutInProgress = false;
+    m_layoutTimer->stop();
+
+    // Build the Fenwick tree over the advance of each row, i.e. the
+    // difference between the offsets of two consecutive rows.
+    m_firstRowOffset = (m_rowCount > 0) ? m_buildRowOffsets.at(0) : 0;
+    m_rowOffsetTree.fill(0, m_rowCount + 1);
+    for (int r = 1; r <= m_rowCount; ++r) {
+        const qreal nextOffset = (r < m_rowCount) ? m_buildRowOffsets.at(r) : m_layoutY;
+        m_rowOffsetTree[r] += nextOffset - m_buildRowOffsets.at(r - 1);
+        const int parent = r + (r & -r);
+        if (parent <= m_rowCount) {
+            m_rowOffsetTree[parent] += m_rowOffsetTree.at(r);
+        }
+    }
+
+    m_maximumScrollOffset = (m_model->count() > 0) ? m_layoutY : 0;
+}
+
+void KItemListViewLayouter::updateMaximumScrollOffsetEstimate()
+{
+    const int itemCount = m_model->count();
+    if (itemCount <= 0) {
         m_maximumScrollOffset = 0;
-        m_maximumItemOffset = 0;
+        return;
     }
 
-#ifdef KITEMLISTVIEWLAYOUTER_DEBUG
-    qCDebug(DolphinDebug) << "[TIME] doLayout() for " << m_model->count() << "items:" << timer.elapsed();
-#endif
-    m_dirty = false;
+    const int remainingItems = itemCount - m_layoutedItemCount;
+    const int remainingRows = (remainingItems + m_columnCount - 1) / m_columnCount;
+    const qreal averageAdvance =
+        (m_rowCount > 0) ? (m_layoutY - m_buildRowOffsets.at(0)) / m_rowCount : m_minimumRowHeight + m_layoutItemMarginHeight;
+    m_maximumScrollOffset = m_layoutY + remainingRows * averageAdvance;
+}
+
+void KItemListViewLayouter::continueLayout()
+{
+    if (!m_layoutInProgress || m_dirty) {
+        // A restarted layout will process the items anyway.
+        return;
+    }
+
+    layoutUntil(-1, -1, LayoutChunkSize);
+    if (m_layoutInProgress) {
+        m_layoutTimer->start();
+    }
+
+    Q_EMIT incrementalLayoutProgress();
 }
 
 void KItemListViewLayouter::updateVisibleIndexes()
@@ -559,33 +780,10 @@ void KItemListViewLayouter::updateVisibleIndexes()
 
     const int maxIndex = m_model->count() - 1;
 
-    // Calculate the first visible index that is fully visible
-    int min = 0;
-    int max = maxIndex;
-    int mid = 0;
-    do {
-        mid = (min + max) / 2;
-        if (m_rowOffsets.at(m_itemInfos[mid].row) < m_scrollOffset) {
-            min = mid + 1;
-        } else {
-            max = mid - 1;
-        }
-    } while (min <= max);
-
-    if (mid > 0) {
-        // Include the row before the first fully visible index, as it might
-        // be partly visible
-        if (m_rowOffsets.at(m_itemInfos[mid].row) >= m_scrollOffset) {
-            --mid;
-            Q_ASSERT(m_rowOffsets.at(m_itemInfos[mid].row) < m_scrollOffset);
-        }
-
-        const int firstVisibleRow = m_itemInfos[mid].row;
-        while (mid > 0 && m_itemInfos[mid - 1].row == firstVisibleRow) {
-            --mid;
-        }
-    }
-    m_firstVisibleIndex = mid;
+    // Determine the row before the first fully visible row, as it might be
+    // partly visible, and map it back to its first item.
+    const int firstVisibleRow = rowForOffset(m_scrollOffset, false);
+    m_firstVisibleIndex = m_firstItemIndexOfRow.at(firstVisibleRow);
 
     // Calculate the last visible index that is (at least partly) visible
     const int visibleHeight = (m_scrollOrientation == Qt::Horizontal) ? m_size.width() : m_size.height();
@@ -594,23 +792,83 @@ void KItemListViewLayouter::updateVisibleIndexes()
         bottom += m_groupHeaderHeight;
     }
 
-    min = m_firstVisibleIndex;
-    max = maxIndex;
-    do {
-        mid = (min + max) / 2;
-        if (m_rowOffsets.at(m_itemInfos[mid].row) <= bottom) {
-            min = mid + 1;
-        } else {
-            max = mid - 1;
+    const int lastVisibleRow = qMax(firstVisibleRow, rowForOffset(bottom, true));
+    m_lastVisibleIndex = (lastVisibleRow + 1 < m_rowCount) ? m_firstItemIndexOfRow.at(lastVisibleRow + 1) - 1 : maxIndex;
+
+    m_visibleIndexesDirty = false;
+}
+
+qreal KItemListViewLayouter::rowOffset(int row) const
+{
+    if (m_layoutInProgress) {
+        return m_buildRowOffsets.at(row);
+    }
+
+    qreal offset = m_firstRowOffset;
+    for (int r = row; r > 0; r -= r & -r) {
+        offset += m_rowOffsetTree.at(r);
+    }
+    return offset;
+}
+
+void KItemListViewLayouter::adjustRowAdvance(int row, qreal delta)
+{
+    for (int r = row + 1; r <= m_rowCount; r += r & -r) {
+        m_rowOffsetTree[r] += delta;
+    }
+}
+
+int KItemListViewLayouter::rowForOffset(qreal offset, bool includeEqualOffset) const
+{
+    if (m_layoutInProgress) {
+        // While the incremental layout is running the offsets are still
+        // available as a plain sorted vector.
+        const auto first = m_buildRowOffsets.constBegin();
+        const auto last = first + m_rowCount;
+        const auto it = includeEqualOffset ? std::upper_bound(first, last, offset) : std::lower_bound(first, last, offset);
+        return qBound(0, static_cast<int>(it - first) - 1, m_rowCount - 1);
+    }
+
+    // Binary descend through the Fenwick tree: accumulates the prefix sum
+    // while narrowing down the largest row whose offset qualifies.
+    int row = 0;
+    qreal remaining = offset - m_firstRowOffset;
+
+    int step = 1;
+    while ((step << 1) <= m_rowCount) {
+        step <<= 1;
+    }
+
+    for (; step > 0; step >>= 1) {
+        const int next = row + step;
+        if (next <= m_rowCount) {
+            const qreal sum = m_rowOffsetTree.at(next);
+            if (includeEqualOffset ? (sum <= remaining) : (sum < remaining)) {
+                row = next;
+                remaining -= sum;
+            }
         }
-    } while (min <= max);
+    }
+
+    return qBound(0, row, m_rowCount - 1);
+}
+
+qreal KItemListViewLayouter::calculateRowHeight(int row) const
+{
+    qreal height = m_minimumRowHeight;
 
-    while (mid > 0 && m_rowOffsets.at(m_itemInfos[mid].row) > bottom) {
-        --mid;
+    const int firstIndex = m_firstItemIndexOfRow.at(row);
+    const int endIndex = (row + 1 < m_rowCount) ? m_firstItemIndexOfRow.at(row + 1) : m_itemInfos.count();
+    for (int i = firstIndex; i < endIndex; ++i) {
+        height = qMax(height, m_sizeHintResolver->sizeHint(i).height());
     }
-    m_lastVisibleIndex = mid;
 
-    m_visibleIndexesDirty = false;
+    if (m_grouped && m_scrollOrientation == Qt::Horizontal) {
+        // See the group header alignment comment in doLayout().
+        height = qMax(height, minimumGroupHeaderWidth());
+    }
+
+    return height;
 }
 
 bool KItemListViewLayouter::createGroupHeaders()
@@ -626,6 +884,7 @@ bool KItemListViewLayouter::createGroupHeaders()
         return false;
     }
 
+    m_groupItemIndexes.reserve(groups.count());
     for (int i = 0; i < groups.count(); ++i) {
         const int firstItemIndex = groups.at(i).first;
         m_groupItemIndexes.insert(firstItemIndex);
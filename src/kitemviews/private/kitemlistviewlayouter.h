@@ -15,8 +15,11 @@
 #include <QSizeF>
 #include <QVector>
 
+#include <utility>
+
 class KItemModelBase;
 class KItemListSizeHintResolver;
+class QTimer;
 
 /**
  * @brief Internal helper class for KItemListView to layout the items.
@@ -31,6 +34,14 @@ class KItemListSizeHintResolver;
  * marking the layouter as dirty (see markAsDirty()). This means that
  * changing properties of the layouter is not expensive, only the
  * first read of a property can get expensive.
+ *
+ * Even then only the rows up to the bottom of the viewport are laid out
+ * synchronously: The remaining items are processed in idle time slices
+ * while the maximum scroll offset is estimated from the average row
+ * height and refined with each slice (see incrementalLayoutProgress()).
+ * This keeps e.g. a zoom level change instant regardless of the number
+ * of items. Reading a property of an item behind the laid out region
+ * extends the layout up to that item on demand.
  */
 class DOLPHIN_EXPORT KItemListViewLayouter : public QObject
 {
@@ -110,6 +121,17 @@ public:
      */
     QRectF itemRect(int index) const;
 
+    /**
+     * @return Range of the first and last item index whose rows intersect
+     *         the rectangle \a rect, which is given in the same coordinates
+     *         as itemRect() returns. The range is conservative: all items
+     *         that intersect the rectangle are inside it, but items of a
+     *         partially covered row might not intersect themselves. The
+     *         lookup costs O(log rowCount). (-1, -1) is returned if no
+     *         item exists.
+     */
+    std::pair<int, int> itemRangeForRect(const QRectF &rect) const;
+
     /**
      * @return Rectangle of the group header for the item with the
      *         index \a index. Note that the layouter does not check
@@ -149,6 +171,17 @@ public:
      */
     void markAsDirty();
 
+    /**
+     * Updates the layout after the size hints of \a count items starting
+     * at \a index have changed. In contrast to markAsDirty() no full
+     * relayout is done: Only the heights of the affected rows are
+     * recalculated and the offsets of the following rows are adjusted in
+     * O(log n), which keeps size-hint updates cheap even for huge
+     * directories. If the layout is dirty for other reasons, the pending
+     * full relayout covers the change anyway.
+     */
+    void updateSizeHints(int index, int count);
+
     inline int columnCount() const
     {
         return m_columnCount;
@@ -169,11 +202,87 @@ public:
     bool isDirty();
 #endif
 
+Q_SIGNALS:
+    /**
+     * Is emitted after an idle time slice of an incremental layout has been
+     * processed and the estimated maximum scroll offset has been refined.
+     * The view uses this to keep the scrollbar range up to date.
+     */
+    void incrementalLayoutProgress();
+
 private:
     void doLayout();
     void updateVisibleIndexes();
     bool createGroupHeaders();
 
+    /**
+     * Prepares an incremental layout run: Calculates the column layout and
+     * the group headers and resets the row bookkeeping. The rows themselves
+     * are laid out afterwards by layoutUntil().
+     */
+    void startIncrementalLayout();
+
+    /**
+     * Lays out further rows of the pending incremental layout. The run
+     * stops as soon as the item \a untilItemIndex has been laid out, the
+     * last laid out row starts behind \a untilOffset, at most \a maxItems
+     * items have been processed, or no items are left. A negative value
+     * disables the respective bound. Finishes the layout if all items have
+     * been processed, otherwise the maximum scroll offset is re-estimated.
+     */
+    void layoutUntil(int untilItemIndex, qreal untilOffset, int maxItems);
+
+    /**
+     * Extends the pending incremental layout so that the item with the
+     * index \a index is laid out. Does nothing if no layout is pending.
+     */
+    void ensureItemLayouted(int index);
+
+    /**
+     * Builds the Fenwick tree from the laid out rows and replaces the
+     * estimated maximum scroll offset by the exact one.
+     */
+    void finishIncrementalLayout();
+
+    /**
+     * Estimates the maximum scroll offset from the average advance of the
+     * rows which have been laid out so far.
+     */
+    void updateMaximumScrollOffsetEstimate();
+
+    /**
+     * Processes the next idle time slice of the pending incremental layout.
+     * Is invoked by m_layoutTimer.
+     */
+    void continueLayout();
+
+    /**
+     * @return The y-coordinate where the row \a row starts. Is resolved in
+     *         O(log n) from the Fenwick tree m_rowOffsetTree which stores
+     *         the advance (height + margins + group header space) of each
+     *         row.
+     */
+    qreal rowOffset(int row) const;
+
+    /**
+     * Adds \a delta to the advance of the row \a row, which shifts the
+     * offsets of all following rows accordingly. O(log n).
+     */
+    void adjustRowAdvance(int row, qreal delta);
+
+    /**
+     * @return The largest row whose offset is smaller than \a offset
+     *         (or smaller than/equal to \a offset if \a includeEqualOffset
+     *         is true). Returns 0 if no row qualifies. O(log n).
+     */
+    int rowForOffset(qreal offset, bool includeEqualOffset) const;
+
+    /**
+     * @return The height of the row \a row, determined from the size hints
+     *         of the items within the row.
+     */
+    qreal calculateRowHeight(int row) const;
+
     /**
      * @return Minimum width of group headers when grouping is enabled in the horizontal
      *         alignment mode. The header alignment is done like this:
@@ -210,7 +319,30 @@ private:
     qreal m_xPosInc;
     int m_columnCount;
 
-    QVector<qreal> m_rowOffsets;
+    // The row geometry is stored as a Fenwick (binary indexed) tree over the
+    // advance of each row, so that both the prefix sums (row offsets) and
+    // point updates (a changed row height) are resolved in O(log n).
+    // m_rowHeights additionally keeps the plain height of each row to be
+    // able to update an advance by its delta, and m_firstItemIndexOfRow
+    // maps a row back to its first item.
+    int m_rowCount;
+    qreal m_firstRowOffset;
+    QVector<qreal> m_rowOffsetTree;
+    QVector<qreal> m_rowHeights;
+    QVector<int> m_firstItemIndexOfRow;
+    qreal m_minimumRowHeight;
+    bool m_grouped;
+
+    // State of a pending incremental layout: While it is in progress the
+    // row offsets are kept in the plain vector m_buildRowOffsets, the
+    // Fenwick tree is built once all items have been laid out.
+    bool m_layoutInProgress;
+    int m_layoutedItemCount;
+    qreal m_layoutY;
+    qreal m_layoutItemMarginHeight;
+    QVector<qreal> m_buildRowOffsets;
+    QTimer *m_layoutTimer;
+
     QVector<qreal> m_columnOffsets;
 
     // Stores all item indexes that are the first item of a group.
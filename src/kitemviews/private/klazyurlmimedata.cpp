@@ -0,0 +1,68 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "klazyurlmimedata.h"
+
+#include <KUrlMimeData>
+
+namespace
+{
+// The formats KUrlMimeData::setUrls() fills in. The KDE format carries the
+// original URLs, "text/uri-list" carries the most local ones.
+const QString UriListFormat = QStringLiteral("text/uri-list");
+const QString KdeUriListFormat = QStringLiteral("application/x-kde4-urilist");
+}
+
+KLazyUrlMimeData::KLazyUrlMimeData(const QList<QUrl> &urls, const QList<QUrl> &mostLocalUrls)
+    : QMimeData()
+    , m_urls(urls)
+    , m_mostLocalUrls(mostLocalUrls)
+    , m_materialized(false)
+{
+}
+
+QStringList KLazyUrlMimeData::formats() const
+{
+    QStringList formats = QMimeData::formats();
+    if (!m_materialized) {
+        // The payloads are not encoded yet so the base class does not know
+        // about the url-list formats. Advertise them manually.
+        for (const QString &urlFormat : {UriListFormat, KdeUriListFormat}) {
+            if (!formats.contains(urlFormat)) {
+                formats.append(urlFormat);
+            }
+        }
+    }
+    return formats;
+}
+
+bool KLazyUrlMimeData::hasFormat(const QString &mimeType) const
+{
+    if (!m_materialized && (mimeType == UriListFormat || mimeType == KdeUriListFormat)) {
+        return true;
+    }
+    return QMimeData::hasFormat(mimeType);
+}
+
+QVariant KLazyUrlMimeData::retrieveData(const QString &mimeType, QMetaType preferredType) const
+{
+    // A target wants actual data, e.g. because the drag was dropped or the
+    // selection gets pasted. Only now the encoding cost is paid.
+    materialize();
+    return QMimeData::retrieveData(mimeType, preferredType);
+}
+
+void KLazyUrlMimeData::materialize() const
+{
+    if (m_materialized) {
+        return;
+    }
+    m_materialized = true;
+
+    KUrlMimeData::setUrls(m_urls, m_mostLocalUrls, const_cast<KLazyUrlMimeData *>(this));
+    m_urls.clear();
+    m_mostLocalUrls.clear();
+}
@@ -0,0 +1,54 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KLAZYURLMIMEDATA_H
+#define KLAZYURLMIMEDATA_H
+
+#include "dolphin_export.h"
+
+#include <QMimeData>
+#include <QUrl>
+
+/**
+ * @brief Mime data for a list of URLs that defers the payload encoding.
+ *
+ * KUrlMimeData::setUrls() serializes all URLs into the "text/uri-list" and
+ * "application/x-kde4-urilist" payloads up front. For a drag of hundreds of
+ * thousands of items this serialization takes seconds and would stall the
+ * application before the drag cursor even appears. This subclass only keeps
+ * the plain URL lists and encodes the payloads when a target actually
+ * retrieves data for the first time. Until then the url-list formats are
+ * advertised manually so that targets can accept the drag as usual.
+ *
+ * The encoded result is byte-for-byte identical to calling
+ * KUrlMimeData::setUrls() eagerly.
+ */
+class DOLPHIN_EXPORT KLazyUrlMimeData : public QMimeData
+{
+    Q_OBJECT
+
+public:
+    KLazyUrlMimeData(const QList<QUrl> &urls, const QList<QUrl> &mostLocalUrls);
+
+    QStringList formats() const override;
+    bool hasFormat(const QString &mimeType) const override;
+
+protected:
+    QVariant retrieveData(const QString &mimeType, QMetaType preferredType) const override;
+
+private:
+    /**
+     * Runs the deferred KUrlMimeData::setUrls() call. Logically const as the
+     * externally visible formats and payloads do not change.
+     */
+    void materialize() const;
+
+    mutable QList<QUrl> m_urls;
+    mutable QList<QUrl> m_mostLocalUrls;
+    mutable bool m_materialized;
+};
+
+#endif
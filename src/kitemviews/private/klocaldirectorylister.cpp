@@ -0,0 +1,313 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "klocaldirectorylister.h"
+
+#include <KIO/UDSEntry>
+
+#include <QFile>
+#include <QHash>
+
+#ifdef Q_OS_LINUX
+#include <dirent.h>
+#include <fcntl.h>
+#include <grp.h>
+#include <limits.h>
+#include <pwd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <vector>
+#endif
+
+namespace
+{
+// Number of items that are collected before they are pushed to the model.
+// Unlike a search, a listing is not about individual early results, so the
+// batches are sized to keep the signal and insertion overhead low while items
+// still stream in during a listing that takes longer than an eyeblink.
+constexpr int ListingBatchSize = 4096;
+
+// Size of the buffer getdents64() fills per call. One syscall returns
+// thousands of directory records at this size.
+constexpr size_t DirentBufferSize = 1024 * 1024;
+}
+
+struct KLocalDirectoryLister::ListingState {
+    /** The native path of the listed directory. */
+    QString path;
+    bool listHiddenFiles = false;
+    bool directoriesOnly = false;
+    QAtomicInt stopped;
+};
+
+#ifdef Q_OS_LINUX
+namespace
+{
+/** The record format getdents64() writes, see man getdents64(2). */
+struct LinuxDirent64 {
+    ino64_t d_ino;
+    off64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+/** @returns the name of the user @p uid, resolved once per listing through @p cache. */
+QString userNameForId(uid_t uid, QHash<uint, QString> &cache)
+{
+    const auto it = cache.constFind(uid);
+    if (it != cache.constEnd()) {
+        return *it;
+    }
+    struct passwd pwd;
+    struct passwd *result = nullptr;
+    char buffer[4096];
+    QString name;
+    if (::getpwuid_r(uid, &pwd, buffer, sizeof(buffer), &result) == 0 && result) {
+        name = QFile::decodeName(result->pw_name);
+    } else {
+        name = QString::number(uid);
+    }
+    cache.insert(uid, name);
+    return name;
+}
+
+/** @returns the name of the group @p gid, resolved once per listing through @p cache. */
+QString groupNameForId(gid_t gid, QHash<uint, QString> &cache)
+{
+    const auto it = cache.constFind(gid);
+    if (it != cache.constEnd()) {
+        return *it;
+    }
+    struct group grp;
+    struct group *result = nullptr;
+    char buffer[4096];
+    QString name;
+    if (::getgrgid_r(gid, &grp, buffer, sizeof(buffer), &result) == 0 && result) {
+        name = QFile::decodeName(result->gr_name);
+    } else {
+        name = QString::number(gid);
+    }
+    cache.insert(gid, name);
+    return name;
+}
+}
+#endif
+
+KLocalDirectoryLister::KLocalDirectoryLister(const QUrl &url, QObject *parent)
+    : QObject(parent)
+    , m_url(url)
+{
+    Q_ASSERT(canList(url));
+    m_path = url.toLocalFile();
+    m_pool.setMaxThreadCount(1);
+}
+
+KLocalDirectoryLister::~KLocalDirectoryLister()
+{
+    stop();
+    m_pool.waitForDone();
+}
+
+bool KLocalDirectoryLister::canList(const QUrl &url)
+{
+#ifdef Q_OS_LINUX
+    return url.isLocalFile();
+#else
+    // The listing relies on getdents64() and statx(); other platforms stay
+    // with the KIO listing.
+    Q_UNUSED(url)
+    return false;
+#endif
+}
+
+QUrl KLocalDirectoryLister::url() const
+{
+    return m_url;
+}
+
+void KLocalDirectoryLister::setListHiddenFiles(bool list)
+{
+    Q_ASSERT_X(!m_state, "KLocalDirectoryLister::setListHiddenFiles()", "May only be called before the listing is started.");
+    m_listHiddenFiles = list;
+}
+
+void KLocalDirectoryLister::setDirectoriesOnly(bool directoriesOnly)
+{
+    Q_ASSERT_X(!m_state, "KLocalDirectoryLister::setDirectoriesOnly()", "May only be called before the listing is started.");
+    m_directoriesOnly = directoriesOnly;
+}
+
+bool KLocalDirectoryLister::isRunning() const
+{
+    return m_running;
+}
+
+void KLocalDirectoryLister::start()
+{
+    Q_ASSERT_X(!m_state, "KLocalDirectoryLister::start()", "A lister instance may only be started once.");
+
+    m_state = std::make_shared<ListingState>();
+    m_state->path = m_path;
+    m_state->listHiddenFiles = m_listHiddenFiles;
+    m_state->directoriesOnly = m_directoriesOnly;
+    m_running = true;
+
+    const std::shared_ptr<ListingState> state = m_state;
+    m_pool.start([this, state]() {
+        list(state);
+    });
+}
+
+void KLocalDirectoryLister::stop()
+{
+    m_running = false;
+    if (m_state) {
+        m_state->stopped.storeRelaxed(1);
+    }
+}
+
+void KLocalDirectoryLister::list(const std::shared_ptr<ListingState> &state)
+{
+    bool ok = false;
+    KFileItemList batch;
+
+#ifdef Q_OS_LINUX
+    const int dirFd = ::open(QFile::encodeName(state->path).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        ok = true;
+        QHash<uint, QString> userNames;
+        QHash<uint, QString> groupNames;
+        std::vector<char> direntBuffer(DirentBufferSize);
+
+        while (!state->stopped.loadRelaxed()) {
+            const long bytesRead = ::syscall(SYS_getdents64, dirFd, direntBuffer.data(), direntBuffer.size());
+            if (bytesRead < 0) {
+                ok = false;
+                break;
+            }
+            if (bytesRead == 0) {
+                // The whole directory has been read.
+                break;
+            }
+
+            for (long offset = 0; offset < bytesRead && !state->stopped.loadRelaxed();) {
+                const auto *dirent = reinterpret_cast<const LinuxDirent64 *>(direntBuffer.data() + offset);
+                offset += dirent->d_reclen;
+
+                const char *name = dirent->d_name;
+                if (name[0] == '.') {
+                    if (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')) {
+                        continue;
+                    }
+                    if (!state->listHiddenFiles) {
+                        continue;
+                    }
+                }
+                if (state->directoriesOnly && dirent->d_type != DT_DIR && dirent->d_type != DT_LNK && dirent->d_type != DT_UNKNOWN) {
+                    // The record type rules the entry out without a statx() call.
+                    continue;
+                }
+
+                struct statx stx;
+                if (::statx(dirFd, name, AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, STATX_BASIC_STATS | STATX_BTIME, &stx) != 0) {
+                    // The entry vanished between getdents64() and here.
+                    continue;
+                }
+
+                QString linkDest;
+                // For symbolic links the file type and size of the target are
+                // reported, like the KIO file worker does, so that a link to a
+                // directory behaves like a directory. The broken-link case
+                // keeps the values of the link itself.
+                quint64 fileType = stx.stx_mode & S_IFMT;
+                quint64 size = stx.stx_size;
+                if (S_ISLNK(stx.stx_mode)) {
+                    char linkBuffer[PATH_MAX];
+                    const ssize_t linkLength = ::readlinkat(dirFd, name, linkBuffer, sizeof(linkBuffer) - 1);
+                    if (linkLength > 0) {
+                        linkDest = QFile::decodeName(QByteArray(linkBuffer, linkLength));
+                    }
+                    struct statx targetStx;
+                    if (::statx(dirFd, name, AT_NO_AUTOMOUNT, STATX_BASIC_STATS, &targetStx) == 0) {
+                        fileType = targetStx.stx_mode & S_IFMT;
+                        size = targetStx.stx_size;
+                    }
+                }
+
+                if (state->directoriesOnly && !S_ISDIR(fileType)) {
+                    continue;
+                }
+
+                KIO::UDSEntry entry;
+                entry.reserve(10);
+                entry.fastInsert(KIO::UDSEntry::UDS_NAME, QFile::decodeName(name));
+                entry.fastInsert(KIO::UDSEntry::UDS_FILE_TYPE, fileType);
+                entry.fastInsert(KIO::UDSEntry::UDS_ACCESS, stx.stx_mode & 07777);
+                entry.fastInsert(KIO::UDSEntry::UDS_SIZE, size);
+                entry.fastInsert(KIO::UDSEntry::UDS_MODIFICATION_TIME, stx.stx_mtime.tv_sec);
+                entry.fastInsert(KIO::UDSEntry::UDS_ACCESS_TIME, stx.stx_atime.tv_sec);
+                if (stx.stx_mask & STATX_BTIME) {
+                    entry.fastInsert(KIO::UDSEntry::UDS_CREATION_TIME, stx.stx_btime.tv_sec);
+                }
+                entry.fastInsert(KIO::UDSEntry::UDS_USER, userNameForId(stx.stx_uid, userNames));
+                entry.fastInsert(KIO::UDSEntry::UDS_GROUP, groupNameForId(stx.stx_gid, groupNames));
+                if (!linkDest.isEmpty()) {
+                    entry.fastInsert(KIO::UDSEntry::UDS_LINK_DEST, linkDest);
+                }
+
+                batch.append(KFileItem(entry, m_url, true /* delayedMimeTypes */, true /* urlIsDirectory */));
+                if (batch.count() >= ListingBatchSize) {
+                    reportBatch(batch);
+                    batch.clear();
+                }
+            }
+        }
+        ::close(dirFd);
+    }
+#endif
+
+    if (state->stopped.loadRelaxed()) {
+        return;
+    }
+
+    // The remainder is flushed before the completion below so all batches are
+    // queued first.
+    if (ok && !batch.isEmpty()) {
+        reportBatch(batch);
+    }
+
+    QMetaObject::invokeMethod(
+        this,
+        [this, ok]() {
+            if (!m_running) {
+                return;
+            }
+            m_running = false;
+            if (ok) {
+                Q_EMIT finished();
+            } else {
+                Q_EMIT listingFailed();
+            }
+        },
+        Qt::QueuedConnection);
+}
+
+void KLocalDirectoryLister::reportBatch(const KFileItemList &items)
+{
+    QMetaObject::invokeMethod(
+        this,
+        [this, items]() {
+            if (m_running) {
+                Q_EMIT itemsListed(m_url, items);
+            }
+        },
+        Qt::QueuedConnection);
+}
+
+#include "moc_klocaldirectorylister.cpp"
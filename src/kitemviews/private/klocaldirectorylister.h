@@ -0,0 +1,123 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KLOCALDIRECTORYLISTER_H
+#define KLOCALDIRECTORYLISTER_H
+
+#include "dolphin_export.h"
+
+#include <KFileItem>
+
+#include <QObject>
+#include <QThreadPool>
+#include <QUrl>
+
+#include <memory>
+
+/**
+ * @brief A fast flat listing of one local directory, bypassing KIO.
+ *
+ * A cold KIO listing of a huge local directory spends most of its time on
+ * per-item overhead: the file worker stats every entry, serializes a UDSEntry
+ * and the lister deserializes it again. This lister reads the same directory
+ * on a worker thread with batched getdents64() and statx() calls instead and
+ * converts the raw records to KFileItems in bulk, so the model receives
+ * fully stat'ed items without any round-trips.
+ *
+ * The lister only produces the initial listing; it does not watch the
+ * directory. KFileItemModel hands the directory over to its KDirLister once
+ * the listing is complete, which restores the change notifications and the
+ * lister cache, see KFileItemModel::loadDirectory().
+ *
+ * Items are delivered in batches through itemsListed() while the listing is
+ * still running. Non-local URLs and platforms without the required syscalls
+ * are rejected by canList() and stay with KIO.
+ */
+class DOLPHIN_EXPORT KLocalDirectoryLister : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param url The directory to list. It must satisfy canList().
+     */
+    explicit KLocalDirectoryLister(const QUrl &url, QObject *parent = nullptr);
+
+    /** Stops the listing and waits until the worker thread has exited. */
+    ~KLocalDirectoryLister() override;
+
+    /** @returns whether this lister can list the given @p url. */
+    static bool canList(const QUrl &url);
+
+    /** @returns the URL of the directory this lister was created for. */
+    QUrl url() const;
+
+    /**
+     * Controls whether hidden entries are part of the listing, matching
+     * KCoreDirLister::showHiddenFiles(). May only be called before start().
+     */
+    void setListHiddenFiles(bool list);
+
+    /**
+     * Makes the listing deliver directories only, matching
+     * KCoreDirLister::dirOnlyMode(). May only be called before start().
+     */
+    void setDirectoriesOnly(bool directoriesOnly);
+
+    /** @returns whether the listing has been started and is not yet finished or stopped. */
+    bool isRunning() const;
+
+    /** Starts the listing. May only be called once per lister instance. */
+    void start();
+
+    /**
+     * Stops the listing. The worker thread exits as soon as it notices the
+     * request and no further signals are emitted.
+     */
+    void stop();
+
+Q_SIGNALS:
+    /**
+     * Is emitted in the lister's thread whenever a batch of items has been
+     * read. @p directoryUrl is the listed directory the items belong to.
+     */
+    void itemsListed(const QUrl &directoryUrl, const KFileItemList &items);
+
+    /** Is emitted after the last batch once the whole directory has been read. */
+    void finished();
+
+    /**
+     * Is emitted instead of finished() when the directory could not be opened
+     * or read. The caller is expected to fall back to a KIO listing, which
+     * reports the error through its usual channels.
+     */
+    void listingFailed();
+
+private:
+    /** The flags and stop request shared with the worker thread. */
+    struct ListingState;
+
+    /** Reads the whole directory. Runs on the worker thread. @see ListingState. */
+    void list(const std::shared_ptr<ListingState> &state);
+
+    /** Posts @p items to the lister's thread to be emitted through itemsListed(). */
+    void reportBatch(const KFileItemList &items);
+
+private:
+    /** The listed directory as it was passed in. */
+    QUrl m_url;
+    /** The native path of the listed directory. */
+    QString m_path;
+    bool m_listHiddenFiles = false;
+    bool m_directoriesOnly = false;
+
+    /** A dedicated pool so the destructor can wait for this listing's worker only. */
+    QThreadPool m_pool;
+    std::shared_ptr<ListingState> m_state;
+    bool m_running = false;
+};
+
+#endif // KLOCALDIRECTORYLISTER_H
@@ -0,0 +1,83 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kmemoryaccounting.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+struct KMemoryAccountingSingleton {
+    KMemoryAccounting instance;
+};
+Q_GLOBAL_STATIC(KMemoryAccountingSingleton, s_memoryAccounting)
+
+KMemoryAccounting *KMemoryAccounting::instance()
+{
+    return &s_memoryAccounting->instance;
+}
+
+KMemoryAccounting::KMemoryAccounting()
+    : m_mutex(),
+      m_reporters()
+{
+}
+
+void KMemoryAccounting::registerReporter(const void *owner, const QByteArray &subsystem, std::function<qint64()> byteEstimator)
+{
+    QMutexLocker locker(&m_mutex);
+    m_reporters.insert(owner, Reporter{subsystem, std::move(byteEstimator)});
+}
+
+void KMemoryAccounting::unregisterReporter(const void *owner)
+{
+    QMutexLocker locker(&m_mutex);
+    m_reporters.remove(owner);
+}
+
+qint64 KMemoryAccounting::totalBytes() const
+{
+    qint64 total = 0;
+
+    QMutexLocker locker(&m_mutex);
+    for (const Reporter &reporter : std::as_const(m_reporters)) {
+        total += reporter.byteEstimator();
+    }
+    return total;
+}
+
+QString KMemoryAccounting::report() const
+{
+    struct SubsystemTotal {
+        int instances = 0;
+        qint64 estimatedBytes = 0;
+    };
+    QHash<QByteArray, SubsystemTotal> totals;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        for (const Reporter &reporter : std::as_const(m_reporters)) {
+            SubsystemTotal &total = totals[reporter.subsystem];
+            ++total.instances;
+            total.estimatedBytes += reporter.byteEstimator();
+        }
+    }
+
+    QJsonObject subsystems;
+    qint64 totalBytes = 0;
+    for (auto it = totals.constBegin(); it != totals.constEnd(); ++it) {
+        QJsonObject subsystem;
+        subsystem.insert(QStringLiteral("instances"), it.value().instances);
+        subsystem.insert(QStringLiteral("estimatedBytes"), it.value().estimatedBytes);
+        subsystems.insert(QString::fromLatin1(it.key()), subsystem);
+        totalBytes += it.value().estimatedBytes;
+    }
+
+    QJsonObject root;
+    root.insert(QStringLiteral("subsystems"), subsystems);
+    root.insert(QStringLiteral("totalEstimatedBytes"), totalBytes);
+
+    return QString::fromUtf8(QJsonDocument(root).toJson(QJsonDocument::Compact));
+}
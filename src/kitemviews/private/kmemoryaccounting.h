@@ -0,0 +1,81 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KMEMORYACCOUNTING_H
+#define KMEMORYACCOUNTING_H
+
+#include "dolphin_export.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#include <functional>
+
+/**
+ * @brief Process-wide registry which attributes memory to its major owners.
+ *
+ * A long session can grow to gigabytes of resident memory, and a plain heap
+ * profile does not tell whether the bytes sit in the ItemData columns of a
+ * huge directory, in preview pixmaps, in the recycled widget pool or in the
+ * models of background tabs. Each major owner therefore registers a byte
+ * estimator here, and GetMemoryAccounting() on the D-Bus interface dumps all
+ * estimates grouped by subsystem.
+ *
+ * The estimates are just that: they count the dominant buffers of each
+ * owner, not every allocation. They exist to direct eviction work and leak
+ * triage to the right subsystem, not to match the heap byte for byte.
+ */
+class DOLPHIN_EXPORT KMemoryAccounting
+{
+public:
+    static KMemoryAccounting *instance();
+
+    /**
+     * Registers \a byteEstimator for \a owner under the group \a subsystem,
+     * e.g. "KFileItemModel". The estimator is invoked on the thread that
+     * requests a report, which is the GUI thread for D-Bus requests, so it
+     * may access the owner without locking as long as the owner lives on the
+     * GUI thread. Registering the same owner again replaces its estimator.
+     */
+    void registerReporter(const void *owner, const QByteArray &subsystem, std::function<qint64()> byteEstimator);
+
+    /**
+     * Removes the estimator of \a owner. Must be called before the owner is
+     * destroyed.
+     */
+    void unregisterReporter(const void *owner);
+
+    /**
+     * @return The current estimates as a JSON document: per subsystem the
+     *         number of registered instances and their summed byte estimate,
+     *         plus the total over all subsystems.
+     */
+    QString report() const;
+
+    /**
+     * @return The summed byte estimate over all registered owners, without
+     *         the JSON formatting of report(). Used by DolphinCacheGovernor
+     *         to compare the session against its memory budget.
+     */
+    qint64 totalBytes() const;
+
+private:
+    KMemoryAccounting();
+
+    struct Reporter {
+        QByteArray subsystem;
+        std::function<qint64()> byteEstimator;
+    };
+
+    mutable QMutex m_mutex;
+    QHash<const void *, Reporter> m_reporters;
+
+    friend struct KMemoryAccountingSingleton;
+};
+
+#endif
@@ -0,0 +1,222 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kmimetypecache.h"
+
+#include <kio/udsentry.h>
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTimer>
+
+#include <algorithm>
+
+namespace
+{
+// Format of the on-disk table holding the sniffed mime types.
+const quint32 CacheMagic = 0x646c6d74; // 'dlmt'
+const quint32 CacheVersion = 1;
+
+// Maximum number of entries written to the on-disk table. If the table grew
+// beyond this limit, the entries which have not been used for the longest
+// time are dropped.
+const int MaxPersistentEntries = 200000;
+
+// Delay in ms before updated entries are written back to disk, so that
+// sniffing a whole directory causes only one write.
+const int SaveDelayMs = 5000;
+}
+
+struct KMimeTypeCacheSingleton {
+    KMimeTypeCache instance;
+};
+Q_GLOBAL_STATIC(KMimeTypeCacheSingleton, s_mimeTypeCache)
+
+KMimeTypeCache *KMimeTypeCache::instance()
+{
+    return &s_mimeTypeCache->instance;
+}
+
+KMimeTypeCache::KMimeTypeCache()
+    : m_mutex()
+    , m_entries()
+    , m_saveScheduled(false)
+{
+    load();
+}
+
+KMimeTypeCache::~KMimeTypeCache()
+{
+    if (m_saveScheduled) {
+        // The process is shutting down before the coalesced save fired.
+        save();
+    }
+}
+
+QString KMimeTypeCache::mimeType(const KFileItem &item)
+{
+    const QByteArray key = keyFor(item);
+    if (key.isEmpty()) {
+        return QString();
+    }
+
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        return QString();
+    }
+
+    // Refreshing the usage time is not worth a disk write on its own, it is
+    // picked up by the next scheduled save.
+    it->lastUsed = QDateTime::currentSecsSinceEpoch();
+    return it->mimeType;
+}
+
+void KMimeTypeCache::insert(const KFileItem &item)
+{
+    if (!item.isMimeTypeKnown() || item.isDir()) {
+        return;
+    }
+
+    const QByteArray key = keyFor(item);
+    if (key.isEmpty()) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_entries.constFind(key);
+    if (it != m_entries.constEnd() && it->mimeType == item.mimetype()) {
+        return;
+    }
+
+    m_entries.insert(key, Entry{item.mimetype(), QDateTime::currentSecsSinceEpoch()});
+    scheduleSave();
+}
+
+QByteArray KMimeTypeCache::keyFor(const KFileItem &item)
+{
+    if (item.isNull() || !item.isLocalFile()) {
+        return QByteArray();
+    }
+
+    const KIO::UDSEntry &entry = item.entry();
+    const long long device = entry.numberValue(KIO::UDSEntry::UDS_DEVICE_ID, 0);
+    const long long inode = entry.numberValue(KIO::UDSEntry::UDS_INODE, 0);
+    if (device == 0 && inode == 0) {
+        // Without a device and inode the file cannot be identified across
+        // renames, do not cache it at all.
+        return QByteArray();
+    }
+
+    const long long modificationTime = entry.numberValue(KIO::UDSEntry::UDS_MODIFICATION_TIME, 0);
+    return QByteArray::number(device) + ':' + QByteArray::number(inode) + ':' + QByteArray::number(modificationTime);
+}
+
+QString KMimeTypeCache::cacheFilePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/mime-types.cache");
+}
+
+void KMimeTypeCache::load()
+{
+    QFile file(cacheFilePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    // Map the table instead of reading it, so that startup does not pay for
+    // copying a table which is mostly made up of entries of other directories.
+    uchar *mapped = file.map(0, file.size());
+    if (!mapped) {
+        return;
+    }
+
+    const QByteArray raw = QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), file.size());
+    QDataStream in(raw);
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != CacheMagic || version != CacheVersion) {
+        file.unmap(mapped);
+        return;
+    }
+
+    while (!in.atEnd()) {
+        QByteArray key;
+        Entry entry;
+        in >> key >> entry.mimeType >> entry.lastUsed;
+        if (in.status() != QDataStream::Ok) {
+            m_entries.clear();
+            break;
+        }
+        m_entries.insert(key, entry);
+    }
+
+    file.unmap(mapped);
+}
+
+void KMimeTypeCache::save()
+{
+    QMutexLocker locker(&m_mutex);
+    m_saveScheduled = false;
+
+    if (m_entries.count() > MaxPersistentEntries) {
+        // Drop the entries which have not been used for the longest time.
+        QList<qint64> usageTimes;
+        usageTimes.reserve(m_entries.count());
+        for (const auto &entry : std::as_const(m_entries)) {
+            usageTimes.append(entry.lastUsed);
+        }
+        std::nth_element(usageTimes.begin(), usageTimes.end() - MaxPersistentEntries, usageTimes.end());
+        const qint64 cutOff = *(usageTimes.end() - MaxPersistentEntries);
+
+        auto it = m_entries.begin();
+        while (it != m_entries.end() && m_entries.count() > MaxPersistentEntries) {
+            if (it->lastUsed < cutOff) {
+                it = m_entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    const QString filePath = cacheFilePath();
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QDataStream out(&file);
+    out << CacheMagic << CacheVersion;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        out << it.key() << it->mimeType << it->lastUsed;
+    }
+    file.commit();
+}
+
+void KMimeTypeCache::scheduleSave()
+{
+    if (m_saveScheduled) {
+        return;
+    }
+    m_saveScheduled = true;
+    // The insert may come from the thread pool used by
+    // KFileItemModel::determineMimeTypes(), so anchor the timer in the main
+    // thread where an event loop is running.
+    QTimer::singleShot(SaveDelayMs, QCoreApplication::instance(), []() {
+        if (s_mimeTypeCache.exists()) {
+            s_mimeTypeCache->instance.save();
+        }
+    });
+}
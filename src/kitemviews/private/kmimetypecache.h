@@ -0,0 +1,80 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KMIMETYPECACHE_H
+#define KMIMETYPECACHE_H
+
+#include "dolphin_export.h"
+
+#include <KFileItem>
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+/**
+ * @brief Persistent cache of sniffed mime types, shared between sessions.
+ *
+ * Determining the mime type of a file whose extension is ambiguous requires
+ * reading its content, which makes the "type" column and sorting by type
+ * expensive every time a directory is visited. The files themselves rarely
+ * change, so the result of a sniff is remembered keyed by the device, inode
+ * and modification time of the file. The cache is loaded from a memory-mapped
+ * file in the cache location at startup and must be consulted before content
+ * sniffing; a changed file gets a new modification time and thereby misses
+ * the cache automatically.
+ *
+ * The class is thread-safe, mime types may be inserted from the thread pool
+ * used by KFileItemModel::determineMimeTypes().
+ */
+class DOLPHIN_EXPORT KMimeTypeCache
+{
+public:
+    static KMimeTypeCache *instance();
+
+    /**
+     * @return The cached mime type name of \a item, or an empty string if
+     *         the file is unknown or has been modified since the mime type
+     *         was cached.
+     */
+    QString mimeType(const KFileItem &item);
+
+    /**
+     * Remembers the already determined mime type of \a item. Items which are
+     * not local files, or whose mime type has not been determined yet, are
+     * ignored.
+     */
+    void insert(const KFileItem &item);
+
+private:
+    KMimeTypeCache();
+    ~KMimeTypeCache();
+
+    /**
+     * @return The key "device:inode:mtime" identifying \a item, or an empty
+     *         array if the item cannot be keyed reliably.
+     */
+    static QByteArray keyFor(const KFileItem &item);
+
+    static QString cacheFilePath();
+
+    void load();
+    void save();
+    void scheduleSave();
+
+    struct Entry {
+        QString mimeType;
+        qint64 lastUsed; // seconds since the epoch, for eviction
+    };
+
+    QMutex m_mutex;
+    QHash<QByteArray, Entry> m_entries;
+    bool m_saveScheduled;
+
+    friend struct KMimeTypeCacheSingleton;
+};
+
+#endif
@@ -0,0 +1,95 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kpipelinetrace.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+
+struct KPipelineTraceSingleton {
+    KPipelineTrace instance;
+};
+Q_GLOBAL_STATIC(KPipelineTraceSingleton, s_pipelineTrace)
+
+KPipelineTrace *KPipelineTrace::instance()
+{
+    return &s_pipelineTrace->instance;
+}
+
+KPipelineTrace::KPipelineTrace()
+    : m_recording(0),
+      m_clock(),
+      m_mutex(),
+      m_spans()
+{
+}
+
+void KPipelineTrace::start()
+{
+    QMutexLocker locker(&m_mutex);
+    m_spans.clear();
+    m_clock.start();
+    m_recording.storeRelease(1);
+}
+
+QString KPipelineTrace::stop()
+{
+    m_recording.storeRelease(0);
+
+    QMutexLocker locker(&m_mutex);
+    if (m_spans.isEmpty()) {
+        return QString();
+    }
+
+    const qint64 processId = QCoreApplication::applicationPid();
+    QJsonArray traceEvents;
+    for (const Span &span : std::as_const(m_spans)) {
+        QJsonObject event;
+        event.insert(QStringLiteral("name"), QString::fromLatin1(span.name));
+        event.insert(QStringLiteral("cat"), QStringLiteral("dolphin"));
+        event.insert(QStringLiteral("ph"), QStringLiteral("X")); // A complete event, i.e. a span with a duration.
+        event.insert(QStringLiteral("ts"), span.startMicroseconds);
+        event.insert(QStringLiteral("dur"), span.durationMicroseconds);
+        event.insert(QStringLiteral("pid"), processId);
+        event.insert(QStringLiteral("tid"), qint64(span.threadId));
+        if (span.itemCount >= 0) {
+            QJsonObject args;
+            args.insert(QStringLiteral("itemCount"), span.itemCount);
+            event.insert(QStringLiteral("args"), args);
+        }
+        traceEvents.append(event);
+    }
+    m_spans.clear();
+
+    QJsonObject root;
+    root.insert(QStringLiteral("traceEvents"), traceEvents);
+    root.insert(QStringLiteral("displayTimeUnit"), QStringLiteral("ms"));
+
+    const QString filePath = QDir::tempPath() + QLatin1String("/dolphin-pipeline-trace-") + QString::number(processId) + QLatin1Char('-')
+        + QString::number(QDateTime::currentSecsSinceEpoch()) + QLatin1String(".json");
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return QString();
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return filePath;
+}
+
+void KPipelineTrace::recordSpan(const char *name, qint64 startMicroseconds, qint64 durationMicroseconds, qint64 itemCount)
+{
+    if (!isRecording()) {
+        // The trace was stopped while the span was open. Spans that did not make it into the written file are dropped.
+        return;
+    }
+    QMutexLocker locker(&m_mutex);
+    m_spans.append(Span{name, startMicroseconds, durationMicroseconds, itemCount, reinterpret_cast<quintptr>(QThread::currentThreadId())});
+}
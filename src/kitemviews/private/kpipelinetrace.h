@@ -0,0 +1,130 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KPIPELINETRACE_H
+#define KPIPELINETRACE_H
+
+#include "dolphin_export.h"
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+/**
+ * @brief Process-wide span recorder for the directory display pipeline.
+ *
+ * While KFileItemRolesTelemetry answers "how much work was done", this class
+ * answers "when did it happen": between StartPipelineTrace() and
+ * StopPipelineTrace() on the D-Bus interface, the instrumented stages of the
+ * pipeline — item insertion and sorting in KFileItemModel, the role
+ * resolution slices of KFileItemModelRolesUpdater, and the layout passes of
+ * KItemListView — record timestamped spans. StopPipelineTrace() writes them
+ * as a chrome://tracing (Trace Event Format) JSON file, so gaps and
+ * serialization between the stages become visible on a shared timeline.
+ *
+ * Unlike the always-on telemetry counters, span recording is off by default:
+ * the instrumented code only pays an atomic load per trace point while no
+ * trace is running. The DOLPHIN_PIPELINE_TRACE_SPAN macro compiles to nothing
+ * entirely when DOLPHIN_DISABLE_PIPELINE_TRACE is defined.
+ */
+class DOLPHIN_EXPORT KPipelineTrace
+{
+public:
+    static KPipelineTrace *instance();
+
+    /** @return Whether a trace is currently being recorded. Safe and cheap to call from any thread. */
+    inline bool isRecording() const
+    {
+        return m_recording.loadRelaxed() != 0;
+    }
+
+    /** Discards any previously recorded spans and starts recording. */
+    void start();
+
+    /**
+     * Stops recording and writes the recorded spans in Trace Event Format to
+     * a file in the temporary directory.
+     * @return The path of the written file, or an empty string if no trace
+     *         was running or the file could not be written.
+     */
+    QString stop();
+
+    /**
+     * Records one completed span. @p startMicroseconds is relative to the
+     * start of the trace, see now(). @p itemCount tells how many items the
+     * span worked on, or -1 if that is not meaningful for the stage.
+     */
+    void recordSpan(const char *name, qint64 startMicroseconds, qint64 durationMicroseconds, qint64 itemCount);
+
+    /** @return Microseconds elapsed since the trace was started. */
+    inline qint64 now() const
+    {
+        return m_clock.nsecsElapsed() / 1000;
+    }
+
+private:
+    KPipelineTrace();
+
+    struct Span {
+        const char *name; // Trace points pass string literals, so storing the pointer is safe.
+        qint64 startMicroseconds;
+        qint64 durationMicroseconds;
+        qint64 itemCount;
+        quintptr threadId;
+    };
+
+    QAtomicInt m_recording;
+    QElapsedTimer m_clock;
+    mutable QMutex m_mutex;
+    QList<Span> m_spans;
+
+    friend struct KPipelineTraceSingleton;
+};
+
+/**
+ * Scoped helper which records the lifetime of the enclosing block as one span.
+ * The start timestamp is only taken while a trace is running, so an inactive
+ * span costs a single atomic load.
+ */
+class KPipelineTraceSpan
+{
+public:
+    explicit inline KPipelineTraceSpan(const char *name, qint64 itemCount = -1)
+    {
+        if (KPipelineTrace::instance()->isRecording()) {
+            m_name = name;
+            m_itemCount = itemCount;
+            m_startMicroseconds = KPipelineTrace::instance()->now();
+        }
+    }
+
+    inline ~KPipelineTraceSpan()
+    {
+        if (m_name) {
+            KPipelineTrace *trace = KPipelineTrace::instance();
+            trace->recordSpan(m_name, m_startMicroseconds, trace->now() - m_startMicroseconds, m_itemCount);
+        }
+    }
+
+    KPipelineTraceSpan(const KPipelineTraceSpan &) = delete;
+    KPipelineTraceSpan &operator=(const KPipelineTraceSpan &) = delete;
+
+private:
+    const char *m_name = nullptr;
+    qint64 m_startMicroseconds = 0;
+    qint64 m_itemCount = -1;
+};
+
+#ifndef DOLPHIN_DISABLE_PIPELINE_TRACE
+/** Records the enclosing block as the span @p name working on @p itemCount items. */
+#define DOLPHIN_PIPELINE_TRACE_SPAN(name, itemCount) const KPipelineTraceSpan pipelineTraceSpan((name), (itemCount))
+#else
+#define DOLPHIN_PIPELINE_TRACE_SPAN(name, itemCount) static_cast<void>(0)
+#endif
+
+#endif
@@ -285,6 +285,17 @@ void KPixmapModifier::scale(QPixmap &pixmap, const QSize &scaledSize)
     pixmap.setDevicePixelRatio(dpr);
 }
 
+void KPixmapModifier::scale(QImage &image, const QSize &scaledSize)
+{
+    if (scaledSize.isEmpty() || image.isNull()) {
+        image = QImage();
+        return;
+    }
+    qreal dpr = image.devicePixelRatio();
+    image = image.scaled(scaledSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    image.setDevicePixelRatio(dpr);
+}
+
 void KPixmapModifier::applyFrame(QPixmap &icon, const QSize &scaledSize)
 {
     if (icon.isNull()) {
@@ -316,6 +327,38 @@ void KPixmapModifier::applyFrame(QPixmap &icon, const QSize &scaledSize)
     icon = framedIcon;
 }
 
+void KPixmapModifier::applyFrame(QImage &icon, const QSize &scaledSize)
+{
+    if (icon.isNull()) {
+        icon = QImage(scaledSize, QImage::Format_ARGB32_Premultiplied);
+        icon.fill(Qt::transparent);
+        return;
+    }
+
+    static TileSet tileSet;
+    qreal dpr = qApp->devicePixelRatio();
+
+    // Resize the icon to the maximum size minus the space required for the frame
+    const QSize size(scaledSize.width() - TileSet::LeftMargin - TileSet::RightMargin, scaledSize.height() - TileSet::TopMargin - TileSet::BottomMargin);
+    scale(icon, size * dpr);
+    icon.setDevicePixelRatio(dpr);
+
+    QImage framedIcon(icon.size().width() + (TileSet::LeftMargin + TileSet::RightMargin) * dpr,
+                      icon.size().height() + (TileSet::TopMargin + TileSet::BottomMargin) * dpr,
+                      QImage::Format_ARGB32_Premultiplied);
+    framedIcon.setDevicePixelRatio(dpr);
+    framedIcon.fill(Qt::transparent);
+
+    QPainter painter;
+    painter.begin(&framedIcon);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    tileSet.paint(&painter, QRect(QPoint(0, 0), framedIcon.size() / dpr));
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    painter.drawImage(TileSet::LeftMargin, TileSet::TopMargin, icon);
+
+    icon = framedIcon;
+}
+
 QSize KPixmapModifier::sizeInsideFrame(const QSize &frameSize)
 {
     return QSize(frameSize.width() - TileSet::LeftMargin - TileSet::RightMargin, frameSize.height() - TileSet::TopMargin - TileSet::BottomMargin);
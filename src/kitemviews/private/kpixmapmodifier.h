@@ -9,6 +9,7 @@
 
 #include "dolphin_export.h"
 
+class QImage;
 class QPixmap;
 class QSize;
 
@@ -22,6 +23,14 @@ public:
      */
     static void scale(QPixmap &pixmap, const QSize &scaledSize);
 
+    /**
+     * Overload working directly on the image data. Transforming a whole
+     * preview pipeline on the QImage level and converting to a QPixmap only
+     * once at the end avoids the image round trip that each QPixmap
+     * operation does internally.
+     */
+    static void scale(QImage &image, const QSize &scaledSize);
+
     /**
      * Resize and paint a frame round an icon
      * @arg scaledSize is in device-independent pixels
@@ -29,6 +38,11 @@ public:
      */
     static void applyFrame(QPixmap &icon, const QSize &scaledSize);
 
+    /**
+     * Overload working directly on the image data, see scale(QImage &, ...).
+     */
+    static void applyFrame(QImage &icon, const QSize &scaledSize);
+
     /**
      * return and paint a frame round an icon
      * @arg framesize is in device-independent pixels
@@ -0,0 +1,67 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kstatictextcache.h"
+
+#include <QFont>
+#include <QTextOption>
+#include <QTransform>
+
+namespace
+{
+// Upper bound for the number of cached entries. A prepared QStaticText
+// stores the glyph layout and is therefore noticeably heavier than a bare
+// string, so the bound is tighter than the one of KTextMeasurementCache.
+// When it is hit the cache is simply reset: the dominating access pattern
+// is scrolling through a directory, which refills the relevant entries
+// within one viewport worth of items anyhow.
+const int MaxStaticTextEntries = 20000;
+}
+
+struct KStaticTextCacheSingleton {
+    KStaticTextCache instance;
+};
+Q_GLOBAL_STATIC(KStaticTextCacheSingleton, s_staticTextCache)
+
+KStaticTextCache *KStaticTextCache::instance()
+{
+    return &s_staticTextCache->instance;
+}
+
+KStaticTextCache::KStaticTextCache()
+    : m_staticTexts()
+{
+}
+
+QStaticText KStaticTextCache::staticText(const QString &text, const QFont &font, const QTextOption &textOption, qreal textWidth)
+{
+    const QString key = keyFor(text, font, textOption, textWidth);
+    const auto it = m_staticTexts.constFind(key);
+    if (it != m_staticTexts.constEnd()) {
+        return it.value();
+    }
+
+    if (m_staticTexts.count() >= MaxStaticTextEntries) {
+        m_staticTexts.clear();
+    }
+
+    QStaticText staticText(text);
+    staticText.setTextFormat(Qt::PlainText);
+    staticText.setPerformanceHint(QStaticText::AggressiveCaching);
+    staticText.setTextOption(textOption);
+    staticText.setTextWidth(textWidth);
+    // Do the shaping now so that all copies handed out share the result.
+    staticText.prepare(QTransform(), font);
+
+    m_staticTexts.insert(key, staticText);
+    return staticText;
+}
+
+QString KStaticTextCache::keyFor(const QString &text, const QFont &font, const QTextOption &textOption, qreal textWidth)
+{
+    return font.key() + QLatin1Char('|') + QString::number(textWidth) + QLatin1Char('|')
+        + QString::number(int(textOption.alignment()) | (int(textOption.wrapMode()) << 16)) + QLatin1Char('|') + text;
+}
@@ -0,0 +1,57 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KSTATICTEXTCACHE_H
+#define KSTATICTEXTCACHE_H
+
+#include "dolphin_export.h"
+
+#include <QHash>
+#include <QStaticText>
+#include <QString>
+
+class QFont;
+class QTextOption;
+
+/**
+ * @brief Process-wide cache for laid out QStaticText entries.
+ *
+ * KStandardItemListWidget draws its texts with QStaticText, whose expensive
+ * text shaping is cached inside each instance. Item-widgets are recycled
+ * while scrolling though, so every widget used to rebuild its QStaticText
+ * objects from scratch in updateTextsCache() and pay the shaping costs
+ * again for strings that had just been laid out by another widget. The
+ * cache shares one prepared QStaticText per (text, font, line width,
+ * text option) between all widgets and views: QStaticText is implicitly
+ * shared, so handing out value copies shares the layout data.
+ *
+ * Unlike KTextMeasurementCache this cache is not thread-safe - it is only
+ * accessed from the GUI thread, where all painting happens.
+ */
+class DOLPHIN_EXPORT KStaticTextCache
+{
+public:
+    static KStaticTextCache *instance();
+
+    /**
+     * @return A QStaticText showing \a text with \a textOption at the line
+     *         width \a textWidth, prepared for being drawn with \a font.
+     *         A negative width stands for an unbounded line. The returned
+     *         object must not be modified as its layout data is shared.
+     */
+    QStaticText staticText(const QString &text, const QFont &font, const QTextOption &textOption, qreal textWidth);
+
+private:
+    KStaticTextCache();
+
+    static QString keyFor(const QString &text, const QFont &font, const QTextOption &textOption, qreal textWidth);
+
+    QHash<QString, QStaticText> m_staticTexts;
+
+    friend struct KStaticTextCacheSingleton;
+};
+
+#endif
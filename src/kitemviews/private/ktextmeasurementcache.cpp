@@ -0,0 +1,62 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "ktextmeasurementcache.h"
+
+#include <QFont>
+
+namespace
+{
+// Upper bound for the number of cached measurements. One entry costs
+// roughly the key string plus a pair, so even the maximum stays in the
+// range of a few ten megabytes. When the bound is hit the cache is simply
+// reset: tracking the recency of the entries would cost more than the
+// occasional re-measurement it could save.
+const int MaxMeasurementEntries = 200000;
+}
+
+struct KTextMeasurementCacheSingleton {
+    KTextMeasurementCache instance;
+};
+Q_GLOBAL_STATIC(KTextMeasurementCacheSingleton, s_textMeasurementCache)
+
+KTextMeasurementCache *KTextMeasurementCache::instance()
+{
+    return &s_textMeasurementCache->instance;
+}
+
+KTextMeasurementCache::KTextMeasurementCache()
+    : m_mutex(),
+      m_measurements()
+{
+}
+
+bool KTextMeasurementCache::lookup(const QFont &font, qreal width, const QString &text, qreal *height, bool *elided) const
+{
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_measurements.constFind(keyFor(font, width, text));
+    if (it == m_measurements.constEnd()) {
+        return false;
+    }
+
+    *height = it.value().first;
+    *elided = it.value().second;
+    return true;
+}
+
+void KTextMeasurementCache::insert(const QFont &font, qreal width, const QString &text, qreal height, bool elided)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_measurements.count() >= MaxMeasurementEntries) {
+        m_measurements.clear();
+    }
+    m_measurements.insert(keyFor(font, width, text), std::make_pair(height, elided));
+}
+
+QString KTextMeasurementCache::keyFor(const QFont &font, qreal width, const QString &text)
+{
+    return font.key() + QLatin1Char('|') + QString::number(width) + QLatin1Char('|') + text;
+}
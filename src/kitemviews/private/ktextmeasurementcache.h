@@ -0,0 +1,61 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef KTEXTMEASUREMENTCACHE_H
+#define KTEXTMEASUREMENTCACHE_H
+
+#include "dolphin_export.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#include <utility>
+
+class QFont;
+
+/**
+ * @brief Process-wide cache for text measurement results.
+ *
+ * Measuring a file name with QTextLayout or QFontMetrics is one of the
+ * dominating costs when the size hints for a huge directory are calculated.
+ * The results only depend on the font, the available line width and the
+ * string itself, so they are shared between all views and layouts of the
+ * process. The cache is thread-safe and may be filled concurrently, see
+ * KStandardItemListWidgetInformant::calculateItemSizeHints().
+ */
+class DOLPHIN_EXPORT KTextMeasurementCache
+{
+public:
+    static KTextMeasurementCache *instance();
+
+    /**
+     * Looks up the measurement of \a text with \a font at the line width
+     * \a width. A negative width stands for an unbounded line.
+     *
+     * @return True if a cached result was written to \a height and
+     *         \a elided.
+     */
+    bool lookup(const QFont &font, qreal width, const QString &text, qreal *height, bool *elided) const;
+
+    /**
+     * Caches the measurement of \a text with \a font at the line width
+     * \a width.
+     */
+    void insert(const QFont &font, qreal width, const QString &text, qreal height, bool elided);
+
+private:
+    KTextMeasurementCache();
+
+    static QString keyFor(const QFont &font, qreal width, const QString &text);
+
+    mutable QMutex m_mutex;
+    QHash<QString, std::pair<qreal, bool>> m_measurements;
+
+    friend struct KTextMeasurementCacheSingleton;
+};
+
+#endif
@@ -13,6 +13,7 @@
 #include "dolphin_version.h"
 #include "dolphindebug.h"
 #include "dolphinmainwindow.h"
+#include "dolphinstartupprofiler.h"
 #include "global.h"
 #if HAVE_KUSERFEEDBACK
 #include "userfeedback/dolphinfeedbackprovider.h"
@@ -37,6 +38,7 @@
 #include <QDBusConnection>
 #include <QDBusConnectionInterface>
 #include <QSessionManager>
+#include <QTimer>
 
 #if HAVE_X11
 #include <private/qtx11extras_p.h>
@@ -66,6 +68,9 @@ int main(int argc, char **argv)
     }
 #endif
 
+    // Start the startup clock, see DolphinStartupProfiler.
+    DolphinStartupProfiler::instance();
+
     /**
      * trigger initialisation of proper icon theme
      */
@@ -73,6 +78,7 @@ int main(int argc, char **argv)
 
     QApplication app(argc, argv);
     app.setWindowIcon(QIcon::fromTheme(QStringLiteral("org.kde.dolphin"), app.windowIcon()));
+    DolphinStartupProfiler::instance()->recordPhase(DolphinStartupProfiler::ApplicationInit);
 
 #if HAVE_STYLE_MANAGER
     /**
@@ -148,6 +154,7 @@ int main(int argc, char **argv)
     aboutData.processCommandLine(&parser);
 
     const bool splitView = parser.isSet(QStringLiteral("split")) || GeneralSettings::splitView();
+    DolphinStartupProfiler::instance()->recordPhase(DolphinStartupProfiler::ConfigLoaded);
     const bool openFiles = parser.isSet(QStringLiteral("select"));
     const bool adminWorkerInfoWanted = parser.isSet(QStringLiteral("sudo")) || parser.isSet(QStringLiteral("admin"));
     const QStringList args = parser.positionalArguments();
@@ -237,25 +244,33 @@ int main(int argc, char **argv)
     //    reboot is in use
     // 3. There is a session available to restore
     if (!parser.isSet(QStringLiteral("new-window")) && (app.isSessionRestored() || GeneralSettings::rememberOpenedTabs())) {
-        // Get saved state data for the last-closed Dolphin instance
-        const QString serviceName = QStringLiteral("org.kde.dolphin-%1").arg(QCoreApplication::applicationPid());
-        if (Dolphin::dolphinGuiInstances(serviceName).size() > 0) {
-            const QString className = KXmlGuiWindow::classNameOfToplevel(1);
-            if (className == QLatin1String("DolphinMainWindow")) {
-                mainWindow->restore(1);
-                // If the user passed any URLs to Dolphin, open those in the
-                // window after session-restoring it
-                if (startedWithURLs) {
-                    if (openFiles) {
-                        mainWindow->openFiles(urls, splitView);
-                    } else {
-                        mainWindow->openDirectories(urls, splitView);
+        // Restore the session only once the event loop is running: This way
+        // the window frame and the initially shown view get on screen first
+        // and the session data - which can touch the disk and DBus - is
+        // applied right afterwards. Together with the hibernated restore of
+        // background tabs (see DolphinTabWidget::readProperties()) this keeps
+        // a cold start with a big session interactive from the beginning.
+        QTimer::singleShot(0, mainWindow, [mainWindow, urls, openFiles, splitView, startedWithURLs]() {
+            // Get saved state data for the last-closed Dolphin instance
+            const QString serviceName = QStringLiteral("org.kde.dolphin-%1").arg(QCoreApplication::applicationPid());
+            if (Dolphin::dolphinGuiInstances(serviceName).size() > 0) {
+                const QString className = KXmlGuiWindow::classNameOfToplevel(1);
+                if (className == QLatin1String("DolphinMainWindow")) {
+                    mainWindow->restore(1);
+                    // If the user passed any URLs to Dolphin, open those in the
+                    // window after session-restoring it
+                    if (startedWithURLs) {
+                        if (openFiles) {
+                            mainWindow->openFiles(urls, splitView);
+                        } else {
+                            mainWindow->openDirectories(urls, splitView);
+                        }
                     }
+                } else {
+                    qCWarning(DolphinDebug) << "Unknown class " << className << " in session saved data!";
                 }
-            } else {
-                qCWarning(DolphinDebug) << "Unknown class " << className << " in session saved data!";
             }
-        }
+        });
     } else if (splitView) {
         // if split mode is set by default and we do not restore last session view
         // we need to call it to properly activate dolphin view
@@ -63,11 +63,24 @@ void InformationPanel::setSelection(const KFileItemList &selection)
         m_isSelectionActive = false;
         m_infoTimer->stop();
     } else {
+        cancelRequest();
         if ((count == 1) && !selection.first().url().isEmpty()) {
             m_urlCandidate = selection.first().url();
         }
         m_isSelectionActive = true;
-        showItemInfo();
+        // Coalesce rapid selection changes, e.g. while arrow-keying through a
+        // directory: the metadata query and the preview job are only started
+        // for the item the user settles on instead of for every step.
+        m_infoTimer->start();
+
+        // While the expensive work above is pending, show the cheap facts the
+        // model already knows right away, so the panel never displays stale
+        // information for a superseded item.
+        if (count == 1) {
+            m_content->showQuickItemInfo(selection.first());
+        } else {
+            m_content->showQuickItemsInfo(selection);
+        }
     }
 }
 
@@ -94,6 +107,10 @@ void InformationPanel::requestDelayedItemInfo(const KFileItem &item)
 
     m_hoveredItem = item;
     m_infoTimer->start();
+
+    // Show the cheap model-provided facts immediately while the metadata
+    // extraction and the preview wait for the hover to settle.
+    m_content->showQuickItemInfo(item);
 }
 
 bool InformationPanel::urlChanged()
@@ -365,6 +382,10 @@ void InformationPanel::cancelRequest()
     delete m_folderStatJob;
     m_folderStatJob = nullptr;
 
+    // A preview that is still being generated belongs to a superseded item,
+    // so kill it right away instead of letting it run to completion.
+    m_content->cancelPreviewJob();
+
     m_infoTimer->stop();
     m_resetUrlTimer->stop();
     // Don't reset m_urlChangedTimer. As it is assured that the timeout of m_urlChangedTimer
@@ -7,6 +7,7 @@
 #include "informationpanelcontent.h"
 
 #include <KConfigGroup>
+#include <KIO/Global>
 #include <KIO/PreviewJob>
 #include <KIconEffect>
 #include <KIconLoader>
@@ -42,6 +43,8 @@
 
 const int PLAY_ARROW_SIZE = 24;
 const int PLAY_ARROW_BORDER_SIZE = 2;
+// Maximum accumulated byte size of the previews kept for reuse in m_previewCache.
+const int PREVIEW_CACHE_COST_LIMIT = 16 * 1024 * 1024;
 
 InformationPanelContent::InformationPanelContent(QWidget *parent)
     : QWidget(parent)
@@ -51,9 +54,11 @@ InformationPanelContent::InformationPanelContent(QWidget *parent)
     , m_preview(nullptr)
     , m_mediaWidget(nullptr)
     , m_nameLabel(nullptr)
+    , m_quickInfoLabel(nullptr)
     , m_metaDataWidget(nullptr)
     , m_metaDataArea(nullptr)
     , m_isVideo(false)
+    , m_previewCache(PREVIEW_CACHE_COST_LIMIT)
 {
     parent->installEventFilter(this);
 
@@ -101,9 +106,22 @@ InformationPanelContent::InformationPanelContent(QWidget *parent)
     const bool previewsShown = InformationPanelSettings::previewsShown();
     m_preview->setVisible(previewsShown);
 
+    // First tier of the two-tier display: the facts which are known to the
+    // view model without any extraction. @see showQuickItemInfo()
+    m_quickInfoLabel = new QLabel(parent);
+    m_quickInfoLabel->setFont(QFontDatabase::systemFont(QFontDatabase::SmallestReadableFont));
+    m_quickInfoLabel->setAlignment(Qt::AlignHCenter);
+    m_quickInfoLabel->setWordWrap(true);
+    m_quickInfoLabel->hide();
+
     m_metaDataWidget = new Baloo::FileMetaDataWidget(parent);
     m_metaDataWidget->setDateFormat(static_cast<Baloo::DateFormats>(InformationPanelSettings::dateFormat()));
     connect(m_metaDataWidget, &Baloo::FileMetaDataWidget::urlActivated, this, &InformationPanelContent::urlActivated);
+    connect(m_metaDataWidget, &Baloo::FileMetaDataWidget::metaDataRequestFinished, this, [this]() {
+        // The extracted metadata has arrived, the quick information is
+        // superseded by it.
+        m_quickInfoLabel->hide();
+    });
     m_metaDataWidget->setFont(QFontDatabase::systemFont(QFontDatabase::SmallestReadableFont));
     m_metaDataWidget->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Minimum);
 
@@ -140,6 +158,7 @@ InformationPanelContent::InformationPanelContent(QWidget *parent)
     layout->addWidget(m_mediaWidget);
     layout->addWidget(m_nameLabel);
     layout->addWidget(new KSeparator());
+    layout->addWidget(m_quickInfoLabel);
     layout->addWidget(m_configureLabel);
     layout->addWidget(m_metaDataArea);
     layout->addWidget(m_configureButtons);
@@ -159,11 +178,43 @@ void InformationPanelContent::showItem(const KFileItem &item)
         m_item = item;
         m_preview->stopAnimatedImage();
         refreshMetaData();
+    } else {
+        // The shown metadata is already up to date, so any quick information
+        // shown for this item is not needed as a stand-in anymore.
+        m_quickInfoLabel->hide();
     }
 
     refreshPreview();
 }
 
+void InformationPanelContent::showQuickItemInfo(const KFileItem &item)
+{
+    if (item.isNull()) {
+        return;
+    }
+
+    setNameLabelText(item.text());
+
+    // getStatusBarInfo() combines the type, size and link target from the
+    // stat information the model already holds - no I/O is done here.
+    m_quickInfoLabel->setText(item.getStatusBarInfo());
+    m_quickInfoLabel->show();
+}
+
+void InformationPanelContent::showQuickItemsInfo(const KFileItemList &items)
+{
+    setNameLabelText(i18ncp("@label", "%1 item selected", "%1 items selected", items.count()));
+
+    KIO::filesize_t totalSize = 0;
+    for (const KFileItem &item : items) {
+        if (!item.isDir() && !item.isLink()) {
+            totalSize += item.size();
+        }
+    }
+    m_quickInfoLabel->setText(KIO::convertSize(totalSize));
+    m_quickInfoLabel->show();
+}
+
 void InformationPanelContent::refreshPixmapView()
 {
     // If there is a preview job, kill it to prevent that we have jobs for
@@ -175,6 +226,15 @@ void InformationPanelContent::refreshPixmapView()
     // Reset disabled state when starting a new preview job
     m_disabledPreviewUrl.clear();
 
+    // Reuse a recently generated preview if there is one, e.g. when stepping
+    // back and forth between items with the arrow keys. The cache key includes
+    // the modification time, so changed files never hit the cache.
+    if (const QPixmap *cachedPreview = m_previewCache.object(previewCacheKey(m_item))) {
+        m_outdatedPreviewTimer->stop();
+        m_preview->setPixmap(*cachedPreview);
+        return;
+    }
+
     // try to get a preview pixmap from the item...
 
     // Mark the currently shown preview as outdated. This is done
@@ -427,6 +487,7 @@ void InformationPanelContent::showPreview(const KFileItem &item, const QPixmap &
         painter.fillPath(path, brush);
     }
 
+    m_previewCache.insert(previewCacheKey(item), new QPixmap(p), p.width() * p.height() * p.depth() / 8);
     m_preview->setPixmap(p);
 }
 
@@ -472,6 +533,21 @@ void InformationPanelContent::setPreviewAutoPlay(bool autoPlay)
     m_mediaWidget->setAutoPlay(autoPlay);
 }
 
+void InformationPanelContent::cancelPreviewJob()
+{
+    if (m_previewJob) {
+        m_previewJob->kill();
+        m_previewJob = nullptr;
+    }
+}
+
+QString InformationPanelContent::previewCacheKey(const KFileItem &item) const
+{
+    return item.url().toString() % QLatin1Char('|') % QString::number(item.time(KFileItem::ModificationTime).toSecsSinceEpoch()) % QLatin1Char('|')
+        % QString::number(item.size()) % QLatin1Char('|') % QString::number(m_preview->width()) % QLatin1Char('x') % QString::number(m_preview->height())
+        % QLatin1Char('@') % QString::number(devicePixelRatioF());
+}
+
 void InformationPanelContent::setNameLabelText(const QString &text)
 {
     QTextOption textOption;
@@ -10,6 +10,7 @@
 #include "config-dolphin.h"
 #include <KFileItem>
 
+#include <QCache>
 #include <QPointer>
 #include <QUrl>
 #include <QWidget>
@@ -59,6 +60,24 @@ public:
      */
     void showItems(const KFileItemList &items);
 
+    /**
+     * Shows the information about \p item which is known to the view model
+     * without any extraction: the name and the stat-based facts (type, size,
+     * modification time). This is the cheap first tier of the display and is
+     * meant to be called immediately on a selection or hover change, while
+     * showItem() - the expensive second tier with preview generation and
+     * metadata extraction - only follows for the item the user settles on.
+     * The quick information is replaced as soon as the extracted metadata
+     * arrives.
+     */
+    void showQuickItemInfo(const KFileItem &item);
+
+    /**
+     * The showQuickItemInfo() counterpart for a selection of several
+     * \p items: shows the item count and their accumulated size.
+     */
+    void showQuickItemsInfo(const KFileItemList &items);
+
     KFileItemList items();
 
     /**
@@ -78,6 +97,13 @@ public:
      */
     void setPreviewAutoPlay(bool autoPlay);
 
+    /**
+     * Kills a possibly running preview job. Called by the InformationPanel
+     * as soon as a newer item is scheduled to be shown, so a superseded
+     * preview is not generated to completion first.
+     */
+    void cancelPreviewJob();
+
 Q_SIGNALS:
     void urlActivated(const QUrl &url);
     void configurationFinished();
@@ -137,6 +163,13 @@ private:
      */
     void refreshPixmapView();
 
+    /**
+     * @return The key of \a item in m_previewCache. Includes the modification
+     *         time, the file size and the preview dimensions, so a changed
+     *         file or a resized panel never reuses a stale preview.
+     */
+    QString previewCacheKey(const KFileItem &item) const;
+
     bool gestureEvent(QGestureEvent *event);
 
 private:
@@ -148,6 +181,9 @@ private:
     PixmapViewer *m_preview;
     MediaWidget *m_mediaWidget;
     QTextEdit *m_nameLabel;
+    /// First-tier display of the cheap stat-based facts, hidden again once
+    /// the extracted metadata has arrived. @see showQuickItemInfo()
+    QLabel *m_quickInfoLabel;
     Baloo::FileMetaDataWidget *m_metaDataWidget;
     QScrollArea *m_metaDataArea;
     QLabel *m_configureLabel;
@@ -155,6 +191,11 @@ private:
 
     bool m_isVideo;
     QUrl m_disabledPreviewUrl;
+
+    /// Recently generated previews, so that stepping back and forth between
+    /// items does not launch a new preview job for each step.
+    /// @see previewCacheKey()
+    QCache<QString, QPixmap> m_previewCache;
 };
 
 #endif // INFORMATIONPANELCONTENT_H
@@ -12,19 +12,131 @@
 #include <QMovie>
 #include <QPainter>
 #include <QStyle>
+#include <QThread>
+#include <QTimer>
+
+namespace
+{
+/// Upper bound of frames the decoder gets ahead of playback. Together with the
+/// pre-scaling to the widget size this bounds the memory used for buffering.
+constexpr int BufferedFrameCount = 8;
+
+/// Fallback delay for frames that do not specify one, matching the common
+/// handling of zero-delay GIFs.
+constexpr int DefaultFrameDelay = 100;
+}
+
+/**
+ * Decodes the frames of an animated image on a worker thread. Each frame is
+ * scaled down to the target size before it crosses the thread boundary, so the
+ * GUI thread never decodes or scales. The decoder stays at most
+ * BufferedFrameCount frames ahead of playback: PixmapViewer reports each shown
+ * frame through continueDecoding(), which grants the credit for decoding the
+ * next one.
+ */
+class AnimatedImageDecoder : public QObject
+{
+    Q_OBJECT
+
+public:
+    ~AnimatedImageDecoder() override
+    {
+        delete m_reader;
+    }
+
+public Q_SLOTS:
+    void startDecoding(int generation, const QString &fileName, const QSize &targetSize)
+    {
+        delete m_reader;
+        m_reader = new QImageReader(fileName);
+        m_fileName = fileName;
+        m_targetSize = targetSize;
+        m_generation = generation;
+        m_decodedFrames = 0;
+        m_shownFrames = 0;
+        decodeAhead();
+    }
+
+    void stopDecoding()
+    {
+        delete m_reader;
+        m_reader = nullptr;
+    }
+
+    void continueDecoding(int generation)
+    {
+        if (generation != m_generation) {
+            return;
+        }
+        ++m_shownFrames;
+        decodeAhead();
+    }
+
+Q_SIGNALS:
+    void frameDecoded(int generation, const QImage &image, int delay);
+
+private:
+    void decodeAhead()
+    {
+        while (m_reader && m_decodedFrames - m_shownFrames < BufferedFrameCount) {
+            QImage frame = m_reader->read();
+            if (frame.isNull()) {
+                // The end of the animation was reached. QImageReader cannot rewind,
+                // so loop by reading the file from the start again.
+                delete m_reader;
+                m_reader = new QImageReader(m_fileName);
+                frame = m_reader->read();
+                if (frame.isNull()) {
+                    stopDecoding();
+                    return;
+                }
+            }
+
+            int delay = m_reader->nextImageDelay();
+            if (delay <= 0) {
+                delay = DefaultFrameDelay;
+            }
+
+            if (m_targetSize.isValid() && (frame.width() > m_targetSize.width() || frame.height() > m_targetSize.height())) {
+                frame = frame.scaled(m_targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+            }
+
+            ++m_decodedFrames;
+            Q_EMIT frameDecoded(m_generation, frame, delay);
+        }
+    }
+
+    QImageReader *m_reader = nullptr;
+    QString m_fileName;
+    QSize m_targetSize;
+    int m_generation = 0;
+    int m_decodedFrames = 0;
+    int m_shownFrames = 0;
+};
 
 PixmapViewer::PixmapViewer(QWidget *parent)
     : QWidget(parent)
-    , m_animatedImage(nullptr)
     , m_sizeHint()
     , m_hasAnimatedImage(false)
+    , m_isAnimationPlaying(false)
+    , m_decoderThread(nullptr)
+    , m_decoder(nullptr)
+    , m_decodeGeneration(0)
 {
     setMinimumWidth(KIconLoader::SizeEnormous);
     setMinimumHeight(KIconLoader::SizeEnormous);
+
+    m_frameTimer = new QTimer(this);
+    m_frameTimer->setSingleShot(true);
+    connect(m_frameTimer, &QTimer::timeout, this, &PixmapViewer::presentNextAnimatedImageFrame);
 }
 
 PixmapViewer::~PixmapViewer()
 {
+    if (m_decoderThread) {
+        m_decoderThread->quit();
+        m_decoderThread->wait();
+    }
 }
 
 void PixmapViewer::setPixmap(const QPixmap &pixmap)
@@ -36,7 +148,7 @@ void PixmapViewer::setPixmap(const QPixmap &pixmap)
     m_pixmap = pixmap;
 
     // Avoid flicker with static pixmap if an animated image is running
-    if (m_animatedImage && m_animatedImage->state() == QMovie::Running) {
+    if (m_isAnimationPlaying) {
         return;
     }
 
@@ -45,16 +157,16 @@ void PixmapViewer::setPixmap(const QPixmap &pixmap)
     if (m_hasAnimatedImage) {
         // If there is no transition animation but an animatedImage
         // and it is not already running, start animating now
-        if (m_animatedImage->state() != QMovie::Running) {
-            m_animatedImage->start();
-        }
+        startAnimatedImage();
     }
 }
 
 void PixmapViewer::setSizeHint(const QSize &size)
 {
-    if (m_animatedImage && size != m_sizeHint) {
-        m_animatedImage->stop();
+    if (m_isAnimationPlaying && size != m_sizeHint) {
+        // The frames buffered so far are scaled for the old size. Stop the
+        // playback; the next setPixmap() call restarts it with the new size.
+        stopAnimationPlayback();
     }
 
     m_sizeHint = size;
@@ -68,16 +180,15 @@ QSize PixmapViewer::sizeHint() const
 
 void PixmapViewer::setAnimatedImageFileName(const QString &fileName)
 {
-    if (!m_animatedImage) {
-        m_animatedImage = new QMovie(this);
-        connect(m_animatedImage, &QMovie::frameChanged, this, &PixmapViewer::updateAnimatedImageFrame);
+    if (m_hasAnimatedImage && m_animatedImageFileName == fileName) {
+        return;
     }
 
-    if (m_animatedImage->fileName() != fileName) {
-        m_animatedImage->setFileName(fileName);
-    }
+    stopAnimationPlayback();
+    m_animatedImageFileName = fileName;
 
-    m_hasAnimatedImage = m_animatedImage->isValid() && (m_animatedImage->frameCount() > 1);
+    QImageReader reader(fileName);
+    m_hasAnimatedImage = reader.canRead() && (reader.imageCount() > 1);
 }
 
 QString PixmapViewer::animatedImageFileName() const
@@ -85,7 +196,7 @@ QString PixmapViewer::animatedImageFileName() const
     if (!m_hasAnimatedImage) {
         return QString();
     }
-    return m_animatedImage->fileName();
+    return m_animatedImageFileName;
 }
 
 void PixmapViewer::paintEvent(QPaintEvent *event)
@@ -99,25 +210,100 @@ void PixmapViewer::paintEvent(QPaintEvent *event)
     }
 }
 
-void PixmapViewer::updateAnimatedImageFrame()
+void PixmapViewer::startAnimatedImage()
 {
-    Q_ASSERT(m_animatedImage);
+    if (!m_decoderThread) {
+        m_decoderThread = new QThread(this);
+        m_decoderThread->setObjectName(QStringLiteral("PixmapViewerDecoder"));
+        m_decoder = new AnimatedImageDecoder();
+        m_decoder->moveToThread(m_decoderThread);
+        connect(m_decoderThread, &QThread::finished, m_decoder, &QObject::deleteLater);
+        connect(m_decoder, &AnimatedImageDecoder::frameDecoded, this, &PixmapViewer::slotFrameDecoded);
+        m_decoderThread->start();
+    }
+
+    ++m_decodeGeneration;
+    m_frameBuffer.clear();
+    m_frameTimer->stop();
+    m_isAnimationPlaying = true;
+
+    auto *decoder = m_decoder;
+    const int generation = m_decodeGeneration;
+    const QString fileName = m_animatedImageFileName;
+    const QSize targetSize = m_sizeHint;
+    QMetaObject::invokeMethod(
+        decoder,
+        [decoder, generation, fileName, targetSize]() {
+            decoder->startDecoding(generation, fileName, targetSize);
+        },
+        Qt::QueuedConnection);
+}
 
-    m_pixmap = m_animatedImage->currentPixmap();
-    if (m_pixmap.width() > m_sizeHint.width() || m_pixmap.height() > m_sizeHint.height()) {
-        m_pixmap = m_pixmap.scaled(m_sizeHint, Qt::KeepAspectRatio);
-        m_animatedImage->setScaledSize(m_pixmap.size());
+void PixmapViewer::stopAnimationPlayback()
+{
+    ++m_decodeGeneration;
+    m_frameTimer->stop();
+    m_frameBuffer.clear();
+    m_isAnimationPlaying = false;
+
+    if (m_decoder) {
+        auto *decoder = m_decoder;
+        QMetaObject::invokeMethod(
+            decoder,
+            [decoder]() {
+                decoder->stopDecoding();
+            },
+            Qt::QueuedConnection);
     }
+}
+
+void PixmapViewer::slotFrameDecoded(int generation, const QImage &image, int delay)
+{
+    if (generation != m_decodeGeneration) {
+        // The frame belongs to a superseded animation.
+        return;
+    }
+
+    m_frameBuffer.enqueue(AnimatedImageFrame{image, delay});
+
+    if (!m_frameTimer->isActive() && m_frameBuffer.count() == 1) {
+        // Either the playback just started or the decoder had fallen behind:
+        // present the frame right away.
+        presentNextAnimatedImageFrame();
+    }
+}
+
+void PixmapViewer::presentNextAnimatedImageFrame()
+{
+    if (m_frameBuffer.isEmpty()) {
+        // The decoder has fallen behind. The next frame is presented as soon
+        // as it arrives in slotFrameDecoded().
+        return;
+    }
+
+    const AnimatedImageFrame frame = m_frameBuffer.dequeue();
+    m_pixmap = QPixmap::fromImage(frame.image);
     update();
+
+    // Grant the decoder the credit for the next frame.
+    auto *decoder = m_decoder;
+    const int generation = m_decodeGeneration;
+    QMetaObject::invokeMethod(
+        decoder,
+        [decoder, generation]() {
+            decoder->continueDecoding(generation);
+        },
+        Qt::QueuedConnection);
+
+    m_frameTimer->start(frame.delay);
 }
 
 void PixmapViewer::stopAnimatedImage()
 {
     if (m_hasAnimatedImage) {
-        m_animatedImage->stop();
+        stopAnimationPlayback();
         m_hasAnimatedImage = false;
-        delete m_animatedImage;
-        m_animatedImage = nullptr;
+        m_animatedImageFileName.clear();
     }
 }
 
@@ -130,3 +316,4 @@ bool PixmapViewer::isAnimatedMimeType(const QString &mimeType)
 }
 
 #include "moc_pixmapviewer.cpp"
+#include "pixmapviewer.moc"
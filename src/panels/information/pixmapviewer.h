@@ -7,19 +7,26 @@
 #ifndef PIXMAPVIEWER_H
 #define PIXMAPVIEWER_H
 
+#include <QImage>
 #include <QPixmap>
 #include <QQueue>
 #include <QTimeLine>
 #include <QWidget>
 
+class AnimatedImageDecoder;
 class QPaintEvent;
-class QMovie;
+class QThread;
+class QTimer;
 
 /**
  * @brief Widget which shows a pixmap centered inside the boundaries.
  *
  * When the pixmap is changed, a smooth transition is done from the old pixmap
  * to the new pixmap.
+ *
+ * Animated images are decoded ahead on a worker thread into a bounded buffer
+ * of frames that are already scaled to the widget size, so showing a frame on
+ * the GUI thread is reduced to a blit.
  */
 class PixmapViewer : public QWidget
 {
@@ -53,13 +60,58 @@ protected:
     void paintEvent(QPaintEvent *event) override;
 
 private Q_SLOTS:
-    void updateAnimatedImageFrame();
+    /**
+     * Appends the frame \a image decoded by m_decoder to m_frameBuffer.
+     * Frames whose \a generation does not match m_decodeGeneration belong
+     * to a superseded animation and are discarded.
+     */
+    void slotFrameDecoded(int generation, const QImage &image, int delay);
+
+    /**
+     * Blits the next buffered frame of the animated image and schedules
+     * the one after it according to the frame delay.
+     */
+    void presentNextAnimatedImageFrame();
 
 private:
+    /**
+     * Starts decoding m_animatedImageFileName on the worker thread and
+     * begins presenting the frames as they arrive. The worker thread is
+     * created lazily on the first animated image and kept for reuse.
+     */
+    void startAnimatedImage();
+
+    /**
+     * Stops presenting frames and discards all buffered ones. Keeps
+     * m_hasAnimatedImage untouched so that the playback can be restarted
+     * by the next setPixmap() call.
+     */
+    void stopAnimationPlayback();
+
+    /** One decoded and pre-scaled frame of an animated image. */
+    struct AnimatedImageFrame {
+        QImage image;
+        int delay; ///< Milliseconds until the next frame should be shown.
+    };
+
     QPixmap m_pixmap;
-    QMovie *m_animatedImage;
     QSize m_sizeHint;
+
+    QString m_animatedImageFileName;
     bool m_hasAnimatedImage;
+    bool m_isAnimationPlaying;
+
+    QThread *m_decoderThread;
+    AnimatedImageDecoder *m_decoder;
+
+    /// Identifies the current animation. It is increased whenever the file or
+    /// the target size changes so that late frames of the old animation are ignored.
+    int m_decodeGeneration;
+
+    /// Frames decoded ahead by m_decoder. The decoder never gets more than a
+    /// fixed number of frames ahead of playback, which bounds the buffer.
+    QQueue<AnimatedImageFrame> m_frameBuffer;
+    QTimer *m_frameTimer;
 };
 
 inline QPixmap PixmapViewer::pixmap() const
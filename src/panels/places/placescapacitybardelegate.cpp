@@ -0,0 +1,143 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "placescapacitybardelegate.h"
+
+#include "statusbar/mountpointobserver.h"
+
+#include <KFilePlacesModel>
+#include <KFilePlacesView>
+
+#include <Solid/StorageAccess>
+
+#include <QPainter>
+
+namespace
+{
+// Height of the capacity bar in device-independent pixels.
+const int CapacityBarHeight = 2;
+}
+
+PlacesCapacityBarDelegate::PlacesCapacityBarDelegate(QAbstractItemDelegate *baseDelegate, KFilePlacesView *view)
+    : QAbstractItemDelegate(view)
+    , m_baseDelegate(baseDelegate)
+    , m_view(view)
+{
+}
+
+PlacesCapacityBarDelegate::~PlacesCapacityBarDelegate()
+{
+    for (const SpaceInfo &info : std::as_const(m_spaceInfoForPath)) {
+        disconnect(info.observer, nullptr, this, nullptr);
+        info.observer->deref();
+    }
+}
+
+void PlacesCapacityBarDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    m_baseDelegate->paint(painter, option, index);
+
+    const SpaceInfo *info = spaceInfoForIndex(index);
+    if (!info || !info->observer->hasSpaceInfo() || info->observer->size() == 0) {
+        return;
+    }
+
+    const quint64 size = info->observer->size();
+    const quint64 used = size - qMin(info->observer->available(), size);
+
+    const int margin = qMax(2, option.rect.height() / 8);
+    const QRect barRect(option.rect.left() + margin, option.rect.bottom() - CapacityBarHeight, option.rect.width() - 2 * margin, CapacityBarHeight);
+    const int usedWidth = static_cast<int>(barRect.width() * (static_cast<double>(used) / size));
+
+    painter->save();
+    painter->setPen(Qt::NoPen);
+
+    QColor track = option.palette.color(QPalette::WindowText);
+    track.setAlphaF(0.15f);
+    painter->setBrush(track);
+    painter->drawRect(barRect);
+
+    // Stale values - carried over from before the last mount state change
+    // and not yet confirmed by an update - are dimmed instead of hidden, so
+    // that a slowly answering device still shows its last known capacity.
+    QColor fill = option.palette.color(QPalette::Highlight);
+    fill.setAlphaF(info->fresh ? 0.9f : 0.4f);
+    painter->setBrush(fill);
+    painter->drawRect(QRect(barRect.topLeft(), QSize(usedWidth, barRect.height())));
+
+    painter->restore();
+}
+
+QSize PlacesCapacityBarDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    return m_baseDelegate->sizeHint(option, index);
+}
+
+QWidget *PlacesCapacityBarDelegate::createEditor(QWidget *parent, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    return m_baseDelegate->createEditor(parent, option, index);
+}
+
+void PlacesCapacityBarDelegate::setEditorData(QWidget *editor, const QModelIndex &index) const
+{
+    m_baseDelegate->setEditorData(editor, index);
+}
+
+void PlacesCapacityBarDelegate::setModelData(QWidget *editor, QAbstractItemModel *model, const QModelIndex &index) const
+{
+    m_baseDelegate->setModelData(editor, model, index);
+}
+
+void PlacesCapacityBarDelegate::updateEditorGeometry(QWidget *editor, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    m_baseDelegate->updateEditorGeometry(editor, option, index);
+}
+
+PlacesCapacityBarDelegate::SpaceInfo *PlacesCapacityBarDelegate::spaceInfoForIndex(const QModelIndex &index) const
+{
+    auto *placesModel = qobject_cast<const KFilePlacesModel *>(index.model());
+    if (!placesModel) {
+        return nullptr;
+    }
+
+    const Solid::StorageAccess *storageAccess = placesModel->deviceForIndex(index).as<Solid::StorageAccess>();
+    if (!storageAccess || !storageAccess->isAccessible()) {
+        return nullptr;
+    }
+
+    const QString path = storageAccess->filePath();
+    if (path.isEmpty()) {
+        return nullptr;
+    }
+
+    auto it = m_spaceInfoForPath.find(path);
+    if (it == m_spaceInfoForPath.end()) {
+        // First paint of this device: attach to the shared observer of its
+        // mount point and request an update. Until it completes, any values
+        // the observer already holds are rendered as stale.
+        MountPointObserver *observer = MountPointObserver::observerForUrl(QUrl::fromLocalFile(path));
+        observer->ref();
+        it = m_spaceInfoForPath.insert(path, {observer, false});
+
+        auto *self = const_cast<PlacesCapacityBarDelegate *>(this);
+        connect(observer, &MountPointObserver::updateFinished, self, [self, path]() {
+            const auto infoIt = self->m_spaceInfoForPath.find(path);
+            if (infoIt != self->m_spaceInfoForPath.end()) {
+                infoIt->fresh = true;
+            }
+            self->m_view->viewport()->update();
+        });
+        connect(observer, &MountPointObserver::spaceInfoChanged, self, [self]() {
+            self->m_view->viewport()->update();
+        });
+
+        observer->update();
+    }
+
+    return &it.value();
+}
+
+#include "moc_placescapacitybardelegate.cpp"
@@ -0,0 +1,77 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef PLACESCAPACITYBARDELEGATE_H
+#define PLACESCAPACITYBARDELEGATE_H
+
+#include <QAbstractItemDelegate>
+#include <QHash>
+#include <QPointer>
+
+class KFilePlacesView;
+class MountPointObserver;
+
+/**
+ * @brief Paints asynchronous capacity bars under the device entries of the Places panel.
+ *
+ * Wraps the item delegate of the KFilePlacesView and sources the capacity of
+ * each mounted device from the process-wide MountPointObserver service, which
+ * performs its statfs calls on the thread pool and pushes changed values.
+ * The panel therefore never queries a device on the GUI path: the last known
+ * values are rendered immediately - dimmed while they are stale, i.e. not yet
+ * confirmed for the current mount state - and a spun-down disk or a dead
+ * network mount can only ever delay its own bar, not the panel's update cycle.
+ */
+class PlacesCapacityBarDelegate : public QAbstractItemDelegate
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param baseDelegate The delegate of \a view that this delegate wraps.
+     *                     All painting except the capacity bar is forwarded
+     *                     to it. Ownership is not taken.
+     */
+    PlacesCapacityBarDelegate(QAbstractItemDelegate *baseDelegate, KFilePlacesView *view);
+    ~PlacesCapacityBarDelegate() override;
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+    QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    void setEditorData(QWidget *editor, const QModelIndex &index) const override;
+    void setModelData(QWidget *editor, QAbstractItemModel *model, const QModelIndex &index) const override;
+    void updateEditorGeometry(QWidget *editor, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+private:
+    /**
+     * The capacity state of one observed mount point. The observer is shared
+     * process-wide; \a fresh tells whether it has completed an update since
+     * this panel attached to it, i.e. whether the rendered values are
+     * confirmed or carried over from an earlier query.
+     */
+    struct SpaceInfo {
+        MountPointObserver *observer;
+        bool fresh;
+    };
+
+    /**
+     * @return The capacity state for the device at \a index, or nullptr if
+     *         the entry is not a mounted device. Attaches to the shared
+     *         observer of the device's mount point on first use and requests
+     *         an asynchronous update.
+     */
+    SpaceInfo *spaceInfoForIndex(const QModelIndex &index) const;
+
+    QAbstractItemDelegate *m_baseDelegate;
+    KFilePlacesView *m_view;
+
+    // Keyed by the mount path of the device entries that have been painted
+    // so far. Mutable because the observers are attached lazily from paint().
+    mutable QHash<QString, SpaceInfo> m_spaceInfoForPath;
+};
+
+#endif // PLACESCAPACITYBARDELEGATE_H
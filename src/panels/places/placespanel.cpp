@@ -14,6 +14,7 @@
 #include "dolphin_generalsettings.h"
 #include "dolphin_placespanelsettings.h"
 #include "dolphinplacesmodelsingleton.h"
+#include "placescapacitybardelegate.h"
 #include "settings/dolphinsettingsdialog.h"
 #include "views/draganddrophelper.h"
 
@@ -70,6 +71,10 @@ PlacesPanel::PlacesPanel(QWidget *parent)
 
     readSettings();
 
+    // The device entries of the model are confirmed asynchronously. Until they are, the size
+    // hint is derived from the snapshot of the last session, see sizeHint().
+    m_snapshotPlaceTexts = DolphinPlacesModelSingleton::snapshotPlaceTexts();
+
     // Set the model here so that it's loaded in time for the sizeHint to properly apply (setting it upon showEvent is too late)
     auto *placesModel = DolphinPlacesModelSingleton::instance().placesModel();
     setModel(placesModel);
@@ -83,6 +88,11 @@ PlacesPanel::PlacesPanel(QWidget *parent)
     for (int i = 0; i < model()->rowCount(); ++i) {
         connectDeviceSignals(model()->index(i, 0, QModelIndex()));
     }
+
+    // Capacity bars for the device entries, sourced asynchronously from the
+    // shared mount point observers so that a slow or dead mount never blocks
+    // the panel, see PlacesCapacityBarDelegate.
+    setItemDelegate(new PlacesCapacityBarDelegate(itemDelegate(), this));
 }
 
 PlacesPanel::~PlacesPanel() = default;
@@ -112,6 +122,20 @@ void PlacesPanel::proceedWithTearDown()
     }
 }
 
+QSize PlacesPanel::sizeHint() const
+{
+    QSize size = KFilePlacesView::sizeHint();
+
+    int snapshotTextWidth = 0;
+    for (const QString &text : m_snapshotPlaceTexts) {
+        snapshotTextWidth = qMax(snapshotTextWidth, fontMetrics().horizontalAdvance(text));
+    }
+    if (snapshotTextWidth > 0) {
+        size.setWidth(qMax(size.width(), qMax(iconSize().width(), 0) + snapshotTextWidth + fontMetrics().height()));
+    }
+    return size;
+}
+
 void PlacesPanel::readSettings()
 {
     if (GeneralSettings::autoExpandFolders()) {
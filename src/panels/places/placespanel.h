@@ -43,6 +43,14 @@ public:
     void requestTearDown();
     void proceedWithTearDown();
 
+    /**
+     * Like KFilePlacesView::sizeHint(), but never narrower than the places
+     * snapshot of the last session requires. The model confirms its device
+     * entries asynchronously, so the inherited hint starts out too narrow
+     * and would let the panel jump in width as devices trickle in.
+     */
+    QSize sizeHint() const override;
+
 public Q_SLOTS:
     void readSettings();
 
@@ -76,6 +84,9 @@ private:
     QAction *m_configureTrashAction;
     QAction *m_openInSplitView;
     QAction *m_lockPanelsAction;
+
+    // The entry texts of the last session, see sizeHint().
+    QStringList m_snapshotPlaceTexts;
 };
 
 #endif // PLACESPANEL_H
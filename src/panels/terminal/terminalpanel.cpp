@@ -7,6 +7,7 @@
 #include "terminalpanel.h"
 
 #include <KActionCollection>
+#include <KConfigGroup>
 #include <KIO/DesktopExecParser>
 #include <KIO/StatJob>
 #include <KJobWidgets>
@@ -17,6 +18,7 @@
 #include <KPluginFactory>
 #include <KProtocolInfo>
 #include <KShell>
+#include <KSharedConfig>
 #include <KXMLGUIBuilder>
 #include <KXMLGUIFactory>
 #include <kde_terminal_interface.h>
@@ -28,9 +30,27 @@
 #include <QTimer>
 #include <QVBoxLayout>
 
+namespace
+{
+/// Milliseconds to wait after a view URL change before the shell working
+/// directory is synchronized. Rapid navigation restarts the timer, so only
+/// the URL the user settles on reaches the shell.
+constexpr int ChangeDirDebounceInterval = 200;
+
+/// Milliseconds after construction before the Konsole KPart is pre-warmed
+/// for users who open the panel. Long enough that the startup and the
+/// initial directory listing are done by then, see preloadKonsolePart().
+constexpr int PreloadKonsolePartDelay = 3000;
+
+/// The state config group remembering whether this user opens the panel.
+const QLatin1String TerminalPanelStateGroup("TerminalPanel");
+const QLatin1String ShownBeforeEntry("ShownBefore");
+}
+
 TerminalPanel::TerminalPanel(QWidget *parent)
     : Panel(parent)
     , m_clearTerminal(true)
+    , m_shellSpawned(false)
     , m_mostLocalUrlJob(nullptr)
     , m_layout(nullptr)
     , m_terminal(nullptr)
@@ -43,6 +63,17 @@ TerminalPanel::TerminalPanel(QWidget *parent)
 {
     m_layout = new QVBoxLayout(this);
     m_layout->setContentsMargins(0, 0, 0, 0);
+
+    m_changeDirTimer = new QTimer(this);
+    m_changeDirTimer->setSingleShot(true);
+    m_changeDirTimer->setInterval(ChangeDirDebounceInterval);
+    connect(m_changeDirTimer, &QTimer::timeout, this, [this]() {
+        changeDir(url());
+    });
+
+    if (KConfigGroup(KSharedConfig::openStateConfig(), TerminalPanelStateGroup).readEntry(ShownBeforeEntry, false)) {
+        QTimer::singleShot(PreloadKonsolePartDelay, this, &TerminalPanel::preloadKonsolePart);
+    }
 }
 
 TerminalPanel::~TerminalPanel()
@@ -71,6 +102,7 @@ void TerminalPanel::terminalExited()
 {
     m_terminal = nullptr;
     m_konsolePart = nullptr;
+    m_shellSpawned = false;
     Q_EMIT hideTerminalPanel();
 }
 
@@ -86,7 +118,7 @@ void TerminalPanel::dockVisibilityChanged()
     if (isHiddenInVisibleWindow()) {
         if (m_konsolePartMissingMessage) {
             m_konsolePartMissingMessage->hide();
-        } else if (m_terminal && !hasProgramRunning()) {
+        } else if (m_terminal && m_shellSpawned && !hasProgramRunning()) {
             // Make sure that the following "cd /" command will not affect the view.
             disconnect(m_konsolePart, SIGNAL(currentDirectoryChanged(QString)), this, SLOT(slotKonsolePartCurrentDirectoryChanged(QString)));
 
@@ -135,12 +167,64 @@ bool TerminalPanel::urlChanged()
 
     const bool sendInput = m_terminal && !hasProgramRunning() && isVisible();
     if (sendInput) {
-        changeDir(url());
+        m_changeDirTimer->start();
     }
 
     return true;
 }
 
+bool TerminalPanel::loadKonsolePart()
+{
+    if (m_terminal) {
+        return true;
+    }
+
+    m_clearTerminal = true;
+    KPluginFactory *factory = KPluginFactory::loadFactory(KPluginMetaData(QStringLiteral("kf6/parts/konsolepart"))).plugin;
+    m_konsolePart = factory ? (factory->create<KParts::ReadOnlyPart>(this)) : nullptr;
+    if (!m_konsolePart) {
+        return false;
+    }
+
+    connect(m_konsolePart, &KParts::ReadOnlyPart::destroyed, this, &TerminalPanel::terminalExited);
+    m_terminalWidget = m_konsolePart->widget();
+    setFocusProxy(m_terminalWidget);
+    m_layout->addWidget(m_terminalWidget);
+    if (m_konsolePartMissingMessage) {
+        m_layout->removeWidget(m_konsolePartMissingMessage);
+    }
+    m_terminal = qobject_cast<TerminalInterface *>(m_konsolePart);
+
+    // needed to collect the correct KonsolePart actionCollection
+    // namely the one of the single inner terminal and not the outer KonsolePart
+    if (!m_konsolePart->factory() && m_terminalWidget) {
+        if (!m_konsolePart->clientBuilder()) {
+            m_konsolePart->setClientBuilder(new KXMLGUIBuilder(m_terminalWidget));
+        }
+
+        auto factory = new KXMLGUIFactory(m_konsolePart->clientBuilder(), this);
+        factory->addClient(m_konsolePart);
+
+        // Prevents the KXMLGui warning about removing the client
+        connect(m_terminalWidget, &QObject::destroyed, this, [factory, this] {
+            factory->removeClient(m_konsolePart);
+        });
+    }
+
+    return true;
+}
+
+void TerminalPanel::preloadKonsolePart()
+{
+    if (m_terminal || isVisible()) {
+        // A show has loaded the part in the meantime.
+        return;
+    }
+    // A failure to load is ignored here; the first actual show reports it
+    // through the "Konsole is not installed" message.
+    loadKonsolePart();
+}
+
 void TerminalPanel::showEvent(QShowEvent *event)
 {
     if (event->spontaneous()) {
@@ -148,37 +232,17 @@ void TerminalPanel::showEvent(QShowEvent *event)
         return;
     }
 
-    if (!m_terminal) {
-        m_clearTerminal = true;
-        KPluginFactory *factory = KPluginFactory::loadFactory(KPluginMetaData(QStringLiteral("kf6/parts/konsolepart"))).plugin;
-        m_konsolePart = factory ? (factory->create<KParts::ReadOnlyPart>(this)) : nullptr;
-        if (m_konsolePart) {
-            connect(m_konsolePart, &KParts::ReadOnlyPart::destroyed, this, &TerminalPanel::terminalExited);
-            m_terminalWidget = m_konsolePart->widget();
-            setFocusProxy(m_terminalWidget);
-            m_layout->addWidget(m_terminalWidget);
-            if (m_konsolePartMissingMessage) {
-                m_layout->removeWidget(m_konsolePartMissingMessage);
-            }
-            m_terminal = qobject_cast<TerminalInterface *>(m_konsolePart);
-
-            // needed to collect the correct KonsolePart actionCollection
-            // namely the one of the single inner terminal and not the outer KonsolePart
-            if (!m_konsolePart->factory() && m_terminalWidget) {
-                if (!m_konsolePart->clientBuilder()) {
-                    m_konsolePart->setClientBuilder(new KXMLGUIBuilder(m_terminalWidget));
-                }
-
-                auto factory = new KXMLGUIFactory(m_konsolePart->clientBuilder(), this);
-                factory->addClient(m_konsolePart);
-
-                // Prevents the KXMLGui warning about removing the client
-                connect(m_terminalWidget, &QObject::destroyed, this, [factory, this] {
-                    factory->removeClient(m_konsolePart);
-                });
-            }
+    {
+        // Remember that this user opens the panel, so the next session
+        // pre-warms the part, see preloadKonsolePart().
+        KConfigGroup stateConfig(KSharedConfig::openStateConfig(), TerminalPanelStateGroup);
+        if (!stateConfig.readEntry(ShownBeforeEntry, false)) {
+            stateConfig.writeEntry(ShownBeforeEntry, true);
+        }
+    }
 
-        } else {
+    if (!m_terminal) {
+        if (!loadKonsolePart()) {
             if (!m_konsolePartMissingMessage) {
                 const auto konsoleInstallUrl = QUrl("appstream://org.kde.konsole.desktop");
                 const auto konsoleNotInstalledText = i18n(
@@ -204,6 +268,7 @@ void TerminalPanel::showEvent(QShowEvent *event)
     }
     if (m_terminal) {
         m_terminal->showShellInDir(url().toLocalFile());
+        m_shellSpawned = true;
         if (!hasProgramRunning()) {
             changeDir(url());
         }
@@ -216,6 +281,8 @@ void TerminalPanel::showEvent(QShowEvent *event)
 
 void TerminalPanel::changeDir(const QUrl &url)
 {
+    m_changeDirTimer->stop();
+
     delete m_mostLocalUrlJob;
     m_mostLocalUrlJob = nullptr;
 
@@ -261,7 +328,7 @@ void TerminalPanel::sendCdToTerminal(const QString &dir, HistoryPolicy addToHist
     // user entered in the panel. Therefore, we have to remember 'dir'. Note that it could also be
     // a symbolic link -> remember the 'canonical' path.
     if (addToHistory == HistoryPolicy::AddToHistory)
-        m_sendCdToTerminalHistory.enqueue(QDir(dir).canonicalPath());
+        m_sendCdToTerminalHistory.enqueue(canonicalOrCleanPath(dir));
 
     m_terminal->sendInput(" cd " + KShell::quoteArg(dir) + '\r');
 
@@ -271,6 +338,20 @@ void TerminalPanel::sendCdToTerminal(const QString &dir, HistoryPolicy addToHist
     }
 }
 
+QString TerminalPanel::canonicalOrCleanPath(const QString &dir)
+{
+    const KMountPoint::Ptr mountPoint = KMountPoint::currentMountPoints().findByPath(dir);
+    if (mountPoint && mountPoint->probablySlow()) {
+        // QDir::canonicalPath() resolves symbolic links and therefore accesses
+        // the file system. On an unresponsive network mount this would block
+        // the GUI thread, so settle for lexical cleaning there. The cleaned
+        // path is only used to match the directory reported back by the
+        // terminal, which goes through the same function.
+        return QDir::cleanPath(dir);
+    }
+    return QDir(dir).canonicalPath();
+}
+
 void TerminalPanel::sendCdToTerminalKIOFuse(const QUrl &url)
 {
     // URL isn't local, only hope for the terminal to be in sync with the
@@ -302,7 +383,7 @@ void TerminalPanel::slotMostLocalUrlResult(KJob *job)
 
 void TerminalPanel::slotKonsolePartCurrentDirectoryChanged(const QString &dir)
 {
-    m_konsolePartCurrentDirectory = QDir(dir).canonicalPath();
+    m_konsolePartCurrentDirectory = canonicalOrCleanPath(dir);
 
     // Only emit a changeUrl signal if the directory change was caused by the user inside the
     // terminal, and not by sendCdToTerminal(QString).
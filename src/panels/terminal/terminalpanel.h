@@ -15,6 +15,7 @@
 class TerminalInterface;
 class KActionCollection;
 class KMessageWidget;
+class QTimer;
 class QVBoxLayout;
 class QWidget;
 
@@ -76,12 +77,42 @@ private Q_SLOTS:
 private:
     enum class HistoryPolicy { AddToHistory, SkipHistory };
 
+    /**
+     * Loads the Konsole KPart and embeds its widget into the panel layout.
+     * Pays for the library load and the profile parsing, but does not spawn
+     * a shell yet - that only happens when the panel is shown.
+     *
+     * @return whether the part is available afterwards.
+     */
+    bool loadKonsolePart();
+
+    /**
+     * Loads the Konsole KPart ahead of time when the user has opened the
+     * panel in an earlier session, so the first show of this session skips
+     * the library load and profile parsing. Scheduled from the constructor
+     * with a delay that keeps the load out of the startup path.
+     */
+    void preloadKonsolePart();
+
     void changeDir(const QUrl &url);
     void sendCdToTerminal(const QString &path, HistoryPolicy addToHistory = HistoryPolicy::AddToHistory);
     void sendCdToTerminalKIOFuse(const QUrl &url);
 
+    /**
+     * @return The canonical form of \p dir, or merely the cleaned path if
+     *         \p dir lies on a mount that is probably slow. Resolving
+     *         symbolic links on such mounts stats the directory and would
+     *         block the GUI thread when the mount is unresponsive.
+     */
+    static QString canonicalOrCleanPath(const QString &dir);
+
 private:
     bool m_clearTerminal;
+    /// Whether a shell has been started in the part. The part itself may
+    /// exist without one when it was merely pre-warmed, see
+    /// preloadKonsolePart(); no input must be sent to it before the first
+    /// show spawns the shell.
+    bool m_shellSpawned;
     KIO::StatJob *m_mostLocalUrlJob;
 
     QVBoxLayout *m_layout;
@@ -91,6 +122,10 @@ private:
     KParts::ReadOnlyPart *m_konsolePart;
     QString m_konsolePartCurrentDirectory;
     QQueue<QString> m_sendCdToTerminalHistory;
+
+    /// Debounces synchronizing the shell working directory with the view URL,
+    /// so that rapid navigation only sends a "cd" for the URL the user settles on.
+    QTimer *m_changeDirTimer;
     org::kde::KIOFuse::VFS m_kiofuseInterface;
 };
 
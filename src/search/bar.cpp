@@ -16,15 +16,20 @@
 #include "widgetmenu.h"
 
 #include "config-dolphin.h"
+#include <KConfigGroup>
 #include <KLocalizedString>
+#include <KSharedConfig>
 
 #include <QApplication>
+#include <QCompleter>
+#include <QElapsedTimer>
 #include <QHBoxLayout>
 #include <QIcon>
 #include <QKeyEvent>
 #include <QLineEdit>
 #include <QMenu>
 #include <QScrollArea>
+#include <QStringListModel>
 #include <QTimer>
 #include <QToolButton>
 
@@ -32,6 +37,15 @@ using namespace Search;
 
 namespace
 {
+/** How many previously committed search terms are kept for completion. */
+const int MaxSearchHistoryLength = 50;
+
+/** The lower and upper bound of the delay between the last keystroke and the start of a search. @see Bar::commitCurrentConfiguration(). */
+const int MinimumSearchDebounceMs = 200;
+const int MaximumSearchDebounceMs = 2000;
+/** How strongly the observed cost of starting a search scales the debounce delay for the next one. */
+const int SearchDebounceCostFactor = 10;
+
 /**
  * @see Bar::IsSearchConfigured().
  */
@@ -57,6 +71,14 @@ Bar::Bar(std::shared_ptr<const DolphinQuery> dolphinQuery, QWidget *parent)
     connect(m_searchTermEditor, &QLineEdit::textEdited, this, &Bar::slotSearchTermEdited);
     setFocusProxy(m_searchTermEditor);
 
+    // Completion from the search history, so re-running an expensive search from an earlier session only takes a few keystrokes.
+    m_searchHistoryModel = new QStringListModel{this};
+    m_searchHistoryModel->setStringList(KConfigGroup{KSharedConfig::openStateConfig(), QStringLiteral("SearchHistory")}.readEntry("Terms", QStringList{}));
+    auto searchHistoryCompleter = new QCompleter{m_searchHistoryModel, this};
+    searchHistoryCompleter->setCaseSensitivity(Qt::CaseInsensitive);
+    m_searchTermEditor->setCompleter(searchHistoryCompleter);
+    connect(searchHistoryCompleter, QOverload<const QString &>::of(&QCompleter::activated), this, &Bar::slotSearchTermEdited);
+
     // Add "Save search" button inside search box
     m_saveSearchAction = new QAction(this);
     m_saveSearchAction->setIcon(QIcon::fromTheme(QStringLiteral("document-save-symbolic")));
@@ -156,7 +178,7 @@ Bar::Bar(std::shared_ptr<const DolphinQuery> dolphinQuery, QWidget *parent)
         filterButton->text()));
 
     // The searching should be started automatically after the user did not change
-    // the text for a while
+    // the text for a while. The interval adapts to how expensive starting a search turned out to be. @see commitCurrentConfiguration().
     m_startSearchTimer = new QTimer(this);
     m_startSearchTimer->setSingleShot(true);
     m_startSearchTimer->setInterval(500);
@@ -255,6 +277,10 @@ void Bar::updateState(const std::shared_ptr<const DolphinQuery> &dolphinQuery)
             return chip;
         }
         if (chip) {
+            // Take the chip out of the layout and out of sight right away: deletion only happens once the event loop runs, and until then the layout would
+            // still place and paint the dying widget, which shows as a flicker when a facet is removed while typing.
+            chip->hide();
+            m_secondRowLayout->removeWidget(chip);
             chip->deleteLater();
         }
         return nullptr;
@@ -314,6 +340,9 @@ void Bar::slotSearchTermEdited(const QString &text)
 
 void Bar::slotReturnPressed()
 {
+    if (isSearchConfigured()) {
+        rememberSearchTerm();
+    }
     commitCurrentConfiguration();
     Q_EMIT focusViewRequest();
 }
@@ -327,7 +356,15 @@ void Bar::commitCurrentConfiguration()
         Q_EMIT urlChangeRequested(m_searchConfiguration->searchPath());
         return;
     }
+
+    // The time the view container spends synchronously on switching to the search URL — stopping the previous search, clearing or re-filtering the model,
+    // starting the new one — is a good proxy for how expensive queries against the current scope are. Scale the debounce of the next as-you-type search with
+    // it, so typing fast against a huge corpus does not stack canceled-but-started searches, while small directories keep reacting almost immediately.
+    QElapsedTimer startupCostTimer;
+    startupCostTimer.start();
     Q_EMIT urlChangeRequested(m_searchConfiguration->toUrl());
+    const int observedStartupCost = static_cast<int>(qMin(startupCostTimer.elapsed(), qint64(MaximumSearchDebounceMs)));
+    m_startSearchTimer->setInterval(qBound(MinimumSearchDebounceMs, observedStartupCost * SearchDebounceCostFactor, MaximumSearchDebounceMs));
 }
 
 void Bar::slotSaveSearch()
@@ -339,6 +376,24 @@ void Bar::slotSaveSearch()
     const QUrl searchUrl = m_searchConfiguration->toUrl();
     Q_ASSERT(searchUrl.isValid() && isSupportedSearchScheme(searchUrl.scheme()));
     DolphinPlacesModelSingleton::instance().placesModel()->addPlace(m_searchConfiguration->title(), searchUrl, QStringLiteral("folder-saved-search-symbolic"));
+    rememberSearchTerm();
+}
+
+void Bar::rememberSearchTerm()
+{
+    const QString searchTerm = m_searchConfiguration->searchTerm();
+    if (searchTerm.isEmpty()) {
+        return;
+    }
+    QStringList searchTerms = m_searchHistoryModel->stringList();
+    searchTerms.removeAll(searchTerm);
+    searchTerms.prepend(searchTerm);
+    while (searchTerms.count() > MaxSearchHistoryLength) {
+        searchTerms.removeLast();
+    }
+    m_searchHistoryModel->setStringList(searchTerms);
+    KConfigGroup searchHistoryConfig{KSharedConfig::openStateConfig(), QStringLiteral("SearchHistory")};
+    searchHistoryConfig.writeEntry("Terms", searchTerms);
 }
 
 bool Bar::isSearchConfigured() const
@@ -351,6 +406,11 @@ QString Bar::queryTitle() const
     return m_searchConfiguration->title();
 }
 
+void Bar::setFacetAggregator(const FacetAggregator *facetAggregator)
+{
+    m_popup->setFacetAggregator(facetAggregator);
+}
+
 int Bar::preferredHeight() const
 {
     return m_secondRowLayout->geometry().y() + m_secondRowLayout->sizeHint().height() + Dolphin::LAYOUT_SPACING_SMALL;
@@ -19,6 +19,7 @@
 class DolphinSearchBarTest;
 class QHBoxLayout;
 class QLineEdit;
+class QStringListModel;
 class QToolButton;
 class QVBoxLayout;
 
@@ -28,6 +29,7 @@ class BarSecondRowFlowLayout;
 template<class Selector>
 class Chip;
 class DateSelector;
+class FacetAggregator;
 class FileTypeSelector;
 class MinimumRatingSelector;
 class Popup;
@@ -95,6 +97,12 @@ public:
      */
     QString queryTitle() const;
 
+    /**
+     * Provides this bar with result counts per facet, so its selectors can hint how many of the current search results each facet value would keep.
+     * @see FacetAggregator.
+     */
+    void setFacetAggregator(const FacetAggregator *facetAggregator);
+
 Q_SIGNALS:
     /**
      * This signals a request for the attached view container to switch to @p url.
@@ -168,6 +176,12 @@ private Q_SLOTS:
     void slotSaveSearch();
 
 private:
+    /**
+     * Adds the current search term to the persistent search history so it can be completed quickly in the future, including in later sessions. Only called
+     * when the user explicitly commits a search, so half-typed terms do not clutter the history.
+     */
+    void rememberSearchTerm();
+
     /**
      * This Search::Bar always represents a search configuration. This method takes a new @p dolphinQuery i.e. search configuration and updates itself and all
      * child widgets to match it. This way the user always knows which search parameters lead to the query results that appear in the view.
@@ -198,6 +212,9 @@ private:
     /// Starts a new search when the user has finished typing the search term.
     QTimer *m_startSearchTimer = nullptr;
 
+    /// Previously committed search terms, most recent first. Backs the completer of the search field and is persisted across sessions.
+    QStringListModel *m_searchHistoryModel = nullptr;
+
     friend DolphinSearchBarTest;
 };
 
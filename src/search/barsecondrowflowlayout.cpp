@@ -73,6 +73,11 @@ void BarSecondRowFlowLayout::setGeometry(const QRect &rect)
     int x = rect.left();
     int y = rect.top();
 
+    // All target geometries are planned first and applied in one pass at the end. Widgets of a row used to be placed and then translated again for the
+    // alignment, so every chip received two move events per relayout; with a query mutation per keystroke that made the whole second row repaint repeatedly.
+    // Now each widget is moved at most once per relayout, and not at all when its geometry did not change.
+    std::vector<QRect> plannedGeometries(count());
+
     /// The search location buttons are treated differently. They are meant to be in the same row and aligned the other way.
     int totalLocationButtonWidth = 0;
     for (int i = 0; i < searchLocationButtonsCount; i++) {
@@ -81,55 +86,59 @@ void BarSecondRowFlowLayout::setGeometry(const QRect &rect)
     if (totalLocationButtonWidth > rect.width()) {
         /// There is not enough space so we will smush all the location buttons into the first row.
         for (int i = 0; i < searchLocationButtonsCount; i++) {
-            QWidget *widget = itemAt(i)->widget();
-            const int targetWidth = qMin(widget->sizeHint().width(), rect.width() / searchLocationButtonsCount);
-            widget->setGeometry(isLeftToRight ? x : rect.right() - x - targetWidth, y, targetWidth, widget->sizeHint().height());
-            x += widget->width();
+            const QSize preferredSize = itemAt(i)->widget()->sizeHint();
+            const int targetWidth = qMin(preferredSize.width(), rect.width() / searchLocationButtonsCount);
+            plannedGeometries[i] = QRect{isLeftToRight ? x : rect.right() - x - targetWidth, y, targetWidth, preferredSize.height()};
+            x += targetWidth;
         }
     } else {
         for (int i = 0; i < searchLocationButtonsCount; i++) {
-            QWidget *widget = itemAt(i)->widget();
-            QSize preferredSize = widget->sizeHint();
-            widget->setGeometry(isLeftToRight ? x : rect.right() - x - preferredSize.width(), y, preferredSize.width(), preferredSize.height());
-            x += widget->width() + spacing();
+            const QSize preferredSize = itemAt(i)->widget()->sizeHint();
+            plannedGeometries[i] = QRect{isLeftToRight ? x : rect.right() - x - preferredSize.width(), y, preferredSize.width(), preferredSize.height()};
+            x += preferredSize.width() + spacing();
         }
     }
 
-    // We want to align all further widgets the other way. We do this by first filling up the row like usual and then moving all widgets of the current row by
-    // the remaining space.
-    std::vector<QWidget *> currentRowWidgets;
+    // We want to align all further widgets the other way. We do this by first filling up the row like usual and then moving the planned geometries of the
+    // current row by the remaining space.
+    std::vector<int> currentRowIndexes;
     for (int i = searchLocationButtonsCount; i < count(); i++) {
-        QWidget *widget = itemAt(i)->widget();
+        const QSize preferredSize = itemAt(i)->widget()->sizeHint();
         const int remainingSpace = rect.right() - x + spacing();
-        if (widget->sizeHint().width() < remainingSpace) {
-            QSize preferredSize = widget->sizeHint();
-            widget->setGeometry(isLeftToRight ? x : rect.right() - x - preferredSize.width(), y, preferredSize.width(), preferredSize.height());
-            x += widget->width() + spacing();
-            currentRowWidgets.push_back(widget);
+        if (preferredSize.width() < remainingSpace) {
+            plannedGeometries[i] = QRect{isLeftToRight ? x : rect.right() - x - preferredSize.width(), y, preferredSize.width(), preferredSize.height()};
+            x += preferredSize.width() + spacing();
+            currentRowIndexes.push_back(i);
             continue;
         }
 
         // There is not enough space for the next widget. We need to open up a new row.
         // Right align all the widgets of the previous row.
-        for (QWidget *widget : std::as_const(currentRowWidgets)) {
-            widget->setGeometry(widget->geometry().translated(isLeftToRight ? remainingSpace : -remainingSpace, 0));
+        for (int rowIndex : std::as_const(currentRowIndexes)) {
+            plannedGeometries[rowIndex].translate(isLeftToRight ? remainingSpace : -remainingSpace, 0);
         }
-        currentRowWidgets.clear();
+        currentRowIndexes.clear();
 
         x = 0;
-        y += itemAt(i - 1)->widget()->height() + spacing();
+        y += plannedGeometries[i - 1].height() + spacing();
 
-        QSize preferredSize = widget->sizeHint();
         const int targetWidth = qMin(preferredSize.width(), rect.width());
-        widget->setGeometry(isLeftToRight ? x : rect.right() - x - targetWidth, y, targetWidth, preferredSize.height());
-        x += widget->width() + spacing();
-        currentRowWidgets.push_back(widget);
+        plannedGeometries[i] = QRect{isLeftToRight ? x : rect.right() - x - targetWidth, y, targetWidth, preferredSize.height()};
+        x += targetWidth + spacing();
+        currentRowIndexes.push_back(i);
     }
 
     // Right align all the widgets of the previous row.
-    int remainingSpace = rect.right() - x + spacing();
-    for (QWidget *widget : std::as_const(currentRowWidgets)) {
-        widget->setGeometry(widget->geometry().translated(isLeftToRight ? remainingSpace : -remainingSpace, 0));
+    const int remainingSpace = rect.right() - x + spacing();
+    for (int rowIndex : std::as_const(currentRowIndexes)) {
+        plannedGeometries[rowIndex].translate(isLeftToRight ? remainingSpace : -remainingSpace, 0);
+    }
+
+    for (int i = 0; i < count(); i++) {
+        QWidget *widget = itemAt(i)->widget();
+        if (widget->geometry() != plannedGeometries[i]) {
+            widget->setGeometry(plannedGeometries[i]);
+        }
     }
 
     if (sizeHint().height() != oldHeightHint) {
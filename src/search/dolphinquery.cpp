@@ -17,6 +17,7 @@
 #include <KLocalizedString>
 #include <KShell>
 
+#include <QCache>
 #include <QRegularExpression>
 #include <QUrlQuery>
 
@@ -126,6 +127,28 @@ QString trimChar(const QString &text, const QLatin1Char aChar)
 }
 
 Search::DolphinQuery::DolphinQuery(const QUrl &url, const QUrl &backupSearchPath)
+{
+    if (!isSupportedSearchScheme(url.scheme())) {
+        initializeFromUrl(url, backupSearchPath);
+        return;
+    }
+
+    // Search URLs are parsed over and over: every keystroke in the search bar round-trips through toUrl() and back, and re-opening a search from the history
+    // or the Places panel parses the very same URL again. A small cache of already parsed queries lets all of these skip the parsing entirely.
+    // The key includes the saved search preferences because the parsed result can depend on them.
+    static QCache<QString, DolphinQuery> parsedQueryCache{50};
+    const QString cacheKey = url.toString() + QLatin1Char('\n') + backupSearchPath.toString() + QLatin1Char('\n') + SearchSettings::location()
+        + QLatin1Char('\n') + SearchSettings::what() + QLatin1Char('\n') + SearchSettings::searchTool();
+    if (const DolphinQuery *parsedQuery = parsedQueryCache.object(cacheKey)) {
+        *this = *parsedQuery;
+        return;
+    }
+
+    initializeFromUrl(url, backupSearchPath);
+    parsedQueryCache.insert(cacheKey, new DolphinQuery(*this));
+}
+
+void DolphinQuery::initializeFromUrl(const QUrl &url, const QUrl &backupSearchPath)
 {
     if (url.scheme() == QLatin1String("filenamesearch")) {
         m_searchTool = SearchTool::Filenamesearch;
@@ -172,6 +195,14 @@ Search::DolphinQuery::DolphinQuery(const QUrl &url, const QUrl &backupSearchPath
 }
 
 QUrl DolphinQuery::toUrl() const
+{
+    if (!m_cachedSearchUrl.has_value()) {
+        m_cachedSearchUrl = buildSearchUrl();
+    }
+    return m_cachedSearchUrl.value();
+}
+
+QUrl DolphinQuery::buildSearchUrl() const
 {
     // The following pre-conditions are sanity checks on this DolphinQuery object. If they fail, the issue is that we ever allowed the DolphinQuery to be in an
     // inconsistent state to begin with. This should be fixed by bringing this DolphinQuery object into a reasonable state at the end of the constructors or
@@ -252,22 +283,35 @@ QUrl DolphinQuery::toUrl() const
 
 void DolphinQuery::setSearchLocations(SearchLocations searchLocations)
 {
+    invalidateCaches();
     m_searchLocations = searchLocations;
     switchToPreferredSearchTool();
 }
 
 void DolphinQuery::setSearchPath(const QUrl &searchPath)
 {
+    invalidateCaches();
     m_searchPath = searchPath;
     switchToPreferredSearchTool();
 }
 
 void DolphinQuery::setSearchThrough(SearchThrough searchThrough)
 {
+    invalidateCaches();
     m_searchThrough = searchThrough;
     switchToPreferredSearchTool();
 }
 
+bool DolphinQuery::operator==(const DolphinQuery &other) const
+{
+    // The memoized URL and title are deliberately not compared: two queries with identical search parameters are the same search, no matter which of the two
+    // has already been exported or titled.
+    return m_searchLocations == other.m_searchLocations && m_searchPath == other.m_searchPath && m_searchThrough == other.m_searchThrough
+        && m_searchTool == other.m_searchTool && m_searchTerm == other.m_searchTerm && m_fileType == other.m_fileType
+        && m_modifiedSinceDate == other.m_modifiedSinceDate && m_minimumRating == other.m_minimumRating && m_requiredTags == other.m_requiredTags
+        && m_unrecognizedBalooQueryStrings == other.m_unrecognizedBalooQueryStrings;
+}
+
 void DolphinQuery::switchToPreferredSearchTool()
 {
     const bool isIndexingEnabledInCurrentSearchLocation = m_searchLocations == SearchLocations::Everywhere || isIndexingEnabledIn(m_searchPath);
@@ -355,6 +399,14 @@ void DolphinQuery::initializeFromBalooQuery(const Baloo::Query &balooQuery, cons
 #endif // HAVE_BALOO
 
 QString DolphinQuery::title() const
+{
+    if (!m_cachedTitle.has_value()) {
+        m_cachedTitle = buildTitle();
+    }
+    return m_cachedTitle.value();
+}
+
+QString DolphinQuery::buildTitle() const
 {
     if (m_searchLocations == SearchLocations::FromHere) {
         QString prettySearchLocation;
@@ -17,6 +17,8 @@
 #include <QString>
 #include <QUrl>
 
+#include <optional>
+
 #if HAVE_BALOO
 namespace Baloo
 {
@@ -97,6 +99,7 @@ public:
     /**
      * @returns a representation of this DolphinQuery as a QUrl. This QUrl can be opened in Dolphin to trigger a search that is identical to the conditions
      *          provided by this DolphinQuery object.
+     * The URL is only built on the first call and whenever a search parameter changed since the last call; repeated calls return the cached result.
      */
     QUrl toUrl() const;
 
@@ -134,6 +137,7 @@ public:
      */
     inline void setSearchTool(SearchTool searchTool)
     {
+        invalidateCaches();
         m_searchTool = searchTool;
         // We do not remove any search parameters here, even if the new search tool does not support them. This is an attempt to avoid that we unnecessarily
         // throw away configuration data. Non-applicable search parameters will be lost when exporting this DolphinQuery to a URL,
@@ -151,6 +155,7 @@ public:
      */
     inline void setSearchTerm(const QString &searchTerm)
     {
+        invalidateCaches();
         m_searchTerm = searchTerm;
     };
     /** @return the search text the user entered into the search field. */
@@ -164,6 +169,7 @@ public:
      */
     inline void setFileType(const KFileMetaData::Type::Type &fileType)
     {
+        invalidateCaches();
         m_fileType = fileType;
     };
     /**
@@ -179,6 +185,7 @@ public:
      */
     inline void setModifiedSinceDate(const QDate &modifiedLaterThanDate)
     {
+        invalidateCaches();
         m_modifiedSinceDate = modifiedLaterThanDate;
     };
     /**
@@ -195,6 +202,7 @@ public:
      */
     inline void setMinimumRating(int minimumRating)
     {
+        invalidateCaches();
         m_minimumRating = minimumRating;
     };
     /**
@@ -211,6 +219,7 @@ public:
      */
     inline void setRequiredTags(const QStringList &requiredTags)
     {
+        invalidateCaches();
         m_requiredTags = requiredTags;
     };
     /**
@@ -221,19 +230,37 @@ public:
         return m_requiredTags;
     };
 
-    bool operator==(const DolphinQuery &) const = default;
+    /** Two DolphinQuery objects are equal if all their search parameters are equal. The memoization caches are ignored. */
+    bool operator==(const DolphinQuery &other) const;
 
     /**
      * @returns a title to be used in user-facing situations to represent this DolphinQuery, such as "Query Results from 'importantFile'".
+     * The title is only built on the first call and whenever a search parameter changed since the last call; repeated calls return the cached result.
      */
     QString title() const;
 
 private:
+    /** Parses the @p url and initializes all search parameters from it. Contains the actual constructor logic. @see DolphinQuery(). */
+    void initializeFromUrl(const QUrl &url, const QUrl &backupSearchPath);
+
 #if HAVE_BALOO
     /** Parses a Baloo::Query to extract its separate components */
     void initializeFromBalooQuery(const Baloo::Query &balooQuery, const QUrl &backupSearchPath);
 #endif
 
+    /** Builds the search URL returned by toUrl(). Only called when no up-to-date memoized URL exists. */
+    QUrl buildSearchUrl() const;
+
+    /** Builds the title returned by title(). Only called when no up-to-date memoized title exists. */
+    QString buildTitle() const;
+
+    /** Drops the memoized results of toUrl() and title(). Every change to a search parameter needs to call this. */
+    inline void invalidateCaches()
+    {
+        m_cachedSearchUrl.reset();
+        m_cachedTitle.reset();
+    };
+
     /**
      * Switches to the user's preferred search tool if this is possible. If the preferred search tool cannot perform a search within this DolphinQuery's
      * conditions, a different search tool will be used instead.
@@ -287,6 +314,14 @@ private:
      */
     QStringList m_unrecognizedBalooQueryStrings;
 
+    /**
+     * The memoized results of toUrl() and title(). Both are rebuilt at most once after a search parameter changed, so the search bar can call them freely
+     * while the user interacts with it. They are not part of the search configuration itself, which is why operator==() ignores them.
+     * @see invalidateCaches().
+     */
+    mutable std::optional<QUrl> m_cachedSearchUrl;
+    mutable std::optional<QString> m_cachedTitle;
+
     friend DolphinQueryTest;
 };
 
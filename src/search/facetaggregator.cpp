@@ -0,0 +1,219 @@
+/*
+    SPDX-FileCopyrightText: 2026 The Dolphin Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "facetaggregator.h"
+
+#include "kitemviews/kfileitemmodel.h"
+
+#include <QMimeType>
+
+using namespace Search;
+
+namespace
+{
+/**
+ * @returns whether @p url shows search results. Mirrors Search::isSupportedSearchScheme(), which cannot be linked from here because DolphinQuery is part of
+ * the application and not of this library.
+ */
+bool isSearchUrl(const QUrl &url)
+{
+    const QString scheme = url.scheme();
+    return scheme == QLatin1String("filenamesearch") || scheme == QLatin1String("baloosearch") || scheme == QLatin1String("tags");
+}
+
+/**
+ * @returns the KFileMetaData type the @p item would be found under.
+ * This mapping is heuristic: it relies on the cheap name-based MIME type so aggregating a batch of streamed results never touches file contents. Items that do
+ * not clearly belong to one of the types count towards KFileMetaData::Type::Empty.
+ */
+KFileMetaData::Type::Type typeOfItem(const KFileItem &item)
+{
+    if (item.isDir()) {
+        return KFileMetaData::Type::Folder;
+    }
+
+    const QMimeType mimeType = item.currentMimeType();
+    const QString mimeTypeName = mimeType.name();
+    if (mimeTypeName.startsWith(QLatin1String("audio/"))) {
+        return KFileMetaData::Type::Audio;
+    }
+    if (mimeTypeName.startsWith(QLatin1String("image/"))) {
+        return KFileMetaData::Type::Image;
+    }
+    if (mimeTypeName.startsWith(QLatin1String("video/"))) {
+        return KFileMetaData::Type::Video;
+    }
+    if (mimeTypeName.startsWith(QLatin1String("text/"))) {
+        return KFileMetaData::Type::Text;
+    }
+
+    static const struct {
+        const char *mimeTypeName;
+        KFileMetaData::Type::Type type;
+    } mimeTypeParents[] = {
+        {"application/pdf", KFileMetaData::Type::Document},
+        {"application/vnd.oasis.opendocument.text", KFileMetaData::Type::Document},
+        {"application/vnd.openxmlformats-officedocument.wordprocessingml.document", KFileMetaData::Type::Document},
+        {"application/vnd.oasis.opendocument.spreadsheet", KFileMetaData::Type::Spreadsheet},
+        {"application/vnd.openxmlformats-officedocument.spreadsheetml.sheet", KFileMetaData::Type::Spreadsheet},
+        {"application/vnd.oasis.opendocument.presentation", KFileMetaData::Type::Presentation},
+        {"application/vnd.openxmlformats-officedocument.presentationml.presentation", KFileMetaData::Type::Presentation},
+        {"application/zip", KFileMetaData::Type::Archive},
+        {"application/x-tar", KFileMetaData::Type::Archive},
+        {"application/x-7z-compressed", KFileMetaData::Type::Archive},
+        {"application/vnd.rar", KFileMetaData::Type::Archive},
+        {"application/gzip", KFileMetaData::Type::Archive},
+    };
+    for (const auto &mimeTypeParent : mimeTypeParents) {
+        if (mimeType.inherits(QLatin1String(mimeTypeParent.mimeTypeName))) {
+            return mimeTypeParent.type;
+        }
+    }
+    return KFileMetaData::Type::Empty;
+}
+
+/** @returns the individual tags of the joined "tags" role value @p tagsRoleValue. @see KBalooRolesProvider. */
+QStringList tagsOfRoleValue(const QString &tagsRoleValue)
+{
+    return tagsRoleValue.split(QLatin1String(", "), Qt::SkipEmptyParts);
+}
+}
+
+FacetAggregator::FacetAggregator(KFileItemModel *model, QObject *parent)
+    : QObject{parent}
+    , m_model{model}
+{
+    connect(m_model, &KFileItemModel::itemsInserted, this, &FacetAggregator::slotItemsInserted);
+    connect(m_model, &KFileItemModel::itemsRemoved, this, &FacetAggregator::slotItemsRemoved);
+    connect(m_model, &KFileItemModel::itemsChanged, this, &FacetAggregator::slotItemsChanged);
+    connect(m_model, &KFileItemModel::directoryLoadingStarted, this, &FacetAggregator::slotDirectoryLoadingStarted);
+
+    m_active = isSearchUrl(m_model->directory());
+    if (m_active) {
+        rebuild();
+    }
+}
+
+bool FacetAggregator::isActive() const
+{
+    return m_active;
+}
+
+int FacetAggregator::totalCount() const
+{
+    return m_totalCount;
+}
+
+int FacetAggregator::countForFileType(KFileMetaData::Type::Type fileType) const
+{
+    if (fileType < 0 || fileType > KFileMetaData::Type::LastType) {
+        return 0;
+    }
+    return m_fileTypeCounts[fileType];
+}
+
+int FacetAggregator::countOfItemsModifiedSince(const QDate &date) const
+{
+    int count = 0;
+    for (auto it = m_modifiedDateCounts.lowerBound(date); it != m_modifiedDateCounts.constEnd(); ++it) {
+        count += it.value();
+    }
+    return count;
+}
+
+int FacetAggregator::countForTag(const QString &tag) const
+{
+    if (m_tagCountsDirty) {
+        m_tagCounts.clear();
+        for (int i = 0; i < m_model->count(); ++i) {
+            const QStringList tags = tagsOfRoleValue(m_model->data(i).value("tags").toString());
+            for (const QString &itemTag : tags) {
+                ++m_tagCounts[itemTag];
+            }
+        }
+        m_tagCountsDirty = false;
+    }
+    return m_tagCounts.value(tag, 0);
+}
+
+void FacetAggregator::slotItemsInserted(const KItemRangeList &itemRanges)
+{
+    if (!m_active) {
+        return;
+    }
+    for (const KItemRange &itemRange : itemRanges) {
+        for (int i = itemRange.index; i < itemRange.index + itemRange.count; ++i) {
+            addItemAt(i);
+        }
+    }
+    Q_EMIT countsChanged();
+}
+
+void FacetAggregator::slotItemsRemoved(const KItemRangeList &itemRanges)
+{
+    Q_UNUSED(itemRanges)
+    if (!m_active) {
+        return;
+    }
+    // The removed items can no longer be queried for their facet values, so the histograms are rebuilt from what is left in the model. Removals are rare while
+    // a search is streaming in; they mostly happen when a search is narrowed, which shrinks the model and therefore the cost of this rebuild as well.
+    rebuild();
+    Q_EMIT countsChanged();
+}
+
+void FacetAggregator::slotItemsChanged(const KItemRangeList &itemRanges, const QSet<QByteArray> &roles)
+{
+    Q_UNUSED(itemRanges)
+    if (!m_active || !roles.contains(QByteArrayLiteral("tags"))) {
+        return;
+    }
+    // Changed items do not report their previous tags, so incremental updating is impossible. The rebuild is deferred until a count is actually requested.
+    m_tagCountsDirty = true;
+    Q_EMIT countsChanged();
+}
+
+void FacetAggregator::slotDirectoryLoadingStarted()
+{
+    m_active = isSearchUrl(m_model->directory());
+    clear();
+    if (m_active) {
+        // A narrowed search keeps its current results in the model and only removes the items which no longer match, so whatever is in the model at this
+        // point belongs to the new search.
+        rebuild();
+    }
+    Q_EMIT countsChanged();
+}
+
+void FacetAggregator::addItemAt(int index)
+{
+    const KFileItem item = m_model->fileItem(index);
+    ++m_totalCount;
+    ++m_fileTypeCounts[typeOfItem(item)];
+    const QDate modifiedDate = item.time(KFileItem::ModificationTime).date();
+    if (modifiedDate.isValid()) {
+        ++m_modifiedDateCounts[modifiedDate];
+    }
+    m_tagCountsDirty = true;
+}
+
+void FacetAggregator::rebuild()
+{
+    clear();
+    for (int i = 0; i < m_model->count(); ++i) {
+        addItemAt(i);
+    }
+}
+
+void FacetAggregator::clear()
+{
+    m_totalCount = 0;
+    m_fileTypeCounts.fill(0);
+    m_modifiedDateCounts.clear();
+    m_tagCounts.clear();
+    m_tagCountsDirty = false;
+}
+
+#include "moc_facetaggregator.cpp"
@@ -0,0 +1,101 @@
+/*
+    SPDX-FileCopyrightText: 2026 The Dolphin Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef FACETAGGREGATOR_H
+#define FACETAGGREGATOR_H
+
+#include "dolphin_export.h"
+#include "kitemviews/kitemrange.h"
+
+#include <KFileMetaData/Types>
+
+#include <QDate>
+#include <QHash>
+#include <QMap>
+#include <QObject>
+
+#include <array>
+
+class KFileItemModel;
+
+namespace Search
+{
+
+/**
+ * @brief Incrementally computed facet histograms over streamed search results.
+ *
+ * The selectors in the search user interface (@see FileTypeSelector etc.) can hint how many of the current search results each facet value would keep, e.g.
+ * "Image (12,430)". Computing such counts on demand would require a pass over the complete result set for every hint, so this aggregator instead observes the
+ * KFileItemModel which receives the search results and updates its histograms while results stream in. The selectors can then query the counts in O(1).
+ *
+ * The aggregator only collects data while the observed model shows search results. For normal directories it stays empty so browsing does not pay for it.
+ */
+class DOLPHIN_EXPORT FacetAggregator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FacetAggregator(KFileItemModel *model, QObject *parent = nullptr);
+
+    /** @returns whether the observed model currently shows search results, i.e. whether the counts below carry any meaning. */
+    bool isActive() const;
+
+    /** @returns the number of search results aggregated so far. */
+    int totalCount() const;
+
+    /** @returns how many of the current search results have the given @p fileType. The mapping from MIME type to @p fileType is heuristic. */
+    int countForFileType(KFileMetaData::Type::Type fileType) const;
+
+    /** @returns how many of the current search results were modified on or after @p date. Costs one walk over the distinct modification days seen so far. */
+    int countOfItemsModifiedSince(const QDate &date) const;
+
+    /**
+     * @returns how many of the current search results carry the tag @p tag. Tags are only known for items whose "tags" role the model has already resolved,
+     *          so this count can grow as metadata arrives.
+     */
+    int countForTag(const QString &tag) const;
+
+Q_SIGNALS:
+    /** Is emitted whenever the histograms changed, so hints showing counts can update themselves. Emitted at most once per model update batch. */
+    void countsChanged();
+
+private Q_SLOTS:
+    void slotItemsInserted(const KItemRangeList &itemRanges);
+    void slotItemsRemoved(const KItemRangeList &itemRanges);
+    void slotItemsChanged(const KItemRangeList &itemRanges, const QSet<QByteArray> &roles);
+    void slotDirectoryLoadingStarted();
+
+private:
+    /** Adds the item at model index @p index to all histograms. */
+    void addItemAt(int index);
+
+    /** Drops all histograms and re-adds every item of the model. Used after removals because the removed items can no longer be queried. */
+    void rebuild();
+
+    /** Empties all histograms. */
+    void clear();
+
+private:
+    KFileItemModel *m_model = nullptr;
+    /** Whether the observed model currently shows search results. Updated whenever a new directory loading starts. */
+    bool m_active = false;
+
+    int m_totalCount = 0;
+    /** One count per KFileMetaData::Type value, indexed by the type. */
+    std::array<int, KFileMetaData::Type::LastType + 1> m_fileTypeCounts{};
+    /** Counts of results per modification day. A QMap so countOfItemsModifiedSince() can sum a sorted tail. */
+    QMap<QDate, int> m_modifiedDateCounts;
+    /**
+     * Counts of results per tag. Tag data arrives asynchronously through the "tags" role, and changed items do not report their previous tags, so this
+     * histogram is rebuilt lazily from the model when @see m_tagCountsDirty is set instead of being updated incrementally.
+     */
+    mutable QHash<QString, int> m_tagCounts;
+    mutable bool m_tagCountsDirty = false;
+};
+
+}
+
+#endif // FACETAGGREGATOR_H
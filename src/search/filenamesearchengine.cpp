@@ -0,0 +1,302 @@
+/*
+    SPDX-FileCopyrightText: 2026 The Dolphin Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "filenamesearchengine.h"
+
+#include <QDirIterator>
+#include <QMutex>
+#include <QThread>
+#include <QUrlQuery>
+#include <QWaitCondition>
+
+using namespace Search;
+
+namespace
+{
+// Number of matches that are collected per worker thread before they are
+// pushed to the model. Batches keep the per-item signal overhead low while
+// results still stream in visibly during a long walk.
+constexpr int ResultBatchSize = 200;
+}
+
+struct FilenameSearchEngine::WalkerState {
+    QMutex mutex;
+    QWaitCondition workAvailable;
+    /** Directories that still need to be walked. Workers take from the back
+     * and steal from it when their own directory yielded no children. */
+    QStringList pendingDirectories;
+    /** Number of workers currently walking a directory. While this is not
+     * zero, new pending directories may still appear. */
+    int busyWorkers = 0;
+    /** Number of workers that have not exited their loop yet. The last one
+     * to leave reports the completion. */
+    int activeWorkers = 0;
+    QAtomicInt stopped;
+    /** The directory the walk started in. @see skipRootEntries. */
+    QString rootPath;
+    /** Whether entries directly inside rootPath are left out of the results. @see FilenameSearchEngine::setSkipRootDirectoryEntries(). */
+    bool skipRootEntries = false;
+    /** The pattern the workers match against. Workers snapshot it per
+     * directory under the mutex; refine() narrows it while they run. */
+    QRegularExpression namePattern;
+};
+
+namespace
+{
+/** @returns the decoded search term of the "filenamesearch" URL @p searchUrl. */
+QString searchTermOfUrl(const QUrl &searchUrl)
+{
+    return QUrlQuery(searchUrl).queryItemValue(QStringLiteral("search"), QUrl::FullyDecoded);
+}
+
+/** @returns the pattern matching every file name that contains @p searchTerm, honoring wildcards. */
+QRegularExpression namePatternForTerm(const QString &searchTerm)
+{
+    return QRegularExpression(QRegularExpression::wildcardToRegularExpression(QLatin1Char('*') + searchTerm + QLatin1Char('*')),
+                              QRegularExpression::CaseInsensitiveOption);
+}
+}
+
+FilenameSearchEngine::FilenameSearchEngine(const QUrl &searchUrl, QObject *parent)
+    : QObject(parent)
+    , m_searchUrl(searchUrl)
+{
+    Q_ASSERT(canSearch(searchUrl));
+
+    const QUrlQuery query(searchUrl);
+    const QString searchPathString = query.queryItemValue(QStringLiteral("url"), QUrl::FullyDecoded);
+    m_rootPath = QUrl::fromUserInput(searchPathString, QString(), QUrl::AssumeLocalFile).toLocalFile();
+
+    // Like the "filenamesearch" KIO worker, a name matches when it contains
+    // the search term, and wildcards in the term are honored.
+    m_searchTerm = searchTermOfUrl(searchUrl);
+    m_namePattern = namePatternForTerm(m_searchTerm);
+}
+
+FilenameSearchEngine::~FilenameSearchEngine()
+{
+    stop();
+    m_pool.waitForDone();
+}
+
+bool FilenameSearchEngine::canSearch(const QUrl &searchUrl)
+{
+    if (searchUrl.scheme() != QLatin1String("filenamesearch")) {
+        return false;
+    }
+
+    const QUrlQuery query(searchUrl);
+    if (query.queryItemValue(QStringLiteral("checkContent")) == QLatin1String("yes")) {
+        // Searching through file contents stays with the KIO worker.
+        return false;
+    }
+
+    const QString searchPathString = query.queryItemValue(QStringLiteral("url"), QUrl::FullyDecoded);
+    const QUrl searchPath = QUrl::fromUserInput(searchPathString, QString(), QUrl::AssumeLocalFile);
+    return searchPath.isLocalFile();
+}
+
+QUrl FilenameSearchEngine::url() const
+{
+    return m_searchUrl;
+}
+
+QString FilenameSearchEngine::rootPath() const
+{
+    return m_rootPath;
+}
+
+void FilenameSearchEngine::setSkipRootDirectoryEntries(bool skip)
+{
+    Q_ASSERT_X(!m_state, "FilenameSearchEngine::setSkipRootDirectoryEntries()", "May only be called before the search is started.");
+    m_skipRootDirectoryEntries = skip;
+}
+
+bool FilenameSearchEngine::refine(const QUrl &searchUrl)
+{
+    if (!canSearch(searchUrl)) {
+        return false;
+    }
+
+    const QUrlQuery query(searchUrl);
+    const QString searchPathString = query.queryItemValue(QStringLiteral("url"), QUrl::FullyDecoded);
+    if (QUrl::fromUserInput(searchPathString, QString(), QUrl::AssumeLocalFile).toLocalFile() != m_rootPath) {
+        return false;
+    }
+
+    const QString searchTerm = searchTermOfUrl(searchUrl);
+    if (searchTerm.contains(QLatin1Char('*')) || searchTerm.contains(QLatin1Char('?')) || m_searchTerm.contains(QLatin1Char('*'))
+        || m_searchTerm.contains(QLatin1Char('?'))) {
+        // With wildcards involved, extending the term does not imply that the
+        // new matches are a subset of the current ones.
+        return false;
+    }
+    if (!searchTerm.contains(m_searchTerm, Qt::CaseInsensitive)) {
+        return false;
+    }
+
+    m_searchUrl = searchUrl;
+    m_searchTerm = searchTerm;
+    m_namePattern = namePatternForTerm(searchTerm);
+    if (m_state) {
+        QMutexLocker locker(&m_state->mutex);
+        m_state->namePattern = m_namePattern;
+    }
+    return true;
+}
+
+bool FilenameSearchEngine::matchesName(const QString &name) const
+{
+    return m_namePattern.match(name).hasMatch();
+}
+
+bool FilenameSearchEngine::isRunning() const
+{
+    return m_running;
+}
+
+void FilenameSearchEngine::start()
+{
+    Q_ASSERT_X(!m_state, "FilenameSearchEngine::start()", "An engine instance may only be started once.");
+
+    m_state = std::make_shared<WalkerState>();
+    m_state->pendingDirectories.append(m_rootPath);
+    m_state->namePattern = m_namePattern;
+    m_state->rootPath = m_rootPath;
+    m_state->skipRootEntries = m_skipRootDirectoryEntries;
+
+    const int workerCount = qMax(1, QThread::idealThreadCount());
+    m_state->activeWorkers = workerCount;
+    m_pool.setMaxThreadCount(workerCount);
+    m_running = true;
+
+    const std::shared_ptr<WalkerState> state = m_state;
+    for (int i = 0; i < workerCount; ++i) {
+        m_pool.start([this, state]() {
+            walk(state);
+        });
+    }
+}
+
+void FilenameSearchEngine::stop()
+{
+    m_running = false;
+    if (m_state) {
+        m_state->stopped.storeRelaxed(1);
+        QMutexLocker locker(&m_state->mutex);
+        m_state->workAvailable.wakeAll();
+    }
+}
+
+void FilenameSearchEngine::walk(const std::shared_ptr<WalkerState> &state)
+{
+    KFileItemList batch;
+
+    QMutexLocker locker(&state->mutex);
+    while (!state->stopped.loadRelaxed()) {
+        if (state->pendingDirectories.isEmpty()) {
+            if (state->busyWorkers == 0) {
+                // Nobody is walking a directory anymore, so no new work can
+                // appear: the search is complete.
+                state->workAvailable.wakeAll();
+                break;
+            }
+            state->workAvailable.wait(&state->mutex);
+            continue;
+        }
+
+        const QString directoryPath = state->pendingDirectories.takeLast();
+        ++state->busyWorkers;
+        // Snapshot the pattern per directory; refine() may narrow it while
+        // the walk is running.
+        const QRegularExpression namePattern = state->namePattern;
+        locker.unlock();
+
+        QStringList subDirectories;
+        const bool reportEntries = !state->skipRootEntries || directoryPath != state->rootPath;
+        QDirIterator it(directoryPath, QDir::AllEntries | QDir::Hidden | QDir::NoDotAndDotDot);
+        while (it.hasNext() && !state->stopped.loadRelaxed()) {
+            it.next();
+            const QFileInfo fileInfo = it.fileInfo();
+            if (fileInfo.isDir() && !fileInfo.isSymLink()) {
+                // Symbolic links are not followed so link cycles cannot make the walk endless.
+                subDirectories.append(it.filePath());
+            }
+
+            if (reportEntries && namePattern.match(it.fileName()).hasMatch()) {
+                KFileItem item(QUrl::fromLocalFile(it.filePath()));
+                // Trigger the lazy stat here so it does not happen in the GUI
+                // thread when the model first accesses the item.
+                item.isDir();
+                batch.append(item);
+                if (batch.count() >= ResultBatchSize) {
+                    reportBatch(batch);
+                    batch.clear();
+                }
+            }
+        }
+
+        locker.relock();
+        --state->busyWorkers;
+        if (!subDirectories.isEmpty()) {
+            state->pendingDirectories.append(subDirectories);
+            // Wake idle workers so they steal the new directories.
+            state->workAvailable.wakeAll();
+        } else if (state->pendingDirectories.isEmpty() && state->busyWorkers == 0) {
+            state->workAvailable.wakeAll();
+        }
+    }
+    locker.unlock();
+
+    // The remainder is flushed before this worker signs off, so all batches
+    // are queued before the completion below.
+    if (!batch.isEmpty() && !state->stopped.loadRelaxed()) {
+        reportBatch(batch);
+    }
+
+    locker.relock();
+    const bool lastWorker = (--state->activeWorkers == 0);
+    locker.unlock();
+
+    if (lastWorker && !state->stopped.loadRelaxed()) {
+        QMetaObject::invokeMethod(
+            this,
+            [this]() {
+                if (m_running) {
+                    m_running = false;
+                    Q_EMIT finished();
+                }
+            },
+            Qt::QueuedConnection);
+    }
+}
+
+void FilenameSearchEngine::reportBatch(const KFileItemList &items)
+{
+    QMetaObject::invokeMethod(
+        this,
+        [this, items]() {
+            if (!m_running) {
+                return;
+            }
+            // A worker may have matched against a pattern that was narrowed
+            // by refine() in the meantime, so the batch is checked once more
+            // against the current pattern before it is delivered.
+            KFileItemList matchingItems;
+            matchingItems.reserve(items.count());
+            for (const KFileItem &item : items) {
+                if (matchesName(item.name())) {
+                    matchingItems.append(item);
+                }
+            }
+            if (!matchingItems.isEmpty()) {
+                Q_EMIT itemsFound(m_searchUrl, matchingItems);
+            }
+        },
+        Qt::QueuedConnection);
+}
+
+#include "moc_filenamesearchengine.cpp"
@@ -0,0 +1,138 @@
+/*
+    SPDX-FileCopyrightText: 2026 The Dolphin Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef FILENAMESEARCHENGINE_H
+#define FILENAMESEARCHENGINE_H
+
+#include "dolphin_export.h"
+
+#include <KFileItem>
+
+#include <QObject>
+#include <QRegularExpression>
+#include <QThreadPool>
+#include <QUrl>
+
+#include <memory>
+
+namespace Search
+{
+
+/**
+ * @brief A parallel filename search for local directories.
+ *
+ * The "filenamesearch" KIO worker lists the search path sequentially, which
+ * makes unindexed searches on big volumes crawl. This engine answers the same
+ * search URLs for local paths with a multi-threaded directory walker instead:
+ * all worker threads share one queue of directories, and threads that run out
+ * of work steal pending sub-directories found by the others, so deep and flat
+ * trees alike keep every core busy.
+ *
+ * Matches are delivered in batches through itemsFound() so the model can
+ * insert them while the walk is still running. The engine only handles
+ * file name searches; content searches and non-local search paths are
+ * rejected by canSearch() and stay with the KIO worker.
+ */
+class DOLPHIN_EXPORT FilenameSearchEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param searchUrl A "filenamesearch" search URL. It must satisfy canSearch().
+     */
+    explicit FilenameSearchEngine(const QUrl &searchUrl, QObject *parent = nullptr);
+
+    /** Stops the search and waits until all worker threads have exited. */
+    ~FilenameSearchEngine() override;
+
+    /**
+     * @returns whether this engine can answer the given @p searchUrl. Only
+     *          file name searches below a local path are supported.
+     */
+    static bool canSearch(const QUrl &searchUrl);
+
+    /** @returns the search URL this engine was created for or refined to. */
+    QUrl url() const;
+
+    /** @returns the local directory the walk starts in. */
+    QString rootPath() const;
+
+    /**
+     * Makes the walk skip the entries directly inside the root directory while still descending into its sub-directories. Useful when the caller already
+     * holds the complete flat listing of the root directory and reuses it, so the walker must not deliver those entries a second time.
+     * May only be called before start().
+     */
+    void setSkipRootDirectoryEntries(bool skip);
+
+    /**
+     * Tries to narrow this search to @p searchUrl without restarting the
+     * walk. This succeeds if @p searchUrl searches the same path and its
+     * term extends the current term, so every new match is necessarily a
+     * match of the current search as well. On success the running walk
+     * continues with the narrower term and url() reports @p searchUrl;
+     * the caller re-filters the already delivered results itself, see
+     * matchesName().
+     *
+     * @returns whether the search could be refined.
+     */
+    bool refine(const QUrl &searchUrl);
+
+    /** @returns whether the file name @p name matches the current search term. */
+    bool matchesName(const QString &name) const;
+
+    /** @returns whether the search has been started and is not yet finished or stopped. */
+    bool isRunning() const;
+
+    /** Starts the search. May only be called once per engine instance. */
+    void start();
+
+    /**
+     * Stops the search. Worker threads exit as soon as they notice the
+     * request and no further signals are emitted.
+     */
+    void stop();
+
+Q_SIGNALS:
+    /**
+     * Is emitted in the engine's thread whenever a batch of matches has been
+     * found. @p directoryUrl is the search URL the items belong to.
+     */
+    void itemsFound(const QUrl &directoryUrl, const KFileItemList &items);
+
+    /** Is emitted after the last batch of matches once the walk is complete. */
+    void finished();
+
+private:
+    /** The queue and counters shared by all worker threads of one search. */
+    struct WalkerState;
+
+    /** The loop each worker thread runs. @see WalkerState. */
+    void walk(const std::shared_ptr<WalkerState> &state);
+
+    /** Posts @p items to the engine's thread to be emitted through itemsFound(). */
+    void reportBatch(const KFileItemList &items);
+
+private:
+    QUrl m_searchUrl;
+    /** The local directory the walk starts in. */
+    QString m_rootPath;
+    /** The term file names are matched against. @see refine(). */
+    QString m_searchTerm;
+    /** Matches every file name that contains the search term, honoring wildcards. */
+    QRegularExpression m_namePattern;
+
+    /** A dedicated pool so the destructor can wait for this search's workers only. */
+    QThreadPool m_pool;
+    std::shared_ptr<WalkerState> m_state;
+    bool m_running = false;
+    /** Whether the entries directly inside the root directory are left out of the results. @see setSkipRootDirectoryEntries(). */
+    bool m_skipRootDirectoryEntries = false;
+};
+
+}
+
+#endif // FILENAMESEARCHENGINE_H
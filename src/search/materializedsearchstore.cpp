@@ -0,0 +1,109 @@
+/*
+    SPDX-FileCopyrightText: 2026 The Dolphin Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "materializedsearchstore.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+using namespace Search;
+
+namespace
+{
+// "DMSR" - Dolphin materialized search results.
+constexpr quint32 SnapshotMagic = 0x444D5352;
+constexpr quint32 SnapshotVersion = 1;
+
+// Result sets beyond this limit are not materialized: inserting that many
+// items into the model takes longer than the instant-open effect is worth,
+// and the snapshot files stay small.
+constexpr int MaxMaterializedResults = 100000;
+
+QString snapshotDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/materialized-searches");
+}
+}
+
+MaterializedSearchStore *MaterializedSearchStore::instance()
+{
+    static MaterializedSearchStore store;
+    return &store;
+}
+
+QString MaterializedSearchStore::snapshotPath(const QUrl &searchUrl)
+{
+    // The serialized search URL is the canonical form of the query, see
+    // DolphinQuery::toUrl(); hashing it gives a file name of bounded length
+    // without escaping issues.
+    const QByteArray key = QCryptographicHash::hash(searchUrl.toEncoded(), QCryptographicHash::Sha1).toHex();
+    return snapshotDirectory() + QLatin1Char('/') + QString::fromLatin1(key) + QLatin1String(".bin");
+}
+
+bool MaterializedSearchStore::contains(const QUrl &searchUrl) const
+{
+    return QFile::exists(snapshotPath(searchUrl));
+}
+
+KFileItemList MaterializedSearchStore::load(const QUrl &searchUrl) const
+{
+    QFile file(snapshotPath(searchUrl));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return KFileItemList();
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 count = 0;
+    stream >> magic >> version >> count;
+    if (magic != SnapshotMagic || version != SnapshotVersion || count < 0 || count > MaxMaterializedResults) {
+        return KFileItemList();
+    }
+
+    KFileItemList items;
+    items.reserve(count);
+    for (qint32 i = 0; i < count; ++i) {
+        QUrl url;
+        stream >> url;
+        if (stream.status() != QDataStream::Ok) {
+            // A truncated snapshot is worthless; revalidation could not tell
+            // the missing tail from deleted files.
+            return KFileItemList();
+        }
+        items.append(KFileItem(url));
+    }
+    return items;
+}
+
+void MaterializedSearchStore::save(const QUrl &searchUrl, const KFileItemList &items)
+{
+    const QString path = snapshotPath(searchUrl);
+    if (items.count() > MaxMaterializedResults) {
+        QFile::remove(path);
+        return;
+    }
+
+    QDir().mkpath(snapshotDirectory());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << SnapshotMagic << SnapshotVersion << static_cast<qint32>(items.count());
+    for (const KFileItem &item : items) {
+        stream << item.url();
+    }
+    file.commit();
+}
@@ -0,0 +1,70 @@
+/*
+    SPDX-FileCopyrightText: 2026 The Dolphin Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef MATERIALIZEDSEARCHSTORE_H
+#define MATERIALIZEDSEARCHSTORE_H
+
+#include "dolphin_export.h"
+
+#include <KFileItem>
+
+#include <QUrl>
+
+namespace Search
+{
+
+/**
+ * @brief Persists the result sets of completed searches.
+ *
+ * Unindexed searches walk the whole search path every time they are opened,
+ * even when the same saved search is opened many times a day and its results
+ * barely change. This store keeps the result set of the last completed run
+ * per search URL, so the next run can show those results instantly while the
+ * walk revalidates them in the background.
+ *
+ * Result sets are keyed by the serialized search URL. DolphinQuery builds
+ * search URLs canonically, so two visits to the same saved search produce the
+ * same key. Only the result URLs are persisted: search results are listed as
+ * lazily stat'ed local items whose roles are resolved on demand anyway, so
+ * reconstructed items behave exactly like freshly found ones and no role
+ * value can go stale in the store.
+ *
+ * The snapshots live in the cache location and are written atomically via
+ * QSaveFile. All methods must be called from the GUI thread.
+ */
+class DOLPHIN_EXPORT MaterializedSearchStore
+{
+public:
+    static MaterializedSearchStore *instance();
+
+    /** @returns whether a result set has been materialized for @p searchUrl. */
+    bool contains(const QUrl &searchUrl) const;
+
+    /**
+     * @returns the materialized result set of the last completed run of
+     *          @p searchUrl as lazily stat'ed items, or an empty list if
+     *          nothing usable has been materialized.
+     */
+    KFileItemList load(const QUrl &searchUrl) const;
+
+    /**
+     * Persists the URLs of @p items as the result set of @p searchUrl,
+     * replacing any previous snapshot. Result sets beyond a sanity limit are
+     * not materialized; their snapshot is removed instead so that a stale
+     * smaller set is not shown.
+     */
+    void save(const QUrl &searchUrl, const KFileItemList &items);
+
+private:
+    MaterializedSearchStore() = default;
+
+    /** @returns the path of the snapshot file for @p searchUrl. */
+    static QString snapshotPath(const QUrl &searchUrl);
+};
+
+}
+
+#endif // MATERIALIZEDSEARCHSTORE_H
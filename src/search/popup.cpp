@@ -59,6 +59,16 @@ Popup::Popup(std::shared_ptr<const DolphinQuery> dolphinQuery, QWidget *parent)
 {
 }
 
+void Popup::setFacetAggregator(const FacetAggregator *facetAggregator)
+{
+    m_facetAggregator = facetAggregator;
+#if HAVE_BALOO
+    if (m_typeSelector) {
+        m_typeSelector->setFacetAggregator(m_facetAggregator);
+    }
+#endif
+}
+
 QWidget *Popup::init()
 {
     auto containerWidget = new QWidget{this};
@@ -211,6 +221,9 @@ QWidget *Popup::init()
 
     m_typeSelector = new FileTypeSelector{m_searchConfiguration, containerWidget};
     connect(m_typeSelector, &FileTypeSelector::configurationChanged, this, &Popup::configurationChanged);
+    if (m_facetAggregator) {
+        m_typeSelector->setFacetAggregator(m_facetAggregator);
+    }
     selectorsLayout->addWidget(m_typeSelector, 2, 0);
 
     auto dateSelectorTitle = new QLabel{i18nc("@title:group for filtering files by modified date", "Modified since:"), containerWidget};
@@ -23,6 +23,7 @@ class QToolButton;
 namespace Search
 {
 class DateSelector;
+class FacetAggregator;
 class FileTypeSelector;
 class MinimumRatingSelector;
 class TagsSelector;
@@ -43,6 +44,9 @@ class Popup : public WidgetMenu, public UpdatableStateInterface
 public:
     explicit Popup(std::shared_ptr<const DolphinQuery> dolphinQuery, QWidget *parent = nullptr);
 
+    /** Provides the selectors in this popup with result counts per facet so they can hint how many results each facet value would keep. */
+    void setFacetAggregator(const FacetAggregator *facetAggregator);
+
 Q_SIGNALS:
     /** Is emitted whenever settings have changed and a new search might be necessary. */
     void configurationChanged(const Search::DolphinQuery &dolphinQuery);
@@ -92,6 +96,9 @@ private:
     TagsSelector *m_tagsSelector = nullptr;
     /** A button that allows installing or opening KFind. */
     QToolButton *m_kFindButton = nullptr;
+
+    /** Counts the facets of the streamed search results. Forwarded to the selectors once they exist because init() creates them lazily. */
+    const FacetAggregator *m_facetAggregator = nullptr;
 };
 
 }
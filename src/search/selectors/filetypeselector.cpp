@@ -7,10 +7,13 @@
 #include "filetypeselector.h"
 
 #include "../dolphinquery.h"
+#include "../facetaggregator.h"
 
 #include <KFileMetaData/TypeInfo>
 #include <KLocalizedString>
 
+#include <QLocale>
+
 using namespace Search;
 
 FileTypeSelector::FileTypeSelector(std::shared_ptr<const DolphinQuery> dolphinQuery, QWidget *parent)
@@ -67,6 +70,43 @@ FileTypeSelector::FileTypeSelector(std::shared_ptr<const DolphinQuery> dolphinQu
     updateStateToMatch(std::move(dolphinQuery));
 }
 
+void FileTypeSelector::setFacetAggregator(const FacetAggregator *facetAggregator)
+{
+    if (m_facetAggregator == facetAggregator) {
+        return;
+    }
+    if (m_facetAggregator) {
+        disconnect(m_facetAggregator, &FacetAggregator::countsChanged, this, &FileTypeSelector::updateCountHints);
+    }
+    m_facetAggregator = facetAggregator;
+    if (m_facetAggregator) {
+        connect(m_facetAggregator, &FacetAggregator::countsChanged, this, &FileTypeSelector::updateCountHints);
+    }
+    updateCountHints();
+}
+
+void FileTypeSelector::updateCountHints()
+{
+    const bool showCounts = m_facetAggregator && m_facetAggregator->isActive();
+    for (int i = 0; i < count(); ++i) {
+        const auto type = itemData(i).value<KFileMetaData::Type::Type>();
+        if (type == KFileMetaData::Type::Empty) {
+            continue; // "Any Type" stays without a count because it represents no restriction.
+        }
+        const QString displayName = KFileMetaData::TypeInfo{type}.displayName();
+        const int typeCount = showCounts ? m_facetAggregator->countForFileType(type) : 0;
+        if (typeCount > 0) {
+            setItemText(i,
+                        i18nc("@item:inlistbox a file type and how many of the current search results have it, e.g. 'Image (12,430)'",
+                              "%1 (%2)",
+                              displayName,
+                              QLocale{}.toString(typeCount)));
+        } else {
+            setItemText(i, displayName);
+        }
+    }
+}
+
 void Search::FileTypeSelector::removeRestriction()
 {
     Q_ASSERT(m_searchConfiguration->fileType() != KFileMetaData::Type::Empty);
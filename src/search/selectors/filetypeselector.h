@@ -13,6 +13,7 @@
 
 namespace Search
 {
+class FacetAggregator;
 
 class FileTypeSelector : public QComboBox, public UpdatableStateInterface
 {
@@ -24,12 +25,25 @@ public:
     /** Causes configurationChanged() to be emitted with a DolphinQuery object that does not contain any restriction settable by this class. */
     void removeRestriction();
 
+    /**
+     * Makes this selector hint how many of the current search results each file type would keep, e.g. "Image (12,430)". The counts come from
+     * @p facetAggregator and update while search results stream in.
+     */
+    void setFacetAggregator(const FacetAggregator *facetAggregator);
+
 Q_SIGNALS:
     /** Is emitted whenever settings have changed and a new search might be necessary. */
     void configurationChanged(const Search::DolphinQuery &dolphinQuery);
 
 private:
     void updateState(const std::shared_ptr<const DolphinQuery> &dolphinQuery) override;
+
+    /** Appends the current result count of each file type to its entry, or restores the plain entries when no counts are available. */
+    void updateCountHints();
+
+private:
+    /** Counts the facets of the streamed search results. @see setFacetAggregator(). */
+    const FacetAggregator *m_facetAggregator = nullptr;
 };
 }
 
@@ -18,6 +18,7 @@
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QMenu>
+#include <QTimer>
 #include <QToolButton>
 #include <QVBoxLayout>
 
@@ -31,10 +32,30 @@ BottomBarContentsContainer::BottomBarContentsContainer(KActionCollection *action
 {
     // We will mostly interact with m_layout when changing the contents and not care about the other internal hierarchy.
     m_layout = new QHBoxLayout(this);
+
+    m_contextualActionsUpdateTimer = new QTimer(this);
+    m_contextualActionsUpdateTimer->setSingleShot(true);
+    m_contextualActionsUpdateTimer->setInterval(250);
+    connect(m_contextualActionsUpdateTimer, &QTimer::timeout, this, [this]() {
+        if (m_contextualActionsUpdatePending) {
+            m_contextualActionsUpdatePending = false;
+            updateContextualActions();
+            m_contextualActionsUpdateTimer->start(); // Keep throttling while changes keep streaming in.
+        }
+    });
 }
 
 void BottomBarContentsContainer::resetContents(BottomBar::Contents contents)
 {
+    if (contents == m_builtContents && contents != BottomBar::GeneralContents && m_layout->count() > 0) {
+        // The widgets for this kind of contents exist already and apart from the main action button
+        // — which slotSelectionChanged() keeps up to date — they only depend on the kind of
+        // contents, so they can simply be shown again. Only the GeneralContents need a rebuild
+        // because their actions depend on the selection.
+        m_contents = contents;
+        return;
+    }
+
     emptyBarContents();
 
     // A label is added in many of the methods below. We only know its size a bit later and if it should be hidden.
@@ -44,6 +65,7 @@ void BottomBarContentsContainer::resetContents(BottomBar::Contents contents)
 
     Q_CHECK_PTR(m_actionCollection);
     m_contents = contents;
+    m_builtContents = contents;
     switch (contents) {
     case BottomBar::CopyContents:
         return addCopyContents();
@@ -130,26 +152,42 @@ void BottomBarContentsContainer::adaptToNewBarWidth(int newBarWidth)
 void BottomBarContentsContainer::slotSelectionChanged(const KFileItemList &selection, const QUrl &baseUrl)
 {
     if (m_contents == BottomBar::GeneralContents) {
-        auto contextActions = contextActionsFor(selection, baseUrl);
-        m_generalBarActions.clear();
-        if (contextActions.empty()) {
-            // We have nothing to show
-            Q_ASSERT(qobject_cast<BottomBar *>(parentWidget()->parentWidget()->parentWidget()));
-            if (isVisibleTo(parentWidget()->parentWidget()->parentWidget()->parentWidget())) { // is the bar visible
-                Q_EMIT barVisibilityChangeRequested(false);
-            }
+        m_pendingSelection = selection;
+        m_pendingBaseUrl = baseUrl;
+        if (m_contextualActionsUpdateTimer->isActive()) {
+            // The contextual actions were rebuilt just a moment ago. Rebuilding queries the capabilities of every selected item,
+            // which makes each click noticeably laggy in huge selections, so further changes are collected while the timer runs
+            // and only the newest selection is rebuilt once it runs out. The main action button below is cheap to update and
+            // therefore always kept current.
+            m_contextualActionsUpdatePending = true;
         } else {
-            for (auto i = contextActions.begin(); i != contextActions.end(); ++i) {
-                m_generalBarActions.emplace_back(ActionWithWidget{*i});
-            }
-            resetContents(BottomBar::GeneralContents);
-
-            Q_EMIT barVisibilityChangeRequested(true);
+            updateContextualActions();
+            m_contextualActionsUpdateTimer->start();
         }
     }
     updateMainActionButton(selection);
 }
 
+void BottomBarContentsContainer::updateContextualActions()
+{
+    auto contextActions = contextActionsFor(m_pendingSelection, m_pendingBaseUrl);
+    m_generalBarActions.clear();
+    if (contextActions.empty()) {
+        // We have nothing to show
+        Q_ASSERT(qobject_cast<BottomBar *>(parentWidget()->parentWidget()->parentWidget()));
+        if (isVisibleTo(parentWidget()->parentWidget()->parentWidget()->parentWidget())) { // is the bar visible
+            Q_EMIT barVisibilityChangeRequested(false);
+        }
+    } else {
+        for (auto i = contextActions.begin(); i != contextActions.end(); ++i) {
+            m_generalBarActions.emplace_back(ActionWithWidget{*i});
+        }
+        resetContents(BottomBar::GeneralContents);
+
+        Q_EMIT barVisibilityChangeRequested(true);
+    }
+}
+
 void BottomBarContentsContainer::addCopyContents()
 {
     m_explanatoryLabel = new QLabel(i18nc("@info explaining the next step in a process", "Select the files and folders that should be copied."), this);
@@ -505,7 +543,13 @@ std::vector<QAction *> BottomBarContentsContainer::contextActionsFor(const KFile
         m_fileItemActions->setParentWidget(dolphinMainWindow);
         connect(m_fileItemActions, &KFileItemActions::error, this, &BottomBarContentsContainer::error);
     }
-    m_internalContextMenu = std::make_unique<DolphinContextMenu>(dolphinMainWindow, selectedItems.constFirst(), selectedItems, baseUrl, m_fileItemActions);
+    // The menu is never shown, its actions are harvested right away, so the expensive sections may not be deferred.
+    m_internalContextMenu = std::make_unique<DolphinContextMenu>(dolphinMainWindow,
+                                                                 selectedItems.constFirst(),
+                                                                 selectedItems,
+                                                                 baseUrl,
+                                                                 m_fileItemActions,
+                                                                 DolphinContextMenu::Population::Immediate);
     auto internalContextMenuActions = m_internalContextMenu->actions();
 
     // There are some actions which we wouldn't want to add. We remember them in the actionsThatShouldntBeAdded set.
@@ -11,17 +11,19 @@
 #include "actionwithwidget.h"
 #include "bottombar.h"
 
+#include <KFileItem>
+
 #include <QPointer>
 #include <QPushButton>
+#include <QUrl>
 #include <QWidget>
 
 class DolphinContextMenu;
 class KActionCollection;
 class KFileItemActions;
-class KFileItemList;
 class QHBoxLayout;
 class QLabel;
-class QUrl;
+class QTimer;
 
 namespace SelectionMode
 {
@@ -103,6 +105,13 @@ private:
      */
     void emptyBarContents();
 
+    /**
+     * Rebuilds m_generalBarActions for the most recent selection reported to slotSelectionChanged()
+     * and resets the GeneralContents of the bar accordingly. This queries the capabilities of every
+     * selected item, so calls are throttled through m_contextualActionsUpdateTimer.
+     */
+    void updateContextualActions();
+
     /**
      * @returns A vector containing contextual actions for the given \a selectedItems in the \a baseUrl.
      * Cut, Copy, Rename and MoveToTrash are always added. Any further contextual actions depend on
@@ -150,9 +159,24 @@ private:
     KActionCollection *m_actionCollection;
     /// Describes the current contents of the bar.
     BottomBar::Contents m_contents;
+    /// The kind of contents the widgets currently on the bar were built for. Unlike m_contents this
+    /// is only changed when widgets are actually (re-)built, so resetContents() can recognise that
+    /// the requested kind of contents already exists and skip the rebuild. m_contents on the other
+    /// hand is sometimes changed without rebuilding to control the hiding behaviour of the bar.
+    BottomBar::Contents m_builtContents = BottomBar::GeneralContents;
     /// The main layout of this ContentsContainer that all the buttons and labels are added to.
     QHBoxLayout *m_layout;
 
+    /// Throttles the expensive rebuilds of the contextual actions while the selection keeps
+    /// changing. @see updateContextualActions()
+    QTimer *m_contextualActionsUpdateTimer;
+    /// The selection and view URL most recently reported to slotSelectionChanged(). Only the newest
+    /// state is rebuilt once m_contextualActionsUpdateTimer runs out.
+    KFileItemList m_pendingSelection;
+    QUrl m_pendingBaseUrl;
+    /// Whether a selection change arrived while m_contextualActionsUpdateTimer was running.
+    bool m_contextualActionsUpdatePending = false;
+
     /// Caches the totalBarWidth as set in adaptToNewWidth(newBarWidth). */
     int m_barWidth = 0;
     /// The info label used for some of the Contents. Is hidden for narrow widths.
@@ -12,11 +12,24 @@
 #include "views/viewproperties.h"
 #include <KIO/ListJob>
 
+#include <QFutureWatcher>
+#include <QtConcurrentRun>
+
+namespace
+{
+// Number of directories whose properties are applied by one worker task.
+// Applying is I/O-bound, so modest batches keep all workers busy while
+// bounding the bookkeeping overhead per task.
+constexpr int ApplyBatchSize = 32;
+}
+
 ApplyViewPropsJob::ApplyViewPropsJob(const QUrl &dir, const ViewProperties &viewProps)
     : KIO::Job()
     , m_viewProps(nullptr)
     , m_progress(0)
     , m_dir(dir)
+    , m_runningBatches(0)
+    , m_listingFinished(false)
 {
     m_viewProps = new ViewProperties(dir);
     m_viewProps->setViewMode(viewProps.viewMode());
@@ -32,6 +45,9 @@ ApplyViewPropsJob::ApplyViewPropsJob(const QUrl &dir, const ViewProperties &view
 
 ApplyViewPropsJob::~ApplyViewPropsJob()
 {
+    // The workers read *m_viewProps, so it must outlive them.
+    m_batches.waitForFinished();
+
     delete m_viewProps; // the properties are written by the destructor
     m_viewProps = nullptr;
 }
@@ -41,17 +57,59 @@ void ApplyViewPropsJob::slotEntries(KIO::Job *, const KIO::UDSEntryList &list)
     for (const KIO::UDSEntry &entry : list) {
         const QString name = entry.stringValue(KIO::UDSEntry::UDS_NAME);
         if (name != QLatin1Char('.') && name != QLatin1String("..") && entry.isDir()) {
-            ++m_progress;
-
             QUrl url(m_dir);
             url = url.adjusted(QUrl::StripTrailingSlash);
             url.setPath(url.path() + QLatin1Char('/') + name);
+            m_pendingDirs.append(url);
+        }
+    }
+
+    while (m_pendingDirs.count() >= ApplyBatchSize) {
+        dispatchBatch();
+    }
+}
 
-            Q_ASSERT(m_viewProps);
+void ApplyViewPropsJob::dispatchBatch()
+{
+    if (m_pendingDirs.isEmpty()) {
+        return;
+    }
 
+    const QList<QUrl> batch = m_pendingDirs.mid(0, ApplyBatchSize);
+    m_pendingDirs.remove(0, batch.count());
+    ++m_runningBatches;
+
+    Q_ASSERT(m_viewProps);
+    const ViewProperties *sourceProps = m_viewProps;
+    auto future = QtConcurrent::run([batch, sourceProps]() {
+        for (const QUrl &url : batch) {
             ViewProperties props(url);
-            props.setDirProperties(*m_viewProps);
+            // Save synchronously in this worker so the writes of all batches
+            // proceed in parallel instead of funneling through the
+            // write-behind queue of the GUI thread.
+            props.setAutoSaveEnabled(false);
+            props.setDirProperties(*sourceProps);
+            if (props.isChanged()) {
+                props.save();
+            }
         }
+    });
+    m_batches.addFuture(future);
+
+    auto *watcher = new QFutureWatcher<void>(this);
+    connect(watcher, &QFutureWatcher<void>::finished, this, [this, watcher, count = batch.count()]() {
+        watcher->deleteLater();
+        m_progress += count;
+        --m_runningBatches;
+        finishIfDone();
+    });
+    watcher->setFuture(future);
+}
+
+void ApplyViewPropsJob::finishIfDone()
+{
+    if (m_listingFinished && m_runningBatches == 0) {
+        emitResult();
     }
 }
 
@@ -61,7 +119,13 @@ void ApplyViewPropsJob::slotResult(KJob *job)
         setError(job->error());
         setErrorText(job->errorText());
     }
-    emitResult();
+    removeSubjob(job);
+
+    m_listingFinished = true;
+    while (!m_pendingDirs.isEmpty()) {
+        dispatchBatch();
+    }
+    finishIfDone();
 }
 
 #include "moc_applyviewpropsjob.cpp"
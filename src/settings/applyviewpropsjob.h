@@ -13,6 +13,8 @@
 #include <KIO/Job>
 #include <KIO/UDSEntry>
 
+#include <QFutureSynchronizer>
+#include <QList>
 #include <QUrl>
 
 class ViewProperties;
@@ -20,6 +22,12 @@ class ViewProperties;
 /**
  * @brief Applies view properties recursively to directories.
  *
+ * The directories are gathered by one recursive listing and their properties
+ * are applied in batches spread across the global thread pool, so that the
+ * writes of different directories proceed in parallel instead of one
+ * synchronous write at a time. Directories whose properties already match are
+ * detected before writing and skipped.
+ *
  * Usage:
  * \code
  * KJob* job = new ApplyViewPropsJob(dir, viewProps);
@@ -57,9 +65,27 @@ private Q_SLOTS:
     void slotEntries(KIO::Job *, const KIO::UDSEntryList &);
 
 private:
+    /**
+     * Hands one batch of collected directories to a worker in the global
+     * thread pool, which applies and saves the properties of each.
+     */
+    void dispatchBatch();
+
+    /** Emits the result once the listing and all dispatched batches are done. */
+    void finishIfDone();
+
     ViewProperties *m_viewProps;
     int m_progress;
     QUrl m_dir;
+
+    /** Directories collected from the listing but not yet dispatched. */
+    QList<QUrl> m_pendingDirs;
+
+    /** Keeps the worker futures so the destructor can wait for them. */
+    QFutureSynchronizer<void> m_batches;
+
+    int m_runningBatches;
+    bool m_listingFinished;
 };
 
 inline int ApplyViewPropsJob::progress() const
@@ -11,15 +11,17 @@
 
 #include <KIO/ApplicationLauncherJob>
 #include <KLocalizedString>
+#include <KMountPoint>
 #include <KService>
 
 #include <QDesktopServices>
+#include <QFutureWatcher>
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QPushButton>
 #include <QShowEvent>
-#include <QStorageInfo>
 #include <QWidgetAction>
+#include <QtConcurrentRun>
 
 DiskSpaceUsageMenu::DiskSpaceUsageMenu(QWidget *parent)
     : QMenu{parent}
@@ -64,14 +66,40 @@ void DiskSpaceUsageMenu::slotInstallFilelightButtonClicked()
 }
 
 void DiskSpaceUsageMenu::updateMenu()
+{
+    if (m_servicesResolved) {
+        // Popping up must not wait for service lookups: fill the menu from the
+        // cached tools right away. The re-check below corrects it in place in
+        // the rare case that a tool was installed or removed in the meantime.
+        populateMenu();
+    }
+
+    QFutureWatcher<QPair<KService::Ptr, KService::Ptr>> *watcher = new QFutureWatcher<QPair<KService::Ptr, KService::Ptr>>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher]() {
+        watcher->deleteLater();
+        const QPair<KService::Ptr, KService::Ptr> services = watcher->result();
+        const bool changed = !m_servicesResolved || bool(services.first) != bool(m_filelight) || bool(services.second) != bool(m_kdiskfree);
+        m_filelight = services.first;
+        m_kdiskfree = services.second;
+        m_servicesResolved = true;
+        if (changed) {
+            populateMenu();
+        }
+    });
+    watcher->setFuture(QtConcurrent::run([]() {
+        return qMakePair(KService::serviceByDesktopName(QStringLiteral("org.kde.filelight")), KService::serviceByDesktopName(QStringLiteral("org.kde.kdf")));
+    }));
+}
+
+void DiskSpaceUsageMenu::populateMenu()
 {
     clear();
 
     // Creates a menu with tools that help to find out more about free
     // disk space for the given url.
 
-    const KService::Ptr filelight = KService::serviceByDesktopName(QStringLiteral("org.kde.filelight"));
-    const KService::Ptr kdiskfree = KService::serviceByDesktopName(QStringLiteral("org.kde.kdf"));
+    const KService::Ptr filelight = m_filelight;
+    const KService::Ptr kdiskfree = m_kdiskfree;
 
     if (!filelight && !kdiskfree) {
         // Show an UI to install a tool to free up disk space because this is what a user pressing on a "free space" button would want.
@@ -93,29 +121,27 @@ void DiskSpaceUsageMenu::updateMenu()
 
         // For remote URLs like FTP analyzing the device makes no sense
         if (m_url.isLocalFile()) {
-            QAction *filelightDiskAction = addAction(QIcon::fromTheme(QStringLiteral("filelight")), i18n("Disk Usage Statistics - current device"));
-
-            connect(filelightDiskAction, &QAction::triggered, this, [this, filelight](bool) {
-                const QStorageInfo info(m_url.toLocalFile());
-
-                if (info.isValid() && info.isReady()) {
+            // The device root is resolved from the mount table while the menu is
+            // built, so activating the action does not statfs a possibly slow
+            // device in the GUI thread.
+            const KMountPoint::Ptr mountPoint = KMountPoint::currentMountPoints().findByPath(m_url.toLocalFile());
+            if (mountPoint) {
+                QAction *filelightDiskAction = addAction(QIcon::fromTheme(QStringLiteral("filelight")), i18n("Disk Usage Statistics - current device"));
+
+                connect(filelightDiskAction, &QAction::triggered, this, [filelight, mountPoint](bool) {
                     auto *job = new KIO::ApplicationLauncherJob(filelight);
-                    job->setUrls({QUrl::fromLocalFile(info.rootPath())});
+                    job->setUrls({QUrl::fromLocalFile(mountPoint->mountPoint())});
                     job->start();
-                }
-            });
-        }
-
-        QAction *filelightAllAction = addAction(QIcon::fromTheme(QStringLiteral("filelight")), i18n("Disk Usage Statistics - all devices"));
+                });
+            }
 
-        connect(filelightAllAction, &QAction::triggered, this, [this, filelight](bool) {
-            const QStorageInfo info(m_url.toLocalFile());
+            QAction *filelightAllAction = addAction(QIcon::fromTheme(QStringLiteral("filelight")), i18n("Disk Usage Statistics - all devices"));
 
-            if (info.isValid() && info.isReady()) {
+            connect(filelightAllAction, &QAction::triggered, this, [filelight](bool) {
                 auto *job = new KIO::ApplicationLauncherJob(filelight);
                 job->start();
-            }
-        });
+            });
+        }
     }
 
     if (kdiskfree) {
@@ -8,6 +8,7 @@
 #define DISKSPACEUSAGEMENU_H
 
 #include <KMessageWidget>
+#include <KService>
 
 #include <QMenu>
 #include <QPointer>
@@ -53,6 +54,12 @@ private Q_SLOTS:
      */
     void slotInstallFilelightButtonClicked();
 
+    /**
+     * Populates the menu instantly from the cached availability of the disk usage
+     * tools and triggers a re-check of the availability on a thread of the global
+     * thread pool. If the re-check comes to a different conclusion, the menu is
+     * updated in place.
+     */
     void updateMenu();
 
 protected:
@@ -66,11 +73,19 @@ private:
      */
     void initialiseInstallFilelightWidgetAction();
 
+    /** Fills the menu with actions for the tools in m_filelight and m_kdiskfree. */
+    void populateMenu();
+
 private:
     /** An action containing a UI to install Filelight. */
     QPointer<QWidgetAction> m_installFilelightWidgetAction = nullptr;
     /** The current url of the view. Filelight can be launched to show this directory. */
     QUrl m_url;
+    /** The cached disk usage tools. Only valid once m_servicesResolved is true. */
+    KService::Ptr m_filelight;
+    KService::Ptr m_kdiskfree;
+    /** Whether the availability of the disk usage tools has been determined at least once. */
+    bool m_servicesResolved = false;
 };
 
 #endif // DISKSPACEUSAGEMENU_H
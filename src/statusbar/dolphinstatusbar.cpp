@@ -36,43 +36,93 @@ DolphinStatusBar::DolphinStatusBar(QWidget *parent)
     : AnimatedHeightWidget(parent)
     , m_text()
     , m_defaultText()
+    , m_contentsContainer(nullptr)
     , m_label(nullptr)
     , m_zoomLabel(nullptr)
     , m_spaceInfo(nullptr)
     , m_zoomSlider(nullptr)
+    , m_zoomLevel(ZoomLevelInfo::minimumLevel())
+    , m_progressTextLabel(nullptr)
     , m_progressBar(nullptr)
     , m_stopButton(nullptr)
     , m_progress(100)
     , m_showProgressBarTimer(nullptr)
     , m_delayUpdateTimer(nullptr)
     , m_textTimestamp()
+    , m_topLayout(nullptr)
 {
     setProperty("_breeze_statusbar_separator", true);
 
-    QWidget *contentsContainer = prepareContentsContainer();
-    contentsContainer->setContentsMargins(0, 0, 0, 0);
+    m_contentsContainer = prepareContentsContainer();
+    m_contentsContainer->setContentsMargins(0, 0, 0, 0);
+
+    // The sub-widgets are only created once this status bar actually becomes
+    // visible: most status bars belong to background tabs that are never
+    // shown. @see DolphinStatusBar::ensureSubWidgetsCreated(). Until then
+    // only the cheap timers are set up.
+    m_showProgressBarTimer = new QTimer(this);
+    m_showProgressBarTimer->setInterval(500);
+    m_showProgressBarTimer->setSingleShot(true);
+    connect(m_showProgressBarTimer, &QTimer::timeout, this, &DolphinStatusBar::updateProgressInfo);
+
+    // initialize text updater delay timer
+    m_delayUpdateTimer = new QTimer(this);
+    m_delayUpdateTimer->setInterval(UpdateDelay);
+    m_delayUpdateTimer->setSingleShot(true);
+    connect(m_delayUpdateTimer, &QTimer::timeout, this, &DolphinStatusBar::updateLabelText);
+
+    readSettings();
+    setWhatsThis(xi18nc("@info:whatsthis Statusbar",
+                        "<para>This is "
+                        "the <emphasis>Statusbar</emphasis>. It contains three elements "
+                        "by default (left to right):<list><item>A <emphasis>text field"
+                        "</emphasis> that displays the size of selected items. If only "
+                        "one item is selected the name and type is shown as well.</item>"
+                        "<item>A <emphasis>zoom slider</emphasis> that allows you "
+                        "to adjust the size of the icons in the view.</item>"
+                        "<item><emphasis>Space information</emphasis> about the "
+                        "current storage device.</item></list></para>"));
+}
+
+DolphinStatusBar::~DolphinStatusBar()
+{
+}
+
+void DolphinStatusBar::ensureSubWidgetsCreated()
+{
+    if (m_label) {
+        return;
+    }
 
     // Initialize text label
-    m_label = new KSqueezedTextLabel(m_text, contentsContainer);
+    m_label = new KSqueezedTextLabel(m_text, m_contentsContainer);
     m_label->setTextFormat(Qt::PlainText);
     m_label->setTextInteractionFlags(Qt::TextBrowserInteraction | Qt::TextSelectableByKeyboard); // for accessibility but also to allow copy-pasting this text.
 
     // Initialize zoom slider's explanatory label
-    m_zoomLabel = new KSqueezedTextLabel(i18nc("Used as a noun, i.e. 'Here is the zoom level:'", "Zoom:"), contentsContainer);
+    m_zoomLabel = new KSqueezedTextLabel(i18nc("Used as a noun, i.e. 'Here is the zoom level:'", "Zoom:"), m_contentsContainer);
 
     // Initialize zoom widget
-    m_zoomSlider = new QSlider(Qt::Horizontal, contentsContainer);
+    m_zoomSlider = new QSlider(Qt::Horizontal, m_contentsContainer);
     m_zoomSlider->setAccessibleName(i18n("Zoom"));
     m_zoomSlider->setAccessibleDescription(i18nc("Description for zoom-slider (accessibility)", "Sets the size of the file icons."));
     m_zoomSlider->setPageStep(1);
     m_zoomSlider->setRange(ZoomLevelInfo::minimumLevel(), ZoomLevelInfo::maximumLevel());
-
-    connect(m_zoomSlider, &QSlider::valueChanged, this, &DolphinStatusBar::zoomLevelChanged);
+    // The zoom level accumulated while there was no slider yet is applied
+    // before the connects, so that no spurious zoomLevelChanged() is emitted.
+    m_zoomSlider->setValue(m_zoomLevel);
+
+    connect(m_zoomSlider, &QSlider::valueChanged, this, [this](int zoomLevel) {
+        m_zoomLevel = zoomLevel;
+        Q_EMIT zoomLevelChanged(zoomLevel);
+    });
     connect(m_zoomSlider, &QSlider::valueChanged, this, &DolphinStatusBar::updateZoomSliderToolTip);
     connect(m_zoomSlider, &QSlider::sliderMoved, this, &DolphinStatusBar::showZoomSliderToolTip);
 
-    // Initialize space information
-    m_spaceInfo = new StatusBarSpaceInfo(contentsContainer);
+    // Initialize space information. The observer backend behind it is shared
+    // per mount point, see SpaceInfoObserver.
+    m_spaceInfo = new StatusBarSpaceInfo(m_contentsContainer);
+    m_spaceInfo->setUrl(m_url);
     connect(m_spaceInfo, &StatusBarSpaceInfo::showMessage, this, &DolphinStatusBar::showMessage);
     connect(m_spaceInfo,
             &StatusBarSpaceInfo::showInstallationProgress,
@@ -82,7 +132,7 @@ DolphinStatusBar::DolphinStatusBar(QWidget *parent)
             });
 
     // Initialize progress information
-    m_stopButton = new QToolButton(contentsContainer);
+    m_stopButton = new QToolButton(m_contentsContainer);
     m_stopButton->setIcon(QIcon::fromTheme(QStringLiteral("process-stop")));
     m_stopButton->setAccessibleName(i18n("Stop"));
     m_stopButton->setAutoRaise(true);
@@ -90,23 +140,14 @@ DolphinStatusBar::DolphinStatusBar(QWidget *parent)
     m_stopButton->hide();
     connect(m_stopButton, &QToolButton::clicked, this, &DolphinStatusBar::stopPressed);
 
-    m_progressTextLabel = new QLabel(contentsContainer);
+    m_progressTextLabel = new QLabel(m_progressText, m_contentsContainer);
     m_progressTextLabel->hide();
 
-    m_progressBar = new QProgressBar(contentsContainer);
+    m_progressBar = new QProgressBar(m_contentsContainer);
+    m_progressBar->setMaximum(m_progressIndeterminate ? 0 : 100);
+    m_progressBar->setValue(m_progress);
     m_progressBar->hide();
 
-    m_showProgressBarTimer = new QTimer(this);
-    m_showProgressBarTimer->setInterval(500);
-    m_showProgressBarTimer->setSingleShot(true);
-    connect(m_showProgressBarTimer, &QTimer::timeout, this, &DolphinStatusBar::updateProgressInfo);
-
-    // initialize text updater delay timer
-    m_delayUpdateTimer = new QTimer(this);
-    m_delayUpdateTimer->setInterval(UpdateDelay);
-    m_delayUpdateTimer->setSingleShot(true);
-    connect(m_delayUpdateTimer, &QTimer::timeout, this, &DolphinStatusBar::updateLabelText);
-
     // Initialize top layout and size policies
     const int fontHeight = QFontMetrics(m_label->font()).height();
     const int zoomSliderHeight = m_zoomSlider->minimumSizeHint().height();
@@ -127,7 +168,7 @@ DolphinStatusBar::DolphinStatusBar(QWidget *parent)
     m_progressBar->setFixedHeight(zoomSliderHeight);
     m_progressBar->setMaximumWidth(fontMetrics.averageCharWidth() * 20);
 
-    m_topLayout = new QHBoxLayout(contentsContainer);
+    m_topLayout = new QHBoxLayout(m_contentsContainer);
     updateContentsMargins();
     m_topLayout->setSpacing(4);
     m_topLayout->addWidget(m_label, 1);
@@ -138,21 +179,20 @@ DolphinStatusBar::DolphinStatusBar(QWidget *parent)
     m_topLayout->addWidget(m_progressTextLabel);
     m_topLayout->addWidget(m_progressBar);
 
+    // Apply the state that has accumulated while the sub-widgets did not
+    // exist yet.
     readSettings();
-    setWhatsThis(xi18nc("@info:whatsthis Statusbar",
-                        "<para>This is "
-                        "the <emphasis>Statusbar</emphasis>. It contains three elements "
-                        "by default (left to right):<list><item>A <emphasis>text field"
-                        "</emphasis> that displays the size of selected items. If only "
-                        "one item is selected the name and type is shown as well.</item>"
-                        "<item>A <emphasis>zoom slider</emphasis> that allows you "
-                        "to adjust the size of the icons in the view.</item>"
-                        "<item><emphasis>Space information</emphasis> about the "
-                        "current storage device.</item></list></para>"));
-}
-
-DolphinStatusBar::~DolphinStatusBar()
-{
+    updateLabelText();
+    if (m_progress < 100 && !m_showProgressBarTimer->isActive()) {
+        // A task reported progress while this status bar was hidden and the
+        // delayed reveal of the progress bar has already elapsed.
+        updateProgressInfo();
+    }
+    // readSettings() replayed the show animation of this bar; it was already
+    // "shown" without its sub-widgets, so jump to the final height instead.
+    if (GeneralSettings::showStatusBar() != GeneralSettings::EnumShowStatusBar::Disabled) {
+        setVisible(true, WithoutAnimation);
+    }
 }
 
 void DolphinStatusBar::setText(const QString &text)
@@ -178,24 +218,29 @@ void DolphinStatusBar::showProgress(const QString &currentlyRunningTaskTitle, in
     m_cancelLoading = cancelLoading;
 
     // Show a busy indicator if a value < 0 is provided:
-    m_progressBar->setMaximum((progressPercent < 0) ? 0 : 100);
+    m_progressIndeterminate = progressPercent < 0;
+    if (m_progressBar) {
+        m_progressBar->setMaximum(m_progressIndeterminate ? 0 : 100);
+    }
 
     progressPercent = qBound(0, progressPercent, 100);
-    if (!m_progressBar->isVisible()) {
+    if (!m_progressBar || !m_progressBar->isVisible()) {
         // Show the progress bar delayed: In the case if 100 % are reached within
         // a short time, no progress bar will be shown at all.
         if (!m_showProgressBarTimer->isActive()) {
             m_showProgressBarTimer->start();
         } else {
             // The timer is already running. Should we restart it or keep it running?
-            if (m_progressTextLabel->text() != currentlyRunningTaskTitle || (progressPercent < 100 && progressPercent < m_progress)) {
+            if (m_progressText != currentlyRunningTaskTitle || (progressPercent < 100 && progressPercent < m_progress)) {
                 m_showProgressBarTimer->start();
             }
         }
     }
     m_progress = progressPercent;
 
-    m_progressBar->setValue(m_progress);
+    if (m_progressBar) {
+        m_progressBar->setValue(m_progress);
+    }
     if (progressPercent == 100) {
         // The end of the progress has been reached. Assure that the progress bar
         // gets hidden and the extensions widgets get visible again.
@@ -203,13 +248,16 @@ void DolphinStatusBar::showProgress(const QString &currentlyRunningTaskTitle, in
         updateProgressInfo();
     }
 
-    m_progressTextLabel->setText(currentlyRunningTaskTitle);
+    m_progressText = currentlyRunningTaskTitle;
+    if (m_progressTextLabel) {
+        m_progressTextLabel->setText(currentlyRunningTaskTitle);
+    }
     updateWidthToContent();
 }
 
 QString DolphinStatusBar::progressText() const
 {
-    return m_progressTextLabel->text();
+    return m_progressText;
 }
 
 int DolphinStatusBar::progress() const
@@ -242,27 +290,33 @@ QString DolphinStatusBar::defaultText() const
 
 void DolphinStatusBar::setUrl(const QUrl &url)
 {
-    if (GeneralSettings::showStatusBar() == GeneralSettings::EnumShowStatusBar::FullWidth && m_spaceInfo && m_spaceInfo->url() != url) {
-        m_spaceInfo->setUrl(url);
+    if (GeneralSettings::showStatusBar() == GeneralSettings::EnumShowStatusBar::FullWidth && m_url != url) {
+        m_url = url;
+        if (m_spaceInfo) {
+            m_spaceInfo->setUrl(url);
+        }
         Q_EMIT urlChanged();
     }
 }
 
 QUrl DolphinStatusBar::url() const
 {
-    return m_spaceInfo->url();
+    return m_url;
 }
 
 void DolphinStatusBar::setZoomLevel(int zoomLevel)
 {
-    if (zoomLevel != m_zoomSlider->value()) {
-        m_zoomSlider->setValue(zoomLevel);
+    if (zoomLevel != m_zoomLevel) {
+        m_zoomLevel = zoomLevel;
+        if (m_zoomSlider) {
+            m_zoomSlider->setValue(zoomLevel);
+        }
     }
 }
 
 int DolphinStatusBar::zoomLevel() const
 {
-    return m_zoomSlider->value();
+    return m_zoomLevel;
 }
 
 void DolphinStatusBar::readSettings()
@@ -273,11 +327,17 @@ void DolphinStatusBar::readSettings()
 
 void DolphinStatusBar::updateSpaceInfo()
 {
-    m_spaceInfo->update();
+    if (m_spaceInfo) {
+        m_spaceInfo->update();
+    }
 }
 
 void DolphinStatusBar::updateWidthToContent()
 {
+    if (!m_label) {
+        // The sub-widgets do not exist yet, so there is no content to fit.
+        return;
+    }
     if (GeneralSettings::showStatusBar() == GeneralSettings::EnumShowStatusBar::Small) {
         QStyleOptionSlider opt;
         opt.initFrom(this);
@@ -319,14 +379,18 @@ void DolphinStatusBar::updateMode()
     switch (GeneralSettings::showStatusBar()) {
     case GeneralSettings::EnumShowStatusBar::Small:
         setEnabled(true);
-        m_spaceInfo->setShown(false);
-        m_zoomSlider->setVisible(false);
-        m_zoomLabel->setVisible(false);
+        if (m_spaceInfo) {
+            m_spaceInfo->setShown(false);
+            m_zoomSlider->setVisible(false);
+            m_zoomLabel->setVisible(false);
+        }
         setVisible(true, WithAnimation);
         break;
     case GeneralSettings::EnumShowStatusBar::FullWidth:
         setEnabled(true);
-        m_spaceInfo->setShown(true);
+        if (m_spaceInfo) {
+            m_spaceInfo->setShown(true);
+        }
         setVisible(true, WithAnimation);
         break;
     case GeneralSettings::EnumShowStatusBar::Disabled:
@@ -375,6 +439,11 @@ void DolphinStatusBar::showZoomSliderToolTip(int zoomLevel)
 
 void DolphinStatusBar::updateProgressInfo()
 {
+    if (!m_progressBar) {
+        // The sub-widgets do not exist yet; ensureSubWidgetsCreated() applies
+        // the progress state once this status bar becomes visible.
+        return;
+    }
     if (m_progress < 100) {
         // Show the progress information and hide the extensions
         m_stopButton->setVisible(m_cancelLoading == CancelLoading::Allowed);
@@ -393,6 +462,9 @@ void DolphinStatusBar::updateProgressInfo()
 
 void DolphinStatusBar::updateLabelText()
 {
+    if (!m_label) {
+        return;
+    }
     const QString text = m_text.isEmpty() ? m_defaultText : m_text;
     m_label->setText(text);
     updateWidthToContent();
@@ -406,6 +478,10 @@ void DolphinStatusBar::updateZoomSliderToolTip(int zoomLevel)
 
 void DolphinStatusBar::setExtensionsVisible(bool visible)
 {
+    if (!m_zoomSlider) {
+        return;
+    }
+
     bool showZoomSlider = visible;
     if (visible) {
         showZoomSlider = GeneralSettings::showZoomSlider() && GeneralSettings::showStatusBar() == GeneralSettings::EnumShowStatusBar::FullWidth;
@@ -418,6 +494,9 @@ void DolphinStatusBar::setExtensionsVisible(bool visible)
 
 void DolphinStatusBar::updateContentsMargins()
 {
+    if (!m_topLayout) {
+        return;
+    }
     if (GeneralSettings::showStatusBar() == GeneralSettings::EnumShowStatusBar::FullWidth) {
         // We reduce the outside margin for the flat button so it visually has the same margin as the status bar text label on the other end of the bar.
         m_topLayout->setContentsMargins(6, 0, 2, 0);
@@ -463,8 +542,20 @@ void DolphinStatusBar::paintEvent(QPaintEvent *paintEvent)
     }
 }
 
+void DolphinStatusBar::showEvent(QShowEvent *event)
+{
+    ensureSubWidgetsCreated();
+    AnimatedHeightWidget::showEvent(event);
+}
+
 int DolphinStatusBar::preferredHeight() const
 {
+    if (!m_spaceInfo) {
+        // Before the sub-widgets exist an estimate is good enough: it is only
+        // used while this status bar has never been shown, and showing it
+        // creates the sub-widgets and applies the real height.
+        return QFontMetrics(font()).height();
+    }
     return m_spaceInfo->height();
 }
 
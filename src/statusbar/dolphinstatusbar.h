@@ -12,8 +12,8 @@
 #include <KMessageWidget>
 
 #include <QTime>
+#include <QUrl>
 
-class QUrl;
 class StatusBarSpaceInfo;
 class QLabel;
 class QProgressBar;
@@ -141,6 +141,9 @@ protected:
     void contextMenuEvent(QContextMenuEvent *event) override;
     void paintEvent(QPaintEvent *paintEvent) override;
 
+    /** Creates the sub-widgets the first time this status bar actually becomes visible. */
+    void showEvent(QShowEvent *event) override;
+
 private Q_SLOTS:
     void showZoomSliderToolTip(int zoomLevel);
 
@@ -159,6 +162,15 @@ private Q_SLOTS:
     void updateZoomSliderToolTip(int zoomLevel);
 
 private:
+    /**
+     * Creates the label, zoom slider, space information and progress
+     * sub-widgets and applies the state that has accumulated in the meantime.
+     * Most status bars belong to background tabs that are never shown, so the
+     * sub-widgets are only built once this status bar becomes visible for the
+     * first time. @see DolphinStatusBar::showEvent().
+     */
+    void ensureSubWidgetsCreated();
+
     /**
      * Makes the space information widget and zoom slider widget
      * visible, if \a visible is true and the settings allow to show
@@ -175,15 +187,24 @@ private:
 private:
     QString m_text;
     QString m_defaultText;
+
+    // The sub-widgets below are nullptr until this status bar is shown for
+    // the first time, see ensureSubWidgetsCreated(). Until then their state
+    // lives in the plain members next to them.
+    QWidget *m_contentsContainer;
     KSqueezedTextLabel *m_label;
     QLabel *m_zoomLabel;
     StatusBarSpaceInfo *m_spaceInfo;
+    QUrl m_url;
 
     QSlider *m_zoomSlider;
+    int m_zoomLevel;
 
     QLabel *m_progressTextLabel;
+    QString m_progressText;
     CancelLoading m_cancelLoading = CancelLoading::Allowed;
     QProgressBar *m_progressBar;
+    bool m_progressIndeterminate = false;
     QToolButton *m_stopButton;
     int m_progress;
     QTimer *m_showProgressBarTimer;
@@ -10,10 +10,26 @@
 
 #include <KIO/FileSystemFreeSpaceJob>
 
+#include <QFutureWatcher>
+#include <QStorageInfo>
+#include <QtConcurrentRun>
+
+namespace
+{
+// Changes of the available space below this fraction of the filesystem size
+// are not pushed to the users of the observer. They would not be noticeable
+// in the status bar but would trigger a repaint of every observing view.
+const quint64 SpaceInfoThresholdPermille = 1;
+}
+
 MountPointObserver::MountPointObserver(const QUrl &url, QObject *parent)
     : QObject(parent)
     , m_url(url)
     , m_referenceCount(0)
+    , m_updateInProgress(false)
+    , m_hasData(false)
+    , m_size(0)
+    , m_available(0)
 {
 }
 
@@ -27,6 +43,32 @@ void MountPointObserver::update()
 {
     if (m_referenceCount == 0) {
         delete this;
+        return;
+    }
+
+    if (m_updateInProgress) {
+        // Several users observe the same mount point. One running query is
+        // enough; its result is pushed to all of them.
+        return;
+    }
+    m_updateInProgress = true;
+
+    if (m_url.isLocalFile()) {
+        // A statfs call can block for a long time on hanging network mounts,
+        // so it is performed on a thread of the global thread pool.
+        const QString path = m_url.toLocalFile();
+        QFutureWatcher<QPair<quint64, quint64>> *watcher = new QFutureWatcher<QPair<quint64, quint64>>(this);
+        connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher]() {
+            watcher->deleteLater();
+            m_updateInProgress = false;
+            const QPair<quint64, quint64> spaceInfo = watcher->result();
+            setSpaceInfo(spaceInfo.first, spaceInfo.second);
+            Q_EMIT updateFinished();
+        });
+        watcher->setFuture(QtConcurrent::run([path]() {
+            const QStorageInfo storageInfo(path);
+            return qMakePair(quint64(qMax(storageInfo.bytesTotal(), qint64(0))), quint64(qMax(storageInfo.bytesAvailable(), qint64(0))));
+        }));
     } else {
         KIO::FileSystemFreeSpaceJob *job = KIO::fileSystemFreeSpace(m_url);
         connect(job, &KJob::result, this, &MountPointObserver::freeSpaceResult);
@@ -35,13 +77,30 @@ void MountPointObserver::update()
 
 void MountPointObserver::freeSpaceResult(KJob *job)
 {
+    m_updateInProgress = false;
     if (!job->error()) {
         KIO::FileSystemFreeSpaceJob *freeSpaceJob = qobject_cast<KIO::FileSystemFreeSpaceJob *>(job);
         Q_ASSERT(freeSpaceJob);
-        Q_EMIT spaceInfoChanged(freeSpaceJob->size(), freeSpaceJob->availableSize());
+        setSpaceInfo(freeSpaceJob->size(), freeSpaceJob->availableSize());
     } else {
-        Q_EMIT spaceInfoChanged(0, 0);
+        setSpaceInfo(0, 0);
+    }
+    Q_EMIT updateFinished();
+}
+
+void MountPointObserver::setSpaceInfo(quint64 size, quint64 available)
+{
+    if (m_hasData && size == m_size) {
+        const quint64 change = (available > m_available) ? available - m_available : m_available - available;
+        if (change * 1000 <= size * SpaceInfoThresholdPermille) {
+            return;
+        }
     }
+
+    m_hasData = true;
+    m_size = size;
+    m_available = available;
+    Q_EMIT spaceInfoChanged(size, available);
 }
 
 #include "moc_mountpointobserver.cpp"
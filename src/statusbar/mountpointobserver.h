@@ -73,12 +73,40 @@ public:
      */
     static MountPointObserver *observerForUrl(const QUrl &url);
 
+    /** @return True if at least one update has delivered space information. */
+    bool hasSpaceInfo() const
+    {
+        return m_hasData;
+    }
+
+    /** @return The size of the observed mount point as of the last update. */
+    quint64 size() const
+    {
+        return m_size;
+    }
+
+    /** @return The available space of the observed mount point as of the last update. */
+    quint64 available() const
+    {
+        return m_available;
+    }
+
 Q_SIGNALS:
     /**
-     * This signal is emitted when the size has been retrieved.
+     * This signal is emitted when the retrieved space information differs noticeably
+     * from the values emitted before. Unchanged results of the periodic updates are
+     * not pushed; new users can query the last values with size() and available().
      */
     void spaceInfoChanged(quint64 size, quint64 available);
 
+    /**
+     * This signal is emitted whenever an update has completed, even if the values
+     * did not change. Users which render cached values immediately can use it to
+     * tell values that are confirmed for the current mount state apart from stale
+     * ones that are still awaiting their first update.
+     */
+    void updateFinished();
+
 public Q_SLOTS:
     /**
      * If this slot is invoked, MountPointObserver starts a new driveSize job
@@ -90,8 +118,18 @@ private Q_SLOTS:
     void freeSpaceResult(KJob *job);
 
 private:
+    /**
+     * Stores the retrieved space information and emits spaceInfoChanged() unless the
+     * values match the previously emitted ones apart from an unnoticeable difference.
+     */
+    void setSpaceInfo(quint64 size, quint64 available);
+
     const QUrl m_url;
     int m_referenceCount;
+    bool m_updateInProgress;
+    bool m_hasData;
+    quint64 m_size;
+    quint64 m_available;
 
     friend class MountPointObserverCache;
 };
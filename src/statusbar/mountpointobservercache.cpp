@@ -10,8 +10,14 @@
 
 #include <KMountPoint>
 
+#include <QSocketNotifier>
 #include <QTimer>
 
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 class MountPointObserverCacheSingleton
 {
 public:
@@ -23,12 +29,35 @@ MountPointObserverCache::MountPointObserverCache()
     : m_observerForMountPoint()
     , m_mountPointForObserver()
     , m_updateTimer(nullptr)
+    , m_mountTableChangedTimer(nullptr)
+    , m_mountInfoNotifier(nullptr)
+    , m_mountInfoFd(-1)
 {
     m_updateTimer = new QTimer(this);
+
+    m_mountTableChangedTimer = new QTimer(this);
+    m_mountTableChangedTimer->setSingleShot(true);
+    m_mountTableChangedTimer->setInterval(100);
+
+#ifdef Q_OS_LINUX
+    // The kernel flags an exceptional condition on /proc/self/mountinfo
+    // whenever the mount table changes, so mounts and unmounts can be picked
+    // up event-driven instead of only on the minutely update cycle.
+    m_mountInfoFd = ::open("/proc/self/mountinfo", O_RDONLY | O_CLOEXEC);
+    if (m_mountInfoFd >= 0) {
+        m_mountInfoNotifier = new QSocketNotifier(m_mountInfoFd, QSocketNotifier::Exception, this);
+        connect(m_mountInfoNotifier, &QSocketNotifier::activated, this, &MountPointObserverCache::slotMountTableChanged);
+    }
+#endif
 }
 
 MountPointObserverCache::~MountPointObserverCache()
 {
+#ifdef Q_OS_LINUX
+    if (m_mountInfoFd >= 0) {
+        ::close(m_mountInfoFd);
+    }
+#endif
 }
 
 MountPointObserverCache *MountPointObserverCache::instance()
@@ -68,11 +97,28 @@ MountPointObserver *MountPointObserverCache::observerForUrl(const QUrl &url)
         }
 
         connect(m_updateTimer, &QTimer::timeout, observer, &MountPointObserver::update);
+        connect(m_mountTableChangedTimer, &QTimer::timeout, observer, &MountPointObserver::update);
     }
 
     return observer;
 }
 
+void MountPointObserverCache::slotMountTableChanged()
+{
+#ifdef Q_OS_LINUX
+    // Consume the current mount table so that the exceptional condition is
+    // cleared and the notifier re-arms for the next change.
+    ::lseek(m_mountInfoFd, 0, SEEK_SET);
+    char buffer[4096];
+    while (::read(m_mountInfoFd, buffer, sizeof(buffer)) > 0) { }
+#endif
+
+    if (!m_mountPointForObserver.isEmpty()) {
+        // (Re)starting the timer coalesces bursts of mount events into a single update of all observers.
+        m_mountTableChangedTimer->start();
+    }
+}
+
 void MountPointObserverCache::slotObserverDestroyed(QObject *observer)
 {
     Q_ASSERT(m_mountPointForObserver.contains(observer));
@@ -85,6 +131,7 @@ void MountPointObserverCache::slotObserverDestroyed(QObject *observer)
 
     if (m_mountPointForObserver.isEmpty()) {
         m_updateTimer->stop();
+        m_mountTableChangedTimer->stop();
     }
 }
 
@@ -11,6 +11,7 @@
 #include <QObject>
 
 class MountPointObserver;
+class QSocketNotifier;
 class QTimer;
 
 class MountPointObserverCache : public QObject
@@ -34,11 +35,32 @@ private Q_SLOTS:
      */
     void slotObserverDestroyed(QObject *observer);
 
+    /**
+     * Is invoked when the kernel flags a change of the mount table on
+     * /proc/self/mountinfo. Schedules an update of all observers through
+     * m_mountTableChangedTimer, so that mounts and unmounts propagate to the
+     * status bars and the places panel within a split second instead of
+     * waiting for the next minutely update.
+     */
+    void slotMountTableChanged();
+
 private:
     QHash<QUrl, MountPointObserver *> m_observerForMountPoint;
     QHash<QObject *, QUrl> m_mountPointForObserver;
     QTimer *m_updateTimer;
 
+    /**
+     * Single-shot timer which triggers an update of all observers shortly
+     * after the mount table changed. The small delay coalesces bursts of
+     * mount events - mounting one device can touch the table several times -
+     * and gives the mount some time to settle before it is queried.
+     */
+    QTimer *m_mountTableChangedTimer;
+
+    /** Watches /proc/self/mountinfo for mount table changes. Remains nullptr on platforms without procfs. */
+    QSocketNotifier *m_mountInfoNotifier;
+    int m_mountInfoFd;
+
     friend class MountPointObserverCacheSingleton;
 };
 
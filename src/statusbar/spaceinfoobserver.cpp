@@ -52,6 +52,12 @@ void SpaceInfoObserver::setUrl(const QUrl &url)
         m_mountPointObserver->ref();
         connect(m_mountPointObserver, &MountPointObserver::spaceInfoChanged, this, &SpaceInfoObserver::spaceInfoChanged);
 
+        if (m_mountPointObserver->hasSpaceInfo()) {
+            // A shared observer only pushes changed values, so take over its
+            // last result right away instead of waiting for the next change.
+            spaceInfoChanged(m_mountPointObserver->size(), m_mountPointObserver->available());
+        }
+
         // If newObserver is cached it won't call update until the next timer update,
         // so update the observer now.
         m_mountPointObserver->update();
@@ -29,10 +29,8 @@ StatusBarSpaceInfo::StatusBarSpaceInfo(QWidget *parent)
     m_textInfoButton = new QToolButton(this);
     m_textInfoButton->setAutoRaise(true);
     m_textInfoButton->setPopupMode(QToolButton::InstantPopup);
-    auto menu = new DiskSpaceUsageMenu{this};
-    connect(menu, &DiskSpaceUsageMenu::showMessage, this, &StatusBarSpaceInfo::showMessage);
-    connect(menu, &DiskSpaceUsageMenu::showInstallationProgress, this, &StatusBarSpaceInfo::showInstallationProgress);
-    m_textInfoButton->setMenu(menu);
+    // The disk space usage menu is only created once this widget actually
+    // becomes visible. @see StatusBarSpaceInfo::showEvent().
 
     auto layout = new QHBoxLayout(this);
     // We reduce the outside margin of the flat button so it visually has the same margin as the status bar text label on the other end of the bar.
@@ -68,7 +66,9 @@ void StatusBarSpaceInfo::setUrl(const QUrl &url)
 {
     if (m_url != url) {
         m_url = url;
-        static_cast<DiskSpaceUsageMenu *>(m_textInfoButton->menu())->setUrl(url);
+        if (auto menu = static_cast<DiskSpaceUsageMenu *>(m_textInfoButton->menu())) {
+            menu->setUrl(url);
+        }
         m_hasSpaceInfo = false;
         if (m_observer) {
             m_observer.reset(new SpaceInfoObserver(m_url, this));
@@ -95,6 +95,17 @@ void StatusBarSpaceInfo::showEvent(QShowEvent *event)
         m_observer.reset(new SpaceInfoObserver(m_url, this));
         connect(m_observer.data(), &SpaceInfoObserver::valuesChanged, this, &StatusBarSpaceInfo::slotValuesChanged);
     }
+
+    if (!m_textInfoButton->menu()) {
+        // Most status bars are never interacted with, so the menu is only
+        // created once the space information actually becomes visible.
+        auto menu = new DiskSpaceUsageMenu{this};
+        menu->setUrl(m_url);
+        connect(menu, &DiskSpaceUsageMenu::showMessage, this, &StatusBarSpaceInfo::showMessage);
+        connect(menu, &DiskSpaceUsageMenu::showInstallationProgress, this, &StatusBarSpaceInfo::showInstallationProgress);
+        m_textInfoButton->setMenu(menu);
+    }
+
     QWidget::showEvent(event);
 }
 
@@ -0,0 +1,169 @@
+/*
+    SPDX-FileCopyrightText: 2026 The Dolphin Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "views/batchrenameengine.h"
+
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTest>
+
+class BatchRenameEngineTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void testPlaceholderPattern();
+    void testPatternWithoutPlaceholder();
+    void testConflictDetection();
+    void testExecution();
+    void testChainedRenames();
+
+private:
+    /** Creates empty files named @p fileNames in @p dir and @returns their items in the same order. */
+    KFileItemList createFiles(const QTemporaryDir &dir, const QStringList &fileNames) const;
+};
+
+void BatchRenameEngineTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+KFileItemList BatchRenameEngineTest::createFiles(const QTemporaryDir &dir, const QStringList &fileNames) const
+{
+    KFileItemList items;
+    for (const QString &fileName : fileNames) {
+        QFile file(dir.filePath(fileName));
+        if (!file.open(QIODevice::WriteOnly)) {
+            return KFileItemList();
+        }
+        items.append(KFileItem(QUrl::fromLocalFile(file.fileName())));
+    }
+    return items;
+}
+
+void BatchRenameEngineTest::testPlaceholderPattern()
+{
+    QTemporaryDir dir;
+    const KFileItemList items = createFiles(dir, {"a.jpg", "b.png", "c"});
+    QVERIFY(!items.isEmpty());
+
+    BatchRenameEngine engine(items);
+    engine.setNamePattern(QStringLiteral("image###"));
+
+    // The "#" run is replaced by the zero-padded position and the original
+    // extension of each file is kept.
+    const QList<QUrl> newUrls = engine.newUrls();
+    QCOMPARE(newUrls.at(0).fileName(), QStringLiteral("image001.jpg"));
+    QCOMPARE(newUrls.at(1).fileName(), QStringLiteral("image002.png"));
+    QCOMPARE(newUrls.at(2).fileName(), QStringLiteral("image003"));
+    QCOMPARE(engine.renameCount(), 3);
+
+    // A pattern with an extension of its own is taken as the complete name.
+    engine.setNamePattern(QStringLiteral("image#.webp"));
+    QCOMPARE(engine.newUrls().at(0).fileName(), QStringLiteral("image1.webp"));
+
+    // An empty pattern renames nothing.
+    engine.setNamePattern(QString());
+    QCOMPARE(engine.newUrls().at(0), items.at(0).url());
+    QCOMPARE(engine.renameCount(), 0);
+}
+
+void BatchRenameEngineTest::testPatternWithoutPlaceholder()
+{
+    QTemporaryDir dir;
+    const KFileItemList items = createFiles(dir, {"a.jpg", "b.jpg"});
+    QVERIFY(!items.isEmpty());
+
+    // Without a placeholder the position is inserted before the extension so
+    // the names stay distinct.
+    BatchRenameEngine engine(items);
+    engine.setNamePattern(QStringLiteral("holiday"));
+    QCOMPARE(engine.newUrls().at(0).fileName(), QStringLiteral("holiday (1).jpg"));
+    QCOMPARE(engine.newUrls().at(1).fileName(), QStringLiteral("holiday (2).jpg"));
+
+    engine.setNamePattern(QStringLiteral("holiday.png"));
+    QCOMPARE(engine.newUrls().at(0).fileName(), QStringLiteral("holiday (1).png"));
+}
+
+void BatchRenameEngineTest::testConflictDetection()
+{
+    QTemporaryDir dir;
+    const KFileItemList items = createFiles(dir, {"file2.txt", "file3.txt"});
+    QVERIFY(!items.isEmpty());
+
+    QSet<QUrl> occupiedUrls;
+    for (const KFileItem &item : items) {
+        occupiedUrls.insert(item.url());
+    }
+
+    // "file2.txt" becomes "file1.txt" and "file3.txt" becomes "file2.txt".
+    // The second target is occupied by a batch item which vacates the name,
+    // so this is no conflict.
+    BatchRenameEngine engine(items);
+    engine.setNamePattern(QStringLiteral("file#"));
+    QVERIFY(engine.conflicts(occupiedUrls).isEmpty());
+
+    // With an item named "file1.txt" outside the batch, the first target
+    // collides with it.
+    occupiedUrls.insert(QUrl::fromLocalFile(dir.filePath(QStringLiteral("file1.txt"))));
+    const QStringList conflictMessages = engine.conflicts(occupiedUrls);
+    QCOMPARE(conflictMessages.count(), 1);
+    QVERIFY(conflictMessages.first().contains(QStringLiteral("file1.txt")));
+}
+
+void BatchRenameEngineTest::testExecution()
+{
+    QTemporaryDir dir;
+    const KFileItemList items = createFiles(dir, {"a.txt", "b.txt", "c.txt"});
+    QVERIFY(!items.isEmpty());
+
+    BatchRenameEngine engine(items);
+    engine.setNamePattern(QStringLiteral("renamed##"));
+
+    QSignalSpy finishedSpy(&engine, &BatchRenameEngine::finished);
+    engine.start();
+    QVERIFY(finishedSpy.wait());
+
+    const auto newUrls = finishedSpy.first().at(0).value<QList<QUrl>>();
+    const auto errorMessages = finishedSpy.first().at(1).toStringList();
+    QVERIFY2(errorMessages.isEmpty(), qPrintable(errorMessages.join(QLatin1Char(' '))));
+    QVERIFY(QFile::exists(dir.filePath(QStringLiteral("renamed01.txt"))));
+    QVERIFY(QFile::exists(dir.filePath(QStringLiteral("renamed02.txt"))));
+    QVERIFY(QFile::exists(dir.filePath(QStringLiteral("renamed03.txt"))));
+    QVERIFY(!QFile::exists(dir.filePath(QStringLiteral("a.txt"))));
+    QCOMPARE(newUrls.at(0).fileName(), QStringLiteral("renamed01.txt"));
+}
+
+void BatchRenameEngineTest::testChainedRenames()
+{
+    QTemporaryDir dir;
+    const KFileItemList items = createFiles(dir, {"2.txt", "3.txt"});
+    QVERIFY(!items.isEmpty());
+
+    // "2.txt" becomes "1.txt" and "3.txt" becomes "2.txt". The second rename
+    // can only run once the first one has vacated the name "2.txt".
+    BatchRenameEngine engine(items);
+    engine.setNamePattern(QStringLiteral("#"));
+    QCOMPARE(engine.newUrls().at(0).fileName(), QStringLiteral("1.txt"));
+    QCOMPARE(engine.newUrls().at(1).fileName(), QStringLiteral("2.txt"));
+
+    QSignalSpy finishedSpy(&engine, &BatchRenameEngine::finished);
+    engine.start();
+    QVERIFY(finishedSpy.wait());
+
+    const auto errorMessages = finishedSpy.first().at(1).toStringList();
+    QVERIFY2(errorMessages.isEmpty(), qPrintable(errorMessages.join(QLatin1Char(' '))));
+    QVERIFY(QFile::exists(dir.filePath(QStringLiteral("1.txt"))));
+    QVERIFY(QFile::exists(dir.filePath(QStringLiteral("2.txt"))));
+    QVERIFY(!QFile::exists(dir.filePath(QStringLiteral("3.txt"))));
+}
+
+QTEST_GUILESS_MAIN(BatchRenameEngineTest)
+
+#include "batchrenameenginetest.cpp.moc"
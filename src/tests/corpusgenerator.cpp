@@ -0,0 +1,118 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "corpusgenerator.h"
+
+#include "testdir.h"
+
+#include <QUrl>
+
+namespace
+{
+/** A minimal deterministic pseudo-random step (xorshift), so corpora do not depend on the platform's random implementation. */
+uint nextState(uint state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+}
+
+CorpusGenerator::CorpusGenerator(const Parameters &parameters)
+    : m_parameters(parameters)
+{
+    Q_ASSERT(m_parameters.fanOut > 0);
+    Q_ASSERT(m_parameters.depth > 0);
+    Q_ASSERT(m_parameters.minimumNameLength > 0);
+    Q_ASSERT(m_parameters.maximumNameLength >= m_parameters.minimumNameLength);
+}
+
+QStringList CorpusGenerator::relativePaths() const
+{
+    QStringList paths;
+    uint state = m_parameters.seed + 1; // xorshift must not start at 0.
+    generateLevel(QString(), m_parameters.depth, state, paths);
+    return paths;
+}
+
+KFileItemList CorpusGenerator::itemList(const QString &urlPrefix) const
+{
+    const QStringList paths = relativePaths();
+    KFileItemList items;
+    items.reserve(paths.count());
+    for (const QString &path : paths) {
+        items << KFileItem(QUrl(urlPrefix + path), QString(), KFileItem::Unknown);
+    }
+    return items;
+}
+
+void CorpusGenerator::populate(TestDir *testDir) const
+{
+    const QStringList paths = relativePaths();
+    for (const QString &path : paths) {
+        if (path.endsWith(QLatin1Char('/'))) {
+            testDir->createDir(path.chopped(1));
+        } else {
+            testDir->createFile(path, QByteArray());
+        }
+    }
+}
+
+int CorpusGenerator::entryCount() const
+{
+    // Each directory of the tree contains fanOut entries; directoryInterval of them are sub-directories as long as depth allows it.
+    int count = 0;
+    int directoriesOnLevel = 1; // The root itself is not counted.
+    for (int level = 1; level <= m_parameters.depth; ++level) {
+        count += directoriesOnLevel * m_parameters.fanOut;
+        if (m_parameters.directoryInterval <= 0 || level == m_parameters.depth) {
+            break;
+        }
+        directoriesOnLevel *= (m_parameters.fanOut + m_parameters.directoryInterval - 1) / m_parameters.directoryInterval;
+    }
+    return count;
+}
+
+void CorpusGenerator::generateLevel(const QString &parentPath, int remainingDepth, uint &state, QStringList &paths) const
+{
+    QStringList subDirectories;
+    for (int i = 0; i < m_parameters.fanOut; ++i) {
+        const bool isDirectory = remainingDepth > 1 && m_parameters.directoryInterval > 0 && i % m_parameters.directoryInterval == 0;
+        QString name = generateName(state, i);
+        if (isDirectory) {
+            paths << parentPath + name + QLatin1Char('/');
+            subDirectories << parentPath + name + QLatin1Char('/');
+        } else {
+            if (!m_parameters.suffixes.isEmpty()) {
+                name += m_parameters.suffixes.at(i % m_parameters.suffixes.count());
+            }
+            paths << parentPath + name;
+        }
+    }
+
+    for (const QString &subDirectory : std::as_const(subDirectories)) {
+        generateLevel(subDirectory, remainingDepth - 1, state, paths);
+    }
+}
+
+QString CorpusGenerator::generateName(uint &state, int indexInDirectory) const
+{
+    state = nextState(state);
+    const int lengthRange = m_parameters.maximumNameLength - m_parameters.minimumNameLength + 1;
+    const int length = m_parameters.minimumNameLength + static_cast<int>(state % static_cast<uint>(lengthRange));
+
+    QString name;
+    name.reserve(length + 8);
+    for (int i = 0; i < length; ++i) {
+        state = nextState(state);
+        name += QLatin1Char(static_cast<char>('a' + state % 26));
+    }
+    // The index suffix guarantees uniqueness within a directory regardless of the pseudo-random letters.
+    name += QLatin1Char('-');
+    name += QString::number(indexInDirectory);
+    return name;
+}
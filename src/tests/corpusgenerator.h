@@ -0,0 +1,71 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef CORPUSGENERATOR_H
+#define CORPUSGENERATOR_H
+
+#include <KFileItem>
+
+#include <QString>
+#include <QStringList>
+
+class TestDir;
+
+/**
+ * CorpusGenerator produces parameterized synthetic directory trees for tests and benchmarks. The same parameters always produce the same corpus, so
+ * pathologies observed with huge production directories can be reproduced deterministically in CI-sized runs.
+ *
+ * There are two variants:
+ * - relativePaths()/itemList() generate the corpus in memory, for model and benchmark code that feeds items directly into a KFileItemModel.
+ * - populate() writes the corpus into a TestDir, for tests that need real directory listings (the TestDir lives wherever QTemporaryDir puts it,
+ *   typically tmpfs-backed /tmp).
+ */
+class CorpusGenerator
+{
+public:
+    struct Parameters {
+        /** How many entries each directory contains. */
+        int fanOut = 10;
+        /** How many directory levels are generated. A depth of 1 means a flat directory. */
+        int depth = 1;
+        /** Every how-many-th entry of a directory is a sub-directory. 0 means no sub-directories, which caps the effective depth at 1. */
+        int directoryInterval = 10;
+        /** File names are this long at least, padded with deterministically varying letters. */
+        int minimumNameLength = 4;
+        /** Name lengths vary between the minimum and this, so sorting and collation see realistic length distributions. */
+        int maximumNameLength = 24;
+        /** File name suffixes cycled through to produce a MIME type mix, e.g. {".txt", ".png", ".mp3"}. Empty means files without suffixes. */
+        QStringList suffixes = {QStringLiteral(".txt"), QStringLiteral(".png"), QStringLiteral(".mp3"), QStringLiteral(".pdf"), QString()};
+        /** Seed for the deterministic pseudo-random name generation. Different seeds produce different but reproducible corpora. */
+        uint seed = 0;
+    };
+
+    explicit CorpusGenerator(const Parameters &parameters = Parameters{});
+
+    /** @returns the paths of all corpus entries relative to the corpus root, directories first within each level, sorted by generation order. */
+    QStringList relativePaths() const;
+
+    /** @returns the corpus as a list of KFileItems below @p urlPrefix, without touching the file system. */
+    KFileItemList itemList(const QString &urlPrefix = QStringLiteral("file:///corpus/")) const;
+
+    /** Creates the corpus inside @p testDir. Directories are created implicitly, files are created empty. */
+    void populate(TestDir *testDir) const;
+
+    /** @returns how many entries (files and directories) the corpus contains in total. */
+    int entryCount() const;
+
+private:
+    /** Appends the entries of one directory level below @p parentPath to @p paths and recurses into its sub-directories. */
+    void generateLevel(const QString &parentPath, int remainingDepth, uint &state, QStringList &paths) const;
+
+    /** @returns a deterministic pseudo-random name, advancing @p state. */
+    QString generateName(uint &state, int indexInDirectory) const;
+
+private:
+    Parameters m_parameters;
+};
+
+#endif
@@ -0,0 +1,153 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "dolphinduplicatechecker.h"
+
+#include "testdir.h"
+
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTest>
+
+class DolphinDuplicateCheckerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void testCanCheck();
+    void testUniqueSizesNeedNoIo();
+    void testGroupsSmallFiles();
+    void testPartialHashCollision();
+    void testUnreadableFile();
+
+private:
+    /** Runs a checker over the files at @p paths inside @p dir and returns the groups of identical files as sorted lists of file names. */
+    QList<QStringList> check(TestDir &dir, const QStringList &paths, int *unreadableCount = nullptr);
+
+    KFileItemList itemsFor(TestDir &dir, const QStringList &paths) const;
+};
+
+void DolphinDuplicateCheckerTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+KFileItemList DolphinDuplicateCheckerTest::itemsFor(TestDir &dir, const QStringList &paths) const
+{
+    KFileItemList items;
+    for (const QString &path : paths) {
+        KFileItem item(QUrl::fromLocalFile(dir.path() + QLatin1Char('/') + path));
+        item.isDir(); // Trigger the stat so size() is resolved, like items coming from a loaded view.
+        items.append(item);
+    }
+    return items;
+}
+
+QList<QStringList> DolphinDuplicateCheckerTest::check(TestDir &dir, const QStringList &paths, int *unreadableCount)
+{
+    DolphinDuplicateChecker checker(itemsFor(dir, paths));
+    QSignalSpy finishedSpy(&checker, &DolphinDuplicateChecker::finished);
+    checker.start();
+    if (!finishedSpy.wait()) {
+        // Distinguishable from "no duplicates" so a hang fails the comparison.
+        return {{QStringLiteral("<timeout>")}};
+    }
+    if (unreadableCount) {
+        *unreadableCount = checker.unreadableFileCount();
+    }
+
+    const auto identicalGroups = finishedSpy.takeFirst().first().value<QList<QList<QUrl>>>();
+    QList<QStringList> namedGroups;
+    for (const QList<QUrl> &group : identicalGroups) {
+        QStringList names;
+        for (const QUrl &url : group) {
+            names.append(url.fileName());
+        }
+        names.sort();
+        namedGroups.append(names);
+    }
+    std::sort(namedGroups.begin(), namedGroups.end());
+    return namedGroups;
+}
+
+void DolphinDuplicateCheckerTest::testCanCheck()
+{
+    TestDir dir;
+    dir.createFile("a.txt");
+    dir.createFile("b.txt");
+    dir.createDir("subdir");
+
+    QVERIFY(DolphinDuplicateChecker::canCheck(itemsFor(dir, {"a.txt", "b.txt"})));
+    // A directory does not count as a comparable file.
+    QVERIFY(!DolphinDuplicateChecker::canCheck(itemsFor(dir, {"a.txt", "subdir"})));
+    QVERIFY(!DolphinDuplicateChecker::canCheck(itemsFor(dir, {"a.txt"})));
+}
+
+void DolphinDuplicateCheckerTest::testUniqueSizesNeedNoIo()
+{
+    TestDir dir;
+    dir.createFile("a.txt", "a");
+    dir.createFile("b.txt", "bb");
+    dir.createFile("c.txt", "ccc");
+
+    QCOMPARE(check(dir, {"a.txt", "b.txt", "c.txt"}), QList<QStringList>());
+}
+
+void DolphinDuplicateCheckerTest::testGroupsSmallFiles()
+{
+    TestDir dir;
+    dir.createFile("a.txt", "same contents");
+    dir.createFile("b.txt", "same contents");
+    dir.createFile("c.txt", "diff contents"); // Same size as a/b, different contents.
+    dir.createFile("d.txt", "other");
+    dir.createFile("e.txt", "other");
+
+    const QList<QStringList> expected{{QStringLiteral("a.txt"), QStringLiteral("b.txt")}, {QStringLiteral("d.txt"), QStringLiteral("e.txt")}};
+    QCOMPARE(check(dir, {"a.txt", "b.txt", "c.txt", "d.txt", "e.txt"}), expected);
+}
+
+void DolphinDuplicateCheckerTest::testPartialHashCollision()
+{
+    // Files that share their size and their first bytes far beyond the
+    // partial-hash range must still be told apart by the full-hash stage.
+    QByteArray commonPrefix(512 * 1024, 'x');
+    TestDir dir;
+    dir.createFile("a.bin", commonPrefix + "1");
+    dir.createFile("b.bin", commonPrefix + "2");
+    dir.createFile("c.bin", commonPrefix + "1");
+
+    const QList<QStringList> expected{{QStringLiteral("a.bin"), QStringLiteral("c.bin")}};
+    QCOMPARE(check(dir, {"a.bin", "b.bin", "c.bin"}), expected);
+}
+
+void DolphinDuplicateCheckerTest::testUnreadableFile()
+{
+    TestDir dir;
+    dir.createFile("a.txt", "same contents");
+    dir.createFile("b.txt", "same contents");
+    dir.createFile("gone.txt", "same contents");
+
+    // The items are created while the file still exists, then the file
+    // disappears before the hashing starts.
+    const KFileItemList items = itemsFor(dir, {"a.txt", "b.txt", "gone.txt"});
+    dir.removeFile("gone.txt");
+
+    DolphinDuplicateChecker checker(items);
+    QSignalSpy finishedSpy(&checker, &DolphinDuplicateChecker::finished);
+    checker.start();
+    QVERIFY(finishedSpy.wait());
+
+    QCOMPARE(checker.unreadableFileCount(), 1);
+    const auto identicalGroups = finishedSpy.takeFirst().first().value<QList<QList<QUrl>>>();
+    QCOMPARE(identicalGroups.count(), 1);
+    QCOMPARE(identicalGroups.first().count(), 2);
+}
+
+QTEST_GUILESS_MAIN(DolphinDuplicateCheckerTest)
+
+#include "dolphinduplicatecheckertest.moc"
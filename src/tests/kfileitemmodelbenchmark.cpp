@@ -11,7 +11,9 @@
 
 #include <random>
 
+#include "corpusgenerator.h"
 #include "kitemviews/kfileitemmodel.h"
+#include "kitemviews/kitemset.h"
 #include "kitemviews/private/kfileitemmodelsortalgorithm.h"
 
 void myMessageOutput(QtMsgType type, const QMessageLogContext &context, const QString &msg)
@@ -48,9 +50,24 @@ private Q_SLOTS:
     void initTestCase();
     void insertAndRemoveManyItems_data();
     void insertAndRemoveManyItems();
+    void insertCorpusItems_data();
+    void insertCorpusItems();
+    void refreshManyItems_data();
+    void refreshManyItems();
+    void nameFilterKeystrokes_data();
+    void nameFilterKeystrokes();
+    void resortAllItems_data();
+    void resortAllItems();
+    void groupedSorting_data();
+    void groupedSorting();
+    void kItemSetBulkOperations_data();
+    void kItemSetBulkOperations();
 
 private:
     static KFileItemList createFileItemList(const QStringList &fileNames, const QString &urlPrefix = QLatin1String("file:///"));
+
+    /** Fills \a model with \a count items named after their number, without natural sorting to keep the sorting overhead low. */
+    static void populateModel(KFileItemModel &model, int count);
 };
 
 KFileItemModelBenchmark::KFileItemModelBenchmark()
@@ -198,6 +215,192 @@ void KFileItemModelBenchmark::insertAndRemoveManyItems()
     }
 }
 
+void KFileItemModelBenchmark::insertCorpusItems_data()
+{
+    QTest::addColumn<int>("fanOut");
+    QTest::addColumn<int>("depth");
+
+    QTest::newRow("flat fanOut=100000") << 100000 << 1;
+    QTest::newRow("deep fanOut=200 depth=3") << 200 << 3;
+}
+
+void KFileItemModelBenchmark::insertCorpusItems()
+{
+    QFETCH(int, fanOut);
+    QFETCH(int, depth);
+
+    // Unlike the numbered items of the other benchmarks, the corpus has realistic name lengths and a MIME type mix, so collation does real work here.
+    CorpusGenerator::Parameters parameters;
+    parameters.fanOut = fanOut;
+    parameters.depth = depth;
+    const KFileItemList items = CorpusGenerator{parameters}.itemList();
+
+    KFileItemModel model;
+    model.setRoles({"text"});
+
+    QBENCHMARK {
+        model.slotClear();
+        model.slotItemsAdded(model.directory(), items);
+        model.slotCompleted();
+    }
+
+    QVERIFY(model.isConsistent());
+    QCOMPARE(model.count(), items.count());
+}
+
+void KFileItemModelBenchmark::refreshManyItems_data()
+{
+    QTest::addColumn<int>("itemCount");
+
+    QTest::newRow("n=10000") << 10000;
+    QTest::newRow("n=100000") << 100000;
+}
+
+void KFileItemModelBenchmark::refreshManyItems()
+{
+    QFETCH(int, itemCount);
+
+    KFileItemModel model;
+    populateModel(model, itemCount);
+
+    // A refresh which changes no item at all measures the pure diffing cost,
+    // which is the part every refresh pays.
+    QList<QPair<KFileItem, KFileItem>> refreshedItems;
+    refreshedItems.reserve(itemCount);
+    for (int i = 0; i < itemCount; ++i) {
+        const KFileItem item = model.fileItem(i);
+        refreshedItems.append(qMakePair(item, item));
+    }
+
+    QBENCHMARK {
+        model.slotRefreshItems(refreshedItems);
+    }
+
+    QVERIFY(model.isConsistent());
+    QCOMPARE(model.count(), itemCount);
+}
+
+void KFileItemModelBenchmark::nameFilterKeystrokes_data()
+{
+    QTest::addColumn<int>("itemCount");
+
+    QTest::newRow("n=10000") << 10000;
+    QTest::newRow("n=100000") << 100000;
+}
+
+void KFileItemModelBenchmark::nameFilterKeystrokes()
+{
+    QFETCH(int, itemCount);
+
+    KFileItemModel model;
+    populateModel(model, itemCount);
+
+    // Simulates typing "123" into the filter bar and clearing it again, which
+    // exercises both the narrowing and the re-showing direction.
+    QBENCHMARK {
+        model.setNameFilter(QStringLiteral("1"));
+        model.setNameFilter(QStringLiteral("12"));
+        model.setNameFilter(QStringLiteral("123"));
+        model.setNameFilter(QString());
+    }
+
+    QVERIFY(model.isConsistent());
+    QCOMPARE(model.count(), itemCount);
+}
+
+void KFileItemModelBenchmark::resortAllItems_data()
+{
+    QTest::addColumn<QByteArray>("sortRole");
+
+    QTest::newRow("text") << QByteArrayLiteral("text");
+    QTest::newRow("size") << QByteArrayLiteral("size");
+    QTest::newRow("modificationtime") << QByteArrayLiteral("modificationtime");
+}
+
+void KFileItemModelBenchmark::resortAllItems()
+{
+    QFETCH(QByteArray, sortRole);
+
+    KFileItemModel model;
+    model.setRoles({"text", "size", "modificationtime"});
+    populateModel(model, 100000);
+
+    // The sorting core is benchmarked directly on a copy of the item list so
+    // the measurement stays synchronous; a full setSortRole() call would
+    // offload a model of this size to the background resort worker.
+    model.m_sortRole = model.typeForRole(sortRole);
+
+    QBENCHMARK {
+        QList<KFileItemModel::ItemData *> sortedItems = model.m_itemData;
+        model.sort(sortedItems.begin(), sortedItems.end());
+    }
+}
+
+void KFileItemModelBenchmark::groupedSorting_data()
+{
+    QTest::addColumn<QByteArray>("sortRole");
+
+    QTest::newRow("text") << QByteArrayLiteral("text");
+    QTest::newRow("size") << QByteArrayLiteral("size");
+}
+
+void KFileItemModelBenchmark::groupedSorting()
+{
+    QFETCH(QByteArray, sortRole);
+
+    KFileItemModel model;
+    model.setRoles({"text", "size"});
+    populateModel(model, 100000);
+    model.setSortRole(sortRole, false);
+    model.setGroupedSorting(true);
+
+    QBENCHMARK {
+        // groups() caches its result, so the cache is dropped to measure the
+        // computation of the group boundaries.
+        model.m_groups.clear();
+        const QList<QPair<int, QVariant>> groups = model.groups();
+        QVERIFY(!groups.isEmpty());
+    }
+}
+
+void KFileItemModelBenchmark::kItemSetBulkOperations_data()
+{
+    QTest::addColumn<int>("itemCount");
+
+    QTest::newRow("n=1000") << 1000;
+    QTest::newRow("n=10000") << 10000;
+    QTest::newRow("n=100000") << 100000;
+    QTest::newRow("n=1000000") << 1000000;
+}
+
+void KFileItemModelBenchmark::kItemSetBulkOperations()
+{
+    QFETCH(int, itemCount);
+
+    // Inserting every second index creates the worst case for the range-based
+    // storage of KItemSet: no two entries can be merged into one range.
+    QBENCHMARK {
+        KItemSet set;
+        for (int i = 0; i < itemCount; i += 2) {
+            set.insert(i);
+        }
+
+        int hits = 0;
+        for (int i = 0; i < itemCount; ++i) {
+            if (set.contains(i)) {
+                ++hits;
+            }
+        }
+        QCOMPARE(hits, (itemCount + 1) / 2);
+
+        qint64 sum = 0;
+        for (int i : set) {
+            sum += i;
+        }
+        QVERIFY(sum >= 0);
+    }
+}
+
 KFileItemList KFileItemModelBenchmark::createFileItemList(const QStringList &fileNames, const QString &prefix)
 {
     // Suppress 'file does not exist anymore' messages from KFileItemPrivate::init().
@@ -211,6 +414,23 @@ KFileItemList KFileItemModelBenchmark::createFileItemList(const QStringList &fil
     return result;
 }
 
+void KFileItemModelBenchmark::populateModel(KFileItemModel &model, int count)
+{
+    QStringList fileNames;
+    for (int i = 0; i < count; ++i) {
+        fileNames << QString::number(i);
+    }
+    fileNames.sort();
+
+    // Avoid overhead caused by natural sorting
+    // and determining the isDir/isLink roles.
+    model.m_naturalSorting = false;
+
+    model.slotItemsAdded(model.directory(), createFileItemList(fileNames));
+    model.slotCompleted();
+    QCOMPARE(model.count(), count);
+}
+
 QTEST_MAIN(KFileItemModelBenchmark)
 
 #include "kfileitemmodelbenchmark.moc"
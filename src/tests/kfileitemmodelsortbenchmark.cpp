@@ -0,0 +1,215 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <QStandardPaths>
+#include <QTest>
+
+#include <algorithm>
+#include <random>
+
+#include "kitemviews/kfileitemmodel.h"
+
+void myMessageOutput(QtMsgType type, const QMessageLogContext &context, const QString &msg)
+{
+    Q_UNUSED(context)
+
+    switch (type) {
+    case QtDebugMsg:
+        break;
+    case QtWarningMsg:
+        break;
+    case QtCriticalMsg:
+        fprintf(stderr, "Critical: %s\n", msg.toLocal8Bit().data());
+        break;
+    case QtFatalMsg:
+        fprintf(stderr, "Fatal: %s\n", msg.toLocal8Bit().data());
+        abort();
+    default:
+        break;
+    }
+}
+
+/**
+ * Benchmarks the sorting core KFileItemModel::sort() in isolation, with the
+ * three input shapes that bound its behavior: collation-heavy names which
+ * keep the collator off its ASCII fast path, numbered names under natural
+ * sorting, and presorted input which is the best case of the merge sort.
+ *
+ * Build with -DDOLPHIN_SORT_PROFILING=ON to additionally get comparison,
+ * merge and per-thread busy-time counters out of every run via the telemetry
+ * D-Bus interface.
+ */
+class KFileItemModelSortBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void sortCollationHeavyNames_data();
+    void sortCollationHeavyNames();
+    void sortNumberedNamesNaturally_data();
+    void sortNumberedNamesNaturally();
+    void sortPresortedNames_data();
+    void sortPresortedNames();
+
+private:
+    static KFileItemList createFileItemList(const QStringList &fileNames);
+
+    /** @returns \a count unique names built from characters which differ only by case or diacritics. */
+    static QStringList collationHeavyNames(int count);
+
+    /** Fills \a model with items named after \a fileNames, with natural sorting enabled. */
+    static void populateModel(KFileItemModel &model, const QStringList &fileNames);
+
+    /**
+     * Benchmarks model.sort() on a copy of the item list, so the measurement
+     * stays synchronous and the model order is not modified between the
+     * benchmark iterations. If \a shuffled is true, the items are sorted from
+     * a deterministically shuffled order instead of the presorted model order.
+     */
+    static void benchmarkSort(KFileItemModel &model, bool shuffled);
+
+    static void addItemCountRows();
+};
+
+void KFileItemModelSortBenchmark::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void KFileItemModelSortBenchmark::addItemCountRows()
+{
+    QTest::addColumn<int>("itemCount");
+
+    QTest::newRow("n=10000") << 10000;
+    QTest::newRow("n=100000") << 100000;
+}
+
+void KFileItemModelSortBenchmark::sortCollationHeavyNames_data()
+{
+    addItemCountRows();
+}
+
+void KFileItemModelSortBenchmark::sortCollationHeavyNames()
+{
+    QFETCH(int, itemCount);
+
+    KFileItemModel model;
+    populateModel(model, collationHeavyNames(itemCount));
+
+    benchmarkSort(model, true);
+}
+
+void KFileItemModelSortBenchmark::sortNumberedNamesNaturally_data()
+{
+    addItemCountRows();
+}
+
+void KFileItemModelSortBenchmark::sortNumberedNamesNaturally()
+{
+    QFETCH(int, itemCount);
+
+    // Numbered names exercise the numeric mode of the collator, which has to
+    // compare the embedded numbers by value so that file9 sorts before file10.
+    QStringList fileNames;
+    fileNames.reserve(itemCount);
+    for (int i = 0; i < itemCount; ++i) {
+        fileNames << QStringLiteral("file%1.txt").arg(i);
+    }
+
+    KFileItemModel model;
+    populateModel(model, fileNames);
+
+    benchmarkSort(model, true);
+}
+
+void KFileItemModelSortBenchmark::sortPresortedNames_data()
+{
+    addItemCountRows();
+}
+
+void KFileItemModelSortBenchmark::sortPresortedNames()
+{
+    QFETCH(int, itemCount);
+
+    // The same corpus as sortNumberedNamesNaturally(), but sorted from the
+    // already sorted model order. Resorting an unchanged directory is the
+    // best case of the merge sort, so the gap between the two benchmarks
+    // shows how much of the cost is comparisons rather than item movement.
+    QStringList fileNames;
+    fileNames.reserve(itemCount);
+    for (int i = 0; i < itemCount; ++i) {
+        fileNames << QStringLiteral("file%1.txt").arg(i);
+    }
+
+    KFileItemModel model;
+    populateModel(model, fileNames);
+
+    benchmarkSort(model, false);
+}
+
+KFileItemList KFileItemModelSortBenchmark::createFileItemList(const QStringList &fileNames)
+{
+    // Suppress 'file does not exist anymore' messages from KFileItemPrivate::init().
+    qInstallMessageHandler(myMessageOutput);
+
+    KFileItemList result;
+    for (const QString &name : fileNames) {
+        const KFileItem item(QUrl::fromLocalFile(QLatin1String("file:///") + name), QString(), KFileItem::Unknown);
+        result << item;
+    }
+    return result;
+}
+
+QStringList KFileItemModelSortBenchmark::collationHeavyNames(int count)
+{
+    // Characters which only differ by case or diacritics keep the collator
+    // off its ASCII fast path for every single comparison.
+    const QString alphabet = QStringLiteral("aAàÀäÄeEéÉèÈoOöÖuUüÜß");
+
+    QStringList names;
+    names.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        QString name;
+        int rest = i;
+        for (int j = 0; j < 8; ++j) {
+            name += alphabet.at(rest % alphabet.size());
+            rest /= 3;
+        }
+        // The numeric suffix makes the names unique; the long shared prefixes
+        // above it are what makes the comparisons expensive.
+        names << name + QLatin1Char('-') + QString::number(i);
+    }
+    return names;
+}
+
+void KFileItemModelSortBenchmark::populateModel(KFileItemModel &model, const QStringList &fileNames)
+{
+    model.setRoles({"text"});
+    model.m_naturalSorting = true;
+
+    model.slotItemsAdded(model.directory(), createFileItemList(fileNames));
+    model.slotCompleted();
+    QCOMPARE(model.count(), fileNames.count());
+}
+
+void KFileItemModelSortBenchmark::benchmarkSort(KFileItemModel &model, bool shuffled)
+{
+    QList<KFileItemModel::ItemData *> source = model.m_itemData;
+    if (shuffled) {
+        // A fixed seed keeps the input order identical between runs.
+        std::shuffle(source.begin(), source.end(), std::mt19937(0));
+    }
+
+    QBENCHMARK {
+        QList<KFileItemModel::ItemData *> sortedItems = source;
+        model.sort(sortedItems.begin(), sortedItems.end());
+    }
+}
+
+QTEST_MAIN(KFileItemModelSortBenchmark)
+
+#include "kfileitemmodelsortbenchmark.moc"
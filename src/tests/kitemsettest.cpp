@@ -97,14 +97,22 @@ private Q_SLOTS:
     void testChangingOneItem();
     void testAddSets_data();
     void testAddSets();
-    /*
     void testSubtractSets_data();
     void testSubtractSets();
-    */
+    void testIntersectSets_data();
+    void testIntersectSets();
     void testSymmetricDifference_data();
     void testSymmetricDifference();
+    void testInsertRemoveRange_data();
+    void testInsertRemoveRange();
+    void testAfterItemsMoved_data();
+    void testAfterItemsMoved();
+    void benchmarkSetOperations();
+    void benchmarkContains();
 
 private:
+    KItemSet createFragmentedSet(int rangeCount, int rangeLength) const;
+
     QHash<const char *, KItemRangeList> m_testCases;
 };
 
@@ -545,6 +553,92 @@ void KItemSetTest::testAddSets()
     QCOMPARE(KItemSet2QSet(sum), sumQSet);
 }
 
+void KItemSetTest::testSubtractSets_data()
+{
+    QTest::addColumn<KItemRangeList>("itemRanges1");
+    QTest::addColumn<KItemRangeList>("itemRanges2");
+
+    QHash<const char *, KItemRangeList>::const_iterator it1 = m_testCases.constBegin();
+    const QHash<const char *, KItemRangeList>::const_iterator end = m_testCases.constEnd();
+
+    while (it1 != end) {
+        QHash<const char *, KItemRangeList>::const_iterator it2 = m_testCases.constBegin();
+
+        while (it2 != end) {
+            QByteArray name = it1.key() + QByteArray(" - ") + it2.key();
+            QTest::newRow(name) << it1.value() << it2.value();
+            ++it2;
+        }
+
+        ++it1;
+    }
+}
+
+void KItemSetTest::testSubtractSets()
+{
+    QFETCH(KItemRangeList, itemRanges1);
+    QFETCH(KItemRangeList, itemRanges2);
+
+    KItemSet itemSet1 = KItemRangeList2KItemSet(itemRanges1);
+    QSet<int> itemsQSet1 = KItemRangeList2QSet(itemRanges1);
+
+    KItemSet itemSet2 = KItemRangeList2KItemSet(itemRanges2);
+    QSet<int> itemsQSet2 = KItemRangeList2QSet(itemRanges2);
+
+    KItemSet difference = itemSet1 - itemSet2;
+    QSet<int> differenceQSet = itemsQSet1 - itemsQSet2;
+
+    QVERIFY(difference.isValid());
+    QCOMPARE(difference.count(), differenceQSet.count());
+    QCOMPARE(KItemSet2QSet(difference), differenceQSet);
+
+    // Removing the difference from itemSet1 yields the intersection.
+    QCOMPARE(itemSet1 - difference, itemSet1 & itemSet2);
+}
+
+void KItemSetTest::testIntersectSets_data()
+{
+    QTest::addColumn<KItemRangeList>("itemRanges1");
+    QTest::addColumn<KItemRangeList>("itemRanges2");
+
+    QHash<const char *, KItemRangeList>::const_iterator it1 = m_testCases.constBegin();
+    const QHash<const char *, KItemRangeList>::const_iterator end = m_testCases.constEnd();
+
+    while (it1 != end) {
+        QHash<const char *, KItemRangeList>::const_iterator it2 = m_testCases.constBegin();
+
+        while (it2 != end) {
+            QByteArray name = it1.key() + QByteArray(" & ") + it2.key();
+            QTest::newRow(name) << it1.value() << it2.value();
+            ++it2;
+        }
+
+        ++it1;
+    }
+}
+
+void KItemSetTest::testIntersectSets()
+{
+    QFETCH(KItemRangeList, itemRanges1);
+    QFETCH(KItemRangeList, itemRanges2);
+
+    KItemSet itemSet1 = KItemRangeList2KItemSet(itemRanges1);
+    QSet<int> itemsQSet1 = KItemRangeList2QSet(itemRanges1);
+
+    KItemSet itemSet2 = KItemRangeList2KItemSet(itemRanges2);
+    QSet<int> itemsQSet2 = KItemRangeList2QSet(itemRanges2);
+
+    KItemSet intersection = itemSet1 & itemSet2;
+    QSet<int> intersectionQSet = itemsQSet1 & itemsQSet2;
+
+    QVERIFY(intersection.isValid());
+    QCOMPARE(intersection.count(), intersectionQSet.count());
+    QCOMPARE(KItemSet2QSet(intersection), intersectionQSet);
+
+    // Check commutativity.
+    QCOMPARE(itemSet2 & itemSet1, intersection);
+}
+
 void KItemSetTest::testSymmetricDifference_data()
 {
     QTest::addColumn<KItemRangeList>("itemRanges1");
@@ -593,6 +687,189 @@ void KItemSetTest::testSymmetricDifference()
     QCOMPARE(itemSet2 ^ symmetricDifference, itemSet1);
 }
 
+void KItemSetTest::testInsertRemoveRange_data()
+{
+    QTest::addColumn<KItemRangeList>("itemRanges");
+
+    QHash<const char *, KItemRangeList>::const_iterator it = m_testCases.constBegin();
+    const QHash<const char *, KItemRangeList>::const_iterator end = m_testCases.constEnd();
+
+    while (it != end) {
+        QTest::newRow(it.key()) << it.value();
+        ++it;
+    }
+}
+
+/**
+ * Verify that insertRange() and removeRange() behave exactly like inserting
+ * or removing each item of the range individually.
+ */
+void KItemSetTest::testInsertRemoveRange()
+{
+    QFETCH(KItemRangeList, itemRanges);
+
+    const KItemSet itemSet = KItemRangeList2KItemSet(itemRanges);
+
+    // Find the minimum and maximum items.
+    int min;
+    int max;
+
+    if (itemSet.isEmpty()) {
+        // Use some arbitrary values for the upcoming tests.
+        min = 0;
+        max = 5;
+    } else {
+        min = itemSet.first();
+        max = itemSet.last();
+    }
+
+    // Test ranges of different lengths at positions between min - 2 and max + 2.
+    for (int index = min - 2; index <= max + 2; ++index) {
+        for (int count = 0; count <= max - index + 2; ++count) {
+            {
+                KItemSet bulkInserted(itemSet);
+                bulkInserted.insertRange(index, count);
+
+                KItemSet reference(itemSet);
+                for (int i = index; i < index + count; ++i) {
+                    reference.insert(i);
+                }
+
+                QVERIFY(bulkInserted.isValid());
+                QCOMPARE(bulkInserted, reference);
+            }
+
+            {
+                KItemSet bulkRemoved(itemSet);
+                bulkRemoved.removeRange(index, count);
+
+                KItemSet reference(itemSet);
+                for (int i = index; i < index + count; ++i) {
+                    reference.remove(i);
+                }
+
+                QVERIFY(bulkRemoved.isValid());
+                QCOMPARE(bulkRemoved, reference);
+            }
+        }
+    }
+}
+
+void KItemSetTest::testAfterItemsMoved_data()
+{
+    QTest::addColumn<KItemRangeList>("itemRanges");
+
+    QHash<const char *, KItemRangeList>::const_iterator it = m_testCases.constBegin();
+    const QHash<const char *, KItemRangeList>::const_iterator end = m_testCases.constEnd();
+
+    while (it != end) {
+        QTest::newRow(it.key()) << it.value();
+        ++it;
+    }
+}
+
+/**
+ * Verify that afterItemsMoved() behaves exactly like mapping each item of
+ * the set individually through movedToIndexes.
+ */
+void KItemSetTest::testAfterItemsMoved()
+{
+    QFETCH(KItemRangeList, itemRanges);
+
+    const KItemSet itemSet = KItemRangeList2KItemSet(itemRanges);
+
+    if (itemSet.isEmpty()) {
+        QCOMPARE(itemSet.afterItemsMoved(KItemRange(0, 0), QList<int>()), itemSet);
+        return;
+    }
+
+    const int min = itemSet.first();
+    const int max = itemSet.last();
+
+    // Test moved ranges of different lengths at positions between min - 2 and max + 2.
+    for (int index = min - 2; index <= max + 2; ++index) {
+        for (int count = 1; count <= max - index + 2; ++count) {
+            // Some permutations of the moved range: the identity, a
+            // reversal, and rotations by one and by half the range.
+            QList<int> identity, reversal, rotation, halfRotation;
+            for (int i = 0; i < count; ++i) {
+                identity.append(index + i);
+                reversal.append(index + count - 1 - i);
+                rotation.append(index + (i + 1) % count);
+                halfRotation.append(index + (i + count / 2) % count);
+            }
+
+            const QList<QList<int>> permutations{identity, reversal, rotation, halfRotation};
+            for (const QList<int> &movedToIndexes : permutations) {
+                const KItemSet moved = itemSet.afterItemsMoved(KItemRange(index, count), movedToIndexes);
+
+                KItemSet reference;
+                for (int i : itemSet) {
+                    if (i >= index && i < index + count) {
+                        reference.insert(movedToIndexes.at(i - index));
+                    } else {
+                        reference.insert(i);
+                    }
+                }
+
+                QVERIFY(moved.isValid());
+                QCOMPARE(moved, reference);
+            }
+        }
+    }
+}
+
+/**
+ * Creates a fragmented set: \a rangeCount ranges of \a rangeLength items
+ * each, separated by one-item gaps. The ranges are appended directly so
+ * that the benchmarks do not measure the construction of the sets.
+ */
+KItemSet KItemSetTest::createFragmentedSet(int rangeCount, int rangeLength) const
+{
+    KItemSet result;
+    for (int i = 0; i < rangeCount; ++i) {
+        result.m_itemRanges.append(KItemRange(i * (rangeLength + 1), rangeLength));
+    }
+    Q_ASSERT(result.isValid());
+    return result;
+}
+
+/**
+ * Benchmark for the range-wise set operations, modelling a
+ * select-all-then-deselect workflow on a large fragmented selection.
+ */
+void KItemSetTest::benchmarkSetOperations()
+{
+    const KItemSet selection = createFragmentedSet(50000, 9);
+    const KItemSet toggledRange = createFragmentedSet(1, 250000);
+
+    QBENCHMARK {
+        const KItemSet sum = selection + toggledRange;
+        const KItemSet difference = selection - toggledRange;
+        const KItemSet intersection = selection & toggledRange;
+        const KItemSet symmetricDifference = selection ^ toggledRange;
+
+        QCOMPARE(sum.count() - difference.count(), toggledRange.count());
+        QCOMPARE(sum.count() - symmetricDifference.count(), intersection.count());
+    }
+}
+
+void KItemSetTest::benchmarkContains()
+{
+    const KItemSet selection = createFragmentedSet(50000, 9);
+    const int maxItem = selection.last();
+
+    QBENCHMARK {
+        int hits = 0;
+        for (int i = 0; i <= maxItem; i += 97) {
+            if (selection.contains(i)) {
+                ++hits;
+            }
+        }
+        QVERIFY(hits > 0);
+    }
+}
+
 QTEST_GUILESS_MAIN(KItemSetTest)
 
 #include "kitemsettest.moc"
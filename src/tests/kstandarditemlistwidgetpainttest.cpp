@@ -0,0 +1,163 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "kitemviews/kfileitemlistview.h"
+#include "kitemviews/kfileitemmodel.h"
+#include "kitemviews/kitemlistcontainer.h"
+#include "kitemviews/kitemlistcontroller.h"
+#include "kitemviews/kstandarditemlistwidget.h"
+#include "testdir.h"
+
+#include <QImage>
+#include <QPainter>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTest>
+
+/**
+ * Verifies that a steady-state repaint of the item widgets does not allocate:
+ * once icons are resolved and overlays are composed, repainting the same
+ * frame again must reuse the per-widget scratch buffers. The test uses the
+ * allocation counter of KStandardItemListWidget, so regressions that
+ * reintroduce per-item per-frame allocations on the paint path fail here
+ * instead of only showing up in heap profiles of long scrolls.
+ */
+class KStandardItemListWidgetPaintTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void testSteadyStateRepaintDoesNotAllocate();
+    void benchmarkSteadyStateRepaint();
+
+private:
+    /** Renders the container - and thereby all visible item widgets - offscreen. */
+    void renderOnce();
+
+    /**
+     * Loads a directory with a few files, waits until the view shows them and
+     * puts one widget into the states that need paint scratch buffers.
+     */
+    void prepareSteadyState();
+
+private:
+    KFileItemListView *m_view;
+    KItemListController *m_controller;
+    KFileItemModel *m_model;
+    TestDir *m_testDir;
+    KItemListContainer *m_container;
+};
+
+void KStandardItemListWidgetPaintTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void KStandardItemListWidgetPaintTest::init()
+{
+    qRegisterMetaType<KItemRangeList>("KItemRangeList");
+    qRegisterMetaType<KFileItemList>("KFileItemList");
+
+    m_testDir = new TestDir();
+    m_model = new KFileItemModel();
+    m_view = new KFileItemListView();
+    m_controller = new KItemListController(m_model, m_view, this);
+    m_container = new KItemListContainer(m_controller);
+    m_controller = m_container->controller();
+
+    m_container->resize(400, 400);
+    m_container->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_container));
+}
+
+void KStandardItemListWidgetPaintTest::cleanup()
+{
+    delete m_container;
+    m_container = nullptr;
+
+    delete m_model;
+    m_model = nullptr;
+
+    delete m_testDir;
+    m_testDir = nullptr;
+}
+
+void KStandardItemListWidgetPaintTest::renderOnce()
+{
+    QImage target(m_container->size(), QImage::Format_ARGB32_Premultiplied);
+    target.fill(Qt::transparent);
+    QPainter painter(&target);
+    m_container->render(&painter);
+}
+
+void KStandardItemListWidgetPaintTest::prepareSteadyState()
+{
+    QSignalSpy loadingCompletedSpy(m_model, &KFileItemModel::directoryLoadingCompleted);
+    QVERIFY(loadingCompletedSpy.isValid());
+
+    m_testDir->createFiles({"a.txt", "b.txt", "c.txt", "d.txt", "e.txt"});
+    m_model->loadDirectory(m_testDir->url());
+    QVERIFY(loadingCompletedSpy.wait());
+    QTRY_VERIFY(!m_view->visibleItemListWidgets().isEmpty());
+
+    // Cover the paths which need scratch buffers: one widget gets emblem
+    // overlays composed onto its icon and is hovered.
+    auto *widget = static_cast<KStandardItemListWidget *>(m_view->visibleItemListWidgets().first());
+    QHash<Qt::Corner, QString> overlays;
+    overlays.insert(Qt::BottomRightCorner, QStringLiteral("emblem-symbolic-link"));
+    widget->setOverlays(overlays);
+    widget->setHovered(true);
+
+    // Warm up until the frames stop allocating: the first paints still
+    // resolve themed icons from the event loop and recompose the overlays
+    // for each new icon pixmap.
+    for (int attempt = 0; attempt < 20; ++attempt) {
+        KStandardItemListWidget::resetPaintScratchBufferAllocations();
+        renderOnce();
+        if (KStandardItemListWidget::paintScratchBufferAllocations() == 0) {
+            break;
+        }
+        QTest::qWait(50);
+    }
+}
+
+void KStandardItemListWidgetPaintTest::testSteadyStateRepaintDoesNotAllocate()
+{
+    prepareSteadyState();
+
+    // Sanity check that the counter is wired up at all: recomposing the
+    // overlays for a changed icon pixmap must be counted.
+    auto *widget = static_cast<KStandardItemListWidget *>(m_view->visibleItemListWidgets().first());
+    QHash<Qt::Corner, QString> overlays;
+    overlays.insert(Qt::TopLeftCorner, QStringLiteral("emblem-locked"));
+    widget->setOverlays(overlays);
+    KStandardItemListWidget::resetPaintScratchBufferAllocations();
+    renderOnce();
+    QVERIFY(KStandardItemListWidget::paintScratchBufferAllocations() >= 1);
+
+    // The actual regression check: repainting an unchanged frame reuses the
+    // scratch buffers of every widget.
+    KStandardItemListWidget::resetPaintScratchBufferAllocations();
+    renderOnce();
+    QCOMPARE(KStandardItemListWidget::paintScratchBufferAllocations(), static_cast<qint64>(0));
+}
+
+void KStandardItemListWidgetPaintTest::benchmarkSteadyStateRepaint()
+{
+    prepareSteadyState();
+
+    QBENCHMARK {
+        renderOnce();
+    }
+}
+
+QTEST_MAIN(KStandardItemListWidgetPaintTest)
+
+#include "kstandarditemlistwidgetpainttest.moc"
@@ -0,0 +1,80 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "search/materializedsearchstore.h"
+
+#include <QStandardPaths>
+#include <QTest>
+
+class MaterializedSearchStoreTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void testRoundTrip();
+    void testReplacesPreviousSnapshot();
+    void testDistinctSearchUrls();
+};
+
+void MaterializedSearchStoreTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void MaterializedSearchStoreTest::testRoundTrip()
+{
+    const QUrl searchUrl(QStringLiteral("filenamesearch:/?search=report&url=file:///home/test"));
+    QVERIFY(!Search::MaterializedSearchStore::instance()->contains(searchUrl));
+    QVERIFY(Search::MaterializedSearchStore::instance()->load(searchUrl).isEmpty());
+
+    KFileItemList items;
+    items.append(KFileItem(QUrl::fromLocalFile(QStringLiteral("/home/test/report-2026.txt"))));
+    items.append(KFileItem(QUrl::fromLocalFile(QStringLiteral("/home/test/sub/report-old.txt"))));
+    Search::MaterializedSearchStore::instance()->save(searchUrl, items);
+
+    QVERIFY(Search::MaterializedSearchStore::instance()->contains(searchUrl));
+    const KFileItemList loaded = Search::MaterializedSearchStore::instance()->load(searchUrl);
+    QCOMPARE(loaded.count(), 2);
+    QCOMPARE(loaded.at(0).url(), items.at(0).url());
+    QCOMPARE(loaded.at(1).url(), items.at(1).url());
+}
+
+void MaterializedSearchStoreTest::testReplacesPreviousSnapshot()
+{
+    const QUrl searchUrl(QStringLiteral("filenamesearch:/?search=notes&url=file:///home/test"));
+
+    KFileItemList items;
+    items.append(KFileItem(QUrl::fromLocalFile(QStringLiteral("/home/test/notes.txt"))));
+    Search::MaterializedSearchStore::instance()->save(searchUrl, items);
+
+    items.clear();
+    items.append(KFileItem(QUrl::fromLocalFile(QStringLiteral("/home/test/meeting-notes.txt"))));
+    items.append(KFileItem(QUrl::fromLocalFile(QStringLiteral("/home/test/todo-notes.txt"))));
+    Search::MaterializedSearchStore::instance()->save(searchUrl, items);
+
+    const KFileItemList loaded = Search::MaterializedSearchStore::instance()->load(searchUrl);
+    QCOMPARE(loaded.count(), 2);
+    QCOMPARE(loaded.at(0).url(), items.at(0).url());
+}
+
+void MaterializedSearchStoreTest::testDistinctSearchUrls()
+{
+    const QUrl firstUrl(QStringLiteral("filenamesearch:/?search=alpha&url=file:///home/test"));
+    const QUrl secondUrl(QStringLiteral("filenamesearch:/?search=beta&url=file:///home/test"));
+
+    KFileItemList items;
+    items.append(KFileItem(QUrl::fromLocalFile(QStringLiteral("/home/test/alpha.txt"))));
+    Search::MaterializedSearchStore::instance()->save(firstUrl, items);
+
+    QVERIFY(Search::MaterializedSearchStore::instance()->contains(firstUrl));
+    QVERIFY(!Search::MaterializedSearchStore::instance()->contains(secondUrl));
+}
+
+QTEST_GUILESS_MAIN(MaterializedSearchStoreTest)
+
+#include "materializedsearchstoretest.moc"
@@ -7,6 +7,7 @@
 #include "views/viewproperties.h"
 #include "dolphin_generalsettings.h"
 #include "testdir.h"
+#include "views/viewpropertieswritebehindqueue.h"
 
 #include <KFileMetaData/UserMetaData>
 
@@ -101,6 +102,8 @@ void ViewPropertiesTest::testReadOnlyDirectory()
     QVERIFY(props->isAutoSaveEnabled());
     props->setSortRole("someNewSortRole");
     props.reset();
+    // The destructor merely schedules the write, see ViewPropertiesWriteBehindQueue.
+    ViewPropertiesWriteBehindQueue::instance().flush();
 
     qDebug() << destinationDir;
     QVERIFY(QDir(destinationDir).exists());
@@ -135,6 +138,8 @@ void ViewPropertiesTest::testAutoSave()
     QVERIFY(props->isAutoSaveEnabled());
     props->setSortRole("someNewSortRole");
     props.reset();
+    // The destructor merely schedules the write, see ViewPropertiesWriteBehindQueue.
+    ViewPropertiesWriteBehindQueue::instance().flush();
 
     KFileMetaData::UserMetaData metadata(m_testDir->url().toLocalFile());
     if (metadata.isSupported()) {
@@ -268,6 +273,8 @@ void ViewPropertiesTest::testExtendedAttributeFull()
     QVERIFY(props->isAutoSaveEnabled());
     props->setSortRole("someNewSortRole");
     props.reset();
+    // The destructor merely schedules the write, see ViewPropertiesWriteBehindQueue.
+    ViewPropertiesWriteBehindQueue::instance().flush();
 
     if (metadata.isSupported()) {
         auto viewProperties = metadata.attribute(QStringLiteral("kde.fm.viewproperties#1"));
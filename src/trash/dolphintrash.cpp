@@ -9,6 +9,7 @@
 
 #include <KConfig>
 #include <KConfigGroup>
+#include <KDirWatch>
 #include <KIO/DeleteOrTrashJob>
 #include <KLocalizedString>
 #include <KNotification>
@@ -17,47 +18,68 @@
 #include <Solid/StorageAccess>
 
 #include <QList>
+#include <QStandardPaths>
+#include <QTimer>
 
 Trash::Trash()
-    : m_trashDirLister(new KDirLister())
 {
-    // The trash icon must always be updated dependent on whether
-    // the trash is empty or not. We use a KDirLister that automatically
-    // watches for changes if the number of items has been changed.
-    m_trashDirLister->setAutoErrorHandlingEnabled(false);
-    m_trashDirLister->setDelayedMimeTypes(true);
-    auto trashDirContentChanged = [this]() {
-        bool isTrashEmpty = m_trashDirLister->items().isEmpty();
-        Q_EMIT emptinessChanged(isTrashEmpty);
+    m_isEmpty = isEmpty();
+
+    m_summaryRefreshTimer = new QTimer(this);
+    m_summaryRefreshTimer->setSingleShot(true);
+    m_summaryRefreshTimer->setInterval(1000);
+    connect(m_summaryRefreshTimer, &QTimer::timeout, this, &Trash::refreshSummary);
+
+    // The KIO trash worker maintains the "Empty" flag in trashrc with every
+    // operation. Watching that file keeps the trash icon up to date without
+    // ever listing the trash contents, which takes seconds for huge trashes.
+    const QString trashrcPath = QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation) + QLatin1String("/trashrc");
+    KDirWatch::self()->addFile(trashrcPath);
+    const auto trashConfigChanged = [this, trashrcPath](const QString &path) {
+        if (path != trashrcPath) {
+            // KDirWatch::self() is shared, ignore other watched files.
+            return;
+        }
+        // The flag only covers the home trash; the background summary
+        // refresh corrects the rare case that only a removable device trash
+        // holds items.
+        const bool isTrashEmpty = isEmpty();
+        if (isTrashEmpty != m_isEmpty) {
+            m_isEmpty = isTrashEmpty;
+            Q_EMIT emptinessChanged(isTrashEmpty);
+        }
+        scheduleSummaryRefresh();
     };
-    connect(m_trashDirLister, &KCoreDirLister::completed, this, trashDirContentChanged);
-    connect(m_trashDirLister, &KDirLister::itemsDeleted, this, trashDirContentChanged);
+    connect(KDirWatch::self(), &KDirWatch::dirty, this, trashConfigChanged);
+    connect(KDirWatch::self(), &KDirWatch::created, this, trashConfigChanged);
 
-    // Update trash directory when removable storage devices are changed to keep it in sync with the
-    // storage device .Trash-1000 folders
+    // Refresh the summary when removable storage devices are changed to keep
+    // it in sync with the storage device .Trash-1000 folders
     Solid::DeviceNotifier *notifier = Solid::DeviceNotifier::instance();
     connect(notifier, &Solid::DeviceNotifier::deviceAdded, this, [this](const QString &device) {
         const Solid::Device dev(device);
         if (dev.isValid() && dev.is<Solid::StorageAccess>()) {
             const Solid::StorageAccess *access = dev.as<Solid::StorageAccess>();
             connect(access, &Solid::StorageAccess::accessibilityChanged, this, [this]() {
-                m_trashDirLister->updateDirectory(QUrl(QStringLiteral("trash:/")));
+                scheduleSummaryRefresh();
             });
         }
     });
     connect(notifier, &Solid::DeviceNotifier::deviceRemoved, this, [this](const QString &device) {
         const Solid::Device dev(device);
         if (dev.isValid() && dev.is<Solid::StorageAccess>()) {
-            m_trashDirLister->updateDirectory(QUrl(QStringLiteral("trash:/")));
+            scheduleSummaryRefresh();
         }
     });
 
-    m_trashDirLister->openUrl(QUrl(QStringLiteral("trash:/")));
+    scheduleSummaryRefresh();
 }
 
 Trash::~Trash()
 {
-    delete m_trashDirLister;
+    if (m_summaryJob) {
+        m_summaryJob->kill();
+    }
 }
 
 Trash &Trash::instance()
@@ -94,4 +116,73 @@ bool Trash::isEmpty()
     return (trashConfig.group(QStringLiteral("Status")).readEntry("Empty", true));
 }
 
+qint64 Trash::itemCount() const
+{
+    return m_itemCount;
+}
+
+qint64 Trash::totalSize() const
+{
+    return m_totalSize;
+}
+
+void Trash::scheduleSummaryRefresh()
+{
+    m_summaryRefreshTimer->start();
+}
+
+void Trash::refreshSummary()
+{
+    if (m_summaryJob) {
+        // A refresh is running already; start over once it is done so the
+        // result reflects this newest change as well.
+        m_refreshPending = true;
+        return;
+    }
+
+    m_listedItemCount = 0;
+    m_listedTotalSize = 0;
+
+    KIO::ListJob *job = KIO::listDir(QUrl(QStringLiteral("trash:/")), KIO::HideProgressInfo);
+    m_summaryJob = job;
+
+    connect(job, &KIO::ListJob::entries, this, [this](KIO::Job *, const KIO::UDSEntryList &entries) {
+        for (const KIO::UDSEntry &entry : entries) {
+            const QString name = entry.stringValue(KIO::UDSEntry::UDS_NAME);
+            if (name == QLatin1Char('.') || name == QLatin1String("..")) {
+                continue;
+            }
+            ++m_listedItemCount;
+            m_listedTotalSize += entry.numberValue(KIO::UDSEntry::UDS_SIZE, 0);
+        }
+        // The listing streams in, so a huge trash is reported as non-empty
+        // as soon as the first entries arrive.
+        if (m_listedItemCount > 0 && m_isEmpty) {
+            m_isEmpty = false;
+            Q_EMIT emptinessChanged(false);
+        }
+    });
+
+    connect(job, &KJob::result, this, [this](KJob *job) {
+        m_summaryJob.clear();
+
+        if (job->error() == KJob::NoError) {
+            m_itemCount = m_listedItemCount;
+            m_totalSize = m_listedTotalSize;
+
+            const bool isTrashEmpty = (m_itemCount == 0);
+            if (isTrashEmpty != m_isEmpty) {
+                m_isEmpty = isTrashEmpty;
+                Q_EMIT emptinessChanged(isTrashEmpty);
+            }
+            Q_EMIT summaryChanged(m_itemCount, m_totalSize);
+        }
+
+        if (m_refreshPending) {
+            m_refreshPending = false;
+            scheduleSummaryRefresh();
+        }
+    });
+}
+
 #include "moc_dolphintrash.cpp"
@@ -8,10 +8,13 @@
 #ifndef DOLPHINTRASH_H
 #define DOLPHINTRASH_H
 
+#include <QPointer>
 #include <QWidget>
 
-#include <KDirLister>
 #include <KIO/EmptyTrashJob>
+#include <KIO/ListJob>
+
+class QTimer;
 
 class Trash : public QObject
 {
@@ -28,11 +31,53 @@ public:
     static void empty(QWidget *window);
     static bool isEmpty();
 
+    /**
+     * @return The cached number of items in the trash, or -1 while no
+     *         background summary refresh has completed yet.
+     */
+    qint64 itemCount() const;
+
+    /**
+     * @return The cached total size of the trash contents in bytes, or -1
+     *         while no background summary refresh has completed yet.
+     */
+    qint64 totalSize() const;
+
 Q_SIGNALS:
     void emptinessChanged(bool isEmpty);
 
+    /**
+     * Is emitted whenever a background summary refresh has completed, see
+     * itemCount() and totalSize().
+     */
+    void summaryChanged(qint64 itemCount, qint64 totalSize);
+
 private:
-    KDirLister *m_trashDirLister;
+    /**
+     * Starts a summary refresh once no trash change has happened for a
+     * moment. Changes come in bursts, e.g. while a big delete operation is
+     * running, and each refresh lists the whole trash.
+     */
+    void scheduleSummaryRefresh();
+
+    /**
+     * Lists trash:/ in the background and updates the cached summary. The
+     * listing streams in: The trash is already reported as non-empty when
+     * the first entries arrive, long before a huge trash has been fully
+     * enumerated.
+     */
+    void refreshSummary();
+
+    bool m_isEmpty = true;
+    qint64 m_itemCount = -1;
+    qint64 m_totalSize = -1;
+
+    QTimer *m_summaryRefreshTimer;
+    QPointer<KIO::ListJob> m_summaryJob;
+    /** Whether a trash change arrived while m_summaryJob was running. */
+    bool m_refreshPending = false;
+    qint64 m_listedItemCount = 0;
+    qint64 m_listedTotalSize = 0;
 
     Trash();
     ~Trash() override;
@@ -5,6 +5,7 @@
  */
 
 #include "dolphinfeedbackprovider.h"
+#include "performancedatasource.h"
 #include "placesdatasource.h"
 #include "settingsdatasource.h"
 
@@ -36,6 +37,7 @@ DolphinFeedbackProvider::DolphinFeedbackProvider()
     addDataSource(new KUserFeedback::ScreenInfoSource);
     addDataSource(new KUserFeedback::StartCountSource);
     addDataSource(new KUserFeedback::UsageTimeSource);
+    addDataSource(new PerformanceDataSource);
     addDataSource(new PlacesDataSource);
     addDataSource(new SettingsDataSource);
 }
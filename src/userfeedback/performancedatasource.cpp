@@ -0,0 +1,81 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "performancedatasource.h"
+
+#include "dolphinstartupprofiler.h"
+#include "kitemviews/private/kfileitemrolestelemetry.h"
+
+#include <KLocalizedString>
+#include <KUserFeedback/Provider>
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QVariant>
+
+PerformanceDataSource::PerformanceDataSource()
+    : KUserFeedback::AbstractDataSource(QStringLiteral("performance"), KUserFeedback::Provider::DetailedUsageStatistics)
+{
+}
+
+QString PerformanceDataSource::name() const
+{
+    return i18nc("name of kuserfeedback data source provided by dolphin", "Performance");
+}
+
+QString PerformanceDataSource::description() const
+{
+    return i18nc("description of kuserfeedback data source provided by dolphin",
+                 "Anonymized distributions of directory sizes, loading, sorting and preview durations, and startup timings");
+}
+
+QVariant PerformanceDataSource::data()
+{
+    QVariantMap map;
+
+    // Only this fixed allow-list of histograms is submitted. Every histogram
+    // is a list of power-of-two bucket counts (the upper bound of bucket i is
+    // 2^i), so the submitted values never identify a directory or file.
+    const struct {
+        const char *histogram;
+        const char *key;
+    } exportedHistograms[] = {
+        {"directory.items", "directoryItemsBuckets"},
+        {"directory.loadMsPer10kItems", "loadMsPer10kItemsBuckets"},
+        {"sort", "sortDurationMsBuckets"},
+        {"previewJob", "previewBatchMsBuckets"},
+    };
+
+    const QHash<QByteArray, QList<qint64>> histograms = KFileItemRolesTelemetry::instance()->histograms();
+    for (const auto &exported : exportedHistograms) {
+        const QList<qint64> buckets = histograms.value(exported.histogram);
+        if (buckets.isEmpty()) {
+            continue;
+        }
+        QVariantList values;
+        values.reserve(buckets.count());
+        for (qint64 count : buckets) {
+            values.append(count);
+        }
+        map.insert(QString::fromLatin1(exported.key), values);
+    }
+
+    const QHash<QByteArray, qint64> counters = KFileItemRolesTelemetry::instance()->counters();
+    map.insert(QStringLiteral("previewsResolved"), counters.value("resolved.preview") + counters.value("resolved.previewInProcess"));
+    map.insert(QStringLiteral("previewsFailed"), counters.value("failed.preview"));
+    map.insert(QStringLiteral("sortedItems"), counters.value("sort.items"));
+    map.insert(QStringLiteral("sortWallMs"), counters.value("sort.wallMs"));
+
+    // The startup phases of this start, in milliseconds since the top of
+    // main(). Only included once all phases have completed, so that a slow
+    // start that is still in progress does not submit misleading numbers.
+    const QJsonObject startup = QJsonDocument::fromJson(DolphinStartupProfiler::instance()->report().toUtf8()).object();
+    if (startup.value(QStringLiteral("complete")).toBool()) {
+        map.insert(QStringLiteral("startupPhasesMs"), startup.value(QStringLiteral("phasesMs")).toObject().toVariantMap());
+    }
+
+    return map;
+}
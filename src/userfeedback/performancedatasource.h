@@ -0,0 +1,32 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef PERFORMANCEDATASOURCE_H
+#define PERFORMANCEDATASOURCE_H
+
+#include <KUserFeedback/AbstractDataSource>
+
+/**
+ * Reports anonymized performance distributions: the sizes of the directories
+ * that were loaded, how long loading and sorting them took, the preview
+ * throughput, and the startup phase timings of DolphinStartupProfiler.
+ *
+ * All quantities are power-of-two bucket histograms or plain counters taken
+ * from KFileItemRolesTelemetry; no paths, names or other identifying values
+ * are included. Like all detailed sources the data is only submitted when
+ * the user opted into the highest telemetry level.
+ */
+class PerformanceDataSource : public KUserFeedback::AbstractDataSource
+{
+public:
+    PerformanceDataSource();
+
+    QString name() const override;
+    QString description() const override;
+    QVariant data() override;
+};
+
+#endif // PERFORMANCEDATASOURCE_H
@@ -0,0 +1,99 @@
+/*
+    SPDX-FileCopyrightText: 2026 The Dolphin Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "batchrenamedialog.h"
+
+#include "batchrenameengine.h"
+
+#include <KLocalizedString>
+
+#include <QDialogButtonBox>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+BatchRenameDialog::BatchRenameDialog(const KFileItemList &items, const QSet<QUrl> &occupiedUrls, QWidget *parent)
+    : QDialog(parent)
+    , m_engine(new BatchRenameEngine(items, this))
+    , m_occupiedUrls(occupiedUrls)
+{
+    setWindowTitle(i18ncp("@title:window", "Rename Item", "Rename Items", items.count()));
+
+    auto layout = new QVBoxLayout(this);
+    layout->addWidget(new QLabel(i18ncp("@label:textbox", "Rename the selected item to:", "Rename the %1 selected items to:", items.count()), this));
+
+    m_patternEdit = new QLineEdit(this);
+    // Propose the name of the first item. For more than one item the
+    // extension is dropped and a placeholder appended, so accepting the
+    // proposal numbers the items while each keeps its own extension.
+    QString proposal = items.first().name();
+    if (items.count() > 1) {
+        const int extensionIndex = proposal.lastIndexOf(QLatin1Char('.'));
+        if (extensionIndex > 0) {
+            proposal.truncate(extensionIndex);
+        }
+        proposal += QLatin1Char('#');
+    }
+    m_patternEdit->setText(proposal);
+    m_patternEdit->selectAll();
+    layout->addWidget(m_patternEdit);
+
+    if (items.count() > 1) {
+        auto hintLabel = new QLabel(i18nc("@info", "\"#\" is replaced by ascending numbers, more of them pad the numbers with zeros."), this);
+        hintLabel->setWordWrap(true);
+        layout->addWidget(hintLabel);
+    }
+
+    m_conflictLabel = new QLabel(this);
+    m_conflictLabel->setWordWrap(true);
+    m_conflictLabel->hide();
+    layout->addWidget(m_conflictLabel);
+
+    auto buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    m_okButton = buttonBox->button(QDialogButtonBox::Ok);
+    connect(buttonBox, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    layout->addWidget(buttonBox);
+
+    connect(m_patternEdit, &QLineEdit::textChanged, this, &BatchRenameDialog::slotPatternChanged);
+    connect(this, &QDialog::rejected, this, &QObject::deleteLater);
+
+    slotPatternChanged(m_patternEdit->text());
+}
+
+void BatchRenameDialog::accept()
+{
+    // The dialog is only hidden, not closed: it stays alive as the owner of
+    // the engine until every rename job has completed.
+    hide();
+    m_patternEdit->setEnabled(false);
+
+    connect(m_engine, &BatchRenameEngine::finished, this, [this](const QList<QUrl> &newUrls, const QStringList &errorMessages) {
+        if (!errorMessages.isEmpty()) {
+            Q_EMIT errorOccurred(errorMessages.join(QLatin1Char('\n')));
+        }
+        Q_EMIT renamingFinished(newUrls);
+        deleteLater();
+    });
+    m_engine->start();
+}
+
+void BatchRenameDialog::slotPatternChanged(const QString &pattern)
+{
+    m_engine->setNamePattern(pattern);
+
+    const QStringList conflictMessages = m_engine->conflicts(m_occupiedUrls);
+    if (conflictMessages.isEmpty()) {
+        m_conflictLabel->hide();
+    } else {
+        m_conflictLabel->setText(conflictMessages.first());
+        m_conflictLabel->show();
+    }
+    m_okButton->setEnabled(conflictMessages.isEmpty());
+}
+
+#include "moc_batchrenamedialog.cpp"
@@ -0,0 +1,72 @@
+/*
+    SPDX-FileCopyrightText: 2026 The Dolphin Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef BATCHRENAMEDIALOG_H
+#define BATCHRENAMEDIALOG_H
+
+#include "dolphin_export.h"
+
+#include <KFileItem>
+
+#include <QDialog>
+#include <QSet>
+#include <QUrl>
+
+class BatchRenameEngine;
+class QLabel;
+class QLineEdit;
+class QPushButton;
+
+/**
+ * @brief Asks for a name pattern and renames the given items through BatchRenameEngine.
+ *
+ * Replaces KIO::RenameFileDialog for renaming a selection: while the user
+ * types, the complete old to new mapping is recomputed and checked for
+ * conflicts, so impossible batches are rejected before a single rename runs
+ * instead of failing item by item. Accepting the dialog hides it and executes
+ * the renames concurrently; renamingFinished() is emitted once all of them
+ * completed.
+ */
+class DOLPHIN_EXPORT BatchRenameDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param items        the items to rename.
+     * @param occupiedUrls the URLs which exist next to @p items, used to
+     *                     detect renames onto existing files. Typically all
+     *                     URLs the view's model currently holds.
+     */
+    explicit BatchRenameDialog(const KFileItemList &items, const QSet<QUrl> &occupiedUrls, QWidget *parent = nullptr);
+
+    /** Starts the renames. The dialog deletes itself after renamingFinished() was emitted. */
+    void accept() override;
+
+Q_SIGNALS:
+    /**
+     * Is emitted once every rename completed. @p newUrls contains the URL of
+     * every item in the order they were passed to the constructor; items
+     * whose rename failed keep their old URL.
+     */
+    void renamingFinished(const QList<QUrl> &newUrls);
+
+    /** Is emitted before renamingFinished() when at least one rename failed. */
+    void errorOccurred(const QString &errorMessage);
+
+private Q_SLOTS:
+    /** Recomputes the mapping for @p pattern and updates the conflict display and the Ok button. */
+    void slotPatternChanged(const QString &pattern);
+
+private:
+    BatchRenameEngine *m_engine;
+    QSet<QUrl> m_occupiedUrls;
+    QLineEdit *m_patternEdit;
+    QLabel *m_conflictLabel;
+    QPushButton *m_okButton;
+};
+
+#endif // BATCHRENAMEDIALOG_H
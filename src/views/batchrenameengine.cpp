@@ -0,0 +1,212 @@
+/*
+    SPDX-FileCopyrightText: 2026 The Dolphin Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "batchrenameengine.h"
+
+#include <KIO/SimpleJob>
+#include <KLocalizedString>
+
+namespace
+{
+// Upper bound for the number of rename jobs in flight. Renames are cheap
+// metadata operations, so a handful in parallel already saturates the
+// round-trip latency to the KIO worker; more only grows the queue there.
+constexpr int MaxConcurrentRenameJobs = 16;
+}
+
+BatchRenameEngine::BatchRenameEngine(const KFileItemList &items, QObject *parent)
+    : QObject(parent)
+    , m_items(items)
+{
+    m_newUrls.reserve(items.count());
+    for (const KFileItem &item : items) {
+        m_newUrls.append(item.url());
+    }
+}
+
+void BatchRenameEngine::setNamePattern(const QString &pattern)
+{
+    Q_ASSERT_X(!m_started, "BatchRenameEngine::setNamePattern()", "The mapping may not change anymore once the renames are running.");
+
+    if (pattern.isEmpty()) {
+        // An empty pattern renames nothing instead of producing nameless files.
+        for (int i = 0; i < m_items.count(); ++i) {
+            m_newUrls[i] = m_items.at(i).url();
+        }
+        return;
+    }
+
+    const int placeholderStart = pattern.indexOf(QLatin1Char('#'));
+    int placeholderLength = 0;
+    while (placeholderStart >= 0 && placeholderStart + placeholderLength < pattern.length() && pattern.at(placeholderStart + placeholderLength) == QLatin1Char('#')) {
+        ++placeholderLength;
+    }
+    const bool patternHasExtension = pattern.contains(QLatin1Char('.'));
+
+    for (int i = 0; i < m_items.count(); ++i) {
+        const KFileItem &item = m_items.at(i);
+
+        QString newName = pattern;
+        if (placeholderLength > 0) {
+            newName.replace(placeholderStart, placeholderLength, QString::number(i + 1).rightJustified(placeholderLength, QLatin1Char('0')));
+        } else if (m_items.count() > 1) {
+            // Without a placeholder every item would get the same name, so
+            // the position is inserted to keep the names distinct.
+            const QString insertion = QStringLiteral(" (%1)").arg(i + 1);
+            const int patternExtensionIndex = newName.lastIndexOf(QLatin1Char('.'));
+            if (patternExtensionIndex > 0) {
+                newName.insert(patternExtensionIndex, insertion);
+            } else {
+                newName += insertion;
+            }
+        }
+
+        if (!patternHasExtension && !item.isDir()) {
+            const QString oldName = item.name();
+            const int extensionIndex = oldName.lastIndexOf(QLatin1Char('.'));
+            if (extensionIndex > 0) {
+                newName += oldName.mid(extensionIndex);
+            }
+        }
+
+        QUrl newUrl = item.url().adjusted(QUrl::RemoveFilename);
+        newUrl.setPath(newUrl.path() + newName);
+        m_newUrls[i] = newUrl;
+    }
+}
+
+QList<QUrl> BatchRenameEngine::newUrls() const
+{
+    return m_newUrls;
+}
+
+int BatchRenameEngine::renameCount() const
+{
+    int count = 0;
+    for (int i = 0; i < m_items.count(); ++i) {
+        if (m_newUrls.at(i) != m_items.at(i).url()) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+QStringList BatchRenameEngine::conflicts(const QSet<QUrl> &occupiedUrls) const
+{
+    // Old URLs which the batch renames away. A target equal to one of these
+    // is no conflict because the occupying item vacates its name.
+    QSet<QUrl> vacatedUrls;
+    for (int i = 0; i < m_items.count(); ++i) {
+        if (m_newUrls.at(i) != m_items.at(i).url()) {
+            vacatedUrls.insert(m_items.at(i).url());
+        }
+    }
+
+    QStringList conflictMessages;
+    QSet<QUrl> plannedTargets;
+    for (int i = 0; i < m_items.count(); ++i) {
+        const QUrl newUrl = m_newUrls.at(i);
+        if (newUrl == m_items.at(i).url()) {
+            continue;
+        }
+
+        if (plannedTargets.contains(newUrl)) {
+            conflictMessages.append(i18nc("@info:status %1 is a file name", "More than one item would be renamed to \"%1\".", newUrl.fileName()));
+            continue;
+        }
+        plannedTargets.insert(newUrl);
+
+        if (occupiedUrls.contains(newUrl) && !vacatedUrls.contains(newUrl)) {
+            conflictMessages.append(i18nc("@info:status %1 is a file name", "An item named \"%1\" already exists.", newUrl.fileName()));
+        }
+    }
+    return conflictMessages;
+}
+
+void BatchRenameEngine::start()
+{
+    Q_ASSERT_X(!m_started, "BatchRenameEngine::start()", "An engine instance may only be started once.");
+    m_started = true;
+
+    for (int i = 0; i < m_items.count(); ++i) {
+        if (m_newUrls.at(i) != m_items.at(i).url()) {
+            m_pendingRenames.append(i);
+            m_occupiedSources.insert(m_items.at(i).url());
+        }
+    }
+    m_totalRenames = m_pendingRenames.count();
+
+    if (m_totalRenames == 0) {
+        // Emitted through the event loop so the caller is connected by then,
+        // no matter whether it connects before or after start().
+        QMetaObject::invokeMethod(
+            this,
+            [this]() {
+                Q_EMIT finished(m_newUrls, m_errors);
+            },
+            Qt::QueuedConnection);
+        return;
+    }
+
+    startReadyJobs();
+}
+
+void BatchRenameEngine::startReadyJobs()
+{
+    bool startedJob = true;
+    while (startedJob && m_runningJobs < MaxConcurrentRenameJobs && !m_pendingRenames.isEmpty()) {
+        startedJob = false;
+        for (int pendingIndex = 0; pendingIndex < m_pendingRenames.count(); ++pendingIndex) {
+            const int i = m_pendingRenames.at(pendingIndex);
+            if (m_occupiedSources.contains(m_newUrls.at(i))) {
+                // The target name is still taken by an item of this batch
+                // which has not been renamed away yet.
+                continue;
+            }
+
+            m_pendingRenames.removeAt(pendingIndex);
+            ++m_runningJobs;
+
+            KIO::SimpleJob *job = KIO::rename(m_items.at(i).url(), m_newUrls.at(i), KIO::HideProgressInfo);
+            connect(job, &KJob::result, this, [this, i](KJob *job) {
+                --m_runningJobs;
+                ++m_finishedCount;
+                if (job->error()) {
+                    m_errors.append(job->errorString());
+                    // The old URL stays occupied and is reported back, so
+                    // renames onto it fail below instead of overwriting.
+                    m_newUrls[i] = m_items.at(i).url();
+                } else {
+                    m_occupiedSources.remove(m_items.at(i).url());
+                }
+                Q_EMIT progressChanged(m_finishedCount, m_totalRenames);
+                startReadyJobs();
+            });
+
+            startedJob = true;
+            break;
+        }
+    }
+
+    if (m_runningJobs == 0 && !m_pendingRenames.isEmpty()) {
+        // None of the remaining renames can ever start: their targets stay
+        // occupied because items would swap names directly or the rename
+        // they depend on has failed.
+        for (const int i : std::as_const(m_pendingRenames)) {
+            m_errors.append(
+                i18nc("@info:status %1 is a file name", "\"%1\" could not be renamed because its new name belongs to an item which kept it.", m_items.at(i).name()));
+            m_newUrls[i] = m_items.at(i).url();
+            ++m_finishedCount;
+        }
+        m_pendingRenames.clear();
+    }
+
+    if (m_runningJobs == 0 && m_pendingRenames.isEmpty()) {
+        Q_EMIT finished(m_newUrls, m_errors);
+    }
+}
+
+#include "moc_batchrenameengine.cpp"
@@ -0,0 +1,120 @@
+/*
+    SPDX-FileCopyrightText: 2026 The Dolphin Developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef BATCHRENAMEENGINE_H
+#define BATCHRENAMEENGINE_H
+
+#include "dolphin_export.h"
+
+#include <KFileItem>
+
+#include <QObject>
+#include <QSet>
+#include <QUrl>
+
+/**
+ * @brief Renames many files at once with precomputed targets and bounded concurrency.
+ *
+ * KIO::BatchRenameJob runs one rename after the other, which makes sessions
+ * with tens of thousands of files take minutes even though each rename is a
+ * cheap metadata operation. This engine first computes the complete old to
+ * new mapping from a name pattern, detects every conflict in a single hash
+ * pass over that mapping, and then executes the renames as concurrent
+ * KIO::rename() jobs with a bounded number in flight.
+ *
+ * A rename whose target is still occupied by another item of the batch (e.g.
+ * "file1" to "file2" while "file2" becomes "file3") is deferred until the
+ * occupying item has been renamed away, so chains resolve in the right order
+ * without any serialization of the independent renames.
+ */
+class DOLPHIN_EXPORT BatchRenameEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    /** @param items the items to rename, in the order the new names are numbered in. */
+    explicit BatchRenameEngine(const KFileItemList &items, QObject *parent = nullptr);
+
+    /**
+     * Computes the new name of every item from @p pattern:
+     * - The first run of "#" characters is replaced by the position of the
+     *   item in the batch, padded with zeros to the length of the run.
+     * - If @p pattern contains no "#" and more than one item is renamed, the
+     *   position is appended in parentheses so the names stay distinct.
+     * - If @p pattern contains no ".", the original extension of each file is
+     *   kept. Directories never have an extension appended.
+     *
+     * May be called repeatedly, e.g. while the user is still typing the
+     * pattern, but not after start().
+     */
+    void setNamePattern(const QString &pattern);
+
+    /**
+     * @returns the planned URL of every item in the order of the constructor
+     *          argument. Items whose name does not change keep their URL.
+     *          After finished() was emitted, items whose rename failed report
+     *          their old URL again.
+     */
+    QList<QUrl> newUrls() const;
+
+    /** @returns the number of items whose name actually changes. */
+    int renameCount() const;
+
+    /**
+     * Checks the complete mapping for conflicts in one pass.
+     *
+     * @param occupiedUrls the URLs which exist next to the renamed items,
+     *                     typically all URLs the model currently holds.
+     * @returns a human-readable message per conflict: two items of the batch
+     *          ending up with the same name, or a target which an item
+     *          outside the batch already occupies. Empty when the batch can
+     *          be executed completely.
+     */
+    QStringList conflicts(const QSet<QUrl> &occupiedUrls) const;
+
+    /**
+     * Executes the planned renames. May only be called once. finished() is
+     * emitted even when the batch is empty.
+     */
+    void start();
+
+Q_SIGNALS:
+    /** Is emitted whenever a rename job completed, successfully or not. */
+    void progressChanged(int finishedCount, int totalCount);
+
+    /**
+     * Is emitted once all rename jobs have completed.
+     * @param newUrls       the URL of every item in constructor order. Items
+     *                      whose rename failed keep their old URL.
+     * @param errorMessages one message per failed rename.
+     */
+    void finished(const QList<QUrl> &newUrls, const QStringList &errorMessages);
+
+private:
+    /**
+     * Starts pending renames whose target is not occupied by a not yet
+     * renamed item of the batch, until the concurrency bound is reached.
+     * Fails the remaining renames when none of them can ever start, which
+     * only happens when items would directly swap names or a rename they
+     * depend on has failed.
+     */
+    void startReadyJobs();
+
+private:
+    KFileItemList m_items;
+    QList<QUrl> m_newUrls;
+    /** Indexes into m_items whose rename has not been started yet. */
+    QList<int> m_pendingRenames;
+    /** Old URLs of batch items which have not been renamed away yet. Targets equal to one of these are deferred. @see startReadyJobs(). */
+    QSet<QUrl> m_occupiedSources;
+    QStringList m_errors;
+    int m_runningJobs = 0;
+    int m_finishedCount = 0;
+    int m_totalRenames = 0;
+    bool m_started = false;
+};
+
+#endif // BATCHRENAMEENGINE_H
@@ -0,0 +1,105 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "dolphindirectoryprefetcher.h"
+
+#include "dolphin_generalsettings.h"
+
+#include <KDirLister>
+#include <KMountPoint>
+#include <KProtocolInfo>
+
+#include <QTimer>
+
+namespace
+{
+// The pause after the last reported candidate before the speculative listing
+// starts. Long enough that arrow-key travel through a directory does not
+// trigger listings for every directory the selection passes over.
+constexpr int PrefetchIdleDelay = 500;
+
+// How many prefetched directories stay attached to the background dir lister.
+// While attached their listings remain in the lister cache and are kept up to
+// date by the directory watcher.
+constexpr int MaxPrefetchedDirs = 8;
+
+// Minimum pause between speculative listings of remote directories. This is
+// the bandwidth budget: at most one speculative remote listing per interval,
+// so speculation never competes with real transfers for long.
+constexpr qint64 RemotePrefetchInterval = 30000;
+}
+
+DolphinDirectoryPrefetcher::DolphinDirectoryPrefetcher(QObject *parent)
+    : QObject{parent}
+    , m_dirLister{new KDirLister{this}}
+    , m_idleTimer{new QTimer{this}}
+{
+    m_dirLister->setAutoErrorHandlingEnabled(false);
+
+    m_idleTimer->setSingleShot(true);
+    m_idleTimer->setInterval(PrefetchIdleDelay);
+    connect(m_idleTimer, &QTimer::timeout, this, &DolphinDirectoryPrefetcher::prefetchPendingUrl);
+}
+
+DolphinDirectoryPrefetcher::~DolphinDirectoryPrefetcher() = default;
+
+void DolphinDirectoryPrefetcher::schedulePrefetch(const QUrl &url)
+{
+    if (!GeneralSettings::speculativePrefetching() || !url.isValid()) {
+        return;
+    }
+    if (url.scheme() == QStringLiteral("admin")) {
+        // Never speculate with elevated privileges: a listing through the
+        // admin worker could trigger an authentication dialog.
+        return;
+    }
+    m_pendingUrl = url;
+    m_idleTimer->start();
+}
+
+void DolphinDirectoryPrefetcher::cancelPendingPrefetch()
+{
+    m_idleTimer->stop();
+    m_pendingUrl.clear();
+}
+
+void DolphinDirectoryPrefetcher::prefetchPendingUrl()
+{
+    const QUrl url = m_pendingUrl;
+    m_pendingUrl.clear();
+    if (!url.isValid() || m_prefetchedUrls.contains(url)) {
+        return;
+    }
+
+    if (isRemote(url)) {
+        if (m_sinceLastRemotePrefetch.isValid() && m_sinceLastRemotePrefetch.elapsed() < RemotePrefetchInterval) {
+            return; // The remote bandwidth budget is used up for now.
+        }
+        m_sinceLastRemotePrefetch.start();
+    }
+
+    if (!m_dirLister->openUrl(url, KDirLister::Keep)) {
+        return;
+    }
+
+    // Keep the directory attached so its cache entry stays alive and watched.
+    // @see KFileItemModel::retireExpandedDir() for the same technique.
+    m_prefetchedUrls.append(url);
+    while (m_prefetchedUrls.count() > MaxPrefetchedDirs) {
+        m_dirLister->forgetDirs(m_prefetchedUrls.takeFirst());
+    }
+}
+
+bool DolphinDirectoryPrefetcher::isRemote(const QUrl &url)
+{
+    if (url.isLocalFile()) {
+        const KMountPoint::Ptr mountPoint = KMountPoint::currentMountPoints().findByPath(url.toLocalFile());
+        return mountPoint && mountPoint->probablySlow();
+    }
+    return KProtocolInfo::protocolClass(url.scheme()) != QStringLiteral(":local");
+}
+
+#include "moc_dolphindirectoryprefetcher.cpp"
@@ -0,0 +1,78 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef DOLPHINDIRECTORYPREFETCHER_H
+#define DOLPHINDIRECTORYPREFETCHER_H
+
+#include "dolphin_export.h"
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QUrl>
+
+class KDirLister;
+class QTimer;
+
+/**
+ * @brief Speculatively lists directories the user is likely to enter next.
+ *
+ * Navigation is highly predictable: users either enter the directory they just
+ * selected or go back up to the parent. DolphinView reports both candidates
+ * here, and after a short idle delay they are listed with a dedicated
+ * background KDirLister. The listing lands in the process-wide dir lister
+ * cache, so when the navigation actually happens KFileItemModel is served from
+ * the cache instead of waiting for KIO. Prefetched directories stay attached
+ * to the background lister for a while, which keeps their cache entries alive
+ * and watched for changes; only the oldest ones are forgotten.
+ *
+ * Prefetching never touches the view's own lister and is dropped entirely
+ * while one of its candidates is already being listed in the foreground.
+ * The GeneralSettings::speculativePrefetching() setting turns it off, and
+ * directories on network mounts or remote protocols are rate-limited so that
+ * speculation does not compete with real traffic for bandwidth.
+ */
+class DOLPHIN_EXPORT DolphinDirectoryPrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DolphinDirectoryPrefetcher(QObject *parent = nullptr);
+    ~DolphinDirectoryPrefetcher() override;
+
+    /**
+     * Schedules \a url to be listed in the background once the user has been
+     * idle for a moment. Calling this again before the idle delay elapsed
+     * replaces the previous candidate, so quickly moving the selection
+     * through a directory does not queue up speculative work.
+     */
+    void schedulePrefetch(const QUrl &url);
+
+    /**
+     * Cancels a pending prefetch, e.g. because the user navigated and the
+     * candidate is being listed in the foreground anyway.
+     */
+    void cancelPendingPrefetch();
+
+private Q_SLOTS:
+    void prefetchPendingUrl();
+
+private:
+    /** @return Whether \a url points to a network mount or a remote protocol. */
+    static bool isRemote(const QUrl &url);
+
+    KDirLister *m_dirLister;
+    QTimer *m_idleTimer;
+    QUrl m_pendingUrl;
+
+    /** The prefetched directories still attached to m_dirLister, oldest first. */
+    QList<QUrl> m_prefetchedUrls;
+
+    /** Measures the pause between remote prefetches, see RemotePrefetchInterval. */
+    QElapsedTimer m_sinceLastRemotePrefetch;
+};
+
+#endif
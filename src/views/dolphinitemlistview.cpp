@@ -16,12 +16,27 @@
 #include "zoomlevelinfo.h"
 
 #include <KIO/PreviewJob>
+#include <QTimer>
 #include <QtMath>
 
+namespace
+{
+// Minimum time in ms between two relayouts which are driven by zoom level
+// changes. Holding Ctrl and spinning the mouse wheel delivers a zoom step per
+// wheel tick, which can be faster than frames are drawn; relayouting for every
+// intermediate level only burns time on grid sizes nobody ever sees. See
+// DolphinItemListView::setZoomLevel().
+const int ZoomRelayoutInterval = 1000 / 60;
+}
+
 DolphinItemListView::DolphinItemListView(QGraphicsWidget *parent)
     : KFileItemListView(parent)
     , m_zoomLevel(0)
 {
+    m_zoomThrottleTimer = new QTimer(this);
+    m_zoomThrottleTimer->setSingleShot(true);
+    connect(m_zoomThrottleTimer, &QTimer::timeout, this, &DolphinItemListView::updateGridSize);
+
     DolphinItemListView::updateFont();
     updateGridSize();
 }
@@ -54,6 +69,20 @@ void DolphinItemListView::setZoomLevel(int level)
         settings.setIconSize(iconSize);
     }
 
+    if (m_zoomThrottleTimer->isActive()) {
+        // A relayout is already scheduled and will use the newest zoom level once it fires.
+        return;
+    }
+
+    const qint64 timeSinceLastRelayout = m_timeSinceZoomRelayout.isValid() ? m_timeSinceZoomRelayout.elapsed() : ZoomRelayoutInterval;
+    if (timeSinceLastRelayout < ZoomRelayoutInterval) {
+        // The zoom level changes faster than frames are drawn, which happens while the user holds Ctrl and spins the mouse wheel. The relayout for the
+        // intermediate levels is skipped; the one at the end of the frame interval picks up whatever level is newest then, including the final one when
+        // the wheel stops.
+        m_zoomThrottleTimer->start(ZoomRelayoutInterval - timeSinceLastRelayout);
+        return;
+    }
+
     updateGridSize();
 }
 
@@ -140,6 +169,7 @@ void DolphinItemListView::onPreviewsShownChanged(bool shown)
 void DolphinItemListView::onVisibleRolesChanged(const QList<QByteArray> &current, const QList<QByteArray> &previous)
 {
     KFileItemListView::onVisibleRolesChanged(current, previous);
+    m_gridParametersCache.clear(); // The number of visible roles affects the item height in the compact layout.
     updateGridSize();
 }
 
@@ -157,16 +187,43 @@ void DolphinItemListView::updateFont()
 
     option.fontMetrics = QFontMetrics(option.font);
     setStyleOption(option);
+    m_gridParametersCache.clear(); // The cached parameters contain font-derived item sizes.
 }
 
 void DolphinItemListView::updateGridSize()
 {
+    m_timeSinceZoomRelayout.start();
+
     const ViewModeSettings settings(itemLayout());
 
     // Calculate the size of the icon
     const int iconSize = previewsShown() ? settings.previewSize() : settings.iconSize();
     m_zoomLevel = ZoomLevelInfo::zoomLevelForIconSize(QSize(iconSize, iconSize));
+
+    const GridParameters parameters = gridParametersForIconSize(iconSize);
+
+    // Apply the calculated values
     KItemListStyleOption option = styleOption();
+    option.padding = parameters.padding;
+    option.horizontalMargin = parameters.horizontalMargin;
+    option.verticalMargin = parameters.verticalMargin;
+    option.iconSize = parameters.iconSize;
+    option.maxTextLines = parameters.maxTextLines;
+    option.maxTextWidth = parameters.maxTextWidth;
+    beginTransaction();
+    setStyleOption(option);
+    setItemSize(parameters.itemSize);
+    endTransaction();
+}
+
+DolphinItemListView::GridParameters DolphinItemListView::gridParametersForIconSize(int iconSize) const
+{
+    const auto cachedParameters = m_gridParametersCache.constFind(iconSize);
+    if (cachedParameters != m_gridParametersCache.constEnd()) {
+        return cachedParameters.value();
+    }
+
+    const KItemListStyleOption &option = styleOption();
 
     const int padding = 2;
     int horizontalMargin = 0;
@@ -180,8 +237,9 @@ void DolphinItemListView::updateGridSize()
 
     switch (itemLayout()) {
     case KFileItemListView::IconsLayout: {
+        const int zoomLevel = ZoomLevelInfo::zoomLevelForIconSize(QSize(iconSize, iconSize));
         // an exponential factor based on zoom, 0 -> 1, 4 -> 1.36 8 -> ~1.85, 16 -> 3.4
-        auto zoomFactor = qExp(m_zoomLevel / 13.0);
+        auto zoomFactor = qExp(zoomLevel / 13.0);
         // 9 is the average char width for 10pt Noto Sans, making fontFactor =1
         // by each pixel the font gets larger the factor increases by 1/9
         auto fontFactor = option.fontMetrics.averageCharWidth() / 9.0;
@@ -225,17 +283,16 @@ void DolphinItemListView::updateGridSize()
         break;
     }
 
-    // Apply the calculated values
-    option.padding = padding;
-    option.horizontalMargin = horizontalMargin;
-    option.verticalMargin = verticalMargin;
-    option.iconSize = iconSize;
-    option.maxTextLines = maxTextLines;
-    option.maxTextWidth = maxTextWidth;
-    beginTransaction();
-    setStyleOption(option);
-    setItemSize(QSizeF(itemWidth, itemHeight));
-    endTransaction();
+    GridParameters parameters;
+    parameters.iconSize = iconSize;
+    parameters.padding = padding;
+    parameters.horizontalMargin = horizontalMargin;
+    parameters.verticalMargin = verticalMargin;
+    parameters.maxTextLines = maxTextLines;
+    parameters.maxTextWidth = maxTextWidth;
+    parameters.itemSize = QSizeF(itemWidth, itemHeight);
+    m_gridParametersCache.insert(iconSize, parameters);
+    return parameters;
 }
 
 #include "moc_dolphinitemlistview.cpp"
@@ -10,7 +10,11 @@
 #include "dolphin_export.h"
 #include "kitemviews/kfileitemlistview.h"
 
+#include <QElapsedTimer>
+#include <QHash>
+
 class KFileItemListView;
+class QTimer;
 
 /**
  * @brief Dolphin specific view-implementation.
@@ -54,14 +58,47 @@ protected:
     void updateFont() override;
 
 private:
+    /**
+     * Applies the layout parameters (icon size, paddings, margins and the
+     * font-derived item size) for the current zoom level and relayouts the
+     * view. Called either directly or - while the zoom level changes rapidly,
+     * e.g. because the user holds Ctrl and spins the mouse wheel - deferred
+     * through m_zoomThrottleTimer so that only the final level of a burst of
+     * zoom steps triggers a full relayout. @see setZoomLevel().
+     */
     void updateGridSize();
 
+    /**
+     * The layout parameters which updateGridSize() derives for one icon size.
+     * They only depend on the icon size, the item layout, the view font and
+     * the view mode settings, so they are computed once per icon size and then
+     * looked up in m_gridParametersCache until one of the other inputs
+     * changes.
+     */
+    struct GridParameters {
+        int iconSize = -1;
+        int padding = 0;
+        int horizontalMargin = 0;
+        int verticalMargin = 0;
+        int maxTextLines = 0;
+        int maxTextWidth = 0;
+        QSizeF itemSize;
+    };
+    GridParameters gridParametersForIconSize(int iconSize) const;
+
     using KItemListView::setEnabledSelectionToggles; // Makes sure that the setEnabledSelectionToggles() declaration above doesn't hide
                                                      // the one from the base class so we can still use it privately.
     SelectionTogglesEnabled m_selectionTogglesEnabled = FollowSetting;
 
 private:
     int m_zoomLevel;
+
+    /** Caches the computed layout parameters per icon size, see gridParametersForIconSize(). */
+    mutable QHash<int, GridParameters> m_gridParametersCache;
+
+    // Coalesce relayouts while the zoom level changes rapidly, see setZoomLevel().
+    QTimer *m_zoomThrottleTimer;
+    QElapsedTimer m_timeSinceZoomRelayout;
 };
 
 #endif
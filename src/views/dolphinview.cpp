@@ -7,8 +7,10 @@
 
 #include "dolphinview.h"
 
+#include "batchrenamedialog.h"
 #include "dolphin_detailsmodesettings.h"
 #include "dolphin_generalsettings.h"
+#include "dolphindirectoryprefetcher.h"
 #include "dolphinitemlistview.h"
 #include "dolphinnewfilemenuobserver.h"
 #include "draganddrophelper.h"
@@ -22,6 +24,7 @@
 #include "kitemviews/kitemlistheader.h"
 #include "kitemviews/kitemlistselectionmanager.h"
 #include "kitemviews/private/kitemlistroleeditor.h"
+#include "search/facetaggregator.h"
 #include "selectionmode/singleclickselectionproxystyle.h"
 #include "settings/viewmodes/viewmodesettings.h"
 #include "versioncontrol/versioncontrolobserver.h"
@@ -40,10 +43,10 @@
 #include <KIO/CopyJob>
 #include <KIO/DeleteOrTrashJob>
 #include <KIO/DropJob>
+#include <KIO/Global>
 #include <KIO/JobUiDelegate>
 #include <KIO/Paste>
 #include <KIO/PasteJob>
-#include <KIO/RenameFileDialog>
 #include <KIconUtils>
 #include <KJob>
 #include <KJobWidgets>
@@ -74,6 +77,7 @@
 #include <QTimer>
 #include <QToolTip>
 #include <QVBoxLayout>
+#include <QWindow>
 
 DolphinView::DolphinView(const QUrl &url, QWidget *parent)
     : QWidget(parent)
@@ -87,12 +91,14 @@ DolphinView::DolphinView(const QUrl &url, QWidget *parent)
     , m_viewPropertiesContext()
     , m_mode(DolphinView::IconsView)
     , m_visibleRoles()
+    , m_selectionStatisticsStale(true)
     , m_topLayout(nullptr)
     , m_model(nullptr)
     , m_view(nullptr)
     , m_container(nullptr)
     , m_toolTipManager(nullptr)
     , m_selectionChangedTimer(nullptr)
+    , m_directoryPrefetcher(nullptr)
     , m_currentItemUrl()
     , m_scrollToCurrentItem(false)
     , m_restoredContentsPosition()
@@ -120,6 +126,8 @@ DolphinView::DolphinView(const QUrl &url, QWidget *parent)
     m_selectionChangedTimer->setInterval(300);
     connect(m_selectionChangedTimer, &QTimer::timeout, this, &DolphinView::emitSelectionChangedSignal);
 
+    m_directoryPrefetcher = new DolphinDirectoryPrefetcher(this);
+
     m_model = new KFileItemModel(this);
     m_view = new DolphinItemListView();
     m_view->setEnabledSelectionToggles(DolphinItemListView::SelectionTogglesEnabled::FollowSetting);
@@ -203,6 +211,17 @@ DolphinView::DolphinView(const QUrl &url, QWidget *parent)
     connect(m_model, &KFileItemModel::itemsChanged, this, &DolphinView::slotItemsChanged);
     connect(m_model, &KFileItemModel::itemsRemoved, this, &DolphinView::itemCountChanged);
     connect(m_model, &KFileItemModel::itemsInserted, this, &DolphinView::itemCountChanged);
+    // The selection statistics refer to items by their model index, so they
+    // cannot survive any change that shifts indexes or alters sizes.
+    connect(m_model, &KFileItemModel::itemsRemoved, this, &DolphinView::invalidateSelectionStatistics);
+    connect(m_model, &KFileItemModel::itemsInserted, this, &DolphinView::invalidateSelectionStatistics);
+    connect(m_model, &KFileItemModel::itemsMoved, this, &DolphinView::invalidateSelectionStatistics);
+    connect(m_model, &KFileItemModel::itemsChanged, this, [this](const KItemRangeList &itemRanges, const QSet<QByteArray> &roles) {
+        Q_UNUSED(itemRanges)
+        if (roles.contains("size")) {
+            invalidateSelectionStatistics();
+        }
+    });
     connect(m_model, &KFileItemModel::infoMessage, this, &DolphinView::infoMessage);
     connect(m_model, &KFileItemModel::errorMessage, this, &DolphinView::errorMessage);
     connect(m_model, &KFileItemModel::directoryRedirection, this, &DolphinView::slotDirectoryRedirection);
@@ -638,28 +657,20 @@ void DolphinView::requestStatusBarText()
         m_statJobForStatusBarText->kill();
     }
 
-    if (m_container->controller()->selectionManager()->hasSelection()) {
-        int folderCount = 0;
-        int fileCount = 0;
-        KIO::filesize_t totalFileSize = 0;
-
+    const KItemListSelectionManager *selectionManager = m_container->controller()->selectionManager();
+    if (selectionManager->hasSelection()) {
         // Give a summary of the status of the selected files
-        const KFileItemList list = selectedItems();
-        for (const KFileItem &item : list) {
-            if (item.isDir()) {
-                ++folderCount;
-            } else {
-                ++fileCount;
-                totalFileSize += item.size();
-            }
-        }
+        updateSelectionStatistics();
+        const int folderCount = m_selectionStatistics.folderCount;
+        const int fileCount = m_selectionStatistics.fileCount;
 
         if (folderCount + fileCount == 1) {
             // If only one item is selected, show info about it
-            Q_EMIT statusBarTextChanged(list.first().getStatusBarInfo());
+            const KFileItem item = m_model->fileItem(selectionManager->selectedItems().first());
+            Q_EMIT statusBarTextChanged(item.getStatusBarInfo());
         } else {
             // At least 2 items are selected
-            emitStatusBarText(folderCount, fileCount, totalFileSize, HasSelection);
+            emitStatusBarText(folderCount, fileCount, m_selectionStatistics.totalFileSize, HasSelection);
         }
     } else { // has no selection
         if (!m_model->rootItem().url().isValid()) {
@@ -700,6 +711,53 @@ void DolphinView::emitStatusBarText(const int folderCount, const int fileCount,
     Q_EMIT statusBarTextChanged(summary);
 }
 
+void DolphinView::updateSelectionStatistics()
+{
+    const KItemSet selection = m_container->controller()->selectionManager()->selectedItems();
+
+    if (m_selectionStatisticsStale) {
+        m_selectionStatistics = SelectionStatistics();
+        m_selectionStatisticsIndexes = KItemSet();
+    }
+
+    // Only the items that entered or left the selection since the last update
+    // have to be looked at. For a huge selection that is extended or reduced
+    // by a few items this is far cheaper than iterating all selected items.
+    const KItemSet changedIndexes = selection ^ m_selectionStatisticsIndexes;
+    for (int index : changedIndexes) {
+        const KFileItem item = m_model->fileItem(index);
+        if (item.isNull()) {
+            continue;
+        }
+
+        if (selection.contains(index)) {
+            // The item entered the selection.
+            if (item.isDir()) {
+                ++m_selectionStatistics.folderCount;
+            } else {
+                ++m_selectionStatistics.fileCount;
+                m_selectionStatistics.totalFileSize += item.size();
+            }
+        } else {
+            // The item left the selection.
+            if (item.isDir()) {
+                --m_selectionStatistics.folderCount;
+            } else {
+                --m_selectionStatistics.fileCount;
+                m_selectionStatistics.totalFileSize -= item.size();
+            }
+        }
+    }
+
+    m_selectionStatisticsIndexes = selection;
+    m_selectionStatisticsStale = false;
+}
+
+void DolphinView::invalidateSelectionStatistics()
+{
+    m_selectionStatisticsStale = true;
+}
+
 QList<QAction *> DolphinView::versionControlActions(const KFileItemList &items) const
 {
     QList<QAction *> actions;
@@ -785,8 +843,17 @@ void DolphinView::renameSelectedItems()
         m_view->scrollToItem(index);
 
     } else {
-        KIO::RenameFileDialog *dialog = new KIO::RenameFileDialog(items, this);
-        connect(dialog, &KIO::RenameFileDialog::renamingFinished, this, [this, items](const QList<QUrl> &urls) {
+        // All URLs the model holds, so the dialog can detect renames onto existing items before a single rename job runs.
+        QSet<QUrl> occupiedUrls;
+        occupiedUrls.reserve(m_model->count());
+        for (int i = 0; i < m_model->count(); ++i) {
+            occupiedUrls.insert(m_model->fileItem(i).url());
+        }
+
+        BatchRenameDialog *dialog = new BatchRenameDialog(items, occupiedUrls, this);
+        connect(dialog, &BatchRenameDialog::renamingFinished, this, [this, items](const QList<QUrl> &urls) {
+            // All changes are applied as one batch so the view receives merged ranges and a single resort instead of one of each per item.
+            m_model->beginItemsChangedBatch();
             // The model may have already been updated, so it's possible that we don't find the old items.
             for (int i = 0; i < items.count(); ++i) {
                 const int index = m_model->index(items[i]);
@@ -796,12 +863,13 @@ void DolphinView::renameSelectedItems()
                     m_model->setData(index, data);
                 }
             }
+            m_model->endItemsChangedBatch();
 
             forceUrlsSelection(urls.first(), urls);
             updateSelectionState();
         });
-        connect(dialog, &KIO::RenameFileDialog::error, this, [this](KJob *job) {
-            KMessageBox::error(this, job->errorString());
+        connect(dialog, &BatchRenameDialog::errorOccurred, this, [this](const QString &errorMessage) {
+            KMessageBox::error(this, errorMessage);
         });
 
         dialog->open();
@@ -964,6 +1032,18 @@ void DolphinView::stopLoading()
     m_model->cancelDirectoryLoading();
 }
 
+void DolphinView::trimCachedPreviews()
+{
+    m_view->trimPreviews();
+}
+
+void DolphinView::trimCachedRoleValues()
+{
+    // The eviction keeps a small margin at the top of the directory and is
+    // skipped internally while the sort role depends on the stored values.
+    m_model->evictRoleValues(0, 0, 0);
+}
+
 void DolphinView::updatePalette()
 {
     QColor color = KColorScheme(isActiveWindow() ? QPalette::Active : QPalette::Inactive, KColorScheme::View).background().color();
@@ -1084,12 +1164,36 @@ void DolphinView::wheelEvent(QWheelEvent *event)
     }
 }
 
+void DolphinView::showEvent(QShowEvent *event)
+{
+    // Minimizing or restoring the window does not propagate as hide and show
+    // events to child widgets, so the visibility of the window itself must be
+    // watched as well.
+    if (QWindow *nativeWindow = window()->windowHandle()) {
+        connect(nativeWindow, &QWindow::visibilityChanged, this, &DolphinView::updateBackgroundWorkSuspension, Qt::UniqueConnection);
+    }
+    updateBackgroundWorkSuspension();
+    QWidget::showEvent(event);
+}
+
 void DolphinView::hideEvent(QHideEvent *event)
 {
     hideToolTip();
+    updateBackgroundWorkSuspension();
     QWidget::hideEvent(event);
 }
 
+void DolphinView::updateBackgroundWorkSuspension()
+{
+    // There is no point in generating previews, sniffing mime types or
+    // counting directory sizes for a view nobody can see. The roles updater
+    // coalesces everything that is missed and catches up once the view is
+    // visible again.
+    const QWidget *topLevel = window();
+    const bool windowShown = topLevel && topLevel->isVisible() && !topLevel->isMinimized();
+    m_view->setRolesUpdaterSuspended(!windowShown || !isVisible());
+}
+
 bool DolphinView::event(QEvent *event)
 {
     if (event->type() == QEvent::WindowDeactivate) {
@@ -1562,7 +1666,17 @@ void DolphinView::slotSelectionChanged(const KItemSet &current, const KItemSet &
 void DolphinView::emitSelectionChangedSignal()
 {
     m_selectionChangedTimer->stop();
-    Q_EMIT selectionChanged(selectedItems());
+    const KFileItemList selection = selectedItems();
+
+    // A single selected directory is the most likely navigation target, so
+    // warm the dir lister cache for it while the user decides.
+    if (selection.count() == 1 && selection.first().isDir()) {
+        m_directoryPrefetcher->schedulePrefetch(selection.first().targetUrl());
+    } else {
+        m_directoryPrefetcher->cancelPendingPrefetch();
+    }
+
+    Q_EMIT selectionChanged(selection);
 }
 
 void DolphinView::slotStatJobResult(KJob *job)
@@ -1704,6 +1818,14 @@ KFileItem DolphinView::rootItem() const
     return m_model->rootItem();
 }
 
+Search::FacetAggregator *DolphinView::searchFacetAggregator()
+{
+    if (!m_searchFacetAggregator) {
+        m_searchFacetAggregator = new Search::FacetAggregator{m_model, this};
+    }
+    return m_searchFacetAggregator;
+}
+
 void DolphinView::setViewPropertiesContext(const QString &context)
 {
     m_viewPropertiesContext = context;
@@ -2083,6 +2205,13 @@ void DolphinView::slotDirectoryLoadingCompleted()
     updatePlaceholderLabel();
     updateWritableState();
 
+    // Going back up is the other common navigation, so keep the parent listing
+    // warm now that the foreground work is done.
+    const QUrl parentUrl = KIO::upUrl(url());
+    if (parentUrl != url()) {
+        m_directoryPrefetcher->schedulePrefetch(parentUrl);
+    }
+
     Q_EMIT directoryLoadingCompleted();
 }
 
@@ -2274,6 +2403,9 @@ void DolphinView::loadDirectory(const QUrl &url, bool reload)
         return;
     }
 
+    // The foreground listing takes precedence over any speculation.
+    m_directoryPrefetcher->cancelPendingPrefetch();
+
     if (reload) {
         m_model->refreshDirectory(url);
     } else {
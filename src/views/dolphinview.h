@@ -10,6 +10,7 @@
 
 #include "dolphin_export.h"
 #include "dolphintabwidget.h"
+#include "kitemviews/kitemset.h"
 #include "tooltips/tooltipmanager.h"
 
 #include "config-dolphin.h"
@@ -27,11 +28,11 @@
 
 typedef KIO::FileUndoManager::CommandType CommandType;
 class QVBoxLayout;
+class DolphinDirectoryPrefetcher;
 class DolphinItemListView;
 class KFileItemModel;
 class KItemListContainer;
 class KItemModelBase;
-class KItemSet;
 class ToolTipManager;
 class VersionControlObserver;
 class ViewProperties;
@@ -41,6 +42,11 @@ class QHelpEvent;
 class QProxyStyle;
 class QRegularExpression;
 
+namespace Search
+{
+class FacetAggregator;
+}
+
 /**
  * @short Represents a view for the directory content.
  *
@@ -335,6 +341,12 @@ public:
      */
     KFileItem rootItem() const;
 
+    /**
+     * @returns the aggregator which counts the facets of the search results shown in this view, e.g. so the search user interface can hint how many results
+     *          each file type would keep. The aggregator is created on the first call and only collects data while this view shows search results.
+     */
+    Search::FacetAggregator *searchFacetAggregator();
+
     /**
      * Sets a context that is used for remembering the view-properties.
      * Per default the context is empty and the path of the currently set URL
@@ -481,6 +493,22 @@ public Q_SLOTS:
 
     void stopLoading();
 
+    /**
+     * Drops the cached preview pixmaps of all items except a screenful
+     * around the visible range. Called for views in background tabs when the
+     * session is under memory pressure, @see DolphinCacheGovernor.
+     */
+    void trimCachedPreviews();
+
+    /**
+     * Releases the cached role values of all items except the visible
+     * screenful. The values are retrieved again on demand when the view
+     * becomes visible, @see KFileItemModel::evictRoleValues(). Called after
+     * trimCachedPreviews() when dropping the previews alone did not get the
+     * session back under its memory budget.
+     */
+    void trimCachedRoleValues();
+
     /**
      * Applies the state that has been restored by restoreViewState()
      * to the view.
@@ -716,10 +744,19 @@ protected:
     /** Changes the zoom level if Control is pressed during a wheel event. */
     void wheelEvent(QWheelEvent *event) override;
 
+    void showEvent(QShowEvent *event) override;
     void hideEvent(QHideEvent *event) override;
     bool event(QEvent *event) override;
 
 private Q_SLOTS:
+    /**
+     * Suspends the background work of the view (preview generation, mime type
+     * sniffing, directory size counting) while nobody can see it, and resumes
+     * it otherwise. Is called when the visibility of this widget changes
+     * (e.g. because its tab was activated or put into the background) and
+     * when the visibility of the window changes (e.g. it was minimized).
+     */
+    void updateBackgroundWorkSuspension();
     /**
      * Marks the view as active (DolphinView:isActive() will return true)
      * and emits the 'activated' signal if it is not already active.
@@ -914,6 +951,23 @@ private:
      */
     void emitStatusBarText(const int folderCount, const int fileCount, KIO::filesize_t totalFileSize, const Selection selection);
 
+    /**
+     * Brings m_selectionStatistics up to date with the current selection.
+     * Only the items that entered or left the selection since the last update
+     * are looked at, so updating is independent of the total selection size
+     * unless the statistics have been invalidated.
+     * @see invalidateSelectionStatistics()
+     */
+    void updateSelectionStatistics();
+
+    /**
+     * Discards m_selectionStatistics. Must be called whenever the model
+     * indexes shift (items inserted, removed or moved) because the remembered
+     * selection indexes do not refer to the same items anymore, and when the
+     * size of items might have changed.
+     */
+    void invalidateSelectionStatistics();
+
     /**
      * Helper method for DolphinView::paste() and DolphinView::pasteIntoFolder().
      * Pastes the clipboard data into the URL \a url.
@@ -984,16 +1038,35 @@ private:
 
     QPointer<KIO::StatJob> m_statJobForStatusBarText;
 
+    /// Aggregates about the selection for the status bar text. Maintained
+    /// incrementally so that e.g. extending a huge selection does not require
+    /// iterating all selected items again. @see updateSelectionStatistics()
+    struct SelectionStatistics {
+        int folderCount = 0;
+        int fileCount = 0;
+        KIO::filesize_t totalFileSize = 0;
+    };
+    SelectionStatistics m_selectionStatistics;
+    /// The selection m_selectionStatistics was computed for.
+    KItemSet m_selectionStatisticsIndexes;
+    bool m_selectionStatisticsStale;
+
     QVBoxLayout *m_topLayout;
 
     KFileItemModel *m_model;
     DolphinItemListView *m_view;
     KItemListContainer *m_container;
 
+    /// Lazily created facet counter over search results. @see searchFacetAggregator()
+    Search::FacetAggregator *m_searchFacetAggregator = nullptr;
+
     ToolTipManager *m_toolTipManager;
 
     QTimer *m_selectionChangedTimer;
 
+    /// Warms the dir lister cache for the directories the user will probably enter next.
+    DolphinDirectoryPrefetcher *m_directoryPrefetcher;
+
     QUrl m_currentItemUrl; // Used for making the view to remember the current URL after F5
     bool m_scrollToCurrentItem; // Used for marking we need to scroll to current item or not
     QPoint m_restoredContentsPosition;
@@ -30,6 +30,47 @@
 #include <QApplication>
 #include <QMenu>
 #include <QPointer>
+#include <QUrlQuery>
+
+namespace
+{
+/**
+ * The flattened view is a file name search with an empty search term: every descendant matches, and the parallel search machinery streams them into the view
+ * in batches. Keeping it a plain "filenamesearch" URL means the URL navigator, the history and the search bar all handle it like any other search.
+ * @returns the URL which shows everything beneath @p directory as one flat list.
+ */
+QUrl flattenedViewUrl(const QUrl &directory)
+{
+    QUrl url;
+    url.setScheme(QStringLiteral("filenamesearch"));
+
+    QUrlQuery query;
+    query.addQueryItem(QStringLiteral("search"), QString());
+    query.addQueryItem(QStringLiteral("url"), QUrl::toPercentEncoding(directory.url()));
+    query.addQueryItem(QStringLiteral("title"),
+                       QUrl::toPercentEncoding(i18nc("@title for a flattened folder listing. %1 is a folder name", "Everything in %1", directory.fileName())));
+
+    url.setQuery(query);
+    return url;
+}
+
+/** @returns whether @p url shows a flattened folder, i.e. is a file name search which matches everything. */
+bool isFlattenedViewUrl(const QUrl &url)
+{
+    if (url.scheme() != QLatin1String("filenamesearch")) {
+        return false;
+    }
+    const QUrlQuery query(url);
+    return query.queryItemValue(QStringLiteral("search"), QUrl::FullyDecoded).isEmpty() && query.queryItemValue(QStringLiteral("checkContent")) != QLatin1String("yes");
+}
+
+/** @returns the folder which the flattened view @p url lists the descendants of. */
+QUrl flattenedViewRoot(const QUrl &url)
+{
+    const QString searchPathString = QUrlQuery(url).queryItemValue(QStringLiteral("url"), QUrl::FullyDecoded);
+    return QUrl::fromUserInput(searchPathString, QString(), QUrl::AssumeLocalFile);
+}
+}
 
 DolphinViewActionHandler::DolphinViewActionHandler(KActionCollection *collection, SelectionMode::ActionTextHelper *actionTextHelper, QObject *parent)
     : QObject(parent)
@@ -53,6 +94,7 @@ void DolphinViewActionHandler::setCurrentView(DolphinView *view)
     m_currentView = view;
 
     connect(view, &DolphinView::modeChanged, this, &DolphinViewActionHandler::updateViewActions);
+    connect(view, &DolphinView::urlChanged, this, &DolphinViewActionHandler::updateFlattenedViewAction);
     connect(view, &DolphinView::previewsShownChanged, this, &DolphinViewActionHandler::slotPreviewsShownChanged);
     connect(view, &DolphinView::sortOrderChanged, this, &DolphinViewActionHandler::slotSortOrderChanged);
     connect(view, &DolphinView::sortFoldersFirstChanged, this, &DolphinViewActionHandler::slotSortFoldersFirstChanged);
@@ -350,6 +392,16 @@ void DolphinViewActionHandler::createActions(SelectionMode::ActionTextHelper *ac
     m_actionCollection->setDefaultShortcuts(showHiddenFiles, KStandardShortcut::showHideHiddenFiles());
     connect(showHiddenFiles, &KToggleAction::triggered, this, &DolphinViewActionHandler::toggleShowHiddenFiles);
 
+    KToggleAction *flattenView = m_actionCollection->add<KToggleAction>(QStringLiteral("flatten_view"));
+    flattenView->setText(i18nc("@action:inmenu View", "Flatten Folder View"));
+    flattenView->setWhatsThis(xi18nc("@info:whatsthis",
+                                     "<para>When this is enabled, the files and folders of <emphasis>all</emphasis> "
+                                     "subfolders are shown together in one flat list. This makes it easy to for example "
+                                     "sort every file of a deeply nested folder structure by their modification time.</para>"
+                                     "<para>The <interface>Path</interface> column shows which subfolder each item "
+                                     "belongs to. Flattening is only available for local folders.</para>"));
+    connect(flattenView, &KToggleAction::triggered, this, &DolphinViewActionHandler::toggleFlattenedView);
+
     QAction *adjustViewProps = m_actionCollection->addAction(QStringLiteral("view_properties"));
     adjustViewProps->setText(i18nc("@action:inmenu View", "Adjust View Display Style…"));
     adjustViewProps->setIcon(QIcon::fromTheme(QStringLiteral("view-choose")));
@@ -374,6 +426,7 @@ void DolphinViewActionHandler::createActions(SelectionMode::ActionTextHelper *ac
     viewSettings->addAction(showPreview);
     viewSettings->addAction(showInGroups);
     viewSettings->addAction(showHiddenFiles);
+    viewSettings->addAction(flattenView);
     viewSettings->addAction(adjustViewProps);
     viewSettings->setPopupMode(QToolButton::ToolButtonPopupMode::MenuButtonPopup);
     connect(viewSettings, &KActionMenu::triggered, viewModeActions, &KSelectAction::triggered);
@@ -562,6 +615,8 @@ void DolphinViewActionHandler::updateViewActions()
 
     // Updates the "show_hidden_files" action state and icon
     slotHiddenFilesShownChanged(m_currentView->hiddenFilesShown());
+
+    updateFlattenedViewAction();
 }
 
 void DolphinViewActionHandler::zoomIn()
@@ -676,6 +731,33 @@ void DolphinViewActionHandler::slotHiddenFilesShownChanged(bool shown)
     showHiddenFilesAction->setChecked(shown);
 }
 
+void DolphinViewActionHandler::toggleFlattenedView(bool flattened)
+{
+    Q_EMIT actionBeingHandled();
+    if (flattened) {
+        // The flattened listing uses the same view properties as searches, so the Path column is shown in details mode without touching the folder's own
+        // view properties.
+        m_currentView->setViewPropertiesContext(QStringLiteral("search"));
+        m_currentView->setUrl(flattenedViewUrl(m_currentView->url()));
+    } else {
+        const QUrl root = flattenedViewRoot(m_currentView->url());
+        if (root.isValid()) {
+            m_currentView->setViewPropertiesContext(QString());
+            m_currentView->setUrl(root);
+        }
+    }
+}
+
+void DolphinViewActionHandler::updateFlattenedViewAction()
+{
+    QAction *flattenViewAction = m_actionCollection->action(QStringLiteral("flatten_view"));
+    const QUrl url = m_currentView->url();
+    const bool flattened = isFlattenedViewUrl(url);
+    flattenViewAction->setChecked(flattened);
+    // Only local folders can be flattened: the walker which gathers the descendants works on local paths, see Search::FilenameSearchEngine::canSearch().
+    flattenViewAction->setEnabled(flattened || url.isLocalFile());
+}
+
 void DolphinViewActionHandler::slotWriteStateChanged(bool isFolderWritable)
 {
     const bool supportsMakeDir = KProtocolManager::supportsMakeDir(currentView()->url());
@@ -206,6 +206,18 @@ private Q_SLOTS:
      */
     void slotHiddenFilesShownChanged(bool shown);
 
+    /**
+     * Switches between the flat listing of all files beneath the current
+     * folder and the normal listing of the folder itself.
+     */
+    void toggleFlattenedView(bool flattened);
+
+    /**
+     * Updates the checked and enabled state of the 'Flatten Folder View'
+     * menu action for the URL the current view shows.
+     */
+    void updateFlattenedViewAction();
+
     /**
      * Updates the state of the 'Create Folder...' action.
      */
@@ -24,6 +24,7 @@ DolphinFileMetaDataWidget::DolphinFileMetaDataWidget(QWidget *parent)
     : QWidget(parent)
     , m_preview(nullptr)
     , m_name(nullptr)
+    , m_separator(nullptr)
     , m_fileMetaDataWidget(nullptr)
 {
     // Create widget for file preview
@@ -44,6 +45,7 @@ DolphinFileMetaDataWidget::DolphinFileMetaDataWidget(QWidget *parent)
     m_name->setMaximumWidth(fontMetrics.averageCharWidth() * 40);
 
     // Create widget for the meta data
+    m_separator = new KSeparator();
     m_fileMetaDataWidget = new Baloo::FileMetaDataWidget(this);
     connect(m_fileMetaDataWidget, &Baloo::FileMetaDataWidget::metaDataRequestFinished, this, &DolphinFileMetaDataWidget::metaDataRequestFinished);
     connect(m_fileMetaDataWidget, &Baloo::FileMetaDataWidget::urlActivated, this, &DolphinFileMetaDataWidget::urlActivated);
@@ -52,7 +54,7 @@ DolphinFileMetaDataWidget::DolphinFileMetaDataWidget(QWidget *parent)
 
     QVBoxLayout *textLayout = new QVBoxLayout();
     textLayout->addWidget(m_name);
-    textLayout->addWidget(new KSeparator());
+    textLayout->addWidget(m_separator);
     textLayout->addWidget(m_fileMetaDataWidget);
     textLayout->setAlignment(m_name, Qt::AlignCenter);
     textLayout->setAlignment(m_fileMetaDataWidget, Qt::AlignLeft);
@@ -132,4 +134,10 @@ KFileItemList DolphinFileMetaDataWidget::items() const
     return m_fileMetaDataWidget->items();
 }
 
+void DolphinFileMetaDataWidget::setMetaDataShown(bool shown)
+{
+    m_separator->setVisible(shown);
+    m_fileMetaDataWidget->setVisible(shown);
+}
+
 #include "moc_dolphinfilemetadatawidget.cpp"
@@ -14,6 +14,7 @@
 #include <QWidget>
 
 class KFileItemList;
+class KSeparator;
 class QLabel;
 
 namespace Baloo
@@ -47,6 +48,14 @@ public:
     void setItems(const KFileItemList &items);
     KFileItemList items() const;
 
+    /**
+     * Shows or hides the meta data section. Used to present the tooltip with
+     * the instantly available name and preview while the meta data for the
+     * items is still being retrieved: the section would otherwise show the
+     * rows of the previously hovered item until the retrieval has finished.
+     */
+    void setMetaDataShown(bool shown);
+
 Q_SIGNALS:
     /**
      * Is emitted after the meta data has been received for the items
@@ -63,6 +72,7 @@ Q_SIGNALS:
 private:
     QLabel *m_preview;
     QLabel *m_name;
+    KSeparator *m_separator;
     Baloo::FileMetaDataWidget *m_fileMetaDataWidget;
 };
 
@@ -7,6 +7,7 @@
 #include "tooltipmanager.h"
 
 #include "dolphinfilemetadatawidget.h"
+#include "kitemviews/private/kfileitemrolescache.h"
 
 #include <KConfigGroup>
 #include <KIO/PreviewJob>
@@ -30,6 +31,14 @@ public:
 
 Q_GLOBAL_STATIC(IconLoaderSingleton, iconLoader)
 
+namespace
+{
+// Size previews are requested with, also used as cache key so that
+// re-hovering an item serves the preview from memory. The cache is keyed by
+// URL and modification time, so changed files are never served stale.
+const QSize ToolTipPreviewSize{512, 512};
+}
+
 ToolTipManager::ToolTipManager(QWidget *parent)
     : QObject(parent)
     , m_showToolTipTimer(nullptr)
@@ -133,9 +142,27 @@ void ToolTipManager::startContentRetrieval()
     // Request a preview of the item
     m_fileMetaDataWidget->setPreview(QPixmap());
 
+    bool supportsSequencing = false;
+    QPixmap cachedPreview = KFileItemRolesCache::instance()->preview(m_item, ToolTipPreviewSize, m_fileMetaDataWidget->devicePixelRatioF(), &supportsSequencing);
+    if (cachedPreview.isNull()) {
+        // No preview was made at the tooltip size yet, but a view might
+        // already hold a thumbnail of this item at its icon size which is
+        // close enough for the tooltip.
+        cachedPreview = KFileItemRolesCache::instance()->nearestPreview(m_item, ToolTipPreviewSize, m_fileMetaDataWidget->devicePixelRatioF());
+    }
+    if (!cachedPreview.isNull()) {
+        // Re-hovering an item, or hovering an item whose preview a view
+        // already resolved: no I/O needed at all.
+        m_fileMetaDataWidget->setPreview(cachedPreview);
+        if (!m_showToolTipTimer->isActive()) {
+            showToolTip();
+        }
+        return;
+    }
+
     const KConfigGroup globalConfig(KSharedConfig::openConfig(), QLatin1String("PreviewSettings"));
     const QStringList plugins = globalConfig.readEntry("Plugins", KIO::PreviewJob::defaultPlugins());
-    KIO::PreviewJob *job = new KIO::PreviewJob(KFileItemList() << m_item, QSize(512, 512), &plugins);
+    KIO::PreviewJob *job = new KIO::PreviewJob(KFileItemList() << m_item, ToolTipPreviewSize, &plugins);
     job->setDevicePixelRatio(m_fileMetaDataWidget->devicePixelRatioF());
     job->setIgnoreMaximumSize(m_item.isLocalFile() && !m_item.isSlow());
     if (job->uiDelegate()) {
@@ -148,6 +175,12 @@ void ToolTipManager::startContentRetrieval()
 
 void ToolTipManager::setPreviewPix(const KFileItem &item, const QPixmap &pixmap)
 {
+    if (!pixmap.isNull()) {
+        // Remember the preview even if the tooltip got canceled meanwhile:
+        // the expensive work is done and re-hovering the item can use it.
+        KFileItemRolesCache::instance()->insertPreview(item, ToolTipPreviewSize, pixmap.devicePixelRatio(), pixmap, false);
+    }
+
     if (!m_toolTipRequested || (m_item.url() != item.url())) {
         // No tooltip is requested anymore or an old preview has been received
         return;
@@ -183,14 +216,22 @@ void ToolTipManager::previewFailed()
 
 void ToolTipManager::slotMetaDataRequestFinished()
 {
-    if (!m_toolTipRequested) {
+    m_metaDataRequested = false;
+
+    if (m_toolTipRequested) {
+        if (!m_showToolTipTimer->isActive()) {
+            showToolTip();
+        }
         return;
     }
 
-    m_metaDataRequested = false;
-
-    if (!m_showToolTipTimer->isActive()) {
-        showToolTip();
+    // The tooltip is already visible with the instantly available name and
+    // preview. Add the meta data section now that it refers to the shown item.
+    if (m_tooltipWidget && m_tooltipWidget->isVisible() && m_fileMetaDataWidget->items().count() == 1
+        && m_fileMetaDataWidget->items().first().url() == m_item.url()) {
+        m_fileMetaDataWidget->setMetaDataShown(true);
+        m_fileMetaDataWidget->adjustSize();
+        m_tooltipWidget->showBelow(m_itemRect, m_fileMetaDataWidget, m_transientParent);
     }
 }
 
@@ -202,13 +243,19 @@ void ToolTipManager::showToolTip()
         m_appliedWaitCursor = false;
     }
 
-    if (m_fileMetaDataWidget->preview().isNull() || m_metaDataRequested) {
+    if (m_fileMetaDataWidget->preview().isNull()) {
         Q_ASSERT(!m_appliedWaitCursor);
         QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
         m_appliedWaitCursor = true;
         return;
     }
 
+    // Do not wait for the meta data: on slow (e.g. remote) locations the
+    // retrieval can take a while. The section is hidden for the time being -
+    // it would still show the rows of the previously hovered item - and gets
+    // added by slotMetaDataRequestFinished() when the data arrives.
+    m_fileMetaDataWidget->setMetaDataShown(!m_metaDataRequested);
+
     // Adjust the size to get a proper sizeHint()
     m_fileMetaDataWidget->adjustSize();
     if (!m_tooltipWidget) {
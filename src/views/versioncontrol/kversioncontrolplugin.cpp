@@ -7,6 +7,8 @@
 
 #include "kversioncontrolplugin.h"
 
+#include <KFileItem>
+
 KVersionControlPlugin::KVersionControlPlugin(QObject *parent)
     : QObject(parent)
 {
@@ -21,4 +23,31 @@ QString KVersionControlPlugin::localRepositoryRoot(const QString & /*directory*/
     return QString();
 }
 
+bool KVersionControlPlugin::supportsConcurrentRetrieval() const
+{
+    return false;
+}
+
+void KVersionControlPlugin::itemVersions(const KFileItemList &items, const std::function<void(const KFileItem &item, ItemVersion version)> &callback)
+{
+    QString currentDirectory;
+    bool retrieving = false;
+
+    for (const KFileItem &item : items) {
+        const QString directory = item.url().adjusted(QUrl::RemoveFilename).path();
+        if (directory != currentDirectory) {
+            if (!currentDirectory.isEmpty()) {
+                endRetrieval();
+            }
+            currentDirectory = directory;
+            retrieving = beginRetrieval(directory);
+        }
+        callback(item, retrieving ? itemVersion(item) : UnversionedVersion);
+    }
+
+    if (!currentDirectory.isEmpty()) {
+        endRetrieval();
+    }
+}
+
 #include "moc_kversioncontrolplugin.cpp"
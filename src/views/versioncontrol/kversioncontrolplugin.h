@@ -13,6 +13,8 @@
 #include <QAction>
 #include <QObject>
 
+#include <functional>
+
 class KFileItemList;
 class KFileItem;
 /**
@@ -170,6 +172,30 @@ public:
      */
     virtual ItemVersion itemVersion(const KFileItem &item) const = 0;
 
+    /**
+     * @return True if beginRetrieval(), itemVersion() and endRetrieval() may
+     *         be invoked for different directories from several threads at
+     *         the same time. Declaring this allows the file manager to
+     *         retrieve the states of large directory trees concurrently.
+     *         The default implementation returns false, which keeps the
+     *         serialized invocation contract described above, so existing
+     *         plugins are unaffected.
+     * @since 26.12
+     */
+    virtual bool supportsConcurrentRetrieval() const;
+
+    /**
+     * Retrieves the version of every item in \p items and reports each
+     * result through \p callback. Consecutive items belong to the same
+     * directory. The default implementation drives beginRetrieval(),
+     * itemVersion() and endRetrieval() per directory, so existing plugins
+     * keep working unchanged; plugins whose backend can answer a whole list
+     * with one query (e.g. a single parsed "git status" run) should
+     * override this to avoid per-item costs.
+     * @since 26.12
+     */
+    virtual void itemVersions(const KFileItemList &items, const std::function<void(const KFileItem &item, ItemVersion version)> &callback);
+
     /**
      * @return List of actions that are available for the \p items in a version controlled
      *         path.
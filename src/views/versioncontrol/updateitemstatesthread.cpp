@@ -27,21 +27,44 @@ void UpdateItemStatesThread::run()
 {
     Q_ASSERT(!m_itemStates.isEmpty());
 
+    if (m_plugin && m_plugin->supportsConcurrentRetrieval()) {
+        // The plugin handles its own synchronization; the shards of one
+        // update may query it from several threads at the same time.
+        retrieveStates();
+        return;
+    }
+
     QMutexLocker pluginLocker(m_globalPluginMutex);
-    QMap<QString, QVector<VersionControlObserver::ItemState>>::iterator it = m_itemStates.begin();
-    for (; it != m_itemStates.end() && !isInterruptionRequested(); ++it) {
-        if (m_plugin->beginRetrieval(it.key())) {
-            QVector<VersionControlObserver::ItemState> &items = it.value();
-            const int count = items.count();
-            for (int i = 0; i < count && !isInterruptionRequested(); ++i) {
-                const KFileItem &item = items.at(i).first;
-                const KVersionControlPlugin::ItemVersion version = m_plugin->itemVersion(item);
-                items[i].second = version;
-            }
-        }
+    retrieveStates();
+}
+
+void UpdateItemStatesThread::retrieveStates()
+{
+    if (isInterruptionRequested()) {
+        return;
+    }
 
-        m_plugin->endRetrieval();
+    // Hand all items of the update to the plugin in one batch. Items of one
+    // directory stay consecutive, as required by the itemVersions() contract.
+    KFileItemList fileItems;
+    QHash<QUrl, QPair<QString, int>> positionForUrl;
+    QMap<QString, QVector<VersionControlObserver::ItemState>>::const_iterator it = m_itemStates.constBegin();
+    for (; it != m_itemStates.constEnd(); ++it) {
+        const QVector<VersionControlObserver::ItemState> &items = it.value();
+        for (int i = 0; i < items.count(); ++i) {
+            fileItems.append(items.at(i).first);
+            positionForUrl.insert(items.at(i).first.url(), qMakePair(it.key(), i));
+        }
     }
+
+    // The results may be streamed back in any order, so they are matched to
+    // the item states by URL.
+    m_plugin->itemVersions(fileItems, [this, &positionForUrl](const KFileItem &item, KVersionControlPlugin::ItemVersion version) {
+        const QPair<QString, int> position = positionForUrl.value(item.url(), qMakePair(QString(), -1));
+        if (position.second >= 0) {
+            m_itemStates[position.first][position.second].second = version;
+        }
+    });
 }
 
 QMap<QString, QVector<VersionControlObserver::ItemState>> UpdateItemStatesThread::itemStates() const
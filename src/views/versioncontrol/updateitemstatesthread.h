@@ -41,6 +41,12 @@ protected:
     void run() override;
 
 private:
+    /**
+     * Queries the plugin for the state of every item in m_itemStates with
+     * one KVersionControlPlugin::itemVersions() batch call.
+     */
+    void retrieveStates();
+
     QMutex *m_globalPluginMutex; // Protects the m_plugin globally
     QPointer<KVersionControlPlugin> m_plugin;
 
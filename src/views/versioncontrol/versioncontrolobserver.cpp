@@ -10,14 +10,31 @@
 #include "dolphindebug.h"
 #include "kitemviews/kfileitemmodel.h"
 #include "updateitemstatesthread.h"
+#include "versioncontrolstatecache.h"
 #include "views/dolphinview.h"
 
+#include <KDirWatch>
 #include <KLocalizedString>
 #include <KPluginFactory>
 #include <KPluginMetaData>
 
+#include <QDir>
+#include <QFileInfo>
 #include <QTimer>
 
+namespace
+{
+// Bounds for the adaptive debouncing of re-checks which are driven by
+// repository metadata changes. A lone event (e.g. a commit in a terminal)
+// refreshes the decorations after the minimum delay; while events keep
+// arriving faster than the current delay the delay doubles up to the maximum,
+// so heavy churn like a rebase results in a few intermediate re-checks and a
+// final one instead of thousands. See
+// VersionControlObserver::slotRepositoryMetaDataChanged().
+const int MinRepositoryEventDebounceMs = 200;
+const int MaxRepositoryEventDebounceMs = 5000;
+}
+
 VersionControlObserver::VersionControlObserver(QObject *parent)
     : QObject(parent)
     , m_pendingItemStatesUpdate(false)
@@ -27,7 +44,11 @@ VersionControlObserver::VersionControlObserver(QObject *parent)
     , m_dirVerificationTimer(nullptr)
     , m_pluginsInitialized(false)
     , m_currentPlugin(nullptr)
-    , m_updateItemStatesThread(nullptr)
+    , m_stateCache(nullptr)
+    , m_repoMetaDataWatch(nullptr)
+    , m_watchedRepoMetaDataPathIsDir(false)
+    , m_repoMetaDataDebounceTimer(nullptr)
+    , m_repoMetaDataDebounceInterval(MinRepositoryEventDebounceMs)
 {
     // The verification timer specifies the timeout until the shown directory
     // is checked whether it is versioned. Per default it is assumed that users
@@ -38,6 +59,15 @@ VersionControlObserver::VersionControlObserver(QObject *parent)
     m_dirVerificationTimer->setSingleShot(true);
     m_dirVerificationTimer->setInterval(500);
     connect(m_dirVerificationTimer, &QTimer::timeout, this, &VersionControlObserver::verifyDirectory);
+
+    m_repoMetaDataWatch = new KDirWatch(this);
+    connect(m_repoMetaDataWatch, &KDirWatch::dirty, this, &VersionControlObserver::slotRepositoryMetaDataChanged);
+    connect(m_repoMetaDataWatch, &KDirWatch::created, this, &VersionControlObserver::slotRepositoryMetaDataChanged);
+    connect(m_repoMetaDataWatch, &KDirWatch::deleted, this, &VersionControlObserver::slotRepositoryMetaDataChanged);
+
+    m_repoMetaDataDebounceTimer = new QTimer(this);
+    m_repoMetaDataDebounceTimer->setSingleShot(true);
+    connect(m_repoMetaDataDebounceTimer, &QTimer::timeout, this, &VersionControlObserver::silentDirectoryVerification);
 }
 
 VersionControlObserver::~VersionControlObserver()
@@ -45,17 +75,21 @@ VersionControlObserver::~VersionControlObserver()
     if (m_currentPlugin) {
         m_currentPlugin->disconnect(this);
     }
-    if (m_updateItemStatesThread) {
-        m_updateItemStatesThread->requestInterruption();
-        m_updateItemStatesThread->wait();
-        m_updateItemStatesThread->deleteLater();
+    for (UpdateItemStatesThread *thread : std::as_const(m_updateItemStatesThreads)) {
+        thread->requestInterruption();
+        thread->wait();
+        thread->deleteLater();
     }
+    m_updateItemStatesThreads.clear();
 
     if (m_currentPlugin) {
         delete m_currentPlugin;
         m_currentPlugin = nullptr;
     }
     m_plugins.clear();
+
+    delete m_stateCache;
+    m_stateCache = nullptr;
 }
 
 void VersionControlObserver::setModel(KFileItemModel *model)
@@ -64,9 +98,10 @@ void VersionControlObserver::setModel(KFileItemModel *model)
         if (m_currentPlugin) {
             delete m_currentPlugin;
             m_currentPlugin = nullptr;
+            updateRepositoryMetaDataWatch();
         }
-        if (m_updateItemStatesThread) {
-            m_updateItemStatesThread->requestInterruption();
+        for (UpdateItemStatesThread *thread : std::as_const(m_updateItemStatesThreads)) {
+            thread->requestInterruption();
         }
         disconnect(m_model, &KFileItemModel::itemsInserted, this, &VersionControlObserver::delayedDirectoryVerification);
         disconnect(m_model, &KFileItemModel::itemsChanged, this, &VersionControlObserver::slotItemsChanged);
@@ -123,6 +158,10 @@ QList<QAction *> VersionControlObserver::actions(const KFileItemList &items) con
     if (isVersionControlled()) {
         return m_currentPlugin->versionControlActions(items);
     } else {
+        // Plugins which never matched a shown directory are still unloaded at
+        // this point, but may offer actions outside of a working copy (e.g.
+        // "clone" or "checkout"), so they have to be loaded now.
+        const_cast<VersionControlObserver *>(this)->loadAllPlugins();
         QList<QAction *> actions;
         for (const KVersionControlPlugin *plugin : std::as_const(m_plugins)) {
             actions << plugin->outOfVersionControlActions(items);
@@ -165,6 +204,23 @@ void VersionControlObserver::slotItemsChanged(const KItemRangeList &itemRanges,
     }
 }
 
+void VersionControlObserver::slotRepositoryMetaDataChanged(const QString &path)
+{
+    Q_UNUSED(path)
+
+    if (m_timeSinceRepoMetaDataEvent.isValid() && m_timeSinceRepoMetaDataEvent.elapsed() < m_repoMetaDataDebounceInterval) {
+        // Events arrive in rapid succession, e.g. because a rebase or a large
+        // checkout rewrites the metadata over and over. Back off so that the
+        // churn results in a few re-checks instead of one per event; the
+        // re-check after the final event still runs once the timer fires.
+        m_repoMetaDataDebounceInterval = qMin(m_repoMetaDataDebounceInterval * 2, MaxRepositoryEventDebounceMs);
+    } else {
+        m_repoMetaDataDebounceInterval = MinRepositoryEventDebounceMs;
+    }
+    m_timeSinceRepoMetaDataEvent.start();
+    m_repoMetaDataDebounceTimer->start(m_repoMetaDataDebounceInterval);
+}
+
 void VersionControlObserver::verifyDirectory()
 {
     if (!m_model) {
@@ -178,6 +234,7 @@ void VersionControlObserver::verifyDirectory()
 
     if (m_currentPlugin && rootItem.url().path().startsWith(m_localRepoRoot) && QFile::exists(m_localRepoRoot + '/' + m_currentPlugin->fileName())) {
         // current directory is still versioned
+        updateRepositoryMetaDataWatch();
         updateItemStates();
         return;
     }
@@ -186,6 +243,7 @@ void VersionControlObserver::verifyDirectory()
         // The directory is versioned. Assume that the user will further browse through
         // versioned directories and decrease the verification timer.
         m_dirVerificationTimer->setInterval(100);
+        updateRepositoryMetaDataWatch();
         updateItemStates();
         return;
     }
@@ -194,29 +252,27 @@ void VersionControlObserver::verifyDirectory()
     // value, so that browsing through non-versioned directories is not slown down
     // by an immediate verification.
     m_dirVerificationTimer->setInterval(500);
+    updateRepositoryMetaDataWatch();
 }
 
 void VersionControlObserver::slotThreadFinished()
 {
-    UpdateItemStatesThread *thread = m_updateItemStatesThread;
-    m_updateItemStatesThread = nullptr; // The thread deletes itself automatically (see updateItemStates())
+    UpdateItemStatesThread *thread = qobject_cast<UpdateItemStatesThread *>(sender());
+    m_updateItemStatesThreads.removeOne(thread); // The thread deletes itself automatically (see updateItemStates())
 
-    if (!m_currentPlugin || !thread) {
-        return;
+    if (m_currentPlugin && thread) {
+        // Apply the states of this shard right away instead of waiting for
+        // the other shards, so decorations appear incrementally.
+        applyStates(thread->itemStates());
     }
 
-    const QMap<QString, QVector<ItemState>> &itemStates = thread->itemStates();
-    QMap<QString, QVector<ItemState>>::const_iterator it = itemStates.constBegin();
-    for (; it != itemStates.constEnd(); ++it) {
-        const QVector<ItemState> &items = it.value();
+    if (!m_updateItemStatesThreads.isEmpty()) {
+        // Other shards of this update are still being retrieved.
+        return;
+    }
 
-        for (const ItemState &item : items) {
-            const KFileItem &fileItem = item.first;
-            const KVersionControlPlugin::ItemVersion version = item.second;
-            QHash<QByteArray, QVariant> values;
-            values.insert("version", QVariant(version));
-            m_model->setData(m_model->index(fileItem), values);
-        }
+    if (m_stateCache) {
+        m_stateCache->save();
     }
 
     if (!m_silentUpdate) {
@@ -235,8 +291,8 @@ void VersionControlObserver::slotThreadFinished()
 void VersionControlObserver::updateItemStates()
 {
     Q_ASSERT(m_currentPlugin);
-    if (m_updateItemStatesThread) {
-        // An update is currently ongoing. Wait until the thread has finished
+    if (!m_updateItemStatesThreads.isEmpty()) {
+        // An update is currently ongoing. Wait until the threads have finished
         // the update (see slotThreadFinished()).
         m_pendingItemStatesUpdate = true;
         return;
@@ -245,16 +301,119 @@ void VersionControlObserver::updateItemStates()
     QMap<QString, QVector<ItemState>> itemStates;
     createItemStatesList(itemStates);
 
-    if (!itemStates.isEmpty()) {
-        if (!m_silentUpdate) {
-            Q_EMIT infoMessage(i18nc("@info:status", "Updating version information…"));
+    if (itemStates.isEmpty()) {
+        return;
+    }
+
+    if (!m_stateCache || m_stateCache->repositoryRoot() != m_localRepoRoot) {
+        delete m_stateCache;
+        m_stateCache = new VersionControlStateCache(m_localRepoRoot, m_currentPlugin->fileName());
+    }
+
+    if (m_stateCache->isCurrent()) {
+        // The repository metadata is unchanged, so the cached states are
+        // still valid. Paint the decorations from the cache and only ask the
+        // plugin about directories with items the cache does not know.
+        QMap<QString, QVector<ItemState>> knownStates;
+        QMap<QString, QVector<ItemState>> unknownStates;
+        for (auto it = itemStates.begin(); it != itemStates.end(); ++it) {
+            QVector<ItemState> &items = it.value();
+            bool allKnown = true;
+            for (ItemState &item : items) {
+                if (!m_stateCache->retrieve(item.first.localPath(), &item.second)) {
+                    allKnown = false;
+                    break;
+                }
+            }
+            if (allKnown) {
+                knownStates.insert(it.key(), items);
+            } else {
+                unknownStates.insert(it.key(), items);
+            }
+        }
+
+        applyStates(knownStates);
+        itemStates = unknownStates;
+        if (itemStates.isEmpty()) {
+            return;
         }
-        m_updateItemStatesThread = new UpdateItemStatesThread(m_currentPlugin, itemStates);
-        connect(m_updateItemStatesThread, &UpdateItemStatesThread::finished, this, &VersionControlObserver::slotThreadFinished);
-        connect(m_updateItemStatesThread, &UpdateItemStatesThread::finished, m_updateItemStatesThread, &UpdateItemStatesThread::deleteLater);
+    } else {
+        // The repository changed: every cached state may be stale. Restart
+        // the cache under the repository's new metadata key; it is refilled
+        // with the answers of the plugin.
+        m_stateCache->invalidate();
+    }
+
+    if (!m_silentUpdate) {
+        Q_EMIT infoMessage(i18nc("@info:status", "Updating version information…"));
+    }
+
+    // Plugins that declare concurrent retrieval get the directories
+    // partitioned across several threads; each shard is applied as soon as
+    // it finishes. All other plugins keep the single retrieval thread.
+    int shardCount = 1;
+    if (m_currentPlugin->supportsConcurrentRetrieval()) {
+        shardCount = qMin(QThread::idealThreadCount(), int(itemStates.count()));
+        shardCount = qMax(shardCount, 1);
+    }
+
+    QVector<QMap<QString, QVector<ItemState>>> shards(shardCount);
+    QVector<int> shardLoads(shardCount, 0);
+    QMap<QString, QVector<ItemState>>::const_iterator it = itemStates.constBegin();
+    for (; it != itemStates.constEnd(); ++it) {
+        // Assign each directory to the shard with the fewest items so the
+        // threads finish at roughly the same time.
+        int targetShard = 0;
+        for (int i = 1; i < shardCount; ++i) {
+            if (shardLoads.at(i) < shardLoads.at(targetShard)) {
+                targetShard = i;
+            }
+        }
+        shards[targetShard].insert(it.key(), it.value());
+        shardLoads[targetShard] += it.value().count();
+    }
+
+    for (const QMap<QString, QVector<ItemState>> &shard : std::as_const(shards)) {
+        if (shard.isEmpty()) {
+            continue;
+        }
+        UpdateItemStatesThread *thread = new UpdateItemStatesThread(m_currentPlugin, shard);
+        connect(thread, &UpdateItemStatesThread::finished, this, &VersionControlObserver::slotThreadFinished);
+        connect(thread, &UpdateItemStatesThread::finished, thread, &UpdateItemStatesThread::deleteLater);
+        m_updateItemStatesThreads.append(thread);
+    }
+
+    for (UpdateItemStatesThread *thread : std::as_const(m_updateItemStatesThreads)) {
+        thread->start(); // slotThreadFinished() is called when finished
+    }
+}
+
+void VersionControlObserver::applyStates(const QMap<QString, QVector<ItemState>> &itemStates)
+{
+    QList<QPair<int, QVariant>> indexValues;
+
+    QMap<QString, QVector<ItemState>>::const_iterator it = itemStates.constBegin();
+    for (; it != itemStates.constEnd(); ++it) {
+        const QVector<ItemState> &items = it.value();
+
+        for (const ItemState &item : items) {
+            const KFileItem &fileItem = item.first;
+            const KVersionControlPlugin::ItemVersion version = item.second;
+            const int index = m_model->index(fileItem);
+            if (index >= 0) {
+                indexValues.append(qMakePair(index, QVariant(version)));
+            }
 
-        m_updateItemStatesThread->start(); // slotThreadFinished() is called when finished
+            if (m_stateCache) {
+                m_stateCache->insert(fileItem.localPath(), version);
+            }
+        }
     }
+
+    // One bulk call emits ranged itemsChanged() signals instead of one
+    // signal per item, which keeps the view updates cheap for huge
+    // working copies.
+    m_model->setDataForRole("version", indexValues);
 }
 
 int VersionControlObserver::createItemStatesList(QMap<QString, QVector<ItemState>> &itemStates, const int firstIndex)
@@ -294,37 +453,71 @@ int VersionControlObserver::createItemStatesList(QMap<QString, QVector<ItemState
 void VersionControlObserver::initPlugins()
 {
     if (!m_pluginsInitialized) {
-        // No searching for plugins has been done yet. Query all fileview version control
-        // plugins and remember them in 'plugins'.
+        // Only the metadata of the enabled plugins is queried here. Loading
+        // the plugin binaries is expensive and most directories are not under
+        // version control at all, so each plugin is only instantiated once a
+        // shown directory actually matches it (see searchPlugin()).
         const QStringList enabledPlugins = VersionControlSettings::enabledPlugins();
 
         const QVector<KPluginMetaData> plugins = KPluginMetaData::findPlugins(QStringLiteral("dolphin/vcs"));
 
         for (const auto &p : plugins) {
             if (enabledPlugins.contains(p.name())) {
-                auto plugin = KPluginFactory::instantiatePlugin<KVersionControlPlugin>(p, parent()).plugin;
-                if (plugin) {
-                    m_plugins.append(plugin);
-                }
+                m_pendingPlugins.append(p);
             }
         }
 
-        for (const auto *plugin : std::as_const(m_plugins)) {
-            connect(plugin, &KVersionControlPlugin::itemVersionsChanged, this, &VersionControlObserver::silentDirectoryVerification);
-            connect(plugin, &KVersionControlPlugin::infoMessage, this, &VersionControlObserver::infoMessage);
-            connect(plugin, &KVersionControlPlugin::errorMessage, this, &VersionControlObserver::errorMessage);
-            connect(plugin, &KVersionControlPlugin::operationCompletedMessage, this, &VersionControlObserver::operationCompletedMessage);
-        }
-
         m_pluginsInitialized = true;
     }
 }
 
+KVersionControlPlugin *VersionControlObserver::instantiatePlugin(const KPluginMetaData &data)
+{
+    auto plugin = KPluginFactory::instantiatePlugin<KVersionControlPlugin>(data, parent()).plugin;
+    if (!plugin) {
+        return nullptr;
+    }
+
+    connect(plugin, &KVersionControlPlugin::itemVersionsChanged, this, &VersionControlObserver::silentDirectoryVerification);
+    connect(plugin, &KVersionControlPlugin::infoMessage, this, &VersionControlObserver::infoMessage);
+    connect(plugin, &KVersionControlPlugin::errorMessage, this, &VersionControlObserver::errorMessage);
+    connect(plugin, &KVersionControlPlugin::operationCompletedMessage, this, &VersionControlObserver::operationCompletedMessage);
+
+    m_plugins.append(plugin);
+    return plugin;
+}
+
+void VersionControlObserver::loadAllPlugins()
+{
+    initPlugins();
+
+    const QVector<KPluginMetaData> pending = m_pendingPlugins;
+    m_pendingPlugins.clear();
+    for (const KPluginMetaData &data : pending) {
+        instantiatePlugin(data);
+    }
+}
+
+QString VersionControlObserver::findMarkerDirectory(const QString &directory, const QStringList &markers)
+{
+    QDir dir(directory);
+    do {
+        for (const QString &marker : markers) {
+            if (dir.exists(marker)) {
+                return dir.path();
+            }
+        }
+    } while (dir.cdUp());
+
+    return QString();
+}
+
 KVersionControlPlugin *VersionControlObserver::searchPlugin(const QUrl &directory)
 {
     initPlugins();
 
-    // Verify whether the current directory is under a version system
+    // Verify whether the current directory is under a version system known
+    // to an already loaded plugin.
     for (KVersionControlPlugin *plugin : std::as_const(m_plugins)) {
         // first naively check if we are at working copy root
         const QString fileName = directory.path() + '/' + plugin->fileName();
@@ -339,6 +532,40 @@ KVersionControlPlugin *VersionControlObserver::searchPlugin(const QUrl &director
             return plugin;
         }
     }
+
+    // Probe the plugins which have not been loaded yet. Plugins which declare
+    // their repository markers in their metadata are only loaded once such a
+    // marker is found at or above the directory; all others have to be loaded
+    // to be asked at all.
+    for (int i = 0; i < m_pendingPlugins.count();) {
+        const KPluginMetaData data = m_pendingPlugins.at(i);
+        const QStringList markers = data.value(QStringLiteral("X-Dolphin-VersionControlMarkers"), QStringList());
+        if (!markers.isEmpty() && findMarkerDirectory(directory.path(), markers).isEmpty()) {
+            // No working copy of this kind anywhere above the directory, the
+            // plugin stays unloaded.
+            ++i;
+            continue;
+        }
+
+        m_pendingPlugins.removeAt(i);
+        KVersionControlPlugin *plugin = instantiatePlugin(data);
+        if (!plugin) {
+            continue;
+        }
+
+        const QString fileName = directory.path() + '/' + plugin->fileName();
+        if (QFile::exists(fileName)) {
+            m_localRepoRoot = directory.path();
+            return plugin;
+        }
+
+        const QString root = plugin->localRepositoryRoot(directory.path());
+        if (!root.isEmpty()) {
+            m_localRepoRoot = root;
+            return plugin;
+        }
+    }
+
     return nullptr;
 }
 
@@ -347,4 +574,37 @@ bool VersionControlObserver::isVersionControlled() const
     return m_currentPlugin != nullptr;
 }
 
+void VersionControlObserver::updateRepositoryMetaDataWatch()
+{
+    const QString metaDataPath = (m_currentPlugin && !m_localRepoRoot.isEmpty()) ? m_localRepoRoot + '/' + m_currentPlugin->fileName() : QString();
+    if (metaDataPath == m_watchedRepoMetaDataPath) {
+        return;
+    }
+
+    if (!m_watchedRepoMetaDataPath.isEmpty()) {
+        if (m_watchedRepoMetaDataPathIsDir) {
+            m_repoMetaDataWatch->removeDir(m_watchedRepoMetaDataPath);
+        } else {
+            m_repoMetaDataWatch->removeFile(m_watchedRepoMetaDataPath);
+        }
+        m_repoMetaDataDebounceTimer->stop();
+        m_timeSinceRepoMetaDataEvent.invalidate();
+        m_repoMetaDataDebounceInterval = MinRepositoryEventDebounceMs;
+    }
+
+    m_watchedRepoMetaDataPath = metaDataPath;
+    if (!metaDataPath.isEmpty()) {
+        // Most plugins mark their working copies with a metadata directory
+        // (".git", ".svn", ...) whose modification time changes whenever the
+        // repository state changes; watching the directory entry alone is
+        // enough and avoids putting a watch on every file inside it.
+        m_watchedRepoMetaDataPathIsDir = QFileInfo(metaDataPath).isDir();
+        if (m_watchedRepoMetaDataPathIsDir) {
+            m_repoMetaDataWatch->addDir(metaDataPath);
+        } else {
+            m_repoMetaDataWatch->addFile(metaDataPath);
+        }
+    }
+}
+
 #include "moc_versioncontrolobserver.cpp"
@@ -12,18 +12,22 @@
 #include "kversioncontrolplugin.h"
 
 #include <KFileItem>
+#include <KPluginMetaData>
 
+#include <QElapsedTimer>
 #include <QList>
 #include <QObject>
 #include <QString>
 #include <QUrl>
 
+class KDirWatch;
 class KFileItemList;
 class KFileItemModel;
 class KItemRangeList;
 class QAction;
 class QTimer;
 class UpdateItemStatesThread;
+class VersionControlStateCache;
 
 class DolphinView;
 
@@ -91,11 +95,24 @@ private Q_SLOTS:
      */
     void slotItemsChanged(const KItemRangeList &itemRanges, const QSet<QByteArray> &roles);
 
+    /**
+     * Is invoked when the watched repository metadata path (e.g. ".git")
+     * changed, which happens when the working copy is modified outside of
+     * this view, e.g. by committing in a terminal. Schedules a silent
+     * re-check with adaptive debouncing: a lone event triggers the re-check
+     * quickly, while bursts of events - a rebase can touch the metadata
+     * thousands of times - back the delay off so that only a few re-checks
+     * run while the churn lasts and one final re-check follows it.
+     */
+    void slotRepositoryMetaDataChanged(const QString &path);
+
     void verifyDirectory();
 
     /**
-     * Is invoked if the thread m_updateItemStatesThread has been finished
-     * and applies the item states.
+     * Is invoked whenever one of the threads in m_updateItemStatesThreads
+     * has been finished. Applies the item states retrieved by that thread;
+     * once all threads of the update are done, the completion is reported
+     * and a pending update is started.
      */
     void slotThreadFinished();
 
@@ -104,6 +121,12 @@ private:
 
     void updateItemStates();
 
+    /**
+     * Applies \a itemStates to the model so the decorations update, and
+     * mirrors the states into m_stateCache.
+     */
+    void applyStates(const QMap<QString, QVector<ItemState>> &itemStates);
+
     /**
      * It creates a item state list for every expanded directory and stores
      * this list together with the directory url in the \a itemStates map.
@@ -130,9 +153,40 @@ private:
      */
     bool isVersionControlled() const;
 
+    /**
+     * Points m_repoMetaDataWatch at the metadata path of the currently
+     * detected repository (or stops watching when the shown directory is not
+     * versioned), so that slotRepositoryMetaDataChanged() is invoked for
+     * changes made outside of this view.
+     */
+    void updateRepositoryMetaDataWatch();
+
 private:
+    /**
+     * Queries the metadata of all enabled version control plugins. The plugin
+     * binaries themselves are not loaded here, see instantiatePlugin().
+     */
     void initPlugins();
 
+    /**
+     * Loads the plugin described by @p data and connects its signals.
+     * Returns the instantiated plugin, or nullptr if loading failed.
+     */
+    KVersionControlPlugin *instantiatePlugin(const KPluginMetaData &data);
+
+    /**
+     * Instantiates all plugins which are still pending. Needed to collect
+     * the actions plugins offer outside of a working copy.
+     */
+    void loadAllPlugins();
+
+    /**
+     * Walks from @p directory up to the root and returns the first directory
+     * which contains one of the @p markers (e.g. ".git"), or an empty string
+     * if there is none.
+     */
+    static QString findMarkerDirectory(const QString &directory, const QStringList &markers);
+
     bool m_pendingItemStatesUpdate;
     bool m_silentUpdate; // if true, no messages will be send during the update
                          // of version states
@@ -143,11 +197,39 @@ private:
 
     QTimer *m_dirVerificationTimer;
 
+    /** Watches the metadata path of the detected repository, see updateRepositoryMetaDataWatch(). */
+    KDirWatch *m_repoMetaDataWatch;
+    QString m_watchedRepoMetaDataPath;
+    bool m_watchedRepoMetaDataPathIsDir;
+
+    // Adaptive debouncing of metadata-driven re-checks, see slotRepositoryMetaDataChanged().
+    QTimer *m_repoMetaDataDebounceTimer;
+    QElapsedTimer m_timeSinceRepoMetaDataEvent;
+    int m_repoMetaDataDebounceInterval;
+
     bool m_pluginsInitialized;
     // directories have at most one plugin, this is the detected current one.
     KVersionControlPlugin *m_currentPlugin;
     QList<KVersionControlPlugin *> m_plugins;
-    UpdateItemStatesThread *m_updateItemStatesThread;
+
+    // Enabled plugins whose binaries have not been loaded yet. A plugin is
+    // only instantiated once a shown directory matches it, see searchPlugin().
+    QVector<KPluginMetaData> m_pendingPlugins;
+
+    /**
+     * The threads of the currently ongoing update. Plugins that declare
+     * KVersionControlPlugin::supportsConcurrentRetrieval() are queried by
+     * several threads at once, each retrieving the states of a share of the
+     * directories; all other plugins are driven by a single thread.
+     */
+    QList<UpdateItemStatesThread *> m_updateItemStatesThreads;
+
+    /**
+     * Persisted states of the repository m_localRepoRoot. While the
+     * repository metadata is unchanged, re-entering a directory paints the
+     * decorations from this cache instead of querying the plugin.
+     */
+    VersionControlStateCache *m_stateCache;
 
     friend class UpdateItemStatesThread;
 };
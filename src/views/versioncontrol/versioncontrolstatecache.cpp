@@ -0,0 +1,174 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "versioncontrolstatecache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace
+{
+/** Identifies the on-disk format; bump when the serialization changes. */
+constexpr quint32 CacheFormatVersion = 1;
+
+/**
+ * Upper bound for the number of persisted states. A cache that grew beyond
+ * this is not written back, so a pathological checkout cannot fill the disk.
+ */
+constexpr int MaxPersistedStates = 500000;
+}
+
+VersionControlStateCache::VersionControlStateCache(const QString &repositoryRoot, const QString &metadataFileName)
+    : m_repositoryRoot(repositoryRoot)
+    , m_metadataFileName(metadataFileName)
+    , m_dirty(false)
+{
+    load();
+}
+
+const QString &VersionControlStateCache::repositoryRoot() const
+{
+    return m_repositoryRoot;
+}
+
+bool VersionControlStateCache::isCurrent() const
+{
+    return !m_key.isEmpty() && m_key == currentKey();
+}
+
+void VersionControlStateCache::invalidate()
+{
+    m_states.clear();
+    m_key = currentKey();
+    m_dirty = true;
+}
+
+bool VersionControlStateCache::retrieve(const QString &filePath, KVersionControlPlugin::ItemVersion *version) const
+{
+    const auto it = m_states.constFind(filePath);
+    if (it == m_states.constEnd()) {
+        return false;
+    }
+    *version = it.value();
+    return true;
+}
+
+void VersionControlStateCache::insert(const QString &filePath, KVersionControlPlugin::ItemVersion version)
+{
+    const auto it = m_states.constFind(filePath);
+    if (it != m_states.constEnd() && it.value() == version) {
+        return;
+    }
+    m_states.insert(filePath, version);
+    m_dirty = true;
+}
+
+void VersionControlStateCache::save()
+{
+    if (!m_dirty || m_key.isEmpty()) {
+        return;
+    }
+    if (m_states.count() > MaxPersistedStates) {
+        return;
+    }
+
+    const QString filePath = cacheFilePath();
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QDataStream out(&file);
+    out << CacheFormatVersion;
+    out << m_key;
+    out << quint32(m_states.count());
+    for (auto it = m_states.constBegin(); it != m_states.constEnd(); ++it) {
+        out << it.key() << qint32(it.value());
+    }
+
+    if (file.commit()) {
+        m_dirty = false;
+    }
+}
+
+QByteArray VersionControlStateCache::currentKey() const
+{
+    const QString metadataPath = m_repositoryRoot + QLatin1Char('/') + m_metadataFileName;
+    const QFileInfo metadataInfo(metadataPath);
+    if (!metadataInfo.exists()) {
+        return QByteArray();
+    }
+
+    QByteArray key;
+    const auto appendStamp = [&key](const QFileInfo &info) {
+        key.append(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+        key.append(',');
+        key.append(QByteArray::number(info.size()));
+        key.append(';');
+    };
+    appendStamp(metadataInfo);
+
+    if (metadataInfo.isDir()) {
+        // The directory's own modification time does not change for every
+        // operation, so also stamp the files that do change on commits,
+        // staging and branch switches, where they exist.
+        for (const QString &child : {QStringLiteral("index"), QStringLiteral("HEAD")}) {
+            const QFileInfo childInfo(metadataPath + QLatin1Char('/') + child);
+            if (childInfo.exists()) {
+                appendStamp(childInfo);
+            }
+        }
+    }
+
+    return key;
+}
+
+QString VersionControlStateCache::cacheFilePath() const
+{
+    const QByteArray hashValue = QCryptographicHash::hash(m_repositoryRoot.toUtf8(), QCryptographicHash::Sha1);
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/vcs-states/") + QString::fromLatin1(hashValue.toHex());
+}
+
+void VersionControlStateCache::load()
+{
+    QFile file(cacheFilePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream in(&file);
+    quint32 formatVersion = 0;
+    in >> formatVersion;
+    if (formatVersion != CacheFormatVersion) {
+        return;
+    }
+
+    QByteArray key;
+    quint32 count = 0;
+    in >> key >> count;
+
+    QHash<QString, KVersionControlPlugin::ItemVersion> states;
+    states.reserve(count);
+    for (quint32 i = 0; i < count; ++i) {
+        QString filePath;
+        qint32 version = 0;
+        in >> filePath >> version;
+        if (in.status() != QDataStream::Ok) {
+            return;
+        }
+        states.insert(filePath, KVersionControlPlugin::ItemVersion(version));
+    }
+
+    m_key = key;
+    m_states = states;
+}
@@ -0,0 +1,91 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef VERSIONCONTROLSTATECACHE_H
+#define VERSIONCONTROLSTATECACHE_H
+
+#include "dolphin_export.h"
+#include "views/versioncontrol/kversioncontrolplugin.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+
+/**
+ * @brief Persistent cache of version states for one repository.
+ *
+ * Re-entering a tracked directory used to query the plugin for the state of
+ * every item even when the repository had not changed at all, which makes
+ * browsing large checkouts needlessly slow. This cache stores the retrieved
+ * states on disk, keyed by the modification times of the repository's
+ * metadata (for example the .git directory and its index and HEAD files).
+ * As long as that key matches, re-entering the checkout paints the
+ * decorations from the cache immediately; once the key changes, the cache is
+ * invalidated and refilled from the plugin's answers.
+ */
+class DOLPHIN_EXPORT VersionControlStateCache
+{
+public:
+    /**
+     * Loads the cached states of the repository at \a repositoryRoot.
+     * \a metadataFileName is the name of the version control system's
+     * metadata entry inside the root, see KVersionControlPlugin::fileName().
+     */
+    VersionControlStateCache(const QString &repositoryRoot, const QString &metadataFileName);
+
+    const QString &repositoryRoot() const;
+
+    /**
+     * @return True if the cached states still describe the repository, i.e.
+     *         the repository metadata has not been modified since they were
+     *         stored.
+     */
+    bool isCurrent() const;
+
+    /**
+     * Drops all cached states and stamps the cache with the repository's
+     * current metadata key. States inserted afterwards are considered
+     * current until the repository metadata changes again.
+     */
+    void invalidate();
+
+    /**
+     * @return True if a state for \a filePath is cached. \a version is only
+     *         written in that case.
+     */
+    bool retrieve(const QString &filePath, KVersionControlPlugin::ItemVersion *version) const;
+
+    void insert(const QString &filePath, KVersionControlPlugin::ItemVersion version);
+
+    /** Writes the cached states to disk if anything changed since loading. */
+    void save();
+
+private:
+    /**
+     * @return A key describing the current state of the repository metadata,
+     *         built from the modification times and sizes of the metadata
+     *         entry and - if it is a directory - its "index" and "HEAD"
+     *         children, which are the files that change on commits, staging
+     *         and branch switches.
+     */
+    QByteArray currentKey() const;
+
+    /** @return The path of the file the states are persisted in. */
+    QString cacheFilePath() const;
+
+    void load();
+
+    QString m_repositoryRoot;
+    QString m_metadataFileName;
+
+    /** The metadata key the cached states belong to. */
+    QByteArray m_key;
+
+    QHash<QString, KVersionControlPlugin::ItemVersion> m_states;
+    bool m_dirty;
+};
+
+#endif
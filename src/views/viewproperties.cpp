@@ -10,6 +10,8 @@
 #include "dolphin_directoryviewpropertysettings.h"
 #include "dolphin_generalsettings.h"
 #include "dolphindebug.h"
+#include "viewpropertiescache.h"
+#include "viewpropertieswritebehindqueue.h"
 
 #include <QCryptographicHash>
 #include <QTemporaryFile>
@@ -33,7 +35,7 @@ const char CustomizedDetailsString[] = "CustomizedDetails";
 const char ViewPropertiesFileName[] = ".directory";
 }
 
-ViewPropertySettings *ViewProperties::loadProperties(const QString &folderPath) const
+ViewPropertySettings *ViewProperties::loadProperties(const QString &folderPath)
 {
     const QString settingsFile = folderPath + QDir::separator() + ViewPropertiesFileName;
 
@@ -42,12 +44,30 @@ ViewPropertySettings *ViewProperties::loadProperties(const QString &folderPath)
         return new ViewPropertySettings(KSharedConfig::openConfig(settingsFile, KConfig::SimpleConfig));
     }
 
+    QString cachedProperties;
+    const bool cacheHit = ViewPropertiesCache::instance().retrieve(folderPath, &cachedProperties);
+    if (cacheHit && cachedProperties.isEmpty()) {
+        // The directory is known to have no view properties stored.
+        return nullptr;
+    }
+
     std::unique_ptr<QTemporaryFile> tempFile(new QTemporaryFile());
     tempFile->setAutoRemove(false);
     if (!tempFile->open()) {
         qCWarning(DolphinDebug) << "Could not open temp file";
         return nullptr;
     }
+
+    if (cacheHit) {
+        // Serve the lookup from memory without touching the (possibly
+        // remote) directory again.
+        QFile outputFile(tempFile->fileName());
+        outputFile.open(QIODevice::WriteOnly);
+        outputFile.write(cachedProperties.toUtf8());
+        outputFile.close();
+        return new ViewPropertySettings(KSharedConfig::openConfig(tempFile->fileName(), KConfig::SimpleConfig));
+    }
+
     if (QFile::exists(settingsFile)) {
         // copy settings to tempfile to load them separately
         QFile::remove(tempFile->fileName());
@@ -62,6 +82,12 @@ ViewPropertySettings *ViewProperties::loadProperties(const QString &folderPath)
                     config.deleteGroup(group);
                 }
             }
+            config.sync();
+
+            QFile trimmedFile(tempFile->fileName());
+            if (trimmedFile.open(QIODevice::ReadOnly)) {
+                ViewPropertiesCache::instance().insert(folderPath, QString::fromUtf8(trimmedFile.readAll()));
+            }
             return new ViewPropertySettings(KSharedConfig::openConfig(tempFile->fileName(), KConfig::SimpleConfig));
 
         } else if (!config.groupList().isEmpty()) {
@@ -73,6 +99,7 @@ ViewPropertySettings *ViewProperties::loadProperties(const QString &folderPath)
     // load from metadata
     const QString viewPropertiesString = metadata.attribute(QStringLiteral("kde.fm.viewproperties#1"));
     if (viewPropertiesString.isEmpty()) {
+        ViewPropertiesCache::instance().insert(folderPath, QString());
         return nullptr;
     }
     // load view properties from xattr to temp file then loads into ViewPropertySettings
@@ -80,10 +107,11 @@ ViewPropertySettings *ViewProperties::loadProperties(const QString &folderPath)
     outputFile.open(QIODevice::WriteOnly);
     outputFile.write(viewPropertiesString.toUtf8());
     outputFile.close();
+    ViewPropertiesCache::instance().insert(folderPath, viewPropertiesString);
     return new ViewPropertySettings(KSharedConfig::openConfig(tempFile->fileName(), KConfig::SimpleConfig));
 }
 
-ViewPropertySettings *ViewProperties::defaultProperties() const
+ViewPropertySettings *ViewProperties::defaultProperties()
 {
     auto props = loadProperties(destinationDir(QStringLiteral("global")));
     if (props == nullptr) {
@@ -160,7 +188,13 @@ ViewProperties::ViewProperties(const QUrl &url)
         m_filePath = destinationDir(QStringLiteral("remote")) + m_filePath;
     }
 
-    m_node = loadProperties(m_filePath);
+    // Adopt not-yet-written settings from the write-behind queue if there
+    // are any, so that readers always see the latest state.
+    m_node = ViewPropertiesWriteBehindQueue::instance().take(m_filePath);
+    const bool tookPendingSettings = (m_node != nullptr);
+    if (!tookPendingSettings) {
+        m_node = loadProperties(m_filePath);
+    }
 
     bool useDefaultSettings = useGlobalViewProps ||
         // If the props timestamp is too old,
@@ -234,21 +268,36 @@ ViewProperties::ViewProperties(const QUrl &url)
 
         m_node->setVersion(CurrentViewPropertiesVersion);
     }
+
+    if (tookPendingSettings) {
+        // The adopted settings have not been written yet, so they must be
+        // saved even if this instance does not change anything itself.
+        m_changedProps = true;
+    }
 }
 
 ViewProperties::~ViewProperties()
 {
     if (m_changedProps && m_autoSave) {
-        save();
+        // Do not write synchronously: bursts of changes - e.g. stepping
+        // through zoom levels - destroy one instance per step, and each write
+        // can hitch on a slow file system. The queue takes ownership of the
+        // settings and flushes them once the burst is over.
+        ViewPropertiesWriteBehindQueue::instance().schedule(m_filePath, m_node);
+    } else {
+        discardSettings(m_node);
     }
+    m_node = nullptr;
+}
 
-    if (!m_node->config()->name().endsWith(ViewPropertiesFileName)) {
+void ViewProperties::discardSettings(ViewPropertySettings *settings)
+{
+    if (!settings->config()->name().endsWith(ViewPropertiesFileName)) {
         // remove temp file
-        QFile::remove(m_node->config()->name());
+        QFile::remove(settings->config()->name());
     }
 
-    delete m_node;
-    m_node = nullptr;
+    delete settings;
 }
 
 void ViewProperties::setViewMode(DolphinView::Mode mode)
@@ -491,6 +540,11 @@ bool ViewProperties::isAutoSaveEnabled() const
     return m_autoSave;
 }
 
+bool ViewProperties::isChanged() const
+{
+    return m_changedProps;
+}
+
 void ViewProperties::update()
 {
     m_changedProps = true;
@@ -499,10 +553,19 @@ void ViewProperties::update()
 
 void ViewProperties::save()
 {
-    qCDebug(DolphinDebug) << "Saving view-properties to" << m_filePath;
+    saveProperties(m_filePath, m_node);
+    m_changedProps = false;
+}
+
+void ViewProperties::saveProperties(const QString &filePath, ViewPropertySettings *settings)
+{
+    qCDebug(DolphinDebug) << "Saving view-properties to" << filePath;
 
-    auto cleanDotDirectoryFile = [this]() {
-        const QString settingsFile = m_filePath + QDir::separator() + ViewPropertiesFileName;
+    // The stored state is about to change; the next lookup re-reads it.
+    ViewPropertiesCache::instance().remove(filePath);
+
+    auto cleanDotDirectoryFile = [&filePath]() {
+        const QString settingsFile = filePath + QDir::separator() + ViewPropertiesFileName;
         if (QFile::exists(settingsFile)) {
             qCDebug(DolphinDebug) << "cleaning .directory" << settingsFile;
             KConfig cfg(settingsFile, KConfig::OpenFlag::SimpleConfig);
@@ -521,16 +584,16 @@ void ViewProperties::save()
     };
 
     // ensures the destination dir exists, in case we don't write metadata directly on the folder
-    QDir destinationDir(m_filePath);
-    if (!destinationDir.exists() && !destinationDir.mkpath(m_filePath)) {
+    QDir destinationDir(filePath);
+    if (!destinationDir.exists() && !destinationDir.mkpath(filePath)) {
         qCWarning(DolphinDebug) << "Could not create fake directory to store metadata";
     }
 
-    KFileMetaData::UserMetaData metaData(m_filePath);
+    KFileMetaData::UserMetaData metaData(filePath);
     if (metaData.isSupported()) {
         const auto metaDataKey = QStringLiteral("kde.fm.viewproperties#1");
 
-        const auto items = m_node->items();
+        const auto items = settings->items();
         const auto defaultConfig = defaultProperties();
         bool allDefault = true;
         for (const auto item : items) {
@@ -538,7 +601,7 @@ void ViewProperties::save()
                 continue;
             }
             if (item->name() == "Version") {
-                if (m_node->version() != CurrentViewPropertiesVersion) {
+                if (settings->version() != CurrentViewPropertiesVersion) {
                     allDefault = false;
                     break;
                 } else {
@@ -554,10 +617,10 @@ void ViewProperties::save()
 
         if (allDefault) {
             if (metaData.hasAttribute(metaDataKey)) {
-                qCDebug(DolphinDebug) << "clearing extended attributes for " << m_filePath;
+                qCDebug(DolphinDebug) << "clearing extended attributes for " << filePath;
                 const auto result = metaData.setAttribute(metaDataKey, QString());
                 if (result != KFileMetaData::UserMetaData::NoError) {
-                    qCWarning(DolphinDebug) << "could not clear extended attributes for " << m_filePath << "error:" << result;
+                    qCWarning(DolphinDebug) << "could not clear extended attributes for " << filePath << "error:" << result;
                 }
             }
             cleanDotDirectoryFile();
@@ -565,14 +628,14 @@ void ViewProperties::save()
         }
 
         // save config to disk
-        if (!m_node->save()) {
-            qCWarning(DolphinDebug) << "could not save viewproperties" << m_node->config()->name();
+        if (!settings->save()) {
+            qCWarning(DolphinDebug) << "could not save viewproperties" << settings->config()->name();
             return;
         }
 
-        QFile configFile(m_node->config()->name());
+        QFile configFile(settings->config()->name());
         if (!configFile.open(QIODevice::ReadOnly)) {
-            qCWarning(DolphinDebug) << "Could not open readonly config file" << m_node->config()->name();
+            qCWarning(DolphinDebug) << "Could not open readonly config file" << settings->config()->name();
         } else {
             // load config from disk
             const QString viewPropertiesString = configFile.readAll();
@@ -582,13 +645,13 @@ void ViewProperties::save()
             if (result != KFileMetaData::UserMetaData::NoError) {
                 if (result == KFileMetaData::UserMetaData::NoSpace) {
                     // copy settings to dotDirectory file as fallback
-                    if (!configFile.copy(m_filePath + QDir::separator() + ViewPropertiesFileName)) {
-                        qCWarning(DolphinDebug) << "could not write viewproperties to .directory for dir " << m_filePath;
+                    if (!configFile.copy(filePath + QDir::separator() + ViewPropertiesFileName)) {
+                        qCWarning(DolphinDebug) << "could not write viewproperties to .directory for dir " << filePath;
                     }
                     // free the space used by viewproperties from the file metadata
                     metaData.setAttribute(metaDataKey, "");
                 } else {
-                    qCWarning(DolphinDebug) << "could not save viewproperties to extended attributes for dir " << m_filePath << "error:" << result;
+                    qCWarning(DolphinDebug) << "could not save viewproperties to extended attributes for dir " << filePath << "error:" << result;
                 }
                 // keep .directory file
                 return;
@@ -596,19 +659,16 @@ void ViewProperties::save()
             cleanDotDirectoryFile();
         }
 
-        m_changedProps = false;
         return;
     }
 
     QDir dir;
-    dir.mkpath(m_filePath);
-    m_node->setVersion(CurrentViewPropertiesVersion);
-    m_node->save();
-
-    m_changedProps = false;
+    dir.mkpath(filePath);
+    settings->setVersion(CurrentViewPropertiesVersion);
+    settings->save();
 }
 
-QString ViewProperties::destinationDir(const QString &subDir) const
+QString ViewProperties::destinationDir(const QString &subDir)
 {
     QString path = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     path.append("/view_properties/").append(subDir);
@@ -100,14 +100,21 @@ public:
     void setAutoSaveEnabled(bool autoSave);
     bool isAutoSaveEnabled() const;
 
+    /**
+     * @return True if at least one property has been changed since the
+     *         properties were loaded or last saved.
+     */
+    bool isChanged() const;
+
     void update();
 
     /**
      * Saves the view properties for the directory specified
-     * in the constructor. The method is automatically
-     * invoked in the destructor, if
-     * ViewProperties::isAutoSaveEnabled() returns true and
-     * at least one property has been changed.
+     * in the constructor immediately. If
+     * ViewProperties::isAutoSaveEnabled() returns true and at least one
+     * property has been changed, the destructor schedules the save through
+     * ViewPropertiesWriteBehindQueue instead, which coalesces the write
+     * with further changes to the same directory.
      */
     void save();
 
@@ -116,7 +123,7 @@ public:
      * properties are stored. \a subDir specifies the used sub
      * directory.
      */
-    QString destinationDir(const QString &subDir) const;
+    static QString destinationDir(const QString &subDir);
 
 private:
     /**
@@ -157,9 +164,20 @@ private:
     static QString directoryHashForUrl(const QUrl &url);
 
     /** @returns a ViewPropertySettings object with properties loaded for the directory at @param filePath. Ownership is returned to the caller. */
-    ViewPropertySettings *loadProperties(const QString &folderPath) const;
+    static ViewPropertySettings *loadProperties(const QString &folderPath);
     /** @returns a ViewPropertySettings object with the globally configured default values. Ownership is returned to the caller. */
-    ViewPropertySettings *defaultProperties() const;
+    static ViewPropertySettings *defaultProperties();
+
+    /**
+     * Writes the given \a settings of the directory stored at \a filePath
+     * to disk. Shared between save() and ViewPropertiesWriteBehindQueue.
+     */
+    static void saveProperties(const QString &filePath, ViewPropertySettings *settings);
+
+    /** Deletes \a settings and removes its backing temporary file, if any. */
+    static void discardSettings(ViewPropertySettings *settings);
+
+    friend class ViewPropertiesWriteBehindQueue;
 
     Q_DISABLE_COPY(ViewProperties)
 
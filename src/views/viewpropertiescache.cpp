@@ -0,0 +1,47 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "viewpropertiescache.h"
+
+namespace
+{
+/** Upper bound for the number of directories the cache remembers. */
+constexpr int MaxCachedDirectories = 1000;
+}
+
+ViewPropertiesCache &ViewPropertiesCache::instance()
+{
+    static ViewPropertiesCache cache;
+    return cache;
+}
+
+ViewPropertiesCache::ViewPropertiesCache()
+    : m_entries(MaxCachedDirectories)
+{
+}
+
+bool ViewPropertiesCache::retrieve(const QString &folderPath, QString *serialized) const
+{
+    QMutexLocker locker(&m_mutex);
+    const QString *entry = m_entries.object(folderPath);
+    if (!entry) {
+        return false;
+    }
+    *serialized = *entry;
+    return true;
+}
+
+void ViewPropertiesCache::insert(const QString &folderPath, const QString &serialized)
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.insert(folderPath, new QString(serialized));
+}
+
+void ViewPropertiesCache::remove(const QString &folderPath)
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.remove(folderPath);
+}
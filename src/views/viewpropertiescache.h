@@ -0,0 +1,58 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef VIEWPROPERTIESCACHE_H
+#define VIEWPROPERTIESCACHE_H
+
+#include "dolphin_export.h"
+
+#include <QCache>
+#include <QMutex>
+#include <QString>
+
+/**
+ * @brief Process-wide LRU cache of serialized view properties per directory.
+ *
+ * Loading the view properties of a directory requires several stat calls, a
+ * read of the .directory file or of the extended attribute, and a temporary
+ * file round trip - on cold NFS caches tens of milliseconds that are paid on
+ * every navigation before the view can configure itself. This cache remembers
+ * the serialized properties (or the fact that a directory has none stored)
+ * keyed by the directory path, turning repeated lookups into a hash probe.
+ * The .directory files and extended attributes remain the source of truth:
+ * ViewProperties::saveProperties() drops the entry of a directory it writes,
+ * so the next lookup re-reads the stored state.
+ *
+ * All methods are thread-safe; ApplyViewPropsJob loads and saves view
+ * properties from worker threads.
+ */
+class DOLPHIN_EXPORT ViewPropertiesCache
+{
+public:
+    static ViewPropertiesCache &instance();
+
+    /**
+     * @return Whether an entry for \a folderPath exists. If it does,
+     *         \a serialized is set to the cached configuration text; an empty
+     *         text means the directory is known to have no view properties
+     *         stored.
+     */
+    bool retrieve(const QString &folderPath, QString *serialized) const;
+
+    /** Remembers \a serialized as the stored view properties of \a folderPath. */
+    void insert(const QString &folderPath, const QString &serialized);
+
+    /** Drops the entry for \a folderPath, if any. */
+    void remove(const QString &folderPath);
+
+private:
+    ViewPropertiesCache();
+
+    mutable QMutex m_mutex;
+    QCache<QString, QString> m_entries;
+};
+
+#endif
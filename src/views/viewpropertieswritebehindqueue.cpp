@@ -0,0 +1,93 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "viewpropertieswritebehindqueue.h"
+
+#include "views/viewproperties.h"
+
+#include <QCoreApplication>
+
+namespace
+{
+// Milliseconds without a further change to any directory's view properties
+// before the pending writes are flushed. Short enough that little is lost
+// on a crash, long enough to coalesce a burst of Ctrl+wheel zoom steps.
+constexpr int QuietPeriodMs = 1000;
+}
+
+ViewPropertiesWriteBehindQueue &ViewPropertiesWriteBehindQueue::instance()
+{
+    static ViewPropertiesWriteBehindQueue queue;
+    return queue;
+}
+
+ViewPropertiesWriteBehindQueue::ViewPropertiesWriteBehindQueue()
+{
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(QuietPeriodMs);
+    connect(&m_flushTimer, &QTimer::timeout, this, &ViewPropertiesWriteBehindQueue::flush);
+
+    // Make sure no pending write is lost on a regular shutdown.
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &ViewPropertiesWriteBehindQueue::flush);
+    }
+}
+
+ViewPropertiesWriteBehindQueue::~ViewPropertiesWriteBehindQueue()
+{
+    flush();
+}
+
+void ViewPropertiesWriteBehindQueue::schedule(const QString &filePath, ViewPropertySettings *settings)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        ViewPropertySettings *replaced = m_pending.take(filePath);
+        if (replaced) {
+            ViewProperties::discardSettings(replaced);
+        } else {
+            m_pendingOrder.append(filePath);
+        }
+        m_pending.insert(filePath, settings);
+    }
+
+    // ViewProperties instances may be destroyed in worker threads, so the
+    // timer has to be restarted in the thread this queue lives in.
+    QMetaObject::invokeMethod(&m_flushTimer, qOverload<>(&QTimer::start), Qt::QueuedConnection);
+}
+
+ViewPropertySettings *ViewPropertiesWriteBehindQueue::take(const QString &filePath)
+{
+    QMutexLocker locker(&m_mutex);
+    ViewPropertySettings *settings = m_pending.take(filePath);
+    if (settings) {
+        m_pendingOrder.removeOne(filePath);
+    }
+    return settings;
+}
+
+void ViewPropertiesWriteBehindQueue::flush()
+{
+    m_flushTimer.stop();
+
+    QHash<QString, ViewPropertySettings *> pending;
+    QStringList order;
+    {
+        QMutexLocker locker(&m_mutex);
+        pending.swap(m_pending);
+        order.swap(m_pendingOrder);
+    }
+
+    for (const QString &filePath : std::as_const(order)) {
+        ViewPropertySettings *settings = pending.take(filePath);
+        if (settings) {
+            ViewProperties::saveProperties(filePath, settings);
+            ViewProperties::discardSettings(settings);
+        }
+    }
+}
+
+#include "moc_viewpropertieswritebehindqueue.cpp"
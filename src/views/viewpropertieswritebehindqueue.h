@@ -0,0 +1,77 @@
+/*
+ * SPDX-FileCopyrightText: 2026 The Dolphin Developers
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef VIEWPROPERTIESWRITEBEHINDQUEUE_H
+#define VIEWPROPERTIESWRITEBEHINDQUEUE_H
+
+#include "dolphin_export.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+
+class ViewPropertySettings;
+
+/**
+ * @brief Coalesces ViewProperties writes and flushes them after a quiet period.
+ *
+ * Adjusting a view setting repeatedly - dragging a column border, stepping
+ * through zoom levels with Ctrl+wheel - destroys one ViewProperties instance
+ * per step, and each destruction used to write the directory's settings
+ * synchronously. On slow (e.g. NFS) file systems this was visible as input
+ * hitches. Instead of saving immediately, ViewProperties now hands its changed
+ * settings to this queue, which keeps at most one pending write per directory
+ * and flushes them in scheduling order once no further change has arrived for
+ * a short while, and in any case when the application exits. A ViewProperties
+ * instance constructed for a directory with a pending write adopts the pending
+ * settings, so readers always see the latest state.
+ *
+ * schedule() and take() are thread-safe; ApplyViewPropsJob constructs
+ * ViewProperties instances in worker threads.
+ */
+class DOLPHIN_EXPORT ViewPropertiesWriteBehindQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    static ViewPropertiesWriteBehindQueue &instance();
+
+    /**
+     * Schedules the changed \a settings of the directory stored at
+     * \a filePath to be written once the quiet period has elapsed. Takes
+     * ownership of \a settings; a write already pending for \a filePath is
+     * replaced.
+     */
+    void schedule(const QString &filePath, ViewPropertySettings *settings);
+
+    /**
+     * Removes and returns the pending settings for \a filePath, transferring
+     * ownership to the caller, or nullptr if no write is pending. Used by
+     * ViewProperties to see not-yet-written changes.
+     */
+    ViewPropertySettings *take(const QString &filePath);
+
+    /** Writes all pending settings to disk immediately, in scheduling order. */
+    void flush();
+
+private:
+    ViewPropertiesWriteBehindQueue();
+    ~ViewPropertiesWriteBehindQueue() override;
+
+    /** Protects m_pending and m_pendingOrder. */
+    QMutex m_mutex;
+
+    QHash<QString, ViewPropertySettings *> m_pending;
+
+    /** File paths of m_pending in scheduling order, so flushing preserves it. */
+    QStringList m_pendingOrder;
+
+    QTimer m_flushTimer;
+};
+
+#endif